@@ -0,0 +1,150 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BENCHMARK_UTILS_HPP
+#define SELENE_BENCHMARK_UTILS_HPP
+
+#include <selene/img/Image.hpp>
+#include <selene/img/PixelTraits.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <boost/filesystem.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <memory>
+
+namespace sln_benchmark {
+
+using namespace sln::literals;
+
+// Image sizes of roughly 1, 12 and 50 megapixels, with a 4:3 aspect ratio.
+inline sln::PixelLength bench_width(std::int64_t megapixels)
+{
+  switch (megapixels)
+  {
+    case 1: return 1152_px;
+    case 12: return 4000_px;
+    default: return 8160_px;
+  }
+}
+
+inline sln::PixelLength bench_height(std::int64_t megapixels)
+{
+  switch (megapixels)
+  {
+    case 1: return 864_px;
+    case 12: return 3000_px;
+    default: return 6120_px;
+  }
+}
+
+// Deterministic image content: smooth gradients with some texture, so that codecs see realistic (neither constant nor
+// incompressible) data.
+template <typename PixelType>
+sln::Image<PixelType> make_bench_image(sln::PixelLength width, sln::PixelLength height)
+{
+  using Element = typename sln::PixelTraits<PixelType>::Element;
+  constexpr auto nr_channels = sln::PixelTraits<PixelType>::nr_channels;
+
+  sln::Image<PixelType> img(width, height);
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    auto ptr = reinterpret_cast<Element*>(img.data(y));
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      for (std::size_t c = 0; c < nr_channels; ++c)
+      {
+        const auto value = (x * 3 + y * 5 + static_cast<std::int32_t>(c) * 64 + ((x ^ y) & 0x0F)) & 0xFF;
+        *ptr++ = static_cast<Element>(value);
+      }
+    }
+  }
+  return img;
+}
+
+template <typename PixelType>
+sln::Image<PixelType> make_bench_image(const benchmark::State& state)
+{
+  return make_bench_image<PixelType>(bench_width(state.range(0)), bench_height(state.range(0)));
+}
+
+inline void set_bytes_processed(benchmark::State& state, std::size_t bytes_per_iteration)
+{
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes_per_iteration));
+}
+
+template <typename PixelType>
+void set_bytes_processed(benchmark::State& state, const sln::Image<PixelType>& img)
+{
+  set_bytes_processed(state, img.total_bytes());
+}
+
+// Benchmark arguments: {megapixels}.
+inline void megapixel_arguments(benchmark::internal::Benchmark* b, std::initializer_list<int> megapixel_values)
+{
+  b->ArgNames({"MP"});
+  for (auto megapixels : megapixel_values)
+  {
+    b->Args({megapixels});
+  }
+  b->Unit(benchmark::kMillisecond);
+}
+
+inline void megapixel_arguments(benchmark::internal::Benchmark* b)
+{
+  megapixel_arguments(b, {1, 12, 50});
+}
+
+// Benchmark arguments: {megapixels, threads}. Zero threads denotes the overload without a thread pool.
+inline void megapixel_thread_arguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"MP", "threads"});
+  for (auto megapixels : {1, 12, 50})
+  {
+    for (auto threads : {0, 2, 4, 8})
+    {
+      b->Args({megapixels, threads});
+    }
+  }
+  b->Unit(benchmark::kMillisecond);
+  b->UseRealTime();
+}
+
+// Returns a thread pool with state.range(1) threads, or nullptr if zero threads are requested.
+inline std::unique_ptr<sln::ThreadPool> make_thread_pool(const benchmark::State& state)
+{
+  const auto nr_threads = static_cast<std::size_t>(state.range(1));
+  return nr_threads > 0 ? std::make_unique<sln::ThreadPool>(nr_threads) : nullptr;
+}
+
+// Directory for files written by the I/O benchmarks.
+inline boost::filesystem::path get_tmp_path()
+{
+  namespace fs = boost::filesystem;
+  const auto tmp_path = fs::temp_directory_path() / "selene_benchmark";
+
+  if (!fs::exists(tmp_path))
+  {
+    fs::create_directories(tmp_path);
+  }
+
+  return tmp_path;
+}
+
+// Directory containing the test data (e.g. the PNG suite); can be overridden by the SELENE_DATA_PATH environment variable.
+inline boost::filesystem::path get_data_path()
+{
+  const auto env_var = std::getenv("SELENE_DATA_PATH");
+  return (env_var) ? boost::filesystem::path(env_var) : boost::filesystem::path("../data");
+}
+
+}  // namespace sln_benchmark
+
+#endif  // SELENE_BENCHMARK_UTILS_HPP
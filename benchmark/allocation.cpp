@@ -0,0 +1,175 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/ArenaMemoryResource.hpp>
+#include <selene/base/MappedMemoryResource.hpp>
+#include <selene/base/MemoryResource.hpp>
+#include <selene/base/PoolMemoryResource.hpp>
+
+#include <selene/img/Image.hpp>
+#include <selene/img/Pixel.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include "BenchmarkUtils.hpp"
+
+using namespace sln_benchmark;
+
+namespace {
+
+// Allocates and writes the intermediate images of one request of a typical processing pipeline (e.g. a full size
+// converted copy, followed by a pyramid of downscaled versions), then destroys them.
+void process_request(sln::PixelLength width, sln::PixelLength height, sln::MemoryResource& resource)
+{
+  sln::Image<sln::Pixel_8u3> img_full(width, height, sln::Stride{0}, resource);
+  sln::Image<sln::Pixel_8u1> img_gray(width, height, sln::Stride{0}, resource);
+  std::memset(img_full.byte_ptr(), 0x40, img_full.total_bytes());
+  std::memset(img_gray.byte_ptr(), 0x80, img_gray.total_bytes());
+
+  for (auto level = 1; level <= 4; ++level)
+  {
+    sln::Image<sln::Pixel_8u3> img_level(sln::to_pixel_length(width >> level),
+                                         sln::to_pixel_length(height >> level), sln::Stride{0}, resource);
+    std::memset(img_level.byte_ptr(), level, img_level.total_bytes());
+    benchmark::DoNotOptimize(img_level.byte_ptr());
+  }
+
+  benchmark::DoNotOptimize(img_full.byte_ptr());
+  benchmark::DoNotOptimize(img_gray.byte_ptr());
+}
+
+std::size_t request_bytes(sln::PixelLength width, sln::PixelLength height)
+{
+  std::size_t nr_bytes = std::size_t(width) * std::size_t(height) * 4;
+
+  for (auto level = 1; level <= 4; ++level)
+  {
+    nr_bytes += std::size_t(width >> level) * std::size_t(height >> level) * 3;
+  }
+
+  return nr_bytes;
+}
+
+}  // namespace
+
+void allocation_default_resource(benchmark::State& state)
+{
+  const auto width = bench_width(state.range(0));
+  const auto height = bench_height(state.range(0));
+  auto& resource = sln::default_memory_resource();
+
+  for (auto _ : state)
+  {
+    process_request(width, height, resource);
+  }
+
+  set_bytes_processed(state, request_bytes(width, height));
+}
+
+void allocation_pool_resource(benchmark::State& state)
+{
+  const auto width = bench_width(state.range(0));
+  const auto height = bench_height(state.range(0));
+  sln::PoolMemoryResource resource;
+
+  for (auto _ : state)
+  {
+    process_request(width, height, resource);
+  }
+
+  set_bytes_processed(state, request_bytes(width, height));
+}
+
+void allocation_arena_resource(benchmark::State& state)
+{
+  const auto width = bench_width(state.range(0));
+  const auto height = bench_height(state.range(0));
+  sln::ArenaMemoryResource resource;
+
+  for (auto _ : state)
+  {
+    process_request(width, height, resource);
+    resource.reset();
+  }
+
+  set_bytes_processed(state, request_bytes(width, height));
+}
+
+// Memory mapped from the system on each allocation, backed by transparent huge pages; pays the page fault cost on each
+// request (fewer, but larger faults), and benefits from fewer TLB misses during processing.
+void allocation_mapped_resource(benchmark::State& state)
+{
+  const auto width = bench_width(state.range(0));
+  const auto height = bench_height(state.range(0));
+  sln::MappedMemoryResource resource(sln::HugePages::Transparent);
+
+  for (auto _ : state)
+  {
+    process_request(width, height, resource);
+  }
+
+  set_bytes_processed(state, request_bytes(width, height));
+}
+
+// A large canvas that is cleared, and then only sparsely written to (e.g. a few tiles of a mosaic).
+template <bool zeroed, typename Resource>
+void zeroed_canvas(benchmark::State& state, Resource& resource)
+{
+  const auto width = bench_width(state.range(0));
+  const auto height = bench_height(state.range(0));
+  const auto tile_size = sln::to_pixel_length(256);
+
+  for (auto _ : state)
+  {
+    sln::Image<sln::Pixel_8u3> canvas(resource);
+
+    if (zeroed)
+    {
+      canvas.allocate_zeroed(width, height);
+    }
+    else
+    {
+      canvas.allocate(width, height);
+      canvas.fill(sln::Pixel_8u3(0, 0, 0));
+    }
+
+    for (auto y = 0_idx; y < tile_size; ++y)
+    {
+      std::fill(canvas.data(y), canvas.data(y) + tile_size, sln::Pixel_8u3(255, 128, 0));
+    }
+
+    benchmark::DoNotOptimize(canvas.byte_ptr());
+  }
+
+  set_bytes_processed(state, std::size_t(width) * std::size_t(height) * 3);
+}
+
+void zeroed_canvas_fill(benchmark::State& state)
+{
+  zeroed_canvas<false>(state, sln::default_memory_resource());
+}
+
+void zeroed_canvas_allocate_zeroed(benchmark::State& state)
+{
+  zeroed_canvas<true>(state, sln::default_memory_resource());
+}
+
+void zeroed_canvas_allocate_zeroed_mapped(benchmark::State& state)
+{
+  sln::MappedMemoryResource resource(sln::HugePages::None);
+  zeroed_canvas<true>(state, resource);
+}
+
+BENCHMARK(allocation_default_resource)->Apply(megapixel_arguments);
+BENCHMARK(allocation_pool_resource)->Apply(megapixel_arguments);
+BENCHMARK(allocation_arena_resource)->Apply(megapixel_arguments);
+BENCHMARK(allocation_mapped_resource)->Apply(megapixel_arguments);
+BENCHMARK(zeroed_canvas_fill)->Apply(megapixel_arguments);
+BENCHMARK(zeroed_canvas_allocate_zeroed)->Apply(megapixel_arguments);
+BENCHMARK(zeroed_canvas_allocate_zeroed_mapped)->Apply(megapixel_arguments);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,134 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/img/Image.hpp>
+#include <selene/img/Pixel.hpp>
+#include <selene/img/PlanarImage.hpp>
+#include <selene/img_ops/ImageConversions.hpp>
+#include <selene/img_ops/PlanarConversions.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "BenchmarkUtils.hpp"
+
+using namespace sln_benchmark;
+
+template <sln::PixelFormat format_src, sln::PixelFormat format_dst, typename PixelSrc, typename PixelDst>
+void convert(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelSrc>(state);
+  sln::Image<PixelDst> img_dst;
+  const auto thread_pool = make_thread_pool(state);
+
+  for (auto _ : state)
+  {
+    if (thread_pool)
+    {
+      sln::convert_image<format_src, format_dst>(img, img_dst, *thread_pool);
+    }
+    else
+    {
+      sln::convert_image<format_src, format_dst>(img, img_dst);
+    }
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <sln::PixelFormat format_src, sln::PixelFormat format_dst, typename PixelSrc, typename PixelDst>
+void convert_with_alpha(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelSrc>(state);
+  sln::Image<PixelDst> img_dst;
+  const auto thread_pool = make_thread_pool(state);
+  constexpr std::uint8_t alpha = 255;
+
+  for (auto _ : state)
+  {
+    if (thread_pool)
+    {
+      sln::convert_image<format_src, format_dst>(img, img_dst, alpha, *thread_pool);
+    }
+    else
+    {
+      sln::convert_image<format_src, format_dst>(img, img_dst, alpha);
+    }
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename T, std::size_t N>
+void deinterleave(benchmark::State& state)
+{
+  const auto img = make_bench_image<sln::Pixel<T, N>>(state);
+  sln::PlanarImage<T, N> img_dst;
+  const auto thread_pool = make_thread_pool(state);
+
+  for (auto _ : state)
+  {
+    if (thread_pool)
+    {
+      sln::deinterleave(img, img_dst, *thread_pool);
+    }
+    else
+    {
+      sln::deinterleave(img, img_dst);
+    }
+    benchmark::DoNotOptimize(img_dst.byte_ptr(0));
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename T, std::size_t N>
+void interleave(benchmark::State& state)
+{
+  const auto img = make_bench_image<sln::Pixel<T, N>>(state);
+  const auto img_src = sln::deinterleave(img);
+  sln::Image<sln::Pixel<T, N>> img_dst;
+  const auto thread_pool = make_thread_pool(state);
+
+  for (auto _ : state)
+  {
+    if (thread_pool)
+    {
+      sln::interleave(img_src, img_dst, *thread_pool);
+    }
+    else
+    {
+      sln::interleave(img_src, img_dst);
+    }
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+using sln::PixelFormat;
+
+BENCHMARK_TEMPLATE(convert, PixelFormat::RGB, PixelFormat::Y, sln::Pixel_8u3, sln::Pixel_8u1)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(convert, PixelFormat::RGB, PixelFormat::BGR, sln::Pixel_8u3, sln::Pixel_8u3)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(convert, PixelFormat::RGBA, PixelFormat::RGB, sln::Pixel_8u4, sln::Pixel_8u3)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(convert, PixelFormat::RGBA, PixelFormat::BGRA, sln::Pixel_8u4, sln::Pixel_8u4)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(convert, PixelFormat::Y, PixelFormat::RGB, sln::Pixel_8u1, sln::Pixel_8u3)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(convert_with_alpha, PixelFormat::RGB, PixelFormat::RGBA, sln::Pixel_8u3, sln::Pixel_8u4)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(convert, PixelFormat::RGB, PixelFormat::Y, sln::Pixel_16u3, sln::Pixel_16u1)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(deinterleave, std::uint8_t, 3)->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(deinterleave, std::uint8_t, 4)->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(interleave, std::uint8_t, 3)->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(interleave, std::uint8_t, 4)->Apply(megapixel_thread_arguments);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/img/Image.hpp>
+#include <selene/img/Pixel.hpp>
+#include <selene/img_ops/Convolution.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkUtils.hpp"
+
+using namespace sln_benchmark;
+
+// Gaussian blur; with 12 MP images (i.e. 4000 pixels wide), the intermediate rows of the larger kernels no longer fit
+// the cache budget all at once, which exercises the column strip handling.
+template <std::size_t kernel_size, typename PixelType>
+void gaussian_blur(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  sln::Image<PixelType> img_dst;
+  const auto thread_pool = make_thread_pool(state);
+
+  for (auto _ : state)
+  {
+    if (thread_pool)
+    {
+      sln::gaussian_blur<kernel_size>(img, 0.0f, img_dst, *thread_pool);
+    }
+    else
+    {
+      sln::gaussian_blur<kernel_size>(img, 0.0f, img_dst);
+    }
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <std::size_t kernel_size, typename PixelType>
+void box_filter(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  sln::Image<PixelType> img_dst;
+
+  for (auto _ : state)
+  {
+    sln::box_filter<kernel_size>(img, img_dst);
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+BENCHMARK_TEMPLATE(gaussian_blur, 5, sln::Pixel_8u3)->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(gaussian_blur, 19, sln::Pixel_8u3)->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(gaussian_blur, 19, sln::Pixel_8u1)->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(gaussian_blur, 31, sln::Pixel_32f3)->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(box_filter, 5, sln::Pixel_8u3)->Apply(megapixel_arguments);
+
+BENCHMARK_MAIN();
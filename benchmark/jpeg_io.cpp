@@ -0,0 +1,192 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <benchmark/benchmark.h>
+
+#if defined(SELENE_WITH_LIBJPEG)
+
+#include <selene/img/Image.hpp>
+#include <selene/img/ImageBufferPool.hpp>
+#include <selene/img/ImageToImageData.hpp>
+#include <selene/img/Pixel.hpp>
+#include <selene/img_io/DecoderPool.hpp>
+#include <selene/img_io/JPEGRead.hpp>
+#include <selene/img_io/JPEGWrite.hpp>
+
+#include <selene/io/FileReader.hpp>
+#include <selene/io/FileWriter.hpp>
+#include <selene/io/MMapReader.hpp>
+#include <selene/io/MemoryReader.hpp>
+#include <selene/io/VectorWriter.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.hpp"
+
+using namespace sln_benchmark;
+
+namespace {
+
+template <typename PixelType>
+constexpr sln::PixelFormat bench_pixel_format()
+{
+  return sln::PixelTraits<PixelType>::nr_channels == 1
+             ? sln::PixelFormat::Y
+             : (sln::PixelTraits<PixelType>::nr_channels == 4 ? sln::PixelFormat::RGBA : sln::PixelFormat::RGB);
+}
+
+template <typename PixelType>
+std::vector<std::uint8_t> encode_bench_image(const sln::Image<PixelType>& img)
+{
+  std::vector<std::uint8_t> buffer;
+  sln::write_jpeg(sln::to_image_data_view(img, bench_pixel_format<PixelType>()), sln::VectorWriter(buffer));
+  return buffer;
+}
+
+template <typename PixelType>
+std::string bench_file_path(const benchmark::State& state)
+{
+  const auto filename = "bench_" + std::to_string(state.range(0)) + "MP_"
+                        + std::to_string(sln::PixelTraits<PixelType>::nr_channels) + "ch.jpg";
+  return (get_tmp_path() / filename).string();
+}
+
+}  // namespace
+
+template <typename PixelType>
+void jpeg_write_memory(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto img_data = sln::to_image_data_view(img, bench_pixel_format<PixelType>());
+  std::vector<std::uint8_t> buffer;
+
+  for (auto _ : state)
+  {
+    buffer.clear();
+    benchmark::DoNotOptimize(sln::write_jpeg(img_data, sln::VectorWriter(buffer)));
+  }
+
+  set_bytes_processed(state, img);
+  state.counters["compressed_bytes"] = static_cast<double>(buffer.size());
+}
+
+template <typename PixelType>
+void jpeg_write_file(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto img_data = sln::to_image_data_view(img, bench_pixel_format<PixelType>());
+  const auto path = bench_file_path<PixelType>(state);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(sln::write_jpeg(img_data, sln::FileWriter(path)));
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void jpeg_read_memory(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto buffer = encode_bench_image(img);
+
+  for (auto _ : state)
+  {
+    auto img_data = sln::read_jpeg(sln::MemoryReader(buffer.data(), buffer.size()));
+    benchmark::DoNotOptimize(img_data.byte_ptr());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+// As jpeg_read_memory, but downscaling by 1/8 during decompression, e.g. for thumbnail generation.
+template <typename PixelType>
+void jpeg_read_memory_scaled(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto buffer = encode_bench_image(img);
+  sln::JPEGDecompressionOptions options;
+  options.scale_denom = 8;
+
+  for (auto _ : state)
+  {
+    auto img_data = sln::read_jpeg(sln::MemoryReader(buffer.data(), buffer.size()), options);
+    benchmark::DoNotOptimize(img_data.byte_ptr());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+// As jpeg_read_memory, but reusing a pooled decompression object and pooled memory for the output image data.
+template <typename PixelType>
+void jpeg_read_memory_pooled(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto buffer = encode_bench_image(img);
+  sln::DecoderPool decoder_pool;
+  sln::ImageBufferPool buffer_pool;
+
+  for (auto _ : state)
+  {
+    auto obj = decoder_pool.jpeg().acquire();
+    auto img_data = sln::read_jpeg(*obj, sln::MemoryReader(buffer.data(), buffer.size()), buffer_pool);
+    benchmark::DoNotOptimize(img_data.image_data().byte_ptr());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void jpeg_read_file(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto path = bench_file_path<PixelType>(state);
+  sln::write_jpeg(sln::to_image_data_view(img, bench_pixel_format<PixelType>()), sln::FileWriter(path));
+
+  for (auto _ : state)
+  {
+    auto img_data = sln::read_jpeg(sln::FileReader(path));
+    benchmark::DoNotOptimize(img_data.byte_ptr());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void jpeg_read_mmap(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto path = bench_file_path<PixelType>(state);
+  sln::write_jpeg(sln::to_image_data_view(img, bench_pixel_format<PixelType>()), sln::FileWriter(path));
+
+  for (auto _ : state)
+  {
+    auto img_data = sln::read_jpeg(sln::MMapReader(path));
+    benchmark::DoNotOptimize(img_data.byte_ptr());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+void io_arguments(benchmark::internal::Benchmark* b)
+{
+  megapixel_arguments(b, {1, 12});
+}
+
+BENCHMARK_TEMPLATE(jpeg_write_memory, sln::Pixel_8u1)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(jpeg_write_memory, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(jpeg_write_file, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(jpeg_read_memory, sln::Pixel_8u1)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(jpeg_read_memory, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(jpeg_read_memory_scaled, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(jpeg_read_memory_pooled, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(jpeg_read_file, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(jpeg_read_mmap, sln::Pixel_8u3)->Apply(io_arguments);
+
+#endif  // defined(SELENE_WITH_LIBJPEG)
+
+BENCHMARK_MAIN();
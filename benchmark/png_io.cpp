@@ -0,0 +1,321 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <benchmark/benchmark.h>
+
+#if defined(SELENE_WITH_LIBPNG)
+
+#include <selene/img/Image.hpp>
+#include <selene/img/ImageBufferPool.hpp>
+#include <selene/img/ImageToImageData.hpp>
+#include <selene/img/Pixel.hpp>
+#include <selene/img_io/DecoderPool.hpp>
+#include <selene/img_io/PNGRead.hpp>
+#include <selene/img_io/PNGWrite.hpp>
+
+#include <selene/io/FileReader.hpp>
+#include <selene/io/FileWriter.hpp>
+#include <selene/io/MMapReader.hpp>
+#include <selene/io/MemoryReader.hpp>
+#include <selene/io/VectorWriter.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchmarkUtils.hpp"
+
+using namespace sln_benchmark;
+
+namespace {
+
+template <typename PixelType>
+constexpr sln::PixelFormat bench_pixel_format()
+{
+  return sln::PixelTraits<PixelType>::nr_channels == 1
+             ? sln::PixelFormat::Y
+             : (sln::PixelTraits<PixelType>::nr_channels == 4 ? sln::PixelFormat::RGBA : sln::PixelFormat::RGB);
+}
+
+template <typename PixelType>
+std::vector<std::uint8_t> encode_bench_image(const sln::Image<PixelType>& img)
+{
+  std::vector<std::uint8_t> buffer;
+  sln::write_png(sln::to_image_data_view(img, bench_pixel_format<PixelType>()), sln::VectorWriter(buffer));
+  return buffer;
+}
+
+template <typename PixelType>
+std::string bench_file_path(const benchmark::State& state)
+{
+  const auto filename = "bench_" + std::to_string(state.range(0)) + "MP_"
+                        + std::to_string(sln::PixelTraits<PixelType>::nr_channels) + "ch_"
+                        + std::to_string(sln::PixelTraits<PixelType>::nr_bytes_per_channel * 8) + "bit.png";
+  return (get_tmp_path() / filename).string();
+}
+
+// The images of the PNG suite (except for the corrupt ones), and a photo.
+const std::vector<sln::ImageData<>>& png_suite_corpus()
+{
+  static const std::vector<sln::ImageData<>> corpus = [] {
+    namespace fs = boost::filesystem;
+    std::vector<fs::path> paths;
+    for (const auto& entry : fs::directory_iterator(get_data_path() / "png_suite"))
+    {
+      if (entry.path().extension() == ".png" && entry.path().filename().string()[0] != 'x')
+      {
+        paths.push_back(entry.path());
+      }
+    }
+    std::sort(paths.begin(), paths.end());
+    paths.push_back(get_data_path() / "bike_duck.png");
+
+    std::vector<sln::ImageData<>> images;
+    for (const auto& path : paths)
+    {
+      auto img_data = sln::read_png(sln::FileReader(path.string()));
+      if (img_data.is_valid())
+      {
+        images.push_back(std::move(img_data));
+      }
+    }
+    return images;
+  }();
+
+  return corpus;
+}
+
+const char* preset_name(std::int64_t preset)
+{
+  switch (static_cast<sln::PNGCompressionPreset>(preset))
+  {
+    case sln::PNGCompressionPreset::Fastest: return "Fastest";
+    case sln::PNGCompressionPreset::Balanced: return "Balanced";
+    case sln::PNGCompressionPreset::Smallest: return "Smallest";
+  }
+  return "";
+}
+
+}  // namespace
+
+template <typename PixelType>
+void png_write_memory(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto img_data = sln::to_image_data_view(img, bench_pixel_format<PixelType>());
+  std::vector<std::uint8_t> buffer;
+
+  for (auto _ : state)
+  {
+    buffer.clear();
+    benchmark::DoNotOptimize(sln::write_png(img_data, sln::VectorWriter(buffer)));
+  }
+
+  set_bytes_processed(state, img);
+  state.counters["compressed_bytes"] = static_cast<double>(buffer.size());
+}
+
+// As png_write_memory, but compressing in parallel on a thread pool. Zero threads denotes single-threaded writing.
+template <typename PixelType>
+void png_write_memory_parallel(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto img_data = sln::to_image_data_view(img, bench_pixel_format<PixelType>());
+  const auto thread_pool = make_thread_pool(state);
+  std::vector<std::uint8_t> buffer;
+
+  for (auto _ : state)
+  {
+    buffer.clear();
+    benchmark::DoNotOptimize(thread_pool ? sln::write_png(img_data, sln::VectorWriter(buffer), *thread_pool)
+                                         : sln::write_png(img_data, sln::VectorWriter(buffer)));
+  }
+
+  set_bytes_processed(state, img);
+  state.counters["compressed_bytes"] = static_cast<double>(buffer.size());
+}
+
+// Compression speed and compressed size of the compression presets, on the synthetic benchmark image.
+template <typename PixelType>
+void png_write_memory_preset(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto img_data = sln::to_image_data_view(img, bench_pixel_format<PixelType>());
+  const auto options = sln::PNGCompressionOptions(static_cast<sln::PNGCompressionPreset>(state.range(1)));
+  std::vector<std::uint8_t> buffer;
+
+  for (auto _ : state)
+  {
+    buffer.clear();
+    benchmark::DoNotOptimize(sln::write_png(img_data, sln::VectorWriter(buffer), options));
+  }
+
+  set_bytes_processed(state, img);
+  state.counters["compressed_bytes"] = static_cast<double>(buffer.size());
+  state.SetLabel(preset_name(state.range(1)));
+}
+
+// Compression speed and compressed size of the compression presets, on the images of the PNG suite.
+void png_write_suite_preset(benchmark::State& state)
+{
+  const auto& corpus = png_suite_corpus();
+  const auto options = sln::PNGCompressionOptions(static_cast<sln::PNGCompressionPreset>(state.range(0)));
+  std::vector<std::uint8_t> buffer;
+  std::size_t uncompressed_bytes = 0;
+  std::size_t compressed_bytes = 0;
+
+  for (auto _ : state)
+  {
+    uncompressed_bytes = 0;
+    compressed_bytes = 0;
+
+    for (const auto& img_data : corpus)
+    {
+      buffer.clear();
+      benchmark::DoNotOptimize(sln::write_png(img_data, sln::VectorWriter(buffer), options));
+      uncompressed_bytes += img_data.total_bytes();
+      compressed_bytes += buffer.size();
+    }
+  }
+
+  set_bytes_processed(state, uncompressed_bytes);
+  state.counters["compressed_bytes"] = static_cast<double>(compressed_bytes);
+  state.SetLabel(preset_name(state.range(0)));
+}
+
+template <typename PixelType>
+void png_write_file(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto img_data = sln::to_image_data_view(img, bench_pixel_format<PixelType>());
+  const auto path = bench_file_path<PixelType>(state);
+
+  for (auto _ : state)
+  {
+    benchmark::DoNotOptimize(sln::write_png(img_data, sln::FileWriter(path)));
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void png_read_memory(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto buffer = encode_bench_image(img);
+
+  for (auto _ : state)
+  {
+    auto img_data = sln::read_png(sln::MemoryReader(buffer.data(), buffer.size()));
+    benchmark::DoNotOptimize(img_data.byte_ptr());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+// As png_read_memory, but reusing a pooled decompression object and pooled memory for the output image data.
+template <typename PixelType>
+void png_read_memory_pooled(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto buffer = encode_bench_image(img);
+  sln::DecoderPool decoder_pool;
+  sln::ImageBufferPool buffer_pool;
+
+  for (auto _ : state)
+  {
+    auto obj = decoder_pool.png().acquire();
+    auto img_data = sln::read_png(*obj, sln::MemoryReader(buffer.data(), buffer.size()), buffer_pool);
+    benchmark::DoNotOptimize(img_data.image_data().byte_ptr());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void png_read_file(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto path = bench_file_path<PixelType>(state);
+  sln::write_png(sln::to_image_data_view(img, bench_pixel_format<PixelType>()), sln::FileWriter(path));
+
+  for (auto _ : state)
+  {
+    auto img_data = sln::read_png(sln::FileReader(path));
+    benchmark::DoNotOptimize(img_data.byte_ptr());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void png_read_mmap(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto path = bench_file_path<PixelType>(state);
+  sln::write_png(sln::to_image_data_view(img, bench_pixel_format<PixelType>()), sln::FileWriter(path));
+
+  for (auto _ : state)
+  {
+    auto img_data = sln::read_png(sln::MMapReader(path));
+    benchmark::DoNotOptimize(img_data.byte_ptr());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+void io_arguments(benchmark::internal::Benchmark* b)
+{
+  megapixel_arguments(b, {1, 12});
+}
+
+void io_preset_arguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"MP", "preset"});
+  for (auto megapixels : {1, 12})
+  {
+    for (auto preset : {sln::PNGCompressionPreset::Fastest, sln::PNGCompressionPreset::Balanced,
+                        sln::PNGCompressionPreset::Smallest})
+    {
+      b->Args({megapixels, static_cast<int>(preset)});
+    }
+  }
+  b->Unit(benchmark::kMillisecond);
+}
+
+void io_thread_arguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"MP", "threads"});
+  for (auto megapixels : {1, 12})
+  {
+    for (auto threads : {0, 2, 4, 8})
+    {
+      b->Args({megapixels, threads});
+    }
+  }
+  b->Unit(benchmark::kMillisecond);
+  b->UseRealTime();
+}
+
+BENCHMARK_TEMPLATE(png_write_memory, sln::Pixel_8u1)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_write_memory, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_write_memory, sln::Pixel_8u4)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_write_memory, sln::Pixel_16u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_write_memory_parallel, sln::Pixel_8u3)->Apply(io_thread_arguments);
+BENCHMARK_TEMPLATE(png_write_memory_preset, sln::Pixel_8u3)->Apply(io_preset_arguments);
+BENCHMARK(png_write_suite_preset)->ArgName("preset")->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(png_write_file, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_read_memory, sln::Pixel_8u1)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_read_memory, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_read_memory, sln::Pixel_8u4)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_read_memory, sln::Pixel_16u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_read_memory_pooled, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_read_file, sln::Pixel_8u3)->Apply(io_arguments);
+BENCHMARK_TEMPLATE(png_read_mmap, sln::Pixel_8u3)->Apply(io_arguments);
+
+#endif  // defined(SELENE_WITH_LIBPNG)
+
+BENCHMARK_MAIN();
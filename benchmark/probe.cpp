@@ -0,0 +1,127 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <benchmark/benchmark.h>
+
+#if defined(SELENE_WITH_LIBJPEG) && defined(SELENE_WITH_LIBPNG)
+
+#include <selene/img/ImageToImageData.hpp>
+#include <selene/img/Pixel.hpp>
+#include <selene/img_io/JPEGRead.hpp>
+#include <selene/img_io/JPEGWrite.hpp>
+#include <selene/img_io/PNGRead.hpp>
+#include <selene/img_io/PNGWrite.hpp>
+#include <selene/img_io/Probe.hpp>
+
+#include <selene/io/FileReader.hpp>
+#include <selene/io/FileUtils.hpp>
+#include <selene/io/VectorWriter.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BenchmarkUtils.hpp"
+
+using namespace sln_benchmark;
+
+namespace {
+
+constexpr std::size_t corpus_size = 300;
+
+// A corpus of 1 MP images: plain JPEG files, JPEG files with 20 KB of embedded metadata (as typically written by
+// cameras), and PNG files.
+const std::vector<std::string>& bench_corpus()
+{
+  static const std::vector<std::string> paths = [] {
+    const auto img = make_bench_image<sln::Pixel_8u3>(bench_width(1), bench_height(1));
+    const auto img_data = sln::to_image_data_view(img, sln::PixelFormat::RGB);
+
+    std::vector<std::uint8_t> jpeg_data;
+    sln::write_jpeg(img_data, sln::VectorWriter(jpeg_data));
+
+    std::vector<std::uint8_t> jpeg_exif_data = jpeg_data;
+    std::vector<std::uint8_t> app_segment(20000, 0x20);
+    app_segment[0] = 0xFF;
+    app_segment[1] = 0xE1;  // APP1
+    app_segment[2] = static_cast<std::uint8_t>((app_segment.size() - 2) >> 8);
+    app_segment[3] = static_cast<std::uint8_t>((app_segment.size() - 2) & 0xFF);
+    jpeg_exif_data.insert(jpeg_exif_data.begin() + 2, app_segment.cbegin(), app_segment.cend());
+
+    std::vector<std::uint8_t> png_data;
+    sln::write_png(img_data, sln::VectorWriter(png_data));
+
+    const auto corpus_path = get_tmp_path() / "probe_corpus";
+    boost::filesystem::create_directories(corpus_path);
+
+    std::vector<std::string> corpus;
+    for (std::size_t i = 0; i < corpus_size; ++i)
+    {
+      const auto& data = (i % 3 == 0) ? jpeg_data : (i % 3 == 1) ? jpeg_exif_data : png_data;
+      const auto extension = (i % 3 == 2) ? ".png" : ".jpg";
+      corpus.push_back((corpus_path / ("img_" + std::to_string(i) + extension)).string());
+      sln::write_data_contents(corpus.back(), data);
+    }
+    return corpus;
+  }();
+
+  return paths;
+}
+
+}  // namespace
+
+// Baseline: header reading as done by read_image(), i.e. trying JPEG first, then PNG, with fresh decompression objects.
+void probe_read_headers(benchmark::State& state)
+{
+  const auto& paths = bench_corpus();
+
+  for (auto _ : state)
+  {
+    for (const auto& path : paths)
+    {
+      sln::FileReader source(path);
+      const auto jpeg_info = sln::read_jpeg_header(source, true);
+      if (jpeg_info.is_valid())
+      {
+        benchmark::DoNotOptimize(jpeg_info.width);
+        continue;
+      }
+
+      const auto png_info = sln::read_png_header(source);
+      benchmark::DoNotOptimize(png_info.width);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(paths.size()));
+}
+
+void probe_images(benchmark::State& state)
+{
+  const auto& paths = bench_corpus();
+  const auto nr_threads = static_cast<std::size_t>(state.range(0));
+  const auto thread_pool = nr_threads > 0 ? std::make_unique<sln::ThreadPool>(nr_threads) : nullptr;
+
+  for (auto _ : state)
+  {
+    const auto infos = thread_pool ? sln::probe_images(paths, *thread_pool) : sln::probe_images(paths);
+    benchmark::DoNotOptimize(infos.data());
+  }
+
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(paths.size()));
+}
+
+BENCHMARK(probe_read_headers)->Unit(benchmark::kMillisecond);
+BENCHMARK(probe_images)
+    ->ArgName("threads")
+    ->Arg(0)
+    ->Arg(2)
+    ->Arg(4)
+    ->Arg(8)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+#endif  // defined(SELENE_WITH_LIBJPEG) && defined(SELENE_WITH_LIBPNG)
+
+BENCHMARK_MAIN();
@@ -0,0 +1,61 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/img/Image.hpp>
+#include <selene/img/Pixel.hpp>
+#include <selene/img_ops/Resample.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkUtils.hpp"
+
+using namespace sln_benchmark;
+
+// Downsampling by a factor of 2 in each dimension; the common case for thumbnail and preview generation.
+template <sln::ImageInterpolationMode mode, sln::InterpolationPrecision precision, typename PixelType>
+void resample_half(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  const auto new_width = sln::to_pixel_length(img.width() / 2);
+  const auto new_height = sln::to_pixel_length(img.height() / 2);
+  sln::Image<PixelType> img_dst;
+  const auto thread_pool = make_thread_pool(state);
+
+  for (auto _ : state)
+  {
+    if (thread_pool)
+    {
+      sln::resample<mode, precision>(img, new_width, new_height, img_dst, *thread_pool);
+    }
+    else
+    {
+      sln::resample<mode, precision>(img, new_width, new_height, img_dst);
+    }
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+constexpr auto floating_point = sln::InterpolationPrecision::FloatingPoint;
+constexpr auto fixed_point = sln::InterpolationPrecision::FixedPoint;
+
+BENCHMARK_TEMPLATE(resample_half, sln::ImageInterpolationMode::NearestNeighbor, floating_point, sln::Pixel_8u3)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(resample_half, sln::ImageInterpolationMode::Bilinear, floating_point, sln::Pixel_8u3)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(resample_half, sln::ImageInterpolationMode::Bilinear, fixed_point, sln::Pixel_8u3)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(resample_half, sln::ImageInterpolationMode::Area, floating_point, sln::Pixel_8u3)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(resample_half, sln::ImageInterpolationMode::Bicubic, floating_point, sln::Pixel_8u3)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(resample_half, sln::ImageInterpolationMode::Lanczos3, floating_point, sln::Pixel_8u3)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(resample_half, sln::ImageInterpolationMode::Bilinear, fixed_point, sln::Pixel_8u1)
+    ->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(resample_half, sln::ImageInterpolationMode::Bilinear, floating_point, sln::Pixel_32f3)
+    ->Apply(megapixel_thread_arguments);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,114 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr std::int64_t nr_tasks = 10000;
+constexpr std::int64_t nr_outer_tasks = 100;
+constexpr std::int64_t nr_inner_tasks = 100;
+
+sln::ThreadPoolScheduler get_scheduler(const benchmark::State& state)
+{
+  return state.range(0) == 0 ? sln::ThreadPoolScheduler::WorkStealing : sln::ThreadPoolScheduler::MultiQueue;
+}
+
+std::int64_t tiny_work(std::int64_t i)
+{
+  auto value = i;
+  for (int k = 0; k < 64; ++k)
+  {
+    value = value * 6364136223846793005LL + 1442695040888963407LL;
+  }
+  return value;
+}
+
+void wait_until(const std::atomic<std::int64_t>& counter, std::int64_t value)
+{
+  while (counter.load(std::memory_order_acquire) < value)
+  {
+    std::this_thread::yield();
+  }
+}
+
+}  // namespace
+
+// Many small tasks pushed from outside of the pool.
+void threadpool_external_push(benchmark::State& state)
+{
+  sln::ThreadPool pool(static_cast<std::size_t>(state.range(1)), get_scheduler(state));
+  std::vector<std::future<std::int64_t>> futures;
+  futures.reserve(nr_tasks);
+
+  for (auto _ : state)
+  {
+    futures.clear();
+    for (std::int64_t i = 0; i < nr_tasks; ++i)
+    {
+      futures.push_back(pool.push(tiny_work, i));
+    }
+
+    for (auto& f : futures)
+    {
+      benchmark::DoNotOptimize(f.get());
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * nr_tasks);
+}
+
+// Tasks that themselves push further tasks to the same pool (as in recursive decomposition).
+void threadpool_nested_push(benchmark::State& state)
+{
+  sln::ThreadPool pool(static_cast<std::size_t>(state.range(1)), get_scheduler(state));
+
+  for (auto _ : state)
+  {
+    std::atomic<std::int64_t> counter{0};
+
+    for (std::int64_t i = 0; i < nr_outer_tasks; ++i)
+    {
+      pool.push([&pool, &counter, i]() {
+        for (std::int64_t j = 0; j < nr_inner_tasks; ++j)
+        {
+          pool.push([&counter, i, j]() {
+            benchmark::DoNotOptimize(tiny_work(i * nr_inner_tasks + j));
+            counter.fetch_add(1, std::memory_order_release);
+          });
+        }
+      });
+    }
+
+    wait_until(counter, nr_outer_tasks * nr_inner_tasks);
+  }
+
+  state.SetItemsProcessed(state.iterations() * nr_outer_tasks * nr_inner_tasks);
+}
+
+void scheduler_arguments(benchmark::internal::Benchmark* b)
+{
+  b->ArgNames({"scheduler", "threads"});
+  for (auto scheduler : {0, 1})
+  {
+    for (auto threads : {1, 8, 64})
+    {
+      b->Args({scheduler, threads});
+    }
+  }
+}
+
+BENCHMARK(threadpool_external_push)->Apply(scheduler_arguments)->UseRealTime();
+BENCHMARK(threadpool_nested_push)->Apply(scheduler_arguments)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,157 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/img/Image.hpp>
+#include <selene/img/Pixel.hpp>
+#include <selene/img_ops/Transformations.hpp>
+
+#include <benchmark/benchmark.h>
+
+#include "BenchmarkUtils.hpp"
+
+using namespace sln::literals;
+using namespace sln_benchmark;
+
+namespace {
+
+// The straightforward per-pixel implementation, as a baseline.
+template <bool flip_h, bool flip_v, typename PixelType>
+void naive_transpose(const sln::Image<PixelType>& img_src, sln::Image<PixelType>& img_dst)
+{
+  img_dst.maybe_allocate(img_src.height(), img_src.width());
+  for (auto dst_y = 0_idx; dst_y < img_dst.height(); ++dst_y)
+  {
+    for (auto dst_x = 0_idx; dst_x < img_dst.width(); ++dst_x)
+    {
+      const auto src_x = flip_v ? sln::PixelIndex{img_src.width() - 1 - dst_y} : dst_y;
+      const auto src_y = flip_h ? sln::PixelIndex{img_src.height() - 1 - dst_x} : dst_x;
+      img_dst(dst_x, dst_y) = img_src(src_x, src_y);
+    }
+  }
+}
+
+}  // namespace
+
+template <typename PixelType>
+void transpose_naive(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  sln::Image<PixelType> img_dst;
+
+  for (auto _ : state)
+  {
+    naive_transpose<false, false>(img, img_dst);
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void transpose_tiled(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  sln::Image<PixelType> img_dst;
+
+  for (auto _ : state)
+  {
+    sln::transpose<false, false>(img, img_dst);
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void rotate_cw90_naive(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  sln::Image<PixelType> img_dst;
+
+  for (auto _ : state)
+  {
+    naive_transpose<true, false>(img, img_dst);
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void rotate_cw90_tiled(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  sln::Image<PixelType> img_dst;
+
+  for (auto _ : state)
+  {
+    sln::rotate<sln::RotationDirection::Clockwise90>(img, img_dst);
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void rotate_cw90_thread_pool(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  sln::Image<PixelType> img_dst;
+  const auto thread_pool = make_thread_pool(state);
+
+  for (auto _ : state)
+  {
+    if (thread_pool)
+    {
+      sln::rotate<sln::RotationDirection::Clockwise90>(img, img_dst, *thread_pool);
+    }
+    else
+    {
+      sln::rotate<sln::RotationDirection::Clockwise90>(img, img_dst);
+    }
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+template <typename PixelType>
+void flip_horizontal_thread_pool(benchmark::State& state)
+{
+  const auto img = make_bench_image<PixelType>(state);
+  sln::Image<PixelType> img_dst;
+  const auto thread_pool = make_thread_pool(state);
+
+  for (auto _ : state)
+  {
+    if (thread_pool)
+    {
+      sln::flip<sln::FlipDirection::Horizontal>(img, img_dst, *thread_pool);
+    }
+    else
+    {
+      sln::flip<sln::FlipDirection::Horizontal>(img, img_dst);
+    }
+    benchmark::DoNotOptimize(img_dst.data());
+  }
+
+  set_bytes_processed(state, img);
+}
+
+BENCHMARK_TEMPLATE(transpose_naive, sln::Pixel_8u1)->Apply(megapixel_arguments);
+BENCHMARK_TEMPLATE(transpose_tiled, sln::Pixel_8u1)->Apply(megapixel_arguments);
+BENCHMARK_TEMPLATE(transpose_naive, sln::Pixel_8u3)->Apply(megapixel_arguments);
+BENCHMARK_TEMPLATE(transpose_tiled, sln::Pixel_8u3)->Apply(megapixel_arguments);
+BENCHMARK_TEMPLATE(transpose_naive, sln::Pixel_8u4)->Apply(megapixel_arguments);
+BENCHMARK_TEMPLATE(transpose_tiled, sln::Pixel_8u4)->Apply(megapixel_arguments);
+
+BENCHMARK_TEMPLATE(rotate_cw90_naive, sln::Pixel_8u3)->Apply(megapixel_arguments);
+BENCHMARK_TEMPLATE(rotate_cw90_tiled, sln::Pixel_8u3)->Apply(megapixel_arguments);
+BENCHMARK_TEMPLATE(rotate_cw90_naive, sln::Pixel_8u4)->Apply(megapixel_arguments);
+BENCHMARK_TEMPLATE(rotate_cw90_tiled, sln::Pixel_8u4)->Apply(megapixel_arguments);
+
+BENCHMARK_TEMPLATE(rotate_cw90_thread_pool, sln::Pixel_8u3)->Apply(megapixel_thread_arguments);
+BENCHMARK_TEMPLATE(flip_horizontal_thread_pool, sln::Pixel_8u3)->Apply(megapixel_thread_arguments);
+
+BENCHMARK_MAIN();
@@ -70,8 +70,6 @@ if (SELENE_BUILD_BENCHMARKS)
     find_package(benchmark REQUIRED)
 endif()
 
-# Threads
+# Threads (needed by selene_base for thread pinning)
 
-if (SELENE_BUILD_TESTS)
-    find_package(Threads REQUIRED)
-endif()
\ No newline at end of file
+find_package(Threads REQUIRED)
\ No newline at end of file
@@ -11,6 +11,50 @@
 
 namespace sln {
 
+namespace {
+
+std::uint8_t* aligned_malloc(std::size_t nr_bytes, std::size_t alignment, bool zeroed) noexcept
+{
+  if (nr_bytes == 0)
+  {
+    return nullptr;
+  }
+
+  // Ensure that the alignment is a power of two
+  alignment = static_cast<std::size_t>(sln::next_power_of_two(std::max(alignment, std::size_t{2})));
+
+  // TODO: C++17's aligned_alloc (http://en.cppreference.com/w/cpp/memory/c/aligned_alloc) would make life easier...
+
+  // Allocate extra space for storing the alignment offset, and to fit the alignment itself
+  const auto offset_ptr_storage = std::size_t{sizeof(void*)};
+  const auto offset_alignment = alignment;
+  const auto total_bytes = offset_ptr_storage + offset_alignment + nr_bytes;
+  void* const m_ptr = zeroed ? std::calloc(total_bytes, 1) : std::malloc(total_bytes);
+
+  if (m_ptr == nullptr)
+  {
+    return nullptr;
+  }
+
+  // Compute the aligned pointer
+  auto m_ptr_2 = reinterpret_cast<void*>(reinterpret_cast<std::uint8_t*>(m_ptr) + offset_ptr_storage);
+  std::size_t space = offset_alignment + nr_bytes;
+  void* const a_ptr = std::align(alignment, sizeof(std::uint8_t), m_ptr_2, space);
+
+  if (a_ptr == nullptr)
+  {
+    std::free(m_ptr);
+    return nullptr;
+  }
+
+  // Store malloc'ed pointer before the aligned memory block (i.e. outside of the zero-initialized data)
+  (reinterpret_cast<void**>(a_ptr))[-1] = m_ptr;
+
+  return reinterpret_cast<std::uint8_t*>(a_ptr);
+}
+
+}  // namespace
+
 /** \brief Allocates the specified number of bytes via `std::malloc` and returns a MemoryBlock.
  *
  * \param nr_bytes The number of bytes to allocate.
@@ -28,6 +72,23 @@ MemoryBlock<MallocAllocator> MallocAllocator::allocate(std::size_t nr_bytes) noe
   return construct_memory_block_from_existing_memory<MallocAllocator>(ptr, (ptr == nullptr) ? 0 : nr_bytes);
 }
 
+/** \brief Allocates the specified number of zero-initialized bytes via `std::calloc` and returns a MemoryBlock.
+ *
+ * \param nr_bytes The number of bytes to allocate.
+ * \return A MemoryBlock instance with a pointer to the allocated data. If no data could be allocated, the MemoryBlock
+ *         will point to nullptr.
+ */
+MemoryBlock<MallocAllocator> MallocAllocator::allocate_zeroed(std::size_t nr_bytes) noexcept
+{
+  if (nr_bytes == 0)
+  {
+    return construct_memory_block_from_existing_memory<MallocAllocator>(nullptr, 0);
+  }
+
+  auto ptr = static_cast<std::uint8_t*>(std::calloc(nr_bytes, 1));
+  return construct_memory_block_from_existing_memory<MallocAllocator>(ptr, (ptr == nullptr) ? 0 : nr_bytes);
+}
+
 /** \brief Deallocates the previously allocated memory block using `std::free`.
  *
  * \param data A pointer to previously allocated data.
@@ -53,41 +114,25 @@ void MallocAllocator::deallocate(std::uint8_t*& data) noexcept
 MemoryBlock<AlignedMallocAllocator> AlignedMallocAllocator::allocate(std::size_t nr_bytes,
                                                                      std::size_t alignment) noexcept
 {
-  if (nr_bytes == 0)
-  {
-    return construct_memory_block_from_existing_memory<AlignedMallocAllocator>(nullptr, 0);
-  }
-
-  // Ensure that the alignment is a power of two
-  alignment = static_cast<std::size_t>(sln::next_power_of_two(std::max(alignment, std::size_t{2})));
-
-  // TODO: C++17's aligned_alloc (http://en.cppreference.com/w/cpp/memory/c/aligned_alloc) would make life easier...
-
-  // Allocate extra space for storing the alignment offset, and to fit the alignment itself
-  const auto offset_ptr_storage = std::size_t{sizeof(void*)};
-  const auto offset_alignment = alignment;
-  void* const m_ptr = std::malloc(offset_ptr_storage + offset_alignment + nr_bytes);
-
-  if (m_ptr == nullptr)
-  {
-    return construct_memory_block_from_existing_memory<AlignedMallocAllocator>(nullptr, 0);
-  }
-
-  // Compute the aligned pointer
-  auto m_ptr_2 = reinterpret_cast<void*>(reinterpret_cast<std::uint8_t*>(m_ptr) + offset_ptr_storage);
-  std::size_t space = offset_alignment + nr_bytes;
-  void* const a_ptr = std::align(alignment, sizeof(std::uint8_t), m_ptr_2, space);
-
-  if (a_ptr == nullptr)
-  {
-    return construct_memory_block_from_existing_memory<AlignedMallocAllocator>(nullptr, 0);
-  }
-
-  // Store malloc'ed pointer before the aligned memory block
-  (reinterpret_cast<void**>(a_ptr))[-1] = m_ptr;
+  const auto ptr = aligned_malloc(nr_bytes, alignment, false);
+  return construct_memory_block_from_existing_memory<AlignedMallocAllocator>(ptr, (ptr == nullptr) ? 0 : nr_bytes);
+}
 
-  auto ptr = reinterpret_cast<std::uint8_t*>(a_ptr);
-  return construct_memory_block_from_existing_memory<AlignedMallocAllocator>(ptr, nr_bytes);
+/** \brief Allocates the specified number of zero-initialized bytes via `std::calloc` and returns a MemoryBlock.
+ *
+ * For large allocations, `std::calloc` can usually hand out fresh pages from the operating system, which are zeroed
+ * lazily on first access, instead of clearing the memory up front.
+ *
+ * \param nr_bytes The number of bytes to allocate.
+ * \param alignment The required byte alignment. Needs to be a power of two (e.g. 8, 16, 32, ...).
+ * \return A MemoryBlock instance with a pointer to the allocated data. If no data could be allocated, the MemoryBlock
+ *         will point to nullptr.
+ */
+MemoryBlock<AlignedMallocAllocator> AlignedMallocAllocator::allocate_zeroed(std::size_t nr_bytes,
+                                                                            std::size_t alignment) noexcept
+{
+  const auto ptr = aligned_malloc(nr_bytes, alignment, true);
+  return construct_memory_block_from_existing_memory<AlignedMallocAllocator>(ptr, (ptr == nullptr) ? 0 : nr_bytes);
 }
 
 /** \brief Deallocates the previously allocated memory block using `std::free`.
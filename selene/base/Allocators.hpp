@@ -17,26 +17,28 @@ class MemoryBlock;
 
 /** \brief Provides means for memory allocation and deallocation throughout the library.
  *
- * The MallocAllocator wraps `std::malloc` and `std::free` in a consistent interface.
+ * The MallocAllocator wraps `std::malloc` (or `std::calloc`) and `std::free` in a consistent interface.
  *
  *  Used in various places inside the library. Not recommended for memory management outside of the library.
  */
 struct MallocAllocator
 {
   static MemoryBlock<MallocAllocator> allocate(std::size_t nr_bytes) noexcept;
+  static MemoryBlock<MallocAllocator> allocate_zeroed(std::size_t nr_bytes) noexcept;
   static void deallocate(std::uint8_t*& data) noexcept;
 };
 
 /** \brief Provides means for aligned memory allocation and deallocation throughout the library.
  *
- * The AlignedMallocAllocator wraps `std::malloc` and `std::free` in a consistent interface, and provides means for
- * specifying alignment of the allocated memory.
+ * The AlignedMallocAllocator wraps `std::malloc` (or `std::calloc`) and `std::free` in a consistent interface, and
+ * provides means for specifying alignment of the allocated memory.
  *
  *  Used in various places inside the library. Not recommended for memory management outside of the library.
  */
 struct AlignedMallocAllocator
 {
   static MemoryBlock<AlignedMallocAllocator> allocate(std::size_t nr_bytes, std::size_t alignment) noexcept;
+  static MemoryBlock<AlignedMallocAllocator> allocate_zeroed(std::size_t nr_bytes, std::size_t alignment) noexcept;
   static void deallocate(std::uint8_t*& data) noexcept;
 };
 
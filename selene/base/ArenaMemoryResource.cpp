@@ -0,0 +1,156 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/Allocators.hpp>
+#include <selene/base/ArenaMemoryResource.hpp>
+
+#include <algorithm>
+
+namespace sln {
+
+namespace {
+
+constexpr std::size_t chunk_alignment = 64;
+
+}  // namespace
+
+/** \brief Constructor. Does not allocate any memory yet.
+ *
+ * @param chunk_size The minimum size of each chunk allocated from the system, in bytes. Larger allocation requests are
+ * served from chunks of the respective size.
+ */
+ArenaMemoryResource::ArenaMemoryResource(std::size_t chunk_size) : chunk_size_(chunk_size)
+{
+}
+
+/** \brief Destructor. Frees all chunks. */
+ArenaMemoryResource::~ArenaMemoryResource()
+{
+  release();
+}
+
+/** \brief Reclaims all memory allocated from the arena, while retaining the chunks for subsequent allocations.
+ *
+ * If more than one chunk is held, the chunks are replaced by a single chunk of their combined size, so that the same
+ * sequence of allocations fits into one chunk afterwards.
+ */
+void ArenaMemoryResource::reset() noexcept
+{
+  if (chunks_.size() > 1)
+  {
+    const auto total_size = capacity();
+    release();
+    allocate_chunk(total_size);
+  }
+
+  current_chunk_ = 0;
+  current_offset_ = 0;
+  nr_bytes_allocated_ = 0;
+}
+
+/** \brief Reclaims all memory allocated from the arena, and frees all chunks. */
+void ArenaMemoryResource::release() noexcept
+{
+  for (auto& chunk : chunks_)
+  {
+    AlignedNewAllocator::deallocate(chunk.data);
+  }
+
+  chunks_.clear();
+  current_chunk_ = 0;
+  current_offset_ = 0;
+  nr_bytes_allocated_ = 0;
+}
+
+/** \brief Returns the number of bytes allocated from the arena since construction or the last reset.
+ *
+ * @return The number of allocated bytes, excluding any alignment padding.
+ */
+std::size_t ArenaMemoryResource::nr_bytes_allocated() const noexcept
+{
+  return nr_bytes_allocated_;
+}
+
+/** \brief Returns the combined size of all chunks held by the arena.
+ *
+ * @return The capacity in bytes.
+ */
+std::size_t ArenaMemoryResource::capacity() const noexcept
+{
+  std::size_t total_size = 0;
+
+  for (const auto& chunk : chunks_)
+  {
+    total_size += chunk.size;
+  }
+
+  return total_size;
+}
+
+/** \brief Returns the number of chunks held by the arena.
+ *
+ * @return The number of chunks.
+ */
+std::size_t ArenaMemoryResource::nr_chunks() const noexcept
+{
+  return chunks_.size();
+}
+
+std::uint8_t* ArenaMemoryResource::do_allocate(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+  for (;;)
+  {
+    if (current_chunk_ == chunks_.size() && !allocate_chunk(nr_bytes + alignment))
+    {
+      return nullptr;
+    }
+
+    const auto& chunk = chunks_[current_chunk_];
+    const auto address = reinterpret_cast<std::uintptr_t>(chunk.data) + current_offset_;
+    const auto padding = (alignment - address % alignment) % alignment;
+
+    if (current_offset_ + padding + nr_bytes <= chunk.size)
+    {
+      const auto data = chunk.data + current_offset_ + padding;
+      current_offset_ += padding + nr_bytes;
+      nr_bytes_allocated_ += nr_bytes;
+      return data;
+    }
+
+    // Continue with the next chunk; the remainder of the current one stays unused until the next reset
+    ++current_chunk_;
+    current_offset_ = 0;
+  }
+}
+
+void ArenaMemoryResource::do_deallocate(std::uint8_t* /*data*/) noexcept
+{
+  // Memory is reclaimed in bulk by reset()
+}
+
+bool ArenaMemoryResource::allocate_chunk(std::size_t min_size) noexcept
+{
+  const auto size = std::max(chunk_size_, min_size);
+
+  try
+  {
+    chunks_.reserve(chunks_.size() + 1);
+  }
+  catch (...)
+  {
+    return false;
+  }
+
+  auto memory = AlignedNewAllocator::allocate(size, chunk_alignment);
+
+  if (memory.data() == nullptr)
+  {
+    return false;
+  }
+
+  chunks_.push_back(Chunk{memory.transfer_data(), size});
+  return true;
+}
+
+}  // namespace sln
@@ -0,0 +1,61 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_ARENA_MEMORY_RESOURCE_HPP
+#define SELENE_BASE_ARENA_MEMORY_RESOURCE_HPP
+
+/// @file
+
+#include <selene/base/MemoryResource.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace sln {
+
+/** \brief Memory resource handing out memory by incrementing a pointer into large chunks ("bump allocation").
+ *
+ * Deallocation is a no-op; instead, all memory allocated from the arena is reclaimed at once by calling reset(). The
+ * chunks are retained across resets, so that e.g. the intermediate images of each request of a processing pipeline can
+ * be allocated without any calls into the system allocator, once the arena has grown to the size needed by a request.
+ * If more than one chunk was in use, reset() replaces them with a single chunk of their combined size.
+ *
+ * Not thread-safe. Any images allocated from the arena need to be destroyed (or cleared) before calling reset().
+ */
+class ArenaMemoryResource : public MemoryResource
+{
+public:
+  explicit ArenaMemoryResource(std::size_t chunk_size = std::size_t{16} << 20);
+  ~ArenaMemoryResource() override;
+
+  void reset() noexcept;
+  void release() noexcept;
+
+  std::size_t nr_bytes_allocated() const noexcept;
+  std::size_t capacity() const noexcept;
+  std::size_t nr_chunks() const noexcept;
+
+protected:
+  std::uint8_t* do_allocate(std::size_t nr_bytes, std::size_t alignment) noexcept override;
+  void do_deallocate(std::uint8_t* data) noexcept override;
+
+private:
+  struct Chunk
+  {
+    std::uint8_t* data;
+    std::size_t size;
+  };
+
+  std::vector<Chunk> chunks_;
+  std::size_t chunk_size_;
+  std::size_t current_chunk_ = 0;  // index of the chunk currently allocated from
+  std::size_t current_offset_ = 0;  // number of bytes used in the current chunk
+  std::size_t nr_bytes_allocated_ = 0;
+
+  bool allocate_chunk(std::size_t min_size) noexcept;
+};
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_ARENA_MEMORY_RESOURCE_HPP
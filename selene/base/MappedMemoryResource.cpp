@@ -0,0 +1,317 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/Allocators.hpp>
+#include <selene/base/MappedMemoryResource.hpp>
+#include <selene/base/Numa.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SELENE_BASE_HAVE_MMAP
+#endif
+
+#if defined(SELENE_BASE_HAVE_MMAP)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace sln {
+
+namespace {
+
+// Stored directly in front of each allocation.
+struct AllocationHeader
+{
+  std::uint8_t* base;  // beginning of the mapping, or of the memory allocated via AlignedNewAllocator
+  std::size_t size;  // size of the mapping; 0 for memory allocated via AlignedNewAllocator
+};
+
+AllocationHeader read_header(const std::uint8_t* data) noexcept
+{
+  AllocationHeader header;
+  std::memcpy(&header, data - sizeof(AllocationHeader), sizeof(AllocationHeader));
+  return header;
+}
+
+void write_header(std::uint8_t* data, const AllocationHeader& header) noexcept
+{
+  std::memcpy(data - sizeof(AllocationHeader), &header, sizeof(AllocationHeader));
+}
+
+// Offset of the returned memory from the beginning of the allocation; leaves room for the header, and preserves the
+// alignment of the allocation (both are powers of two).
+std::size_t data_offset(std::size_t alignment) noexcept
+{
+  return std::max(alignment, sizeof(AllocationHeader));
+}
+
+std::size_t round_up(std::size_t value, std::size_t multiple) noexcept
+{
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+#if defined(SELENE_BASE_HAVE_MMAP)
+std::size_t page_size() noexcept
+{
+  static const auto size = static_cast<std::size_t>(std::max(::sysconf(_SC_PAGESIZE), 4096l));
+  return size;
+}
+#endif
+
+bool bind_to_numa_node(void* addr, std::size_t len, int node) noexcept
+{
+#if defined(__linux__)
+  constexpr int mpol_bind = 2;  // MPOL_BIND, as defined in <numaif.h>
+  constexpr std::size_t bits_per_word = sizeof(unsigned long) * 8;
+
+  try
+  {
+    const auto node_index = static_cast<std::size_t>(node);
+    std::vector<unsigned long> node_mask(node_index / bits_per_word + 1, 0ul);
+    node_mask[node_index / bits_per_word] |= 1ul << (node_index % bits_per_word);
+    const auto max_node = node_mask.size() * bits_per_word + 1;
+    return ::syscall(SYS_mbind, addr, len, mpol_bind, node_mask.data(), max_node, 0u) == 0;
+  }
+  catch (...)
+  {
+    return false;
+  }
+#else
+  static_cast<void>(addr);
+  static_cast<void>(len);
+  static_cast<void>(node);
+  return false;
+#endif
+}
+
+}  // namespace
+
+constexpr int MappedMemoryResource::any_numa_node;
+constexpr int MappedMemoryResource::local_numa_node;
+constexpr std::size_t MappedMemoryResource::default_min_mapping_size;
+
+/** \brief Constructor.
+ *
+ * @param huge_pages Whether mapped memory should be backed by huge pages.
+ * @param numa_node The NUMA node to bind mapped memory to. Can also be `any_numa_node` (no binding) or
+ * `local_numa_node` (binding to the node of the allocating thread).
+ * @param min_mapping_size The minimum allocation size, in bytes, for which memory is mapped from the system.
+ */
+MappedMemoryResource::MappedMemoryResource(HugePages huge_pages, int numa_node, std::size_t min_mapping_size)
+    : huge_pages_(huge_pages), numa_node_(numa_node), min_mapping_size_(min_mapping_size)
+{
+}
+
+/** \brief Returns whether mapped memory is backed by huge pages.
+ *
+ * @return The huge page mode.
+ */
+HugePages MappedMemoryResource::huge_pages() const noexcept
+{
+  return huge_pages_;
+}
+
+/** \brief Returns the NUMA node mapped memory is bound to.
+ *
+ * @return The NUMA node index, `any_numa_node`, or `local_numa_node`.
+ */
+int MappedMemoryResource::numa_node() const noexcept
+{
+  return numa_node_;
+}
+
+/** \brief Returns the minimum allocation size for which memory is mapped from the system.
+ *
+ * @return The mapping threshold in bytes.
+ */
+std::size_t MappedMemoryResource::min_mapping_size() const noexcept
+{
+  return min_mapping_size_;
+}
+
+/** \brief Returns the number of allocations served by mapping memory from the system so far.
+ *
+ * @return The number of mappings.
+ */
+std::size_t MappedMemoryResource::nr_mappings() const noexcept
+{
+  return nr_mappings_.load();
+}
+
+/** \brief Returns the number of mappings that were successfully bound to a NUMA node so far.
+ *
+ * @return The number of bound mappings.
+ */
+std::size_t MappedMemoryResource::nr_bound_mappings() const noexcept
+{
+  return nr_bound_mappings_.load();
+}
+
+/** \brief Returns the (default) huge page size of the system.
+ *
+ * @return The huge page size in bytes; 2 MiB if it cannot be determined.
+ */
+std::size_t MappedMemoryResource::huge_page_size() noexcept
+{
+  static const std::size_t size = []() -> std::size_t {
+    try
+    {
+      std::ifstream ifs("/proc/meminfo");
+      std::string key;
+      std::size_t value = 0;
+
+      while (ifs >> key >> value)
+      {
+        if (key == "Hugepagesize:")
+        {
+          return value * 1024;  // in kB
+        }
+
+        ifs.ignore(256, '\n');
+      }
+    }
+    catch (...)
+    {
+    }
+
+    return std::size_t{2} << 20;
+  }();
+
+  return size;
+}
+
+std::uint8_t* MappedMemoryResource::do_allocate(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+#if defined(SELENE_BASE_HAVE_MMAP)
+  if (nr_bytes >= min_mapping_size_)
+  {
+    return map(nr_bytes, alignment);
+  }
+#endif
+
+  const auto offset = data_offset(alignment);
+  auto memory = AlignedNewAllocator::allocate(offset + nr_bytes, alignment);
+
+  if (memory.data() == nullptr)
+  {
+    return nullptr;
+  }
+
+  const auto base = memory.transfer_data();
+  write_header(base + offset, AllocationHeader{base, 0});
+  return base + offset;
+}
+
+std::uint8_t* MappedMemoryResource::do_allocate_zeroed(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+#if defined(SELENE_BASE_HAVE_MMAP)
+  if (nr_bytes >= min_mapping_size_)
+  {
+    // Fresh anonymous mappings are zero-initialized; only the header in front of the data has been written to.
+    return map(nr_bytes, alignment);
+  }
+#endif
+
+  return MemoryResource::do_allocate_zeroed(nr_bytes, alignment);
+}
+
+void MappedMemoryResource::do_deallocate(std::uint8_t* data) noexcept
+{
+  auto header = read_header(data);
+
+  if (header.size == 0)
+  {
+    AlignedNewAllocator::deallocate(header.base);
+    return;
+  }
+
+#if defined(SELENE_BASE_HAVE_MMAP)
+  ::munmap(header.base, header.size);
+#endif
+}
+
+std::uint8_t* MappedMemoryResource::map(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+#if defined(SELENE_BASE_HAVE_MMAP)
+  const auto granularity = (huge_pages_ == HugePages::None) ? page_size() : huge_page_size();
+  const auto offset = data_offset(alignment);
+  const auto size = round_up(offset + nr_bytes, granularity);
+  void* base = MAP_FAILED;
+
+#if defined(MAP_HUGETLB)
+  if (huge_pages_ == HugePages::Explicit && alignment <= granularity)
+  {
+    // Huge page mappings are aligned to the huge page size
+    base = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  }
+#endif
+
+  if (base == MAP_FAILED)
+  {
+    // Map a larger region, and trim it such that the mapping is aligned to the (huge) page size; transparent huge pages
+    // can only back suitably aligned memory.
+    const auto base_alignment = std::max(granularity, alignment);
+    const auto extra_size = base_alignment - page_size();
+    const auto raw_base =
+        ::mmap(nullptr, size + extra_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (raw_base == MAP_FAILED)
+    {
+      return nullptr;
+    }
+
+    const auto raw_address = reinterpret_cast<std::uintptr_t>(raw_base);
+    const auto address = round_up(raw_address, base_alignment);
+    const auto head_size = address - raw_address;
+    const auto tail_size = extra_size - head_size;
+
+    if (head_size > 0)
+    {
+      ::munmap(raw_base, head_size);
+    }
+
+    if (tail_size > 0)
+    {
+      ::munmap(reinterpret_cast<void*>(address + size), tail_size);
+    }
+
+    base = reinterpret_cast<void*>(address);
+
+#if defined(MADV_HUGEPAGE)
+    if (huge_pages_ != HugePages::None)
+    {
+      ::madvise(base, size, MADV_HUGEPAGE);  // purely advisory; failure is not an error
+    }
+#endif
+  }
+
+  // Bind before the first access, which faults in the first pages
+  const auto node = (numa_node_ == local_numa_node) ? current_numa_node() : numa_node_;
+
+  if (node >= 0 && bind_to_numa_node(base, size, node))
+  {
+    ++nr_bound_mappings_;
+  }
+
+  ++nr_mappings_;
+  const auto data = static_cast<std::uint8_t*>(base) + offset;
+  write_header(data, AllocationHeader{static_cast<std::uint8_t*>(base), size});
+  return data;
+#else
+  static_cast<void>(nr_bytes);
+  static_cast<void>(alignment);
+  return nullptr;
+#endif
+}
+
+}  // namespace sln
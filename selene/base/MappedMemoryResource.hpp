@@ -0,0 +1,82 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_MAPPED_MEMORY_RESOURCE_HPP
+#define SELENE_BASE_MAPPED_MEMORY_RESOURCE_HPP
+
+/// @file
+
+#include <selene/base/MemoryResource.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace sln {
+
+/** \brief Describes whether memory mapped by a `MappedMemoryResource` is backed by huge pages. */
+enum class HugePages
+{
+  None,  ///< Regular pages.
+  Transparent,  ///< Transparent huge pages; mappings are aligned to the huge page size and advised (`MADV_HUGEPAGE`).
+  Explicit,  ///< Pages from the reserved huge page pool (`MAP_HUGETLB`), falling back to transparent huge pages.
+};
+
+/** \brief Memory resource mapping large allocations directly from the operating system, optionally backed by huge
+ * pages and bound to a NUMA node.
+ *
+ * Allocations of at least `min_mapping_size` bytes are served by anonymous `mmap` calls, and returned to the system on
+ * deallocation. Backing very large images with (2 MiB) huge pages reduces TLB misses during processing, and binding
+ * their memory to the NUMA node of the processing threads avoids cross-socket memory traffic.
+ *
+ * Smaller allocations are served by `AlignedNewAllocator`.
+ *
+ * Since mapped memory is zeroed by the operating system on first access, zero-initialized allocations (see
+ * `allocate_zeroed()`) of at least `min_mapping_size` bytes come at no additional cost; pages that are never written
+ * to are never faulted in.
+ *
+ * Huge pages and NUMA binding are only supported on Linux, and are applied on a best effort basis: if the system
+ * denies them (e.g. because no huge pages are reserved), the memory is still allocated. On systems without `mmap`,
+ * all allocations are served by `AlignedNewAllocator`.
+ *
+ * To allocate per-node scratch images on a `ThreadPool` pinned with `ThreadPinning::NumaNodes`, use a resource with
+ * `numa_node == local_numa_node`; each allocation is then bound to the node of the allocating thread.
+ */
+class MappedMemoryResource : public MemoryResource
+{
+public:
+  static constexpr int any_numa_node = -1;  ///< Do not bind memory; the system's default (first-touch) policy applies.
+  static constexpr int local_numa_node = -2;  ///< Bind memory to the NUMA node of the allocating thread.
+  static constexpr std::size_t default_min_mapping_size = std::size_t{2} << 20;  ///< Default mapping threshold.
+
+  explicit MappedMemoryResource(HugePages huge_pages = HugePages::Transparent,
+                                int numa_node = any_numa_node,
+                                std::size_t min_mapping_size = default_min_mapping_size);
+
+  HugePages huge_pages() const noexcept;
+  int numa_node() const noexcept;
+  std::size_t min_mapping_size() const noexcept;
+
+  std::size_t nr_mappings() const noexcept;
+  std::size_t nr_bound_mappings() const noexcept;
+
+  static std::size_t huge_page_size() noexcept;
+
+protected:
+  std::uint8_t* do_allocate(std::size_t nr_bytes, std::size_t alignment) noexcept override;
+  std::uint8_t* do_allocate_zeroed(std::size_t nr_bytes, std::size_t alignment) noexcept override;
+  void do_deallocate(std::uint8_t* data) noexcept override;
+
+private:
+  HugePages huge_pages_;
+  int numa_node_;
+  std::size_t min_mapping_size_;
+  std::atomic<std::size_t> nr_mappings_{0};
+  std::atomic<std::size_t> nr_bound_mappings_{0};
+
+  std::uint8_t* map(std::size_t nr_bytes, std::size_t alignment) noexcept;
+};
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_MAPPED_MEMORY_RESOURCE_HPP
@@ -75,19 +75,33 @@ inline MemoryBlock<Allocator>::~MemoryBlock()
   }
 }
 
-/** Move constructor. */
+/** Move constructor. Leaves `other` empty. */
 template <typename Allocator>
 inline MemoryBlock<Allocator>::MemoryBlock(MemoryBlock<Allocator>&& other) noexcept
     : data_(other.data_), size_(other.size_)
 {
+  other.data_ = nullptr;
+  other.size_ = 0;
 }
 
-/** Move assignment operator. */
+/** Move assignment operator. Deallocates the memory currently held, and leaves `other` empty. */
 template <typename Allocator>
 inline MemoryBlock<Allocator>& MemoryBlock<Allocator>::operator=(MemoryBlock<Allocator>&& other) noexcept
 {
+  if (this == &other)
+  {
+    return *this;
+  }
+
+  if (data_ != nullptr)
+  {
+    Allocator::deallocate(data_);
+  }
+
   data_ = other.data_;
   size_ = other.size_;
+  other.data_ = nullptr;
+  other.size_ = 0;
   return *this;
 }
 
@@ -0,0 +1,90 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/Allocators.hpp>
+#include <selene/base/MemoryResource.hpp>
+
+#include <cstdint>
+#include <cstring>
+
+namespace sln {
+
+namespace {
+
+// Both AlignedNewAllocator and AlignedMallocAllocator store the pointer returned by the underlying allocation function
+// directly in front of the aligned block. That pointer is suitably aligned for any fundamental type, so its lowest bit
+// is free to mark the blocks allocated via AlignedMallocAllocator.
+constexpr std::uintptr_t malloc_tag = 1;
+static_assert(sizeof(std::uintptr_t) == sizeof(void*), "Unexpected pointer size");
+
+std::uintptr_t read_allocation_word(const std::uint8_t* data) noexcept
+{
+  std::uintptr_t word;
+  std::memcpy(&word, data - sizeof(void*), sizeof(word));
+  return word;
+}
+
+void write_allocation_word(std::uint8_t* data, std::uintptr_t word) noexcept
+{
+  std::memcpy(data - sizeof(void*), &word, sizeof(word));
+}
+
+class AlignedNewMemoryResource : public MemoryResource
+{
+protected:
+  std::uint8_t* do_allocate(std::size_t nr_bytes, std::size_t alignment) noexcept override
+  {
+    return AlignedNewAllocator::allocate(nr_bytes, alignment).transfer_data();
+  }
+
+  // Large blocks are handed out by `std::calloc` directly from fresh pages of the operating system, which are zeroed
+  // lazily on first access; i.e. the memory does not need to be cleared up front.
+  std::uint8_t* do_allocate_zeroed(std::size_t nr_bytes, std::size_t alignment) noexcept override
+  {
+    const auto ptr = AlignedMallocAllocator::allocate_zeroed(nr_bytes, alignment).transfer_data();
+
+    if (ptr != nullptr)
+    {
+      write_allocation_word(ptr, read_allocation_word(ptr) | malloc_tag);
+    }
+
+    return ptr;
+  }
+
+  void do_deallocate(std::uint8_t* data) noexcept override
+  {
+    const auto word = read_allocation_word(data);
+
+    if (word & malloc_tag)
+    {
+      write_allocation_word(data, word & ~malloc_tag);
+      AlignedMallocAllocator::deallocate(data);
+      return;
+    }
+
+    AlignedNewAllocator::deallocate(data);
+  }
+};
+
+}  // namespace
+
+/** \brief Returns the default memory resource, which allocates through AlignedNewAllocator.
+ *
+ * Memory allocated via `AlignedNewAllocator::allocate` can be deallocated through the default resource, e.g. after
+ * being handed to an image.
+ *
+ * Zero-initialized memory (see `MemoryResource::allocate_zeroed()`) is allocated through `AlignedMallocAllocator`
+ * instead, i.e. via `std::calloc`, which does not need to clear large blocks freshly obtained from the operating system.
+ *
+ * The resource is never destroyed, so that images with static storage duration can still deallocate through it.
+ *
+ * @return The default memory resource.
+ */
+MemoryResource& default_memory_resource() noexcept
+{
+  static auto* const resource = new AlignedNewMemoryResource();
+  return *resource;
+}
+
+}  // namespace sln
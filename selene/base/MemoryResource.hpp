@@ -0,0 +1,299 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_MEMORY_RESOURCE_HPP
+#define SELENE_BASE_MEMORY_RESOURCE_HPP
+
+/// @file
+
+#include <selene/base/MemoryBlock.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace sln {
+
+class MemoryResource;
+
+MemoryResource& default_memory_resource() noexcept;
+
+/** \brief Polymorphic source of (aligned) memory for image data.
+ *
+ * `Image<PixelType>` and `ImageData<>` instances allocate and deallocate their owned memory through a memory resource,
+ * which defaults to default_memory_resource(). Supplying a different resource on construction changes the allocation
+ * strategy for a particular image, without changing its type; see PoolMemoryResource and ArenaMemoryResource.
+ *
+ * Derived classes implement do_allocate() and do_deallocate(), and may override do_allocate_zeroed() if they can
+ * provide zero-initialized memory more cheaply than by clearing it, e.g. from fresh pages mapped from the operating
+ * system, which are zeroed lazily on first access. Memory returned by do_allocate() has to remain valid until it is
+ * passed to do_deallocate() (or, for resources that free memory in bulk, until the documented point in time). As
+ * do_deallocate() is not passed the size of the allocation, resources that need it have to track it themselves.
+ *
+ * A resource needs to outlive all memory allocated from it.
+ */
+class MemoryResource
+{
+public:
+  MemoryResource() = default;  ///< Default constructor.
+  virtual ~MemoryResource() = default;  ///< Destructor.
+
+  MemoryResource(const MemoryResource&) = delete;  ///< Copy constructor (deleted).
+  MemoryResource& operator=(const MemoryResource&) = delete;  ///< Copy assignment operator (deleted).
+
+  MemoryBlock<MemoryResource> allocate(std::size_t nr_bytes, std::size_t alignment) noexcept;
+  MemoryBlock<MemoryResource> allocate_zeroed(std::size_t nr_bytes, std::size_t alignment) noexcept;
+  void deallocate(std::uint8_t*& data) noexcept;
+
+protected:
+  /** \brief Allocates the specified number of bytes.
+   *
+   * @param nr_bytes The number of bytes to allocate; greater than 0.
+   * @param alignment The required byte alignment; a power of two.
+   * @return Pointer to the allocated memory, or `nullptr` if no memory could be allocated.
+   */
+  virtual std::uint8_t* do_allocate(std::size_t nr_bytes, std::size_t alignment) noexcept = 0;
+
+  virtual std::uint8_t* do_allocate_zeroed(std::size_t nr_bytes, std::size_t alignment) noexcept;
+
+  /** \brief Deallocates memory previously returned by do_allocate().
+   *
+   * @param data Pointer to the memory; not `nullptr`.
+   */
+  virtual void do_deallocate(std::uint8_t* data) noexcept = 0;
+};
+
+/** \brief Represents a contiguous block of memory allocated from a MemoryResource instance.
+ *
+ * In contrast to the general `MemoryBlock<Allocator>` template, the instance also stores the resource from which the
+ * memory was allocated, and deallocates the memory through it.
+ */
+template <>
+class MemoryBlock<MemoryResource>
+{
+public:
+  ~MemoryBlock();
+
+  MemoryBlock(const MemoryBlock&) = delete;
+  MemoryBlock& operator=(const MemoryBlock&) = delete;
+
+  MemoryBlock(MemoryBlock&& other) noexcept;
+  MemoryBlock& operator=(MemoryBlock&& other) noexcept;
+
+  std::uint8_t* data() const noexcept;
+  std::size_t size() const noexcept;
+  MemoryResource& resource() const noexcept;
+
+  std::uint8_t* transfer_data() noexcept;
+
+private:
+  std::uint8_t* data_;
+  std::size_t size_;
+  MemoryResource* resource_;
+
+  MemoryBlock(std::uint8_t* data, std::size_t size, MemoryResource& resource) noexcept;
+
+  friend MemoryBlock<MemoryResource> construct_memory_block_from_existing_memory(std::uint8_t*,
+                                                                                 std::size_t,
+                                                                                 MemoryResource&) noexcept;
+};
+
+MemoryBlock<MemoryResource> construct_memory_block_from_existing_memory(std::uint8_t* data,
+                                                                        std::size_t size,
+                                                                        MemoryResource& resource) noexcept;
+
+// ----------
+// Implementation:
+
+/// \cond INTERNAL
+namespace detail {
+
+inline std::size_t normalized_alignment(std::size_t alignment) noexcept
+{
+  std::size_t pow2_alignment = 2;
+  while (pow2_alignment < alignment)
+  {
+    pow2_alignment *= 2;
+  }
+
+  return pow2_alignment;
+}
+
+}  // namespace detail
+/// \endcond
+
+/** \brief Allocates the specified number of bytes from the resource and returns a MemoryBlock.
+ *
+ * @param nr_bytes The number of bytes to allocate.
+ * @param alignment The required byte alignment. Will be rounded up to a power of two, and to at least 2.
+ * @return A MemoryBlock instance with a pointer to the allocated data. If no data could be allocated, the MemoryBlock
+ *         will point to nullptr.
+ */
+inline MemoryBlock<MemoryResource> MemoryResource::allocate(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+  if (nr_bytes == 0)
+  {
+    return construct_memory_block_from_existing_memory(nullptr, 0, *this);
+  }
+
+  const auto ptr = do_allocate(nr_bytes, detail::normalized_alignment(alignment));
+  return construct_memory_block_from_existing_memory(ptr, (ptr == nullptr) ? 0 : nr_bytes, *this);
+}
+
+/** \brief Allocates the specified number of zero-initialized bytes from the resource and returns a MemoryBlock.
+ *
+ * Depending on the resource, this can be considerably cheaper than allocating and subsequently clearing the memory:
+ * memory freshly mapped from the operating system is zeroed lazily on first access, so that e.g. large images of
+ * which only small parts are written to will never be touched in their entirety.
+ *
+ * @param nr_bytes The number of bytes to allocate.
+ * @param alignment The required byte alignment. Will be rounded up to a power of two, and to at least 2.
+ * @return A MemoryBlock instance with a pointer to the allocated data. If no data could be allocated, the MemoryBlock
+ *         will point to nullptr.
+ */
+inline MemoryBlock<MemoryResource> MemoryResource::allocate_zeroed(std::size_t nr_bytes,
+                                                                    std::size_t alignment) noexcept
+{
+  if (nr_bytes == 0)
+  {
+    return construct_memory_block_from_existing_memory(nullptr, 0, *this);
+  }
+
+  const auto ptr = do_allocate_zeroed(nr_bytes, detail::normalized_alignment(alignment));
+  return construct_memory_block_from_existing_memory(ptr, (ptr == nullptr) ? 0 : nr_bytes, *this);
+}
+
+/** \brief Deallocates memory previously allocated from the resource.
+ *
+ * @param data A pointer to previously allocated data. Will be set to `nullptr`.
+ */
+inline void MemoryResource::deallocate(std::uint8_t*& data) noexcept
+{
+  if (data != nullptr)
+  {
+    do_deallocate(data);
+  }
+
+  data = nullptr;
+}
+
+/** \brief Allocates the specified number of zero-initialized bytes.
+ *
+ * The default implementation allocates via do_allocate() and clears the memory.
+ *
+ * @param nr_bytes The number of bytes to allocate; greater than 0.
+ * @param alignment The required byte alignment; a power of two.
+ * @return Pointer to the allocated memory, or `nullptr` if no memory could be allocated.
+ */
+inline std::uint8_t* MemoryResource::do_allocate_zeroed(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+  const auto ptr = do_allocate(nr_bytes, alignment);
+
+  if (ptr != nullptr)
+  {
+    std::memset(ptr, 0, nr_bytes);
+  }
+
+  return ptr;
+}
+
+// ----------
+
+inline MemoryBlock<MemoryResource>::MemoryBlock(std::uint8_t* data, std::size_t size, MemoryResource& resource) noexcept
+    : data_(data), size_(size), resource_(&resource)
+{
+}
+
+inline MemoryBlock<MemoryResource>::~MemoryBlock()
+{
+  resource_->deallocate(data_);
+}
+
+/** Move constructor. Leaves `other` empty. */
+inline MemoryBlock<MemoryResource>::MemoryBlock(MemoryBlock<MemoryResource>&& other) noexcept
+    : data_(other.data_), size_(other.size_), resource_(other.resource_)
+{
+  other.data_ = nullptr;
+  other.size_ = 0;
+}
+
+/** Move assignment operator. Deallocates the memory currently held, and leaves `other` empty. */
+inline MemoryBlock<MemoryResource>& MemoryBlock<MemoryResource>::operator=(MemoryBlock<MemoryResource>&& other) noexcept
+{
+  if (this == &other)
+  {
+    return *this;
+  }
+
+  resource_->deallocate(data_);
+  data_ = other.data_;
+  size_ = other.size_;
+  resource_ = other.resource_;
+  other.data_ = nullptr;
+  other.size_ = 0;
+  return *this;
+}
+
+/** \brief Returns a read-write pointer to the allocated memory.
+ *
+ * \return Pointer to the allocated memory.
+ */
+inline std::uint8_t* MemoryBlock<MemoryResource>::data() const noexcept
+{
+  return data_;
+}
+
+/** \brief Returns the size of the allocated memory.
+ *
+ * \return Size of the allocated memory in bytes.
+ */
+inline std::size_t MemoryBlock<MemoryResource>::size() const noexcept
+{
+  return size_;
+}
+
+/** \brief Returns the memory resource that the memory was allocated from.
+ *
+ * \return The memory resource.
+ */
+inline MemoryResource& MemoryBlock<MemoryResource>::resource() const noexcept
+{
+  return *resource_;
+}
+
+/** \brief Returns (and releases) the data of the MemoryBlock instance, and set the MemoryBlock instance to empty.
+ *
+ * The memory will have to be deallocated manually through `resource()`, since it is now not bound to the MemoryBlock
+ * instance anymore.
+ *
+ * \return Pointer to the data, previously contained in the MemoryBlock instance.
+ */
+inline std::uint8_t* MemoryBlock<MemoryResource>::transfer_data() noexcept
+{
+  auto data = data_;
+  data_ = nullptr;
+  size_ = 0;
+  return data;
+}
+
+/** \brief Constructs a `MemoryBlock<MemoryResource>` instance from existing memory.
+ *
+ * It is important that the supplied memory was allocated from the supplied resource; otherwise, the deallocation is
+ * undefined behavior.
+ *
+ * @param data Pointer to the beginning of the memory region.
+ * @param size Size of the memory region.
+ * @param resource The memory resource that the memory region was allocated from.
+ * @return A `MemoryBlock<MemoryResource>` instance.
+ */
+inline MemoryBlock<MemoryResource> construct_memory_block_from_existing_memory(std::uint8_t* data,
+                                                                               std::size_t size,
+                                                                               MemoryResource& resource) noexcept
+{
+  return MemoryBlock<MemoryResource>(data, size, resource);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_MEMORY_RESOURCE_HPP
@@ -0,0 +1,199 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/Numa.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#define SELENE_BASE_HAVE_LINUX_NUMA
+#endif
+
+#if defined(SELENE_BASE_HAVE_LINUX_NUMA)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace sln {
+
+namespace {
+
+// Parses a Linux CPU or node list, e.g. "0-3,8,10-11".
+std::vector<int> parse_list(const std::string& str)
+{
+  std::vector<int> values;
+  std::istringstream iss(str);
+  std::string range;
+
+  while (std::getline(iss, range, ','))
+  {
+    const auto dash = range.find('-');
+
+    try
+    {
+      const auto first = std::stoi(range.substr(0, dash));
+      const auto last = (dash == std::string::npos) ? first : std::stoi(range.substr(dash + 1));
+
+      for (auto value = first; value <= last; ++value)
+      {
+        values.push_back(value);
+      }
+    }
+    catch (...)
+    {
+      // Skip malformed (e.g. empty) entries
+    }
+  }
+
+  return values;
+}
+
+std::vector<int> read_list(const std::string& filename)
+{
+  std::ifstream ifs(filename);
+  std::string line;
+  std::getline(ifs, line);
+  return parse_list(line);
+}
+
+}  // namespace
+
+/** \brief Returns the number of NUMA nodes of the system.
+ *
+ * The number is determined from the highest online node index, so that node indices are always smaller than the
+ * returned value.
+ *
+ * @return The number of NUMA nodes; 1 if the topology cannot be determined.
+ */
+std::size_t nr_numa_nodes() noexcept
+{
+  static const std::size_t nr_nodes = []() -> std::size_t {
+    try
+    {
+      const auto nodes = read_list("/sys/devices/system/node/online");
+      return nodes.empty() ? 1 : static_cast<std::size_t>(*std::max_element(nodes.cbegin(), nodes.cend())) + 1;
+    }
+    catch (...)
+    {
+      return 1;
+    }
+  }();
+
+  return nr_nodes;
+}
+
+/** \brief Returns the NUMA node of the CPU the calling thread is currently running on.
+ *
+ * Unless the thread is pinned to the CPUs of a single node, the result may be outdated by the time it is used.
+ *
+ * @return The NUMA node index; 0 if it cannot be determined.
+ */
+int current_numa_node() noexcept
+{
+#if defined(SELENE_BASE_HAVE_LINUX_NUMA)
+  unsigned int cpu = 0;
+  unsigned int node = 0;
+
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) == 0)
+  {
+    return static_cast<int>(node);
+  }
+#endif
+
+  return 0;
+}
+
+/** \brief Returns the CPUs the calling process may run on.
+ *
+ * @return The list of CPU indices, in ascending order.
+ */
+std::vector<int> available_cpus()
+{
+  std::vector<int> cpus;
+
+#if defined(SELENE_BASE_HAVE_LINUX_NUMA)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+
+  if (::sched_getaffinity(0, sizeof(set), &set) == 0)
+  {
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+      if (CPU_ISSET(cpu, &set))
+      {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+
+  if (cpus.empty())
+  {
+    const auto nr_cpus = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned int cpu = 0; cpu < nr_cpus; ++cpu)
+    {
+      cpus.push_back(static_cast<int>(cpu));
+    }
+  }
+
+  return cpus;
+}
+
+/** \brief Returns the CPUs of the specified NUMA node that the calling process may run on.
+ *
+ * @param node The NUMA node index.
+ * @return The list of CPU indices, in ascending order. If the topology cannot be determined, all available CPUs are
+ * assigned to node 0.
+ */
+std::vector<int> numa_node_cpus(int node)
+{
+  const auto cpus = available_cpus();
+  auto node_cpus = read_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+
+  if (node_cpus.empty())
+  {
+    return (node == 0 && nr_numa_nodes() == 1) ? cpus : std::vector<int>{};
+  }
+
+  const auto not_available = [&cpus](int cpu) { return !std::binary_search(cpus.cbegin(), cpus.cend(), cpu); };
+  node_cpus.erase(std::remove_if(node_cpus.begin(), node_cpus.end(), not_available), node_cpus.end());
+  return node_cpus;
+}
+
+/** \brief Restricts the calling thread to run on the specified CPUs.
+ *
+ * @param cpus The list of CPU indices.
+ * @return True, if the thread was pinned; false otherwise (e.g. if the list is empty, or pinning is not supported).
+ */
+bool pin_current_thread(const std::vector<int>& cpus) noexcept
+{
+#if defined(SELENE_BASE_HAVE_LINUX_NUMA)
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  bool any_cpu = false;
+
+  for (const auto cpu : cpus)
+  {
+    if (cpu >= 0 && cpu < CPU_SETSIZE)
+    {
+      CPU_SET(cpu, &set);
+      any_cpu = true;
+    }
+  }
+
+  return any_cpu && ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set) == 0;
+#else
+  static_cast<void>(cpus);
+  return false;
+#endif
+}
+
+}  // namespace sln
@@ -0,0 +1,28 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_NUMA_HPP
+#define SELENE_BASE_NUMA_HPP
+
+/// @file
+
+#include <cstdint>
+#include <vector>
+
+namespace sln {
+
+// NUMA topology queries and thread pinning. On systems where the topology cannot be determined, the system is reported
+// as a single NUMA node containing all CPUs, and pinning is a no-op.
+
+std::size_t nr_numa_nodes() noexcept;
+int current_numa_node() noexcept;
+
+std::vector<int> available_cpus();
+std::vector<int> numa_node_cpus(int node);
+
+bool pin_current_thread(const std::vector<int>& cpus) noexcept;
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_NUMA_HPP
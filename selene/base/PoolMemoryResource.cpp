@@ -0,0 +1,402 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/base/Allocators.hpp>
+#include <selene/base/Assert.hpp>
+#include <selene/base/PoolMemoryResource.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace sln {
+
+namespace {
+
+// Stored directly in front of each block handed out by the pool.
+struct BlockHeader
+{
+  std::size_t index;  // size class index, or unpooled_index
+  std::size_t offset;  // offset of the block from the beginning of the underlying allocation
+};
+
+constexpr std::size_t unpooled_index = std::numeric_limits<std::size_t>::max();
+
+BlockHeader read_header(const std::uint8_t* data) noexcept
+{
+  BlockHeader header;
+  std::memcpy(&header, data - sizeof(BlockHeader), sizeof(BlockHeader));
+  return header;
+}
+
+}  // namespace
+
+constexpr std::size_t PoolMemoryResource::min_block_size;
+constexpr std::size_t PoolMemoryResource::block_alignment;
+constexpr std::size_t PoolMemoryResource::nr_size_classes;
+
+// Blocks cached for the allocations of one thread. The mutex is practically uncontended; it only guards against
+// concurrent clear() calls, pool destruction, and thread exit.
+struct PoolMemoryResource::ThreadCache
+{
+  explicit ThreadCache(PoolMemoryResource* pool_) : pool(pool_)
+  {
+    blocks.reserve(pool_->max_blocks_per_thread_);
+  }
+
+  std::mutex mutex;
+  std::atomic<PoolMemoryResource*> pool;  // nullptr after the pool was destroyed
+  std::vector<std::pair<std::size_t, std::uint8_t*>> blocks;  // (size class index, block); most recent last
+  bool orphaned = false;  // true after the owning thread exited
+};
+
+// Thread-local list of the caches of one thread, across all pools.
+struct PoolMemoryResource::ThreadCacheRegistry
+{
+  std::vector<std::shared_ptr<ThreadCache>> caches;
+
+  ~ThreadCacheRegistry()
+  {
+    // Hand the cached blocks back to their pools, since this thread will not allocate from them anymore.
+    for (auto& cache : caches)
+    {
+      std::lock_guard<std::mutex> lock(cache->mutex);
+      const auto pool = cache->pool.load();
+
+      if (pool != nullptr)
+      {
+        for (const auto& block : cache->blocks)
+        {
+          pool->release(block.second, block.first);
+        }
+      }
+
+      cache->blocks.clear();
+      cache->orphaned = true;
+    }
+  }
+};
+
+/** \brief Constructor.
+ *
+ * @param max_blocks_per_class The maximum number of blocks retained per size class in the shared pool.
+ * @param max_blocks_per_thread The maximum number of blocks retained in the cache of each thread. If 0, all
+ * deallocated blocks are directly returned to the shared pool.
+ */
+PoolMemoryResource::PoolMemoryResource(std::size_t max_blocks_per_class, std::size_t max_blocks_per_thread)
+    : max_blocks_per_class_(max_blocks_per_class), max_blocks_per_thread_(max_blocks_per_thread)
+{
+}
+
+/** \brief Destructor. Frees all retained blocks, including those in thread caches. */
+PoolMemoryResource::~PoolMemoryResource()
+{
+  {
+    std::lock_guard<std::mutex> lock(caches_mutex_);
+
+    for (auto& cache : caches_)
+    {
+      std::lock_guard<std::mutex> cache_lock(cache->mutex);
+
+      for (const auto& block : cache->blocks)
+      {
+        free_block(block.second);
+      }
+
+      cache->blocks.clear();
+      cache->pool = nullptr;  // the thread-local registry drops the cache lazily
+    }
+
+    caches_.clear();
+  }
+
+  clear();
+}
+
+/** \brief Frees all blocks retained by the pool, including those in thread caches.
+ *
+ * Memory currently allocated is not affected; it will be returned to the pool on deallocation.
+ */
+void PoolMemoryResource::clear()
+{
+  {
+    std::lock_guard<std::mutex> lock(caches_mutex_);
+
+    for (auto& cache : caches_)
+    {
+      std::lock_guard<std::mutex> cache_lock(cache->mutex);
+
+      for (const auto& block : cache->blocks)
+      {
+        free_block(block.second);
+      }
+
+      cache->blocks.clear();
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (auto& blocks : free_blocks_)
+  {
+    for (auto data : blocks)
+    {
+      free_block(data);
+    }
+
+    blocks.clear();
+  }
+}
+
+/** \brief Returns the number of blocks currently retained by the pool, i.e. deallocated and available for reuse.
+ *
+ * @return The number of pooled blocks, including those in thread caches.
+ */
+std::size_t PoolMemoryResource::nr_pooled_blocks() const
+{
+  std::size_t nr_blocks = 0;
+
+  {
+    std::lock_guard<std::mutex> lock(caches_mutex_);
+
+    for (const auto& cache : caches_)
+    {
+      std::lock_guard<std::mutex> cache_lock(cache->mutex);
+      nr_blocks += cache->blocks.size();
+    }
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (const auto& blocks : free_blocks_)
+  {
+    nr_blocks += blocks.size();
+  }
+
+  return nr_blocks;
+}
+
+/** \brief Returns the number of blocks allocated by the pool from the system so far.
+ *
+ * Once the pool has seen the image sizes of a workload, this number stays constant.
+ *
+ * @return The number of block allocations.
+ */
+std::size_t PoolMemoryResource::nr_allocations() const
+{
+  return nr_allocations_.load();
+}
+
+/** \brief Returns the index of the size class for blocks of the specified size.
+ *
+ * @param nr_bytes The block size in bytes.
+ * @return The size class index.
+ */
+std::size_t PoolMemoryResource::size_class_index(std::size_t nr_bytes)
+{
+  if (nr_bytes <= min_block_size)
+  {
+    return 0;
+  }
+
+  // Find the power-of-two range (base, 2 * base], then the quarter of that range containing nr_bytes
+  std::size_t octave = 0;
+  std::size_t base = min_block_size;
+
+  while (base * 2 < nr_bytes)
+  {
+    base *= 2;
+    ++octave;
+  }
+
+  const auto step = base / 4;
+  const auto quarter = (nr_bytes - base + step - 1) / step;  // 1 to 4
+  const auto index = 1 + 4 * octave + (quarter - 1);
+  SELENE_FORCED_ASSERT(index < nr_size_classes);
+  return index;
+}
+
+/** \brief Returns the block size of the specified size class.
+ *
+ * @param index The size class index.
+ * @return The block size in bytes.
+ */
+std::size_t PoolMemoryResource::size_class_bytes(std::size_t index)
+{
+  if (index == 0)
+  {
+    return min_block_size;
+  }
+
+  const auto octave = (index - 1) / 4;
+  const auto quarter = (index - 1) % 4 + 1;
+  return (min_block_size << octave) / 4 * (4 + quarter);
+}
+
+std::uint8_t* PoolMemoryResource::do_allocate(std::size_t nr_bytes, std::size_t alignment) noexcept
+{
+  if (alignment > block_alignment)
+  {
+    return allocate_block(nr_bytes, alignment, unpooled_index);
+  }
+
+  const auto index = size_class_index(nr_bytes);
+  const auto cache = (max_blocks_per_thread_ > 0) ? thread_cache() : nullptr;
+
+  if (cache != nullptr)
+  {
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    auto& blocks = cache->blocks;
+    const auto it = std::find_if(blocks.rbegin(), blocks.rend(), [index](const auto& b) { return b.first == index; });
+
+    if (it != blocks.rend())
+    {
+      const auto data = it->second;
+      blocks.erase(std::next(it).base());
+      return data;
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& blocks = free_blocks_[index];
+
+    if (!blocks.empty())
+    {
+      const auto data = blocks.back();
+      blocks.pop_back();
+      return data;
+    }
+  }
+
+  return allocate_block(size_class_bytes(index), block_alignment, index);
+}
+
+void PoolMemoryResource::do_deallocate(std::uint8_t* data) noexcept
+{
+  const auto index = read_header(data).index;
+
+  if (index == unpooled_index)
+  {
+    free_block(data);
+    return;
+  }
+
+  const auto cache = (max_blocks_per_thread_ > 0) ? thread_cache() : nullptr;
+
+  if (cache == nullptr)
+  {
+    release(data, index);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(cache->mutex);
+  auto& blocks = cache->blocks;
+
+  if (blocks.size() == max_blocks_per_thread_)
+  {
+    // Evict the least recently cached block; the capacity reserved on construction suffices
+    release(blocks.front().second, blocks.front().first);
+    blocks.erase(blocks.begin());
+  }
+
+  blocks.emplace_back(index, data);
+}
+
+// Returns the cache of the calling thread, or nullptr if it could not be created.
+auto PoolMemoryResource::thread_cache() noexcept -> ThreadCache*
+{
+  static thread_local ThreadCacheRegistry registry;
+
+  for (const auto& cache : registry.caches)
+  {
+    if (cache->pool.load() == this)
+    {
+      return cache.get();
+    }
+  }
+
+  try
+  {
+    // Drop the caches of destroyed pools
+    auto& caches = registry.caches;
+    caches.erase(std::remove_if(caches.begin(), caches.end(), [](const auto& c) { return c->pool.load() == nullptr; }),
+                 caches.end());
+
+    auto cache = std::make_shared<ThreadCache>(this);
+    caches.reserve(caches.size() + 1);
+
+    {
+      std::lock_guard<std::mutex> lock(caches_mutex_);
+
+      // Drop the caches of exited threads
+      caches_.erase(std::remove_if(caches_.begin(), caches_.end(),
+                                   [](const auto& c) {
+                                     std::lock_guard<std::mutex> cache_lock(c->mutex);
+                                     return c->orphaned;
+                                   }),
+                    caches_.end());
+      caches_.push_back(cache);
+    }
+
+    caches.push_back(std::move(cache));
+    return caches.back().get();
+  }
+  catch (...)
+  {
+    return nullptr;
+  }
+}
+
+std::uint8_t* PoolMemoryResource::allocate_block(std::size_t nr_bytes,
+                                                 std::size_t alignment,
+                                                 std::size_t index) noexcept
+{
+  // The header is stored within the leading alignment bytes, which also keeps the block itself aligned
+  const auto offset = std::max(alignment, sizeof(BlockHeader));
+  auto memory = AlignedNewAllocator::allocate(offset + nr_bytes, alignment);
+
+  if (memory.data() == nullptr)
+  {
+    return nullptr;
+  }
+
+  ++nr_allocations_;
+  const auto data = memory.transfer_data() + offset;
+  const BlockHeader header{index, offset};
+  std::memcpy(data - sizeof(BlockHeader), &header, sizeof(BlockHeader));
+  return data;
+}
+
+void PoolMemoryResource::release(std::uint8_t* data, std::size_t index) noexcept
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& blocks = free_blocks_[index];
+
+    if (blocks.size() < max_blocks_per_class_)
+    {
+      // Only allocates while the pool grows; afterwards, the vector capacity suffices.
+      try
+      {
+        blocks.push_back(data);
+        return;
+      }
+      catch (...)
+      {
+      }
+    }
+  }
+
+  free_block(data);
+}
+
+void PoolMemoryResource::free_block(std::uint8_t* data) noexcept
+{
+  auto memory = data - read_header(data).offset;
+  AlignedNewAllocator::deallocate(memory);
+}
+
+}  // namespace sln
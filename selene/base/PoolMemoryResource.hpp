@@ -0,0 +1,80 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_POOL_MEMORY_RESOURCE_HPP
+#define SELENE_BASE_POOL_MEMORY_RESOURCE_HPP
+
+/// @file
+
+#include <selene/base/MemoryResource.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace sln {
+
+/** \brief Thread-safe memory resource that retains deallocated memory blocks for reuse, keyed by size class.
+ *
+ * Requested sizes are rounded up to the next size class: the first class holds blocks of `min_block_size` bytes;
+ * beyond that, each power-of-two range is divided into four classes, so that at most 25% of a block remains unused.
+ * Once the pool has seen the image sizes of a workload, allocations are served from retained blocks, which avoids the
+ * cost of returning large blocks to the operating system and faulting them in again on the next allocation.
+ *
+ * Each thread deallocating memory to the pool keeps up to `max_blocks_per_thread` blocks in a thread-local cache, from
+ * which its own subsequent allocations are served first. Blocks evicted from a thread cache, or cached by an exiting
+ * thread, are moved to the shared pool, which retains at most `max_blocks_per_class` blocks per size class; surplus
+ * blocks are freed.
+ *
+ * Allocations with an alignment larger than `block_alignment` bypass the pool.
+ * The pool needs to outlive all memory allocated from it.
+ */
+class PoolMemoryResource : public MemoryResource
+{
+public:
+  static constexpr std::size_t min_block_size = 4096;  ///< Size of the smallest size class, in bytes.
+  static constexpr std::size_t block_alignment = 64;  ///< Alignment of each pooled block, in bytes.
+
+  explicit PoolMemoryResource(std::size_t max_blocks_per_class = 16, std::size_t max_blocks_per_thread = 4);
+  ~PoolMemoryResource() override;
+
+  void clear();
+
+  std::size_t nr_pooled_blocks() const;
+  std::size_t nr_allocations() const;
+
+  static std::size_t size_class_index(std::size_t nr_bytes);
+  static std::size_t size_class_bytes(std::size_t index);
+
+protected:
+  std::uint8_t* do_allocate(std::size_t nr_bytes, std::size_t alignment) noexcept override;
+  void do_deallocate(std::uint8_t* data) noexcept override;
+
+private:
+  struct ThreadCache;
+  struct ThreadCacheRegistry;
+
+  static constexpr std::size_t nr_size_classes = 1 + 4 * 48;
+
+  mutable std::mutex mutex_;
+  std::array<std::vector<std::uint8_t*>, nr_size_classes> free_blocks_;
+  std::size_t max_blocks_per_class_;
+  std::size_t max_blocks_per_thread_;
+  std::atomic<std::size_t> nr_allocations_{0};
+
+  mutable std::mutex caches_mutex_;
+  std::vector<std::shared_ptr<ThreadCache>> caches_;
+
+  ThreadCache* thread_cache() noexcept;
+  std::uint8_t* allocate_block(std::size_t nr_bytes, std::size_t alignment, std::size_t index) noexcept;
+  void release(std::uint8_t* data, std::size_t index) noexcept;
+  static void free_block(std::uint8_t* data) noexcept;
+};
+
+}  // namespace sln
+
+#endif  // SELENE_BASE_POOL_MEMORY_RESOURCE_HPP
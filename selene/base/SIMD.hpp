@@ -0,0 +1,48 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_BASE_SIMD_HPP
+#define SELENE_BASE_SIMD_HPP
+
+/// @file
+
+// Determines, at compile time, which SIMD instruction sets may be used by vectorized code paths, and includes the
+// corresponding intrinsics headers.
+// Dispatch happens exclusively at compile time (i.e. depends on the target architecture flags passed to the compiler,
+// such as `-msse4.2`, `-mavx2` or `-march=native`). Each code path that makes use of one of the defined macros is
+// required to have a scalar fallback.
+//
+// The following macros may be defined:
+// - SELENE_SIMD_SSE2
+// - SELENE_SIMD_SSSE3
+// - SELENE_SIMD_AVX2
+// - SELENE_SIMD_NEON
+//
+// Definition of SELENE_SIMD_DISABLE suppresses all of the above.
+
+#if !defined(SELENE_SIMD_DISABLE)
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SELENE_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX2__)
+#define SELENE_SIMD_SSSE3
+#include <tmmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define SELENE_SIMD_AVX2
+#include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define SELENE_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+#endif  // !defined(SELENE_SIMD_DISABLE)
+
+#endif  // SELENE_BASE_SIMD_HPP
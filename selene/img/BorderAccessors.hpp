@@ -8,6 +8,7 @@
 /// @file
 
 #include <selene/img/Image.hpp>
+#include <selene/img/OrientedView.hpp>
 #include <selene/img/Pixel.hpp>
 #include <selene/img/PixelTraits.hpp>
 #include <selene/img/RelativeAccessor.hpp>
@@ -44,6 +45,9 @@ struct ImageBorderAccessor<BorderAccessMode::Unchecked>
 
   template <typename PixelType>
   static decltype(auto) access(const RelativeAccessor<PixelType>& img, PixelIndex rx, PixelIndex ry) noexcept;
+
+  template <typename PixelType>
+  static decltype(auto) access(const OrientedView<PixelType>& img, PixelIndex x, PixelIndex y) noexcept;
 };
 
 /** \brief `ImageBorderAccessor` specialization for `BorderAccessMode::ZeroPadding`.
@@ -56,6 +60,9 @@ struct ImageBorderAccessor<BorderAccessMode::ZeroPadding>
 
   template <typename PixelType>
   static auto access(const RelativeAccessor<PixelType>& img, PixelIndex rx, PixelIndex ry) noexcept;
+
+  template <typename PixelType>
+  static auto access(const OrientedView<PixelType>& img, PixelIndex x, PixelIndex y) noexcept;
 };
 
 /** \brief `ImageBorderAccessor` specialization for `BorderAccessMode::Replicated`.
@@ -68,6 +75,9 @@ struct ImageBorderAccessor<BorderAccessMode::Replicated>
 
   template <typename PixelType>
   static decltype(auto) access(const RelativeAccessor<PixelType>& img, PixelIndex rx, PixelIndex ry) noexcept;
+
+  template <typename PixelType>
+  static decltype(auto) access(const OrientedView<PixelType>& img, PixelIndex x, PixelIndex y) noexcept;
 };
 
 
@@ -111,6 +121,24 @@ ImageBorderAccessor<BorderAccessMode::Unchecked>::access(const RelativeAccessor<
   return ImageBorderAccessor<BorderAccessMode::Unchecked>::access(img.image(), abs_xy.x, abs_xy.y);
 }
 
+/** \brief Accesses the pixel value of the oriented view `img` at location (x, y) using the border access mode
+ * `BorderAccessMode::Unchecked`.
+ *
+ * @tparam PixelType The pixel type.
+ * @param img The oriented view to access.
+ * @param x The x-coordinate.
+ * @param y The y-coordinate.
+ * @return The pixel value at (x, y), using `BorderAccessMode::Unchecked`.
+ */
+template <typename PixelType>
+inline decltype(auto)
+ImageBorderAccessor<BorderAccessMode::Unchecked>::access(const OrientedView<PixelType>& img,
+                                                         PixelIndex x,
+                                                         PixelIndex y) noexcept
+{
+  return img(x, y);
+}
+
 /** \brief Accesses the pixel value of `img` at location (x, y) using the border access mode
  * `BorderAccessMode::ZeroPadding`.
  *
@@ -154,6 +182,30 @@ ImageBorderAccessor<BorderAccessMode::ZeroPadding>::access(const RelativeAccesso
   return ImageBorderAccessor<BorderAccessMode::ZeroPadding>::access(img.image(), abs_xy.x, abs_xy.y);
 }
 
+/** \brief Accesses the pixel value of the oriented view `img` at location (x, y) using the border access mode
+ * `BorderAccessMode::ZeroPadding`.
+ *
+ * @tparam PixelType The pixel type.
+ * @param img The oriented view to access.
+ * @param x The x-coordinate.
+ * @param y The y-coordinate.
+ * @return The pixel value at (x, y), using `BorderAccessMode::ZeroPadding`.
+ */
+template <typename PixelType>
+inline auto
+ImageBorderAccessor<BorderAccessMode::ZeroPadding>::access(const OrientedView<PixelType>& img,
+                                                           PixelIndex x,
+                                                           PixelIndex y) noexcept
+{
+  if (x < 0 || x >= static_cast<PixelIndex>(img.width()) || y < 0
+      || y >= static_cast<PixelIndex>(img.height()))
+  {
+    return PixelTraits<PixelType>::zero_element;
+  }
+
+  return img(x, y);
+}
+
 /** \brief Accesses the pixel value of `img` at location (x, y) using the border access mode
  * `BorderAccessMode::Replicated`.
  *
@@ -209,6 +261,42 @@ ImageBorderAccessor<BorderAccessMode::Replicated>::access(const RelativeAccessor
   return ImageBorderAccessor<BorderAccessMode::Replicated>::access(img.image(), abs_xy.x, abs_xy.y);
 }
 
+/** \brief Accesses the pixel value of the oriented view `img` at location (x, y) using the border access mode
+ * `BorderAccessMode::Replicated`.
+ *
+ * @tparam PixelType The pixel type.
+ * @param img The oriented view to access.
+ * @param x The x-coordinate.
+ * @param y The y-coordinate.
+ * @return The pixel value at (x, y), using `BorderAccessMode::Replicated`.
+ */
+template <typename PixelType>
+inline decltype(auto)
+ImageBorderAccessor<BorderAccessMode::Replicated>::access(const OrientedView<PixelType>& img,
+                                                          PixelIndex x,
+                                                          PixelIndex y) noexcept
+{
+  if (x < 0)
+  {
+    x = 0_idx;
+  }
+  else if (x >= static_cast<PixelIndex>(img.width()))
+  {
+    x = static_cast<PixelIndex>(img.width() - 1);
+  }
+
+  if (y < 0)
+  {
+    y = 0_idx;
+  }
+  else if (y >= static_cast<PixelIndex>(img.height()))
+  {
+    y = static_cast<PixelIndex>(img.height() - 1);
+  }
+
+  return img(x, y);
+}
+
 }  // namespace sln
 
 #endif  // SELENE_IMG_BORDER_ACCESSORS_HPP
@@ -10,6 +10,7 @@
 #include <selene/base/Allocators.hpp>
 #include <selene/base/Assert.hpp>
 #include <selene/base/MemoryBlock.hpp>
+#include <selene/base/MemoryResource.hpp>
 
 #include <selene/img/ImageDataStorage.hpp>
 #include <selene/img/PixelFormat.hpp>
@@ -59,6 +60,10 @@ ImageData<ImageDataStorage::Modifiable> to_image_data(Image<PixelType>&&, PixelF
  *
  * The memory of an `Image<PixelType>` instance may either be owned or non-owned; in the latter case, the instance is a
  * "view" on image data.
+ *
+ * Owned memory is allocated from a MemoryResource, which is `default_memory_resource()` unless specified on
+ * construction. The resource stays associated with the instance across (re)allocations; it is transferred along with
+ * the memory on move construction and move assignment, but not on copy construction.
  */
 template <typename PixelType_>
 class Image
@@ -69,13 +74,28 @@ public:
   using const_iterator = ConstImageRowIterator<PixelType>;  ///< The const_iterator type.
 
   Image();
-  Image(PixelLength width, PixelLength height, Stride stride_bytes = Stride{0});
-  Image(PixelLength width, PixelLength height, ImageRowAlignment row_alignment_bytes);
+  explicit Image(MemoryResource& resource);
+  Image(PixelLength width,
+        PixelLength height,
+        Stride stride_bytes = Stride{0},
+        MemoryResource& resource = default_memory_resource());
+  Image(PixelLength width,
+        PixelLength height,
+        ImageRowAlignment row_alignment_bytes,
+        MemoryResource& resource = default_memory_resource());
+  Image(PixelLength width,
+        PixelLength height,
+        ImageLayout layout,
+        MemoryResource& resource = default_memory_resource());
   Image(std::uint8_t* data, PixelLength width, PixelLength height, Stride stride_bytes = Stride{0}) noexcept;
   Image(MemoryBlock<AlignedNewAllocator>&& data,
         PixelLength width,
         PixelLength height,
         Stride stride_bytes = Stride{0}) noexcept;
+  Image(MemoryBlock<MemoryResource>&& data,
+        PixelLength width,
+        PixelLength height,
+        Stride stride_bytes = Stride{0}) noexcept;
 
   Image(const Image<PixelType>& other);
   Image<PixelType>& operator=(const Image<PixelType>& other);
@@ -94,6 +114,8 @@ public:
   bool is_view() const noexcept;
   bool is_empty() const noexcept;
   bool is_valid() const noexcept;
+  bool simd_safe_tail() const noexcept;
+  MemoryResource& memory_resource() const noexcept;
 
   void clear() noexcept;
   void fill(PixelType value) noexcept;
@@ -109,12 +131,25 @@ public:
                 bool shrink_to_fit = true,
                 bool force_allocation = false,
                 bool allow_view_reallocation = true);
+  void allocate(PixelLength width,
+                PixelLength height,
+                ImageLayout layout,
+                bool shrink_to_fit = true,
+                bool force_allocation = false,
+                bool allow_view_reallocation = true);
   void maybe_allocate(PixelLength width, PixelLength height, Stride stride_bytes = Stride{0});
+  void allocate_zeroed(PixelLength width, PixelLength height, Stride stride_bytes = Stride{0});
+  void allocate_zeroed(PixelLength width, PixelLength height, ImageRowAlignment row_alignment_bytes);
+  void allocate_zeroed(PixelLength width, PixelLength height, ImageLayout layout);
   void set_view(std::uint8_t* data, PixelLength width, PixelLength height, Stride stride_bytes = Stride{0});
   void set_data(MemoryBlock<AlignedNewAllocator>&& data,
                 PixelLength width,
                 PixelLength height,
                 Stride stride_bytes = Stride{0});
+  void set_data(MemoryBlock<MemoryResource>&& data,
+                PixelLength width,
+                PixelLength height,
+                Stride stride_bytes = Stride{0});
 
   iterator begin() noexcept;
   const_iterator begin() const noexcept;
@@ -156,9 +191,13 @@ private:
   PixelLength width_;
   PixelLength height_;
   bool owns_memory_ = true;
+  MemoryResource* resource_ = &default_memory_resource();
 
   constexpr static std::size_t default_base_alignment_ = 16;
 
+  static Stride layout_stride_bytes(PixelLength width, ImageLayout layout) noexcept;
+  static std::size_t layout_base_alignment(ImageLayout layout) noexcept;
+
   void allocate(PixelLength width,
                 PixelLength height,
                 Stride stride_bytes,
@@ -166,7 +205,8 @@ private:
                 bool shrink_to_fit,
                 bool force_allocation,
                 bool allow_view_reallocation);
-  void allocate_bytes(std::size_t nr_bytes, std::size_t alignment);
+  void allocate_zeroed(PixelLength width, PixelLength height, Stride stride_bytes, std::size_t base_alignment_bytes);
+  void allocate_bytes(std::size_t nr_bytes, std::size_t alignment, bool zeroed = false);
   void deallocate_bytes();
   void deallocate_bytes_if_owned();
   void reset();
@@ -174,7 +214,7 @@ private:
   Bytes compute_data_offset(PixelIndex y) const noexcept;
   Bytes compute_data_offset(PixelIndex x, PixelIndex y) const noexcept;
 
-  MemoryBlock<AlignedNewAllocator> relinquish_data_ownership();
+  MemoryBlock<MemoryResource> relinquish_data_ownership();
 
   friend void clone<PixelType>(const Image<PixelType>&, Image<PixelType>&);
   friend Image<PixelType> view<PixelType>(const Image<PixelType>&);
@@ -677,6 +717,19 @@ Image<PixelType>::Image() : stride_bytes_(0), width_(0), height_(0)
 {
 }
 
+/** \brief Constructs an empty image, which will allocate its data from the specified memory resource.
+ *
+ * Creates an empty image of width and height 0. The image data will be owned, i.e. `is_view() == false`.
+ *
+ * @tparam PixelType The pixel type.
+ * @param resource The memory resource to allocate from. Needs to outlive the image data.
+ */
+template <typename PixelType>
+Image<PixelType>::Image(MemoryResource& resource)
+    : stride_bytes_(0), width_(0), height_(0), resource_(&resource)
+{
+}
+
 /** \brief Constructs an image of the specified width, height, and stride in bytes.
  *
  * Image content will be undefined.
@@ -690,12 +743,14 @@ Image<PixelType>::Image() : stride_bytes_(0), width_(0), height_(0)
  * @param width Desired image width.
  * @param height Desired image height.
  * @param stride_bytes The stride (row length) in bytes.
+ * @param resource The memory resource to allocate from. Needs to outlive the image data.
  */
 template <typename PixelType>
-Image<PixelType>::Image(PixelLength width, PixelLength height, Stride stride_bytes)
+Image<PixelType>::Image(PixelLength width, PixelLength height, Stride stride_bytes, MemoryResource& resource)
     : stride_bytes_(std::max(stride_bytes, Stride(PixelTraits<PixelType>::nr_bytes * width)))
     , width_(width)
     , height_(height)
+    , resource_(&resource)
 {
   constexpr auto base_alignment_bytes = Image<PixelType>::default_base_alignment_;
   allocate_bytes(stride_bytes_ * height_, base_alignment_bytes);
@@ -712,16 +767,42 @@ Image<PixelType>::Image(PixelLength width, PixelLength height, Stride stride_byt
  * @param width Desired image width.
  * @param height Desired image height.
  * @param row_alignment_bytes The row alignment in bytes.
+ * @param resource The memory resource to allocate from. Needs to outlive the image data.
  */
 template <typename PixelType>
-Image<PixelType>::Image(PixelLength width, PixelLength height, ImageRowAlignment row_alignment_bytes)
+Image<PixelType>::Image(PixelLength width,
+                        PixelLength height,
+                        ImageRowAlignment row_alignment_bytes,
+                        MemoryResource& resource)
     : stride_bytes_(detail::compute_stride_bytes(PixelTraits<PixelType>::nr_bytes * width, row_alignment_bytes))
     , width_(width)
     , height_(height)
+    , resource_(&resource)
 {
   allocate_bytes(stride_bytes_ * height_, row_alignment_bytes);
 }
 
+/** \brief Constructs an image of the specified width, height, and with the specified memory layout.
+ *
+ * Image content will be undefined.
+ * The image data will be owned, i.e. `is_view() == false`.
+ *
+ * With `ImageLayout::SimdPadded`, the image data and each row are aligned to `simd_vector_bytes`, and each row is
+ * followed by at least `simd_vector_bytes` of padding; see `simd_safe_tail()`.
+ *
+ * @tparam PixelType The pixel type.
+ * @param width Desired image width.
+ * @param height Desired image height.
+ * @param layout The memory layout.
+ * @param resource The memory resource to allocate from. Needs to outlive the image data.
+ */
+template <typename PixelType>
+Image<PixelType>::Image(PixelLength width, PixelLength height, ImageLayout layout, MemoryResource& resource)
+    : stride_bytes_(layout_stride_bytes(width, layout)), width_(width), height_(height), resource_(&resource)
+{
+  allocate_bytes(stride_bytes_ * height_, layout_base_alignment(layout));
+}
+
 /** \brief Constructs an image view (non-owned data) from supplied memory.
  *
  * The row stride (in bytes) is chosen to be at least `width * PixelTraits::nr_bytes`, or the supplied value.
@@ -748,7 +829,7 @@ Image<PixelType>::Image(std::uint8_t* data, PixelLength width, PixelLength heigh
  * The row stride (in bytes) is chosen to be at least `width * PixelTraits::nr_bytes`, or the supplied value.
  *
  * @tparam PixelType The pixel type.
- * @param data A `MemoryBlock<NewAllocator>` with the existing data.
+ * @param data A `MemoryBlock<AlignedNewAllocator>` with the existing data.
  * @param width Image width.
  * @param height Image height.
  * @param stride_bytes The stride (row length) in bytes.
@@ -766,6 +847,31 @@ Image<PixelType>::Image(MemoryBlock<AlignedNewAllocator>&& data,
   SELENE_ASSERT(width_ > 0 && height_ > 0 && stride_bytes_ > 0);
 }
 
+/** \brief Constructs an image (owned data) from memory allocated from a memory resource.
+ *
+ * The row stride (in bytes) is chosen to be at least `width * PixelTraits::nr_bytes`, or the supplied value.
+ * The image will subsequently allocate from the resource of the memory block.
+ *
+ * @tparam PixelType The pixel type.
+ * @param data A `MemoryBlock<MemoryResource>` with the existing data.
+ * @param width Image width.
+ * @param height Image height.
+ * @param stride_bytes The stride (row length) in bytes.
+ */
+template <typename PixelType>
+Image<PixelType>::Image(MemoryBlock<MemoryResource>&& data,
+                        PixelLength width,
+                        PixelLength height,
+                        Stride stride_bytes) noexcept
+    : stride_bytes_(std::max(stride_bytes, Stride(PixelTraits<PixelType>::nr_bytes * width)))
+    , width_(width)
+    , height_(height)
+    , resource_(&data.resource())
+{
+  data_ = data.transfer_data();
+  SELENE_ASSERT(width_ > 0 && height_ > 0 && stride_bytes_ > 0);
+}
+
 /** \brief Copy constructor.
  *
  * Constructs an image instance from the supplied image.
@@ -774,6 +880,9 @@ Image<PixelType>::Image(MemoryBlock<AlignedNewAllocator>&& data,
  * image (the data will be copied, s.t. `is_view() == false`), but if the supplied image points to non-owned data, then
  * the constructed image will be a view (`is_view() == true`).
  *
+ * The constructed image allocates from `default_memory_resource()`, irrespective of the memory resource of the supplied
+ * image.
+ *
  * @tparam PixelType The pixel type.
  * @param other The source image.
  */
@@ -806,6 +915,8 @@ inline Image<PixelType>::Image(const Image<PixelType>& other)
  * image (the data will be copied, s.t. `is_view() == false`), but if the supplied image points to non-owned data, then
  * the constructed image will be a view (`is_view() == true`).
  *
+ * The memory resource of this image is retained.
+ *
  * @tparam PixelType The pixel type.
  * @param other The image to assign from.
  * @return A reference to this image.
@@ -852,6 +963,8 @@ inline Image<PixelType>& Image<PixelType>::operator=(const Image<PixelType>& oth
 }
 
 /** \brief Move constructor.
+ *
+ * The memory resource is taken over from the supplied image.
  *
  * @tparam PixelType The pixel type.
  * @param other The image to move from.
@@ -863,11 +976,14 @@ inline Image<PixelType>::Image(Image<PixelType>&& other) noexcept
     , width_(other.width_)
     , height_(other.height_)
     , owns_memory_(other.owns_memory_)
+    , resource_(other.resource_)
 {
   other.reset();
 }
 
 /**\brief Move assignment operator.
+ *
+ * The memory resource is taken over from the supplied image.
  *
  * @tparam PixelType The pixel type.
  * @param other The image to move assign from.
@@ -891,6 +1007,7 @@ inline Image<PixelType>& Image<PixelType>::operator=(Image<PixelType>&& other) n
   width_ = other.width_;
   height_ = other.height_;
   owns_memory_ = other.owns_memory_;
+  resource_ = other.resource_;
 
   // Reset other image
   other.reset();
@@ -1027,6 +1144,37 @@ inline bool Image<PixelType>::is_valid() const noexcept
   return !is_empty();
 }
 
+/** \brief Returns whether the image rows can be safely accessed in full SIMD vectors, including beyond their end.
+ *
+ * This is the case if the image data is owned, the image data and each row are aligned to `simd_vector_bytes`, and
+ * each row is followed by at least `simd_vector_bytes` of padding. Vectorized kernels may then read and write up to
+ * `simd_vector_bytes` beyond the last pixel of each row, instead of handling the last partial vector separately; the
+ * contents of the padding are unspecified.
+ *
+ * Images allocated with `ImageLayout::SimdPadded` satisfy these requirements. Views never do, since their row padding
+ * may overlap with pixels outside of the view.
+ *
+ * @tparam PixelType The pixel type.
+ * @return True, if the image rows can be accessed beyond their end; false otherwise.
+ */
+template <typename PixelType>
+inline bool Image<PixelType>::simd_safe_tail() const noexcept
+{
+  return owns_memory_ && is_valid() && reinterpret_cast<std::uintptr_t>(data_) % simd_vector_bytes == 0
+         && stride_bytes_ % simd_vector_bytes == 0 && stride_bytes_ >= row_bytes() + simd_vector_bytes;
+}
+
+/** \brief Returns the memory resource that owned image data is allocated from.
+ *
+ * @tparam PixelType The pixel type.
+ * @return The memory resource.
+ */
+template <typename PixelType>
+inline MemoryResource& Image<PixelType>::memory_resource() const noexcept
+{
+  return *resource_;
+}
+
 /** \brief Resets the image instance by clearing the image data and resetting the internal state to the state after
  * default construction.
  *
@@ -1043,6 +1191,8 @@ void Image<PixelType>::clear() noexcept
 }
 
 /** \brief Fills the image data, i.e. each pixel, with the specified value.
+ *
+ * To obtain a zero-initialized image, prefer `allocate_zeroed()`, which avoids writing to the freshly allocated memory.
  *
  * @tparam PixelType The pixel type.
  * @param value The value that each image pixel should assume.
@@ -1121,6 +1271,38 @@ void Image<PixelType>::allocate(PixelLength width,
   allocate(width, height, stride_bytes, row_alignment_bytes, shrink_to_fit, force_allocation, allow_view_reallocation);
 }
 
+/** \brief Resizes the allocated image data to exactly fit an image of size (width x height), with the specified
+ * memory layout.
+ *
+ * No memory (re)allocation will happen, if the needed allocation size already matches the existing allocation size,
+ * and the existing allocation satisfies the alignment of the layout. See also the `shrink_to_fit` parameter.
+ *
+ * Postconditions: `!is_view() && (stride_bytes() >= width() * PixelTraits::nr_bytes)`; with
+ * `ImageLayout::SimdPadded`, also `simd_safe_tail()`.
+ *
+ * @tparam PixelType The pixel type.
+ * @param width The new image width.
+ * @param height The new image height.
+ * @param layout The desired memory layout.
+ * @param shrink_to_fit If true, reallocate if it results in less memory usage; otherwise allow excess memory to stay
+ * allocated
+ * @param force_allocation If true, always force a reallocation. Overrides `allow_view_reallocation == false`.
+ * @param allow_view_reallocation If true, allow allocation from `is_view() == true`. If false, and the existing image
+ * is a view, a `std::runtime_error` exception will be thrown (respecting the strong exception guarantee).
+ */
+template <typename PixelType>
+void Image<PixelType>::allocate(PixelLength width,
+                                PixelLength height,
+                                ImageLayout layout,
+                                bool shrink_to_fit,
+                                bool force_allocation,
+                                bool allow_view_reallocation)
+{
+  const auto stride_bytes = layout_stride_bytes(width, layout);
+  const auto base_alignment_bytes = layout_base_alignment(layout);
+  allocate(width, height, stride_bytes, base_alignment_bytes, shrink_to_fit, force_allocation, allow_view_reallocation);
+}
+
 /** \brief Resizes the allocated image data to exactly fit an image of size (width x height), with user-defined row
  * stride, if (and only if) the existing width and height differ (disregarding the existing stride).
  *
@@ -1156,6 +1338,63 @@ void Image<PixelType>::maybe_allocate(PixelLength width, PixelLength height, Str
   allocate(width, height, stride_bytes, base_alignment_bytes, shrink_to_fit, force_allocation, allow_view_reallocation);
 }
 
+/** \brief Allocates zero-initialized image data for an image of size (width x height), with user-defined row stride.
+ *
+ * Use instead of `allocate()` followed by `fill()` with a zero value. New memory is always allocated, through the
+ * `allocate_zeroed()` function of the memory resource; for the default resource and `MappedMemoryResource`, large
+ * images are backed by fresh pages from the operating system, which are zeroed lazily on first access. This makes
+ * large canvases that are only sparsely written to considerably cheaper.
+ *
+ * The row stride (in bytes) is chosen to be at least `width * PixelTraits::nr_bytes`, or the supplied value.
+ *
+ * Postconditions: `!is_view() && (stride_bytes() >= width() * PixelTraits::nr_bytes)`, and all bytes of the image data
+ * (including any row padding) are zero.
+ *
+ * @tparam PixelType The pixel type.
+ * @param width The new image width.
+ * @param height The new image height.
+ * @param stride_bytes The desired row stride in bytes.
+ */
+template <typename PixelType>
+void Image<PixelType>::allocate_zeroed(PixelLength width, PixelLength height, Stride stride_bytes)
+{
+  allocate_zeroed(width, height, stride_bytes, Image<PixelType>::default_base_alignment_);
+}
+
+/** \brief Allocates zero-initialized image data for an image of size (width x height), with user-defined row
+ * alignment.
+ *
+ * See the overload taking a row stride for details.
+ *
+ * @tparam PixelType The pixel type.
+ * @param width The new image width.
+ * @param height The new image height.
+ * @param row_alignment_bytes The desired row alignment in bytes.
+ */
+template <typename PixelType>
+void Image<PixelType>::allocate_zeroed(PixelLength width, PixelLength height, ImageRowAlignment row_alignment_bytes)
+{
+  const auto row_bytes = width * PixelTraits<PixelType>::nr_bytes;
+  const auto stride_bytes = detail::compute_stride_bytes(row_bytes, row_alignment_bytes);
+  allocate_zeroed(width, height, stride_bytes, row_alignment_bytes);
+}
+
+/** \brief Allocates zero-initialized image data for an image of size (width x height), with the specified memory
+ * layout.
+ *
+ * See the overload taking a row stride for details. The row padding is zero-initialized as well.
+ *
+ * @tparam PixelType The pixel type.
+ * @param width The new image width.
+ * @param height The new image height.
+ * @param layout The desired memory layout.
+ */
+template <typename PixelType>
+void Image<PixelType>::allocate_zeroed(PixelLength width, PixelLength height, ImageLayout layout)
+{
+  allocate_zeroed(width, height, layout_stride_bytes(width, layout), layout_base_alignment(layout));
+}
+
 /** \brief Sets the image data to be a view onto non-owned external memory.
  *
  * The row stride (in bytes) is chosen to be at least `width * PixelTraits::nr_bytes`, or the supplied value.
@@ -1216,6 +1455,43 @@ inline void Image<PixelType>::set_data(MemoryBlock<AlignedNewAllocator>&& data,
   width_ = width;
   height_ = height;
   owns_memory_ = true;
+  resource_ = &default_memory_resource();
+}
+
+/** \brief Sets the image data to the provided memory block, which will be owned by the `Image<>` instance.
+ *
+ * The row stride (in bytes) is chosen to be at least `width * PixelTraits::nr_bytes`, or the supplied value.
+ * The image will subsequently allocate from the resource of the memory block.
+ *
+ * Precondition: `data.size() >= stride_bytes * height`.
+ *
+ * Postcondition: `!is_view()`.
+ *
+ * @tparam PixelType The pixel type.
+ * @param data Memory block of image data, to be owned by the image instance.
+ * @param width The image width.
+ * @param height The image height.
+ * @param stride_bytes The row stride in bytes.
+ */
+template <typename PixelType>
+inline void Image<PixelType>::set_data(MemoryBlock<MemoryResource>&& data,
+                                       PixelLength width,
+                                       PixelLength height,
+                                       Stride stride_bytes)
+{
+  stride_bytes = std::max(stride_bytes, Stride(PixelTraits<PixelType>::nr_bytes * width));
+  SELENE_ASSERT(data.size() >= stride_bytes * height);
+
+  // Clean up own data
+  deallocate_bytes_if_owned();
+
+  // Set local values
+  resource_ = &data.resource();
+  data_ = data.transfer_data();
+  stride_bytes_ = stride_bytes;
+  width_ = width;
+  height_ = height;
+  owns_memory_ = true;
 }
 
 /** \brief Returns an iterator to the first row of the image.
@@ -1499,10 +1775,12 @@ void Image<PixelType>::allocate(PixelLength width,
     stride_bytes_ = stride_bytes;
   };
 
-  // No need to act, if size parameters match
+  // No need to act, if size parameters match, and the existing memory is suitably aligned
   const auto bytes_match = shrink_to_fit ? (nr_bytes_to_allocate == nr_currently_allocated_bytes)
                                          : (nr_bytes_to_allocate <= nr_currently_allocated_bytes);
-  if (!force_allocation && bytes_match && owns_memory_)
+  const auto alignment_match =
+      (base_alignment_bytes == 0 || reinterpret_cast<std::uintptr_t>(data_) % base_alignment_bytes == 0);
+  if (!force_allocation && bytes_match && alignment_match && owns_memory_)
   {
     commit_new_geometry();
     return;
@@ -1521,11 +1799,41 @@ void Image<PixelType>::allocate(PixelLength width,
 }
 
 template <typename PixelType>
-void Image<PixelType>::allocate_bytes(std::size_t nr_bytes, std::size_t alignment)
+void Image<PixelType>::allocate_zeroed(PixelLength width,
+                                       PixelLength height,
+                                       Stride stride_bytes,
+                                       std::size_t base_alignment_bytes)
+{
+  stride_bytes = std::max(stride_bytes, Stride(PixelTraits<PixelType>::nr_bytes * width));
+
+  width_ = width;
+  height_ = height;
+  stride_bytes_ = stride_bytes;
+
+  deallocate_bytes_if_owned();
+  owns_memory_ = true;
+  allocate_bytes(stride_bytes * height, base_alignment_bytes, true);
+}
+
+template <typename PixelType>
+Stride Image<PixelType>::layout_stride_bytes(PixelLength width, ImageLayout layout) noexcept
+{
+  const auto row_bytes = std::size_t(PixelTraits<PixelType>::nr_bytes * width);
+  return (layout == ImageLayout::SimdPadded) ? detail::compute_simd_stride_bytes(row_bytes) : Stride{row_bytes};
+}
+
+template <typename PixelType>
+std::size_t Image<PixelType>::layout_base_alignment(ImageLayout layout) noexcept
+{
+  return (layout == ImageLayout::SimdPadded) ? simd_vector_bytes : Image<PixelType>::default_base_alignment_;
+}
+
+template <typename PixelType>
+void Image<PixelType>::allocate_bytes(std::size_t nr_bytes, std::size_t alignment, bool zeroed)
 {
   SELENE_ASSERT(owns_memory_);
 
-  auto memory = AlignedNewAllocator::allocate(nr_bytes, alignment);
+  auto memory = zeroed ? resource_->allocate_zeroed(nr_bytes, alignment) : resource_->allocate(nr_bytes, alignment);
   SELENE_ASSERT(memory.size() == nr_bytes);
   data_ = memory.transfer_data();
 }
@@ -1537,7 +1845,7 @@ void Image<PixelType>::deallocate_bytes()
 
   if (data_)
   {
-    AlignedNewAllocator::deallocate(data_);
+    resource_->deallocate(data_);
     SELENE_ASSERT(data_ == nullptr);
   }
 }
@@ -1554,7 +1862,7 @@ void Image<PixelType>::deallocate_bytes_if_owned()
 template <typename PixelType>
 void Image<PixelType>::reset()
 {
-  // reset to default constructed state
+  // reset to default constructed state, but keep the memory resource
   data_ = nullptr;
   stride_bytes_ = Stride{0};
   width_ = PixelLength{0};
@@ -1587,7 +1895,7 @@ inline Bytes Image<PixelType>::compute_data_offset(PixelIndex x, PixelIndex y) c
 }
 
 template <typename PixelType>
-inline MemoryBlock<AlignedNewAllocator> Image<PixelType>::relinquish_data_ownership()
+inline MemoryBlock<MemoryResource> Image<PixelType>::relinquish_data_ownership()
 {
   SELENE_FORCED_ASSERT(owns_memory_);
   const auto ptr = data_;
@@ -1595,7 +1903,7 @@ inline MemoryBlock<AlignedNewAllocator> Image<PixelType>::relinquish_data_owners
 
   owns_memory_ = false;
   clear();
-  return construct_memory_block_from_existing_memory<AlignedNewAllocator>(ptr, len);
+  return construct_memory_block_from_existing_memory(ptr, len, *resource_);
 }
 
 // ----------
@@ -26,6 +26,8 @@ namespace sln {
  *
  * @tparam InterpolationMode The interpolation mode to use. Defaults to `ImageInterpolationMode::Bilinear`.
  * @tparam AccessMode The border access mode to use. Defaults to BorderAccessMode::Unchecked.
+ * @tparam Precision The interpolation precision to use. Defaults to `InterpolationPrecision::FloatingPoint`.
+ * `InterpolationPrecision::FixedPoint` requires an `Image<>` with 8- or 16-bit integral pixel elements.
  * @tparam ImageType The image type, i.e. `Image<...>`.
  * @tparam Index The index type. Must be floating point for this overload.
  * @param img The image to return the pixel value from.
@@ -35,6 +37,7 @@ namespace sln {
  */
 template <ImageInterpolationMode InterpolationMode = ImageInterpolationMode::Bilinear,
           BorderAccessMode AccessMode = BorderAccessMode::Unchecked,
+          InterpolationPrecision Precision = InterpolationPrecision::FloatingPoint,
           typename ImageType,
           typename Index,
           typename = std::enable_if_t<std::is_floating_point<Index>::value>>
@@ -43,7 +46,7 @@ inline decltype(auto) get(const ImageType& img,
                           Index y,
                           std::integral_constant<ImageInterpolationMode, InterpolationMode> = {}) noexcept
 {
-  return ImageInterpolator<InterpolationMode, AccessMode>::interpolate(img, x, y);
+  return ImageInterpolator<InterpolationMode, AccessMode, Precision>::interpolate(img, x, y);
 }
 
 /** \brief Returns the pixel value of the image at the specified (floating point) location, using bilinear interpolation
@@ -0,0 +1,182 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/img/ImageBufferPool.hpp>
+
+#include <new>
+
+namespace sln {
+
+constexpr std::size_t ImageBufferPool::min_buffer_size;
+constexpr std::size_t ImageBufferPool::buffer_alignment;
+constexpr std::size_t ImageBufferPool::nr_size_classes;
+
+/** \brief Constructor.
+ *
+ * @param max_buffers_per_class The maximum number of released buffers retained per size class.
+ */
+ImageBufferPool::ImageBufferPool(std::size_t max_buffers_per_class)
+    : max_buffers_per_class_(max_buffers_per_class)
+{
+}
+
+/** \brief Destructor. Frees all pooled buffers. */
+ImageBufferPool::~ImageBufferPool()
+{
+  clear();
+}
+
+/** \brief Acquires a buffer of at least the specified size.
+ *
+ * A pooled buffer of the respective size class is reused, if available; otherwise, a new buffer is allocated.
+ *
+ * @param nr_bytes The minimum buffer size in bytes.
+ * @return The buffer. Its size is the size of the respective size class.
+ */
+auto ImageBufferPool::acquire(std::size_t nr_bytes) -> Buffer
+{
+  const auto index = size_class_index(nr_bytes);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& buffers = free_buffers_[index];
+
+    if (!buffers.empty())
+    {
+      const auto data = buffers.back();
+      buffers.pop_back();
+      return Buffer(this, data, index);
+    }
+
+    ++nr_allocations_;
+  }
+
+  auto memory = AlignedNewAllocator::allocate(size_class_bytes(index), buffer_alignment);
+
+  if (memory.data() == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+
+  return Buffer(this, memory.transfer_data(), index);
+}
+
+/** \brief Acquires image data of the specified size and format, with tightly packed rows.
+ *
+ * @param width The image width.
+ * @param height The image height.
+ * @param nr_channels The number of channels per pixel element.
+ * @param nr_bytes_per_channel The number of bytes stored per channel.
+ * @param pixel_format The pixel format (semantic tag).
+ * @param sample_format The sample format (semantic tag).
+ * @return The pooled image data.
+ */
+PooledImageData ImageBufferPool::acquire_image_data(PixelLength width,
+                                                           PixelLength height,
+                                                           std::uint16_t nr_channels,
+                                                           std::uint16_t nr_bytes_per_channel,
+                                                           PixelFormat pixel_format,
+                                                           SampleFormat sample_format)
+{
+  const auto stride_bytes = Stride(nr_bytes_per_channel * nr_channels * width);
+  auto buffer = acquire(stride_bytes * height);
+  ImageData<> image_data(buffer.data(), width, height, nr_channels, nr_bytes_per_channel, stride_bytes, pixel_format,
+                         sample_format);
+  return PooledImageData(std::move(buffer), std::move(image_data));
+}
+
+/** \brief Frees all pooled buffers.
+ *
+ * Buffers currently acquired are not affected; they will be returned to the pool on their destruction.
+ */
+void ImageBufferPool::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  for (auto& buffers : free_buffers_)
+  {
+    for (auto data : buffers)
+    {
+      AlignedNewAllocator::deallocate(data);
+    }
+
+    buffers.clear();
+  }
+}
+
+/** \brief Returns the number of buffers currently held by the pool, i.e. released and available for reuse.
+ *
+ * @return The number of pooled buffers.
+ */
+std::size_t ImageBufferPool::nr_pooled_buffers() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::size_t nr_buffers = 0;
+
+  for (const auto& buffers : free_buffers_)
+  {
+    nr_buffers += buffers.size();
+  }
+
+  return nr_buffers;
+}
+
+/** \brief Returns the number of buffers allocated by the pool so far.
+ *
+ * Once the pool has seen the image sizes of a workload, this number stays constant.
+ *
+ * @return The number of buffer allocations.
+ */
+std::size_t ImageBufferPool::nr_allocations() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return nr_allocations_;
+}
+
+/** \brief Returns the index of the size class for buffers of the specified size.
+ *
+ * The size classes are the same as the ones of PoolMemoryResource.
+ *
+ * @param nr_bytes The buffer size in bytes.
+ * @return The size class index.
+ */
+std::size_t ImageBufferPool::size_class_index(std::size_t nr_bytes)
+{
+  return PoolMemoryResource::size_class_index(nr_bytes);
+}
+
+/** \brief Returns the buffer size of the specified size class.
+ *
+ * @param index The size class index.
+ * @return The buffer size in bytes.
+ */
+std::size_t ImageBufferPool::size_class_bytes(std::size_t index)
+{
+  return PoolMemoryResource::size_class_bytes(index);
+}
+
+void ImageBufferPool::release(std::uint8_t* data, std::size_t index) noexcept
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto& buffers = free_buffers_[index];
+
+    if (buffers.size() < max_buffers_per_class_)
+    {
+      // Only allocates while the pool grows; afterwards, the vector capacity suffices.
+      try
+      {
+        buffers.push_back(data);
+        return;
+      }
+      catch (...)
+      {
+      }
+    }
+  }
+
+  AlignedNewAllocator::deallocate(data);
+}
+
+}  // namespace sln
@@ -0,0 +1,276 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_IMAGE_BUFFER_POOL_HPP
+#define SELENE_IMG_IMAGE_BUFFER_POOL_HPP
+
+/// @file
+
+#include <selene/base/Allocators.hpp>
+#include <selene/base/Assert.hpp>
+#include <selene/base/PoolMemoryResource.hpp>
+
+#include <selene/img/ImageData.hpp>
+#include <selene/img/PixelFormat.hpp>
+#include <selene/img/Types.hpp>
+
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace sln {
+
+class PooledImageData;
+
+/** \brief Thread-safe pool of memory buffers for image data, keyed by size class.
+ *
+ * Requested buffer sizes are rounded up to the next size class: the first class holds buffers of `min_buffer_size`
+ * bytes; beyond that, each power-of-two range is divided into four classes, so that at most 25% of a buffer remains
+ * unused. The size classes are the same as the ones of PoolMemoryResource.
+ *
+ * Buffers are handed out as ImageBufferPool::Buffer instances, which return their memory to the pool on destruction.
+ * Once a pool has seen the image sizes of a workload, acquiring buffers therefore does not allocate any further memory.
+ * Each size class retains at most `max_buffers_per_class` released buffers; surplus buffers are freed.
+ *
+ * A pool instance needs to outlive all buffers acquired from it.
+ */
+class ImageBufferPool
+{
+public:
+  class Buffer;
+
+  /// Size of the smallest size class, in bytes.
+  static constexpr std::size_t min_buffer_size = PoolMemoryResource::min_block_size;
+  static constexpr std::size_t buffer_alignment = 16;  ///< Alignment of each buffer, in bytes.
+
+  explicit ImageBufferPool(std::size_t max_buffers_per_class = 16);
+  ~ImageBufferPool();
+
+  ImageBufferPool(const ImageBufferPool&) = delete;  ///< Copy constructor (deleted).
+  ImageBufferPool& operator=(const ImageBufferPool&) = delete;  ///< Copy assignment operator (deleted).
+  ImageBufferPool(ImageBufferPool&&) = delete;  ///< Move constructor (deleted).
+  ImageBufferPool& operator=(ImageBufferPool&&) = delete;  ///< Move assignment operator (deleted).
+
+  Buffer acquire(std::size_t nr_bytes);
+
+  PooledImageData acquire_image_data(PixelLength width,
+                                     PixelLength height,
+                                     std::uint16_t nr_channels,
+                                     std::uint16_t nr_bytes_per_channel,
+                                     PixelFormat pixel_format = PixelFormat::Unknown,
+                                     SampleFormat sample_format = SampleFormat::Unknown);
+
+  void clear();
+
+  std::size_t nr_pooled_buffers() const;
+  std::size_t nr_allocations() const;
+
+  static std::size_t size_class_index(std::size_t nr_bytes);
+  static std::size_t size_class_bytes(std::size_t index);
+
+private:
+  static constexpr std::size_t nr_size_classes = 1 + 4 * 48;
+
+  mutable std::mutex mutex_;
+  std::array<std::vector<std::uint8_t*>, nr_size_classes> free_buffers_;
+  std::size_t max_buffers_per_class_;
+  std::size_t nr_allocations_ = 0;
+
+  void release(std::uint8_t* data, std::size_t index) noexcept;
+};
+
+/** \brief A memory buffer acquired from an ImageBufferPool.
+ *
+ * Move-only; the memory is returned to the pool on destruction.
+ */
+class ImageBufferPool::Buffer
+{
+public:
+  Buffer() = default;  ///< Default constructor. Constructs an empty buffer.
+  ~Buffer();
+
+  Buffer(const Buffer&) = delete;  ///< Copy constructor (deleted).
+  Buffer& operator=(const Buffer&) = delete;  ///< Copy assignment operator (deleted).
+  Buffer(Buffer&& other) noexcept;
+  Buffer& operator=(Buffer&& other) noexcept;
+
+  std::uint8_t* data() const noexcept;
+  std::size_t size() const noexcept;
+  bool empty() const noexcept;
+
+  void reset() noexcept;
+
+private:
+  ImageBufferPool* pool_ = nullptr;
+  std::uint8_t* data_ = nullptr;
+  std::size_t index_ = 0;
+
+  Buffer(ImageBufferPool* pool, std::uint8_t* data, std::size_t index) noexcept;
+
+  friend class ImageBufferPool;
+};
+
+/** \brief Image data in memory acquired from an ImageBufferPool.
+ *
+ * Holds the pooled buffer, and an `ImageData<>` view onto it. Move-only; the memory is returned to the pool on
+ * destruction.
+ */
+class PooledImageData
+{
+public:
+  PooledImageData() = default;  ///< Default constructor. Constructs invalid image data.
+
+  PooledImageData(const PooledImageData&) = delete;  ///< Copy constructor (deleted).
+  PooledImageData& operator=(const PooledImageData&) = delete;  ///< Copy assignment operator (deleted).
+  PooledImageData(PooledImageData&&) noexcept = default;  ///< Move constructor.
+  PooledImageData& operator=(PooledImageData&&) noexcept = default;  ///< Move assignment operator.
+
+  ImageData<>& image_data() noexcept;
+  const ImageData<>& image_data() const noexcept;
+
+  bool is_valid() const noexcept;
+
+  void clear() noexcept;
+
+private:
+  ImageBufferPool::Buffer buffer_;
+  ImageData<> image_data_;  // view onto the memory of buffer_
+
+  PooledImageData(ImageBufferPool::Buffer&& buffer, ImageData<>&& image_data) noexcept;
+
+  friend class ImageBufferPool;
+};
+
+// ----------
+// Implementation:
+
+inline ImageBufferPool::Buffer::Buffer(ImageBufferPool* pool, std::uint8_t* data, std::size_t index) noexcept
+    : pool_(pool), data_(data), index_(index)
+{
+}
+
+/** \brief Destructor. Returns the memory to the pool. */
+inline ImageBufferPool::Buffer::~Buffer()
+{
+  reset();
+}
+
+/** \brief Move constructor.
+ *
+ * @param other The buffer to move from; is empty afterwards.
+ */
+inline ImageBufferPool::Buffer::Buffer(Buffer&& other) noexcept
+    : pool_(other.pool_), data_(other.data_), index_(other.index_)
+{
+  other.pool_ = nullptr;
+  other.data_ = nullptr;
+  other.index_ = 0;
+}
+
+/** \brief Move assignment operator.
+ *
+ * Returns the memory currently held to the pool.
+ *
+ * @param other The buffer to move from; is empty afterwards.
+ * @return A reference to this buffer.
+ */
+inline auto ImageBufferPool::Buffer::operator=(Buffer&& other) noexcept -> Buffer&
+{
+  if (this != &other)
+  {
+    reset();
+    std::swap(pool_, other.pool_);
+    std::swap(data_, other.data_);
+    std::swap(index_, other.index_);
+  }
+
+  return *this;
+}
+
+/** \brief Returns a pointer to the buffer memory.
+ *
+ * @return Pointer to the buffer memory; `nullptr` if the buffer is empty.
+ */
+inline std::uint8_t* ImageBufferPool::Buffer::data() const noexcept
+{
+  return data_;
+}
+
+/** \brief Returns the buffer size.
+ *
+ * @return The buffer size in bytes; 0 if the buffer is empty.
+ */
+inline std::size_t ImageBufferPool::Buffer::size() const noexcept
+{
+  return data_ ? ImageBufferPool::size_class_bytes(index_) : 0;
+}
+
+/** \brief Returns whether the buffer is empty.
+ *
+ * @return True, if the buffer holds no memory; false otherwise.
+ */
+inline bool ImageBufferPool::Buffer::empty() const noexcept
+{
+  return data_ == nullptr;
+}
+
+/** \brief Returns the memory to the pool. Postcondition: `empty()`. */
+inline void ImageBufferPool::Buffer::reset() noexcept
+{
+  if (data_ != nullptr)
+  {
+    pool_->release(data_, index_);
+  }
+
+  pool_ = nullptr;
+  data_ = nullptr;
+  index_ = 0;
+}
+
+// ----------
+
+inline PooledImageData::PooledImageData(ImageBufferPool::Buffer&& buffer, ImageData<>&& image_data) noexcept
+    : buffer_(std::move(buffer)), image_data_(std::move(image_data))
+{
+}
+
+/** \brief Returns the image data, a view onto the pooled memory.
+ *
+ * @return The image data.
+ */
+inline ImageData<>& PooledImageData::image_data() noexcept
+{
+  return image_data_;
+}
+
+/** \brief Returns the image data, a view onto the pooled memory.
+ *
+ * @return The image data.
+ */
+inline const ImageData<>& PooledImageData::image_data() const noexcept
+{
+  return image_data_;
+}
+
+/** \brief Returns whether the image data is valid.
+ *
+ * @return True, if the image data is valid; false otherwise.
+ */
+inline bool PooledImageData::is_valid() const noexcept
+{
+  return image_data_.is_valid();
+}
+
+/** \brief Invalidates the image data, and returns the memory to the pool. */
+inline void PooledImageData::clear() noexcept
+{
+  image_data_.clear();
+  buffer_.reset();
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_IMAGE_BUFFER_POOL_HPP
@@ -10,6 +10,7 @@
 #include <selene/base/Allocators.hpp>
 #include <selene/base/Assert.hpp>
 #include <selene/base/MemoryBlock.hpp>
+#include <selene/base/MemoryResource.hpp>
 
 #include <selene/img/ImageDataBase.hpp>
 #include <selene/img/ImageDataStorage.hpp>
@@ -26,11 +27,17 @@ namespace sln {
 template <typename T>
 class Image;
 
+template <typename T, std::size_t N>
+class PlanarImage;
+
 /** \brief Dynamically typed image class.
  *
  * An instance of `ImageData` represents a dynamically typed image with pixel elements in interleaved storage.
  * Images are stored row-wise contiguous, with additional space after each row due to a custom stride in bytes.
  *
+ * Modifiable image data can alternatively describe planar storage (see `allocate_planar()` and `is_planar()`), where
+ * each channel is stored in a separate plane. This allows e.g. decoders to write channels directly to their planes.
+ *
  * Each image pixel can have an arbitrary number of channels, and each channel/sample in a pixel can have an arbitrary
  * number of bytes.
  *
@@ -78,6 +85,10 @@ public:
 /** \brief Explicit specialization of `ImageData` for modifiable image data.
  *
  * Can only point to both owned as well as non-owned memory.
+ *
+ * Owned memory is allocated from a MemoryResource, which is `default_memory_resource()` unless specified on
+ * construction. The resource stays associated with the instance across (re)allocations; it is transferred along with
+ * the memory on move construction and move assignment, but not on copy construction.
  */
 template <>
 class ImageData<ImageDataStorage::Modifiable> : public ImageDataBase<std::uint8_t*>
@@ -85,13 +96,16 @@ class ImageData<ImageDataStorage::Modifiable> : public ImageDataBase<std::uint8_
 public:
   ImageData() = default;  ///< Default constructor. See clear() for the postconditions.
 
+  explicit ImageData(MemoryResource& resource);
+
   ImageData(PixelLength width,
             PixelLength height,
             std::uint16_t nr_channels,
             std::uint16_t nr_bytes_per_channel,
             Stride stride_bytes = Stride{0},
             PixelFormat pixel_format = PixelFormat::Unknown,
-            SampleFormat sample_format = SampleFormat::Unknown);
+            SampleFormat sample_format = SampleFormat::Unknown,
+            MemoryResource& resource = default_memory_resource());
 
   ImageData(PixelLength width,
             PixelLength height,
@@ -99,7 +113,8 @@ public:
             std::uint16_t nr_bytes_per_channel,
             ImageRowAlignment row_alignment_bytes,
             PixelFormat pixel_format = PixelFormat::Unknown,
-            SampleFormat sample_format = SampleFormat::Unknown);
+            SampleFormat sample_format = SampleFormat::Unknown,
+            MemoryResource& resource = default_memory_resource());
 
   ImageData(std::uint8_t* data,
             PixelLength width,
@@ -119,6 +134,15 @@ public:
             PixelFormat pixel_format = PixelFormat::Unknown,
             SampleFormat sample_format = SampleFormat::Unknown) noexcept;
 
+  ImageData(MemoryBlock<MemoryResource>&& data,
+            PixelLength width,
+            PixelLength height,
+            std::uint16_t nr_channels,
+            std::uint16_t nr_bytes_per_channel,
+            Stride stride_bytes = Stride{0},
+            PixelFormat pixel_format = PixelFormat::Unknown,
+            SampleFormat sample_format = SampleFormat::Unknown) noexcept;
+
   ~ImageData();
 
   ImageData(const ImageData<ImageDataStorage::Modifiable>&);
@@ -127,6 +151,7 @@ public:
   ImageData<ImageDataStorage::Modifiable>& operator=(ImageData<ImageDataStorage::Modifiable>&&) noexcept;
 
   bool is_view() const noexcept;
+  MemoryResource& memory_resource() const noexcept;
 
   void clear() noexcept;
 
@@ -160,6 +185,22 @@ public:
                       PixelFormat pixel_format = PixelFormat::Unknown,
                       SampleFormat sample_format = SampleFormat::Unknown);
 
+  void allocate_zeroed(PixelLength width,
+                       PixelLength height,
+                       std::uint16_t nr_channels,
+                       std::uint16_t nr_bytes_per_channel,
+                       Stride stride_bytes = Stride{0},
+                       PixelFormat pixel_format = PixelFormat::Unknown,
+                       SampleFormat sample_format = SampleFormat::Unknown);
+
+  void allocate_zeroed(PixelLength width,
+                       PixelLength height,
+                       std::uint16_t nr_channels,
+                       std::uint16_t nr_bytes_per_channel,
+                       ImageRowAlignment row_alignment_bytes,
+                       PixelFormat pixel_format = PixelFormat::Unknown,
+                       SampleFormat sample_format = SampleFormat::Unknown);
+
   void set_view(std::uint8_t* data,
                 PixelLength width,
                 PixelLength height,
@@ -178,6 +219,44 @@ public:
                 PixelFormat pixel_format = PixelFormat::Unknown,
                 SampleFormat sample_format = SampleFormat::Unknown);
 
+  void set_data(MemoryBlock<MemoryResource>&& data,
+                PixelLength width,
+                PixelLength height,
+                std::uint16_t nr_channels,
+                std::uint16_t nr_bytes_per_channel,
+                Stride stride_bytes = Stride{0},
+                PixelFormat pixel_format = PixelFormat::Unknown,
+                SampleFormat sample_format = SampleFormat::Unknown);
+
+  void allocate_planar(PixelLength width,
+                       PixelLength height,
+                       std::uint16_t nr_channels,
+                       std::uint16_t nr_bytes_per_channel,
+                       Stride stride_bytes = Stride{0},
+                       PixelFormat pixel_format = PixelFormat::Unknown,
+                       SampleFormat sample_format = SampleFormat::Unknown,
+                       bool shrink_to_fit = true,
+                       bool force_allocation = false,
+                       bool allow_view_reallocation = true);
+
+  void set_planar_view(std::uint8_t* data,
+                       PixelLength width,
+                       PixelLength height,
+                       std::uint16_t nr_channels,
+                       std::uint16_t nr_bytes_per_channel,
+                       Stride stride_bytes = Stride{0},
+                       PixelFormat pixel_format = PixelFormat::Unknown,
+                       SampleFormat sample_format = SampleFormat::Unknown);
+
+  void set_planar_data(MemoryBlock<MemoryResource>&& data,
+                       PixelLength width,
+                       PixelLength height,
+                       std::uint16_t nr_channels,
+                       std::uint16_t nr_bytes_per_channel,
+                       Stride stride_bytes = Stride{0},
+                       PixelFormat pixel_format = PixelFormat::Unknown,
+                       SampleFormat sample_format = SampleFormat::Unknown);
+
   std::uint8_t* byte_ptr() noexcept;
   const std::uint8_t* byte_ptr() const noexcept;
 
@@ -187,6 +266,12 @@ public:
   std::uint8_t* byte_ptr(PixelIndex x, PixelIndex y) noexcept;
   const std::uint8_t* byte_ptr(PixelIndex x, PixelIndex y) const noexcept;
 
+  std::uint8_t* plane_byte_ptr(std::uint16_t channel) noexcept;
+  const std::uint8_t* plane_byte_ptr(std::uint16_t channel) const noexcept;
+
+  std::uint8_t* plane_byte_ptr(std::uint16_t channel, PixelIndex y) noexcept;
+  const std::uint8_t* plane_byte_ptr(std::uint16_t channel, PixelIndex y) const noexcept;
+
   template <typename PixelType>
   PixelType* data() noexcept;
 
@@ -219,6 +304,7 @@ public:
 
 private:
   bool owns_memory_ = true;
+  MemoryResource* resource_ = &default_memory_resource();
 
   constexpr static std::size_t default_base_alignment_ = 16;
 
@@ -230,18 +316,30 @@ private:
                 std::size_t base_alignment_bytes,
                 PixelFormat pixel_format,
                 SampleFormat sample_format,
+                ChannelLayout channel_layout,
                 bool shrink_to_fit,
                 bool force_allocation,
                 bool allow_view_reallocation);
-  void allocate_bytes(std::size_t nr_bytes, std::size_t alignment);
+  void allocate_zeroed(PixelLength width,
+                       PixelLength height,
+                       std::uint16_t nr_channels,
+                       std::uint16_t nr_bytes_per_channel,
+                       Stride stride_bytes,
+                       std::size_t base_alignment_bytes,
+                       PixelFormat pixel_format,
+                       SampleFormat sample_format);
+  void allocate_bytes(std::size_t nr_bytes, std::size_t alignment, bool zeroed = false);
   void deallocate_bytes();
   void deallocate_bytes_if_owned();
   void reset();
 
-  MemoryBlock<AlignedNewAllocator> relinquish_data_ownership();
+  MemoryBlock<MemoryResource> relinquish_data_ownership();
 
   template <typename PixelType>
   friend Image<PixelType> to_image(ImageData&&);
+
+  template <typename T, std::size_t N>
+  friend PlanarImage<T, N> to_planar_image(ImageData&&);
 };
 
 
@@ -283,6 +381,14 @@ inline ImageData<ImageDataStorage::Constant>::ImageData(const std::uint8_t* data
 
 // ImageData<ImageDataStorage::Modifiable>:
 
+/** \brief Constructs empty image data, which will allocate from the specified memory resource.
+ *
+ * @param resource The memory resource to allocate from. Needs to outlive the image data.
+ */
+inline ImageData<ImageDataStorage::Modifiable>::ImageData(MemoryResource& resource) : resource_(&resource)
+{
+}
+
 /** \brief Constructs image data (owned memory) with the specified parameters.
  *
  * Effectively calls `allocate(width, height, nr_channels, nr_bytes_per_channel, stride_bytes, pixel_format,
@@ -300,6 +406,7 @@ inline ImageData<ImageDataStorage::Constant>::ImageData(const std::uint8_t* data
  * @param stride_bytes The desired row stride in bytes.
  * @param pixel_format The pixel format (semantic tag).
  * @param sample_format The sample format (semantic tag).
+ * @param resource The memory resource to allocate from. Needs to outlive the image data.
  */
 inline ImageData<ImageDataStorage::Modifiable>::ImageData(PixelLength width,
                                                           PixelLength height,
@@ -307,14 +414,16 @@ inline ImageData<ImageDataStorage::Modifiable>::ImageData(PixelLength width,
                                                           std::uint16_t nr_bytes_per_channel,
                                                           Stride stride_bytes,
                                                           PixelFormat pixel_format,
-                                                          SampleFormat sample_format)
+                                                          SampleFormat sample_format,
+                                                          MemoryResource& resource)
+    : resource_(&resource)
 {
   constexpr auto base_alignment_bytes = ImageData<ImageDataStorage::Modifiable>::default_base_alignment_;
   constexpr bool shrink_to_fit = true;
   constexpr bool force_allocation = false;
   constexpr bool allow_view_reallocation = true;
   allocate(width, height, nr_channels, nr_bytes_per_channel, stride_bytes, base_alignment_bytes, pixel_format,
-           sample_format, shrink_to_fit, force_allocation, allow_view_reallocation);
+           sample_format, ChannelLayout::Interleaved, shrink_to_fit, force_allocation, allow_view_reallocation);
 }
 
 /** \brief Constructs image data (owned memory) with the specified parameters.
@@ -328,6 +437,7 @@ inline ImageData<ImageDataStorage::Modifiable>::ImageData(PixelLength width,
  * @param row_alignment_bytes The row alignment in bytes.
  * @param pixel_format The pixel format (semantic tag).
  * @param sample_format The sample format (semantic tag).
+ * @param resource The memory resource to allocate from. Needs to outlive the image data.
  */
 inline ImageData<ImageDataStorage::Modifiable>::ImageData(PixelLength width,
                                                           PixelLength height,
@@ -335,7 +445,9 @@ inline ImageData<ImageDataStorage::Modifiable>::ImageData(PixelLength width,
                                                           std::uint16_t nr_bytes_per_channel,
                                                           ImageRowAlignment row_alignment_bytes,
                                                           PixelFormat pixel_format,
-                                                          SampleFormat sample_format)
+                                                          SampleFormat sample_format,
+                                                          MemoryResource& resource)
+    : resource_(&resource)
 {
   const auto row_bytes = nr_bytes_per_channel * nr_channels * width;
   const auto stride_bytes = detail::compute_stride_bytes(row_bytes, row_alignment_bytes);
@@ -343,7 +455,7 @@ inline ImageData<ImageDataStorage::Modifiable>::ImageData(PixelLength width,
   constexpr bool force_allocation = false;
   constexpr bool allow_view_reallocation = true;
   allocate(width, height, nr_channels, nr_bytes_per_channel, stride_bytes, row_alignment_bytes, pixel_format,
-           sample_format, shrink_to_fit, force_allocation, allow_view_reallocation);
+           sample_format, ChannelLayout::Interleaved, shrink_to_fit, force_allocation, allow_view_reallocation);
 }
 
 /** \brief Constructs image data (a view onto non-owned memory) with the specified parameters.
@@ -384,7 +496,7 @@ inline ImageData<ImageDataStorage::Modifiable>::ImageData(std::uint8_t* data,
  * The row stride (in bytes) is chosen to be at least `nr_bytes_per_channel * nr_channels * width`, or the supplied
  * value.
  *
- * @param data A `MemoryBlock<NewAllocator>` with the existing data.
+ * @param data A `MemoryBlock<AlignedNewAllocator>` with the existing data.
  * @param width Desired image width.
  * @param height Desired image height.
  * @param nr_channels The number of channels per pixel element.
@@ -406,6 +518,34 @@ inline ImageData<ImageDataStorage::Modifiable>::ImageData(MemoryBlock<AlignedNew
            sample_format);
 }
 
+/** \brief Constructs image data from memory allocated from a memory resource (which will be owned) with the specified
+ * parameters.
+ *
+ * Effectively calls `set_data(std::move(data), width, height, nr_channels, nr_bytes_per_channel, stride_bytes,
+ * pixel_format, output_sample_format);`.
+ *
+ * @param data A `MemoryBlock<MemoryResource>` with the existing data.
+ * @param width Desired image width.
+ * @param height Desired image height.
+ * @param nr_channels The number of channels per pixel element.
+ * @param nr_bytes_per_channel The number of bytes stored per channel.
+ * @param stride_bytes The desired row stride in bytes.
+ * @param pixel_format The pixel format (semantic tag).
+ * @param sample_format The sample format (semantic tag).
+ */
+inline ImageData<ImageDataStorage::Modifiable>::ImageData(MemoryBlock<MemoryResource>&& data,
+                                                          PixelLength width,
+                                                          PixelLength height,
+                                                          std::uint16_t nr_channels,
+                                                          std::uint16_t nr_bytes_per_channel,
+                                                          Stride stride_bytes,
+                                                          PixelFormat pixel_format,
+                                                          SampleFormat sample_format) noexcept
+{
+  set_data(std::move(data), width, height, nr_channels, nr_bytes_per_channel, stride_bytes, pixel_format,
+           sample_format);
+}
+
 /** \brief Destructor.
  *
  * Owned data will be deallocated at destruction time.
@@ -423,6 +563,9 @@ inline ImageData<ImageDataStorage::Modifiable>::~ImageData()
  * image (the data will be copied, s.t. `is_view() == false`), but if the supplied image points to non-owned data, then
  * the constructed image will be a view (`is_view() == true`).
  *
+ * The constructed image allocates from `default_memory_resource()`, irrespective of the memory resource of the supplied
+ * image.
+ *
  * @param other The source image.
  */
 inline ImageData<ImageDataStorage::Modifiable>::ImageData(const ImageData<ImageDataStorage::Modifiable>& other)
@@ -432,7 +575,7 @@ inline ImageData<ImageDataStorage::Modifiable>::ImageData(const ImageData<ImageD
 
   if (other.owns_memory_)
   {
-    const auto nr_bytes = stride_bytes_ * height_;
+    const auto nr_bytes = total_bytes();
     allocate_bytes(nr_bytes, detail::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()),
                                                          other.stride_bytes()));
   }
@@ -446,6 +589,8 @@ inline ImageData<ImageDataStorage::Modifiable>::ImageData(const ImageData<ImageD
  * image (the data will be copied, s.t. `is_view() == false`), but if the supplied image points to non-owned data, then
  * the constructed image will be a view (`is_view() == true`).
  *
+ * The memory resource of this image is retained.
+ *
  * @param other The image to assign from.
  * @return A reference to this image.
  */
@@ -462,11 +607,12 @@ inline ImageData<ImageDataStorage::Modifiable>& ImageData<ImageDataStorage::Modi
   nr_bytes_per_channel_ = other.nr_bytes_per_channel_;
   pixel_format_ = other.pixel_format_;
   sample_format_ = other.sample_format_;
+  channel_layout_ = other.channel_layout_;
   owns_memory_ = other.owns_memory_;
 
   if (other.owns_memory_)
   {
-    const auto nr_bytes = stride_bytes_ * height_;
+    const auto nr_bytes = total_bytes();
     allocate_bytes(nr_bytes, detail::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.byte_ptr()),
                                                          other.stride_bytes()));
   }
@@ -475,6 +621,8 @@ inline ImageData<ImageDataStorage::Modifiable>& ImageData<ImageDataStorage::Modi
 }
 
 /** \brief Move constructor.
+ *
+ * The memory resource is taken over from the supplied image.
  *
  * @param other The image to move from.
  */
@@ -488,12 +636,16 @@ inline ImageData<ImageDataStorage::Modifiable>::ImageData(ImageData<ImageDataSto
   nr_bytes_per_channel_ = other.nr_bytes_per_channel_;
   pixel_format_ = other.pixel_format_;
   sample_format_ = other.sample_format_;
+  channel_layout_ = other.channel_layout_;
   owns_memory_ = other.owns_memory_;
+  resource_ = other.resource_;
 
   other.reset();
 }
 
 /**\brief Move assignment operator.
+ *
+ * The memory resource is taken over from the supplied image.
  *
  * @param other The image to move assign from.
  * @return A reference to this image.
@@ -511,7 +663,9 @@ inline ImageData<ImageDataStorage::Modifiable>& ImageData<ImageDataStorage::Modi
   nr_bytes_per_channel_ = other.nr_bytes_per_channel_;
   pixel_format_ = other.pixel_format_;
   sample_format_ = other.sample_format_;
+  channel_layout_ = other.channel_layout_;
   owns_memory_ = other.owns_memory_;
+  resource_ = other.resource_;
 
   other.reset();
   return *this;
@@ -527,6 +681,15 @@ inline bool ImageData<ImageDataStorage::Modifiable>::is_view() const noexcept
   return !owns_memory_;
 }
 
+/** \brief Returns the memory resource that owned image data is allocated from.
+ *
+ * @return The memory resource.
+ */
+inline MemoryResource& ImageData<ImageDataStorage::Modifiable>::memory_resource() const noexcept
+{
+  return *resource_;
+}
+
 /** \brief Resets the image instance by clearing the image data and resetting the internal state to the state after
  * default construction.
  *
@@ -573,7 +736,7 @@ inline void ImageData<ImageDataStorage::Modifiable>::allocate(PixelLength width,
 {
   constexpr auto base_alignment_bytes = ImageData<ImageDataStorage::Modifiable>::default_base_alignment_;
   allocate(width, height, nr_channels, nr_bytes_per_channel, stride_bytes, base_alignment_bytes, pixel_format,
-           sample_format, shrink_to_fit, force_allocation, allow_view_reallocation);
+           sample_format, ChannelLayout::Interleaved, shrink_to_fit, force_allocation, allow_view_reallocation);
 }
 
 /** \brief Allocates memory for an image with the specified parameters.
@@ -610,7 +773,7 @@ inline void ImageData<ImageDataStorage::Modifiable>::allocate(PixelLength width,
   const auto row_bytes = nr_bytes_per_channel * nr_channels * width;
   const auto stride_bytes = detail::compute_stride_bytes(row_bytes, row_alignment_bytes);
   allocate(width, height, nr_channels, nr_bytes_per_channel, stride_bytes, row_alignment_bytes, pixel_format,
-           sample_format, shrink_to_fit, force_allocation, allow_view_reallocation);
+           sample_format, ChannelLayout::Interleaved, shrink_to_fit, force_allocation, allow_view_reallocation);
 }
 
 /** \brief Resizes the allocated image data to exactly fit an image of size (width x height), with user-defined row
@@ -647,7 +810,7 @@ inline void ImageData<ImageDataStorage::Modifiable>::maybe_allocate(PixelLength
                                                                     SampleFormat sample_format)
 {
   if (width_ == width && height_ == height && nr_channels_ == nr_channels
-      && nr_bytes_per_channel_ == nr_bytes_per_channel)
+      && nr_bytes_per_channel_ == nr_bytes_per_channel && channel_layout_ == ChannelLayout::Interleaved)
   {
     return;
   }
@@ -656,7 +819,67 @@ inline void ImageData<ImageDataStorage::Modifiable>::maybe_allocate(PixelLength
   constexpr auto shrink_to_fit = true;
   constexpr auto force_allocation = false;
   constexpr auto allow_view_reallocation = false;
-  allocate(width, height, nr_channels, nr_bytes_per_channel, stride_bytes, base_alignment_bytes, pixel_format, sample_format, shrink_to_fit, force_allocation, allow_view_reallocation);
+  allocate(width, height, nr_channels, nr_bytes_per_channel, stride_bytes, base_alignment_bytes, pixel_format,
+           sample_format, ChannelLayout::Interleaved, shrink_to_fit, force_allocation, allow_view_reallocation);
+}
+
+/** \brief Allocates zero-initialized memory for an image with the specified parameters.
+ *
+ * Use instead of allocating and subsequently clearing the image data. New memory is always allocated, through the
+ * `allocate_zeroed()` function of the memory resource; for the default resource and `MappedMemoryResource`, large
+ * images are backed by fresh pages from the operating system, which are zeroed lazily on first access.
+ *
+ * The row stride (in bytes) is chosen to be at least `width * nr_channels * nr_bytes_per_channel`, or the supplied
+ * value.
+ *
+ * Postconditions: `!is_view() && (stride_bytes() >= nr_bytes_per_channel * nr_channels * width)`, and all bytes of the
+ * image data (including any row padding) are zero.
+ *
+ * @param width Desired image width.
+ * @param height Desired image height.
+ * @param nr_channels The number of channels per pixel element.
+ * @param nr_bytes_per_channel The number of bytes stored per channel.
+ * @param stride_bytes The row stride in bytes.
+ * @param pixel_format The pixel format (semantic tag).
+ * @param sample_format The sample format (semantic tag).
+ */
+inline void ImageData<ImageDataStorage::Modifiable>::allocate_zeroed(PixelLength width,
+                                                                     PixelLength height,
+                                                                     std::uint16_t nr_channels,
+                                                                     std::uint16_t nr_bytes_per_channel,
+                                                                     Stride stride_bytes,
+                                                                     PixelFormat pixel_format,
+                                                                     SampleFormat sample_format)
+{
+  allocate_zeroed(width, height, nr_channels, nr_bytes_per_channel, stride_bytes,
+                  ImageData<ImageDataStorage::Modifiable>::default_base_alignment_, pixel_format, sample_format);
+}
+
+/** \brief Allocates zero-initialized memory for an image with the specified parameters, with user-defined row
+ * alignment.
+ *
+ * See the overload taking a row stride for details.
+ *
+ * @param width Desired image width.
+ * @param height Desired image height.
+ * @param nr_channels The number of channels per pixel element.
+ * @param nr_bytes_per_channel The number of bytes stored per channel.
+ * @param row_alignment_bytes The desired row alignment in bytes.
+ * @param pixel_format The pixel format (semantic tag).
+ * @param sample_format The sample format (semantic tag).
+ */
+inline void ImageData<ImageDataStorage::Modifiable>::allocate_zeroed(PixelLength width,
+                                                                     PixelLength height,
+                                                                     std::uint16_t nr_channels,
+                                                                     std::uint16_t nr_bytes_per_channel,
+                                                                     ImageRowAlignment row_alignment_bytes,
+                                                                     PixelFormat pixel_format,
+                                                                     SampleFormat sample_format)
+{
+  const auto row_bytes = nr_bytes_per_channel * nr_channels * width;
+  const auto stride_bytes = detail::compute_stride_bytes(row_bytes, row_alignment_bytes);
+  allocate_zeroed(width, height, nr_channels, nr_bytes_per_channel, stride_bytes, row_alignment_bytes, pixel_format,
+                  sample_format);
 }
 
 /** \brief Sets the image data to be a view onto non-owned external memory.
@@ -695,6 +918,7 @@ inline void ImageData<ImageDataStorage::Modifiable>::set_view(std::uint8_t* data
   nr_bytes_per_channel_ = nr_bytes_per_channel;
   pixel_format_ = pixel_format;
   sample_format_ = sample_format;
+  channel_layout_ = ChannelLayout::Interleaved;
   owns_memory_ = false;
 }
 
@@ -737,6 +961,180 @@ inline void ImageData<ImageDataStorage::Modifiable>::set_data(MemoryBlock<Aligne
   nr_bytes_per_channel_ = nr_bytes_per_channel;
   pixel_format_ = pixel_format;
   sample_format_ = sample_format;
+  channel_layout_ = ChannelLayout::Interleaved;
+  owns_memory_ = true;
+  resource_ = &default_memory_resource();
+}
+
+/** \brief Sets the image data to the provided memory block, which will be owned by the `ImageData` instance.
+ *
+ * The row stride (in bytes) is chosen to be at least `nr_bytes_per_channel * nr_channels * width`, or the supplied
+ * value. The image will subsequently allocate from the resource of the memory block.
+ *
+ * Precondition: `data.size() >= stride_bytes * height`.
+ *
+ * Postcondition: `!is_view()`.
+ *
+ * @param data Memory block of image data, allocated from a memory resource.
+ * @param width The image width.
+ * @param height The image height.
+ * @param nr_channels The number of channels for each pixel element.
+ * @param nr_bytes_per_channel The number of bytes per channel in each pixel element.
+ * @param stride_bytes The row stride in bytes.
+ * @param pixel_format The pixel format (semantic tag).
+ * @param sample_format The sample format (semantic tag).
+ */
+inline void ImageData<ImageDataStorage::Modifiable>::set_data(MemoryBlock<MemoryResource>&& data,
+                                                              PixelLength width,
+                                                              PixelLength height,
+                                                              std::uint16_t nr_channels,
+                                                              std::uint16_t nr_bytes_per_channel,
+                                                              Stride stride_bytes,
+                                                              PixelFormat pixel_format,
+                                                              SampleFormat sample_format)
+{
+  stride_bytes = std::max(stride_bytes, Stride(nr_bytes_per_channel * nr_channels * width));
+  SELENE_ASSERT(data.size() >= stride_bytes * height);
+
+  deallocate_bytes_if_owned();
+  resource_ = &data.resource();
+  data_ = data.transfer_data();
+  width_ = width;
+  height_ = height;
+  stride_bytes_ = stride_bytes;
+  nr_channels_ = nr_channels;
+  nr_bytes_per_channel_ = nr_bytes_per_channel;
+  pixel_format_ = pixel_format;
+  sample_format_ = sample_format;
+  channel_layout_ = ChannelLayout::Interleaved;
+  owns_memory_ = true;
+}
+
+/** \brief Allocates memory for planar image data with the specified parameters.
+ *
+ * Allocates `stride_bytes * height * nr_channels` bytes of memory to represent an image with the respective width,
+ * height, and number of channels, where each channel is stored in a separate plane. The planes are stored
+ * consecutively, and can be accessed via `plane_byte_ptr()`.
+ *
+ * The row stride (in bytes) of each plane is chosen to be at least `nr_bytes_per_channel * width`, or the supplied
+ * value.
+ *
+ * Postconditions: `!is_view() && is_planar() && (stride_bytes() >= nr_bytes_per_channel * width)`.
+ *
+ * @param width Desired image width.
+ * @param height Desired image height.
+ * @param nr_channels The number of channels, i.e. planes.
+ * @param nr_bytes_per_channel The number of bytes stored per channel.
+ * @param stride_bytes The row stride in bytes, for each plane.
+ * @param pixel_format The pixel format (semantic tag).
+ * @param sample_format The sample format (semantic tag).
+ * @param shrink_to_fit If true, reallocate if it results in less memory usage; otherwise allow excess memory to stay
+ * allocated
+ * @param force_allocation If true, always force a reallocation. Overrides `allow_view_reallocation == false`.
+ * @param allow_view_reallocation If true, allow allocation from `is_view() == true`. If false, and the existing image
+ * is a view, a `std::runtime_error` exception will be thrown (respecting the strong exception guarantee).
+ */
+inline void ImageData<ImageDataStorage::Modifiable>::allocate_planar(PixelLength width,
+                                                                     PixelLength height,
+                                                                     std::uint16_t nr_channels,
+                                                                     std::uint16_t nr_bytes_per_channel,
+                                                                     Stride stride_bytes,
+                                                                     PixelFormat pixel_format,
+                                                                     SampleFormat sample_format,
+                                                                     bool shrink_to_fit,
+                                                                     bool force_allocation,
+                                                                     bool allow_view_reallocation)
+{
+  constexpr auto base_alignment_bytes = ImageData<ImageDataStorage::Modifiable>::default_base_alignment_;
+  allocate(width, height, nr_channels, nr_bytes_per_channel, stride_bytes, base_alignment_bytes, pixel_format,
+           sample_format, ChannelLayout::Planar, shrink_to_fit, force_allocation, allow_view_reallocation);
+}
+
+/** \brief Sets the image data to be a view onto non-owned external planar memory.
+ *
+ * The `nr_channels` planes are expected to be stored consecutively, i.e. plane `c` starts at byte offset
+ * `c * stride_bytes * height` from `data`.
+ *
+ * The row stride (in bytes) of each plane is chosen to be at least `nr_bytes_per_channel * width`, or the supplied
+ * value.
+ *
+ * Postcondition: `is_view() && is_planar()`.
+ *
+ * @param data Pointer to the external data, i.e. to the first byte of the first plane.
+ * @param width The image width.
+ * @param height The image height.
+ * @param nr_channels The number of channels, i.e. planes.
+ * @param nr_bytes_per_channel The number of bytes per channel.
+ * @param stride_bytes The row stride in bytes, for each plane.
+ * @param pixel_format The pixel format (semantic tag).
+ * @param sample_format The sample format (semantic tag).
+ */
+inline void ImageData<ImageDataStorage::Modifiable>::set_planar_view(std::uint8_t* data,
+                                                                     PixelLength width,
+                                                                     PixelLength height,
+                                                                     std::uint16_t nr_channels,
+                                                                     std::uint16_t nr_bytes_per_channel,
+                                                                     Stride stride_bytes,
+                                                                     PixelFormat pixel_format,
+                                                                     SampleFormat sample_format)
+{
+  stride_bytes = std::max(stride_bytes, Stride(nr_bytes_per_channel * width));
+
+  deallocate_bytes_if_owned();
+  data_ = data;
+  width_ = width;
+  height_ = height;
+  stride_bytes_ = stride_bytes;
+  nr_channels_ = nr_channels;
+  nr_bytes_per_channel_ = nr_bytes_per_channel;
+  pixel_format_ = pixel_format;
+  sample_format_ = sample_format;
+  channel_layout_ = ChannelLayout::Planar;
+  owns_memory_ = false;
+}
+
+/** \brief Sets the image data to the provided memory block of planar data, which will be owned by the `ImageData`
+ * instance.
+ *
+ * The `nr_channels` planes are expected to be stored consecutively, i.e. plane `c` starts at byte offset
+ * `c * stride_bytes * height`. The image will subsequently allocate from the resource of the memory block.
+ *
+ * Precondition: `data.size() >= stride_bytes * height * nr_channels`.
+ *
+ * Postcondition: `!is_view() && is_planar()`.
+ *
+ * @param data Memory block of image data, allocated from a memory resource.
+ * @param width The image width.
+ * @param height The image height.
+ * @param nr_channels The number of channels, i.e. planes.
+ * @param nr_bytes_per_channel The number of bytes per channel.
+ * @param stride_bytes The row stride in bytes, for each plane.
+ * @param pixel_format The pixel format (semantic tag).
+ * @param sample_format The sample format (semantic tag).
+ */
+inline void ImageData<ImageDataStorage::Modifiable>::set_planar_data(MemoryBlock<MemoryResource>&& data,
+                                                                     PixelLength width,
+                                                                     PixelLength height,
+                                                                     std::uint16_t nr_channels,
+                                                                     std::uint16_t nr_bytes_per_channel,
+                                                                     Stride stride_bytes,
+                                                                     PixelFormat pixel_format,
+                                                                     SampleFormat sample_format)
+{
+  stride_bytes = std::max(stride_bytes, Stride(nr_bytes_per_channel * width));
+  SELENE_ASSERT(data.size() >= stride_bytes * height * nr_channels);
+
+  deallocate_bytes_if_owned();
+  resource_ = &data.resource();
+  data_ = data.transfer_data();
+  width_ = width;
+  height_ = height;
+  stride_bytes_ = stride_bytes;
+  nr_channels_ = nr_channels;
+  nr_bytes_per_channel_ = nr_bytes_per_channel;
+  pixel_format_ = pixel_format;
+  sample_format_ = sample_format;
+  channel_layout_ = ChannelLayout::Planar;
   owns_memory_ = true;
 }
 
@@ -801,6 +1199,54 @@ inline const std::uint8_t* ImageData<ImageDataStorage::Modifiable>::byte_ptr(Pix
   return data_ + compute_data_offset(x, y);
 }
 
+/** \brief Returns a pointer to the first byte of the specified plane.
+ *
+ * For interleaved image data, there is only one "plane" (`channel == 0`), starting at `byte_ptr()`.
+ *
+ * @param channel The channel index, i.e. the plane index.
+ * @return Pointer to the first data byte of the plane.
+ */
+inline std::uint8_t* ImageData<ImageDataStorage::Modifiable>::plane_byte_ptr(std::uint16_t channel) noexcept
+{
+  return data_ + compute_plane_offset(channel);
+}
+
+/** \brief Returns a constant pointer to the first byte of the specified plane.
+ *
+ * For interleaved image data, there is only one "plane" (`channel == 0`), starting at `byte_ptr()`.
+ *
+ * @param channel The channel index, i.e. the plane index.
+ * @return Constant pointer to the first data byte of the plane.
+ */
+inline const std::uint8_t* ImageData<ImageDataStorage::Modifiable>::plane_byte_ptr(std::uint16_t channel) const noexcept
+{
+  return data_ + compute_plane_offset(channel);
+}
+
+/** \brief Returns a pointer to the first byte of row `y` of the specified plane.
+ *
+ * @param channel The channel index, i.e. the plane index.
+ * @param y Row index.
+ * @return Pointer to the first data byte of row `y` of the plane.
+ */
+inline std::uint8_t* ImageData<ImageDataStorage::Modifiable>::plane_byte_ptr(std::uint16_t channel,
+                                                                            PixelIndex y) noexcept
+{
+  return data_ + compute_plane_offset(channel) + compute_data_offset(y);
+}
+
+/** \brief Returns a constant pointer to the first byte of row `y` of the specified plane.
+ *
+ * @param channel The channel index, i.e. the plane index.
+ * @param y Row index.
+ * @return Constant pointer to the first data byte of row `y` of the plane.
+ */
+inline const std::uint8_t* ImageData<ImageDataStorage::Modifiable>::plane_byte_ptr(std::uint16_t channel,
+                                                                                  PixelIndex y) const noexcept
+{
+  return data_ + compute_plane_offset(channel) + compute_data_offset(y);
+}
+
 /** \brief Returns a pointer to the first pixel element (i.e. at row 0, column 0).
  *
  * Due to the "dynamically" typed image data, the pixel type has to be determined at function call granularity.
@@ -891,7 +1337,7 @@ PixelType* ImageData<ImageDataStorage::Modifiable>::data_row_end(PixelIndex y) n
   SELENE_ASSERT(nr_bytes_per_channel_ == PixelTraits<PixelType>::nr_bytes_per_channel);
   SELENE_ASSERT(sample_format_ == SampleFormat::Unknown || sample_format_ == PixelTraits<PixelType>::sample_format);
 
-  return reinterpret_cast<PixelType*>(byte_ptr(y) + nr_bytes_per_channel_ * nr_channels_ * width_);
+  return reinterpret_cast<PixelType*>(byte_ptr(y) + row_bytes());
 }
 
 /** \brief Returns a constant pointer to the one-past-the-last pixel element of the y-th row (i.e. at row y,
@@ -911,7 +1357,7 @@ const PixelType* ImageData<ImageDataStorage::Modifiable>::data_row_end(PixelInde
   SELENE_ASSERT(nr_bytes_per_channel_ == PixelTraits<PixelType>::nr_bytes_per_channel);
   SELENE_ASSERT(sample_format_ == SampleFormat::Unknown || sample_format_ == PixelTraits<PixelType>::sample_format);
 
-  return reinterpret_cast<const PixelType*>(byte_ptr(y) + nr_bytes_per_channel_ * nr_channels_ * width_);
+  return reinterpret_cast<const PixelType*>(byte_ptr(y) + row_bytes());
 }
 
 /** \brief Returns a pointer to the x-th pixel element of the y-th row (i.e. at row y, column x).
@@ -994,12 +1440,16 @@ inline void ImageData<ImageDataStorage::Modifiable>::allocate(PixelLength width,
                                                               std::size_t base_alignment_bytes,
                                                               PixelFormat pixel_format,
                                                               SampleFormat sample_format,
+                                                              ChannelLayout channel_layout,
                                                               bool shrink_to_fit,
                                                               bool force_allocation,
                                                               bool allow_view_reallocation)
 {
-  stride_bytes = std::max(stride_bytes, Stride(nr_bytes_per_channel * nr_channels * width));
-  const auto nr_bytes_to_allocate = stride_bytes * height;
+  const auto planar = (channel_layout == ChannelLayout::Planar);
+  const auto nr_row_channels = planar ? std::uint16_t{1} : nr_channels;
+  const auto nr_planes = planar ? nr_channels : std::uint16_t{1};
+  stride_bytes = std::max(stride_bytes, Stride(nr_bytes_per_channel * nr_row_channels * width));
+  const auto nr_bytes_to_allocate = stride_bytes * height * nr_planes;
   const auto nr_currently_allocated_bytes = total_bytes();
 
   auto commit_new_geometry = [=]() {
@@ -1010,6 +1460,7 @@ inline void ImageData<ImageDataStorage::Modifiable>::allocate(PixelLength width,
     nr_bytes_per_channel_ = nr_bytes_per_channel;
     pixel_format_ = pixel_format;
     sample_format_ = sample_format;
+    channel_layout_ = channel_layout;
   };
 
   const auto bytes_match = shrink_to_fit ? (nr_bytes_to_allocate == nr_currently_allocated_bytes)
@@ -1032,10 +1483,37 @@ inline void ImageData<ImageDataStorage::Modifiable>::allocate(PixelLength width,
   allocate_bytes(nr_bytes_to_allocate, base_alignment_bytes);
 }
 
-inline void ImageData<ImageDataStorage::Modifiable>::allocate_bytes(std::size_t nr_bytes, std::size_t alignment)
+inline void ImageData<ImageDataStorage::Modifiable>::allocate_zeroed(PixelLength width,
+                                                                     PixelLength height,
+                                                                     std::uint16_t nr_channels,
+                                                                     std::uint16_t nr_bytes_per_channel,
+                                                                     Stride stride_bytes,
+                                                                     std::size_t base_alignment_bytes,
+                                                                     PixelFormat pixel_format,
+                                                                     SampleFormat sample_format)
+{
+  stride_bytes = std::max(stride_bytes, Stride(nr_bytes_per_channel * nr_channels * width));
+
+  width_ = width;
+  height_ = height;
+  stride_bytes_ = stride_bytes;
+  nr_channels_ = nr_channels;
+  nr_bytes_per_channel_ = nr_bytes_per_channel;
+  pixel_format_ = pixel_format;
+  sample_format_ = sample_format;
+  channel_layout_ = ChannelLayout::Interleaved;
+
+  deallocate_bytes_if_owned();
+  owns_memory_ = true;
+  allocate_bytes(stride_bytes * height, base_alignment_bytes, true);
+}
+
+inline void ImageData<ImageDataStorage::Modifiable>::allocate_bytes(std::size_t nr_bytes,
+                                                                    std::size_t alignment,
+                                                                    bool zeroed)
 {
   SELENE_ASSERT(owns_memory_);
-  auto memory = AlignedNewAllocator::allocate(nr_bytes, alignment);
+  auto memory = zeroed ? resource_->allocate_zeroed(nr_bytes, alignment) : resource_->allocate(nr_bytes, alignment);
   SELENE_ASSERT(memory.size() == nr_bytes);
   data_ = memory.transfer_data();
 }
@@ -1046,7 +1524,7 @@ inline void ImageData<ImageDataStorage::Modifiable>::deallocate_bytes()
 
   if (data_)
   {
-    AlignedNewAllocator::deallocate(data_);
+    resource_->deallocate(data_);
     SELENE_ASSERT(data_ == nullptr);
   }
 }
@@ -1065,7 +1543,7 @@ inline void ImageData<ImageDataStorage::Modifiable>::reset()
   owns_memory_ = true;
 }
 
-inline MemoryBlock<AlignedNewAllocator> ImageData<ImageDataStorage::Modifiable>::relinquish_data_ownership()
+inline MemoryBlock<MemoryResource> ImageData<ImageDataStorage::Modifiable>::relinquish_data_ownership()
 {
   SELENE_FORCED_ASSERT(owns_memory_);
   const auto ptr = data_;
@@ -1073,7 +1551,7 @@ inline MemoryBlock<AlignedNewAllocator> ImageData<ImageDataStorage::Modifiable>:
 
   owns_memory_ = false;
   clear();
-  return construct_memory_block_from_existing_memory<AlignedNewAllocator>(ptr, len);
+  return construct_memory_block_from_existing_memory(ptr, len, *resource_);
 }
 
 }  // namespace sln
@@ -41,6 +41,8 @@ public:
   std::size_t total_bytes() const noexcept;
   PixelFormat pixel_format() const noexcept;
   SampleFormat sample_format() const noexcept;
+  ChannelLayout channel_layout() const noexcept;
+  bool is_planar() const noexcept;
   bool is_packed() const noexcept;
   bool is_view() const noexcept;
   bool is_empty() const noexcept;
@@ -64,6 +66,9 @@ public:
   const std::uint8_t* byte_ptr(PixelIndex y) const noexcept;
   const std::uint8_t* byte_ptr(PixelIndex x, PixelIndex y) const noexcept;
 
+  const std::uint8_t* plane_byte_ptr(std::uint16_t channel) const noexcept;
+  const std::uint8_t* plane_byte_ptr(std::uint16_t channel, PixelIndex y) const noexcept;
+
   template <typename PixelType>
   const PixelType* data() const noexcept;
 
@@ -89,12 +94,15 @@ protected:
   std::uint16_t nr_bytes_per_channel_ = 0;
   PixelFormat pixel_format_ = PixelFormat::Unknown;
   SampleFormat sample_format_ = SampleFormat::Unknown;
+  ChannelLayout channel_layout_ = ChannelLayout::Interleaved;
 
   ImageDataBase() = default;
 
   void reset();
+  std::size_t pixel_bytes() const noexcept;
   Bytes compute_data_offset(PixelIndex y) const noexcept;
   Bytes compute_data_offset(PixelIndex x, PixelIndex y) const noexcept;
+  Bytes compute_plane_offset(std::uint16_t channel) const noexcept;
   /// \endcond
 };
 
@@ -145,6 +153,8 @@ inline std::uint16_t ImageDataBase<DataStoragePtr>::nr_bytes_per_channel() const
  * `(stride_bytes() >= width() * nr_channels() * nr_bytes_per_channel())`.
  * If it is equal, then `is_packed()` returns `true`, otherwise `is_packed()` returns `false`.
  *
+ * For planar image data, the row stride applies to each plane, and `(stride_bytes() >= row_bytes())`.
+ *
  * @return Row stride in bytes.
  */
 template <typename DataStoragePtr>
@@ -155,7 +165,8 @@ inline Stride ImageDataBase<DataStoragePtr>::stride_bytes() const noexcept
 
 /** \brief Returns the number of data bytes occupied by each image row.
  *
- * The value returned is equal to `(width() * nr_channels() * nr_bytes_per_channel())`.
+ * The value returned is equal to `(width() * nr_channels() * nr_bytes_per_channel())`, or to
+ * `(width() * nr_bytes_per_channel())` for each plane row of planar image data.
  * It follows that `stride_bytes() >= row_bytes()`, since `stride_bytes()` may include additional padding bytes.
  *
  * @return Number of data bytes occupied by each image row.
@@ -163,19 +174,20 @@ inline Stride ImageDataBase<DataStoragePtr>::stride_bytes() const noexcept
 template <typename DataStoragePtr>
 inline std::size_t ImageDataBase<DataStoragePtr>::row_bytes() const noexcept
 {
-  return width_ * nr_channels_ * nr_bytes_per_channel_;
+  return width_ * pixel_bytes();
 }
 
 /** \brief Returns the total number of bytes occupied by the image data in memory.
  *
- * The value returned is equal to `(stride_bytes() * height())`.
+ * The value returned is equal to `(stride_bytes() * height())`, or to `(stride_bytes() * height() * nr_channels())`
+ * for planar image data.
  *
  * @return Number of bytes occupied by the image data in memory.
  */
 template <typename DataStoragePtr>
 inline std::size_t ImageDataBase<DataStoragePtr>::total_bytes() const noexcept
 {
-  return stride_bytes_ * height_;
+  return stride_bytes_ * height_ * (channel_layout_ == ChannelLayout::Planar ? nr_channels_ : 1);
 }
 
 /** \brief Returns the pixel format (semantic tag).
@@ -198,16 +210,40 @@ inline SampleFormat ImageDataBase<DataStoragePtr>::sample_format() const noexcep
   return sample_format_;
 }
 
+/** \brief Returns the channel layout, i.e. whether the channels are stored interleaved or in separate planes.
+ *
+ * @return The channel layout.
+ */
+template <typename DataStoragePtr>
+inline ChannelLayout ImageDataBase<DataStoragePtr>::channel_layout() const noexcept
+{
+  return channel_layout_;
+}
+
+/** \brief Returns whether the channels are stored in separate planes.
+ *
+ * Planar image data consists of `nr_channels()` planes, each of which is laid out like single-channel image data with
+ * row stride `stride_bytes()`. The planes are stored consecutively; plane `c` starts at byte offset
+ * `c * stride_bytes() * height()`. Use `plane_byte_ptr()` to access the planes.
+ *
+ * @return True, if `channel_layout() == ChannelLayout::Planar`; false otherwise.
+ */
+template <typename DataStoragePtr>
+inline bool ImageDataBase<DataStoragePtr>::is_planar() const noexcept
+{
+  return channel_layout_ == ChannelLayout::Planar;
+}
+
 /** \brief Returns whether the image data is stored packed in memory.
  *
- * Returns the boolean expression `(stride_bytes() == width() * nr_channels() * nr_bytes_per_channel())`.
+ * Returns the boolean expression `(stride_bytes() == row_bytes())`.
  *
  * @return True, if the image data stored packed; false otherwise.
  */
 template <typename DataStoragePtr>
 inline bool ImageDataBase<DataStoragePtr>::is_packed() const noexcept
 {
-  return stride_bytes_ == static_cast<Stride::value_type>(nr_bytes_per_channel_ * nr_channels_ * width_);
+  return stride_bytes_ == static_cast<Stride::value_type>(row_bytes());
 }
 
 /** \brief Returns whether the image is a view onto (non-owned) memory.
@@ -295,6 +331,7 @@ inline void ImageDataBase<DataStoragePtr>::set_view(DataStoragePtr data,
   nr_bytes_per_channel_ = nr_bytes_per_channel;
   pixel_format_ = pixel_format;
   sample_format_ = sample_format;
+  channel_layout_ = ChannelLayout::Interleaved;
 }
 
 /** \brief Sets the pixel format.
@@ -351,6 +388,32 @@ inline const std::uint8_t* ImageDataBase<DataStoragePtr>::byte_ptr(PixelIndex x,
   return data_ + compute_data_offset(x, y);
 }
 
+/** \brief Returns a constant pointer to the first byte of the specified plane.
+ *
+ * For interleaved image data, there is only one "plane" (`channel == 0`), starting at `byte_ptr()`.
+ *
+ * @param channel The channel index, i.e. the plane index.
+ * @return Constant pointer to the first data byte of the plane.
+ */
+template <typename DataStoragePtr>
+inline const std::uint8_t* ImageDataBase<DataStoragePtr>::plane_byte_ptr(std::uint16_t channel) const noexcept
+{
+  return data_ + compute_plane_offset(channel);
+}
+
+/** \brief Returns a constant pointer to the first byte of row `y` of the specified plane.
+ *
+ * @param channel The channel index, i.e. the plane index.
+ * @param y Row index.
+ * @return Constant pointer to the first data byte of row `y` of the plane.
+ */
+template <typename DataStoragePtr>
+inline const std::uint8_t* ImageDataBase<DataStoragePtr>::plane_byte_ptr(std::uint16_t channel,
+                                                                         PixelIndex y) const noexcept
+{
+  return data_ + compute_plane_offset(channel) + compute_data_offset(y);
+}
+
 /** \brief Returns a constant pointer to the first pixel element (i.e. at row 0, column 0).
  *
  * Due to the "dynamically" typed image data, the pixel type has to be determined at function call granularity.
@@ -408,7 +471,7 @@ const PixelType* ImageDataBase<DataStoragePtr>::data_row_end(PixelIndex y) const
   SELENE_ASSERT(nr_bytes_per_channel_ == PixelTraits<PixelType>::nr_bytes_per_channel);
   SELENE_ASSERT(sample_format_ == SampleFormat::Unknown || sample_format_ == PixelTraits<PixelType>::sample_format);
 
-  return reinterpret_cast<const PixelType*>(byte_ptr(y) + nr_bytes_per_channel_ * nr_channels_ * width_);
+  return reinterpret_cast<const PixelType*>(byte_ptr(y) + row_bytes());
 }
 
 /** \brief Returns a constant pointer to the x-th pixel element of the y-th row (i.e. at row y, column x).
@@ -461,6 +524,15 @@ inline void ImageDataBase<DataStoragePtr>::reset()
   nr_bytes_per_channel_ = std::uint16_t{0};
   pixel_format_ = PixelFormat::Unknown;
   sample_format_ = SampleFormat::Unknown;
+  channel_layout_ = ChannelLayout::Interleaved;
+}
+
+// Number of bytes per pixel element in a row; a planar row only holds one channel.
+template <typename DataStoragePtr>
+inline std::size_t ImageDataBase<DataStoragePtr>::pixel_bytes() const noexcept
+{
+  return (channel_layout_ == ChannelLayout::Planar) ? nr_bytes_per_channel_
+                                                    : std::size_t{nr_bytes_per_channel_} * nr_channels_;
 }
 
 template <typename DataStoragePtr>
@@ -472,7 +544,14 @@ inline Bytes ImageDataBase<DataStoragePtr>::compute_data_offset(PixelIndex y) co
 template <typename DataStoragePtr>
 inline Bytes ImageDataBase<DataStoragePtr>::compute_data_offset(PixelIndex x, PixelIndex y) const noexcept
 {
-  return Bytes(stride_bytes_ * y + nr_bytes_per_channel_ * nr_channels_ * x);
+  return Bytes(stride_bytes_ * y + pixel_bytes() * x);
+}
+
+template <typename DataStoragePtr>
+inline Bytes ImageDataBase<DataStoragePtr>::compute_plane_offset(std::uint16_t channel) const noexcept
+{
+  SELENE_ASSERT(channel == 0 || (channel_layout_ == ChannelLayout::Planar && channel < nr_channels_));
+  return Bytes(stride_bytes_ * height_ * channel);
 }
 
 }  // namespace sln
@@ -34,6 +34,7 @@ Image<PixelType> to_image_view(ImageData<>& img_data);
  * The number of channels, the number of bytes per channel, and the sample format of the `ImageData` instance need to be
  * compatible with the `PixelTraits` of `PixelType`. If this is not the case, this function will throw a
  * `std::runtime_error` exception.
+ * Planar image data (with more than one channel) cannot be converted; see `to_planar_image()` instead.
  *
  * The `ImageData` instance `img_data` is moved from, i.e. it will be in a valid but unspecified state after the
  * function call.
@@ -57,6 +58,11 @@ Image<PixelType> to_image(ImageData<>&& img_data)
     throw std::runtime_error("Supplied image data is not valid.");
   }
 
+  if (img_data.is_planar() && img_data.nr_channels() > 1)
+  {
+    throw std::runtime_error("Cannot convert planar ImageData to Image<>; use to_planar_image() instead.");
+  }
+
   if (img_data.nr_channels() != nr_channels || img_data.nr_bytes_per_channel() != nr_bytes_per_channel)
   {
     throw std::runtime_error("Cannot convert ImageData to desired Image<> format: incompatible nr of channels.");
@@ -93,6 +99,7 @@ Image<PixelType> to_image(ImageData<>&& img_data)
  * The number of channels, the number of bytes per channel, and the sample format of the `ImageData` instance need to be
  * compatible with the `PixelTraits` of `PixelType`. If this is not the case, this function will throw a
  * `std::runtime_error` exception.
+ * Planar image data (with more than one channel) cannot be converted; see `to_planar_image()` instead.
  *
  * As the resulting `Image<PixelType>` is a non-owning view, the lifetime of the supplied `ImageData` instance must be
  * equal to or exceed the lifetime of the returned instance.
@@ -113,6 +120,11 @@ Image<PixelType> to_image_view(ImageData<>& img_data)
     throw std::runtime_error("Supplied image data is not valid.");
   }
 
+  if (img_data.is_planar() && img_data.nr_channels() > 1)
+  {
+    throw std::runtime_error("Cannot convert planar ImageData to Image<>; use to_planar_image() instead.");
+  }
+
   if (img_data.nr_channels() != nr_channels || img_data.nr_bytes_per_channel() != nr_bytes_per_channel)
   {
     throw std::runtime_error("Cannot convert ImageData to desired Image<> format: incompatible nr of channels.");
@@ -12,8 +12,12 @@
 
 #include <selene/img/BorderAccessors.hpp>
 #include <selene/img/Image.hpp>
+#include <selene/img/OrientedView.hpp>
 #include <selene/img/Pixel.hpp>
+#include <selene/img/PixelTraits.hpp>
 
+#include <cmath>
+#include <cstdint>
 #include <type_traits>
 
 namespace sln {
@@ -25,7 +29,20 @@ namespace sln {
 enum class ImageInterpolationMode
 {
   NearestNeighbor,  ///< Nearest neighbor interpolation.
-  Bilinear  ///< Bilinear interpolation.
+  Bilinear,  ///< Bilinear interpolation.
+  Bicubic,  ///< Bicubic interpolation; filter based, i.e. anti-aliased when downsampling. Only supported by `resample`.
+  Lanczos3,  ///< Lanczos interpolation (a = 3); filter based, i.e. anti-aliased when downsampling. Only supported by
+             ///< `resample`.
+  Area,  ///< Area averaging; i.e. a box filter covering the source area of each pixel. Only supported by `resample`.
+};
+
+/** The arithmetic precision used for interpolation.
+ */
+enum class InterpolationPrecision
+{
+  FloatingPoint,  ///< Floating point arithmetic; interpolated pixel values are returned with floating point elements.
+  FixedPoint,  ///< Fixed-point integer arithmetic, for 8- and 16-bit integral pixel elements; interpolated pixel values
+               ///< are rounded, and returned with the same element type as the image.
 };
 
 /** \brief Image interpolator structure; provides a static `interpolate` function to access image pixels according to
@@ -34,16 +51,23 @@ enum class ImageInterpolationMode
  * @tparam ImageInterpolationMode The interpolation mode to use.
  * @tparam BorderAccessMode The border access mode (`BorderAccessMode`) to use. Defaults to
  * `BorderAccessMode::Unchecked`.
+ * @tparam InterpolationPrecision The arithmetic precision (`InterpolationPrecision`) to use. Defaults to
+ * `InterpolationPrecision::FloatingPoint`.
  */
-template <ImageInterpolationMode, BorderAccessMode = BorderAccessMode::Unchecked>
+template <ImageInterpolationMode,
+          BorderAccessMode = BorderAccessMode::Unchecked,
+          InterpolationPrecision = InterpolationPrecision::FloatingPoint>
 struct ImageInterpolator;
 
 /** \brief Partial `ImageInterpolator` specialization for `ImageInterpolationMode::NearestNeighbor`.
+ *
+ * No arithmetic is performed on pixel values, so the result does not depend on the interpolation precision.
  *
  * @tparam AccessMode The border access mode (`BorderAccessMode`) to use.
+ * @tparam Precision The interpolation precision (`InterpolationPrecision`).
  */
-template <BorderAccessMode AccessMode>
-struct ImageInterpolator<ImageInterpolationMode::NearestNeighbor, AccessMode>
+template <BorderAccessMode AccessMode, InterpolationPrecision Precision>
+struct ImageInterpolator<ImageInterpolationMode::NearestNeighbor, AccessMode, Precision>
 {
   constexpr static PixelLength::value_type index_to_left = 0;
   constexpr static PixelLength::value_type index_to_right = 1;
@@ -57,12 +81,13 @@ struct ImageInterpolator<ImageInterpolationMode::NearestNeighbor, AccessMode>
   static auto interpolate(const RelativeAccessor<PixelType>& img, ScalarAccess x, ScalarAccess y) noexcept;
 };
 
-/** \brief Partial `ImageInterpolator` specialization for `ImageInterpolationMode::Bilinear`.
+/** \brief Partial `ImageInterpolator` specialization for `ImageInterpolationMode::Bilinear` and
+ * `InterpolationPrecision::FloatingPoint`.
  *
  * @tparam AccessMode The border access mode (`BorderAccessMode`) to use.
  */
 template <BorderAccessMode AccessMode>
-struct ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode>
+struct ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode, InterpolationPrecision::FloatingPoint>
 {
   constexpr static PixelLength::value_type index_to_left = 0;
   constexpr static PixelLength::value_type index_to_right = 1;
@@ -77,8 +102,99 @@ struct ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode>
             typename ScalarAccess = default_float_t,
             typename ScalarOutputElement = default_float_t>
   static auto interpolate(const Image<Pixel<T, nr_channels>>& img, ScalarAccess x, ScalarAccess y) noexcept;
+
+  template <typename T,
+            std::size_t nr_channels,
+            typename ScalarAccess = default_float_t,
+            typename ScalarOutputElement = default_float_t>
+  static auto interpolate(const OrientedView<Pixel<T, nr_channels>>& img, ScalarAccess x, ScalarAccess y) noexcept;
 };
 
+/** \brief Partial `ImageInterpolator` specialization for `ImageInterpolationMode::Bilinear` and
+ * `InterpolationPrecision::FixedPoint`.
+ *
+ * Interpolation weights are quantized to 11 fractional bits; for 8-bit elements, all arithmetic happens in 32-bit
+ * integers.
+ *
+ * @tparam AccessMode The border access mode (`BorderAccessMode`) to use.
+ */
+template <BorderAccessMode AccessMode>
+struct ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode, InterpolationPrecision::FixedPoint>
+{
+  constexpr static PixelLength::value_type index_to_left = 0;
+  constexpr static PixelLength::value_type index_to_right = 1;
+  constexpr static PixelLength::value_type index_to_up = 0;
+  constexpr static PixelLength::value_type index_to_down = 1;
+
+  template <typename ImageType, typename ScalarAccess = default_float_t>
+  static typename ImageType::PixelType interpolate(const ImageType& img, ScalarAccess x, ScalarAccess y) noexcept;
+};
+
+/// \cond INTERNAL
+
+namespace detail {
+
+/// Number of fractional bits of each (horizontal or vertical) fixed-point bilinear interpolation weight.
+constexpr int bilinear_fixed_point_bits = 11;
+
+template <typename T>
+using BilinearFixedPointAccumulator = std::conditional_t<sizeof(T) == 1, std::int32_t, std::int64_t>;
+
+template <typename ScalarAccess>
+inline std::int32_t bilinear_fixed_point_weight(ScalarAccess fraction) noexcept
+{
+  constexpr auto scale = static_cast<ScalarAccess>(std::int32_t{1} << bilinear_fixed_point_bits);
+  return static_cast<std::int32_t>(fraction * scale + ScalarAccess(0.5));
+}
+
+// Blends two values with weight w (for v1) in [0, 2^bilinear_fixed_point_bits].
+template <typename Accumulator>
+inline Accumulator bilinear_fixed_point_blend(Accumulator v0, Accumulator v1, std::int32_t w) noexcept
+{
+  return v0 * ((std::int32_t{1} << bilinear_fixed_point_bits) - w) + v1 * w;
+}
+
+// Rounds and removes the scaling of two consecutive blends; the value is then within the range of T.
+template <typename T, typename Accumulator>
+inline T bilinear_fixed_point_result(Accumulator value) noexcept
+{
+  constexpr auto shift = 2 * bilinear_fixed_point_bits;
+  return static_cast<T>((value + (Accumulator{1} << (shift - 1))) >> shift);
+}
+
+template <BorderAccessMode AccessMode,
+          typename ScalarOutputElement,
+          std::size_t nr_channels,
+          typename ImageType,
+          typename ScalarAccess>
+inline Pixel<ScalarOutputElement, nr_channels> bilinear_interpolate_channels(const ImageType& img,
+                                                                              ScalarAccess x,
+                                                                              ScalarAccess y) noexcept
+{
+  const auto xf = static_cast<PixelIndex::value_type>(x);
+  const auto yf = static_cast<PixelIndex::value_type>(y);
+
+  const auto dx = ScalarOutputElement{x - xf};
+  const auto dy = ScalarOutputElement{y - yf};
+
+  const auto& a = ImageBorderAccessor<AccessMode>::access(img, PixelIndex{xf + 0}, PixelIndex{yf + 0});
+  const auto& b = ImageBorderAccessor<AccessMode>::access(img, PixelIndex{xf + 1}, PixelIndex{yf + 0});
+  const auto& c = ImageBorderAccessor<AccessMode>::access(img, PixelIndex{xf + 0}, PixelIndex{yf + 1});
+  const auto& d = ImageBorderAccessor<AccessMode>::access(img, PixelIndex{xf + 1}, PixelIndex{yf + 1});
+
+  Pixel<ScalarOutputElement, nr_channels> dst;
+  for (std::size_t i = 0; i < nr_channels; ++i)  // nr_channels is known at compile-time
+  {
+    dst[i] = ScalarOutputElement(a[i]) + ((b[i] - a[i]) * dx) + ((c[i] - a[i]) * dy)
+             + ((a[i] - b[i] - c[i] + d[i]) * dx * dy);
+  }
+  return dst;
+}
+
+}  // namespace detail
+
+/// \endcond
+
 
 // ----------
 // Implementation:
@@ -94,9 +210,9 @@ struct ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode>
  * @param y The y-coordinate.
  * @return The pixel value at (x, y), using `ImageInterpolationMode::NearestNeighbor`.
  */
-template <BorderAccessMode AccessMode>
+template <BorderAccessMode AccessMode, InterpolationPrecision Precision>
 template <typename ImageType, typename ScalarAccess>
-inline auto ImageInterpolator<ImageInterpolationMode::NearestNeighbor, AccessMode>::interpolate(
+inline auto ImageInterpolator<ImageInterpolationMode::NearestNeighbor, AccessMode, Precision>::interpolate(
     const ImageType& img, ScalarAccess x, ScalarAccess y) noexcept
 {
   static_assert(std::is_floating_point<ScalarAccess>::value, "Interpolation coordinates must be floating point.");
@@ -119,9 +235,9 @@ inline auto ImageInterpolator<ImageInterpolationMode::NearestNeighbor, AccessMod
  * @param y The y-coordinate.
  * @return The pixel value at (x, y), using `ImageInterpolationMode::NearestNeighbor`.
  */
-template <BorderAccessMode AccessMode>
+template <BorderAccessMode AccessMode, InterpolationPrecision Precision>
 template <typename PixelType, typename ScalarAccess>
-inline auto ImageInterpolator<ImageInterpolationMode::NearestNeighbor, AccessMode>::interpolate(
+inline auto ImageInterpolator<ImageInterpolationMode::NearestNeighbor, AccessMode, Precision>::interpolate(
     const RelativeAccessor<PixelType>& img, ScalarAccess x, ScalarAccess y) noexcept
 {
   static_assert(std::is_floating_point<ScalarAccess>::value, "Interpolation coordinates must be floating point.");
@@ -151,9 +267,8 @@ inline auto ImageInterpolator<ImageInterpolationMode::NearestNeighbor, AccessMod
  */
 template <BorderAccessMode AccessMode>
 template <typename ImageType, typename ScalarAccess, typename ScalarOutputElement>
-inline auto ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode>::interpolate(const ImageType& img,
-                                                                                         ScalarAccess x,
-                                                                                         ScalarAccess y) noexcept
+inline auto ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode, InterpolationPrecision::FloatingPoint>::
+    interpolate(const ImageType& img, ScalarAccess x, ScalarAccess y) noexcept
 {
   static_assert(std::is_floating_point<ScalarAccess>::value, "Interpolation coordinates must be floating point.");
   static_assert(std::is_floating_point<ScalarOutputElement>::value,
@@ -192,29 +307,91 @@ inline auto ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode>::int
  */
 template <BorderAccessMode AccessMode>
 template <typename T, std::size_t nr_channels, typename ScalarAccess, typename ScalarOutputElement>
-inline auto ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode>::interpolate(
-    const Image<Pixel<T, nr_channels>>& img, ScalarAccess x, ScalarAccess y) noexcept
+inline auto ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode, InterpolationPrecision::FloatingPoint>::
+    interpolate(const Image<Pixel<T, nr_channels>>& img, ScalarAccess x, ScalarAccess y) noexcept
 {
   static_assert(std::is_floating_point<ScalarAccess>::value, "Interpolation coordinates must be floating point.");
   static_assert(std::is_floating_point<ScalarOutputElement>::value,
                 "Output pixel channel values must be floating point.");
+  return detail::bilinear_interpolate_channels<AccessMode, ScalarOutputElement, nr_channels>(img, x, y);
+}
 
-  const auto xf = static_cast<PixelIndex::value_type>(x);
-  const auto yf = static_cast<PixelIndex::value_type>(y);
+/** \brief Accesses the pixel value of the oriented view `img` at floating point location (x, y) using the
+ * interpolation mode `ImageInterpolationMode::Bilinear` and the specified `BorderAccessMode`.
+ *
+ * This is an overload for views `OrientedView<PixelType>`, where `PixelType` is `Pixel<T, nr_channels>`.
+ * The result is identical to interpolating the materialized oriented image at (x, y).
+ *
+ * @tparam AccessMode The border access mode (`BorderAccessMode`) to use.
+ * @tparam T The pixel element type; i.e. the type of each channel element.
+ * @tparam nr_channels The number of channels for a pixel.
+ * @tparam ScalarAccess The floating point type for specifying the location (x, y).
+ * @tparam ScalarOutputElement The floating point type for each pixel element; i.e. the type for each channel element.
+ * @param img The oriented view to access.
+ * @param x The x-coordinate.
+ * @param y The y-coordinate.
+ * @return The pixel value at (x, y), using `ImageInterpolationMode::Bilinear`. Will be of type
+ * `Pixel<ScalarOutputElement, nr_channels>`.
+ */
+template <BorderAccessMode AccessMode>
+template <typename T, std::size_t nr_channels, typename ScalarAccess, typename ScalarOutputElement>
+inline auto ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode, InterpolationPrecision::FloatingPoint>::
+    interpolate(const OrientedView<Pixel<T, nr_channels>>& img, ScalarAccess x, ScalarAccess y) noexcept
+{
+  static_assert(std::is_floating_point<ScalarAccess>::value, "Interpolation coordinates must be floating point.");
+  static_assert(std::is_floating_point<ScalarOutputElement>::value,
+                "Output pixel channel values must be floating point.");
+  return detail::bilinear_interpolate_channels<AccessMode, ScalarOutputElement, nr_channels>(img, x, y);
+}
 
-  const auto dx = ScalarOutputElement{x - xf};
-  const auto dy = ScalarOutputElement{y - yf};
+/** \brief Accesses the pixel value of `img` at floating point location (x, y) using the interpolation mode
+ * `ImageInterpolationMode::Bilinear` with fixed-point arithmetic, and the specified `BorderAccessMode`.
+ *
+ * @tparam AccessMode The border access mode (`BorderAccessMode`) to use.
+ * @tparam ImageType The image type; e.g. `Image<PixelType>` or `OrientedView<PixelType>`. The pixel elements need to
+ * be of an 8- or 16-bit integral type.
+ * @tparam ScalarAccess The floating point type for specifying the location (x, y).
+ * @param img The image to access.
+ * @param x The x-coordinate.
+ * @param y The y-coordinate.
+ * @return The pixel value at (x, y), using `ImageInterpolationMode::Bilinear`, rounded to the nearest integer. Will be
+ * of type `ImageType::PixelType`.
+ */
+template <BorderAccessMode AccessMode>
+template <typename ImageType, typename ScalarAccess>
+inline typename ImageType::PixelType
+ImageInterpolator<ImageInterpolationMode::Bilinear, AccessMode, InterpolationPrecision::FixedPoint>::interpolate(
+    const ImageType& img, ScalarAccess x, ScalarAccess y) noexcept
+{
+  using PixelType = typename ImageType::PixelType;
+  using T = typename PixelTraits<PixelType>::Element;
+  constexpr auto nr_channels = PixelTraits<PixelType>::nr_channels;
+
+  static_assert(std::is_floating_point<ScalarAccess>::value, "Interpolation coordinates must be floating point.");
+  static_assert(std::is_integral<T>::value && sizeof(T) <= 2,
+                "Fixed-point interpolation requires 8- or 16-bit integral pixel elements.");
+
+  using Accumulator = detail::BilinearFixedPointAccumulator<T>;
+
+  const auto x_floor = std::floor(x);
+  const auto y_floor = std::floor(y);
+  const auto xf = static_cast<PixelIndex::value_type>(x_floor);
+  const auto yf = static_cast<PixelIndex::value_type>(y_floor);
+  const auto wx = detail::bilinear_fixed_point_weight(x - x_floor);
+  const auto wy = detail::bilinear_fixed_point_weight(y - y_floor);
 
   const auto& a = ImageBorderAccessor<AccessMode>::access(img, PixelIndex{xf + 0}, PixelIndex{yf + 0});
   const auto& b = ImageBorderAccessor<AccessMode>::access(img, PixelIndex{xf + 1}, PixelIndex{yf + 0});
   const auto& c = ImageBorderAccessor<AccessMode>::access(img, PixelIndex{xf + 0}, PixelIndex{yf + 1});
   const auto& d = ImageBorderAccessor<AccessMode>::access(img, PixelIndex{xf + 1}, PixelIndex{yf + 1});
 
-  Pixel<ScalarOutputElement, nr_channels> dst;
+  PixelType dst;
   for (std::size_t i = 0; i < nr_channels; ++i)  // nr_channels is known at compile-time
   {
-    dst[i] = ScalarOutputElement(a[i]) + ((b[i] - a[i]) * dx) + ((c[i] - a[i]) * dy)
-             + ((a[i] - b[i] - c[i] + d[i]) * dx * dy);
+    // Vertical blend first; the result is exact in either order.
+    const auto ac = detail::bilinear_fixed_point_blend(Accumulator{a[i]}, Accumulator{c[i]}, wy);
+    const auto bd = detail::bilinear_fixed_point_blend(Accumulator{b[i]}, Accumulator{d[i]}, wy);
+    dst[i] = detail::bilinear_fixed_point_result<T>(detail::bilinear_fixed_point_blend(ac, bd, wx));
   }
   return dst;
 }
@@ -0,0 +1,439 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_ORIENTED_VIEW_HPP
+#define SELENE_IMG_ORIENTED_VIEW_HPP
+
+/// @file
+
+#include <selene/base/Assert.hpp>
+
+#include <selene/img/Image.hpp>
+#include <selene/img/PixelTraits.hpp>
+#include <selene/img/Types.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace sln {
+
+/** \brief Describes one of the eight possible orientations of an image (i.e. an element of the dihedral group D4).
+ *
+ * Each value describes the transformation that is applied to an underlying image to obtain the oriented image.
+ * The numeric values (plus one) correspond to the values of the EXIF orientation tag.
+ */
+enum class ImageOrientation : std::uint8_t
+{
+  Identity = 0,  ///< No transformation.
+  FlipHorizontal = 1,  ///< Horizontal flip.
+  Clockwise180 = 2,  ///< Rotation by 180 degrees.
+  FlipVertical = 3,  ///< Vertical flip.
+  Transpose = 4,  ///< Transposition, i.e. reflection along the main diagonal.
+  Clockwise90 = 5,  ///< Rotation by 90 degrees clockwise.
+  Transverse = 6,  ///< Transverse transposition, i.e. reflection along the anti-diagonal.
+  Clockwise270 = 7,  ///< Rotation by 270 degrees clockwise.
+};
+
+ImageOrientation orientation_from_exif(std::uint16_t exif_orientation) noexcept;
+
+ImageOrientation compose_orientations(ImageOrientation first, ImageOrientation second) noexcept;
+
+bool orientation_swaps_extents(ImageOrientation orientation) noexcept;
+
+/** \brief Read-only view on an `Image<>` instance, with one of the eight possible orientations applied lazily.
+ *
+ * No pixel data is copied; each access through the view is mapped to the respective pixel of the underlying image.
+ * Cropping a view (see `crop()`) only narrows the mapped region of the underlying image, so that chains of cropping,
+ * re-orienting and resampling do not allocate any intermediate images.
+ * If needed, the oriented image can be materialized using `clone()` (in `Transformations.hpp`).
+ *
+ * An instance of `OrientedView<>` is accepted in place of an `Image<>` instance in calls to
+ * `ImageBorderAccessor<>::access`, `ImageInterpolator<>::interpolate`, the various forms of `get()` for pixel access,
+ * `resample()`, and `transform_pixels()`.
+ *
+ * The underlying image data has to outlive the view.
+ *
+ * @tparam PixelType_ The pixel type.
+ */
+template <typename PixelType_>
+class OrientedView
+{
+public:
+  using PixelType = PixelType_;  ///< The pixel type.
+  using ImageType = Image<PixelType_>;  ///< The image type of the underlying image.
+
+  /** \brief x/y coordinate.
+   *
+   * @tparam T The coordinate element type.
+   */
+  template <typename T = PixelIndex>
+  struct XY
+  {
+    T x;  ///< X-coordinate.
+    T y;  ///< Y-coordinate.
+  };
+
+  OrientedView() = default;  ///< Default constructor; constructs an empty view.
+  explicit OrientedView(const ImageType& img, ImageOrientation orientation = ImageOrientation::Identity);
+
+  OrientedView(const OrientedView<PixelType_>&) = default;  ///< Copy constructor.
+  OrientedView<PixelType_>& operator=(const OrientedView<PixelType_>&) = default;  ///< Copy assignment operator.
+
+  OrientedView(OrientedView<PixelType_>&&) noexcept = default;  ///< Move constructor.
+  OrientedView<PixelType_>& operator=(OrientedView<PixelType_>&&) noexcept = default;  ///< Move assignment operator.
+
+  const ImageType& image() const noexcept;
+  ImageOrientation orientation() const noexcept;
+
+  PixelLength width() const noexcept;
+  PixelLength height() const noexcept;
+  bool is_empty() const noexcept;
+
+  XY<PixelIndex> source_coordinates(PixelIndex x, PixelIndex y) const noexcept;
+
+  template <typename T>
+  XY<T> source_location(T x, T y) const noexcept;
+
+  const PixelType& operator()(PixelIndex x, PixelIndex y) const noexcept;
+
+  const PixelType* row_origin(PixelIndex y) const noexcept;
+  std::ptrdiff_t pixel_step_bytes() const noexcept;
+
+private:
+  ImageType img_;
+  ImageOrientation orientation_ = ImageOrientation::Identity;
+  bool transposed_ = false;
+  bool flip_x_ = false;
+  bool flip_y_ = false;
+
+  void set_orientation(ImageOrientation orientation) noexcept;
+
+  template <typename PixelType2>
+  friend void crop(OrientedView<PixelType2>&, PixelIndex, PixelIndex, PixelLength, PixelLength);
+};
+
+template <typename PixelType>
+OrientedView<PixelType> oriented_view(const Image<PixelType>& img, ImageOrientation orientation);
+
+template <typename PixelType>
+OrientedView<PixelType> oriented_view(const OrientedView<PixelType>& view, ImageOrientation orientation);
+
+template <typename PixelType>
+void crop(OrientedView<PixelType>& view, PixelIndex x0, PixelIndex y0, PixelLength width, PixelLength height);
+
+// ----------
+// Implementation:
+
+/// \cond INTERNAL
+
+namespace detail {
+
+// An orientation maps target coordinates (x, y) to source coordinates by first optionally swapping x and y, and then
+// optionally mirroring each of the resulting coordinates.
+struct OrientationComponents
+{
+  bool transposed;
+  bool flip_x;
+  bool flip_y;
+};
+
+inline OrientationComponents orientation_components(ImageOrientation orientation) noexcept
+{
+  switch (orientation)
+  {
+    case ImageOrientation::Identity: return {false, false, false};
+    case ImageOrientation::FlipHorizontal: return {false, true, false};
+    case ImageOrientation::Clockwise180: return {false, true, true};
+    case ImageOrientation::FlipVertical: return {false, false, true};
+    case ImageOrientation::Transpose: return {true, false, false};
+    case ImageOrientation::Clockwise90: return {true, false, true};
+    case ImageOrientation::Transverse: return {true, true, true};
+    case ImageOrientation::Clockwise270: return {true, true, false};
+  }
+  return {false, false, false};
+}
+
+inline ImageOrientation orientation_from_components(OrientationComponents c) noexcept
+{
+  if (!c.transposed)
+  {
+    return c.flip_x ? (c.flip_y ? ImageOrientation::Clockwise180 : ImageOrientation::FlipHorizontal)
+                    : (c.flip_y ? ImageOrientation::FlipVertical : ImageOrientation::Identity);
+  }
+
+  return c.flip_x ? (c.flip_y ? ImageOrientation::Transverse : ImageOrientation::Clockwise270)
+                  : (c.flip_y ? ImageOrientation::Clockwise90 : ImageOrientation::Transpose);
+}
+
+}  // namespace detail
+
+/// \endcond
+
+/** \brief Converts the value of an EXIF orientation tag to an `ImageOrientation`.
+ *
+ * The returned orientation is the one that needs to be applied to the stored image for correct display.
+ *
+ * @param exif_orientation The EXIF orientation value, in the range [1, 8].
+ * @return The corresponding image orientation. Invalid values are mapped to `ImageOrientation::Identity`.
+ */
+inline ImageOrientation orientation_from_exif(std::uint16_t exif_orientation) noexcept
+{
+  if (exif_orientation < 1 || exif_orientation > 8)
+  {
+    return ImageOrientation::Identity;
+  }
+
+  return static_cast<ImageOrientation>(exif_orientation - 1);
+}
+
+/** \brief Returns the orientation that is equivalent to applying `first`, and then `second`.
+ *
+ * @param first The orientation that is applied first.
+ * @param second The orientation that is applied second.
+ * @return The composed orientation.
+ */
+inline ImageOrientation compose_orientations(ImageOrientation first, ImageOrientation second) noexcept
+{
+  const auto c1 = detail::orientation_components(first);
+  const auto c2 = detail::orientation_components(second);
+  // Coordinates are mapped by `second` first (to the coordinates of the intermediate image), then by `first`.
+  // If `first` is transposed, the mirroring of the intermediate image applies to the swapped source axes.
+  const bool flip_x = c1.flip_x != (c1.transposed ? c2.flip_y : c2.flip_x);
+  const bool flip_y = c1.flip_y != (c1.transposed ? c2.flip_x : c2.flip_y);
+  return detail::orientation_from_components({c1.transposed != c2.transposed, flip_x, flip_y});
+}
+
+/** \brief Returns whether the orientation swaps the image extents, i.e. whether width and height are exchanged.
+ *
+ * @param orientation The image orientation.
+ * @return True, if width and height are exchanged; false otherwise.
+ */
+inline bool orientation_swaps_extents(ImageOrientation orientation) noexcept
+{
+  return detail::orientation_components(orientation).transposed;
+}
+
+/** \brief Constructor.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @param img The underlying image. Its pixel data has to outlive the view.
+ * @param orientation The orientation to apply.
+ */
+template <typename PixelType_>
+inline OrientedView<PixelType_>::OrientedView(const ImageType& img, ImageOrientation orientation)
+    : img_(view(img))
+{
+  set_orientation(orientation);
+}
+
+/** \brief Returns the (non-owning) underlying image; possibly a cropped region of the image passed at construction.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @return The underlying image.
+ */
+template <typename PixelType_>
+inline auto OrientedView<PixelType_>::image() const noexcept -> const ImageType&
+{
+  return img_;
+}
+
+/** \brief Returns the orientation that is applied to the underlying image.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @return The image orientation.
+ */
+template <typename PixelType_>
+inline ImageOrientation OrientedView<PixelType_>::orientation() const noexcept
+{
+  return orientation_;
+}
+
+/** \brief Returns the width of the oriented view.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @return The view width.
+ */
+template <typename PixelType_>
+inline PixelLength OrientedView<PixelType_>::width() const noexcept
+{
+  return transposed_ ? img_.height() : img_.width();
+}
+
+/** \brief Returns the height of the oriented view.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @return The view height.
+ */
+template <typename PixelType_>
+inline PixelLength OrientedView<PixelType_>::height() const noexcept
+{
+  return transposed_ ? img_.width() : img_.height();
+}
+
+/** \brief Returns whether the view is empty.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @return True, if the underlying image is empty; false otherwise.
+ */
+template <typename PixelType_>
+inline bool OrientedView<PixelType_>::is_empty() const noexcept
+{
+  return img_.is_empty();
+}
+
+/** \brief Converts integral view coordinates to coordinates of the underlying image.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @param x The x-coordinate in the view.
+ * @param y The y-coordinate in the view.
+ * @return The corresponding coordinates in the underlying image.
+ */
+template <typename PixelType_>
+inline auto OrientedView<PixelType_>::source_coordinates(PixelIndex x, PixelIndex y) const noexcept -> XY<PixelIndex>
+{
+  const auto sx = transposed_ ? y : x;
+  const auto sy = transposed_ ? x : y;
+  return {flip_x_ ? PixelIndex{img_.width() - 1 - sx} : sx, flip_y_ ? PixelIndex{img_.height() - 1 - sy} : sy};
+}
+
+/** \brief Converts floating point view coordinates to coordinates of the underlying image.
+ *
+ * Coordinates are mapped with respect to pixel centers, i.e. integral locations map to the same locations as in
+ * `source_coordinates()`.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @tparam T The (floating point) coordinate type.
+ * @param x The x-coordinate in the view.
+ * @param y The y-coordinate in the view.
+ * @return The corresponding location in the underlying image.
+ */
+template <typename PixelType_>
+template <typename T>
+inline auto OrientedView<PixelType_>::source_location(T x, T y) const noexcept -> XY<T>
+{
+  static_assert(std::is_floating_point<T>::value, "Coordinate type needs to be floating point");
+  const auto sx = transposed_ ? y : x;
+  const auto sy = transposed_ ? x : y;
+  const auto max_x = static_cast<T>(img_.width() - 1);
+  const auto max_y = static_cast<T>(img_.height() - 1);
+  return {flip_x_ ? max_x - sx : sx, flip_y_ ? max_y - sy : sy};
+}
+
+/** \brief Accesses a pixel of the oriented view.
+ *
+ * No bounds checking is performed.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @param x The x-coordinate in the view.
+ * @param y The y-coordinate in the view.
+ * @return The respective pixel of the underlying image.
+ */
+template <typename PixelType_>
+inline auto OrientedView<PixelType_>::operator()(PixelIndex x, PixelIndex y) const noexcept -> const PixelType&
+{
+  const auto src = source_coordinates(x, y);
+  return img_(src.x, src.y);
+}
+
+/** \brief Returns a pointer to the pixel at location (0, y) of the view.
+ *
+ * Subsequent pixels of the same view row are located `pixel_step_bytes()` bytes apart.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @param y The row index in the view.
+ * @return Pointer to the first pixel of view row `y`.
+ */
+template <typename PixelType_>
+inline auto OrientedView<PixelType_>::row_origin(PixelIndex y) const noexcept -> const PixelType*
+{
+  return &(*this)(0_idx, y);
+}
+
+/** \brief Returns the (possibly negative) distance in bytes between horizontally adjacent pixels of the view.
+ *
+ * @tparam PixelType_ The pixel type.
+ * @return The distance in bytes between view pixels (x + 1, y) and (x, y).
+ */
+template <typename PixelType_>
+inline std::ptrdiff_t OrientedView<PixelType_>::pixel_step_bytes() const noexcept
+{
+  if (transposed_)
+  {
+    const auto stride = static_cast<std::ptrdiff_t>(img_.stride_bytes());
+    return flip_y_ ? -stride : stride;
+  }
+
+  constexpr auto nr_bytes = static_cast<std::ptrdiff_t>(PixelTraits<PixelType_>::nr_bytes);
+  return flip_x_ ? -nr_bytes : nr_bytes;
+}
+
+template <typename PixelType_>
+inline void OrientedView<PixelType_>::set_orientation(ImageOrientation orientation) noexcept
+{
+  const auto components = detail::orientation_components(orientation);
+  orientation_ = orientation;
+  transposed_ = components.transposed;
+  flip_x_ = components.flip_x;
+  flip_y_ = components.flip_y;
+}
+
+/** \brief Returns an `OrientedView<PixelType>` on an image.
+ *
+ * @tparam PixelType The pixel type.
+ * @param img The underlying image. Its pixel data has to outlive the view.
+ * @param orientation The orientation to apply.
+ * @return An `OrientedView<PixelType>` instance.
+ */
+template <typename PixelType>
+inline OrientedView<PixelType> oriented_view(const Image<PixelType>& img, ImageOrientation orientation)
+{
+  return OrientedView<PixelType>(img, orientation);
+}
+
+/** \brief Returns an `OrientedView<PixelType>` that additionally applies the specified orientation to an existing
+ * view.
+ *
+ * @tparam PixelType The pixel type.
+ * @param view The existing view.
+ * @param orientation The orientation to apply on top of the orientation of `view`.
+ * @return An `OrientedView<PixelType>` instance on the same underlying image.
+ */
+template <typename PixelType>
+inline OrientedView<PixelType> oriented_view(const OrientedView<PixelType>& view, ImageOrientation orientation)
+{
+  return OrientedView<PixelType>(view.image(), compose_orientations(view.orientation(), orientation));
+}
+
+/** \brief Crops the oriented view to the specified region (given in view coordinates), without copying any data.
+ *
+ * The region has to be located within the view extents.
+ *
+ * @tparam PixelType The pixel type.
+ * @param[in,out] view The view to crop.
+ * @param x0 The x-coordinate of the top-left corner of the region.
+ * @param y0 The y-coordinate of the top-left corner of the region.
+ * @param width The width of the region.
+ * @param height The height of the region.
+ */
+template <typename PixelType>
+void crop(OrientedView<PixelType>& view, PixelIndex x0, PixelIndex y0, PixelLength width, PixelLength height)
+{
+  SELENE_ASSERT(x0 >= 0 && y0 >= 0 && width > 0 && height > 0);
+  SELENE_ASSERT(x0 + width <= view.width() && y0 + height <= view.height());
+
+  const auto corner_0 = view.source_coordinates(x0, y0);
+  const auto corner_1 = view.source_coordinates(PixelIndex{x0 + width - 1}, PixelIndex{y0 + height - 1});
+  const auto src_x0 = std::min(corner_0.x, corner_1.x);
+  const auto src_y0 = std::min(corner_0.y, corner_1.y);
+  const auto src_width = view.transposed_ ? height : width;
+  const auto src_height = view.transposed_ ? width : height;
+
+  view.img_ = sln::view(view.img_, src_x0, src_y0, src_width, src_height);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_ORIENTED_VIEW_HPP
@@ -0,0 +1,1276 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_PLANAR_IMAGE_HPP
+#define SELENE_IMG_PLANAR_IMAGE_HPP
+
+/// @file
+
+#include <selene/base/Assert.hpp>
+#include <selene/base/MemoryBlock.hpp>
+#include <selene/base/MemoryResource.hpp>
+
+#include <selene/img/Image.hpp>
+#include <selene/img/ImageData.hpp>
+#include <selene/img/Pixel.hpp>
+#include <selene/img/PixelFormat.hpp>
+#include <selene/img/PixelTraits.hpp>
+#include <selene/img/Types.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace sln {
+
+template <typename T, std::size_t N>
+class PlanarImage;
+
+template <typename T, std::size_t N>
+ImageData<ImageDataStorage::Modifiable> to_image_data(PlanarImage<T, N>&&, PixelFormat);
+
+/** \brief Statically typed planar image class.
+ *
+ * An instance of `PlanarImage<T, N>` represents a statically typed image with `N` channels of element type `T`, in
+ * planar storage: each channel is stored in a separate plane, which is laid out like an `Image<Pixel<T, 1>>`. All planes
+ * share the same width, height, and row stride.
+ *
+ * The allocation and view semantics follow those of `Image<>`. Owned memory is allocated as one block from a
+ * `MemoryResource`, with the planes stored consecutively (i.e. in CHW order); a view may refer to arbitrary plane
+ * locations. `plane()` returns a view onto a single plane, to which all `Image<>`-based algorithms can be applied.
+ *
+ * Use `deinterleave()` and `interleave()` (see `img_ops/PlanarConversions.hpp`) to convert from and to interleaved
+ * images.
+ */
+template <typename T, std::size_t N>
+class PlanarImage
+{
+public:
+  using ElementType = T;  ///< The element type of each plane.
+  using PlaneType = Image<Pixel<T, 1>>;  ///< The image type of each plane.
+  using PixelType = Pixel<T, N>;  ///< The corresponding interleaved pixel type.
+
+  static constexpr std::size_t nr_channels = N;  ///< The number of channels, i.e. planes.
+
+  PlanarImage();
+  explicit PlanarImage(MemoryResource& resource);
+  PlanarImage(PixelLength width,
+              PixelLength height,
+              Stride stride_bytes = Stride{0},
+              MemoryResource& resource = default_memory_resource());
+  PlanarImage(PixelLength width,
+              PixelLength height,
+              ImageLayout layout,
+              MemoryResource& resource = default_memory_resource());
+  PlanarImage(const std::array<std::uint8_t*, N>& planes,
+              PixelLength width,
+              PixelLength height,
+              Stride stride_bytes = Stride{0}) noexcept;
+  PlanarImage(MemoryBlock<MemoryResource>&& data,
+              PixelLength width,
+              PixelLength height,
+              Stride stride_bytes = Stride{0}) noexcept;
+
+  PlanarImage(const PlanarImage<T, N>& other);
+  PlanarImage<T, N>& operator=(const PlanarImage<T, N>& other);
+
+  PlanarImage(PlanarImage<T, N>&& other) noexcept;
+  PlanarImage<T, N>& operator=(PlanarImage<T, N>&& other) noexcept;
+
+  ~PlanarImage();
+
+  PixelLength width() const noexcept;
+  PixelLength height() const noexcept;
+  Stride stride_bytes() const noexcept;
+  std::size_t row_bytes() const noexcept;
+  std::size_t plane_bytes() const noexcept;
+  std::size_t total_bytes() const noexcept;
+  bool is_packed() const noexcept;
+  bool is_view() const noexcept;
+  bool is_empty() const noexcept;
+  bool is_valid() const noexcept;
+  bool simd_safe_tail() const noexcept;
+  MemoryResource& memory_resource() const noexcept;
+
+  void clear() noexcept;
+  void fill(const PixelType& value) noexcept;
+  void allocate(PixelLength width,
+                PixelLength height,
+                Stride stride_bytes = Stride{0},
+                bool shrink_to_fit = true,
+                bool force_allocation = false,
+                bool allow_view_reallocation = true);
+  void allocate(PixelLength width,
+                PixelLength height,
+                ImageLayout layout,
+                bool shrink_to_fit = true,
+                bool force_allocation = false,
+                bool allow_view_reallocation = true);
+  void maybe_allocate(PixelLength width, PixelLength height, Stride stride_bytes = Stride{0});
+  void set_view(const std::array<std::uint8_t*, N>& planes,
+                PixelLength width,
+                PixelLength height,
+                Stride stride_bytes = Stride{0});
+
+  PlaneType plane(std::size_t channel) noexcept;
+  const PlaneType plane(std::size_t channel) const noexcept;
+
+  std::uint8_t* byte_ptr(std::size_t channel) noexcept;
+  const std::uint8_t* byte_ptr(std::size_t channel) const noexcept;
+
+  std::uint8_t* byte_ptr(std::size_t channel, PixelIndex y) noexcept;
+  const std::uint8_t* byte_ptr(std::size_t channel, PixelIndex y) const noexcept;
+
+  T* data(std::size_t channel, PixelIndex y) noexcept;
+  const T* data(std::size_t channel, PixelIndex y) const noexcept;
+
+  T* data_row_end(std::size_t channel, PixelIndex y) noexcept;
+  const T* data_row_end(std::size_t channel, PixelIndex y) const noexcept;
+
+  T& operator()(PixelIndex x, PixelIndex y, std::size_t channel) noexcept;
+  const T& operator()(PixelIndex x, PixelIndex y, std::size_t channel) const noexcept;
+
+  PixelType pixel(PixelIndex x, PixelIndex y) const noexcept;
+
+private:
+  std::array<std::uint8_t*, N> planes_{};
+  Stride stride_bytes_;
+  PixelLength width_;
+  PixelLength height_;
+  bool owns_memory_ = true;
+  MemoryResource* resource_ = &default_memory_resource();
+
+  constexpr static std::size_t default_base_alignment_ = 16;
+
+  void allocate(PixelLength width,
+                PixelLength height,
+                Stride stride_bytes,
+                std::size_t base_alignment_bytes,
+                bool shrink_to_fit,
+                bool force_allocation,
+                bool allow_view_reallocation);
+  void allocate_bytes(std::size_t base_alignment_bytes);
+  void set_planes(std::uint8_t* data) noexcept;
+  void deallocate_bytes_if_owned() noexcept;
+  void reset() noexcept;
+  void copy_planes_from(const PlanarImage<T, N>& src) noexcept;
+
+  MemoryBlock<MemoryResource> relinquish_data_ownership();
+
+  friend ImageData<ImageDataStorage::Modifiable> to_image_data<T, N>(PlanarImage<T, N>&&, PixelFormat);
+};
+
+template <typename T, std::size_t N>
+bool operator==(const PlanarImage<T, N>& img0, const PlanarImage<T, N>& img1);
+
+template <typename T, std::size_t N>
+bool operator!=(const PlanarImage<T, N>& img0, const PlanarImage<T, N>& img1);
+
+template <typename T, std::size_t N>
+PlanarImage<T, N> view(const PlanarImage<T, N>& src);
+
+template <typename T, std::size_t N>
+ImageData<ImageDataStorage::Modifiable> to_image_data(PlanarImage<T, N>&& img, PixelFormat pixel_format);
+
+template <typename T, std::size_t N>
+PlanarImage<T, N> to_planar_image(ImageData<>&& img_data);
+
+template <typename T, std::size_t N>
+PlanarImage<T, N> to_planar_image_view(ImageData<>& img_data);
+
+using PlanarImage_8u3 = PlanarImage<std::uint8_t, 3>;  ///< 8-bit unsigned 3-channel planar image.
+using PlanarImage_8u4 = PlanarImage<std::uint8_t, 4>;  ///< 8-bit unsigned 4-channel planar image.
+using PlanarImage_16u3 = PlanarImage<std::uint16_t, 3>;  ///< 16-bit unsigned 3-channel planar image.
+using PlanarImage_16u4 = PlanarImage<std::uint16_t, 4>;  ///< 16-bit unsigned 4-channel planar image.
+using PlanarImage_32f3 = PlanarImage<float, 3>;  ///< 32-bit floating point 3-channel planar image.
+using PlanarImage_32f4 = PlanarImage<float, 4>;  ///< 32-bit floating point 4-channel planar image.
+
+// ----------
+// Implementation:
+
+template <typename T, std::size_t N>
+constexpr std::size_t PlanarImage<T, N>::nr_channels;
+
+template <typename T, std::size_t N>
+constexpr std::size_t PlanarImage<T, N>::default_base_alignment_;
+
+/** \brief Default constructor.
+ *
+ * Creates an empty image of width and height 0. The image data will be owned, i.e. `is_view() == false`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>::PlanarImage() : stride_bytes_(0), width_(0), height_(0)
+{
+}
+
+/** \brief Constructs an empty image, which will allocate its data from the specified memory resource.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param resource The memory resource to allocate from. Needs to outlive the image data.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>::PlanarImage(MemoryResource& resource)
+    : stride_bytes_(0), width_(0), height_(0), resource_(&resource)
+{
+}
+
+/** \brief Constructs a planar image of the specified width, height, and (per-plane) row stride in bytes.
+ *
+ * Image content will be undefined.
+ * The image data will be owned, i.e. `is_view() == false`.
+ *
+ * The row stride (in bytes) is chosen to be at least `width * sizeof(T)`, or the supplied value.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param width Desired image width.
+ * @param height Desired image height.
+ * @param stride_bytes The stride (row length) in bytes, for each plane.
+ * @param resource The memory resource to allocate from. Needs to outlive the image data.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>::PlanarImage(PixelLength width, PixelLength height, Stride stride_bytes, MemoryResource& resource)
+    : stride_bytes_(std::max(stride_bytes, Stride(sizeof(T) * width)))
+    , width_(width)
+    , height_(height)
+    , resource_(&resource)
+{
+  allocate_bytes(PlanarImage<T, N>::default_base_alignment_);
+}
+
+/** \brief Constructs a planar image of the specified width, height, and with the specified memory layout.
+ *
+ * Image content will be undefined.
+ * The image data will be owned, i.e. `is_view() == false`.
+ *
+ * With `ImageLayout::SimdPadded`, each plane and each of its rows is aligned to `simd_vector_bytes`, and each row is
+ * followed by at least `simd_vector_bytes` of padding; see `simd_safe_tail()`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param width Desired image width.
+ * @param height Desired image height.
+ * @param layout The memory layout.
+ * @param resource The memory resource to allocate from. Needs to outlive the image data.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>::PlanarImage(PixelLength width, PixelLength height, ImageLayout layout, MemoryResource& resource)
+    : PlanarImage(resource)
+{
+  allocate(width, height, layout);
+}
+
+/** \brief Constructs a planar image view (non-owned data) from supplied plane memory.
+ *
+ * The row stride (in bytes) is chosen to be at least `width * sizeof(T)`, or the supplied value.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param planes Pointers to the existing data of each plane.
+ * @param width Image width.
+ * @param height Image height.
+ * @param stride_bytes The stride (row length) in bytes, for each plane.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>::PlanarImage(const std::array<std::uint8_t*, N>& planes,
+                               PixelLength width,
+                               PixelLength height,
+                               Stride stride_bytes) noexcept
+    : planes_(planes)
+    , stride_bytes_(std::max(stride_bytes, Stride(sizeof(T) * width)))
+    , width_(width)
+    , height_(height)
+    , owns_memory_(false)
+{
+  SELENE_ASSERT(width_ > 0 && height_ > 0 && stride_bytes_ > 0);
+}
+
+/** \brief Constructs a planar image (owned data) from memory allocated from a memory resource.
+ *
+ * The planes are expected to be stored consecutively, i.e. plane `c` starts at byte offset
+ * `c * stride_bytes * height`. The image will subsequently allocate from the resource of the memory block.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param data A `MemoryBlock<MemoryResource>` with the existing data.
+ * @param width Image width.
+ * @param height Image height.
+ * @param stride_bytes The stride (row length) in bytes, for each plane.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>::PlanarImage(MemoryBlock<MemoryResource>&& data,
+                               PixelLength width,
+                               PixelLength height,
+                               Stride stride_bytes) noexcept
+    : stride_bytes_(std::max(stride_bytes, Stride(sizeof(T) * width)))
+    , width_(width)
+    , height_(height)
+    , resource_(&data.resource())
+{
+  SELENE_ASSERT(data.size() >= total_bytes());
+  set_planes(data.transfer_data());
+  SELENE_ASSERT(width_ > 0 && height_ > 0 && stride_bytes_ > 0);
+}
+
+/** \brief Copy constructor.
+ *
+ * The ownership semantics will stay the same; i.e. if the supplied image has owned data, then so will the constructed
+ * image (the data will be copied), but if the supplied image points to non-owned data, then the constructed image will
+ * be a view.
+ *
+ * The constructed image allocates from `default_memory_resource()`, irrespective of the memory resource of the supplied
+ * image.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param other The source image.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>::PlanarImage(const PlanarImage<T, N>& other)
+    : planes_(other.planes_)
+    , stride_bytes_(other.stride_bytes_)
+    , width_(other.width_)
+    , height_(other.height_)
+    , owns_memory_(other.owns_memory_)
+{
+  if (!other.owns_memory_ || other.is_empty())
+  {
+    return;
+  }
+
+  allocate_bytes(detail::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.planes_[0]),
+                                             other.stride_bytes_));
+  copy_planes_from(other);
+}
+
+/** \brief Copy assignment operator.
+ *
+ * The ownership semantics will stay the same; see the copy constructor. The memory resource of this image is retained.
+ * If this image already owns a suitably aligned allocation of the same size, it is reused.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param other The image to assign from.
+ * @return A reference to this image.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>& PlanarImage<T, N>::operator=(const PlanarImage<T, N>& other)
+{
+  if (this == &other)
+  {
+    return *this;
+  }
+
+  if (other.owns_memory_ && !other.is_empty())
+  {
+    // Reuses the existing allocation, if it is owned, of equal size, and suitably aligned
+    constexpr auto shrink_to_fit = true;
+    constexpr auto force_allocation = false;
+    constexpr auto allow_view_reallocation = true;
+    allocate(other.width_, other.height_, other.stride_bytes_,
+             detail::guess_row_alignment(reinterpret_cast<std::uintptr_t>(other.planes_[0]), other.stride_bytes_),
+             shrink_to_fit, force_allocation, allow_view_reallocation);
+    copy_planes_from(other);
+    return *this;
+  }
+
+  deallocate_bytes_if_owned();
+
+  planes_ = other.planes_;
+  stride_bytes_ = other.stride_bytes_;
+  width_ = other.width_;
+  height_ = other.height_;
+  owns_memory_ = other.owns_memory_;
+  return *this;
+}
+
+/** \brief Move constructor.
+ *
+ * The memory resource is taken over from the supplied image.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param other The image to move from.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>::PlanarImage(PlanarImage<T, N>&& other) noexcept
+    : planes_(other.planes_)
+    , stride_bytes_(other.stride_bytes_)
+    , width_(other.width_)
+    , height_(other.height_)
+    , owns_memory_(other.owns_memory_)
+    , resource_(other.resource_)
+{
+  other.reset();
+}
+
+/** \brief Move assignment operator.
+ *
+ * The memory resource is taken over from the supplied image.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param other The image to move assign from.
+ * @return A reference to this image.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>& PlanarImage<T, N>::operator=(PlanarImage<T, N>&& other) noexcept
+{
+  if (this == &other)
+  {
+    return *this;
+  }
+
+  deallocate_bytes_if_owned();
+
+  planes_ = other.planes_;
+  stride_bytes_ = other.stride_bytes_;
+  width_ = other.width_;
+  height_ = other.height_;
+  owns_memory_ = other.owns_memory_;
+  resource_ = other.resource_;
+
+  other.reset();
+  return *this;
+}
+
+/** \brief Destructor.
+ *
+ * Owned data will be deallocated at destruction time.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N>::~PlanarImage()
+{
+  deallocate_bytes_if_owned();
+}
+
+/** \brief Returns the image width.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return Width of the image in pixels.
+ */
+template <typename T, std::size_t N>
+inline PixelLength PlanarImage<T, N>::width() const noexcept
+{
+  return width_;
+}
+
+/** \brief Returns the image height.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return Height of the image in pixels.
+ */
+template <typename T, std::size_t N>
+inline PixelLength PlanarImage<T, N>::height() const noexcept
+{
+  return height_;
+}
+
+/** \brief Returns the row stride of each plane in bytes.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return Row stride in bytes.
+ */
+template <typename T, std::size_t N>
+inline Stride PlanarImage<T, N>::stride_bytes() const noexcept
+{
+  return stride_bytes_;
+}
+
+/** \brief Returns the number of data bytes occupied by each row of a plane.
+ *
+ * The value returned is equal to `(width() * sizeof(T))`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return Number of data bytes occupied by each plane row.
+ */
+template <typename T, std::size_t N>
+inline std::size_t PlanarImage<T, N>::row_bytes() const noexcept
+{
+  return sizeof(T) * width_;
+}
+
+/** \brief Returns the number of bytes occupied by each plane in memory.
+ *
+ * The value returned is equal to `(stride_bytes() * height())`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return Number of bytes occupied by each plane.
+ */
+template <typename T, std::size_t N>
+inline std::size_t PlanarImage<T, N>::plane_bytes() const noexcept
+{
+  return stride_bytes_ * height_;
+}
+
+/** \brief Returns the total number of bytes occupied by the image data in memory.
+ *
+ * The value returned is equal to `(N * plane_bytes())`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return Number of bytes occupied by the image data.
+ */
+template <typename T, std::size_t N>
+inline std::size_t PlanarImage<T, N>::total_bytes() const noexcept
+{
+  return N * plane_bytes();
+}
+
+/** \brief Returns whether the plane rows are stored packed in memory.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return True, if `stride_bytes() == row_bytes()`; false otherwise.
+ */
+template <typename T, std::size_t N>
+inline bool PlanarImage<T, N>::is_packed() const noexcept
+{
+  return stride_bytes_ == row_bytes();
+}
+
+/** \brief Returns whether the image is a view onto (non-owned) memory.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return True, if the image data points to non-owned memory; false otherwise.
+ */
+template <typename T, std::size_t N>
+inline bool PlanarImage<T, N>::is_view() const noexcept
+{
+  return !owns_memory_;
+}
+
+/** \brief Returns whether the image is empty.
+ *
+ * An image is considered empty if its plane data pointers point to `nullptr`, `width() == 0`, `height() == 0`, or any
+ * combination of these.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return True, if the image is empty; false if it is non-empty.
+ */
+template <typename T, std::size_t N>
+inline bool PlanarImage<T, N>::is_empty() const noexcept
+{
+  return planes_[0] == nullptr || width_ == 0 || height_ == 0;
+}
+
+/** \brief Returns whether the instance represents a valid image.
+ *
+ * Semantically equal to `!is_empty()`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return True, if the image is valid; false otherwise.
+ */
+template <typename T, std::size_t N>
+inline bool PlanarImage<T, N>::is_valid() const noexcept
+{
+  return !is_empty();
+}
+
+/** \brief Returns whether the rows of all planes can be safely accessed in full SIMD vectors, including beyond their
+ * end.
+ *
+ * See `Image<>::simd_safe_tail()`; the requirements apply to each plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return True, if the plane rows can be accessed beyond their end; false otherwise.
+ */
+template <typename T, std::size_t N>
+inline bool PlanarImage<T, N>::simd_safe_tail() const noexcept
+{
+  const auto aligned = [](const std::uint8_t* ptr) {
+    return reinterpret_cast<std::uintptr_t>(ptr) % simd_vector_bytes == 0;
+  };
+
+  return owns_memory_ && is_valid() && std::all_of(planes_.cbegin(), planes_.cend(), aligned)
+         && stride_bytes_ % simd_vector_bytes == 0 && stride_bytes_ >= row_bytes() + simd_vector_bytes;
+}
+
+/** \brief Returns the memory resource that owned image data is allocated from.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @return The memory resource.
+ */
+template <typename T, std::size_t N>
+inline MemoryResource& PlanarImage<T, N>::memory_resource() const noexcept
+{
+  return *resource_;
+}
+
+/** \brief Resets the image instance by clearing the image data and resetting the internal state to the state after
+ * default construction.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ */
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::clear() noexcept
+{
+  deallocate_bytes_if_owned();
+  reset();
+}
+
+/** \brief Fills each plane with the respective channel value of the specified pixel.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param value The value that each image pixel should assume.
+ */
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::fill(const PixelType& value) noexcept
+{
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    for (auto y = 0_idx; y < height_; ++y)
+    {
+      std::fill(data(c, y), data_row_end(c, y), value[c]);
+    }
+  }
+}
+
+/** \brief Resizes the allocated image data to exactly fit an image of size (width x height), with user-defined
+ * per-plane row stride.
+ *
+ * The semantics of the parameters are equal to those of `Image<>::allocate()`. All planes are allocated as one block.
+ *
+ * Postconditions: `!is_view() && (stride_bytes() >= width() * sizeof(T))`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param width The new image width.
+ * @param height The new image height.
+ * @param stride_bytes The desired row stride in bytes, for each plane.
+ * @param shrink_to_fit If true, reallocate if it results in less memory usage; otherwise allow excess memory to stay
+ * allocated
+ * @param force_allocation If true, always force a reallocation. Overrides `allow_view_reallocation == false`.
+ * @param allow_view_reallocation If true, allow allocation from `is_view() == true`. If false, and the existing image
+ * is a view, a `std::runtime_error` exception will be thrown (respecting the strong exception guarantee).
+ */
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::allocate(PixelLength width,
+                                 PixelLength height,
+                                 Stride stride_bytes,
+                                 bool shrink_to_fit,
+                                 bool force_allocation,
+                                 bool allow_view_reallocation)
+{
+  constexpr auto base_alignment_bytes = PlanarImage<T, N>::default_base_alignment_;
+  allocate(width, height, stride_bytes, base_alignment_bytes, shrink_to_fit, force_allocation, allow_view_reallocation);
+}
+
+/** \brief Resizes the allocated image data to exactly fit an image of size (width x height), with the specified
+ * memory layout of each plane.
+ *
+ * Postconditions: `!is_view() && (stride_bytes() >= width() * sizeof(T))`; with `ImageLayout::SimdPadded`, also
+ * `simd_safe_tail()`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param width The new image width.
+ * @param height The new image height.
+ * @param layout The desired memory layout.
+ * @param shrink_to_fit If true, reallocate if it results in less memory usage; otherwise allow excess memory to stay
+ * allocated
+ * @param force_allocation If true, always force a reallocation. Overrides `allow_view_reallocation == false`.
+ * @param allow_view_reallocation If true, allow allocation from `is_view() == true`. If false, and the existing image
+ * is a view, a `std::runtime_error` exception will be thrown (respecting the strong exception guarantee).
+ */
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::allocate(PixelLength width,
+                                 PixelLength height,
+                                 ImageLayout layout,
+                                 bool shrink_to_fit,
+                                 bool force_allocation,
+                                 bool allow_view_reallocation)
+{
+  const auto row_bytes = sizeof(T) * width;
+  const auto simd_padded = (layout == ImageLayout::SimdPadded);
+  const auto stride_bytes = simd_padded ? detail::compute_simd_stride_bytes(row_bytes) : Stride{row_bytes};
+  const auto base_alignment_bytes = simd_padded ? simd_vector_bytes : PlanarImage<T, N>::default_base_alignment_;
+  allocate(width, height, stride_bytes, base_alignment_bytes, shrink_to_fit, force_allocation, allow_view_reallocation);
+}
+
+/** \brief Resizes the allocated image data to exactly fit an image of size (width x height), if (and only if) the
+ * existing width and height differ.
+ *
+ * If the existing image is a view, and would need to be changed in size, a `std::runtime_error` exception will be
+ * thrown.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param width The desired image width.
+ * @param height The desired image height.
+ * @param stride_bytes The desired row stride in bytes, if (and only if) an allocation takes place.
+ */
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::maybe_allocate(PixelLength width, PixelLength height, Stride stride_bytes)
+{
+  if (width_ == width && height_ == height)
+  {
+    return;
+  }
+
+  constexpr auto base_alignment_bytes = PlanarImage<T, N>::default_base_alignment_;
+  constexpr auto shrink_to_fit = true;
+  constexpr auto force_allocation = false;
+  constexpr auto allow_view_reallocation = false;
+  allocate(width, height, stride_bytes, base_alignment_bytes, shrink_to_fit, force_allocation, allow_view_reallocation);
+}
+
+/** \brief Sets the image data to be a view onto non-owned external plane memory.
+ *
+ * Postcondition: `is_view()`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param planes Pointers to the external data of each plane.
+ * @param width The image width.
+ * @param height The image height.
+ * @param stride_bytes The row stride in bytes, for each plane.
+ */
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::set_view(const std::array<std::uint8_t*, N>& planes,
+                                 PixelLength width,
+                                 PixelLength height,
+                                 Stride stride_bytes)
+{
+  stride_bytes = std::max(stride_bytes, Stride(sizeof(T) * width));
+
+  deallocate_bytes_if_owned();
+
+  planes_ = planes;
+  stride_bytes_ = stride_bytes;
+  width_ = width;
+  height_ = height;
+  owns_memory_ = false;
+}
+
+/** \brief Returns a view onto the specified plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param channel The channel index.
+ * @return A single-channel image view (`is_view() == true`) of the plane.
+ */
+template <typename T, std::size_t N>
+inline auto PlanarImage<T, N>::plane(std::size_t channel) noexcept -> PlaneType
+{
+  return PlaneType(byte_ptr(channel), width_, height_, stride_bytes_);
+}
+
+/** \brief Returns a constant view onto the specified plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param channel The channel index.
+ * @return A single-channel image view (`is_view() == true`) of the plane.
+ */
+template <typename T, std::size_t N>
+inline auto PlanarImage<T, N>::plane(std::size_t channel) const noexcept -> const PlaneType
+{
+  return PlaneType(const_cast<std::uint8_t*>(byte_ptr(channel)), width_, height_, stride_bytes_);
+}
+
+/** \brief Returns a pointer to the first byte of the specified plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param channel The channel index.
+ * @return Pointer to the first data byte of the plane.
+ */
+template <typename T, std::size_t N>
+inline std::uint8_t* PlanarImage<T, N>::byte_ptr(std::size_t channel) noexcept
+{
+  SELENE_ASSERT(channel < N);
+  return planes_[channel];
+}
+
+/** \brief Returns a constant pointer to the first byte of the specified plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param channel The channel index.
+ * @return Constant pointer to the first data byte of the plane.
+ */
+template <typename T, std::size_t N>
+inline const std::uint8_t* PlanarImage<T, N>::byte_ptr(std::size_t channel) const noexcept
+{
+  SELENE_ASSERT(channel < N);
+  return planes_[channel];
+}
+
+/** \brief Returns a pointer to the first byte of row `y` of the specified plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param channel The channel index.
+ * @param y Row index.
+ * @return Pointer to the first data byte of row `y` of the plane.
+ */
+template <typename T, std::size_t N>
+inline std::uint8_t* PlanarImage<T, N>::byte_ptr(std::size_t channel, PixelIndex y) noexcept
+{
+  return byte_ptr(channel) + stride_bytes_ * static_cast<std::ptrdiff_t>(y);
+}
+
+/** \brief Returns a constant pointer to the first byte of row `y` of the specified plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param channel The channel index.
+ * @param y Row index.
+ * @return Constant pointer to the first data byte of row `y` of the plane.
+ */
+template <typename T, std::size_t N>
+inline const std::uint8_t* PlanarImage<T, N>::byte_ptr(std::size_t channel, PixelIndex y) const noexcept
+{
+  return byte_ptr(channel) + stride_bytes_ * static_cast<std::ptrdiff_t>(y);
+}
+
+/** \brief Returns a pointer to the first element of row `y` of the specified plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param channel The channel index.
+ * @param y Row index.
+ * @return Pointer to the first element of row `y` of the plane.
+ */
+template <typename T, std::size_t N>
+inline T* PlanarImage<T, N>::data(std::size_t channel, PixelIndex y) noexcept
+{
+  return reinterpret_cast<T*>(byte_ptr(channel, y));
+}
+
+/** \brief Returns a constant pointer to the first element of row `y` of the specified plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param channel The channel index.
+ * @param y Row index.
+ * @return Constant pointer to the first element of row `y` of the plane.
+ */
+template <typename T, std::size_t N>
+inline const T* PlanarImage<T, N>::data(std::size_t channel, PixelIndex y) const noexcept
+{
+  return reinterpret_cast<const T*>(byte_ptr(channel, y));
+}
+
+/** \brief Returns a pointer to the one-past-the-last element of row `y` of the specified plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param channel The channel index.
+ * @param y Row index.
+ * @return Pointer to the one-past-the-last element of row `y` of the plane.
+ */
+template <typename T, std::size_t N>
+inline T* PlanarImage<T, N>::data_row_end(std::size_t channel, PixelIndex y) noexcept
+{
+  return data(channel, y) + static_cast<std::ptrdiff_t>(width_);
+}
+
+/** \brief Returns a constant pointer to the one-past-the-last element of row `y` of the specified plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param channel The channel index.
+ * @param y Row index.
+ * @return Constant pointer to the one-past-the-last element of row `y` of the plane.
+ */
+template <typename T, std::size_t N>
+inline const T* PlanarImage<T, N>::data_row_end(std::size_t channel, PixelIndex y) const noexcept
+{
+  return data(channel, y) + static_cast<std::ptrdiff_t>(width_);
+}
+
+/** \brief Returns a reference to the element of the specified channel at location `(x, y)`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param x Column index.
+ * @param y Row index.
+ * @param channel The channel index.
+ * @return Reference to the element.
+ */
+template <typename T, std::size_t N>
+inline T& PlanarImage<T, N>::operator()(PixelIndex x, PixelIndex y, std::size_t channel) noexcept
+{
+  return data(channel, y)[static_cast<std::ptrdiff_t>(x)];
+}
+
+/** \brief Returns a constant reference to the element of the specified channel at location `(x, y)`.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param x Column index.
+ * @param y Row index.
+ * @param channel The channel index.
+ * @return Constant reference to the element.
+ */
+template <typename T, std::size_t N>
+inline const T& PlanarImage<T, N>::operator()(PixelIndex x, PixelIndex y, std::size_t channel) const noexcept
+{
+  return data(channel, y)[static_cast<std::ptrdiff_t>(x)];
+}
+
+/** \brief Returns the (interleaved) pixel value at location `(x, y)`, gathered from all planes.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param x Column index.
+ * @param y Row index.
+ * @return The pixel value.
+ */
+template <typename T, std::size_t N>
+inline auto PlanarImage<T, N>::pixel(PixelIndex x, PixelIndex y) const noexcept -> PixelType
+{
+  PixelType px;
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    px[c] = (*this)(x, y, c);
+  }
+
+  return px;
+}
+
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::allocate(PixelLength width,
+                                 PixelLength height,
+                                 Stride stride_bytes,
+                                 std::size_t base_alignment_bytes,
+                                 bool shrink_to_fit,
+                                 bool force_allocation,
+                                 bool allow_view_reallocation)
+{
+  stride_bytes = std::max(stride_bytes, Stride(sizeof(T) * width));
+  const auto nr_bytes_to_allocate = N * stride_bytes * height;
+  const auto nr_currently_allocated_bytes = total_bytes();
+
+  // No need to act, if size parameters match, and the existing memory is suitably aligned
+  const auto bytes_match = shrink_to_fit ? (nr_bytes_to_allocate == nr_currently_allocated_bytes)
+                                         : (nr_bytes_to_allocate <= nr_currently_allocated_bytes);
+  const auto alignment_match =
+      (base_alignment_bytes == 0 || reinterpret_cast<std::uintptr_t>(planes_[0]) % base_alignment_bytes == 0);
+
+  if (!force_allocation && bytes_match && alignment_match && owns_memory_)
+  {
+    const auto data = planes_[0];
+    width_ = width;
+    height_ = height;
+    stride_bytes_ = stride_bytes;
+    set_planes(data);
+    return;
+  }
+
+  if (!owns_memory_ && !allow_view_reallocation && !force_allocation)
+  {
+    throw std::runtime_error("Cannot allocate from image that is a view to external memory.");
+  }
+
+  deallocate_bytes_if_owned();
+
+  width_ = width;
+  height_ = height;
+  stride_bytes_ = stride_bytes;
+  owns_memory_ = true;
+  allocate_bytes(base_alignment_bytes);
+}
+
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::allocate_bytes(std::size_t base_alignment_bytes)
+{
+  SELENE_ASSERT(owns_memory_);
+
+  auto memory = resource_->allocate(total_bytes(), base_alignment_bytes);
+  SELENE_ASSERT(memory.size() == total_bytes());
+  set_planes(memory.transfer_data());
+}
+
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::set_planes(std::uint8_t* data) noexcept
+{
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    planes_[c] = (data != nullptr) ? data + c * plane_bytes() : nullptr;
+  }
+}
+
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::deallocate_bytes_if_owned() noexcept
+{
+  if (owns_memory_ && planes_[0] != nullptr)
+  {
+    resource_->deallocate(planes_[0]);
+    planes_.fill(nullptr);
+  }
+}
+
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::reset() noexcept
+{
+  planes_.fill(nullptr);
+  stride_bytes_ = Stride{0};
+  width_ = PixelLength{0};
+  height_ = PixelLength{0};
+  owns_memory_ = true;
+  // Keep the memory resource
+}
+
+template <typename T, std::size_t N>
+void PlanarImage<T, N>::copy_planes_from(const PlanarImage<T, N>& src) noexcept
+{
+  SELENE_ASSERT(width_ == src.width_ && height_ == src.height_);
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    for (auto y = 0_idx; y < height_; ++y)
+    {
+      std::memcpy(byte_ptr(c, y), src.byte_ptr(c, y), row_bytes());
+    }
+  }
+}
+
+template <typename T, std::size_t N>
+MemoryBlock<MemoryResource> PlanarImage<T, N>::relinquish_data_ownership()
+{
+  SELENE_FORCED_ASSERT(owns_memory_);
+  const auto ptr = planes_[0];
+  const auto len = total_bytes();
+
+  owns_memory_ = false;
+  clear();
+  return construct_memory_block_from_existing_memory(ptr, len, *resource_);
+}
+
+// ----------
+
+/** \brief Equality comparison for two planar images.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img0 The left-hand side image to compare.
+ * @param img1 The right-hand side image to compare.
+ * @return True, if the two images have equal extents and equal values in all planes; false otherwise.
+ */
+template <typename T, std::size_t N>
+bool operator==(const PlanarImage<T, N>& img0, const PlanarImage<T, N>& img1)
+{
+  // Special case: if both images have a zero-length side, they shall be considered equal (both are invalid)
+  if ((img0.width() == 0 || img0.height() == 0) && (img1.width() == 0 || img1.height() == 0))
+  {
+    return true;
+  }
+
+  if (img0.width() != img1.width() || img0.height() != img1.height())
+  {
+    return false;
+  }
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    if (img0.plane(c) != img1.plane(c))
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/** \brief Inequality comparison for two planar images.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img0 The left-hand side image to compare.
+ * @param img1 The right-hand side image to compare.
+ * @return True, if the two images are not equal; false otherwise.
+ */
+template <typename T, std::size_t N>
+bool operator!=(const PlanarImage<T, N>& img0, const PlanarImage<T, N>& img1)
+{
+  return !(img0 == img1);
+}
+
+/** \brief Returns a planar image representing a view onto the provided source image.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param src Source image.
+ * @return A planar image view (`is_view() == true`), or an empty image if the source image is empty.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N> view(const PlanarImage<T, N>& src)
+{
+  if (src.is_empty())
+  {
+    return PlanarImage<T, N>();
+  }
+
+  std::array<std::uint8_t*, N> planes;
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    planes[c] = const_cast<std::uint8_t*>(src.byte_ptr(c));
+  }
+
+  return PlanarImage<T, N>(planes, src.width(), src.height(), src.stride_bytes());
+}
+
+/** \brief Converts a `PlanarImage<T, N>` instance to a (planar) `ImageData` instance.
+ *
+ * Precondition: The supplied image must be valid; otherwise this function will throw a `std::runtime_error` exception.
+ *
+ * If the image owns its data, ownership is transferred; image data will not be copied. If it is a view, its planes
+ * need to be stored consecutively (as for owned planar images), since `ImageData` describes planes by a single data
+ * pointer; otherwise this function will throw a `std::runtime_error` exception.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img The planar image. Moved from.
+ * @param pixel_format The pixel format of the `ImageData` instance to be created. If unknown, can be
+ *                     `PixelFormat::Unknown`.
+ * @return An `ImageData` instance with `channel_layout() == ChannelLayout::Planar`.
+ */
+template <typename T, std::size_t N>
+ImageData<ImageDataStorage::Modifiable> to_image_data(PlanarImage<T, N>&& img, PixelFormat pixel_format)
+{
+  if (!img.is_valid())
+  {
+    throw std::runtime_error("Supplied image is not valid.");
+  }
+
+  constexpr auto nr_channels = static_cast<std::uint16_t>(N);
+  constexpr auto nr_bytes_per_channel = static_cast<std::uint16_t>(sizeof(T));
+  constexpr auto sample_format = PixelTraits<Pixel<T, N>>::sample_format;
+
+  if (pixel_format != PixelFormat::Unknown && get_nr_channels(pixel_format) != nr_channels)
+  {
+    throw std::runtime_error("Mismatch in pixel format and number of channels.");
+  }
+
+  const auto width = img.width();
+  const auto height = img.height();
+  const auto stride_bytes = img.stride_bytes();
+
+  ImageData<> img_data;
+
+  if (img.is_view())
+  {
+    for (std::size_t c = 1; c < N; ++c)
+    {
+      if (img.byte_ptr(c) != img.byte_ptr(0) + c * img.plane_bytes())
+      {
+        throw std::runtime_error("Cannot describe planar image view with non-consecutive planes as ImageData.");
+      }
+    }
+
+    img_data.set_planar_view(img.byte_ptr(0), width, height, nr_channels, nr_bytes_per_channel, stride_bytes,
+                             pixel_format, sample_format);
+  }
+  else
+  {
+    img_data.set_planar_data(img.relinquish_data_ownership(), width, height, nr_channels, nr_bytes_per_channel,
+                             stride_bytes, pixel_format, sample_format);
+  }
+
+  return img_data;
+}
+
+/** \brief Converts a planar `ImageData` instance to a statically typed `PlanarImage<T, N>` instance.
+ *
+ * Precondition: The supplied image data must be valid, and have `channel_layout() == ChannelLayout::Planar`.
+ * The number of channels, the number of bytes per channel, and the sample format need to be compatible with `T` and
+ * `N`. Otherwise this function will throw a `std::runtime_error` exception.
+ *
+ * If the `ImageData` instance is a view, then the returned image will also be a view; image data will not be copied.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img_data The dynamically typed planar image. Moved from.
+ * @return A `PlanarImage<T, N>` instance.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N> to_planar_image(ImageData<>&& img_data)
+{
+  auto img = to_planar_image_view<T, N>(img_data);
+
+  if (img_data.is_view())
+  {
+    return img;
+  }
+
+  const auto width = img.width();
+  const auto height = img.height();
+  const auto stride_bytes = img.stride_bytes();
+  return PlanarImage<T, N>(img_data.relinquish_data_ownership(), width, height, stride_bytes);
+}
+
+/** \brief Creates a statically typed `PlanarImage<T, N>` view from a planar `ImageData` instance.
+ *
+ * See `to_planar_image()` for the preconditions. The lifetime of the supplied `ImageData` instance must be equal to or
+ * exceed the lifetime of the returned instance.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img_data The dynamically typed planar image.
+ * @return A `PlanarImage<T, N>` instance, which will be a view (i.e. `is_view() == true`).
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N> to_planar_image_view(ImageData<>& img_data)
+{
+  if (!img_data.is_valid())
+  {
+    throw std::runtime_error("Supplied image data is not valid.");
+  }
+
+  if (!img_data.is_planar())
+  {
+    throw std::runtime_error("Cannot convert interleaved ImageData to PlanarImage<>; use to_image() instead.");
+  }
+
+  if (img_data.nr_channels() != N || img_data.nr_bytes_per_channel() != sizeof(T))
+  {
+    throw std::runtime_error("Cannot convert ImageData to desired PlanarImage<> format: incompatible nr of channels.");
+  }
+
+  const auto sample_format = PixelTraits<Pixel<T, N>>::sample_format;
+
+  if (img_data.sample_format() != SampleFormat::Unknown && img_data.sample_format() != sample_format)
+  {
+    throw std::runtime_error("Cannot convert ImageData to desired PlanarImage<> format: incompatible sample formats.");
+  }
+
+  std::array<std::uint8_t*, N> planes;
+
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    planes[c] = img_data.plane_byte_ptr(static_cast<std::uint16_t>(c));
+  }
+
+  return PlanarImage<T, N>(planes, img_data.width(), img_data.height(), img_data.stride_bytes());
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_PLANAR_IMAGE_HPP
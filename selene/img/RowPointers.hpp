@@ -12,6 +12,7 @@
 
 #include <cstdint>
 #include <memory>
+#include <stdexcept>
 #include <vector>
 
 namespace sln {
@@ -72,12 +73,20 @@ ConstRowPointers get_row_pointers(const Image<T>& img)
 }
 
 /** \brief Extracts a list of consecutive pointers to each image row from an `ImageData` instance.
+ *
+ * Row pointers are only defined for interleaved image data. If the image data is planar and has more than one
+ * channel, a `std::runtime_error` exception will be thrown.
  *
  * @param img An image to extract the row pointers from.
  * @return List of row pointers.
  */
 inline RowPointers get_row_pointers(ImageData<>& img)
 {
+  if (img.is_planar() && img.nr_channels() > 1)
+  {
+    throw std::runtime_error("Cannot extract row pointers from planar image data with more than one channel");
+  }
+
   RowPointers row_pointers(img.height());
 
   for (PixelIndex y = 0_idx; y < img.height(); ++y)
@@ -89,6 +98,9 @@ inline RowPointers get_row_pointers(ImageData<>& img)
 }
 
 /** \brief Extracts a list of consecutive (constant) pointers to each image row from an `ImageData` instance.
+ *
+ * Row pointers are only defined for interleaved image data. If the image data is planar and has more than one
+ * channel, a `std::runtime_error` exception will be thrown.
  *
  * @param img An image to extract the row pointers from.
  * @return List of row pointers.
@@ -96,6 +108,11 @@ inline RowPointers get_row_pointers(ImageData<>& img)
 template <ImageDataStorage storage_type>
 inline ConstRowPointers get_row_pointers(const ImageData<storage_type>& img)
 {
+  if (img.is_planar() && img.nr_channels() > 1)
+  {
+    throw std::runtime_error("Cannot extract row pointers from planar image data with more than one channel");
+  }
+
   ConstRowPointers row_pointers(img.height());
 
   for (PixelIndex y = 0_idx; y < img.height(); ++y)
@@ -38,6 +38,22 @@ using Stride = ExplicitType<std::size_t, detail::StrideTag>;  ///< Type represen
 using ImageRowAlignment = ExplicitType<std::size_t, detail::ImageRowAlignmentTag>;  ///< Type representing an image row
                                                                                     ///< alignment.
 
+constexpr std::size_t simd_vector_bytes = 64;  ///< Width of the widest supported SIMD vector (AVX-512), in bytes.
+
+/** \brief Describes the memory layout of image data allocated by an `Image<>`. */
+enum class ImageLayout
+{
+  Default,  ///< Rows with the minimal stride; no alignment or padding guarantees.
+  SimdPadded,  ///< Data and rows aligned to `simd_vector_bytes`, with at least `simd_vector_bytes` of padding per row.
+};
+
+/** \brief Describes how the channels of multi-channel image data are arranged in memory. */
+enum class ChannelLayout
+{
+  Interleaved,  ///< All channels of a pixel are stored next to each other (e.g. RGBRGB...).
+  Planar,  ///< Each channel is stored in a separate plane (e.g. RR..., GG..., BB...); all planes share the same stride.
+};
+
 /** \brief Explicitly converts the provided value to `PixelIndex` type.
  *
  * This operation should usually be optimized away, but provides stronger type safety.
@@ -106,6 +122,14 @@ inline Stride compute_stride_bytes(std::size_t row_bytes, std::size_t alignment_
   return stride_bytes;
 }
 
+// Smallest stride that is a multiple of `simd_vector_bytes`, and leaves at least `simd_vector_bytes` of row padding.
+inline Stride compute_simd_stride_bytes(std::size_t row_bytes)
+{
+  const auto stride_bytes = Stride{(row_bytes + 2 * simd_vector_bytes - 1) / simd_vector_bytes * simd_vector_bytes};
+  SELENE_ASSERT(stride_bytes >= row_bytes + simd_vector_bytes);
+  return stride_bytes;
+}
+
 inline std::size_t guess_row_alignment(std::uintptr_t ptr, std::size_t stride_bytes, std::size_t start_alignment = 128)
 {
   SELENE_ASSERT(start_alignment > 0 && bit_count(start_alignment) == 1);  // should be power of 2
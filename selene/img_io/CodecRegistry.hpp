@@ -0,0 +1,359 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_IO_CODEC_REGISTRY_HPP
+#define SELENE_IMG_IO_CODEC_REGISTRY_HPP
+
+/// @file
+
+#include <selene/base/Assert.hpp>
+#include <selene/base/MessageLog.hpp>
+
+#include <selene/img/ImageBufferPool.hpp>
+#include <selene/img/ImageData.hpp>
+#include <selene/img_io/DecoderPool.hpp>
+#include <selene/img_io/JPEGRead.hpp>
+#include <selene/img_io/JPEGWrite.hpp>
+#include <selene/img_io/PNGRead.hpp>
+#include <selene/img_io/PNGWrite.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+namespace sln {
+
+/** \brief Describes a supported image format for reading or writing.
+ *
+ * To add support for a new image format, add an enumerator here, and register the respective read and write functions
+ * with the ImageReaderRegistry and ImageWriterRegistry.
+ */
+enum class ImageFormat
+{
+  Unknown,  ///< Unknown or unsupported image format.
+  JPEG,  ///< JPEG image format.
+  PNG  ///< PNG image format.
+};
+
+/** \brief Registry of image decoders for a particular source type, keyed by the signature ("magic") bytes of the image
+ * formats.
+ *
+ * Used by read_image() to dispatch directly to the right decoder, without trying each one in turn.
+ * The instance() of each source type comes with all built-in decoders registered. Further decoders (for new formats, or
+ * replacing a built-in decoder) can be added using add().
+ * Entries may additionally hold a pooled read function, which is used by the read_image() overload taking a DecoderPool
+ * and an ImageBufferPool.
+ *
+ * Registration is not synchronized with lookups; custom decoders should be registered before images are read
+ * concurrently.
+ *
+ * @tparam SourceType Type of the input source, e.g. FileReader or MemoryReader.
+ */
+template <typename SourceType>
+class ImageReaderRegistry
+{
+public:
+  /// Function reading an image stream from a source, in the format of the respective registry entry.
+  using ReadFunction = ImageData<> (*)(SourceType& source, MessageLog* messages);
+
+  /// Function reading an image stream from a source using pooled decompression objects and pooled image memory.
+  using PooledReadFunction = PooledImageData (*)(SourceType& source,
+                                                 DecoderPool& decoder_pool,
+                                                 ImageBufferPool& buffer_pool,
+                                                 MessageLog* messages);
+
+  static constexpr std::size_t max_signature_size = 16;  ///< The maximum number of signature bytes of an entry.
+
+  /** \brief An entry of the registry. */
+  struct Entry
+  {
+    ImageFormat format;  ///< The image format.
+    std::array<std::uint8_t, max_signature_size> signature;  ///< The signature bytes.
+    std::size_t signature_size;  ///< The number of signature bytes.
+    ReadFunction read;  ///< The read function.
+    PooledReadFunction pooled_read;  ///< The pooled read function; may be `nullptr`.
+  };
+
+  static ImageReaderRegistry& instance();
+
+  bool add(ImageFormat format,
+           std::initializer_list<std::uint8_t> signature,
+           ReadFunction read,
+           PooledReadFunction pooled_read = nullptr);
+  const Entry* find(const std::uint8_t* data, std::size_t len) const;
+  bool empty() const;
+
+private:
+  // Entries, bucketed by the first signature byte; within each bucket, entries are sorted by decreasing signature size.
+  std::array<std::vector<Entry>, 256> buckets_;
+  std::size_t nr_entries_ = 0;
+
+  ImageReaderRegistry();
+};
+
+/** \brief Registry of image encoders for a particular sink type, keyed by image format.
+ *
+ * Used by write_image() to dispatch to the encoder of the requested format.
+ * The instance() of each sink type comes with all built-in encoders registered. Further encoders can be added using
+ * add().
+ *
+ * Registration is not synchronized with lookups; custom encoders should be registered before images are written
+ * concurrently.
+ *
+ * @tparam SinkType Type of the output sink, e.g. FileWriter or VectorWriter.
+ */
+template <typename SinkType>
+class ImageWriterRegistry
+{
+public:
+  /// Function writing an image stream to a sink. The quality value is only meaningful for lossy formats.
+  using WriteFunction = bool (*)(const ImageData<ImageDataStorage::Constant>& img_data,
+                                 SinkType& sink,
+                                 MessageLog* messages,
+                                 int quality);
+
+  static ImageWriterRegistry& instance();
+
+  void add(ImageFormat format, WriteFunction write);
+  WriteFunction find(ImageFormat format) const;
+
+private:
+  std::vector<WriteFunction> write_functions_;  // indexed by format
+
+  ImageWriterRegistry();
+};
+
+// ----------
+// Implementation:
+
+/// \cond INTERNAL
+namespace detail {
+
+#if defined(SELENE_WITH_LIBJPEG)
+template <typename SourceType>
+ImageData<> read_jpeg_default(SourceType& source, MessageLog* messages)
+{
+  return read_jpeg(source, JPEGDecompressionOptions(), messages);
+}
+
+template <typename SourceType>
+PooledImageData read_jpeg_pooled_default(SourceType& source,
+                                         DecoderPool& decoder_pool,
+                                         ImageBufferPool& buffer_pool,
+                                         MessageLog* messages)
+{
+  auto obj = decoder_pool.jpeg().acquire();
+  return read_jpeg(*obj, source, buffer_pool, JPEGDecompressionOptions(), messages);
+}
+
+template <typename SinkType>
+bool write_jpeg_default(const ImageData<ImageDataStorage::Constant>& img_data,
+                        SinkType& sink,
+                        MessageLog* messages,
+                        int quality)
+{
+  return write_jpeg(img_data, sink, JPEGCompressionOptions(quality), messages);
+}
+#endif  // defined(SELENE_WITH_LIBJPEG)
+
+#if defined(SELENE_WITH_LIBPNG)
+template <typename SourceType>
+ImageData<> read_png_default(SourceType& source, MessageLog* messages)
+{
+  return read_png(source, PNGDecompressionOptions(), messages);
+}
+
+template <typename SourceType>
+PooledImageData read_png_pooled_default(SourceType& source,
+                                        DecoderPool& decoder_pool,
+                                        ImageBufferPool& buffer_pool,
+                                        MessageLog* messages)
+{
+  auto obj = decoder_pool.png().acquire();
+  return read_png(*obj, source, buffer_pool, PNGDecompressionOptions(), messages);
+}
+
+template <typename SinkType>
+bool write_png_default(const ImageData<ImageDataStorage::Constant>& img_data,
+                       SinkType& sink,
+                       MessageLog* messages,
+                       int /*quality*/)
+{
+  return write_png(img_data, sink, PNGCompressionOptions(), messages);
+}
+#endif  // defined(SELENE_WITH_LIBPNG)
+
+}  // namespace detail
+/// \endcond
+
+template <typename SourceType>
+constexpr std::size_t ImageReaderRegistry<SourceType>::max_signature_size;
+
+/** \brief Returns the registry instance for the source type, with all built-in decoders registered.
+ *
+ * @return The registry instance.
+ */
+template <typename SourceType>
+ImageReaderRegistry<SourceType>& ImageReaderRegistry<SourceType>::instance()
+{
+  static ImageReaderRegistry<SourceType> registry;
+  return registry;
+}
+
+template <typename SourceType>
+ImageReaderRegistry<SourceType>::ImageReaderRegistry()
+{
+#if defined(SELENE_WITH_LIBJPEG)
+  add(ImageFormat::JPEG, {0xFF, 0xD8, 0xFF}, detail::read_jpeg_default<SourceType>,
+      detail::read_jpeg_pooled_default<SourceType>);
+#endif
+#if defined(SELENE_WITH_LIBPNG)
+  add(ImageFormat::PNG, {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A}, detail::read_png_default<SourceType>,
+      detail::read_png_pooled_default<SourceType>);
+#endif
+}
+
+/** \brief Registers a decoder for image streams beginning with the specified signature bytes.
+ *
+ * An already registered decoder for the same signature will be replaced, including its pooled read function.
+ *
+ * @param format The image format.
+ * @param signature The signature bytes. Needs to consist of 1 to `max_signature_size` bytes.
+ * @param read The read function.
+ * @param pooled_read The pooled read function (optional). If `nullptr`, the read_image() overload reading into pooled
+ * memory rejects streams of this signature.
+ * @return True, if the decoder was registered; false if the format, the signature, or the read function is invalid.
+ */
+template <typename SourceType>
+bool ImageReaderRegistry<SourceType>::add(ImageFormat format,
+                                          std::initializer_list<std::uint8_t> signature,
+                                          ReadFunction read,
+                                          PooledReadFunction pooled_read)
+{
+  if (format == ImageFormat::Unknown || signature.size() == 0 || signature.size() > max_signature_size
+      || read == nullptr)
+  {
+    return false;
+  }
+
+  Entry entry{format, {}, signature.size(), read, pooled_read};
+  std::copy(signature.begin(), signature.end(), entry.signature.begin());
+
+  auto& bucket = buckets_[*signature.begin()];
+  auto same_signature = [&entry](const Entry& e) {
+    return e.signature_size == entry.signature_size
+           && std::equal(e.signature.cbegin(), e.signature.cbegin() + e.signature_size, entry.signature.cbegin());
+  };
+
+  const auto it = std::find_if(bucket.begin(), bucket.end(), same_signature);
+  if (it != bucket.end())
+  {
+    *it = entry;
+    return true;
+  }
+
+  // Keep longer signatures first, so that the most specific match is found.
+  const auto pos = std::find_if(bucket.begin(), bucket.end(),
+                                [&entry](const Entry& e) { return e.signature_size < entry.signature_size; });
+  bucket.insert(pos, entry);
+  ++nr_entries_;
+  return true;
+}
+
+/** \brief Returns the registry entry matching the beginning of the supplied image stream.
+ *
+ * @param data Pointer to the first bytes of the image stream.
+ * @param len The number of bytes available at `data`. At most `max_signature_size` bytes will be considered.
+ * @return A pointer to the matching entry, or `nullptr` if no registered signature matches.
+ */
+template <typename SourceType>
+auto ImageReaderRegistry<SourceType>::find(const std::uint8_t* data, std::size_t len) const -> const Entry*
+{
+  if (len == 0)
+  {
+    return nullptr;
+  }
+
+  for (const auto& entry : buckets_[data[0]])
+  {
+    if (entry.signature_size <= len && std::memcmp(entry.signature.data(), data, entry.signature_size) == 0)
+    {
+      return &entry;
+    }
+  }
+
+  return nullptr;
+}
+
+/** \brief Returns whether no decoders are registered.
+ *
+ * @return True, if no decoders are registered; false otherwise.
+ */
+template <typename SourceType>
+bool ImageReaderRegistry<SourceType>::empty() const
+{
+  return nr_entries_ == 0;
+}
+
+// ----------
+
+/** \brief Returns the registry instance for the sink type, with all built-in encoders registered.
+ *
+ * @return The registry instance.
+ */
+template <typename SinkType>
+ImageWriterRegistry<SinkType>& ImageWriterRegistry<SinkType>::instance()
+{
+  static ImageWriterRegistry<SinkType> registry;
+  return registry;
+}
+
+template <typename SinkType>
+ImageWriterRegistry<SinkType>::ImageWriterRegistry()
+{
+#if defined(SELENE_WITH_LIBJPEG)
+  add(ImageFormat::JPEG, detail::write_jpeg_default<SinkType>);
+#endif
+#if defined(SELENE_WITH_LIBPNG)
+  add(ImageFormat::PNG, detail::write_png_default<SinkType>);
+#endif
+}
+
+/** \brief Registers an encoder for the specified image format.
+ *
+ * An already registered encoder for the same format will be replaced.
+ *
+ * @param format The image format.
+ * @param write The write function.
+ */
+template <typename SinkType>
+void ImageWriterRegistry<SinkType>::add(ImageFormat format, WriteFunction write)
+{
+  const auto index = static_cast<std::size_t>(format);
+  if (index >= write_functions_.size())
+  {
+    write_functions_.resize(index + 1, nullptr);
+  }
+
+  write_functions_[index] = write;
+}
+
+/** \brief Returns the encoder registered for the specified image format.
+ *
+ * @param format The image format.
+ * @return The write function, or `nullptr` if no encoder is registered for the format.
+ */
+template <typename SinkType>
+auto ImageWriterRegistry<SinkType>::find(ImageFormat format) const -> WriteFunction
+{
+  const auto index = static_cast<std::size_t>(format);
+  return index < write_functions_.size() ? write_functions_[index] : nullptr;
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_IO_CODEC_REGISTRY_HPP
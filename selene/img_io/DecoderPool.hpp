@@ -0,0 +1,315 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_IO_DECODER_POOL_HPP
+#define SELENE_IMG_IO_DECODER_POOL_HPP
+
+/// @file
+
+#include <selene/img/ImageBufferPool.hpp>
+#include <selene/img_io/JPEGRead.hpp>
+#include <selene/img_io/PNGRead.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace sln {
+
+/** \brief Thread-safe pool of decompression objects of one type, e.g. JPEGDecompressionObject or
+ * PNGDecompressionObject.
+ *
+ * Objects are handed out as DecompressionObjectPool::Handle instances, which return the object to the pool on
+ * destruction. Returned objects are kept alive ("warm"), so that their construction cost is only paid once.
+ *
+ * A pool instance needs to outlive all handles acquired from it.
+ *
+ * @tparam DecompressionObject The type of the pooled decompression objects.
+ */
+template <typename DecompressionObject>
+class DecompressionObjectPool
+{
+public:
+  class Handle;
+
+  explicit DecompressionObjectPool(std::size_t nr_preallocated_objects = 0);
+
+  DecompressionObjectPool(const DecompressionObjectPool&) = delete;  ///< Copy constructor (deleted).
+  DecompressionObjectPool& operator=(const DecompressionObjectPool&) = delete;  ///< Copy assignment operator (deleted).
+  DecompressionObjectPool(DecompressionObjectPool&&) = delete;  ///< Move constructor (deleted).
+  DecompressionObjectPool& operator=(DecompressionObjectPool&&) = delete;  ///< Move assignment operator (deleted).
+
+  Handle acquire();
+  void preallocate(std::size_t nr_objects);
+
+  std::size_t nr_pooled_objects() const;
+  std::size_t nr_constructed_objects() const;
+
+private:
+  mutable std::mutex mutex_;
+  std::vector<std::unique_ptr<DecompressionObject>> objects_;
+  std::size_t nr_constructed_objects_ = 0;
+
+  void release(std::unique_ptr<DecompressionObject>&& object) noexcept;
+};
+
+/** \brief A decompression object acquired from a DecompressionObjectPool.
+ *
+ * Move-only; the object is returned to the pool on destruction.
+ *
+ * @tparam DecompressionObject The type of the decompression object.
+ */
+template <typename DecompressionObject>
+class DecompressionObjectPool<DecompressionObject>::Handle
+{
+public:
+  Handle() = default;  ///< Default constructor. Constructs an empty handle.
+  ~Handle();
+
+  Handle(const Handle&) = delete;  ///< Copy constructor (deleted).
+  Handle& operator=(const Handle&) = delete;  ///< Copy assignment operator (deleted).
+  Handle(Handle&& other) noexcept = default;  ///< Move constructor.
+  Handle& operator=(Handle&& other) noexcept;
+
+  DecompressionObject& operator*() const noexcept;
+  DecompressionObject* operator->() const noexcept;
+  DecompressionObject* get() const noexcept;
+
+  void reset() noexcept;
+
+private:
+  DecompressionObjectPool* pool_ = nullptr;
+  std::unique_ptr<DecompressionObject> object_;
+
+  Handle(DecompressionObjectPool* pool, std::unique_ptr<DecompressionObject>&& object) noexcept;
+
+  friend class DecompressionObjectPool;
+};
+
+/** \brief Thread-safe pool of the decompression objects for all supported image formats.
+ *
+ * Meant for services that decode many images, potentially on many threads. In combination with an ImageBufferPool,
+ * decoding of the images via read_image() (see IO.hpp), read_jpeg(), or read_png() neither constructs decompression
+ * objects nor allocates memory for the output image data, once the pools have been warmed up.
+ */
+class DecoderPool
+{
+public:
+  explicit DecoderPool(std::size_t nr_preallocated_objects = 0);
+
+#if defined(SELENE_WITH_LIBJPEG)
+  /// Returns the pool of JPEG decompression objects.
+  DecompressionObjectPool<JPEGDecompressionObject>& jpeg() noexcept { return jpeg_pool_; }
+#endif
+
+#if defined(SELENE_WITH_LIBPNG)
+  /// Returns the pool of PNG decompression objects.
+  DecompressionObjectPool<PNGDecompressionObject>& png() noexcept { return png_pool_; }
+#endif
+
+private:
+#if defined(SELENE_WITH_LIBJPEG)
+  DecompressionObjectPool<JPEGDecompressionObject> jpeg_pool_;
+#endif
+#if defined(SELENE_WITH_LIBPNG)
+  DecompressionObjectPool<PNGDecompressionObject> png_pool_;
+#endif
+};
+
+// ----------
+// Implementation:
+
+/** \brief Constructor.
+ *
+ * @param nr_preallocated_objects The number of decompression objects to construct upfront.
+ */
+template <typename DecompressionObject>
+DecompressionObjectPool<DecompressionObject>::DecompressionObjectPool(std::size_t nr_preallocated_objects)
+{
+  preallocate(nr_preallocated_objects);
+}
+
+/** \brief Acquires a decompression object.
+ *
+ * A pooled object is reused, if available; otherwise, a new object is constructed.
+ *
+ * @return A handle to the decompression object.
+ */
+template <typename DecompressionObject>
+auto DecompressionObjectPool<DecompressionObject>::acquire() -> Handle
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!objects_.empty())
+    {
+      auto object = std::move(objects_.back());
+      objects_.pop_back();
+      return Handle(this, std::move(object));
+    }
+
+    ++nr_constructed_objects_;
+  }
+
+  return Handle(this, std::make_unique<DecompressionObject>());
+}
+
+/** \brief Constructs decompression objects upfront, until the pool holds at least the specified number of objects.
+ *
+ * @param nr_objects The number of objects the pool should hold.
+ */
+template <typename DecompressionObject>
+void DecompressionObjectPool<DecompressionObject>::preallocate(std::size_t nr_objects)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  objects_.reserve(nr_objects);
+
+  while (objects_.size() < nr_objects)
+  {
+    objects_.push_back(std::make_unique<DecompressionObject>());
+    ++nr_constructed_objects_;
+  }
+}
+
+/** \brief Returns the number of objects currently held by the pool, i.e. released and available for reuse.
+ *
+ * @return The number of pooled objects.
+ */
+template <typename DecompressionObject>
+std::size_t DecompressionObjectPool<DecompressionObject>::nr_pooled_objects() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return objects_.size();
+}
+
+/** \brief Returns the number of objects constructed by the pool so far.
+ *
+ * This equals the maximum number of objects that have been in use concurrently (or the number of preallocated objects,
+ * if larger).
+ *
+ * @return The number of constructed objects.
+ */
+template <typename DecompressionObject>
+std::size_t DecompressionObjectPool<DecompressionObject>::nr_constructed_objects() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return nr_constructed_objects_;
+}
+
+template <typename DecompressionObject>
+void DecompressionObjectPool<DecompressionObject>::release(std::unique_ptr<DecompressionObject>&& object) noexcept
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Only allocates while the pool grows; the capacity never exceeds the number of constructed objects.
+  try
+  {
+    objects_.push_back(std::move(object));
+  }
+  catch (...)
+  {
+  }
+}
+
+// ----------
+
+template <typename DecompressionObject>
+DecompressionObjectPool<DecompressionObject>::Handle::Handle(DecompressionObjectPool* pool,
+                                                             std::unique_ptr<DecompressionObject>&& object) noexcept
+    : pool_(pool), object_(std::move(object))
+{
+}
+
+/** \brief Destructor. Returns the decompression object to the pool. */
+template <typename DecompressionObject>
+DecompressionObjectPool<DecompressionObject>::Handle::~Handle()
+{
+  reset();
+}
+
+/** \brief Move assignment operator.
+ *
+ * Returns the decompression object currently held to the pool.
+ *
+ * @param other The handle to move from; is empty afterwards.
+ * @return A reference to this handle.
+ */
+template <typename DecompressionObject>
+auto DecompressionObjectPool<DecompressionObject>::Handle::operator=(Handle&& other) noexcept -> Handle&
+{
+  if (this != &other)
+  {
+    reset();
+    pool_ = other.pool_;
+    object_ = std::move(other.object_);
+  }
+
+  return *this;
+}
+
+/** \brief Returns a reference to the decompression object.
+ *
+ * @return A reference to the decompression object.
+ */
+template <typename DecompressionObject>
+DecompressionObject& DecompressionObjectPool<DecompressionObject>::Handle::operator*() const noexcept
+{
+  return *object_;
+}
+
+/** \brief Returns a pointer to the decompression object.
+ *
+ * @return A pointer to the decompression object.
+ */
+template <typename DecompressionObject>
+DecompressionObject* DecompressionObjectPool<DecompressionObject>::Handle::operator->() const noexcept
+{
+  return object_.get();
+}
+
+/** \brief Returns a pointer to the decompression object.
+ *
+ * @return A pointer to the decompression object; `nullptr` if the handle is empty.
+ */
+template <typename DecompressionObject>
+DecompressionObject* DecompressionObjectPool<DecompressionObject>::Handle::get() const noexcept
+{
+  return object_.get();
+}
+
+/** \brief Returns the decompression object to the pool. Postcondition: `get() == nullptr`. */
+template <typename DecompressionObject>
+void DecompressionObjectPool<DecompressionObject>::Handle::reset() noexcept
+{
+  if (object_)
+  {
+    pool_->release(std::move(object_));
+  }
+
+  object_ = nullptr;
+  pool_ = nullptr;
+}
+
+// ----------
+
+/** \brief Constructor.
+ *
+ * @param nr_preallocated_objects The number of decompression objects to construct upfront, per image format.
+ */
+inline DecoderPool::DecoderPool(std::size_t nr_preallocated_objects)
+{
+#if defined(SELENE_WITH_LIBJPEG)
+  jpeg_pool_.preallocate(nr_preallocated_objects);
+#endif
+#if defined(SELENE_WITH_LIBPNG)
+  png_pool_.preallocate(nr_preallocated_objects);
+#endif
+  static_cast<void>(nr_preallocated_objects);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_IO_DECODER_POOL_HPP
@@ -11,26 +11,23 @@
 #include <selene/base/MessageLog.hpp>
 
 #include <selene/img/ImageData.hpp>
-#include <selene/img_io/JPEGRead.hpp>
-#include <selene/img_io/JPEGWrite.hpp>
-#include <selene/img_io/PNGRead.hpp>
-#include <selene/img_io/PNGWrite.hpp>
+#include <selene/img_io/CodecRegistry.hpp>
 
+#include <array>
 #include <stdexcept>
+#include <type_traits>
 
 namespace sln {
 
-/** \brief Describes a supported image format for reading or writing.
- */
-enum class ImageFormat
-{
-  JPEG,  ///< JPEG image format.
-  PNG  ///< PNG image format.
-};
-
 template <typename SourceType>
 ImageData<> read_image(SourceType&& source, MessageLog* messages = nullptr);
 
+template <typename SourceType>
+PooledImageData read_image(SourceType&& source,
+                           DecoderPool& decoder_pool,
+                           ImageBufferPool& buffer_pool,
+                           MessageLog* messages = nullptr);
+
 template <ImageDataStorage storage_type, typename SinkType>
 bool write_image(const ImageData<storage_type>& img_data,
                  ImageFormat format,
@@ -45,11 +42,29 @@ namespace detail {
 
 void add_messages(const MessageLog& messages_src, MessageLog* messages_dst);
 
+inline const ImageData<ImageDataStorage::Constant>& to_constant_image_data(
+    const ImageData<ImageDataStorage::Constant>& img_data)
+{
+  return img_data;
+}
+
+inline ImageData<ImageDataStorage::Constant> to_constant_image_data(
+    const ImageData<ImageDataStorage::Modifiable>& img_data)
+{
+  return ImageData<ImageDataStorage::Constant>(img_data.byte_ptr(), img_data.width(), img_data.height(),
+                                               img_data.nr_channels(), img_data.nr_bytes_per_channel(),
+                                               img_data.stride_bytes(), img_data.pixel_format(),
+                                               img_data.sample_format());
+}
+
 }  // namespace detail
 
-/** \brief Reads an image stream, trying all supported formats.
+/** \brief Reads an image stream, detecting its format from the leading signature bytes.
+ *
+ * The decoder is looked up in the ImageReaderRegistry of the source type; only the decoder of the detected format is
+ * invoked.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  * @param source Input source instance.
  * @param messages Optional pointer to the message log. If provided, warning and error messages will be output there.
  * @return An `ImageData` instance. Reading the image stream was successful, if `is_valid() == true`, and unsuccessful
@@ -58,66 +73,110 @@ void add_messages(const MessageLog& messages_src, MessageLog* messages_dst);
 template <typename SourceType>
 ImageData<> read_image(SourceType&& source, MessageLog* messages)
 {
-  bool reading_attempted = false;
+  using Registry = ImageReaderRegistry<std::remove_reference_t<SourceType>>;
+  const auto& registry = Registry::instance();
+
+  if (registry.empty())
+  {
+    throw std::runtime_error("ERROR: Image reading unsupported; recompile with the respective external dependencies.");
+  }
+
+  // Peek at the signature bytes, and return to the original position
   const auto source_pos = source.position();
-  ImageData<> img_data;
+  std::array<std::uint8_t, Registry::max_signature_size> signature;
+  const auto nr_signature_bytes = source.read(signature.data(), signature.size());
+  source.seek_abs(source_pos);
 
-  // First, try to read as JPEG image:
+  const auto entry = registry.find(signature.data(), nr_signature_bytes);
 
-#if defined(SELENE_WITH_LIBJPEG)
+  if (entry == nullptr)
   {
-    JPEGDecompressionObject obj;
-    MessageLog messages_jpeg;
-    auto header_info = read_jpeg_header(obj, std::forward<SourceType>(source), false, &messages_jpeg);
-    reading_attempted = true;
-
-    if (header_info.is_valid())
+    if (messages != nullptr)
     {
-      img_data = read_jpeg(obj, std::forward<SourceType>(source), JPEGDecompressionOptions(), &messages_jpeg,
-                           &header_info);
-
-      detail::add_messages(messages_jpeg, messages);
-      return img_data;
+      messages->add_message("Source is not in a supported image format.");
     }
+
+    return ImageData<>();
   }
-#endif  // defined(SELENE_WITH_LIBJPEG)
 
-  // In case that failed, try to read as PNG image:
-  SELENE_ASSERT(!img_data.is_valid());
-  source.seek_abs(source_pos);
+  MessageLog messages_read;
+  auto img_data = entry->read(source, &messages_read);
 
-#if defined(SELENE_WITH_LIBPNG)
+  if (!img_data.is_valid())
   {
-    PNGDecompressionObject obj;
-    MessageLog messages_png;
-    auto header_info = read_png_header(obj, std::forward<SourceType>(source), false, &messages_png);
-    reading_attempted = true;
+    source.seek_abs(source_pos);
+  }
 
-    if (header_info.is_valid())
-    {
-      img_data = read_png(obj, std::forward<SourceType>(source), PNGDecompressionOptions(), &messages_png,
-                          &header_info);
+  detail::add_messages(messages_read, messages);
+  return img_data;
+}
 
-      detail::add_messages(messages_png, messages);
-      return img_data;
+/** \brief Reads an image stream, detecting its format from the leading signature bytes, using pooled decompression
+ * objects and pooled memory for the image data.
+ *
+ * The decoder is looked up in the ImageReaderRegistry of the source type, and invoked through the pooled read function
+ * of its entry. Decoders registered without a pooled read function are not supported.
+ *
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
+ * @param source Input source instance.
+ * @param decoder_pool The pool to acquire the decompression object from.
+ * @param buffer_pool The pool to acquire the memory for the decompressed image data from.
+ * @param messages Optional pointer to the message log. If provided, warning and error messages will be output there.
+ * @return A `PooledImageData` instance. Reading the image stream was successful, if `is_valid() == true`, and
+ * unsuccessful otherwise.
+ */
+template <typename SourceType>
+PooledImageData read_image(SourceType&& source,
+                           DecoderPool& decoder_pool,
+                           ImageBufferPool& buffer_pool,
+                           MessageLog* messages)
+{
+  using Registry = ImageReaderRegistry<std::remove_reference_t<SourceType>>;
+  const auto& registry = Registry::instance();
+
+  // Peek at the signature bytes, and return to the original position
+  const auto source_pos = source.position();
+  std::array<std::uint8_t, Registry::max_signature_size> signature;
+  const auto nr_signature_bytes = source.read(signature.data(), signature.size());
+  source.seek_abs(source_pos);
+
+  const auto entry = registry.find(signature.data(), nr_signature_bytes);
+
+  if (entry == nullptr)
+  {
+    if (messages != nullptr)
+    {
+      messages->add_message("Source is not in a supported image format.");
     }
+
+    return PooledImageData();
   }
-#endif  // defined(SELENE_WITH_LIBPNG)
 
-  // Image reading failed: return an ImageData instance that is invalid:
+  if (entry->pooled_read == nullptr)
+  {
+    if (messages != nullptr)
+    {
+      messages->add_message("Pooled reading is unsupported by the decoder registered for the image format.");
+    }
 
-  SELENE_ASSERT(!img_data.is_valid());
-  source.seek_abs(source_pos);
+    return PooledImageData();
+  }
 
-  if (!reading_attempted)
+  MessageLog messages_read;
+  auto img_data = entry->pooled_read(source, decoder_pool, buffer_pool, &messages_read);
+
+  if (!img_data.is_valid())
   {
-    throw std::runtime_error("ERROR: Image reading unsupported; recompile with the respective external dependencies.");
+    source.seek_abs(source_pos);
   }
 
+  detail::add_messages(messages_read, messages);
   return img_data;
 }
 
 /** \brief Writes an image stream, given the supplied uncompressed image data.
+ *
+ * The encoder is looked up in the ImageWriterRegistry of the sink type.
  *
  * @tparam SinkType Type of the output sink. Can be FileWriter or VectorWriter.
  * @param img_data The image data to be written.
@@ -135,33 +194,28 @@ bool write_image(const ImageData<storage_type>& img_data,
                  MessageLog* messages,
                  int jpeg_quality)
 {
-  if (format == ImageFormat::JPEG)
+  using Registry = ImageWriterRegistry<std::remove_reference_t<SinkType>>;
+  const auto write = Registry::instance().find(format);
+
+  if (write == nullptr)
   {
-#if defined(SELENE_WITH_LIBJPEG)
-    MessageLog messages_jpeg;
-    bool success = write_jpeg(img_data, std::forward<SinkType>(sink), JPEGCompressionOptions(jpeg_quality),
-                              &messages_jpeg);
-
-    detail::add_messages(messages_jpeg, messages);
-    return success;
-#else  // defined(SELENE_WITH_LIBJPEG)
-    throw std::runtime_error("ERROR: JPEG writing unsupported; recompile with the respective external dependency.");
-#endif  // defined(SELENE_WITH_LIBJPEG)
+    throw std::runtime_error("ERROR: Writing of the requested image format unsupported; recompile with the respective "
+                             "external dependency.");
   }
-  else if (format == ImageFormat::PNG)
+
+  MessageLog messages_write;
+
+  // Encoders expect interleaved rows; also, the planar layout would not survive the conversion to constant image data
+  if (img_data.is_planar() && img_data.nr_channels() > 1)
   {
-#if defined(SELENE_WITH_LIBPNG)
-    MessageLog messages_png;
-    bool success = write_png(img_data, std::forward<SinkType>(sink), PNGCompressionOptions(), &messages_png);
-
-    detail::add_messages(messages_png, messages);
-    return success;
-#else  // defined(SELENE_WITH_LIBPNG)
-    throw std::runtime_error("ERROR: PNG writing unsupported; recompile with the respective external dependency.");
-#endif  // defined(SELENE_WITH_LIBPNG)
+    messages_write.add_message("Planar image data with more than one channel cannot be written.");
+    detail::add_messages(messages_write, messages);
+    return false;
   }
 
-  throw std::runtime_error("ERROR: Unknown image format.");
+  const bool success = write(detail::to_constant_image_data(img_data), sink, &messages_write, jpeg_quality);
+  detail::add_messages(messages_write, messages);
+  return success;
 }
 
 }  // namespace sln
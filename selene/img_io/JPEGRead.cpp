@@ -9,6 +9,7 @@
 
 #include <jpeglib.h>
 
+#include <algorithm>
 #include <cstdio>
 #include <stdexcept>
 
@@ -41,6 +42,10 @@ struct JPEGDecompressionObject::Impl
 {
   jpeg_decompress_struct cinfo;
   detail::JPEGErrorManager error_manager;
+  // libjpeg refuses to switch a decompression object between stdio and memory sources, since their source managers
+  // differ. Hence one source manager of each kind is kept, and swapped in as needed.
+  jpeg_source_mgr* stdio_src = nullptr;
+  jpeg_source_mgr* mem_src = nullptr;
   bool valid = false;
   bool needs_reset = false;
 };
@@ -69,6 +74,16 @@ void JPEGDecompressionObject::reset_if_needed()
   }
 }
 
+// Prepares the object for reading from a new source. This returns libjpeg to its start state, in case the previous
+// stream was not decompressed completely (e.g. if only its header was read, or if reading failed).
+void JPEGDecompressionObject::restart()
+{
+  jpeg_abort_decompress(&impl_->cinfo);
+  impl_->error_manager.error_state = false;
+  impl_->error_manager.message_log.clear();
+  impl_->needs_reset = false;
+}
+
 bool JPEGDecompressionObject::valid() const
 {
   return impl_->valid;
@@ -81,11 +96,34 @@ JPEGImageInfo JPEGDecompressionObject::get_header_info() const
                        static_cast<std::uint16_t>(impl_->cinfo.num_components), color_space);
 }
 
-void JPEGDecompressionObject::set_decompression_parameters(JPEGColorSpace out_color_space)
+void JPEGDecompressionObject::set_decompression_parameters(const JPEGDecompressionOptions& options)
 {
-  if (out_color_space != JPEGColorSpace::Auto)
+  auto& cinfo = impl_->cinfo;
+
+  if (options.out_color_space != JPEGColorSpace::Auto)
+  {
+    cinfo.out_color_space = detail::color_space_pub_to_lib(options.out_color_space);
+  }
+
+  cinfo.scale_num = options.scale_num;
+  cinfo.scale_denom = options.scale_denom;
+
+  if (options.min_width > 0 || options.min_height > 0)
   {
-    impl_->cinfo.out_color_space = detail::color_space_pub_to_lib(out_color_space);
+    // Choose the largest power-of-two downscaling (up to 1/8) that still satisfies the requested minimum size.
+    // libjpeg rounds scaled dimensions up, as is done here.
+    const auto min_width = static_cast<JDIMENSION>(std::max(options.min_width, 0_px));
+    const auto min_height = static_cast<JDIMENSION>(std::max(options.min_height, 0_px));
+    auto scale_denom = JDIMENSION{1};
+
+    while (scale_denom < 8 && (cinfo.image_width + 2 * scale_denom - 1) / (2 * scale_denom) >= min_width
+           && (cinfo.image_height + 2 * scale_denom - 1) / (2 * scale_denom) >= min_height)
+    {
+      scale_denom *= 2;
+    }
+
+    cinfo.scale_num = 1;
+    cinfo.scale_denom = scale_denom;
   }
 }
 
@@ -155,12 +193,39 @@ JPEGImageInfo JPEGDecompressionCycle::get_output_info() const
 }
 
 bool JPEGDecompressionCycle::decompress(RowPointers& row_pointers)
+{
+  return decompress_rows(row_pointers, row_pointers.size()) && nr_remaining_rows() == 0 && finish();
+}
+
+std::size_t JPEGDecompressionCycle::nr_remaining_rows() const
+{
+  if (finished_or_aborted_)
+  {
+    return 0;
+  }
+
+  const auto& cinfo = obj_.impl_->cinfo;
+  const auto end_row = region_.empty() ? cinfo.output_height : static_cast<JDIMENSION>(region_.y_end());
+  const auto next_row = (!started_ && !region_.empty()) ? static_cast<JDIMENSION>(region_.y0()) : cinfo.output_scanline;
+  return static_cast<std::size_t>(end_row - next_row);
+}
+
+// Decompresses the next `nr_rows` rows (at most) of the output image into the rows pointed to by `row_pointers`.
+bool JPEGDecompressionCycle::decompress_rows(RowPointers& row_pointers, std::size_t nr_rows)
 {
   auto& cinfo = obj_.impl_->cinfo;
 
   const auto region_valid = !region_.empty();
   const auto skip_lines_top = region_valid ? region_.y0() : 0;
-  const auto skip_lines_bottom = region_valid ? cinfo.output_height - region_.y_end() : 0;
+  const auto end_row = region_valid ? static_cast<JDIMENSION>(region_.y_end()) : cinfo.output_height;
+  std::size_t row = 0;
+
+  SELENE_ASSERT(row_pointers.size() >= nr_rows);
+
+  if (finished_or_aborted_)
+  {
+    return false;
+  }
 
   if (setjmp(obj_.impl_->error_manager.setjmp_buffer))
   {
@@ -168,19 +233,53 @@ bool JPEGDecompressionCycle::decompress(RowPointers& row_pointers)
   }
 
 #if defined(SELENE_LIBJPEG_PARTIAL_DECODING)
-  jpeg_skip_scanlines(&cinfo, static_cast<JDIMENSION>(skip_lines_top));
+  if (!started_)
+  {
+    jpeg_skip_scanlines(&cinfo, static_cast<JDIMENSION>(skip_lines_top));
+  }
+#else
+  static_cast<void>(skip_lines_top);
 #endif
 
-  while (cinfo.output_scanline < cinfo.output_height - skip_lines_bottom)
+  started_ = true;
+
+  for (; row < nr_rows && cinfo.output_scanline < end_row; ++row)
+  {
+    jpeg_read_scanlines(&cinfo, &row_pointers[row], 1);
+  }
+
+  return true;
+
+failure_state:
+  jpeg_abort_decompress(&cinfo);
+  finished_or_aborted_ = true;
+  return false;
+}
+
+// Finishes decompression, after all rows have been decompressed.
+bool JPEGDecompressionCycle::finish()
+{
+  auto& cinfo = obj_.impl_->cinfo;
+
+  const auto skip_lines_bottom = !region_.empty() ? cinfo.output_height - region_.y_end() : 0;
+
+  if (finished_or_aborted_)
   {
-    jpeg_read_scanlines(&cinfo, &row_pointers[cinfo.output_scanline - skip_lines_top], 1);
+    return false;
+  }
+
+  if (setjmp(obj_.impl_->error_manager.setjmp_buffer))
+  {
+    goto failure_state;
   }
 
 #if defined(SELENE_LIBJPEG_PARTIAL_DECODING)
   jpeg_skip_scanlines(&cinfo, static_cast<JDIMENSION>(skip_lines_bottom));
+#else
+  static_cast<void>(skip_lines_bottom);
 #endif
 
-  jpeg_finish_decompress(&obj_.impl_->cinfo);
+  jpeg_finish_decompress(&cinfo);
   finished_or_aborted_ = true;
   return true;
 
@@ -196,14 +295,16 @@ failure_state:
 
 void set_source(JPEGDecompressionObject& obj, FileReader& source)
 {
-  obj.reset_if_needed();
+  obj.restart();
 
   if (setjmp(obj.impl_->error_manager.setjmp_buffer))
   {
     goto failure_state;
   }
 
+  obj.impl_->cinfo.src = obj.impl_->stdio_src;
   jpeg_stdio_src(&obj.impl_->cinfo, source.handle());
+  obj.impl_->stdio_src = obj.impl_->cinfo.src;
 
 failure_state:;
 }
@@ -211,7 +312,7 @@ failure_state:;
 
 void set_source(JPEGDecompressionObject& obj, MemoryReader& source)
 {
-  obj.reset_if_needed();
+  obj.restart();
 
   // Unfortunately, the libjpeg API is not const-correct before version 9b (or before libjpeg-turbo 1.5.0).
   auto handle = const_cast<unsigned char*>(source.handle());
@@ -221,7 +322,30 @@ void set_source(JPEGDecompressionObject& obj, MemoryReader& source)
     goto failure_state;
   }
 
-  jpeg_mem_src(&obj.impl_->cinfo, handle, static_cast<unsigned long>(source.size()));
+  // libjpeg reads directly from the memory region, starting at the current position of the reader; no data is copied.
+  obj.impl_->cinfo.src = obj.impl_->mem_src;
+  jpeg_mem_src(&obj.impl_->cinfo, handle, static_cast<unsigned long>(source.bytes_remaining()));
+  obj.impl_->mem_src = obj.impl_->cinfo.src;
+
+failure_state:;
+}
+
+
+void set_source(JPEGDecompressionObject& obj, MMapReader& source)
+{
+  obj.restart();
+
+  // The mapped pages are handed to libjpeg directly, without going through a stdio buffer.
+  auto handle = const_cast<unsigned char*>(source.handle());
+
+  if (setjmp(obj.impl_->error_manager.setjmp_buffer))
+  {
+    goto failure_state;
+  }
+
+  obj.impl_->cinfo.src = obj.impl_->mem_src;
+  jpeg_mem_src(&obj.impl_->cinfo, handle, static_cast<unsigned long>(source.bytes_remaining()));
+  obj.impl_->mem_src = obj.impl_->cinfo.src;
 
 failure_state:;
 }
@@ -15,6 +15,7 @@
 #include <selene/base/Utils.hpp>
 
 #include <selene/img/BoundingBox.hpp>
+#include <selene/img/ImageBufferPool.hpp>
 #include <selene/img/ImageData.hpp>
 #include <selene/img/RowPointers.hpp>
 #include <selene/img_io/JPEGCommon.hpp>
@@ -22,6 +23,7 @@
 #include <selene/img_io/detail/Util.hpp>
 
 #include <selene/io/FileReader.hpp>
+#include <selene/io/MMapReader.hpp>
 #include <selene/io/MemoryReader.hpp>
 
 #include <array>
@@ -37,6 +39,7 @@ namespace detail {
 class JPEGDecompressionCycle;
 void set_source(JPEGDecompressionObject&, FileReader&);
 void set_source(JPEGDecompressionObject&, MemoryReader&);
+void set_source(JPEGDecompressionObject&, MMapReader&);
 JPEGImageInfo read_header(JPEGDecompressionObject&);
 }  // namespace detail
 
@@ -63,11 +66,24 @@ struct JPEGImageInfo
 
 /** \brief JPEG decompression options.
  *
+ * Besides the constructor arguments, the image may be downscaled during decompression, which is considerably cheaper
+ * than decompressing at full size and resampling afterwards, since libjpeg then computes a reduced-size inverse DCT:
+ * - `scale_num`/`scale_denom` specify the scaling factor directly. libjpeg-turbo supports factors M/8 (M = 1..16);
+ *   other libjpeg versions may only support 1/1, 1/2, 1/4 and 1/8. Unsupported factors yield a decompression error.
+ * - `min_width`/`min_height` (if one of them is non-zero) select the smallest of the scaling factors 1/1, 1/2, 1/4 and
+ *   1/8 for which the output image is still at least as large as specified, e.g. for generating thumbnails. This
+ *   overrides `scale_num`/`scale_denom`.
+ *
+ * If a region is set, it refers to the (downscaled) output image.
  */
 struct JPEGDecompressionOptions
 {
   JPEGColorSpace out_color_space;  ///< The color space for the uncompressed data.
   BoundingBox region;  ///< If set (and supported), decompress only the specified image region (libjpeg-turbo).
+  unsigned int scale_num = 1;  ///< Numerator of the scaling factor applied during decompression.
+  unsigned int scale_denom = 1;  ///< Denominator of the scaling factor applied during decompression.
+  PixelLength min_width = 0_px;  ///< If non-zero, downscale to the smallest power-of-two size at least this wide.
+  PixelLength min_height = 0_px;  ///< If non-zero, downscale to the smallest power-of-two size at least this high.
 
   /** \brief Constructor, setting the respective JPEG decompression options.
    *
@@ -104,7 +120,7 @@ public:
   const MessageLog& message_log() const;
 
   JPEGImageInfo get_header_info() const;
-  void set_decompression_parameters(JPEGColorSpace out_color_space = JPEGColorSpace::Auto);
+  void set_decompression_parameters(const JPEGDecompressionOptions& options);
   /// \endcond
 
 private:
@@ -112,17 +128,19 @@ private:
   std::unique_ptr<Impl> impl_;
 
   void reset_if_needed();
+  void restart();
 
   friend class detail::JPEGDecompressionCycle;
   friend void detail::set_source(JPEGDecompressionObject&, FileReader&);
   friend void detail::set_source(JPEGDecompressionObject&, MemoryReader&);
+  friend void detail::set_source(JPEGDecompressionObject&, MMapReader&);
   friend JPEGImageInfo detail::read_header(JPEGDecompressionObject&);
 };
 
 
 /** \brief Reads header of JPEG image data stream.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  * @param source Input source instance.
  * @param rewind If true, the source position will be re-set to the original position after reading the header.
  * @param messages Optional pointer to the message log. If provided, warning and error messages will be output there.
@@ -135,7 +153,7 @@ JPEGImageInfo read_jpeg_header(SourceType&& source, bool rewind = false, Message
  *
  * This function overload enables re-use of a JPEGDecompressionObject instance.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  * @param obj A JPEGDecompressionObject instance.
  * @param source Input source instance.
  * @param rewind If true, the source position will be re-set to the original position after reading the header.
@@ -153,7 +171,7 @@ JPEGImageInfo read_jpeg_header(JPEGDecompressionObject& obj,
  * The source position must be set to the beginning of the JPEG stream, including header. In case img::read_jpeg_header
  * is called before, then it must be with `rewind == true`.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  * @param source Input source instance.
  * @param options The decompression options.
  * @param messages Optional pointer to the message log. If provided, warning and error messages will be output there.
@@ -173,7 +191,7 @@ ImageData<> read_jpeg(SourceType&& source,
  *
  * This function overload enables re-use of a JPEGDecompressionObject instance.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  * @param obj A JPEGDecompressionObject instance.
  * @param source Input source instance.
  * @param options The decompression options.
@@ -189,6 +207,29 @@ ImageData<> read_jpeg(JPEGDecompressionObject& obj,
                       MessageLog* messages = nullptr,
                       const JPEGImageInfo* provided_header_info = nullptr);
 
+/** \brief Reads contents of a JPEG image data stream into memory acquired from a buffer pool.
+ *
+ * The source position must be set to the beginning of the JPEG stream, including header.
+ *
+ * This function overload enables re-use of a JPEGDecompressionObject instance, as well as of the memory for the
+ * decompressed image data.
+ *
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
+ * @param obj A JPEGDecompressionObject instance.
+ * @param source Input source instance.
+ * @param buffer_pool The pool to acquire the memory for the decompressed image data from.
+ * @param options The decompression options.
+ * @param messages Optional pointer to the message log. If provided, warning and error messages will be output there.
+ * @return A `PooledImageData` instance. Reading the JPEG stream was successful, if `is_valid() == true`, and
+ * unsuccessful otherwise.
+ */
+template <typename SourceType>
+PooledImageData read_jpeg(JPEGDecompressionObject& obj,
+                          SourceType&& source,
+                          ImageBufferPool& buffer_pool,
+                          JPEGDecompressionOptions options = JPEGDecompressionOptions(),
+                          MessageLog* messages = nullptr);
+
 /** Class with functionality to read header and data of a JPEG image data stream.
  *
  * Generally, the free functions read_jpeg() or read_jpeg_header() should be preferred, due to ease of use.
@@ -206,7 +247,11 @@ ImageData<> read_jpeg(JPEGDecompressionObject& obj,
  * The source may optionally be re-set using `set_source()`; this is required if the previous image has not been read
  * completely or successfully.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * Alternatively, the image data can be read in strips of consecutive rows, by repeatedly calling
+ * `read_rows(ImageData<>&, PixelLength)`. This bounds the memory required for decompression by the strip size instead
+ * of the image size, e.g. for very large images which are processed strip by strip.
+ *
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  */
 template <typename SourceType>
 class JPEGReader
@@ -224,6 +269,9 @@ public:
   ImageData<> read_image_data();
   bool read_image_data(ImageData<>& img_data);
 
+  PixelLength read_rows(ImageData<>& strip_data, PixelLength max_nr_rows);
+  PixelLength nr_remaining_rows() const;
+
   MessageLog& message_log();
 
 private:
@@ -233,6 +281,7 @@ private:
   mutable std::unique_ptr<detail::JPEGDecompressionCycle> cycle_;
   bool header_read_ = false;
   bool valid_header_read_ = false;
+  bool rows_finished_ = false;
 
   void reset();
 };
@@ -251,9 +300,14 @@ public:
   JPEGImageInfo get_output_info() const;
   bool decompress(RowPointers& row_pointers);
 
+  std::size_t nr_remaining_rows() const;
+  bool decompress_rows(RowPointers& row_pointers, std::size_t nr_rows);
+  bool finish();
+
 private:
   JPEGDecompressionObject& obj_;
   BoundingBox region_;
+  bool started_ = false;
   bool finished_or_aborted_ = false;
 };
 
@@ -303,12 +357,17 @@ ImageData<> read_jpeg(SourceType&& source, JPEGDecompressionOptions options, Mes
   return read_jpeg(obj, std::forward<SourceType>(source), options, messages, nullptr);
 }
 
-template <typename SourceType>
-ImageData<> read_jpeg(JPEGDecompressionObject& obj,
-                      SourceType&& source,
-                      JPEGDecompressionOptions options,
-                      MessageLog* messages,
-                      const JPEGImageInfo* provided_header_info)
+namespace detail {
+
+// Decompresses the JPEG stream into the image data returned by `get_output`, which is called with the output image
+// parameters once these are known.
+template <typename SourceType, typename OutputFunction>
+bool read_jpeg_data(JPEGDecompressionObject& obj,
+                    SourceType& source,
+                    JPEGDecompressionOptions options,
+                    MessageLog* messages,
+                    const JPEGImageInfo* provided_header_info,
+                    OutputFunction get_output)
 {
   if (!provided_header_info)
   {
@@ -317,7 +376,7 @@ ImageData<> read_jpeg(JPEGDecompressionObject& obj,
     if (obj.error_state())
     {
       detail::assign_message_log(obj, messages);
-      return ImageData<>();
+      return false;
     }
   }
 
@@ -326,10 +385,10 @@ ImageData<> read_jpeg(JPEGDecompressionObject& obj,
   if (!header_info.is_valid())
   {
     detail::assign_message_log(obj, messages);
-    return ImageData<>();
+    return false;
   }
 
-  obj.set_decompression_parameters(options.out_color_space);
+  obj.set_decompression_parameters(options);
 
   detail::JPEGDecompressionCycle cycle(obj, options.region);
 
@@ -337,22 +396,66 @@ ImageData<> read_jpeg(JPEGDecompressionObject& obj,
   const auto output_width = output_info.width;
   const auto output_height = output_info.height;
   const auto output_nr_channels = output_info.nr_channels;
-  const auto output_nr_bytes_per_channel = 1;
-  const auto output_stride_bytes = Stride{0};  // will be chosen s.t. image content is tightly packed
+  const auto output_nr_bytes_per_channel = std::uint16_t{1};
   const auto output_pixel_format = detail::color_space_to_pixel_format(output_info.color_space);
   const auto output_sample_format = SampleFormat::UnsignedInteger;
 
-  ImageData<> img(output_width, output_height, output_nr_channels, output_nr_bytes_per_channel, output_stride_bytes,
-                  output_pixel_format, output_sample_format);
+  auto& img = get_output(output_width, output_height, output_nr_channels, output_nr_bytes_per_channel,
+                         output_pixel_format, output_sample_format);
   auto row_pointers = get_row_pointers(img);
   const auto dec_success = cycle.decompress(row_pointers);
 
-  if (!dec_success)
+  detail::assign_message_log(obj, messages);
+  return dec_success;
+}
+
+}  // namespace detail
+
+template <typename SourceType>
+ImageData<> read_jpeg(JPEGDecompressionObject& obj,
+                      SourceType&& source,
+                      JPEGDecompressionOptions options,
+                      MessageLog* messages,
+                      const JPEGImageInfo* provided_header_info)
+{
+  ImageData<> img;
+  const auto allocate = [&img](PixelLength width, PixelLength height, std::uint16_t nr_channels,
+                               std::uint16_t nr_bytes_per_channel, PixelFormat pixel_format,
+                               SampleFormat sample_format) -> ImageData<>& {
+    // The stride will be chosen s.t. image content is tightly packed
+    img.allocate(width, height, nr_channels, nr_bytes_per_channel, Stride{0}, pixel_format, sample_format);
+    return img;
+  };
+
+  if (!detail::read_jpeg_data(obj, source, options, messages, provided_header_info, allocate))
   {
     img.clear();  // invalidates image data
   }
 
-  detail::assign_message_log(obj, messages);
+  return img;
+}
+
+template <typename SourceType>
+PooledImageData read_jpeg(JPEGDecompressionObject& obj,
+                          SourceType&& source,
+                          ImageBufferPool& buffer_pool,
+                          JPEGDecompressionOptions options,
+                          MessageLog* messages)
+{
+  PooledImageData img;
+  const auto acquire = [&img, &buffer_pool](PixelLength width, PixelLength height, std::uint16_t nr_channels,
+                                            std::uint16_t nr_bytes_per_channel, PixelFormat pixel_format,
+                                            SampleFormat sample_format) -> ImageData<>& {
+    img = buffer_pool.acquire_image_data(width, height, nr_channels, nr_bytes_per_channel, pixel_format,
+                                         sample_format);
+    return img.image_data();
+  };
+
+  if (!detail::read_jpeg_data(obj, source, options, messages, nullptr, acquire))
+  {
+    img.clear();  // invalidates image data, and returns the memory to the pool
+  }
+
   return img;
 }
 
@@ -375,6 +478,7 @@ template <typename SourceType>
 void JPEGReader<SourceType>::set_source(SourceType& source)
 {
   reset();
+  rows_finished_ = false;
   source_ = &source;
   detail::set_source(obj_, source);
 }
@@ -392,6 +496,7 @@ JPEGImageInfo JPEGReader<SourceType>::read_header()
     throw std::runtime_error("JPEGReader: Cannot call read_header() after call to get_output_image_info() or read_image_data().");
   }
 
+  rows_finished_ = false;
   const JPEGImageInfo header_info = detail::read_header(obj_);
   header_read_ = true;
   valid_header_read_ = header_info.is_valid();
@@ -424,7 +529,7 @@ JPEGImageInfo JPEGReader<SourceType>::get_output_image_info()
 
   if (!cycle_)
   {
-    obj_.set_decompression_parameters(options_.out_color_space);
+    obj_.set_decompression_parameters(options_);
     cycle_ = std::make_unique<detail::JPEGDecompressionCycle>(obj_, options_.region);
   }
 
@@ -488,6 +593,76 @@ bool JPEGReader<SourceType>::read_image_data(ImageData<>& img_data)
   return true;
 }
 
+/** \brief Reads the next rows of the image data, i.e. the next strip of the image.
+ *
+ * Header reading and the setup of the decompression happen on the first call, if not done before.
+ * `strip_data` is allocated to hold `min(max_nr_rows, nr_remaining_rows())` tightly packed rows; its memory is reused
+ * between calls, as long as it suffices.
+ *
+ * Once all rows of the image have been read, decompression of the image is finished, and subsequent calls return 0
+ * until the next image is started (by a call to `set_source()`, `read_header()`, `get_output_image_info()`, or
+ * `read_image_data()`).
+ *
+ * @param strip_data The image data to read the rows into. Must not be a view.
+ * @param max_nr_rows The maximum number of rows to read.
+ * @return The number of rows read. 0, if all rows have been read already, or if an error occurred; in the latter case,
+ * the message log contains the respective error message.
+ */
+template <typename SourceType>
+PixelLength JPEGReader<SourceType>::read_rows(ImageData<>& strip_data, PixelLength max_nr_rows)
+{
+  if (rows_finished_ || max_nr_rows <= 0)
+  {
+    return 0_px;
+  }
+
+  const auto output_info = get_output_image_info();
+
+  if (!output_info.is_valid())
+  {
+    reset();
+    rows_finished_ = true;
+    return 0_px;
+  }
+
+  const auto nr_rows = std::min(max_nr_rows, nr_remaining_rows());
+  const auto output_pixel_format = detail::color_space_to_pixel_format(output_info.color_space);
+  const auto output_sample_format = SampleFormat::UnsignedInteger;
+  constexpr auto shrink_to_fit = false;
+
+  strip_data.allocate(output_info.width, nr_rows, output_info.nr_channels, output_info.nr_bytes_per_channel(),
+                      Stride{0}, output_pixel_format, output_sample_format, shrink_to_fit);
+  auto row_pointers = get_row_pointers(strip_data);
+  const auto dec_success = cycle_->decompress_rows(row_pointers, static_cast<std::size_t>(nr_rows));
+
+  if (!dec_success)
+  {
+    reset();
+    rows_finished_ = true;
+    return 0_px;
+  }
+
+  if (cycle_->nr_remaining_rows() == 0)
+  {
+    // Errors at the end of the stream are reported in the message log; the rows read are still valid.
+    cycle_->finish();
+    reset();
+    rows_finished_ = true;
+  }
+
+  return nr_rows;
+}
+
+/** \brief Returns the number of rows of the current image that remain to be read by `read_rows()`.
+ *
+ * @return The number of remaining rows; 0 if decompression of an image has not been started.
+ */
+template <typename SourceType>
+PixelLength JPEGReader<SourceType>::nr_remaining_rows() const
+{
+  return cycle_ ? PixelLength(static_cast<PixelLength::value_type>(cycle_->nr_remaining_rows())) : 0_px;
+}
+
 template <typename SourceType>
 MessageLog& JPEGReader<SourceType>::message_log()
 {
@@ -8,22 +8,151 @@
 #include <selene/img_io/detail/JPEGDetail.hpp>
 
 #include <jpeglib.h>
+#include <jerror.h>
 
+#include <algorithm>
 #include <csetjmp>
 #include <cstdio>
+#include <new>
 #include <stdexcept>
+#include <vector>
 
 namespace sln {
 
 /// \cond INTERNAL
 
+namespace detail {
+
+// Destination manager compressing directly into the vector of a VectorWriter, starting at its current position.
+// The vector is grown as needed, and trimmed to the end of the compressed data once compression is finished.
+struct VectorDestinationManager
+{
+  jpeg_destination_mgr pub;  // needs to be the first member
+  VectorWriter* sink = nullptr;
+  std::size_t start_pos = 0;  // position of the first byte of the JPEG stream in the vector
+  std::size_t original_size = 0;  // size of the vector before compression
+  int quality = 75;  // used for the size estimate
+
+  static void init_destination(j_compress_ptr cinfo);
+  static boolean empty_output_buffer(j_compress_ptr cinfo);
+  static void term_destination(j_compress_ptr cinfo);
+
+  // Resizes the vector to `new_size`, and sets the libjpeg output buffer to the bytes starting at `offset`.
+  static void set_output_buffer(j_compress_ptr cinfo, std::size_t offset, std::size_t new_size);
+};
+
+}  // namespace detail
+
+namespace {
+
+// Returns an estimate of the compressed size of an image, to size the output vector such that it rarely needs to grow.
+// The compressed size of natural images increases steeply towards the highest qualities; the estimate is chosen to be
+// on the generous side (about 1.5-3x for typical photos), since overestimation only costs initializing unused memory.
+std::size_t estimate_compressed_size(const jpeg_compress_struct& cinfo, int quality)
+{
+  const auto nr_samples = std::size_t{cinfo.image_width} * cinfo.image_height
+                          * static_cast<std::size_t>(std::max(cinfo.input_components, 1));
+  const auto q2 = (static_cast<double>(quality) / 100.0) * (static_cast<double>(quality) / 100.0);
+  const auto bytes_per_sample = 0.015 + 0.25 * (q2 * q2) * (q2 * q2);
+  return 1024 + static_cast<std::size_t>(static_cast<double>(nr_samples) * bytes_per_sample);
+}
+
+// Aborts compression of the current image. A vector destination is terminated first, such that the vector is trimmed
+// to the data compressed so far (as a file would contain it).
+void abort_compression(jpeg_compress_struct& cinfo, detail::JPEGErrorManager& error_manager)
+{
+  if (setjmp(error_manager.setjmp_buffer))
+  {
+    goto abort_state;
+  }
+
+  if (cinfo.dest != nullptr && cinfo.dest->term_destination == detail::VectorDestinationManager::term_destination)
+  {
+    cinfo.dest->term_destination(&cinfo);
+  }
+
+abort_state:
+  jpeg_abort_compress(&cinfo);
+}
+
+}  // namespace
+
+namespace detail {
+
+void VectorDestinationManager::set_output_buffer(j_compress_ptr cinfo, std::size_t offset, std::size_t new_size)
+{
+  auto dest = reinterpret_cast<VectorDestinationManager*>(cinfo->dest);
+  auto& data = *dest->sink->handle();
+  bool allocated = true;
+
+  try
+  {
+    data.resize(new_size);
+  }
+  catch (const std::bad_alloc&)
+  {
+    allocated = false;
+  }
+
+  if (!allocated)
+  {
+    cinfo->err->msg_code = JERR_OUT_OF_MEMORY;
+    (*cinfo->err->error_exit)(reinterpret_cast<j_common_ptr>(cinfo));
+  }
+
+  dest->pub.next_output_byte = data.data() + offset;
+  dest->pub.free_in_buffer = new_size - offset;
+}
+
+void VectorDestinationManager::init_destination(j_compress_ptr cinfo)
+{
+  auto dest = reinterpret_cast<VectorDestinationManager*>(cinfo->dest);
+  auto& data = *dest->sink->handle();
+
+  dest->start_pos = static_cast<std::size_t>(dest->sink->position());
+  dest->original_size = data.size();
+
+  const auto size_hint = estimate_compressed_size(*cinfo, dest->quality);
+  set_output_buffer(cinfo, dest->start_pos, std::max(data.size(), dest->start_pos + size_hint));
+}
+
+boolean VectorDestinationManager::empty_output_buffer(j_compress_ptr cinfo)
+{
+  // The output buffer is the whole remainder of the vector, which is full at this point.
+  auto dest = reinterpret_cast<VectorDestinationManager*>(cinfo->dest);
+  const auto size = dest->sink->handle()->size();
+  set_output_buffer(cinfo, size, size + std::max(size - dest->start_pos, std::size_t{4096}));
+  return TRUE;
+}
+
+void VectorDestinationManager::term_destination(j_compress_ptr cinfo)
+{
+  auto dest = reinterpret_cast<VectorDestinationManager*>(cinfo->dest);
+
+  if (dest->pub.next_output_byte == nullptr)  // not initialized, or already terminated
+  {
+    return;
+  }
+
+  auto& data = *dest->sink->handle();
+  const auto end_pos = data.size() - dest->pub.free_in_buffer;
+  data.resize(std::max(dest->original_size, end_pos));  // does not reallocate
+  dest->sink->seek_abs(static_cast<std::ptrdiff_t>(end_pos));
+  dest->pub.next_output_byte = nullptr;
+  dest->pub.free_in_buffer = 0;
+}
+
+}  // namespace detail
+
 struct JPEGCompressionObject::Impl
 {
   jpeg_compress_struct cinfo;
   detail::JPEGErrorManager error_manager;
 
-  unsigned char* output_buffer = nullptr;  // temporary buffer for in-memory decompression
-  unsigned long output_size = 0;  // size of in-memory buffer
+  // libjpeg refuses to switch a compression object between destination managers of different kinds. Hence the stdio
+  // destination manager is kept, and swapped in as needed.
+  jpeg_destination_mgr* stdio_dest = nullptr;
+  detail::VectorDestinationManager vector_dest;
 
   bool valid = false;
   bool needs_reset = false;
@@ -41,12 +170,6 @@ JPEGCompressionObject::JPEGCompressionObject() : impl_(std::make_unique<JPEGComp
 JPEGCompressionObject::~JPEGCompressionObject()
 {
   jpeg_destroy_compress(&impl_->cinfo);
-
-  if (impl_->output_buffer != nullptr)
-  {
-    std::free(impl_->output_buffer);
-    impl_->output_buffer = nullptr;
-  }
 }
 
 void JPEGCompressionObject::reset_if_needed()
@@ -115,6 +238,7 @@ bool JPEGCompressionObject::set_compression_parameters(int quality, JPEGColorSpa
   }
 
   jpeg_set_quality(&impl_->cinfo, quality, force_baseline);
+  impl_->vector_dest.quality = quality;
 
   impl_->cinfo.optimize_coding = (optimize_coding ? TRUE : FALSE);
   return true;
@@ -144,58 +268,119 @@ namespace detail {
 JPEGCompressionCycle::JPEGCompressionCycle(JPEGCompressionObject& obj) : obj_(obj)
 {
   obj_.reset_if_needed();
+
+  if (setjmp(obj_.impl_->error_manager.setjmp_buffer))
+  {
+    goto failure_state;
+  }
+
   jpeg_start_compress(&obj_.impl_->cinfo, TRUE);
+  return;
+
+failure_state:
+  abort_compression(obj_.impl_->cinfo, obj_.impl_->error_manager);
+  error_state_ = true;
+  finished_or_aborted_ = true;
 }
 
 JPEGCompressionCycle::~JPEGCompressionCycle()
 {
-  jpeg_finish_compress(&obj_.impl_->cinfo);
+  // An incompletely written image cannot be finished; its compression is aborted instead.
+  if (!finished_or_aborted_)
+  {
+    abort_compression(obj_.impl_->cinfo, obj_.impl_->error_manager);
+  }
+
   obj_.impl_->needs_reset = true;
 }
 
+bool JPEGCompressionCycle::error_state() const
+{
+  return error_state_;
+}
+
 void JPEGCompressionCycle::compress(const ConstRowPointers& row_pointers)
+{
+  if (compress_rows(row_pointers, row_pointers.size()) && nr_remaining_rows() == 0)
+  {
+    finish();
+  }
+}
+
+std::size_t JPEGCompressionCycle::nr_remaining_rows() const
+{
+  if (finished_or_aborted_)
+  {
+    return 0;
+  }
+
+  const auto& cinfo = obj_.impl_->cinfo;
+  return static_cast<std::size_t>(cinfo.image_height - cinfo.next_scanline);
+}
+
+// Compresses the next `nr_rows` rows (at most) of the image, pointed to by `row_pointers`.
+bool JPEGCompressionCycle::compress_rows(const ConstRowPointers& row_pointers, std::size_t nr_rows)
 {
   auto& cinfo = obj_.impl_->cinfo;
   std::array<JSAMPLE*, 1> row_ptr = {{nullptr}};
+  std::size_t row = 0;
+
+  SELENE_ASSERT(row_pointers.size() >= nr_rows);
+
+  if (finished_or_aborted_)
+  {
+    return false;
+  }
 
   if (setjmp(obj_.impl_->error_manager.setjmp_buffer))
   {
     goto failure_state;
   }
 
-  while (cinfo.next_scanline < cinfo.image_height)
+  for (; row < nr_rows && cinfo.next_scanline < cinfo.image_height; ++row)
   {
-    auto row_ptr_c = row_pointers[cinfo.next_scanline];
     // Hack to accommodate non-const correct API
-    row_ptr[0] = const_cast<JSAMPLE*>(row_ptr_c);
+    row_ptr[0] = const_cast<JSAMPLE*>(row_pointers[row]);
     const auto nr_scanlines_written = jpeg_write_scanlines(&cinfo, row_ptr.data(), 1);
     SELENE_FORCED_ASSERT(nr_scanlines_written == 1);
   }
 
-  return;
+  return true;
 
 failure_state:
-  jpeg_abort_compress(&cinfo);
+  abort_compression(cinfo, obj_.impl_->error_manager);
+  finished_or_aborted_ = true;
+  return false;
 }
 
-// -----------------------------
-// Compression related functions
-
-void set_destination(JPEGCompressionObject& obj, FileWriter& sink)
+bool JPEGCompressionCycle::finish()
 {
-  obj.reset_if_needed();
+  auto& cinfo = obj_.impl_->cinfo;
 
-  if (setjmp(obj.impl_->error_manager.setjmp_buffer))
+  if (finished_or_aborted_)
+  {
+    return false;
+  }
+
+  if (setjmp(obj_.impl_->error_manager.setjmp_buffer))
   {
     goto failure_state;
   }
 
-  jpeg_stdio_dest(&obj.impl_->cinfo, sink.handle());
+  jpeg_finish_compress(&cinfo);
+  finished_or_aborted_ = true;
+  return true;
 
-failure_state:;
+failure_state:
+  abort_compression(cinfo, obj_.impl_->error_manager);
+  finished_or_aborted_ = true;
+  return false;
 }
 
-void set_destination(JPEGCompressionObject& obj, VectorWriter& /*sink*/)
+// -----------------------------
+// Compression related functions
+
+void set_destination(JPEGCompressionObject& obj, FileWriter& sink)
 {
   obj.reset_if_needed();
 
@@ -204,31 +389,32 @@ void set_destination(JPEGCompressionObject& obj, VectorWriter& /*sink*/)
     goto failure_state;
   }
 
-  jpeg_mem_dest(&obj.impl_->cinfo, &obj.impl_->output_buffer, &obj.impl_->output_size);
+  obj.impl_->cinfo.dest = obj.impl_->stdio_dest;
+  jpeg_stdio_dest(&obj.impl_->cinfo, sink.handle());
+  obj.impl_->stdio_dest = obj.impl_->cinfo.dest;
 
 failure_state:;
 }
 
-bool flush_data_buffer(JPEGCompressionObject& /*obj*/, FileWriter& /*sink*/)
+void set_destination(JPEGCompressionObject& obj, VectorWriter& sink)
 {
-  return true;
-}
+  obj.reset_if_needed();
 
-bool flush_data_buffer(JPEGCompressionObject& obj, VectorWriter& sink)
-{
-  if (obj.impl_->output_buffer != nullptr)
+  if (!sink.is_open())
   {
-    const auto buf = static_cast<const std::uint8_t*>(obj.impl_->output_buffer);
-    const auto len = static_cast<std::size_t>(obj.impl_->output_size);
-    const auto nr_written = sink.write(buf, len);
-
-    if (nr_written != static_cast<std::size_t>(obj.impl_->output_size))
-    {
-      return false;
-    }
+    obj.impl_->error_manager.message_log.add_message("Output sink is not open.");
+    obj.impl_->error_manager.error_state = true;
+    return;
   }
 
-  return true;
+  auto& dest = obj.impl_->vector_dest;
+  dest.pub.init_destination = VectorDestinationManager::init_destination;
+  dest.pub.empty_output_buffer = VectorDestinationManager::empty_output_buffer;
+  dest.pub.term_destination = VectorDestinationManager::term_destination;
+  dest.pub.next_output_byte = nullptr;
+  dest.pub.free_in_buffer = 0;
+  dest.sink = &sink;
+  obj.impl_->cinfo.dest = &dest.pub;
 }
 
 }  // namespace detail
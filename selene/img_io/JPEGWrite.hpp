@@ -25,8 +25,10 @@
 #include <selene/io/VectorWriter.hpp>
 
 #include <array>
+#include <cstdint>
 #include <cstdio>
 #include <memory>
+#include <stdexcept>
 
 namespace sln {
 
@@ -36,8 +38,6 @@ namespace detail {
 class JPEGCompressionCycle;
 void set_destination(JPEGCompressionObject&, FileWriter&);
 void set_destination(JPEGCompressionObject&, VectorWriter&);
-bool flush_data_buffer(JPEGCompressionObject&, FileWriter&);
-bool flush_data_buffer(JPEGCompressionObject&, VectorWriter&);
 }  // namespace detail
 
 /** \brief JPEG compression options.
@@ -45,9 +45,9 @@ bool flush_data_buffer(JPEGCompressionObject&, VectorWriter&);
  */
 struct JPEGCompressionOptions
 {
-  const int quality;  ///< Compression quality. May take values from 1 (worst) to 100 (best).
-  const JPEGColorSpace in_color_space;  ///< Color space of the incoming, to-be-compressed data.
-  const JPEGColorSpace jpeg_color_space;  ///< Color space of the compressed data inside the JPEG stream.
+  int quality;  ///< Compression quality. May take values from 1 (worst) to 100 (best).
+  JPEGColorSpace in_color_space;  ///< Color space of the incoming, to-be-compressed data.
+  JPEGColorSpace jpeg_color_space;  ///< Color space of the compressed data inside the JPEG stream.
   bool optimize_coding;  ///< If true, compute optimal Huffman coding tables for the image (more expensive computation).
 
   /** \brief Constructor, setting the respective JPEG compression options.
@@ -99,8 +99,6 @@ private:
   friend class detail::JPEGCompressionCycle;
   friend void detail::set_destination(JPEGCompressionObject&, FileWriter&);
   friend void detail::set_destination(JPEGCompressionObject&, VectorWriter&);
-  friend bool detail::flush_data_buffer(JPEGCompressionObject&, FileWriter&);
-  friend bool detail::flush_data_buffer(JPEGCompressionObject&, VectorWriter&);
 };
 
 
@@ -138,6 +136,57 @@ bool write_jpeg(const ImageData<storage_type>& img_data,
                 JPEGCompressionOptions options = JPEGCompressionOptions(),
                 MessageLog* messages = nullptr);
 
+/** Class with functionality to write a JPEG image data stream strip by strip.
+ *
+ * Generally, the free function write_jpeg() should be preferred, due to ease of use.
+ *
+ * write_jpeg(), however, requires the complete image data to be present in memory. This class allows writing the image
+ * data in strips of consecutive rows instead, e.g. if the rows are generated on the fly. The memory required is then
+ * bounded by the strip size instead of the image size.
+ *
+ * The size and pixel format of the image have to be known beforehand, and are set using `write_header()`.
+ * Subsequently, the image rows are supplied in order by repeatedly calling `write_rows()`. Once the last row has been
+ * supplied, the JPEG stream is completed.
+ *
+ * Multiple images can be written in sequence using the same JPEGWriter<> (on the same thread), by calling
+ * `write_header()` again. If the previous image has not been written completely, it is aborted.
+ *
+ * @tparam SinkType Type of the output sink. Can be FileWriter or VectorWriter.
+ */
+template <typename SinkType>
+class JPEGWriter
+{
+public:
+  JPEGWriter();
+  explicit JPEGWriter(SinkType& sink, JPEGCompressionOptions options = JPEGCompressionOptions());
+
+  void set_sink(SinkType& sink);
+  void set_compression_options(JPEGCompressionOptions options);
+
+  bool write_header(PixelLength width,
+                    PixelLength height,
+                    std::uint16_t nr_channels,
+                    std::uint16_t nr_bytes_per_channel,
+                    PixelFormat pixel_format);
+
+  template <ImageDataStorage storage_type>
+  bool write_rows(const ImageData<storage_type>& strip_data);
+  PixelLength nr_remaining_rows() const;
+
+  MessageLog& message_log();
+
+private:
+  SinkType* sink_;
+  JPEGCompressionOptions options_;
+  JPEGCompressionObject obj_;
+  std::unique_ptr<detail::JPEGCompressionCycle> cycle_;
+  PixelLength width_ = 0_px;
+  std::uint16_t nr_channels_ = 0;
+  std::uint16_t nr_bytes_per_channel_ = 0;
+
+  void reset();
+};
+
 // ----------
 // Implementation:
 
@@ -149,10 +198,17 @@ public:
   explicit JPEGCompressionCycle(JPEGCompressionObject& obj);
   ~JPEGCompressionCycle();
 
+  bool error_state() const;
   void compress(const ConstRowPointers& row_pointers);
 
+  std::size_t nr_remaining_rows() const;
+  bool compress_rows(const ConstRowPointers& row_pointers, std::size_t nr_rows);
+  bool finish();
+
 private:
   JPEGCompressionObject& obj_;
+  bool error_state_ = false;
+  bool finished_or_aborted_ = false;
 };
 
 }  // namespace detail
@@ -176,6 +232,13 @@ bool write_jpeg(const ImageData<storage_type>& img_data,
                 JPEGCompressionOptions options,
                 MessageLog* messages)
 {
+  if (img_data.is_planar() && img_data.nr_channels() > 1)
+  {
+    obj.message_log().add_message("Planar image data with more than one channel cannot be written as JPEG.");
+    detail::assign_message_log(obj, messages);
+    return false;
+  }
+
   detail::set_destination(obj, sink);
 
   if (obj.error_state())
@@ -212,19 +275,192 @@ bool write_jpeg(const ImageData<storage_type>& img_data,
   {
     detail::JPEGCompressionCycle cycle(obj);
     const auto row_pointers = get_row_pointers(img_data);
-    cycle.compress(row_pointers);
-    // Destructor of JPEGCompressionCycle calls jpeg_finish_compress(), which updates internal state
+    cycle.compress(row_pointers);  // calls jpeg_finish_compress(), which updates internal state
   }
 
-  bool flushed = detail::flush_data_buffer(obj, sink);
-  if (!flushed)
+  detail::assign_message_log(obj, messages);
+  return !obj.error_state();
+}
+
+template <typename SinkType>
+JPEGWriter<SinkType>::JPEGWriter()
+    : sink_(nullptr), options_(JPEGCompressionOptions())
+{
+}
+
+template <typename SinkType>
+JPEGWriter<SinkType>::JPEGWriter(SinkType& sink, JPEGCompressionOptions options)
+    : sink_(&sink), options_(options)
+{
+}
+
+/** \brief Sets the output sink. An image that has not been written completely is aborted.
+ *
+ * @param sink Output sink instance.
+ */
+template <typename SinkType>
+void JPEGWriter<SinkType>::set_sink(SinkType& sink)
+{
+  reset();
+  sink_ = &sink;
+}
+
+/** \brief Sets the compression options for the next image to be written.
+ *
+ * @param options The compression options.
+ */
+template <typename SinkType>
+void JPEGWriter<SinkType>::set_compression_options(JPEGCompressionOptions options)
+{
+  if (cycle_)
+  {
+    throw std::runtime_error("JPEGWriter: Cannot call set_compression_options() after call to write_header().");
+  }
+
+  options_ = options;
+}
+
+/** \brief Starts writing a new JPEG image of the specified size and pixel format.
+ *
+ * An image that has not been written completely is aborted.
+ *
+ * @param width The image width.
+ * @param height The image height.
+ * @param nr_channels The number of image channels.
+ * @param nr_bytes_per_channel The number of bytes per channel. Needs to be 1.
+ * @param pixel_format The pixel format of the image data to be supplied.
+ * @return True, if the image stream was started successfully; false otherwise.
+ */
+template <typename SinkType>
+bool JPEGWriter<SinkType>::write_header(PixelLength width,
+                                        PixelLength height,
+                                        std::uint16_t nr_channels,
+                                        std::uint16_t nr_bytes_per_channel,
+                                        PixelFormat pixel_format)
+{
+  reset();
+
+  if (sink_ == nullptr)
   {
-    detail::assign_message_log(obj, messages);
     return false;
   }
 
-  detail::assign_message_log(obj, messages);
-  return !obj.error_state();
+  detail::set_destination(obj_, *sink_);
+
+  if (obj_.error_state())
+  {
+    return false;
+  }
+
+  const auto in_color_space = (options_.in_color_space == JPEGColorSpace::Auto)
+                                  ? detail::pixel_format_to_color_space(pixel_format)
+                                  : options_.in_color_space;
+
+  const auto img_info_set = obj_.set_image_info(static_cast<int>(width), static_cast<int>(height),
+                                                static_cast<int>(nr_channels), static_cast<int>(nr_bytes_per_channel),
+                                                in_color_space);
+
+  if (!img_info_set)
+  {
+    return false;
+  }
+
+  const bool pars_set = obj_.set_compression_parameters(options_.quality, options_.jpeg_color_space,
+                                                        options_.optimize_coding);
+
+  if (!pars_set)
+  {
+    return false;
+  }
+
+  cycle_ = std::make_unique<detail::JPEGCompressionCycle>(obj_);
+
+  if (cycle_->error_state())
+  {
+    reset();
+    return false;
+  }
+
+  width_ = width;
+  nr_channels_ = nr_channels;
+  nr_bytes_per_channel_ = nr_bytes_per_channel;
+  return true;
+}
+
+/** \brief Writes the next rows of the image, i.e. the next strip of the image.
+ *
+ * The strip has to match the width and the number of channels set by `write_header()`, and may not contain more rows
+ * than remain to be written. If it contains the last row of the image, the JPEG stream is completed.
+ *
+ * @param strip_data The image data containing the rows to be written.
+ * @return True, if the rows were written successfully; false otherwise. In the latter case, the message log contains
+ * the respective error message; an image stream that failed to be written is aborted.
+ */
+template <typename SinkType>
+template <ImageDataStorage storage_type>
+bool JPEGWriter<SinkType>::write_rows(const ImageData<storage_type>& strip_data)
+{
+  if (!cycle_)
+  {
+    obj_.message_log().add_message("JPEGWriter: write_header() needs to be called before write_rows().");
+    return false;
+  }
+
+  if (strip_data.width() != width_ || strip_data.nr_channels() != nr_channels_
+      || strip_data.nr_bytes_per_channel() != nr_bytes_per_channel_ || strip_data.height() > nr_remaining_rows())
+  {
+    obj_.message_log().add_message("JPEGWriter: Image data strip does not match the image to be written.");
+    return false;
+  }
+
+  if (strip_data.is_planar() && strip_data.nr_channels() > 1)
+  {
+    obj_.message_log().add_message("JPEGWriter: Planar image data with more than one channel cannot be written.");
+    return false;
+  }
+
+  const auto row_pointers = get_row_pointers(strip_data);
+
+  if (!cycle_->compress_rows(row_pointers, row_pointers.size()))
+  {
+    reset();
+    return false;
+  }
+
+  if (cycle_->nr_remaining_rows() > 0)
+  {
+    return true;
+  }
+
+  const auto finished = cycle_->finish();
+  reset();
+  return finished && !obj_.error_state();
+}
+
+/** \brief Returns the number of rows of the current image that remain to be written by `write_rows()`.
+ *
+ * @return The number of remaining rows; 0 if no image is currently being written.
+ */
+template <typename SinkType>
+PixelLength JPEGWriter<SinkType>::nr_remaining_rows() const
+{
+  return cycle_ ? PixelLength(static_cast<PixelLength::value_type>(cycle_->nr_remaining_rows())) : 0_px;
+}
+
+template <typename SinkType>
+MessageLog& JPEGWriter<SinkType>::message_log()
+{
+  return obj_.message_log();
+}
+
+template <typename SinkType>
+void JPEGWriter<SinkType>::reset()
+{
+  // reset internal state; aborts an incomplete image
+  cycle_ = nullptr;
+  width_ = 0_px;
+  nr_channels_ = 0;
+  nr_bytes_per_channel_ = 0;
 }
 
 }  // namespace sln
@@ -9,6 +9,7 @@
 #include <selene/img_io/PNGRead.hpp>
 #include <selene/img_io/detail/PNGDetail.hpp>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstdio>
@@ -54,6 +55,7 @@ struct PNGDecompressionObject::Impl
   PixelFormat pixel_format_ = PixelFormat::Unknown;
   bool valid = false;
   bool needs_reset = false;
+  bool header_read = false;
 };
 
 PNGDecompressionObject::PNGDecompressionObject() : impl_(std::make_unique<PNGDecompressionObject::Impl>())
@@ -131,6 +133,20 @@ void PNGDecompressionObject::reset_if_needed()
   }
 }
 
+// Prepares the object for reading from a new source. libpng offers no way to return a png_struct to its start state,
+// so the structures are recreated if they have been used already (e.g. if only the header of the previous stream was
+// read).
+void PNGDecompressionObject::restart()
+{
+  if (impl_->needs_reset || impl_->header_read)
+  {
+    deallocate();
+    allocate();
+    impl_->needs_reset = false;
+    impl_->header_read = false;
+  }
+}
+
 bool PNGDecompressionObject::valid() const
 {
   return impl_->valid;
@@ -447,6 +463,11 @@ bool PNGDecompressionCycle::decompress(RowPointers& row_pointers)
   auto png_ptr = obj_.impl_->png_ptr;
   auto end_info = obj_.impl_->end_info;
 
+  if (finished_or_aborted_)
+  {
+    return false;
+  }
+
   if (setjmp(png_jmpbuf(png_ptr)))
   {
     goto failure_state;
@@ -454,20 +475,97 @@ bool PNGDecompressionCycle::decompress(RowPointers& row_pointers)
 
   // Read PNG image in one go
   png_read_image(png_ptr, row_pointers.data());
+  next_row_ = png_get_image_height(png_ptr, obj_.impl_->info_ptr);
   // Read comment or time chunks
   // TODO: Make use of these
 
   png_read_end(png_ptr, end_info);
+  finished_or_aborted_ = true;
+
+  return true;
+
+failure_state:
+  finished_or_aborted_ = true;
+  return false;
+}
+
+std::size_t PNGDecompressionCycle::nr_remaining_rows() const
+{
+  if (finished_or_aborted_)
+  {
+    return 0;
+  }
+
+  const auto height = static_cast<std::size_t>(png_get_image_height(obj_.impl_->png_ptr, obj_.impl_->info_ptr));
+  return height - next_row_;
+}
+
+// Decompresses the next `nr_rows` rows (at most) of the image into the rows pointed to by `row_pointers`.
+// Interlaced images are not supported, since their rows are only complete after the last pass.
+bool PNGDecompressionCycle::decompress_rows(RowPointers& row_pointers, std::size_t nr_rows)
+{
+  auto png_ptr = obj_.impl_->png_ptr;
+  auto info_ptr = obj_.impl_->info_ptr;
+
+  SELENE_ASSERT(row_pointers.size() >= nr_rows);
+
+  if (finished_or_aborted_)
+  {
+    return false;
+  }
+
+  if (png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE)
+  {
+    obj_.impl_->error_manager.message_log.add_message("Interlaced PNG images cannot be decompressed row by row.");
+    finished_or_aborted_ = true;
+    return false;
+  }
+
+  nr_rows = std::min(nr_rows, nr_remaining_rows());
+
+  if (setjmp(png_jmpbuf(png_ptr)))
+  {
+    goto failure_state;
+  }
+
+  png_read_rows(png_ptr, row_pointers.data(), nullptr, static_cast<png_uint_32>(nr_rows));
+  next_row_ += nr_rows;
 
   return true;
 
 failure_state:
+  finished_or_aborted_ = true;
+  return false;
+}
+
+bool PNGDecompressionCycle::finish()
+{
+  auto png_ptr = obj_.impl_->png_ptr;
+  auto end_info = obj_.impl_->end_info;
+
+  if (finished_or_aborted_)
+  {
+    return false;
+  }
+
+  if (setjmp(png_jmpbuf(png_ptr)))
+  {
+    goto failure_state;
+  }
+
+  png_read_end(png_ptr, end_info);
+  finished_or_aborted_ = true;
+  return true;
+
+failure_state:
+  finished_or_aborted_ = true;
   return false;
 }
 
 // -------------------------------
 // Decompression related functions
 
+template <typename SourceType>
 void user_read_data(png_structp png_ptr, png_bytep data, png_size_t length)
 {
   void* io_ptr = png_get_io_ptr(png_ptr);
@@ -477,7 +575,7 @@ void user_read_data(png_structp png_ptr, png_bytep data, png_size_t length)
     detail::error_handler(png_ptr, "[selene] png_get_io_ptr() failed");
   }
 
-  auto reader = static_cast<MemoryReader*>(io_ptr);
+  auto reader = static_cast<SourceType*>(io_ptr);
   SELENE_ASSERT(reader);
 
   if (static_cast<png_size_t>(reader->bytes_remaining()) < length)
@@ -491,7 +589,7 @@ void user_read_data(png_structp png_ptr, png_bytep data, png_size_t length)
 
 void set_source(PNGDecompressionObject& obj, FileReader& source)
 {
-  obj.reset_if_needed();
+  obj.restart();
 
   if (setjmp(png_jmpbuf(obj.impl_->png_ptr)))
   {
@@ -505,14 +603,28 @@ failure_state:;
 
 void set_source(PNGDecompressionObject& obj, MemoryReader& source)
 {
-  obj.reset_if_needed();
+  obj.restart();
+
+  if (setjmp(png_jmpbuf(obj.impl_->png_ptr)))
+  {
+    goto failure_state;
+  }
+
+  png_set_read_fn(obj.impl_->png_ptr, static_cast<png_voidp>(&source), user_read_data<MemoryReader>);
+
+failure_state:;
+}
+
+void set_source(PNGDecompressionObject& obj, MMapReader& source)
+{
+  obj.restart();
 
   if (setjmp(png_jmpbuf(obj.impl_->png_ptr)))
   {
     goto failure_state;
   }
 
-  png_set_read_fn(obj.impl_->png_ptr, static_cast<png_voidp>(&source), user_read_data);
+  png_set_read_fn(obj.impl_->png_ptr, static_cast<png_voidp>(&source), user_read_data<MMapReader>);
 
 failure_state:;
 }
@@ -520,6 +632,7 @@ failure_state:;
 PNGImageInfo read_header_info(PNGDecompressionObject& obj, const std::array<std::uint8_t, 8>& header_bytes, bool eof)
 {
   obj.reset_if_needed();
+  obj.impl_->header_read = true;
 
   auto png_ptr = obj.impl_->png_ptr;
   auto info_ptr = obj.impl_->info_ptr;
@@ -582,6 +695,15 @@ PNGImageInfo read_header(MemoryReader& source, PNGDecompressionObject& obj)
   return read_header_info(obj, header_bytes, source.is_eof());
 }
 
+PNGImageInfo read_header(MMapReader& source, PNGDecompressionObject& obj)
+{
+  // Check if the file is a PNG file (look at first 8 bytes)
+  std::array<std::uint8_t, 8> header_bytes;
+  source.template read<std::uint8_t>(header_bytes.data(), 8);
+
+  return read_header_info(obj, header_bytes, source.is_eof());
+}
+
 }  // namespace detail
 
 
@@ -15,12 +15,14 @@
 #include <selene/base/Utils.hpp>
 
 #include <selene/img/BoundingBox.hpp>
+#include <selene/img/ImageBufferPool.hpp>
 #include <selene/img/ImageData.hpp>
 #include <selene/img/PixelFormat.hpp>
 #include <selene/img/RowPointers.hpp>
 #include <selene/img_io/detail/Util.hpp>
 
 #include <selene/io/FileReader.hpp>
+#include <selene/io/MMapReader.hpp>
 #include <selene/io/MemoryReader.hpp>
 
 #include <array>
@@ -37,9 +39,11 @@ namespace detail {
 class PNGDecompressionCycle;
 void set_source(PNGDecompressionObject&, FileReader&);
 void set_source(PNGDecompressionObject&, MemoryReader&);
+void set_source(PNGDecompressionObject&, MMapReader&);
 PNGImageInfo read_header_info(PNGDecompressionObject&, const std::array<std::uint8_t, 8>&, bool);
 PNGImageInfo read_header(FileReader&, PNGDecompressionObject&);
 PNGImageInfo read_header(MemoryReader&, PNGDecompressionObject&);
+PNGImageInfo read_header(MMapReader&, PNGDecompressionObject&);
 }  // namespace detail
 
 /** \brief PNG image information, containing the image size, the number of channels, and the bit depth.
@@ -141,16 +145,18 @@ private:
   void allocate();
   void deallocate();
   void reset_if_needed();
+  void restart();
 
   friend class detail::PNGDecompressionCycle;
   friend void detail::set_source(PNGDecompressionObject&, FileReader&);
   friend void detail::set_source(PNGDecompressionObject&, MemoryReader&);
+  friend void detail::set_source(PNGDecompressionObject&, MMapReader&);
   friend PNGImageInfo detail::read_header_info(PNGDecompressionObject&, const std::array<std::uint8_t, 8>&, bool);
 };
 
 /** \brief Reads header of PNG image data stream.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  * @param source Input source instance.
  * @param rewind If true, the source position will be re-set to the original position after reading the header.
  * @param messages Optional pointer to the message log. If provided, warning and error messages will be output there.
@@ -163,7 +169,7 @@ PNGImageInfo read_png_header(SourceType&& source, bool rewind = false, MessageLo
  *
  * This function overload enables re-use of a PNGDecompressionObject instance.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  * @param obj A PNGDecompressionObject instance.
  * @param source Input source instance.
  * @param rewind If true, the source position will be re-set to the original position after reading the header.
@@ -181,7 +187,7 @@ PNGImageInfo read_png_header(PNGDecompressionObject& obj,
  * The source position must be set to the beginning of the PNG stream, including header. In case img::read_png_header
  * is called before, then it must be with `rewind == true`.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  * @param source Input source instance.
  * @param options The decompression options.
  * @param messages Optional pointer to the message log. If provided, warning and error messages will be output there.
@@ -201,7 +207,7 @@ ImageData<> read_png(SourceType&& source,
  *
  * This function overload enables re-use of a PNGDecompressionObject instance.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  * @param obj A PNGDecompressionObject instance.
  * @param source Input source instance.
  * @param options The decompression options.
@@ -217,6 +223,29 @@ ImageData<> read_png(PNGDecompressionObject& obj,
                      MessageLog* messages = nullptr,
                      const PNGImageInfo* provided_header_info = nullptr);
 
+/** \brief Reads contents of a PNG image data stream into memory acquired from a buffer pool.
+ *
+ * The source position must be set to the beginning of the PNG stream, including header.
+ *
+ * This function overload enables re-use of a PNGDecompressionObject instance, as well as of the memory for the
+ * decompressed image data.
+ *
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
+ * @param obj A PNGDecompressionObject instance.
+ * @param source Input source instance.
+ * @param buffer_pool The pool to acquire the memory for the decompressed image data from.
+ * @param options The decompression options.
+ * @param messages Optional pointer to the message log. If provided, warning and error messages will be output there.
+ * @return A `PooledImageData` instance. Reading the PNG stream was successful, if `is_valid() == true`, and
+ * unsuccessful otherwise.
+ */
+template <typename SourceType>
+PooledImageData read_png(PNGDecompressionObject& obj,
+                         SourceType&& source,
+                         ImageBufferPool& buffer_pool,
+                         PNGDecompressionOptions options = PNGDecompressionOptions(),
+                         MessageLog* messages = nullptr);
+
 /** Class with functionality to read header and data of a PNG image data stream.
  *
  * Generally, the free functions read_png() or read_png_header() should be preferred, due to ease of use.
@@ -234,7 +263,12 @@ ImageData<> read_png(PNGDecompressionObject& obj,
  * The source may optionally be re-set using `set_source()`; this is required if the previous image has not been read
  * completely or successfully.
  *
- * @tparam SourceType Type of the input source. Can be FileReader or MemoryReader.
+ * Alternatively, the image data can be read in strips of consecutive rows, by repeatedly calling
+ * `read_rows(ImageData<>&, PixelLength)`. This bounds the memory required for decompression by the strip size instead
+ * of the image size, e.g. for very large images which are processed strip by strip.
+ * Interlaced PNG images cannot be read in strips, since each of their rows is only complete after the last pass.
+ *
+ * @tparam SourceType Type of the input source. Can be FileReader, MemoryReader, or MMapReader.
  */
 template <typename SourceType>
 class PNGReader
@@ -252,6 +286,9 @@ public:
   ImageData<> read_image_data();
   bool read_image_data(ImageData<>& img_data);
 
+  PixelLength read_rows(ImageData<>& strip_data, PixelLength max_nr_rows);
+  PixelLength nr_remaining_rows() const;
+
   MessageLog& message_log();
 
 private:
@@ -261,6 +298,7 @@ private:
   mutable std::unique_ptr<detail::PNGDecompressionCycle> cycle_;
   bool header_read_ = false;
   bool valid_header_read_ = false;
+  bool rows_finished_ = false;
 
   void reset();
 };
@@ -281,9 +319,15 @@ public:
   PNGImageInfo get_output_info() const;
   bool decompress(RowPointers& row_pointers);
 
+  std::size_t nr_remaining_rows() const;
+  bool decompress_rows(RowPointers& row_pointers, std::size_t nr_rows);
+  bool finish();
+
 private:
   PNGDecompressionObject& obj_;
   bool error_state_;
+  bool finished_or_aborted_ = false;
+  std::size_t next_row_ = 0;
 };
 
 }  // namespace detail
@@ -332,12 +376,17 @@ ImageData<> read_png(SourceType&& source, PNGDecompressionOptions options, Messa
   return read_png(obj, std::forward<SourceType>(source), options, messages);
 }
 
-template <typename SourceType>
-ImageData<> read_png(PNGDecompressionObject& obj,
-                     SourceType&& source,
-                     PNGDecompressionOptions options,
-                     MessageLog* messages,
-                     const PNGImageInfo* provided_header_info)
+namespace detail {
+
+// Decompresses the PNG stream into the image data returned by `get_output`, which is called with the output image
+// parameters once these are known.
+template <typename SourceType, typename OutputFunction>
+bool read_png_data(PNGDecompressionObject& obj,
+                   SourceType& source,
+                   PNGDecompressionOptions options,
+                   MessageLog* messages,
+                   const PNGImageInfo* provided_header_info,
+                   OutputFunction get_output)
 {
   if (!provided_header_info)
   {
@@ -346,7 +395,7 @@ ImageData<> read_png(PNGDecompressionObject& obj,
     if (obj.error_state())
     {
       detail::assign_message_log(obj, messages);
-      return ImageData<>();
+      return false;
     }
   }
 
@@ -355,7 +404,7 @@ ImageData<> read_png(PNGDecompressionObject& obj,
   if (!header_info.is_valid())
   {
     detail::assign_message_log(obj, messages);
-    return ImageData<>();
+    return false;
   }
 
   const bool pars_set = obj.set_decompression_parameters(
@@ -366,7 +415,7 @@ ImageData<> read_png(PNGDecompressionObject& obj,
   if (!pars_set)
   {
     detail::assign_message_log(obj, messages);
-    return ImageData<>();
+    return false;
   }
 
   detail::PNGDecompressionCycle cycle(obj);
@@ -374,7 +423,7 @@ ImageData<> read_png(PNGDecompressionObject& obj,
   if (cycle.error_state())
   {
     detail::assign_message_log(obj, messages);
-    return ImageData<>();
+    return false;
   }
 
   const auto output_info = cycle.get_output_info();
@@ -383,25 +432,68 @@ ImageData<> read_png(PNGDecompressionObject& obj,
   const auto output_nr_channels = output_info.nr_channels;
   const auto output_bit_depth = output_info.bit_depth;
   const auto output_nr_bytes_per_channel = output_bit_depth >> 3;
-  const auto output_stride_bytes = Stride{0};  // will be chosen s.t. image content is tightly packed
   const auto output_pixel_format = obj.get_pixel_format();
   const auto output_sample_format = SampleFormat::UnsignedInteger;
 
-  ImageData<> img(output_width, output_height, static_cast<std::uint16_t>(output_nr_channels),
-                  static_cast<std::uint8_t>(output_nr_bytes_per_channel), output_stride_bytes, output_pixel_format,
-                  output_sample_format);
+  auto& img = get_output(output_width, output_height, static_cast<std::uint16_t>(output_nr_channels),
+                         static_cast<std::uint16_t>(output_nr_bytes_per_channel), output_pixel_format,
+                         output_sample_format);
   auto row_pointers = get_row_pointers(img);
   const auto dec_success = cycle.decompress(row_pointers);
 
-  if (!dec_success)
+  detail::assign_message_log(obj, messages);
+  return dec_success;
+}
+
+}  // namespace detail
+
+template <typename SourceType>
+ImageData<> read_png(PNGDecompressionObject& obj,
+                     SourceType&& source,
+                     PNGDecompressionOptions options,
+                     MessageLog* messages,
+                     const PNGImageInfo* provided_header_info)
+{
+  ImageData<> img;
+  const auto allocate = [&img](PixelLength width, PixelLength height, std::uint16_t nr_channels,
+                               std::uint16_t nr_bytes_per_channel, PixelFormat pixel_format,
+                               SampleFormat sample_format) -> ImageData<>& {
+    // The stride will be chosen s.t. image content is tightly packed
+    img.allocate(width, height, nr_channels, nr_bytes_per_channel, Stride{0}, pixel_format, sample_format);
+    return img;
+  };
+
+  if (!detail::read_png_data(obj, source, options, messages, provided_header_info, allocate))
   {
     img.clear();  // invalidates image data
   }
 
-  detail::assign_message_log(obj, messages);
   return img;
 }
 
+template <typename SourceType>
+PooledImageData read_png(PNGDecompressionObject& obj,
+                         SourceType&& source,
+                         ImageBufferPool& buffer_pool,
+                         PNGDecompressionOptions options,
+                         MessageLog* messages)
+{
+  PooledImageData img;
+  const auto acquire = [&img, &buffer_pool](PixelLength width, PixelLength height, std::uint16_t nr_channels,
+                                            std::uint16_t nr_bytes_per_channel, PixelFormat pixel_format,
+                                            SampleFormat sample_format) -> ImageData<>& {
+    img = buffer_pool.acquire_image_data(width, height, nr_channels, nr_bytes_per_channel, pixel_format,
+                                         sample_format);
+    return img.image_data();
+  };
+
+  if (!detail::read_png_data(obj, source, options, messages, nullptr, acquire))
+  {
+    img.clear();  // invalidates image data, and returns the memory to the pool
+  }
+
+  return img;
+}
 
 
 template <typename SourceType>
@@ -421,6 +513,7 @@ template <typename SourceType>
 void PNGReader<SourceType>::set_source(SourceType& source)
 {
   reset();
+  rows_finished_ = false;
   source_ = &source;
   detail::set_source(obj_, source);
 }
@@ -438,6 +531,7 @@ PNGImageInfo PNGReader<SourceType>::read_header()
     throw std::runtime_error("PNGReader: Cannot call read_header() after call to get_output_image_info() or read_image_data().");
   }
 
+  rows_finished_ = false;
   const PNGImageInfo header_info = detail::read_header(*source_, obj_);
   header_read_ = true;
   valid_header_read_ = header_info.is_valid();
@@ -537,6 +631,76 @@ bool PNGReader<SourceType>::read_image_data(ImageData<>& img_data)
   return true;
 }
 
+/** \brief Reads the next rows of the image data, i.e. the next strip of the image.
+ *
+ * Header reading and the setup of the decompression happen on the first call, if not done before.
+ * `strip_data` is allocated to hold `min(max_nr_rows, nr_remaining_rows())` tightly packed rows; its memory is reused
+ * between calls, as long as it suffices.
+ *
+ * Once all rows of the image have been read, decompression of the image is finished, and subsequent calls return 0
+ * until the next image is started (by a call to `set_source()`, `read_header()`, `get_output_image_info()`, or
+ * `read_image_data()`).
+ *
+ * @param strip_data The image data to read the rows into. Must not be a view.
+ * @param max_nr_rows The maximum number of rows to read.
+ * @return The number of rows read. 0, if all rows have been read already, or if an error occurred; in the latter case,
+ * the message log contains the respective error message.
+ */
+template <typename SourceType>
+PixelLength PNGReader<SourceType>::read_rows(ImageData<>& strip_data, PixelLength max_nr_rows)
+{
+  if (rows_finished_ || max_nr_rows <= 0)
+  {
+    return 0_px;
+  }
+
+  const auto output_info = get_output_image_info();
+
+  if (!output_info.is_valid())
+  {
+    reset();
+    rows_finished_ = true;
+    return 0_px;
+  }
+
+  const auto nr_rows = std::min(max_nr_rows, nr_remaining_rows());
+  const auto output_pixel_format = obj_.get_pixel_format();
+  const auto output_sample_format = SampleFormat::UnsignedInteger;
+  constexpr auto shrink_to_fit = false;
+
+  strip_data.allocate(output_info.width, nr_rows, output_info.nr_channels, output_info.nr_bytes_per_channel(),
+                      Stride{0}, output_pixel_format, output_sample_format, shrink_to_fit);
+  auto row_pointers = get_row_pointers(strip_data);
+  const auto dec_success = cycle_->decompress_rows(row_pointers, static_cast<std::size_t>(nr_rows));
+
+  if (!dec_success)
+  {
+    reset();
+    rows_finished_ = true;
+    return 0_px;
+  }
+
+  if (cycle_->nr_remaining_rows() == 0)
+  {
+    // Errors at the end of the stream are reported in the message log; the rows read are still valid.
+    cycle_->finish();
+    reset();
+    rows_finished_ = true;
+  }
+
+  return nr_rows;
+}
+
+/** \brief Returns the number of rows of the current image that remain to be read by `read_rows()`.
+ *
+ * @return The number of remaining rows; 0 if decompression of an image has not been started.
+ */
+template <typename SourceType>
+PixelLength PNGReader<SourceType>::nr_remaining_rows() const
+{
+  return cycle_ ? PixelLength(static_cast<PixelLength::value_type>(cycle_->nr_remaining_rows())) : 0_px;
+}
+
 template <typename SourceType>
 MessageLog& PNGReader<SourceType>::message_log()
 {
@@ -5,15 +5,21 @@
 #if defined(SELENE_WITH_LIBPNG)
 
 #include <png.h>
+#include <zlib.h>
 
 #include <selene/base/Utils.hpp>
 #include <selene/img_io/PNGWrite.hpp>
 #include <selene/img_io/detail/PNGDetail.hpp>
 
+#include <selene/thread/Parallel.hpp>
+
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <stdexcept>
+#include <vector>
 
 namespace sln {
 
@@ -39,6 +45,532 @@ int determine_color_type(PixelFormat pixel_format)
   }
 }
 
+int zlib_strategy(PNGCompressionStrategy strategy)
+{
+  switch (strategy)
+  {
+    case PNGCompressionStrategy::Filtered: return Z_FILTERED;
+    case PNGCompressionStrategy::HuffmanOnly: return Z_HUFFMAN_ONLY;
+    case PNGCompressionStrategy::RLE: return Z_RLE;
+    case PNGCompressionStrategy::Fixed: return Z_FIXED;
+    default: return Z_DEFAULT_STRATEGY;
+  }
+}
+
+bool check_color_type(int color_type, int nr_channels, MessageLog& message_log)
+{
+  if (color_type == PNG_COLOR_TYPE_INVALID)
+  {
+    message_log.add_message("Cannot determine PNG color type from pixel format of image data");
+    return false;
+  }
+
+  if ((color_type == PNG_COLOR_TYPE_GRAY && nr_channels != 1)
+      || (color_type == PNG_COLOR_TYPE_GRAY_ALPHA && nr_channels != 2)
+      || (color_type == PNG_COLOR_TYPE_RGB && nr_channels != 3)
+      || (color_type == PNG_COLOR_TYPE_RGB_ALPHA && nr_channels != 4))
+  {
+    message_log.add_message("Mismatch between determined PNG color type and nr of channels");
+    return false;
+  }
+
+  return true;
+}
+
+// ----------------------
+// Parallel compression
+
+constexpr std::size_t parallel_block_bytes = std::size_t{256} * 1024;  // targeted (filtered) data size of a row block
+constexpr std::size_t zlib_header_bytes = 2;
+
+constexpr std::array<std::uint8_t, 8> png_signature = {{0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A}};
+constexpr std::array<std::uint8_t, 4> idat_chunk_type = {{0x49, 0x44, 0x41, 0x54}};
+constexpr std::array<std::uint8_t, 12> iend_chunk = {
+    {0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82}};
+
+struct RowLayout
+{
+  std::size_t row_bytes;
+  std::size_t pixel_bytes;
+  std::size_t channel_bytes;
+  int color_type;
+};
+
+// The pixel transformations applied by the libpng write path (png_set_bgr, png_set_invert_alpha, png_set_invert_mono),
+// restricted to the color types that libpng applies them to.
+struct RowTransformation
+{
+  bool swap_red_blue;
+  bool invert_alpha;
+  bool invert_gray;
+
+  RowTransformation(const PNGCompressionOptions& options, int color_type)
+      : swap_red_blue(options.set_bgr && (color_type == PNG_COLOR_TYPE_RGB || color_type == PNG_COLOR_TYPE_RGB_ALPHA))
+      , invert_alpha(options.invert_alpha_channel
+                     && (color_type == PNG_COLOR_TYPE_RGB_ALPHA || color_type == PNG_COLOR_TYPE_GRAY_ALPHA))
+      , invert_gray(options.invert_monochrome
+                    && (color_type == PNG_COLOR_TYPE_GRAY || color_type == PNG_COLOR_TYPE_GRAY_ALPHA))
+  {
+  }
+
+  bool active() const
+  {
+    return swap_red_blue || invert_alpha || invert_gray;
+  }
+
+  // Returns a pointer to the (possibly transformed) row; `buffer` needs to provide space for one row.
+  const std::uint8_t* apply(const std::uint8_t* row, const RowLayout& layout, std::uint8_t* buffer) const
+  {
+    if (!active())
+    {
+      return row;
+    }
+
+    std::copy(row, row + layout.row_bytes, buffer);
+    const auto cb = layout.channel_bytes;
+
+    for (auto px = buffer; px < buffer + layout.row_bytes; px += layout.pixel_bytes)
+    {
+      if (swap_red_blue)
+      {
+        std::swap_ranges(px, px + cb, px + 2 * cb);
+      }
+
+      if (invert_alpha)
+      {
+        std::transform(px + layout.pixel_bytes - cb, px + layout.pixel_bytes, px + layout.pixel_bytes - cb,
+                       [](std::uint8_t v) { return static_cast<std::uint8_t>(~v); });
+      }
+
+      if (invert_gray)
+      {
+        std::transform(px, px + cb, px, [](std::uint8_t v) { return static_cast<std::uint8_t>(~v); });
+      }
+    }
+
+    return buffer;
+  }
+};
+
+inline std::uint8_t paeth_predictor(int a, int b, int c)
+{
+  const auto p = a + b - c;
+  const auto pa = std::abs(p - a);
+  const auto pb = std::abs(p - b);
+  const auto pc = std::abs(p - c);
+  return static_cast<std::uint8_t>((pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c));
+}
+
+// Writes the filter type byte, followed by the row filtered with the respective filter type, to `dst`.
+void apply_filter(int filter_type,
+                  const std::uint8_t* row,
+                  const std::uint8_t* prev,
+                  std::size_t row_bytes,
+                  std::size_t bpp,
+                  std::uint8_t* dst)
+{
+  *dst++ = static_cast<std::uint8_t>(filter_type);
+  const auto n0 = std::min(bpp, row_bytes);
+
+  switch (filter_type)
+  {
+    case PNG_FILTER_VALUE_NONE:
+      std::copy(row, row + row_bytes, dst);
+      break;
+    case PNG_FILTER_VALUE_SUB:
+      std::copy(row, row + n0, dst);
+      for (std::size_t i = n0; i < row_bytes; ++i)
+      {
+        dst[i] = static_cast<std::uint8_t>(row[i] - row[i - bpp]);
+      }
+      break;
+    case PNG_FILTER_VALUE_UP:
+      for (std::size_t i = 0; i < row_bytes; ++i)
+      {
+        dst[i] = static_cast<std::uint8_t>(row[i] - prev[i]);
+      }
+      break;
+    case PNG_FILTER_VALUE_AVG:
+      for (std::size_t i = 0; i < n0; ++i)
+      {
+        dst[i] = static_cast<std::uint8_t>(row[i] - (prev[i] >> 1));
+      }
+      for (std::size_t i = n0; i < row_bytes; ++i)
+      {
+        dst[i] = static_cast<std::uint8_t>(row[i] - ((row[i - bpp] + prev[i]) >> 1));
+      }
+      break;
+    case PNG_FILTER_VALUE_PAETH:
+      for (std::size_t i = 0; i < n0; ++i)
+      {
+        dst[i] = static_cast<std::uint8_t>(row[i] - prev[i]);
+      }
+      for (std::size_t i = n0; i < row_bytes; ++i)
+      {
+        dst[i] = static_cast<std::uint8_t>(row[i] - paeth_predictor(row[i - bpp], prev[i], prev[i - bpp]));
+      }
+      break;
+    default:
+      SELENE_ASSERT(false);
+  }
+}
+
+// Sum of the filtered bytes, interpreted as signed values; the filter selection heuristic used by libpng.
+std::size_t filter_cost(const std::uint8_t* filtered, std::size_t row_bytes)
+{
+  std::size_t sum = 0;
+
+  for (std::size_t i = 0; i < row_bytes; ++i)
+  {
+    sum += (filtered[i] < 128) ? filtered[i] : 256 - filtered[i];
+  }
+
+  return sum;
+}
+
+// Filters a row, choosing the filter type adaptively from the set `filters` (a non-empty combination of PNG_FILTER_*
+// flags). `dst` and `scratch` need to provide space for the filter type byte and the row.
+void filter_row(const std::uint8_t* row,
+                const std::uint8_t* prev,
+                const RowLayout& layout,
+                int filters,
+                std::uint8_t* dst,
+                std::uint8_t* scratch)
+{
+  const auto filter_flag = [](int filter_type) { return PNG_FILTER_NONE << filter_type; };
+
+  auto first_type = PNG_FILTER_VALUE_NONE;
+  while ((filters & filter_flag(first_type)) == 0)
+  {
+    ++first_type;
+  }
+
+  apply_filter(first_type, row, prev, layout.row_bytes, layout.pixel_bytes, dst);
+
+  if (filters == filter_flag(first_type))
+  {
+    return;
+  }
+
+  auto best_cost = filter_cost(dst + 1, layout.row_bytes);
+
+  for (int filter_type = first_type + 1; filter_type <= PNG_FILTER_VALUE_PAETH; ++filter_type)
+  {
+    if ((filters & filter_flag(filter_type)) == 0)
+    {
+      continue;
+    }
+
+    apply_filter(filter_type, row, prev, layout.row_bytes, layout.pixel_bytes, scratch);
+    const auto cost = filter_cost(scratch + 1, layout.row_bytes);
+
+    if (cost < best_cost)
+    {
+      best_cost = cost;
+      std::copy(scratch, scratch + layout.row_bytes + 1, dst);
+    }
+  }
+}
+
+// One block of consecutive rows, compressed to a part of the zlib stream.
+struct CompressedBlock
+{
+  std::vector<std::uint8_t> data;  // compressed data (preceded by the zlib header, for the first block)
+  uLong crc = 0;  // CRC of the IDAT chunk type and data
+  uLong adler = 0;  // Adler-32 checksum of the uncompressed block data
+  std::size_t nr_uncompressed_bytes = 0;
+  bool valid = false;
+};
+
+// Filter and zlib parameters, with defaults resolved as done by libpng.
+struct DeflateParameters
+{
+  int compression_level;
+  int filters;
+  int strategy;
+  int window_bits;
+  int mem_level;
+
+  explicit DeflateParameters(const PNGCompressionOptions& options)
+      : compression_level(clamp(options.compression_level, 0, 9))
+      , filters(static_cast<int>(options.filters) & PNG_ALL_FILTERS)
+      , window_bits(clamp(options.window_bits, 9, 15))
+      , mem_level(clamp(options.mem_level, 1, 9))
+  {
+    if (filters == 0)
+    {
+      filters = (compression_level == 0) ? PNG_FILTER_NONE : PNG_ALL_FILTERS;
+    }
+
+    if (options.strategy == PNGCompressionStrategy::Auto)
+    {
+      strategy = (filters == PNG_FILTER_NONE) ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+    }
+    else
+    {
+      strategy = zlib_strategy(options.strategy);
+    }
+  }
+
+  std::size_t window_bytes() const
+  {
+    return std::size_t{1} << window_bits;
+  }
+
+  std::array<std::uint8_t, zlib_header_bytes> zlib_header() const
+  {
+    const auto cmf = ((window_bits - 8) << 4) | Z_DEFLATED;
+    const auto level = compression_level;
+    const auto flags = ((level < 2) ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3))) << 6;
+    return {{static_cast<std::uint8_t>(cmf), static_cast<std::uint8_t>(flags + 31 - ((cmf * 256 + flags) % 31))}};
+  }
+};
+
+void compress_block(const ConstRowPointers& row_pointers,
+                    std::size_t row_begin,
+                    std::size_t row_end,
+                    bool last_block,
+                    const RowLayout& layout,
+                    const RowTransformation& transformation,
+                    const DeflateParameters& parameters,
+                    CompressedBlock& block)
+{
+  const auto filtered_row_bytes = layout.row_bytes + 1;
+  const auto window_bytes = parameters.window_bytes();
+
+  // The rows preceding the block are filtered again, to obtain the preset dictionary for the deflate stream.
+  const auto nr_dict_rows = std::min(row_begin, (window_bytes + filtered_row_bytes - 1) / filtered_row_bytes);
+  const auto filter_begin = row_begin - nr_dict_rows;
+
+  std::vector<std::uint8_t> filtered((row_end - filter_begin) * filtered_row_bytes);
+  std::vector<std::uint8_t> scratch(filtered_row_bytes);
+  std::vector<std::uint8_t> zero_row(filter_begin == 0 ? layout.row_bytes : 0, 0);
+  std::array<std::vector<std::uint8_t>, 2> row_buffers;
+
+  if (transformation.active())
+  {
+    row_buffers[0].resize(layout.row_bytes);
+    row_buffers[1].resize(layout.row_bytes);
+  }
+
+  const auto get_row = [&](std::size_t y) {
+    return transformation.apply(row_pointers[y], layout, row_buffers[y % 2].data());
+  };
+
+  const std::uint8_t* prev = (filter_begin == 0) ? zero_row.data() : get_row(filter_begin - 1);
+
+  for (auto y = filter_begin; y < row_end; ++y)
+  {
+    const auto row = get_row(y);
+    filter_row(row, prev, layout, parameters.filters, filtered.data() + (y - filter_begin) * filtered_row_bytes,
+               scratch.data());
+    prev = row;
+  }
+
+  const auto dict_bytes = nr_dict_rows * filtered_row_bytes;
+  const auto input = filtered.data() + dict_bytes;
+  const auto input_bytes = filtered.size() - dict_bytes;
+
+  z_stream stream{};
+
+  if (deflateInit2(&stream, parameters.compression_level, Z_DEFLATED, -parameters.window_bits, parameters.mem_level,
+                   parameters.strategy) != Z_OK)
+  {
+    return;
+  }
+
+  if (dict_bytes > 0)
+  {
+    const auto nr_bytes = std::min(dict_bytes, window_bytes);
+    deflateSetDictionary(&stream, input - nr_bytes, static_cast<uInt>(nr_bytes));
+  }
+
+  const auto header_bytes = (row_begin == 0) ? zlib_header_bytes : 0;
+  auto& output = block.data;
+  output.resize(header_bytes + deflateBound(&stream, static_cast<uLong>(input_bytes)) + 16);
+
+  if (header_bytes > 0)
+  {
+    const auto header = parameters.zlib_header();
+    std::copy(header.cbegin(), header.cend(), output.begin());
+  }
+
+  stream.next_in = const_cast<Bytef*>(input);  // zlib API is not const-correct with some configurations
+  stream.avail_in = static_cast<uInt>(input_bytes);
+  stream.next_out = output.data() + header_bytes;
+  stream.avail_out = static_cast<uInt>(output.size() - header_bytes);
+
+  // Non-final blocks end with a sync flush, i.e. byte-aligned and without the final block bit being set, so that the
+  // next block can be appended.
+  const int flush = last_block ? Z_FINISH : Z_SYNC_FLUSH;
+
+  for (;;)
+  {
+    const auto ret = deflate(&stream, flush);
+
+    if (ret == Z_STREAM_ERROR)
+    {
+      deflateEnd(&stream);
+      return;
+    }
+
+    if (last_block ? (ret == Z_STREAM_END) : (stream.avail_in == 0 && stream.avail_out > 0))
+    {
+      break;
+    }
+
+    const auto used_bytes = output.size() - stream.avail_out;
+    output.resize(2 * output.size());
+    stream.next_out = output.data() + used_bytes;
+    stream.avail_out = static_cast<uInt>(output.size() - used_bytes);
+  }
+
+  output.resize(output.size() - stream.avail_out);
+  deflateEnd(&stream);
+
+  block.crc = crc32(crc32(0, idat_chunk_type.data(), static_cast<uInt>(idat_chunk_type.size())), output.data(),
+                    static_cast<uInt>(output.size()));
+  block.adler = adler32(1, input, static_cast<uInt>(input_bytes));
+  block.nr_uncompressed_bytes = input_bytes;
+  block.valid = true;
+}
+
+void store_uint32(std::uint8_t* dst, std::uint32_t value)
+{
+  dst[0] = static_cast<std::uint8_t>(value >> 24);
+  dst[1] = static_cast<std::uint8_t>(value >> 16);
+  dst[2] = static_cast<std::uint8_t>(value >> 8);
+  dst[3] = static_cast<std::uint8_t>(value);
+}
+
+template <typename SinkType>
+bool write_bytes(SinkType& sink, const std::uint8_t* data, std::size_t nr_bytes)
+{
+  return nr_bytes == 0 || write(sink, data, nr_bytes) == nr_bytes;
+}
+
+template <typename SinkType>
+bool write_png_parallel_impl(const ConstRowPointers& row_pointers,
+                             PixelLength width,
+                             PixelLength height,
+                             std::uint16_t nr_channels,
+                             std::uint16_t nr_bytes_per_channel,
+                             PixelFormat pixel_format,
+                             const PNGCompressionOptions& options,
+                             ThreadPool& thread_pool,
+                             SinkType& sink,
+                             MessageLog& message_log)
+{
+  const auto color_type = determine_color_type(pixel_format);
+
+  if (!check_color_type(color_type, nr_channels, message_log))
+  {
+    return false;
+  }
+
+  if (width <= 0 || height <= 0)
+  {
+    message_log.add_message("Invalid image size for PNG output");
+    return false;
+  }
+
+  if (!sink.is_open())
+  {
+    message_log.add_message("Output sink is not open");
+    return false;
+  }
+
+  const DeflateParameters parameters(options);
+  const auto pixel_bytes = std::size_t{nr_channels} * nr_bytes_per_channel;
+  const RowLayout layout{static_cast<std::size_t>(width) * pixel_bytes, pixel_bytes, nr_bytes_per_channel, color_type};
+  const RowTransformation transformation(options, color_type);
+
+  const auto nr_rows = static_cast<std::size_t>(height);
+  const auto rows_per_block = std::max(std::size_t{1}, parallel_block_bytes / (layout.row_bytes + 1));
+  const auto nr_blocks = (nr_rows + rows_per_block - 1) / rows_per_block;
+  std::vector<CompressedBlock> blocks(nr_blocks);
+
+  parallel_for(thread_pool, std::size_t{0}, nr_blocks, std::size_t{1}, [&](std::size_t begin, std::size_t end) {
+    for (auto i = begin; i < end; ++i)
+    {
+      const auto row_begin = i * rows_per_block;
+      const auto row_end = std::min(nr_rows, row_begin + rows_per_block);
+      compress_block(row_pointers, row_begin, row_end, i + 1 == nr_blocks, layout, transformation, parameters,
+                     blocks[i]);
+    }
+  });
+
+  if (!std::all_of(blocks.cbegin(), blocks.cend(), [](const CompressedBlock& block) { return block.valid; }))
+  {
+    message_log.add_message("Failed to compress PNG image data (zlib error)");
+    return false;
+  }
+
+  // Signature and IHDR chunk
+  std::array<std::uint8_t, 33> header{};
+  std::copy(png_signature.cbegin(), png_signature.cend(), header.begin());
+  const auto ihdr = header.data() + png_signature.size();
+  store_uint32(ihdr, 13);
+  std::copy_n("IHDR", 4, ihdr + 4);
+  store_uint32(ihdr + 8, static_cast<std::uint32_t>(width));
+  store_uint32(ihdr + 12, static_cast<std::uint32_t>(height));
+  ihdr[16] = static_cast<std::uint8_t>(nr_bytes_per_channel * 8);
+  ihdr[17] = static_cast<std::uint8_t>(color_type);
+  ihdr[18] = PNG_COMPRESSION_TYPE_BASE;
+  ihdr[19] = PNG_FILTER_TYPE_BASE;
+  ihdr[20] = PNG_INTERLACE_NONE;
+  store_uint32(ihdr + 21, static_cast<std::uint32_t>(crc32(0, ihdr + 4, 17)));
+
+  if (!write_bytes(sink, header.data(), header.size()))
+  {
+    message_log.add_message("Failed to write PNG data to sink");
+    return false;
+  }
+
+  // IDAT chunks, one per block; the last one is followed by the Adler-32 checksum of the whole zlib stream
+  auto adler = adler32(0, nullptr, 0);
+
+  for (std::size_t i = 0; i < nr_blocks; ++i)
+  {
+    const auto& block = blocks[i];
+    adler = adler32_combine(adler, block.adler, static_cast<z_off_t>(block.nr_uncompressed_bytes));
+
+    const bool last_block = (i + 1 == nr_blocks);
+    auto crc = block.crc;
+    std::array<std::uint8_t, 4> adler_bytes{};
+
+    if (last_block)
+    {
+      store_uint32(adler_bytes.data(), static_cast<std::uint32_t>(adler));
+      crc = crc32(crc, adler_bytes.data(), static_cast<uInt>(adler_bytes.size()));
+    }
+
+    const auto chunk_data_bytes = block.data.size() + (last_block ? adler_bytes.size() : 0);
+    std::array<std::uint8_t, 8> chunk_header{};
+    store_uint32(chunk_header.data(), static_cast<std::uint32_t>(chunk_data_bytes));
+    std::copy(idat_chunk_type.cbegin(), idat_chunk_type.cend(), chunk_header.begin() + 4);
+    std::array<std::uint8_t, 4> crc_bytes{};
+    store_uint32(crc_bytes.data(), static_cast<std::uint32_t>(crc));
+
+    if (!write_bytes(sink, chunk_header.data(), chunk_header.size())
+        || !write_bytes(sink, block.data.data(), block.data.size())
+        || (last_block && !write_bytes(sink, adler_bytes.data(), adler_bytes.size()))
+        || !write_bytes(sink, crc_bytes.data(), crc_bytes.size()))
+    {
+      message_log.add_message("Failed to write PNG data to sink");
+      return false;
+    }
+  }
+
+  if (!write_bytes(sink, iend_chunk.data(), iend_chunk.size()))
+  {
+    message_log.add_message("Failed to write PNG data to sink");
+    return false;
+  }
+
+  return true;
+}
+
 }  // namespace
 
 /// \cond INTERNAL
@@ -54,6 +586,19 @@ struct PNGCompressionObject::Impl
 
 PNGCompressionObject::PNGCompressionObject() : impl_(std::make_unique<PNGCompressionObject::Impl>())
 {
+  allocate();
+}
+
+PNGCompressionObject::~PNGCompressionObject()
+{
+  deallocate();
+}
+
+void PNGCompressionObject::allocate()
+{
+  SELENE_FORCED_ASSERT(!impl_->png_ptr);
+  SELENE_FORCED_ASSERT(!impl_->info_ptr);
+
   auto user_error_ptr = static_cast<png_voidp>(&impl_->error_manager);
   png_error_ptr user_error_fn = detail::error_handler;
   png_error_ptr user_warning_fn = detail::warning_handler;
@@ -77,16 +622,22 @@ PNGCompressionObject::PNGCompressionObject() : impl_(std::make_unique<PNGCompres
   impl_->valid = true;
 }
 
-PNGCompressionObject::~PNGCompressionObject()
+void PNGCompressionObject::deallocate()
 {
   png_destroy_write_struct(&impl_->png_ptr, &impl_->info_ptr);
+  impl_->png_ptr = nullptr;
+  impl_->info_ptr = nullptr;
+  impl_->valid = false;
 }
 
+// libpng offers no way to return a png_struct to its start state, e.g. after an image stream has been aborted, so the
+// structures are recreated once they have been used.
 void PNGCompressionObject::reset_if_needed()
 {
   if (impl_->needs_reset)
   {
-    // TODO: do we also need to deallocate and reallocate the png structs here, as in the decompression object?
+    deallocate();
+    allocate();
     impl_->error_manager.error_state = false;
     impl_->error_manager.message_log.clear();
     impl_->needs_reset = false;
@@ -109,18 +660,8 @@ bool PNGCompressionObject::set_image_info(
   const auto compression_type = PNG_COMPRESSION_TYPE_DEFAULT;
   const auto filter_method = PNG_FILTER_TYPE_DEFAULT;
 
-  if (color_type == PNG_COLOR_TYPE_INVALID)
-  {
-    impl_->error_manager.message_log.add_message("Cannot determine PNG color type from pixel format of image data");
-    return false;
-  }
-
-  if ((color_type == PNG_COLOR_TYPE_GRAY && nr_channels != 1)
-      || (color_type == PNG_COLOR_TYPE_GRAY_ALPHA && nr_channels != 2)
-      || (color_type == PNG_COLOR_TYPE_RGB && nr_channels != 3)
-      || (color_type == PNG_COLOR_TYPE_RGB_ALPHA && nr_channels != 4))
+  if (!check_color_type(color_type, nr_channels, impl_->error_manager.message_log))
   {
-    impl_->error_manager.message_log.add_message("Mismatch between determined PNG color type and nr of channels");
     return false;
   }
 
@@ -141,11 +682,14 @@ failure_state:
   return false;
 }
 
-bool PNGCompressionObject::set_compression_parameters(int compression_level, bool invert_alpha)
+bool PNGCompressionObject::set_compression_parameters(const PNGCompressionOptions& options)
 {
   auto png_ptr = impl_->png_ptr;
 
-  compression_level = clamp(compression_level, 0, 9);
+  const auto compression_level = clamp(options.compression_level, 0, 9);
+  const auto filters = static_cast<int>(options.filters) & PNG_ALL_FILTERS;
+  const auto window_bits = clamp(options.window_bits, 9, 15);
+  const auto mem_level = clamp(options.mem_level, 1, 9);
 
   if (setjmp(png_jmpbuf(png_ptr)))
   {
@@ -153,8 +697,20 @@ bool PNGCompressionObject::set_compression_parameters(int compression_level, boo
   }
 
   png_set_compression_level(png_ptr, compression_level);
+  png_set_compression_window_bits(png_ptr, window_bits);
+  png_set_compression_mem_level(png_ptr, mem_level);
+
+  if (filters != 0)
+  {
+    png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, filters);
+  }
+
+  if (options.strategy != PNGCompressionStrategy::Auto)
+  {
+    png_set_compression_strategy(png_ptr, zlib_strategy(options.strategy));
+  }
 
-  if (invert_alpha)
+  if (options.invert_alpha_channel)
   {
     png_set_invert_alpha(png_ptr);
   }
@@ -215,6 +771,7 @@ PNGCompressionCycle::PNGCompressionCycle(PNGCompressionObject& obj, bool set_bgr
 
 failure_state:
   error_state_ = true;
+  finished_or_aborted_ = true;
 }
 
 PNGCompressionCycle::~PNGCompressionCycle()
@@ -232,11 +789,100 @@ void PNGCompressionCycle::compress(const ConstRowPointers& row_pointers)
   auto png_ptr = obj_.impl_->png_ptr;
   auto info_ptr = obj_.impl_->info_ptr;
 
+  if (finished_or_aborted_)
+  {
+    return;
+  }
+
+  if (setjmp(png_jmpbuf(png_ptr)))
+  {
+    goto failure_state;
+  }
+
   // Hack to accommodate non-const correct API
-  const auto png_row_pointers = const_cast<png_bytepp>(row_pointers.data());
-  png_write_image(png_ptr, png_row_pointers);
+  png_write_image(png_ptr, const_cast<png_bytepp>(row_pointers.data()));
+  next_row_ = png_get_image_height(png_ptr, info_ptr);
 
   png_write_end(png_ptr, info_ptr);
+  finished_or_aborted_ = true;
+  return;
+
+failure_state:
+  finished_or_aborted_ = true;
+}
+
+std::size_t PNGCompressionCycle::nr_remaining_rows() const
+{
+  if (finished_or_aborted_)
+  {
+    return 0;
+  }
+
+  const auto height = static_cast<std::size_t>(png_get_image_height(obj_.impl_->png_ptr, obj_.impl_->info_ptr));
+  return height - next_row_;
+}
+
+// Compresses the next `nr_rows` rows (at most) of the image, pointed to by `row_pointers`.
+// Interlaced images are not supported, since each of their passes requires rows from the whole image.
+bool PNGCompressionCycle::compress_rows(const ConstRowPointers& row_pointers, std::size_t nr_rows)
+{
+  auto png_ptr = obj_.impl_->png_ptr;
+  auto info_ptr = obj_.impl_->info_ptr;
+
+  SELENE_ASSERT(row_pointers.size() >= nr_rows);
+
+  if (finished_or_aborted_)
+  {
+    return false;
+  }
+
+  if (png_get_interlace_type(png_ptr, info_ptr) != PNG_INTERLACE_NONE)
+  {
+    obj_.impl_->error_manager.message_log.add_message("Interlaced PNG images cannot be compressed row by row.");
+    finished_or_aborted_ = true;
+    return false;
+  }
+
+  nr_rows = std::min(nr_rows, nr_remaining_rows());
+
+  if (setjmp(png_jmpbuf(png_ptr)))
+  {
+    goto failure_state;
+  }
+
+  // Hack to accommodate non-const correct API
+  png_write_rows(png_ptr, const_cast<png_bytepp>(row_pointers.data()), static_cast<png_uint_32>(nr_rows));
+  next_row_ += nr_rows;
+
+  return true;
+
+failure_state:
+  finished_or_aborted_ = true;
+  return false;
+}
+
+bool PNGCompressionCycle::finish()
+{
+  auto png_ptr = obj_.impl_->png_ptr;
+  auto info_ptr = obj_.impl_->info_ptr;
+
+  if (finished_or_aborted_)
+  {
+    return false;
+  }
+
+  if (setjmp(png_jmpbuf(png_ptr)))
+  {
+    goto failure_state;
+  }
+
+  png_write_end(png_ptr, info_ptr);
+  finished_or_aborted_ = true;
+  return true;
+
+failure_state:
+  finished_or_aborted_ = true;
+  return false;
 }
 
 
@@ -288,6 +934,36 @@ void set_destination(PNGCompressionObject& obj, VectorWriter& sink)
 failure_state:;
 }
 
+bool write_png_parallel(const ConstRowPointers& row_pointers,
+                        PixelLength width,
+                        PixelLength height,
+                        std::uint16_t nr_channels,
+                        std::uint16_t nr_bytes_per_channel,
+                        PixelFormat pixel_format,
+                        const PNGCompressionOptions& options,
+                        ThreadPool& thread_pool,
+                        FileWriter& sink,
+                        MessageLog& message_log)
+{
+  return write_png_parallel_impl(row_pointers, width, height, nr_channels, nr_bytes_per_channel, pixel_format, options,
+                                 thread_pool, sink, message_log);
+}
+
+bool write_png_parallel(const ConstRowPointers& row_pointers,
+                        PixelLength width,
+                        PixelLength height,
+                        std::uint16_t nr_channels,
+                        std::uint16_t nr_bytes_per_channel,
+                        PixelFormat pixel_format,
+                        const PNGCompressionOptions& options,
+                        ThreadPool& thread_pool,
+                        VectorWriter& sink,
+                        MessageLog& message_log)
+{
+  return write_png_parallel_impl(row_pointers, width, height, nr_channels, nr_bytes_per_channel, pixel_format, options,
+                                 thread_pool, sink, message_log);
+}
+
 }  // namespace detail
 
 /// \endcond
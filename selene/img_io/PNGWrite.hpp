@@ -22,10 +22,14 @@
 #include <selene/io/FileWriter.hpp>
 #include <selene/io/VectorWriter.hpp>
 
+#include <selene/thread/ThreadPool.hpp>
+
 #include <array>
 #include <csetjmp>
+#include <cstdint>
 #include <cstdio>
 #include <memory>
+#include <stdexcept>
 
 namespace sln {
 
@@ -40,7 +44,55 @@ void set_destination(PNGCompressionObject&, FileWriter&);
 void set_destination(PNGCompressionObject&, VectorWriter&);
 }  // namespace detail
 
+/** \brief PNG row filter types.
+ *
+ * Filter types can be combined using `operator|`, forming the set of filter types that each image row may be filtered
+ * with. If the set contains more than one filter type, the filter type is chosen adaptively for each row, as the one
+ * minimizing the sum of absolute differences of the filtered row.
+ */
+enum class PNGFilter : std::uint8_t
+{
+  Default = 0x00,  ///< libpng default: all filter types, for images with at least 8 bits per sample.
+  None = 0x08,  ///< No filtering.
+  Sub = 0x10,  ///< Difference to the pixel to the left.
+  Up = 0x20,  ///< Difference to the pixel above.
+  Average = 0x40,  ///< Difference to the average of the pixels to the left and above.
+  Paeth = 0x80,  ///< Difference to the Paeth predictor of the pixels to the left, above, and above left.
+  All = 0xF8  ///< All filter types.
+};
+
+constexpr PNGFilter operator|(PNGFilter a, PNGFilter b);
+
+/** \brief zlib compression strategy used for PNG compression.
+ *
+ * See the zlib manual for the documentation of the respective `deflateInit2()` strategies.
+ */
+enum class PNGCompressionStrategy : std::uint8_t
+{
+  Auto,  ///< libpng default: `Filtered` if image rows are filtered, `Default` otherwise.
+  Default,  ///< Regular deflate compression (Z_DEFAULT_STRATEGY).
+  Filtered,  ///< Favors Huffman coding over string matching; suited to filtered data (Z_FILTERED).
+  HuffmanOnly,  ///< Huffman coding only, no string matching (Z_HUFFMAN_ONLY).
+  RLE,  ///< String matching limited to run-length encoding; fast, but only suited to images with uniform areas (Z_RLE).
+  Fixed  ///< Huffman coding with fixed codes (Z_FIXED).
+};
+
+/** \brief Named sets of PNG compression options, trading off compression speed against compressed size. */
+enum class PNGCompressionPreset : std::uint8_t
+{
+  Fastest,  ///< Compression level 2, adaptive filtering using the Sub and Up filters only.
+  Balanced,  ///< The libpng defaults: compression level 6, adaptive filtering using all filter types.
+  Smallest  ///< Compression level 9, maximum zlib memory level, adaptive filtering using all filter types.
+};
+
 /** \brief PNG compression options.
+ *
+ * Besides the constructor arguments, the following members control the compression, and can be set individually, or
+ * jointly from a PNGCompressionPreset:
+ * - `filters` specifies the set of row filter types to choose from.
+ * - `strategy` specifies the zlib compression strategy.
+ * - `window_bits` specifies the base-2 logarithm of the deflate window size, from 9 to 15.
+ * - `mem_level` specifies the zlib memory level, from 1 (minimum memory, slow) to 9 (maximum memory, fast).
  *
  * For more detailed information, consult the libpng manual (libpng-manual.txt) provided with every libpng source
  * distribution, or available here: http://www.libpng.org/pub/png/libpng-manual.txt
@@ -52,6 +104,10 @@ struct PNGCompressionOptions
   bool set_bgr;  ///< If true, convert BGR (supplied) to RGB (written).
   bool invert_alpha_channel;  ///< If true, invert values in alpha channel (e.g. 0 -> 255).
   bool invert_monochrome;  ///< If true, invert grayscale or grayscale_alpha image values.
+  PNGFilter filters = PNGFilter::Default;  ///< The set of row filter types to choose from.
+  PNGCompressionStrategy strategy = PNGCompressionStrategy::Auto;  ///< The zlib compression strategy.
+  int window_bits = 15;  ///< Base-2 logarithm of the deflate window size; may take values from 9 to 15.
+  int mem_level = 8;  ///< zlib memory level; may take values from 1 to 9.
 
   /** \brief Constructor, setting the respective JPEG compression options.
    *
@@ -74,6 +130,29 @@ struct PNGCompressionOptions
       , invert_monochrome(invert_monochrome_)
   {
   }
+
+  /** \brief Constructor, setting the compression options of the specified preset.
+   *
+   * @param preset The compression preset.
+   */
+  explicit PNGCompressionOptions(PNGCompressionPreset preset) : PNGCompressionOptions()
+  {
+    switch (preset)
+    {
+      case PNGCompressionPreset::Fastest:
+        compression_level = 2;
+        filters = PNGFilter::Sub | PNGFilter::Up;
+        strategy = PNGCompressionStrategy::Default;
+        break;
+      case PNGCompressionPreset::Balanced:
+        break;
+      case PNGCompressionPreset::Smallest:
+        compression_level = 9;
+        mem_level = 9;
+        filters = PNGFilter::All;
+        break;
+    }
+  }
 };
 
 /** \brief Opaque PNG compression object, holding internal state.
@@ -92,13 +171,15 @@ public:
   const MessageLog& message_log() const;
 
   bool set_image_info(int width, int height, int nr_channels, int bit_depth, bool interlaced, PixelFormat pixel_format);
-  bool set_compression_parameters(int, bool);
+  bool set_compression_parameters(const PNGCompressionOptions& options);
   /// \endcond
 
 private:
   struct Impl;
   std::unique_ptr<Impl> impl_;
 
+  void allocate();
+  void deallocate();
   void reset_if_needed();
 
   friend class detail::PNGCompressionCycle;
@@ -141,9 +222,100 @@ bool write_png(const ImageData<storage_type>& img_data,
                PNGCompressionOptions options = PNGCompressionOptions(),
                MessageLog* messages = nullptr);
 
+/** \brief Writes a PNG image data stream, given the supplied uncompressed image data, compressing it in parallel.
+ *
+ * The image rows are split into blocks, which are filtered and deflated independently by the tasks of the thread pool.
+ * The deflate stream of each block is primed with the last 32 KiB of the preceding data, and ended with a sync flush,
+ * so that the concatenated blocks form one valid zlib stream. Each block is written as a separate IDAT chunk; the
+ * chunk CRCs and the Adler-32 checksum of the zlib stream are computed incrementally per block.
+ * The output is a standard-conforming PNG image data stream, whose size is typically within a few per cent of the
+ * output of the single-threaded write_png().
+ *
+ * The filter and zlib options are respected as by the single-threaded write_png(); by default, rows are filtered
+ * adaptively using all filter types, as done by libpng. Interlaced images cannot be compressed in independent row
+ * blocks; if `options.interlaced` is set, the image is written using the single-threaded write_png().
+ *
+ * @tparam SinkType Type of the output sink. Can be FileWriter or VectorWriter.
+ * @param img_data The image data to be written.
+ * @param sink Output sink instance.
+ * @param thread_pool The thread pool to use for compression.
+ * @param options The compression options.
+ * @param messages Optional pointer to the message log. If provided, warning and error messages will be output there.
+ * @return True, if the write operation was successful; false otherwise.
+ */
+template <ImageDataStorage storage_type, typename SinkType>
+bool write_png(const ImageData<storage_type>& img_data,
+               SinkType&& sink,
+               ThreadPool& thread_pool,
+               PNGCompressionOptions options = PNGCompressionOptions(),
+               MessageLog* messages = nullptr);
+
+/** Class with functionality to write a PNG image data stream strip by strip.
+ *
+ * Generally, the free function write_png() should be preferred, due to ease of use.
+ *
+ * write_png(), however, requires the complete image data to be present in memory. This class allows writing the image
+ * data in strips of consecutive rows instead, e.g. if the rows are generated on the fly. The memory required is then
+ * bounded by the strip size instead of the image size.
+ *
+ * The size and pixel format of the image have to be known beforehand, and are set using `write_header()`.
+ * Subsequently, the image rows are supplied in order by repeatedly calling `write_rows()`. Once the last row has been
+ * supplied, the PNG stream is completed.
+ * Interlaced PNG images cannot be written in strips, since each of their passes requires rows from the whole image.
+ *
+ * Multiple images can be written in sequence using the same PNGWriter<> (on the same thread), by calling
+ * `write_header()` again. If the previous image has not been written completely, it is aborted.
+ *
+ * @tparam SinkType Type of the output sink. Can be FileWriter or VectorWriter.
+ */
+template <typename SinkType>
+class PNGWriter
+{
+public:
+  PNGWriter();
+  explicit PNGWriter(SinkType& sink, PNGCompressionOptions options = PNGCompressionOptions());
+
+  void set_sink(SinkType& sink);
+  void set_compression_options(PNGCompressionOptions options);
+
+  bool write_header(PixelLength width,
+                    PixelLength height,
+                    std::uint16_t nr_channels,
+                    std::uint16_t nr_bytes_per_channel,
+                    PixelFormat pixel_format);
+
+  template <ImageDataStorage storage_type>
+  bool write_rows(const ImageData<storage_type>& strip_data);
+  PixelLength nr_remaining_rows() const;
+
+  MessageLog& message_log();
+
+private:
+  SinkType* sink_;
+  PNGCompressionOptions options_;
+  PNGCompressionObject obj_;
+  std::unique_ptr<detail::PNGCompressionCycle> cycle_;
+  PixelLength width_ = 0_px;
+  std::uint16_t nr_channels_ = 0;
+  std::uint16_t nr_bytes_per_channel_ = 0;
+
+  void reset();
+};
+
 // ----------
 // Implementation:
 
+/** \brief Combines two sets of PNG row filter types.
+ *
+ * @param a The first set of filter types.
+ * @param b The second set of filter types.
+ * @return The union of both sets.
+ */
+constexpr PNGFilter operator|(PNGFilter a, PNGFilter b)
+{
+  return static_cast<PNGFilter>(static_cast<std::uint8_t>(a) | static_cast<std::uint8_t>(b));
+}
+
 namespace detail {
 
 class PNGCompressionCycle
@@ -155,11 +327,39 @@ public:
   bool error_state() const;
   void compress(const ConstRowPointers& row_pointers);
 
+  std::size_t nr_remaining_rows() const;
+  bool compress_rows(const ConstRowPointers& row_pointers, std::size_t nr_rows);
+  bool finish();
+
 private:
   PNGCompressionObject& obj_;
   bool error_state_;
+  bool finished_or_aborted_ = false;
+  std::size_t next_row_ = 0;
 };
 
+bool write_png_parallel(const ConstRowPointers& row_pointers,
+                        PixelLength width,
+                        PixelLength height,
+                        std::uint16_t nr_channels,
+                        std::uint16_t nr_bytes_per_channel,
+                        PixelFormat pixel_format,
+                        const PNGCompressionOptions& options,
+                        ThreadPool& thread_pool,
+                        FileWriter& sink,
+                        MessageLog& message_log);
+
+bool write_png_parallel(const ConstRowPointers& row_pointers,
+                        PixelLength width,
+                        PixelLength height,
+                        std::uint16_t nr_channels,
+                        std::uint16_t nr_bytes_per_channel,
+                        PixelFormat pixel_format,
+                        const PNGCompressionOptions& options,
+                        ThreadPool& thread_pool,
+                        VectorWriter& sink,
+                        MessageLog& message_log);
+
 }  // namespace detail
 
 
@@ -186,6 +386,13 @@ bool write_png(const ImageData<storage_type>& img_data,
     throw std::runtime_error("Unsupported bit depth of image data for PNG output");
   }
 
+  if (img_data.is_planar() && img_data.nr_channels() > 1)
+  {
+    obj.message_log().add_message("Planar image data with more than one channel cannot be written as PNG.");
+    detail::assign_message_log(obj, messages);
+    return false;
+  }
+
   detail::set_destination(obj, sink);
 
   if (obj.error_state())
@@ -207,7 +414,7 @@ bool write_png(const ImageData<storage_type>& img_data,
     return false;
   }
 
-  const bool pars_set = obj.set_compression_parameters(options.compression_level, options.invert_alpha_channel);
+  const bool pars_set = obj.set_compression_parameters(options);
 
   if (!pars_set)
   {
@@ -223,6 +430,233 @@ bool write_png(const ImageData<storage_type>& img_data,
   return !obj.error_state();
 }
 
+template <ImageDataStorage storage_type, typename SinkType>
+bool write_png(const ImageData<storage_type>& img_data,
+               SinkType&& sink,
+               ThreadPool& thread_pool,
+               PNGCompressionOptions options,
+               MessageLog* messages)
+{
+  if (img_data.nr_bytes_per_channel() != 1 && img_data.nr_bytes_per_channel() != 2)
+  {
+    throw std::runtime_error("Unsupported bit depth of image data for PNG output");
+  }
+
+  if (options.interlaced)
+  {
+    return write_png(img_data, std::forward<SinkType>(sink), options, messages);
+  }
+
+  MessageLog message_log;
+
+  if (img_data.is_planar() && img_data.nr_channels() > 1)
+  {
+    message_log.add_message("Planar image data with more than one channel cannot be written as PNG.");
+
+    if (messages)
+    {
+      *messages = message_log;
+    }
+
+    return false;
+  }
+
+  const auto row_pointers = get_row_pointers(img_data);
+  const bool written = detail::write_png_parallel(row_pointers, img_data.width(), img_data.height(),
+                                                  img_data.nr_channels(), img_data.nr_bytes_per_channel(),
+                                                  img_data.pixel_format(), options, thread_pool, sink, message_log);
+
+  if (messages)
+  {
+    *messages = message_log;
+  }
+
+  return written;
+}
+
+template <typename SinkType>
+PNGWriter<SinkType>::PNGWriter()
+    : sink_(nullptr), options_(PNGCompressionOptions())
+{
+}
+
+template <typename SinkType>
+PNGWriter<SinkType>::PNGWriter(SinkType& sink, PNGCompressionOptions options)
+    : sink_(&sink), options_(options)
+{
+}
+
+/** \brief Sets the output sink. An image that has not been written completely is aborted.
+ *
+ * @param sink Output sink instance.
+ */
+template <typename SinkType>
+void PNGWriter<SinkType>::set_sink(SinkType& sink)
+{
+  reset();
+  sink_ = &sink;
+}
+
+/** \brief Sets the compression options for the next image to be written.
+ *
+ * @param options The compression options.
+ */
+template <typename SinkType>
+void PNGWriter<SinkType>::set_compression_options(PNGCompressionOptions options)
+{
+  if (cycle_)
+  {
+    throw std::runtime_error("PNGWriter: Cannot call set_compression_options() after call to write_header().");
+  }
+
+  options_ = options;
+}
+
+/** \brief Starts writing a new PNG image of the specified size and pixel format.
+ *
+ * An image that has not been written completely is aborted.
+ *
+ * @param width The image width.
+ * @param height The image height.
+ * @param nr_channels The number of image channels.
+ * @param nr_bytes_per_channel The number of bytes per channel. Needs to be 1 or 2.
+ * @param pixel_format The pixel format of the image data to be supplied.
+ * @return True, if the image stream was started successfully; false otherwise.
+ */
+template <typename SinkType>
+bool PNGWriter<SinkType>::write_header(PixelLength width,
+                                       PixelLength height,
+                                       std::uint16_t nr_channels,
+                                       std::uint16_t nr_bytes_per_channel,
+                                       PixelFormat pixel_format)
+{
+  if (nr_bytes_per_channel != 1 && nr_bytes_per_channel != 2)
+  {
+    throw std::runtime_error("Unsupported bit depth of image data for PNG output");
+  }
+
+  reset();
+
+  if (sink_ == nullptr)
+  {
+    return false;
+  }
+
+  detail::set_destination(obj_, *sink_);
+
+  if (obj_.error_state())
+  {
+    return false;
+  }
+
+  const auto bit_depth = nr_bytes_per_channel == 1 ? 8 : 16;
+
+  const bool img_info_set = obj_.set_image_info(static_cast<int>(width), static_cast<int>(height),
+                                                static_cast<int>(nr_channels), static_cast<int>(bit_depth),
+                                                options_.interlaced, pixel_format);
+
+  if (!img_info_set)
+  {
+    return false;
+  }
+
+  const bool pars_set = obj_.set_compression_parameters(options_);
+
+  if (!pars_set)
+  {
+    return false;
+  }
+
+  cycle_ = std::make_unique<detail::PNGCompressionCycle>(obj_, options_.set_bgr, options_.invert_monochrome);
+
+  if (cycle_->error_state())
+  {
+    reset();
+    return false;
+  }
+
+  width_ = width;
+  nr_channels_ = nr_channels;
+  nr_bytes_per_channel_ = nr_bytes_per_channel;
+  return true;
+}
+
+/** \brief Writes the next rows of the image, i.e. the next strip of the image.
+ *
+ * The strip has to match the width, the number of channels, and the bit depth set by `write_header()`, and may not
+ * contain more rows than remain to be written. If it contains the last row of the image, the PNG stream is completed.
+ *
+ * @param strip_data The image data containing the rows to be written.
+ * @return True, if the rows were written successfully; false otherwise. In the latter case, the message log contains
+ * the respective error message; an image stream that failed to be written is aborted.
+ */
+template <typename SinkType>
+template <ImageDataStorage storage_type>
+bool PNGWriter<SinkType>::write_rows(const ImageData<storage_type>& strip_data)
+{
+  if (!cycle_)
+  {
+    obj_.message_log().add_message("PNGWriter: write_header() needs to be called before write_rows().");
+    return false;
+  }
+
+  if (strip_data.width() != width_ || strip_data.nr_channels() != nr_channels_
+      || strip_data.nr_bytes_per_channel() != nr_bytes_per_channel_ || strip_data.height() > nr_remaining_rows())
+  {
+    obj_.message_log().add_message("PNGWriter: Image data strip does not match the image to be written.");
+    return false;
+  }
+
+  if (strip_data.is_planar() && strip_data.nr_channels() > 1)
+  {
+    obj_.message_log().add_message("PNGWriter: Planar image data with more than one channel cannot be written.");
+    return false;
+  }
+
+  const auto row_pointers = get_row_pointers(strip_data);
+
+  if (!cycle_->compress_rows(row_pointers, row_pointers.size()))
+  {
+    reset();
+    return false;
+  }
+
+  if (cycle_->nr_remaining_rows() > 0)
+  {
+    return true;
+  }
+
+  const auto finished = cycle_->finish();
+  reset();
+  return finished && !obj_.error_state();
+}
+
+/** \brief Returns the number of rows of the current image that remain to be written by `write_rows()`.
+ *
+ * @return The number of remaining rows; 0 if no image is currently being written.
+ */
+template <typename SinkType>
+PixelLength PNGWriter<SinkType>::nr_remaining_rows() const
+{
+  return cycle_ ? PixelLength(static_cast<PixelLength::value_type>(cycle_->nr_remaining_rows())) : 0_px;
+}
+
+template <typename SinkType>
+MessageLog& PNGWriter<SinkType>::message_log()
+{
+  return obj_.message_log();
+}
+
+template <typename SinkType>
+void PNGWriter<SinkType>::reset()
+{
+  // reset internal state; aborts an incomplete image
+  cycle_ = nullptr;
+  width_ = 0_px;
+  nr_channels_ = 0;
+  nr_bytes_per_channel_ = 0;
+}
+
 }  // namespace sln
 
 #endif  // defined(SELENE_WITH_LIBPNG)
@@ -0,0 +1,247 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/img_io/Probe.hpp>
+
+#include <selene/io/FileReader.hpp>
+#include <selene/io/MemoryReader.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace sln {
+
+namespace {
+
+constexpr std::array<std::uint8_t, 3> jpeg_signature = {{0xFF, 0xD8, 0xFF}};
+constexpr std::array<std::uint8_t, 8> png_signature = {{0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A}};
+
+template <std::size_t N>
+bool starts_with(const std::uint8_t* data, std::size_t len, const std::array<std::uint8_t, N>& signature)
+{
+  return len >= N && std::memcmp(data, signature.data(), N) == 0;
+}
+
+std::uint32_t read_big_endian_u32(const std::uint8_t* data)
+{
+  return (std::uint32_t{data[0]} << 24) | (std::uint32_t{data[1]} << 16) | (std::uint32_t{data[2]} << 8)
+         | std::uint32_t{data[3]};
+}
+
+// The IHDR chunk is required to come first, directly after the signature: 4 bytes chunk length (always 13), 4 bytes
+// chunk type, then width (4 bytes), height (4 bytes), bit depth (1 byte), and color type (1 byte).
+ImageProbeInfo probe_png(const std::uint8_t* data, std::size_t len)
+{
+  ImageProbeInfo info;
+  constexpr std::size_t ihdr_end = 8 + 8 + 10;
+
+  if (len < ihdr_end || read_big_endian_u32(data + 8) != 13 || std::memcmp(data + 12, "IHDR", 4) != 0)
+  {
+    return info;
+  }
+
+  const auto width = read_big_endian_u32(data + 16);
+  const auto height = read_big_endian_u32(data + 20);
+  const auto bit_depth = data[24];
+  const auto color_type = data[25];
+
+  std::uint16_t nr_channels = 0;
+  switch (color_type)
+  {
+    case 0: nr_channels = 1; break;  // grayscale
+    case 2: nr_channels = 3; break;  // RGB
+    case 3: nr_channels = 1; break;  // palette
+    case 4: nr_channels = 2; break;  // grayscale + alpha
+    case 6: nr_channels = 4; break;  // RGB + alpha
+    default: return info;
+  }
+
+  // PNG limits the image dimensions to 2^31 - 1.
+  if (width > 0x7FFFFFFF || height > 0x7FFFFFFF)
+  {
+    return info;
+  }
+
+  info.format = ImageFormat::PNG;
+  info.width = to_pixel_length(width);
+  info.height = to_pixel_length(height);
+  info.nr_channels = nr_channels;
+  info.bit_depth = bit_depth;
+  return info;
+}
+
+#if defined(SELENE_WITH_LIBJPEG)
+// Appends the JPEG marker segments read from `source` to `buffer`, up to and including the SOS segment, but leaving out
+// application (APPn) and comment (COM) segments; these are skipped over without being read. Returns true if the SOS
+// segment was reached. Otherwise, `segment_start` holds the source position of the segment that could not be read.
+template <typename SourceType>
+bool collect_jpeg_header_segments(SourceType& source, std::vector<std::uint8_t>& buffer, std::ptrdiff_t& segment_start)
+{
+  for (;;)
+  {
+    segment_start = source.position();
+
+    std::array<std::uint8_t, 4> marker_bytes;  // 0xFF, marker, and the 2-byte segment length
+    if (source.read(marker_bytes.data(), 2) != 2 || marker_bytes[0] != 0xFF)
+    {
+      return false;
+    }
+
+    while (marker_bytes[1] == 0xFF)  // skip fill bytes
+    {
+      if (source.read(marker_bytes.data() + 1, 1) != 1)
+      {
+        return false;
+      }
+    }
+
+    if (source.read(marker_bytes.data() + 2, 2) != 2)
+    {
+      return false;
+    }
+
+    const auto marker = marker_bytes[1];
+    const auto length = static_cast<std::size_t>((marker_bytes[2] << 8) | marker_bytes[3]);
+
+    if (length < 2)
+    {
+      return false;
+    }
+
+    if ((marker >= 0xE0 && marker <= 0xEF) || marker == 0xFE)
+    {
+      const auto segment_end = source.position() + static_cast<std::ptrdiff_t>(length) - 2;
+      if (!source.seek_abs(segment_end) || source.position() != segment_end)
+      {
+        return false;
+      }
+      continue;
+    }
+
+    const auto offset = buffer.size();
+    buffer.resize(offset + 2 + length);
+    std::copy(marker_bytes.cbegin(), marker_bytes.cend(), buffer.begin() + static_cast<std::ptrdiff_t>(offset));
+
+    if (source.read(buffer.data() + offset + 4, length - 2) != length - 2)
+    {
+      buffer.resize(offset);
+      return false;
+    }
+
+    if (marker == 0xDA)  // SOS
+    {
+      return true;
+    }
+  }
+}
+
+// Only the segments required by libjpeg to read the header are passed on to it. These are usually contained in the file
+// prefix. Otherwise, usually due to large embedded metadata (EXIF, XMP, ICC profiles), the remaining segments are
+// collected from the file, seeking over the metadata.
+JPEGImageInfo probe_jpeg(JPEGDecompressionObject& obj,
+                         FileReader& source,
+                         const std::uint8_t* data,
+                         std::size_t len,
+                         std::vector<std::uint8_t>& buffer)
+{
+  buffer = {0xFF, 0xD8};  // SOI marker
+  std::ptrdiff_t segment_start = 0;
+
+  MemoryReader prefix(data, len);
+  prefix.seek_abs(2);
+  bool complete = collect_jpeg_header_segments(prefix, buffer, segment_start);
+
+  if (!complete && !source.is_eof() && source.seek_abs(segment_start))
+  {
+    complete = collect_jpeg_header_segments(source, buffer, segment_start);
+  }
+
+  return complete ? read_jpeg_header(obj, MemoryReader(buffer.data(), buffer.size())) : JPEGImageInfo();
+}
+#endif  // defined(SELENE_WITH_LIBJPEG)
+
+}  // namespace
+
+/// \cond INTERNAL
+
+struct ImageProber::Impl
+{
+#if defined(SELENE_WITH_LIBJPEG)
+  JPEGDecompressionObject jpeg_obj;
+  std::vector<std::uint8_t> jpeg_buffer;
+#endif
+  std::array<std::uint8_t, ImageProber::prefix_size> prefix;
+};
+
+/// \endcond
+
+/** \brief Constructor. */
+ImageProber::ImageProber() : impl_(std::make_unique<ImageProber::Impl>())
+{
+}
+
+/** \brief Destructor. */
+ImageProber::~ImageProber() = default;
+
+ImageProber::ImageProber(ImageProber&&) noexcept = default;
+
+ImageProber& ImageProber::operator=(ImageProber&&) noexcept = default;
+
+/// \cond INTERNAL
+namespace detail {
+
+ImageProber& thread_local_image_prober()
+{
+  static thread_local ImageProber prober;
+  return prober;
+}
+
+}  // namespace detail
+/// \endcond
+
+/** \brief Probes the specified image file.
+ *
+ * @param path The path to the image file.
+ * @return The probed image information. Is invalid if the file could not be read or is not a supported image file.
+ */
+ImageProbeInfo ImageProber::probe(const char* path)
+{
+  FileReader source;
+  if (!source.open(path))
+  {
+    return ImageProbeInfo();
+  }
+
+  const auto data = impl_->prefix.data();
+  const auto len = source.read(data, impl_->prefix.size());
+
+  if (starts_with(data, len, png_signature))
+  {
+    return probe_png(data, len);
+  }
+
+#if defined(SELENE_WITH_LIBJPEG)
+  if (starts_with(data, len, jpeg_signature))
+  {
+    const auto header_info = probe_jpeg(impl_->jpeg_obj, source, data, len, impl_->jpeg_buffer);
+
+    ImageProbeInfo info;
+    if (header_info.is_valid())
+    {
+      info.format = ImageFormat::JPEG;
+      info.width = header_info.width;
+      info.height = header_info.height;
+      info.nr_channels = header_info.nr_channels;
+      info.bit_depth = 8;
+    }
+    return info;
+  }
+#endif  // defined(SELENE_WITH_LIBJPEG)
+
+  return ImageProbeInfo();
+}
+
+}  // namespace sln
@@ -0,0 +1,161 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_IO_PROBE_HPP
+#define SELENE_IMG_IO_PROBE_HPP
+
+/// @file
+
+#include <selene/base/Types.hpp>
+
+#include <selene/img/Types.hpp>
+#include <selene/img_io/IO.hpp>
+
+#include <selene/thread/Parallel.hpp>
+#include <selene/thread/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sln {
+
+/** \brief Image information obtained by probing an image file, without decoding the image data.
+ */
+struct ImageProbeInfo
+{
+  ImageFormat format = ImageFormat::Unknown;  ///< The image format; `ImageFormat::Unknown` if `is_valid() == false`.
+  PixelLength width = 0_px;  ///< Image width.
+  PixelLength height = 0_px;  ///< Image height.
+  std::uint16_t nr_channels = 0;  ///< Number of image channels.
+  std::uint16_t bit_depth = 0;  ///< Bit depth per channel.
+
+  /** \brief Returns whether the probed information is valid.
+   *
+   * @return True, if the file could be read and identified as supported image format; false otherwise.
+   */
+  bool is_valid() const { return width > 0 && height > 0 && nr_channels > 0 && bit_depth > 0; }
+};
+
+/** \brief Reads image dimensions and format of image files, without decoding the image data.
+ *
+ * The image format is determined from the leading magic bytes of a file, so that no decoder has to be tried in vain.
+ * Only the first few KB of each file are read in the common case:
+ * - For PNG files, all information is contained in the IHDR chunk, at a fixed offset after the signature.
+ * - For JPEG files, the header is parsed from the initial part of the file using an internal, reused JPEG
+ *   decompression object. Only if the frame header is not contained therein (e.g. due to large embedded metadata), the
+ *   header is read from the complete file.
+ *
+ * An ImageProber instance may be reused for an arbitrary number of files, but should not be shared between threads.
+ */
+class ImageProber
+{
+public:
+  ImageProber();
+  ~ImageProber();
+
+  ImageProber(const ImageProber&) = delete;  ///< Copy constructor (deleted).
+  ImageProber& operator=(const ImageProber&) = delete;  ///< Copy assignment operator (deleted).
+  ImageProber(ImageProber&&) noexcept;  ///< Move constructor.
+  ImageProber& operator=(ImageProber&&) noexcept;  ///< Move assignment operator.
+
+  ImageProbeInfo probe(const char* path);
+  ImageProbeInfo probe(const std::string& path);
+
+  static constexpr std::size_t prefix_size = 4096;  ///< Number of bytes initially read from each file.
+
+private:
+  struct Impl;
+  std::unique_ptr<Impl> impl_;
+};
+
+ImageProbeInfo probe_image(const std::string& path);
+
+std::vector<ImageProbeInfo> probe_images(const std::vector<std::string>& paths);
+
+std::vector<ImageProbeInfo> probe_images(const std::vector<std::string>& paths, ThreadPool& thread_pool);
+
+// ----------
+// Implementation:
+
+/// \cond INTERNAL
+namespace detail {
+
+ImageProber& thread_local_image_prober();
+
+}  // namespace detail
+/// \endcond
+
+/** \brief Probes the specified image file.
+ *
+ * @param path The path to the image file.
+ * @return The probed image information. Is invalid if the file could not be read or is not a supported image file.
+ */
+inline ImageProbeInfo ImageProber::probe(const std::string& path)
+{
+  return probe(path.c_str());
+}
+
+/** \brief Probes the specified image file, using a temporary ImageProber instance.
+ *
+ * To probe many files, use probe_images() or a reused ImageProber instance instead.
+ *
+ * @param path The path to the image file.
+ * @return The probed image information. Is invalid if the file could not be read or is not a supported image file.
+ */
+inline ImageProbeInfo probe_image(const std::string& path)
+{
+  return ImageProber().probe(path);
+}
+
+/** \brief Probes the specified image files, reusing one ImageProber instance.
+ *
+ * @param paths The paths to the image files.
+ * @return The probed image information, in the same order as `paths`. Entries for files that could not be read or are
+ * not supported image files are invalid.
+ */
+inline std::vector<ImageProbeInfo> probe_images(const std::vector<std::string>& paths)
+{
+  std::vector<ImageProbeInfo> infos(paths.size());
+  ImageProber prober;
+  std::transform(paths.cbegin(), paths.cend(), infos.begin(), [&prober](const auto& path) {
+    return prober.probe(path);
+  });
+  return infos;
+}
+
+/** \brief Probes the specified image files in parallel, on the provided thread pool.
+ *
+ * The list of paths is partitioned into a few blocks per thread. Each thread (including the calling one) probes its
+ * blocks using its own thread-local ImageProber instance, which is kept alive for the lifetime of the thread, and
+ * hence also reused by subsequent calls.
+ *
+ * @param paths The paths to the image files.
+ * @param thread_pool The thread pool to use for parallel execution.
+ * @return The probed image information, in the same order as `paths`. Entries for files that could not be read or are
+ * not supported image files are invalid.
+ */
+inline std::vector<ImageProbeInfo> probe_images(const std::vector<std::string>& paths, ThreadPool& thread_pool)
+{
+  std::vector<ImageProbeInfo> infos(paths.size());
+
+  const auto nr_blocks = 4 * (thread_pool.size() + 1);
+  const auto grain = std::max(std::size_t{1}, (paths.size() + nr_blocks - 1) / nr_blocks);
+
+  parallel_for(thread_pool, std::size_t{0}, paths.size(), grain, [&](std::size_t begin, std::size_t end) {
+    auto& prober = detail::thread_local_image_prober();
+    for (auto i = begin; i < end; ++i)
+    {
+      infos[i] = prober.probe(paths[i]);
+    }
+  });
+
+  return infos;
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_IO_PROBE_HPP
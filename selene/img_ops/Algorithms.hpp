@@ -8,8 +8,15 @@
 /// @file
 
 #include <selene/img/Image.hpp>
+#include <selene/img/OrientedView.hpp>
 #include <selene/img/Pixel.hpp>
 
+#include <selene/img_ops/detail/RowBands.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <cstdint>
+
 namespace sln {
 
 /** \brief Applies a unary function to each pixel value of an image.
@@ -34,6 +41,35 @@ UnaryFunction for_each_pixel(Image<PixelType>& img, UnaryFunction f)
   return std::move(f);
 }
 
+/** \brief Applies a unary function to each pixel value of an image, in parallel.
+ *
+ * The image is split into bands of rows, each of which is processed as a separate task on the thread pool.
+ * The function returns after all rows have been processed.
+ *
+ * Each task operates on its own copy of `f`; the function therefore should not rely on internal state being shared
+ * across invocations.
+ *
+ * @tparam PixelType The pixel type of the image.
+ * @tparam UnaryFunction The unary function type.
+ * @param[in,out] img The image to apply the function on.
+ * @param f The unary function to apply to each pixel. Its signature should be `void f(PixelType&)`.
+ * @param thread_pool The thread pool on which to execute the tasks.
+ */
+template <typename PixelType, typename UnaryFunction>
+void for_each_pixel(Image<PixelType>& img, UnaryFunction f, ThreadPool& thread_pool)
+{
+  detail::for_each_row_band(thread_pool, img.height(), [&img, &f](PixelIndex y_begin, PixelIndex y_end) {
+    auto f_band = f;
+    for (auto y = y_begin; y < y_end; ++y)
+    {
+      for (auto ptr = img.data(y), end = img.data_row_end(y); ptr != end; ++ptr)
+      {
+        f_band(*ptr);
+      }
+    }
+  });
+}
+
 /** \brief Transforms one image into another by applying a unary operation to each pixel value.
  *
  * `sln::Image<PixelTypeDst>::maybe_allocate` is called on the destination image prior to performing the operation.
@@ -79,6 +115,181 @@ Image<PixelTypeDst> transform_pixels(const Image<PixelTypeSrc>& img_src, UnaryOp
   return img_dst;
 }
 
+/** \brief Transforms one image into another by applying a unary operation to each pixel value, in parallel.
+ *
+ * `sln::Image<PixelTypeDst>::maybe_allocate` is called on the destination image prior to performing the operation.
+ * The destination image is then split into bands of rows, each of which is processed as a separate task on the thread
+ * pool. The function returns after all rows have been processed.
+ *
+ * @tparam PixelTypeDst The pixel type of the destination image.
+ * @tparam PixelTypeSrc The pixel type of the source image.
+ * @tparam UnaryOperation The unary operation type.
+ * @param img_src The source image.
+ * @param[out] img_dst The destination image.
+ * @param op The unary operation. Its signature should be `PixelTypeDst f(const PixelTypeSrc&)` or `PixelTypeDst
+ * f(PixelTypeSrc)`. It will be called concurrently from multiple threads.
+ * @param thread_pool The thread pool on which to execute the tasks.
+ */
+template <typename PixelTypeDst, typename PixelTypeSrc, typename UnaryOperation>
+void transform_pixels(const Image<PixelTypeSrc>& img_src,
+                      Image<PixelTypeDst>& img_dst,
+                      UnaryOperation op,
+                      ThreadPool& thread_pool)
+{
+  img_dst.maybe_allocate(img_src.width(), img_src.height());
+
+  detail::for_each_row_band(thread_pool, img_dst.height(), [&img_src, &img_dst, &op](PixelIndex y_begin,
+                                                                                     PixelIndex y_end) {
+    for (auto y = y_begin; y < y_end; ++y)
+    {
+      auto ptr_src = img_src.data(y);
+      for (auto ptr_dst = img_dst.data(y), ptr_dst_end = img_dst.data_row_end(y); ptr_dst != ptr_dst_end;)
+      {
+        *ptr_dst++ = op(*ptr_src++);
+      }
+    }
+  });
+}
+
+/** \brief Transforms one image into another by applying a unary operation to each pixel value, in parallel.
+ *
+ * @tparam PixelTypeDst The pixel type of the destination image.
+ * @tparam PixelTypeSrc The pixel type of the source image.
+ * @tparam UnaryOperation The unary operation type.
+ * @param img_src The source image.
+ * @param op The unary operation. Its signature should be `PixelTypeDst f(const PixelTypeSrc&)` or `PixelTypeDst
+ * f(PixelTypeSrc)`. It will be called concurrently from multiple threads.
+ * @param thread_pool The thread pool on which to execute the tasks.
+ * @return The destination image.
+ */
+template <typename PixelTypeDst, typename PixelTypeSrc, typename UnaryOperation>
+Image<PixelTypeDst> transform_pixels(const Image<PixelTypeSrc>& img_src, UnaryOperation op, ThreadPool& thread_pool)
+{
+  Image<PixelTypeDst> img_dst(img_src.width(), img_src.height());
+  transform_pixels(img_src, img_dst, op, thread_pool);
+  return img_dst;
+}
+
+/// \cond INTERNAL
+
+namespace detail {
+
+template <typename PixelTypeDst, typename PixelTypeSrc, typename UnaryOperation>
+void transform_oriented_rows(const OrientedView<PixelTypeSrc>& view_src,
+                             Image<PixelTypeDst>& img_dst,
+                             UnaryOperation& op,
+                             PixelIndex y_begin,
+                             PixelIndex y_end)
+{
+  // Each row of the view is a constant-stride walk through the underlying image (either along a row or a column).
+  const auto step = view_src.pixel_step_bytes();
+  for (auto y = y_begin; y < y_end; ++y)
+  {
+    auto ptr_src = reinterpret_cast<const std::uint8_t*>(view_src.row_origin(y));
+    for (auto ptr_dst = img_dst.data(y), ptr_dst_end = img_dst.data_row_end(y); ptr_dst != ptr_dst_end; ptr_src += step)
+    {
+      *ptr_dst++ = op(*reinterpret_cast<const PixelTypeSrc*>(ptr_src));
+    }
+  }
+}
+
+}  // namespace detail
+
+/// \endcond
+
+/** \brief Transforms an oriented view into an image by applying a unary operation to each pixel value.
+ *
+ * The orientation is applied on the fly; no intermediate image is allocated.
+ * `sln::Image<PixelTypeDst>::maybe_allocate` is called on the destination image prior to performing the operation.
+ *
+ * @tparam PixelTypeDst The pixel type of the destination image.
+ * @tparam PixelTypeSrc The pixel type of the source view.
+ * @tparam UnaryOperation The unary operation type.
+ * @param view_src The source view.
+ * @param[out] img_dst The destination image.
+ * @param op The unary operation. Its signature should be `PixelTypeDst f(const PixelTypeSrc&)` or `PixelTypeDst
+ * f(PixelTypeSrc)`.
+ */
+template <typename PixelTypeDst, typename PixelTypeSrc, typename UnaryOperation>
+void transform_pixels(const OrientedView<PixelTypeSrc>& view_src, Image<PixelTypeDst>& img_dst, UnaryOperation op)
+{
+  img_dst.maybe_allocate(view_src.width(), view_src.height());
+  detail::transform_oriented_rows(view_src, img_dst, op, 0_idx, to_pixel_index(img_dst.height()));
+}
+
+/** \brief Transforms an oriented view into an image by applying a unary operation to each pixel value.
+ *
+ * The orientation is applied on the fly; no intermediate image is allocated.
+ *
+ * @tparam PixelTypeDst The pixel type of the destination image.
+ * @tparam PixelTypeSrc The pixel type of the source view.
+ * @tparam UnaryOperation The unary operation type.
+ * @param view_src The source view.
+ * @param op The unary operation. Its signature should be `PixelTypeDst f(const PixelTypeSrc&)` or `PixelTypeDst
+ * f(PixelTypeSrc)`.
+ * @return The destination image.
+ */
+template <typename PixelTypeDst, typename PixelTypeSrc, typename UnaryOperation>
+Image<PixelTypeDst> transform_pixels(const OrientedView<PixelTypeSrc>& view_src, UnaryOperation op)
+{
+  Image<PixelTypeDst> img_dst(view_src.width(), view_src.height());
+  transform_pixels(view_src, img_dst, op);
+  return img_dst;
+}
+
+/** \brief Transforms an oriented view into an image by applying a unary operation to each pixel value, in parallel.
+ *
+ * The orientation is applied on the fly; no intermediate image is allocated.
+ * `sln::Image<PixelTypeDst>::maybe_allocate` is called on the destination image prior to performing the operation.
+ * The destination image is then split into bands of rows, each of which is processed as a separate task on the thread
+ * pool. The function returns after all rows have been processed.
+ *
+ * @tparam PixelTypeDst The pixel type of the destination image.
+ * @tparam PixelTypeSrc The pixel type of the source view.
+ * @tparam UnaryOperation The unary operation type.
+ * @param view_src The source view.
+ * @param[out] img_dst The destination image.
+ * @param op The unary operation. Its signature should be `PixelTypeDst f(const PixelTypeSrc&)` or `PixelTypeDst
+ * f(PixelTypeSrc)`. It will be called concurrently from multiple threads.
+ * @param thread_pool The thread pool on which to execute the tasks.
+ */
+template <typename PixelTypeDst, typename PixelTypeSrc, typename UnaryOperation>
+void transform_pixels(const OrientedView<PixelTypeSrc>& view_src,
+                      Image<PixelTypeDst>& img_dst,
+                      UnaryOperation op,
+                      ThreadPool& thread_pool)
+{
+  img_dst.maybe_allocate(view_src.width(), view_src.height());
+
+  detail::for_each_row_band(thread_pool, img_dst.height(), [&view_src, &img_dst, &op](PixelIndex y_begin,
+                                                                                      PixelIndex y_end) {
+    detail::transform_oriented_rows(view_src, img_dst, op, y_begin, y_end);
+  });
+}
+
+/** \brief Transforms an oriented view into an image by applying a unary operation to each pixel value, in parallel.
+ *
+ * The orientation is applied on the fly; no intermediate image is allocated.
+ *
+ * @tparam PixelTypeDst The pixel type of the destination image.
+ * @tparam PixelTypeSrc The pixel type of the source view.
+ * @tparam UnaryOperation The unary operation type.
+ * @param view_src The source view.
+ * @param op The unary operation. Its signature should be `PixelTypeDst f(const PixelTypeSrc&)` or `PixelTypeDst
+ * f(PixelTypeSrc)`. It will be called concurrently from multiple threads.
+ * @param thread_pool The thread pool on which to execute the tasks.
+ * @return The destination image.
+ */
+template <typename PixelTypeDst, typename PixelTypeSrc, typename UnaryOperation>
+Image<PixelTypeDst> transform_pixels(const OrientedView<PixelTypeSrc>& view_src,
+                                     UnaryOperation op,
+                                     ThreadPool& thread_pool)
+{
+  Image<PixelTypeDst> img_dst(view_src.width(), view_src.height());
+  transform_pixels(view_src, img_dst, op, thread_pool);
+  return img_dst;
+}
+
 }  // namespace sln
 
 #endif  // SELENE_IMG_ALGORITHMS_HPP
@@ -0,0 +1,719 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_CONVOLUTION_HPP
+#define SELENE_IMG_CONVOLUTION_HPP
+
+/// @file
+
+#include <selene/base/Assert.hpp>
+#include <selene/base/SIMD.hpp>
+#include <selene/base/Types.hpp>
+
+#include <selene/img/BorderAccessors.hpp>
+#include <selene/img/Image.hpp>
+#include <selene/img/PixelTraits.hpp>
+#include <selene/img/Types.hpp>
+
+#include <selene/img_ops/detail/RowBands.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+template <std::size_t kernel_size>
+std::array<default_float_t, kernel_size> gaussian_kernel(default_float_t sigma);
+
+template <std::size_t kernel_size>
+std::array<default_float_t, kernel_size> box_kernel();
+
+template <BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType,
+          std::size_t kernel_size_x,
+          std::size_t kernel_size_y>
+void convolve_separable(const Image<PixelType>& img_src,
+                        const std::array<default_float_t, kernel_size_x>& kernel_x,
+                        const std::array<default_float_t, kernel_size_y>& kernel_y,
+                        Image<PixelType>& img_dst);
+
+template <BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType,
+          std::size_t kernel_size_x,
+          std::size_t kernel_size_y>
+Image<PixelType> convolve_separable(const Image<PixelType>& img,
+                                    const std::array<default_float_t, kernel_size_x>& kernel_x,
+                                    const std::array<default_float_t, kernel_size_y>& kernel_y);
+
+template <BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType,
+          std::size_t kernel_size_x,
+          std::size_t kernel_size_y>
+void convolve_separable(const Image<PixelType>& img_src,
+                        const std::array<default_float_t, kernel_size_x>& kernel_x,
+                        const std::array<default_float_t, kernel_size_y>& kernel_y,
+                        Image<PixelType>& img_dst,
+                        ThreadPool& thread_pool);
+
+template <BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType,
+          std::size_t kernel_size_x,
+          std::size_t kernel_size_y>
+Image<PixelType> convolve_separable(const Image<PixelType>& img,
+                                    const std::array<default_float_t, kernel_size_x>& kernel_x,
+                                    const std::array<default_float_t, kernel_size_y>& kernel_y,
+                                    ThreadPool& thread_pool);
+
+template <std::size_t kernel_size,
+          BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType>
+void gaussian_blur(const Image<PixelType>& img_src, default_float_t sigma, Image<PixelType>& img_dst);
+
+template <std::size_t kernel_size,
+          BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType>
+Image<PixelType> gaussian_blur(const Image<PixelType>& img, default_float_t sigma);
+
+template <std::size_t kernel_size,
+          BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType>
+void gaussian_blur(const Image<PixelType>& img_src,
+                   default_float_t sigma,
+                   Image<PixelType>& img_dst,
+                   ThreadPool& thread_pool);
+
+template <std::size_t kernel_size,
+          BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType>
+Image<PixelType> gaussian_blur(const Image<PixelType>& img, default_float_t sigma, ThreadPool& thread_pool);
+
+template <std::size_t kernel_size,
+          BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType>
+void box_filter(const Image<PixelType>& img_src, Image<PixelType>& img_dst);
+
+template <std::size_t kernel_size,
+          BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType>
+Image<PixelType> box_filter(const Image<PixelType>& img);
+
+template <std::size_t kernel_size,
+          BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType>
+void box_filter(const Image<PixelType>& img_src, Image<PixelType>& img_dst, ThreadPool& thread_pool);
+
+template <std::size_t kernel_size,
+          BorderAccessMode border_access_mode = BorderAccessMode::Replicated,
+          typename PixelType>
+Image<PixelType> box_filter(const Image<PixelType>& img, ThreadPool& thread_pool);
+
+// ----------
+// Implementation:
+
+/// \cond INTERNAL
+
+namespace detail {
+
+/// Target size of the intermediate (horizontally filtered) row buffer, s.t. it remains cache resident.
+constexpr std::size_t convolution_tile_bytes = 256 * 1024;
+
+/// Minimum width (in pixels) of the column strips into which the image is split to meet `convolution_tile_bytes`.
+constexpr std::size_t convolution_min_strip_width = 256;
+
+// Accumulation happens in single precision for 8- and 16-bit integral elements, and in at least double precision
+// otherwise.
+template <typename Element>
+using ConvolutionAccumulator = std::conditional_t<(sizeof(Element) <= 2 && std::is_integral<Element>::value)
+                                                      || std::is_same<Element, float>::value,
+                                                  float,
+                                                  std::common_type_t<Element, double>>;
+
+template <BorderAccessMode border_access_mode>
+struct ConvolutionBorder;
+
+template <>
+struct ConvolutionBorder<BorderAccessMode::ZeroPadding>
+{
+  // Returns false if the index lies outside of [0, size), i.e. if the respective value is 0.
+  static bool map(std::ptrdiff_t& index, std::ptrdiff_t size) noexcept
+  {
+    return index >= 0 && index < size;
+  }
+};
+
+template <>
+struct ConvolutionBorder<BorderAccessMode::Replicated>
+{
+  static bool map(std::ptrdiff_t& index, std::ptrdiff_t size) noexcept
+  {
+    index = std::max(std::ptrdiff_t{0}, std::min(index, size - 1));
+    return true;
+  }
+};
+
+// dst[i] += weight * src[i], for i in [0, n)
+inline void multiply_add_row(float* dst, const float* src, float weight, std::ptrdiff_t n) noexcept
+{
+  std::ptrdiff_t i = 0;
+
+#if defined(SELENE_SIMD_AVX2)
+  const auto w8 = _mm256_set1_ps(weight);
+  for (; i + 8 <= n; i += 8)
+  {
+    const auto d = _mm256_loadu_ps(dst + i);
+    const auto s = _mm256_loadu_ps(src + i);
+    _mm256_storeu_ps(dst + i, _mm256_add_ps(d, _mm256_mul_ps(s, w8)));
+  }
+#endif
+
+#if defined(SELENE_SIMD_SSE2)
+  const auto w4 = _mm_set1_ps(weight);
+  for (; i + 4 <= n; i += 4)
+  {
+    const auto d = _mm_loadu_ps(dst + i);
+    const auto s = _mm_loadu_ps(src + i);
+    _mm_storeu_ps(dst + i, _mm_add_ps(d, _mm_mul_ps(s, w4)));
+  }
+#elif defined(SELENE_SIMD_NEON)
+  const auto w4 = vdupq_n_f32(weight);
+  for (; i + 4 <= n; i += 4)
+  {
+    const auto d = vld1q_f32(dst + i);
+    const auto s = vld1q_f32(src + i);
+    vst1q_f32(dst + i, vaddq_f32(d, vmulq_f32(s, w4)));
+  }
+#endif
+
+  for (; i < n; ++i)
+  {
+    dst[i] += weight * src[i];
+  }
+}
+
+template <typename Accumulator>
+void multiply_add_row(Accumulator* dst, const Accumulator* src, Accumulator weight, std::ptrdiff_t n) noexcept
+{
+  for (std::ptrdiff_t i = 0; i < n; ++i)
+  {
+    dst[i] += weight * src[i];
+  }
+}
+
+template <typename Element, typename Accumulator>
+Element convolution_result_cast(Accumulator value, std::true_type /* is_integral */) noexcept
+{
+  constexpr auto lowest = static_cast<Accumulator>(std::numeric_limits<Element>::lowest());
+  constexpr auto highest = static_cast<Accumulator>(std::numeric_limits<Element>::max());
+  value = std::max(lowest, std::min(value, highest));
+  return static_cast<Element>(value + (value < Accumulator{0} ? Accumulator{-0.5} : Accumulator{0.5}));
+}
+
+template <typename Element, typename Accumulator>
+Element convolution_result_cast(Accumulator value, std::false_type /* is_integral */) noexcept
+{
+  return static_cast<Element>(value);
+}
+
+// Horizontal pass over the pixel range [x_begin, x_end) of one row. `src` holds the source row converted to
+// accumulator values, starting at pixel `src_x_begin`; it has to cover [x_begin - kernel_size / 2, x_end +
+// kernel_size / 2), clipped to [0, width). `dst` receives the result, starting at pixel `x_begin`.
+// The unchecked interior part is computed tap by tap over the flat element range; only pixels closer than
+// `kernel_size / 2` to the left or right image border need border treatment.
+template <BorderAccessMode border_access_mode, std::size_t nr_channels, typename Accumulator, std::size_t kernel_size>
+void convolve_row_horizontal(const Accumulator* src,
+                             std::ptrdiff_t src_x_begin,
+                             Accumulator* dst,
+                             std::ptrdiff_t x_begin,
+                             std::ptrdiff_t x_end,
+                             std::ptrdiff_t width,
+                             const std::array<Accumulator, kernel_size>& kernel)
+{
+  constexpr auto radius = static_cast<std::ptrdiff_t>(kernel_size / 2);
+  constexpr auto nr_ch = static_cast<std::ptrdiff_t>(nr_channels);
+
+  const auto interior_begin = std::min(std::max(x_begin, radius), x_end);
+  const auto interior_end = std::max(interior_begin, std::min(x_end, width - radius));
+
+  const auto convolve_checked = [src, src_x_begin, dst, x_begin, width, &kernel](std::ptrdiff_t x) {
+    for (std::ptrdiff_t c = 0; c < nr_ch; ++c)
+    {
+      auto sum = Accumulator{0};
+      for (std::ptrdiff_t k = 0; k < static_cast<std::ptrdiff_t>(kernel_size); ++k)
+      {
+        auto x_src = x - radius + k;
+        if (ConvolutionBorder<border_access_mode>::map(x_src, width))
+        {
+          sum += kernel[static_cast<std::size_t>(k)] * src[(x_src - src_x_begin) * nr_ch + c];
+        }
+      }
+      dst[(x - x_begin) * nr_ch + c] = sum;
+    }
+  };
+
+  for (auto x = x_begin; x < interior_begin; ++x)
+  {
+    convolve_checked(x);
+  }
+
+  const auto n = (interior_end - interior_begin) * nr_ch;
+
+  if (n > 0)
+  {
+    const auto ptr_dst = dst + (interior_begin - x_begin) * nr_ch;
+    const auto ptr_src = src + (interior_begin - src_x_begin) * nr_ch;
+    std::fill(ptr_dst, ptr_dst + n, Accumulator{0});
+    for (std::size_t k = 0; k < kernel_size; ++k)
+    {
+      const auto offset = (static_cast<std::ptrdiff_t>(k) - radius) * nr_ch;
+      multiply_add_row(ptr_dst, ptr_src + offset, kernel[k], n);
+    }
+  }
+
+  for (auto x = interior_end; x < x_end; ++x)
+  {
+    convolve_checked(x);
+  }
+}
+
+template <BorderAccessMode border_access_mode,
+          typename PixelType,
+          std::size_t kernel_size_x,
+          std::size_t kernel_size_y,
+          typename RowRangeExecutor>
+void convolve_separable_rows(const Image<PixelType>& img_src,
+                             const std::array<default_float_t, kernel_size_x>& kernel_x,
+                             const std::array<default_float_t, kernel_size_y>& kernel_y,
+                             Image<PixelType>& img_dst,
+                             RowRangeExecutor executor)
+{
+  static_assert(border_access_mode != BorderAccessMode::Unchecked,
+                "Convolution requires a border access mode other than BorderAccessMode::Unchecked");
+  static_assert(kernel_size_x % 2 == 1 && kernel_size_y % 2 == 1, "Kernel sizes need to be odd");
+
+  using Element = typename PixelTraits<PixelType>::Element;
+  using Accumulator = ConvolutionAccumulator<Element>;
+  constexpr auto nr_channels = PixelTraits<PixelType>::nr_channels;
+  constexpr auto radius_x = static_cast<std::ptrdiff_t>(kernel_size_x / 2);
+  constexpr auto radius_y = static_cast<std::ptrdiff_t>(kernel_size_y / 2);
+
+  std::array<Accumulator, kernel_size_x> kx;
+  std::array<Accumulator, kernel_size_y> ky;
+  std::transform(kernel_x.cbegin(), kernel_x.cend(), kx.begin(), [](auto v) { return static_cast<Accumulator>(v); });
+  std::transform(kernel_y.cbegin(), kernel_y.cend(), ky.begin(), [](auto v) { return static_cast<Accumulator>(v); });
+
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto height = static_cast<std::ptrdiff_t>(img_src.height());
+
+  if (width == 0 || height == 0)
+  {
+    return;
+  }
+
+  // The image is processed in column strips that are narrow enough for the ring buffer of `kernel_size_y`
+  // horizontally filtered rows to stay cache resident. Each strip spans at least `convolution_min_strip_width` pixels
+  // (or the whole image), so that the overhead of the horizontal kernel overlap between strips remains small.
+  const auto ring_row_capacity = convolution_tile_bytes / (kernel_size_y * nr_channels * sizeof(Accumulator));
+  const auto strip_width = std::min(
+      width, static_cast<std::ptrdiff_t>(std::max(convolution_min_strip_width, ring_row_capacity)));
+
+  executor([&](PixelIndex y_dst_begin, PixelIndex y_dst_end) {
+    constexpr auto nr_ch = static_cast<std::ptrdiff_t>(nr_channels);
+    const auto strip_elements = static_cast<std::size_t>(strip_width * nr_ch);
+
+    std::vector<Accumulator> src_row(static_cast<std::size_t>((strip_width + 2 * radius_x) * nr_ch));
+    std::vector<Accumulator> dst_row(strip_elements);
+    std::vector<Accumulator> ring(kernel_size_y * strip_elements);
+    std::array<std::ptrdiff_t, kernel_size_y> ring_rows;
+    std::array<const Accumulator*, kernel_size_y> taps;
+
+    for (auto x_begin = std::ptrdiff_t{0}; x_begin < width; x_begin += strip_width)
+    {
+      const auto x_end = std::min(x_begin + strip_width, width);
+      const auto src_x_begin = std::max(std::ptrdiff_t{0}, x_begin - radius_x);
+      const auto src_x_end = std::min(width, x_end + radius_x);
+      const auto nr_elements = static_cast<std::size_t>((x_end - x_begin) * nr_ch);
+
+      // Returns the horizontally filtered source row `y_src`, restricted to the current strip. Rows are kept in a ring
+      // buffer, indexed by `y_src % kernel_size_y`; since each output row only needs rows out of a contiguous range of
+      // at most `kernel_size_y` source rows, each source row is filtered exactly once per strip and band.
+      ring_rows.fill(-1);
+      const auto get_filtered_row = [&](std::ptrdiff_t y_src) {
+        const auto slot = static_cast<std::size_t>(y_src % static_cast<std::ptrdiff_t>(kernel_size_y));
+        const auto ptr_ring = ring.data() + slot * strip_elements;
+
+        if (ring_rows[slot] != y_src)
+        {
+          const auto ptr_src =
+              reinterpret_cast<const Element*>(img_src.data(to_pixel_index(y_src))) + src_x_begin * nr_ch;
+          std::transform(ptr_src, ptr_src + (src_x_end - src_x_begin) * nr_ch, src_row.begin(),
+                         [](Element v) { return static_cast<Accumulator>(v); });
+          convolve_row_horizontal<border_access_mode, nr_channels>(src_row.data(), src_x_begin, ptr_ring, x_begin,
+                                                                   x_end, width, kx);
+          ring_rows[slot] = y_src;
+        }
+
+        return static_cast<const Accumulator*>(ptr_ring);
+      };
+
+      for (auto y = static_cast<std::ptrdiff_t>(y_dst_begin); y < static_cast<std::ptrdiff_t>(y_dst_end); ++y)
+      {
+        for (std::size_t k = 0; k < kernel_size_y; ++k)
+        {
+          auto y_src = y - radius_y + static_cast<std::ptrdiff_t>(k);
+          taps[k] = ConvolutionBorder<border_access_mode>::map(y_src, height) ? get_filtered_row(y_src) : nullptr;
+        }
+
+        std::fill(dst_row.begin(), dst_row.begin() + static_cast<std::ptrdiff_t>(nr_elements), Accumulator{0});
+        for (std::size_t k = 0; k < kernel_size_y; ++k)
+        {
+          if (taps[k] != nullptr)
+          {
+            multiply_add_row(dst_row.data(), taps[k], ky[k], static_cast<std::ptrdiff_t>(nr_elements));
+          }
+        }
+
+        const auto ptr_dst = reinterpret_cast<Element*>(img_dst.data(to_pixel_index(y))) + x_begin * nr_ch;
+        std::transform(dst_row.cbegin(), dst_row.cbegin() + static_cast<std::ptrdiff_t>(nr_elements), ptr_dst,
+                       [](Accumulator v) {
+                         return convolution_result_cast<Element>(
+                             v, std::integral_constant<bool, std::is_integral<Element>::value>{});
+                       });
+      }
+    }
+  });
+}
+
+}  // namespace detail
+
+/// \endcond
+
+/** \brief Returns a normalized 1-D Gaussian kernel of the specified size.
+ *
+ * @tparam kernel_size The kernel size. Needs to be odd.
+ * @param sigma The standard deviation of the Gaussian. If not positive, it is derived from the kernel size as
+ * `0.3 * ((kernel_size - 1) * 0.5 - 1) + 0.8`.
+ * @return The Gaussian kernel; its elements sum to 1.
+ */
+template <std::size_t kernel_size>
+std::array<default_float_t, kernel_size> gaussian_kernel(default_float_t sigma)
+{
+  static_assert(kernel_size % 2 == 1, "Kernel size needs to be odd");
+
+  if (sigma <= default_float_t{0})
+  {
+    sigma = default_float_t(0.3) * ((kernel_size - 1) * default_float_t(0.5) - 1) + default_float_t(0.8);
+  }
+
+  constexpr auto radius = static_cast<std::ptrdiff_t>(kernel_size / 2);
+  std::array<default_float_t, kernel_size> kernel;
+  auto sum = default_float_t{0};
+
+  for (std::size_t k = 0; k < kernel_size; ++k)
+  {
+    const auto x = static_cast<default_float_t>(static_cast<std::ptrdiff_t>(k) - radius);
+    kernel[k] = std::exp(-(x * x) / (2 * sigma * sigma));
+    sum += kernel[k];
+  }
+
+  std::for_each(kernel.begin(), kernel.end(), [sum](default_float_t& v) { v /= sum; });
+  return kernel;
+}
+
+/** \brief Returns a normalized 1-D box (i.e. uniform) kernel of the specified size.
+ *
+ * @tparam kernel_size The kernel size. Needs to be odd.
+ * @return The box kernel; all elements are equal to `1 / kernel_size`.
+ */
+template <std::size_t kernel_size>
+std::array<default_float_t, kernel_size> box_kernel()
+{
+  static_assert(kernel_size % 2 == 1, "Kernel size needs to be odd");
+
+  std::array<default_float_t, kernel_size> kernel;
+  kernel.fill(default_float_t{1} / kernel_size);
+  return kernel;
+}
+
+/** \brief Convolves an image with a separable kernel, given by a horizontal and a vertical 1-D kernel.
+ *
+ * The horizontal pass is computed first, followed by the vertical pass; intermediate values are kept in floating point
+ * precision. For integral pixel element types, results are rounded and saturated.
+ * Each source row is filtered horizontally only once, into a ring buffer of `kernel_size_y` rows; wide images are
+ * split into column strips, s.t. this buffer stays in cache. Only pixels within `kernel_size / 2` of the image border
+ * are computed using the (slower) border-checked access.
+ *
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @tparam kernel_size_x The size of the horizontal kernel. Needs to be odd.
+ * @tparam kernel_size_y The size of the vertical kernel. Needs to be odd.
+ * @param img_src The source image.
+ * @param kernel_x The horizontal kernel.
+ * @param kernel_y The vertical kernel.
+ * @param img_dst The output image. Needs to be different from `img_src`.
+ */
+template <BorderAccessMode border_access_mode,
+          typename PixelType,
+          std::size_t kernel_size_x,
+          std::size_t kernel_size_y>
+void convolve_separable(const Image<PixelType>& img_src,
+                        const std::array<default_float_t, kernel_size_x>& kernel_x,
+                        const std::array<default_float_t, kernel_size_y>& kernel_y,
+                        Image<PixelType>& img_dst)
+{
+  SELENE_ASSERT(&img_src != &img_dst);
+
+  img_dst.maybe_allocate(img_src.width(), img_src.height());
+
+  detail::convolve_separable_rows<border_access_mode>(img_src, kernel_x, kernel_y, img_dst, [&img_dst](auto func) {
+    func(0_idx, to_pixel_index(img_dst.height()));
+  });
+}
+
+/** \brief Convolves an image with a separable kernel, given by a horizontal and a vertical 1-D kernel.
+ *
+ * See the overload taking an output image for details.
+ *
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @tparam kernel_size_x The size of the horizontal kernel. Needs to be odd.
+ * @tparam kernel_size_y The size of the vertical kernel. Needs to be odd.
+ * @param img The source image.
+ * @param kernel_x The horizontal kernel.
+ * @param kernel_y The vertical kernel.
+ * @return The output image.
+ */
+template <BorderAccessMode border_access_mode,
+          typename PixelType,
+          std::size_t kernel_size_x,
+          std::size_t kernel_size_y>
+Image<PixelType> convolve_separable(const Image<PixelType>& img,
+                                    const std::array<default_float_t, kernel_size_x>& kernel_x,
+                                    const std::array<default_float_t, kernel_size_y>& kernel_y)
+{
+  Image<PixelType> img_dst;
+  convolve_separable<border_access_mode>(img, kernel_x, kernel_y, img_dst);
+  return img_dst;
+}
+
+/** \brief Convolves an image with a separable kernel, given by a horizontal and a vertical 1-D kernel.
+ *
+ * The output image is split into bands of rows, each of which is computed as a separate task on the thread pool.
+ * See the single-threaded overload for details.
+ *
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @tparam kernel_size_x The size of the horizontal kernel. Needs to be odd.
+ * @tparam kernel_size_y The size of the vertical kernel. Needs to be odd.
+ * @param img_src The source image.
+ * @param kernel_x The horizontal kernel.
+ * @param kernel_y The vertical kernel.
+ * @param img_dst The output image. Needs to be different from `img_src`.
+ * @param thread_pool The thread pool on which to execute the convolution.
+ */
+template <BorderAccessMode border_access_mode,
+          typename PixelType,
+          std::size_t kernel_size_x,
+          std::size_t kernel_size_y>
+void convolve_separable(const Image<PixelType>& img_src,
+                        const std::array<default_float_t, kernel_size_x>& kernel_x,
+                        const std::array<default_float_t, kernel_size_y>& kernel_y,
+                        Image<PixelType>& img_dst,
+                        ThreadPool& thread_pool)
+{
+  SELENE_ASSERT(&img_src != &img_dst);
+
+  img_dst.maybe_allocate(img_src.width(), img_src.height());
+
+  detail::convolve_separable_rows<border_access_mode>(img_src, kernel_x, kernel_y, img_dst,
+                                                      [&img_dst, &thread_pool](auto func) {
+                                                        detail::for_each_row_band(thread_pool, img_dst.height(), func);
+                                                      });
+}
+
+/** \brief Convolves an image with a separable kernel, given by a horizontal and a vertical 1-D kernel.
+ *
+ * The output image is split into bands of rows, each of which is computed as a separate task on the thread pool.
+ * See the single-threaded overload for details.
+ *
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @tparam kernel_size_x The size of the horizontal kernel. Needs to be odd.
+ * @tparam kernel_size_y The size of the vertical kernel. Needs to be odd.
+ * @param img The source image.
+ * @param kernel_x The horizontal kernel.
+ * @param kernel_y The vertical kernel.
+ * @param thread_pool The thread pool on which to execute the convolution.
+ * @return The output image.
+ */
+template <BorderAccessMode border_access_mode,
+          typename PixelType,
+          std::size_t kernel_size_x,
+          std::size_t kernel_size_y>
+Image<PixelType> convolve_separable(const Image<PixelType>& img,
+                                    const std::array<default_float_t, kernel_size_x>& kernel_x,
+                                    const std::array<default_float_t, kernel_size_y>& kernel_y,
+                                    ThreadPool& thread_pool)
+{
+  Image<PixelType> img_dst;
+  convolve_separable<border_access_mode>(img, kernel_x, kernel_y, img_dst, thread_pool);
+  return img_dst;
+}
+
+/** \brief Blurs an image with a Gaussian kernel of the specified size.
+ *
+ * @tparam kernel_size The kernel size, in both dimensions. Needs to be odd.
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @param img_src The source image.
+ * @param sigma The standard deviation of the Gaussian. If not positive, it is derived from the kernel size.
+ * @param img_dst The output image. Needs to be different from `img_src`.
+ */
+template <std::size_t kernel_size, BorderAccessMode border_access_mode, typename PixelType>
+void gaussian_blur(const Image<PixelType>& img_src, default_float_t sigma, Image<PixelType>& img_dst)
+{
+  const auto kernel = gaussian_kernel<kernel_size>(sigma);
+  convolve_separable<border_access_mode>(img_src, kernel, kernel, img_dst);
+}
+
+/** \brief Blurs an image with a Gaussian kernel of the specified size.
+ *
+ * @tparam kernel_size The kernel size, in both dimensions. Needs to be odd.
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @param img The source image.
+ * @param sigma The standard deviation of the Gaussian. If not positive, it is derived from the kernel size.
+ * @return The blurred image.
+ */
+template <std::size_t kernel_size, BorderAccessMode border_access_mode, typename PixelType>
+Image<PixelType> gaussian_blur(const Image<PixelType>& img, default_float_t sigma)
+{
+  Image<PixelType> img_dst;
+  gaussian_blur<kernel_size, border_access_mode>(img, sigma, img_dst);
+  return img_dst;
+}
+
+/** \brief Blurs an image with a Gaussian kernel of the specified size, in parallel on a thread pool.
+ *
+ * @tparam kernel_size The kernel size, in both dimensions. Needs to be odd.
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @param img_src The source image.
+ * @param sigma The standard deviation of the Gaussian. If not positive, it is derived from the kernel size.
+ * @param img_dst The output image. Needs to be different from `img_src`.
+ * @param thread_pool The thread pool on which to execute the filtering.
+ */
+template <std::size_t kernel_size, BorderAccessMode border_access_mode, typename PixelType>
+void gaussian_blur(const Image<PixelType>& img_src,
+                   default_float_t sigma,
+                   Image<PixelType>& img_dst,
+                   ThreadPool& thread_pool)
+{
+  const auto kernel = gaussian_kernel<kernel_size>(sigma);
+  convolve_separable<border_access_mode>(img_src, kernel, kernel, img_dst, thread_pool);
+}
+
+/** \brief Blurs an image with a Gaussian kernel of the specified size, in parallel on a thread pool.
+ *
+ * @tparam kernel_size The kernel size, in both dimensions. Needs to be odd.
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @param img The source image.
+ * @param sigma The standard deviation of the Gaussian. If not positive, it is derived from the kernel size.
+ * @param thread_pool The thread pool on which to execute the filtering.
+ * @return The blurred image.
+ */
+template <std::size_t kernel_size, BorderAccessMode border_access_mode, typename PixelType>
+Image<PixelType> gaussian_blur(const Image<PixelType>& img, default_float_t sigma, ThreadPool& thread_pool)
+{
+  Image<PixelType> img_dst;
+  gaussian_blur<kernel_size, border_access_mode>(img, sigma, img_dst, thread_pool);
+  return img_dst;
+}
+
+/** \brief Filters an image with a normalized box kernel (i.e. computes the local mean) of the specified size.
+ *
+ * @tparam kernel_size The kernel size, in both dimensions. Needs to be odd.
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @param img_src The source image.
+ * @param img_dst The output image. Needs to be different from `img_src`.
+ */
+template <std::size_t kernel_size, BorderAccessMode border_access_mode, typename PixelType>
+void box_filter(const Image<PixelType>& img_src, Image<PixelType>& img_dst)
+{
+  const auto kernel = box_kernel<kernel_size>();
+  convolve_separable<border_access_mode>(img_src, kernel, kernel, img_dst);
+}
+
+/** \brief Filters an image with a normalized box kernel (i.e. computes the local mean) of the specified size.
+ *
+ * @tparam kernel_size The kernel size, in both dimensions. Needs to be odd.
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @param img The source image.
+ * @return The filtered image.
+ */
+template <std::size_t kernel_size, BorderAccessMode border_access_mode, typename PixelType>
+Image<PixelType> box_filter(const Image<PixelType>& img)
+{
+  Image<PixelType> img_dst;
+  box_filter<kernel_size, border_access_mode>(img, img_dst);
+  return img_dst;
+}
+
+/** \brief Filters an image with a normalized box kernel of the specified size, in parallel on a thread pool.
+ *
+ * @tparam kernel_size The kernel size, in both dimensions. Needs to be odd.
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @param img_src The source image.
+ * @param img_dst The output image. Needs to be different from `img_src`.
+ * @param thread_pool The thread pool on which to execute the filtering.
+ */
+template <std::size_t kernel_size, BorderAccessMode border_access_mode, typename PixelType>
+void box_filter(const Image<PixelType>& img_src, Image<PixelType>& img_dst, ThreadPool& thread_pool)
+{
+  const auto kernel = box_kernel<kernel_size>();
+  convolve_separable<border_access_mode>(img_src, kernel, kernel, img_dst, thread_pool);
+}
+
+/** \brief Filters an image with a normalized box kernel of the specified size, in parallel on a thread pool.
+ *
+ * @tparam kernel_size The kernel size, in both dimensions. Needs to be odd.
+ * @tparam border_access_mode The border access mode; either `BorderAccessMode::ZeroPadding` or
+ * `BorderAccessMode::Replicated`.
+ * @tparam PixelType The pixel type.
+ * @param img The source image.
+ * @param thread_pool The thread pool on which to execute the filtering.
+ * @return The filtered image.
+ */
+template <std::size_t kernel_size, BorderAccessMode border_access_mode, typename PixelType>
+Image<PixelType> box_filter(const Image<PixelType>& img, ThreadPool& thread_pool)
+{
+  Image<PixelType> img_dst;
+  box_filter<kernel_size, border_access_mode>(img, img_dst, thread_pool);
+  return img_dst;
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_CONVOLUTION_HPP
@@ -11,6 +11,12 @@
 #include <selene/img/PixelTraits.hpp>
 #include <selene/img_ops/Algorithms.hpp>
 #include <selene/img_ops/PixelConversions.hpp>
+#include <selene/img_ops/detail/ConversionKernels.hpp>
+#include <selene/img_ops/detail/RowBands.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <cstddef>
 
 namespace sln {
 
@@ -42,6 +48,37 @@ template <PixelFormat pixel_format_src,
           typename = std::enable_if_t<conversion_requires_alpha_value(pixel_format_src, pixel_format_dst)>>
 auto convert_image(const Image<PixelSrc>& img_src, ElementType alpha_value);
 
+template <PixelFormat pixel_format_src,
+          PixelFormat pixel_format_dst,
+          typename PixelSrc,
+          typename PixelDst,
+          typename = std::enable_if_t<!conversion_requires_alpha_value(pixel_format_src, pixel_format_dst)>>
+void convert_image(const Image<PixelSrc>& img_src, Image<PixelDst>& img_dst, ThreadPool& thread_pool);
+
+template <PixelFormat pixel_format_src,
+          PixelFormat pixel_format_dst,
+          typename PixelSrc,
+          typename = std::enable_if_t<!conversion_requires_alpha_value(pixel_format_src, pixel_format_dst)>>
+auto convert_image(const Image<PixelSrc>& img_src, ThreadPool& thread_pool);
+
+template <PixelFormat pixel_format_src,
+          PixelFormat pixel_format_dst,
+          typename PixelSrc,
+          typename PixelDst,
+          typename ElementType,
+          typename = std::enable_if_t<conversion_requires_alpha_value(pixel_format_src, pixel_format_dst)>>
+void convert_image(const Image<PixelSrc>& img_src,
+                   Image<PixelDst>& img_dst,
+                   ElementType alpha_value,
+                   ThreadPool& thread_pool);
+
+template <PixelFormat pixel_format_src,
+          PixelFormat pixel_format_dst,
+          typename PixelSrc,
+          typename ElementType,
+          typename = std::enable_if_t<conversion_requires_alpha_value(pixel_format_src, pixel_format_dst)>>
+auto convert_image(const Image<PixelSrc>& img_src, ElementType alpha_value, ThreadPool& thread_pool);
+
 // ----------
 // Implementation:
 
@@ -53,66 +90,53 @@ struct TargetPixelType
   using type = Pixel<typename PixelTraits<PixelSrc>::Element, get_nr_channels(pixel_format_dst)>;
 };
 
-template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst, typename = void>
-struct ImageConversion;
-
 template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst>
-struct ImageConversion<pixel_format_src,
-                       pixel_format_dst,
-                       std::enable_if_t<!conversion_requires_alpha_value(pixel_format_src, pixel_format_dst)>>
+struct ImageConversion
 {
-  template <typename PixelSrc, typename PixelDst>
-  static void apply(const Image<PixelSrc>& img_src, Image<PixelDst>& img_dst)
+  template <typename PixelSrc, typename PixelDst, typename... AlphaValue>
+  static void apply_rows(const Image<PixelSrc>& img_src,
+                         Image<PixelDst>& img_dst,
+                         PixelIndex y_begin,
+                         PixelIndex y_end,
+                         AlphaValue... alpha_value)
   {
-    auto transform_func = [](const PixelSrc& px) {
-      return PixelConversion<pixel_format_src, pixel_format_dst>::apply(px);
-    };
+    using Element = typename PixelTraits<PixelSrc>::Element;
+    using Kernel = RowConversionKernel<pixel_format_src, pixel_format_dst, Element>;
 
-    transform_pixels(img_src, img_dst, transform_func);
-  }
-
-  template <typename PixelSrc>
-  static auto apply(const Image<PixelSrc>& img_src)
-  {
-    using PixelDst = typename detail::TargetPixelType<pixel_format_dst, PixelSrc>::type;
+    const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+    const auto padded_rows = img_src.simd_safe_tail() && img_dst.simd_safe_tail();
+    for (auto y = y_begin; y < y_end; ++y)
+    {
+      const auto ptr_src = img_src.data(y);
+      const auto ptr_dst = img_dst.data(y);
 
-    auto transform_func = [](const PixelSrc& px) {
-      return PixelConversion<pixel_format_src, pixel_format_dst>::apply(px);
-    };
-
-    Image<PixelDst> img_dst;
-    transform_pixels(img_src, img_dst, transform_func);
-    return img_dst;
+      // Vectorized part (if available), followed by the scalar remainder of the row (if any, given padded rows)
+      auto x = Kernel::apply(reinterpret_cast<const Element*>(ptr_src), reinterpret_cast<Element*>(ptr_dst), width,
+                             padded_rows, alpha_value...);
+      for (; x < width; ++x)
+      {
+        ptr_dst[x] = PixelConversion<pixel_format_src, pixel_format_dst>::apply(ptr_src[x], alpha_value...);
+      }
+    }
   }
-};
 
-template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst>
-struct ImageConversion<pixel_format_src,
-                       pixel_format_dst,
-                       std::enable_if_t<conversion_requires_alpha_value(pixel_format_src, pixel_format_dst)>>
-{
-  template <typename PixelSrc, typename PixelDst, typename ElementType>
-  static void apply(const Image<PixelSrc>& img_src, Image<PixelDst>& img_dst, ElementType alpha_value)
+  template <typename PixelSrc, typename PixelDst, typename... AlphaValue>
+  static void apply(const Image<PixelSrc>& img_src, Image<PixelDst>& img_dst, AlphaValue... alpha_value)
   {
-    auto transform_func = [alpha_value](const PixelSrc& px) -> PixelDst {
-      return PixelConversion<pixel_format_src, pixel_format_dst>::apply(px, alpha_value);
-    };
-
-    transform_pixels(img_src, img_dst, transform_func);
+    img_dst.maybe_allocate(img_src.width(), img_src.height());
+    apply_rows(img_src, img_dst, 0_idx, to_pixel_index(img_dst.height()), alpha_value...);
   }
 
-  template <typename PixelSrc, typename ElementType>
-  static auto apply(const Image<PixelSrc>& img_src, ElementType alpha_value)
+  template <typename PixelSrc, typename PixelDst, typename... AlphaValue>
+  static void apply_parallel(const Image<PixelSrc>& img_src,
+                             Image<PixelDst>& img_dst,
+                             ThreadPool& thread_pool,
+                             AlphaValue... alpha_value)
   {
-    using PixelDst = typename detail::TargetPixelType<pixel_format_dst, PixelSrc>::type;
-
-    auto transform_func = [alpha_value](const PixelSrc& px) -> PixelDst {
-      return PixelConversion<pixel_format_src, pixel_format_dst>::apply(px, alpha_value);
-    };
-
-    Image<PixelDst> img_dst;
-    transform_pixels(img_src, img_dst, transform_func);
-    return img_dst;
+    img_dst.maybe_allocate(img_src.width(), img_src.height());
+    for_each_row_band(thread_pool, img_dst.height(), [&](PixelIndex y_begin, PixelIndex y_end) {
+      apply_rows(img_src, img_dst, y_begin, y_end, alpha_value...);
+    });
   }
 };
 
@@ -170,7 +194,11 @@ inline auto convert_image(const Image<PixelSrc>& img_src)
 {
   static_assert(get_nr_channels(pixel_format_src) == PixelTraits<PixelSrc>::nr_channels,
                 "Incorrect source pixel format.");
-  return detail::ImageConversion<pixel_format_src, pixel_format_dst>::apply(img_src);
+  using PixelDst = typename detail::TargetPixelType<pixel_format_dst, PixelSrc>::type;
+
+  Image<PixelDst> img_dst;
+  detail::ImageConversion<pixel_format_src, pixel_format_dst>::apply(img_src, img_dst);
+  return img_dst;
 }
 
 /** \brief Converts an image (i.e. each pixel) from a source to a target pixel format.
@@ -240,7 +268,120 @@ inline auto convert_image(const Image<PixelSrc>& img_src, ElementType alpha_valu
 {
   static_assert(get_nr_channels(pixel_format_src) == PixelTraits<PixelSrc>::nr_channels,
                 "Incorrect source pixel format.");
-  return detail::ImageConversion<pixel_format_src, pixel_format_dst>::apply(img_src, alpha_value);
+  using PixelDst = typename detail::TargetPixelType<pixel_format_dst, PixelSrc>::type;
+
+  Image<PixelDst> img_dst;
+  detail::ImageConversion<pixel_format_src, pixel_format_dst>::apply(img_src, img_dst, alpha_value);
+  return img_dst;
+}
+
+/** \brief Converts an image (i.e. each pixel) from a source to a target pixel format, in parallel.
+ *
+ * The target image is split into bands of rows, each of which is converted as a separate task on the thread pool.
+ * See the single-threaded overload for details.
+ *
+ * @tparam pixel_format_src The source pixel format.
+ * @tparam pixel_format_dst The target pixel format.
+ * @tparam PixelSrc The source pixel type (usually automatically deduced).
+ * @tparam PixelDst The source pixel type (usually automatically deduced).
+ * @param img_src The source image.
+ * @param img_dst The target image. Its pixel type has to be compatible with the target pixel format.
+ * @param thread_pool The thread pool on which to execute the conversion.
+ */
+template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst, typename PixelSrc, typename PixelDst, typename>
+inline void convert_image(const Image<PixelSrc>& img_src, Image<PixelDst>& img_dst, ThreadPool& thread_pool)
+{
+  static_assert(get_nr_channels(pixel_format_src) == PixelTraits<PixelSrc>::nr_channels,
+                "Incorrect source pixel format.");
+  static_assert(get_nr_channels(pixel_format_dst) == PixelTraits<PixelDst>::nr_channels,
+                "Incorrect target pixel format.");
+  detail::ImageConversion<pixel_format_src, pixel_format_dst>::apply_parallel(img_src, img_dst, thread_pool);
+}
+
+/** \brief Converts an image (i.e. each pixel) from a source to a target pixel format, in parallel.
+ *
+ * This overload returns the target image, for which the type is automatically determined.
+ * See the single-threaded overload for details.
+ *
+ * @tparam pixel_format_src The source pixel format.
+ * @tparam pixel_format_dst The target pixel format.
+ * @tparam PixelSrc The source pixel type (usually automatically deduced).
+ * @param img_src The source image.
+ * @param thread_pool The thread pool on which to execute the conversion.
+ * @return The target image.
+ */
+template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst, typename PixelSrc, typename>
+inline auto convert_image(const Image<PixelSrc>& img_src, ThreadPool& thread_pool)
+{
+  static_assert(get_nr_channels(pixel_format_src) == PixelTraits<PixelSrc>::nr_channels,
+                "Incorrect source pixel format.");
+  using PixelDst = typename detail::TargetPixelType<pixel_format_dst, PixelSrc>::type;
+
+  Image<PixelDst> img_dst;
+  detail::ImageConversion<pixel_format_src, pixel_format_dst>::apply_parallel(img_src, img_dst, thread_pool);
+  return img_dst;
+}
+
+/** \brief Converts an image (i.e. each pixel) from a source to a target pixel format, in parallel.
+ *
+ * This is an overload for performing conversions that add an alpha channel (e.g. RGB -> RGBA).
+ * See the single-threaded overload for details.
+ *
+ * @tparam pixel_format_src The source pixel format.
+ * @tparam pixel_format_dst The target pixel format.
+ * @tparam PixelSrc The source pixel type (usually automatically deduced).
+ * @tparam PixelDst The source pixel type (usually automatically deduced).
+ * @tparam ElementType The pixel element type (for the target format; usually automatically deduced).
+ * @param img_src The source image.
+ * @param img_dst The target image. Its pixel type has to be compatible with the target pixel format.
+ * @param alpha_value The alpha value to assign to each pixel in the target image.
+ * @param thread_pool The thread pool on which to execute the conversion.
+ */
+template <PixelFormat pixel_format_src,
+          PixelFormat pixel_format_dst,
+          typename PixelSrc,
+          typename PixelDst,
+          typename ElementType,
+          typename>
+inline void convert_image(const Image<PixelSrc>& img_src,
+                          Image<PixelDst>& img_dst,
+                          ElementType alpha_value,
+                          ThreadPool& thread_pool)
+{
+  static_assert(get_nr_channels(pixel_format_src) == PixelTraits<PixelSrc>::nr_channels,
+                "Incorrect source pixel format.");
+  static_assert(get_nr_channels(pixel_format_dst) == PixelTraits<PixelDst>::nr_channels,
+                "Incorrect target pixel format.");
+  detail::ImageConversion<pixel_format_src, pixel_format_dst>::apply_parallel(img_src, img_dst, thread_pool,
+                                                                              alpha_value);
+}
+
+/** \brief Converts an image (i.e. each pixel) from a source to a target pixel format, in parallel.
+ *
+ * This overload returns the target image, for which the type is automatically determined.
+ * This is an overload for performing conversions that add an alpha channel (e.g. RGB -> RGBA).
+ * See the single-threaded overload for details.
+ *
+ * @tparam pixel_format_src The source pixel format.
+ * @tparam pixel_format_dst The target pixel format.
+ * @tparam PixelSrc The source pixel type (usually automatically deduced).
+ * @tparam ElementType The pixel element type (for the target format; usually automatically deduced).
+ * @param img_src The source image.
+ * @param alpha_value The alpha value to assign to each pixel in the target image.
+ * @param thread_pool The thread pool on which to execute the conversion.
+ * @return The target image.
+ */
+template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst, typename PixelSrc, typename ElementType, typename>
+inline auto convert_image(const Image<PixelSrc>& img_src, ElementType alpha_value, ThreadPool& thread_pool)
+{
+  static_assert(get_nr_channels(pixel_format_src) == PixelTraits<PixelSrc>::nr_channels,
+                "Incorrect source pixel format.");
+  using PixelDst = typename detail::TargetPixelType<pixel_format_dst, PixelSrc>::type;
+
+  Image<PixelDst> img_dst;
+  detail::ImageConversion<pixel_format_src, pixel_format_dst>::apply_parallel(img_src, img_dst, thread_pool,
+                                                                              alpha_value);
+  return img_dst;
 }
 
 }  // namespace sln
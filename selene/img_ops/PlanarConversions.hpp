@@ -0,0 +1,257 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_PLANAR_CONVERSIONS_HPP
+#define SELENE_IMG_OPS_PLANAR_CONVERSIONS_HPP
+
+/// @file
+
+#include <selene/base/Assert.hpp>
+
+#include <selene/img/Image.hpp>
+#include <selene/img/Pixel.hpp>
+#include <selene/img/PlanarImage.hpp>
+
+#include <selene/img_ops/detail/PlanarKernels.hpp>
+#include <selene/img_ops/detail/RowBands.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <array>
+#include <cstddef>
+
+namespace sln {
+
+template <typename T, std::size_t N>
+void deinterleave(const Image<Pixel<T, N>>& img_src, PlanarImage<T, N>& img_dst);
+
+template <typename T, std::size_t N>
+PlanarImage<T, N> deinterleave(const Image<Pixel<T, N>>& img_src);
+
+template <typename T, std::size_t N>
+void interleave(const PlanarImage<T, N>& img_src, Image<Pixel<T, N>>& img_dst);
+
+template <typename T, std::size_t N>
+Image<Pixel<T, N>> interleave(const PlanarImage<T, N>& img_src);
+
+template <typename T, std::size_t N>
+void deinterleave(const Image<Pixel<T, N>>& img_src, PlanarImage<T, N>& img_dst, ThreadPool& thread_pool);
+
+template <typename T, std::size_t N>
+PlanarImage<T, N> deinterleave(const Image<Pixel<T, N>>& img_src, ThreadPool& thread_pool);
+
+template <typename T, std::size_t N>
+void interleave(const PlanarImage<T, N>& img_src, Image<Pixel<T, N>>& img_dst, ThreadPool& thread_pool);
+
+template <typename T, std::size_t N>
+Image<Pixel<T, N>> interleave(const PlanarImage<T, N>& img_src, ThreadPool& thread_pool);
+
+// ----------
+// Implementation:
+
+namespace detail {
+
+template <typename T, std::size_t N>
+void deinterleave_rows(const Image<Pixel<T, N>>& img_src,
+                       PlanarImage<T, N>& img_dst,
+                       PixelIndex y_begin,
+                       PixelIndex y_end)
+{
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto padded_rows = img_src.simd_safe_tail() && img_dst.simd_safe_tail();
+  std::array<T*, N> ptrs_dst;
+
+  for (auto y = y_begin; y < y_end; ++y)
+  {
+    const auto ptr_src = reinterpret_cast<const T*>(img_src.data(y));
+    for (std::size_t c = 0; c < N; ++c)
+    {
+      ptrs_dst[c] = img_dst.data(c, y);
+    }
+
+    // Vectorized part (if available), followed by the scalar remainder of the row (if any, given padded rows)
+    auto x = DeinterleaveKernel<T, N>::apply(ptr_src, ptrs_dst.data(), width, padded_rows);
+    for (; x < width; ++x)
+    {
+      for (std::size_t c = 0; c < N; ++c)
+      {
+        ptrs_dst[c][x] = ptr_src[static_cast<std::ptrdiff_t>(N) * x + static_cast<std::ptrdiff_t>(c)];
+      }
+    }
+  }
+}
+
+template <typename T, std::size_t N>
+void interleave_rows(const PlanarImage<T, N>& img_src,
+                     Image<Pixel<T, N>>& img_dst,
+                     PixelIndex y_begin,
+                     PixelIndex y_end)
+{
+  const auto width = static_cast<std::ptrdiff_t>(img_src.width());
+  const auto padded_rows = img_src.simd_safe_tail() && img_dst.simd_safe_tail();
+  std::array<const T*, N> ptrs_src;
+
+  for (auto y = y_begin; y < y_end; ++y)
+  {
+    for (std::size_t c = 0; c < N; ++c)
+    {
+      ptrs_src[c] = img_src.data(c, y);
+    }
+    const auto ptr_dst = reinterpret_cast<T*>(img_dst.data(y));
+
+    // Vectorized part (if available), followed by the scalar remainder of the row (if any, given padded rows)
+    auto x = InterleaveKernel<T, N>::apply(ptrs_src.data(), ptr_dst, width, padded_rows);
+    for (; x < width; ++x)
+    {
+      for (std::size_t c = 0; c < N; ++c)
+      {
+        ptr_dst[static_cast<std::ptrdiff_t>(N) * x + static_cast<std::ptrdiff_t>(c)] = ptrs_src[c][x];
+      }
+    }
+  }
+}
+
+}  // namespace detail
+
+/** \brief Converts an interleaved image to planar storage, i.e. copies each channel to a separate plane.
+ *
+ * For 8-bit images with 3 or 4 channels, rows are converted using SIMD byte shuffles (SSSE3) or structured loads
+ * (NEON), where available. Without SSSE3, 4-channel images are still converted using SSE2; 3-channel images are
+ * converted using scalar code.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img_src The interleaved source image.
+ * @param[out] img_dst The planar output image.
+ */
+template <typename T, std::size_t N>
+void deinterleave(const Image<Pixel<T, N>>& img_src, PlanarImage<T, N>& img_dst)
+{
+  img_dst.maybe_allocate(img_src.width(), img_src.height());
+  detail::deinterleave_rows(img_src, img_dst, 0_idx, to_pixel_index(img_src.height()));
+}
+
+/** \brief Converts an interleaved image to planar storage, i.e. copies each channel to a separate plane.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img_src The interleaved source image.
+ * @return The planar output image.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N> deinterleave(const Image<Pixel<T, N>>& img_src)
+{
+  PlanarImage<T, N> img_dst;
+  deinterleave(img_src, img_dst);
+  return img_dst;
+}
+
+/** \brief Converts a planar image to interleaved storage, i.e. merges the planes into one multi-channel image.
+ *
+ * For 8-bit images with 3 or 4 channels, rows are converted using SIMD byte shuffles (SSSE3) or structured stores
+ * (NEON), where available. Without SSSE3, 4-channel images are still converted using SSE2 unpacks; 3-channel images are
+ * converted using scalar code.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img_src The planar source image.
+ * @param[out] img_dst The interleaved output image.
+ */
+template <typename T, std::size_t N>
+void interleave(const PlanarImage<T, N>& img_src, Image<Pixel<T, N>>& img_dst)
+{
+  img_dst.maybe_allocate(img_src.width(), img_src.height());
+  detail::interleave_rows(img_src, img_dst, 0_idx, to_pixel_index(img_src.height()));
+}
+
+/** \brief Converts a planar image to interleaved storage, i.e. merges the planes into one multi-channel image.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img_src The planar source image.
+ * @return The interleaved output image.
+ */
+template <typename T, std::size_t N>
+Image<Pixel<T, N>> interleave(const PlanarImage<T, N>& img_src)
+{
+  Image<Pixel<T, N>> img_dst;
+  interleave(img_src, img_dst);
+  return img_dst;
+}
+
+/** \brief Converts an interleaved image to planar storage, in parallel.
+ *
+ * The image is split into bands of rows, each of which is processed as a separate task on the thread pool.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img_src The interleaved source image.
+ * @param[out] img_dst The planar output image.
+ * @param thread_pool The thread pool on which to execute the operation.
+ */
+template <typename T, std::size_t N>
+void deinterleave(const Image<Pixel<T, N>>& img_src, PlanarImage<T, N>& img_dst, ThreadPool& thread_pool)
+{
+  img_dst.maybe_allocate(img_src.width(), img_src.height());
+
+  detail::for_each_row_band(thread_pool, img_src.height(), [&img_src, &img_dst](PixelIndex y_begin, PixelIndex y_end) {
+    detail::deinterleave_rows(img_src, img_dst, y_begin, y_end);
+  });
+}
+
+/** \brief Converts an interleaved image to planar storage, in parallel.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img_src The interleaved source image.
+ * @param thread_pool The thread pool on which to execute the operation.
+ * @return The planar output image.
+ */
+template <typename T, std::size_t N>
+PlanarImage<T, N> deinterleave(const Image<Pixel<T, N>>& img_src, ThreadPool& thread_pool)
+{
+  PlanarImage<T, N> img_dst;
+  deinterleave(img_src, img_dst, thread_pool);
+  return img_dst;
+}
+
+/** \brief Converts a planar image to interleaved storage, in parallel.
+ *
+ * The image is split into bands of rows, each of which is processed as a separate task on the thread pool.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img_src The planar source image.
+ * @param[out] img_dst The interleaved output image.
+ * @param thread_pool The thread pool on which to execute the operation.
+ */
+template <typename T, std::size_t N>
+void interleave(const PlanarImage<T, N>& img_src, Image<Pixel<T, N>>& img_dst, ThreadPool& thread_pool)
+{
+  img_dst.maybe_allocate(img_src.width(), img_src.height());
+
+  detail::for_each_row_band(thread_pool, img_src.height(), [&img_src, &img_dst](PixelIndex y_begin, PixelIndex y_end) {
+    detail::interleave_rows(img_src, img_dst, y_begin, y_end);
+  });
+}
+
+/** \brief Converts a planar image to interleaved storage, in parallel.
+ *
+ * @tparam T The element type.
+ * @tparam N The number of channels.
+ * @param img_src The planar source image.
+ * @param thread_pool The thread pool on which to execute the operation.
+ * @return The interleaved output image.
+ */
+template <typename T, std::size_t N>
+Image<Pixel<T, N>> interleave(const PlanarImage<T, N>& img_src, ThreadPool& thread_pool)
+{
+  Image<Pixel<T, N>> img_dst;
+  interleave(img_src, img_dst, thread_pool);
+  return img_dst;
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_PLANAR_CONVERSIONS_HPP
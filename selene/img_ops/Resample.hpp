@@ -9,18 +9,81 @@
 
 #include <selene/img/Image.hpp>
 #include <selene/img/Interpolators.hpp>
+#include <selene/img/OrientedView.hpp>
 #include <selene/img/Types.hpp>
 
+#include <selene/img_ops/Transformations.hpp>
+#include <selene/img_ops/detail/RowBands.hpp>
+#include <selene/img_ops/detail/SeparableResample.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
 
 namespace sln {
 
-template <ImageInterpolationMode interpolation_mode = ImageInterpolationMode::Bilinear, typename PixelType>
+template <ImageInterpolationMode interpolation_mode = ImageInterpolationMode::Bilinear,
+          InterpolationPrecision precision = InterpolationPrecision::FloatingPoint,
+          typename PixelType>
 Image<PixelType> resample(const Image<PixelType>& img, PixelLength new_width, PixelLength new_height);
 
-template <ImageInterpolationMode interpolation_mode = ImageInterpolationMode::Bilinear, typename PixelType>
+template <ImageInterpolationMode interpolation_mode = ImageInterpolationMode::Bilinear,
+          InterpolationPrecision precision = InterpolationPrecision::FloatingPoint,
+          typename PixelType>
 void resample(const Image<PixelType>& img_src, PixelLength new_width, PixelLength new_height, Image<PixelType>& img_dst);
 
+template <ImageInterpolationMode interpolation_mode = ImageInterpolationMode::Bilinear,
+          InterpolationPrecision precision = InterpolationPrecision::FloatingPoint,
+          typename PixelType>
+Image<PixelType> resample(const Image<PixelType>& img,
+                          PixelLength new_width,
+                          PixelLength new_height,
+                          ThreadPool& thread_pool);
+
+template <ImageInterpolationMode interpolation_mode = ImageInterpolationMode::Bilinear,
+          InterpolationPrecision precision = InterpolationPrecision::FloatingPoint,
+          typename PixelType>
+void resample(const Image<PixelType>& img_src,
+              PixelLength new_width,
+              PixelLength new_height,
+              Image<PixelType>& img_dst,
+              ThreadPool& thread_pool);
+
+template <ImageInterpolationMode interpolation_mode = ImageInterpolationMode::Bilinear,
+          InterpolationPrecision precision = InterpolationPrecision::FloatingPoint,
+          typename PixelType>
+Image<PixelType> resample(const OrientedView<PixelType>& view, PixelLength new_width, PixelLength new_height);
+
+template <ImageInterpolationMode interpolation_mode = ImageInterpolationMode::Bilinear,
+          InterpolationPrecision precision = InterpolationPrecision::FloatingPoint,
+          typename PixelType>
+void resample(const OrientedView<PixelType>& view_src,
+              PixelLength new_width,
+              PixelLength new_height,
+              Image<PixelType>& img_dst);
+
+template <ImageInterpolationMode interpolation_mode = ImageInterpolationMode::Bilinear,
+          InterpolationPrecision precision = InterpolationPrecision::FloatingPoint,
+          typename PixelType>
+Image<PixelType> resample(const OrientedView<PixelType>& view,
+                          PixelLength new_width,
+                          PixelLength new_height,
+                          ThreadPool& thread_pool);
+
+template <ImageInterpolationMode interpolation_mode = ImageInterpolationMode::Bilinear,
+          InterpolationPrecision precision = InterpolationPrecision::FloatingPoint,
+          typename PixelType>
+void resample(const OrientedView<PixelType>& view_src,
+              PixelLength new_width,
+              PixelLength new_height,
+              Image<PixelType>& img_dst,
+              ThreadPool& thread_pool);
+
 // ----------
 // Implementation:
 
@@ -34,31 +97,32 @@ void apply_resample_functions(Func func, FuncSafe func_safe,
                               PixelLength safe_boundary_right,
                               PixelLength safe_boundary_top,
                               PixelLength safe_boundary_bottom,
-                              Image<PixelType>& img_dst)
+                              Image<PixelType>& img_dst,
+                              PixelIndex y_dst_begin,
+                              PixelIndex y_dst_end)
 {
   const auto dst_width = img_dst.width();
-  const auto dst_height = img_dst.height();
 
   const auto bound_left = PixelIndex{safe_boundary_left};
   const auto bound_right = PixelIndex{safe_boundary_right};
   const auto bound_top = PixelIndex{safe_boundary_top};
   const auto bound_bottom = PixelIndex{safe_boundary_bottom};
 
-  for (auto y_dst = 0_idx; y_dst < bound_top; ++y_dst)
+  for (auto y_dst = y_dst_begin; y_dst < y_dst_end; ++y_dst)
   {
     const auto y_src = y_dst * dst_to_src_factor_y;
 
-    for (auto x_dst = 0_idx; x_dst < dst_width; ++x_dst)
+    if (y_dst < bound_top || y_dst >= bound_bottom)
     {
-      const auto x_src = x_dst * dst_to_src_factor_x;
-      const auto value = func_safe(x_src, y_src);
-      img_dst(x_dst, y_dst) = value;
-    }
-  }
+      for (auto x_dst = 0_idx; x_dst < dst_width; ++x_dst)
+      {
+        const auto x_src = x_dst * dst_to_src_factor_x;
+        const auto value = func_safe(x_src, y_src);
+        img_dst(x_dst, y_dst) = value;
+      }
 
-  for (auto y_dst = bound_top; y_dst < bound_bottom; ++y_dst)
-  {
-    const auto y_src = y_dst * dst_to_src_factor_y;
+      continue;
+    }
 
     for (auto x_dst = 0_idx; x_dst < bound_left; ++x_dst)
     {
@@ -81,84 +145,457 @@ void apply_resample_functions(Func func, FuncSafe func_safe,
       img_dst(x_dst, y_dst) = value;
     }
   }
+}
+
+inline PixelLength resample_safe_lower_bound(PixelLength::value_type index_to_lower,
+                                             default_float_t dst_to_src_factor,
+                                             PixelLength dst_length)
+{
+  const auto bound = std::ceil(index_to_lower / dst_to_src_factor);
+  return to_pixel_length(std::min(bound, static_cast<default_float_t>(dst_length)));
+}
+
+inline PixelLength resample_safe_upper_bound(PixelLength::value_type index_to_upper,
+                                             default_float_t dst_to_src_factor,
+                                             PixelLength src_length,
+                                             PixelLength lower_bound,
+                                             PixelLength dst_length)
+{
+  const auto bound = std::ceil((src_length - index_to_upper) / dst_to_src_factor) - 1;
+  const auto bound_clamped = std::max(static_cast<default_float_t>(lower_bound),
+                                      std::min(bound, static_cast<default_float_t>(dst_length)));
+  return to_pixel_length(bound_clamped);
+}
+
+// The source may be an `Image<PixelType>` or an `OrientedView<PixelType>`; the latter is sampled lazily.
+template <ImageInterpolationMode interpolation_mode,
+          InterpolationPrecision precision = InterpolationPrecision::FloatingPoint,
+          typename SourceType,
+          typename PixelType,
+          typename RowRangeExecutor>
+void resample_rows(const SourceType& img_src, Image<PixelType>& img_dst, RowRangeExecutor executor)
+{
+  const auto dst_to_src_factor_x = img_src.width() / static_cast<default_float_t>(img_dst.width());
+  const auto dst_to_src_factor_y = img_src.height() / static_cast<default_float_t>(img_dst.height());
+
+  using Interpolator = ImageInterpolator<interpolation_mode, BorderAccessMode::Unchecked, precision>;
+
+  // Destination pixels in [left, right) x [top, bottom) only access source pixels inside the image; the upper bounds
+  // are chosen one pixel conservatively, to be robust against floating point rounding.
+  const auto safe_boundary_left = resample_safe_lower_bound(Interpolator::index_to_left, dst_to_src_factor_x,
+                                                            img_dst.width());
+  const auto safe_boundary_right = resample_safe_upper_bound(Interpolator::index_to_right, dst_to_src_factor_x,
+                                                             img_src.width(), safe_boundary_left, img_dst.width());
+  const auto safe_boundary_top = resample_safe_lower_bound(Interpolator::index_to_up, dst_to_src_factor_y,
+                                                           img_dst.height());
+  const auto safe_boundary_bottom = resample_safe_upper_bound(Interpolator::index_to_down, dst_to_src_factor_y,
+                                                              img_src.height(), safe_boundary_top, img_dst.height());
 
-  for (auto y_dst = bound_bottom; y_dst < dst_height; ++y_dst)
+  const auto func = [&img_src](auto x, auto y) {
+    return ImageInterpolator<interpolation_mode, BorderAccessMode::Unchecked, precision>::interpolate(img_src, x, y);
+  };
+
+  const auto func_safe = [&img_src](auto x, auto y) {
+    return ImageInterpolator<interpolation_mode, BorderAccessMode::Replicated, precision>::interpolate(img_src, x, y);
+  };
+
+  executor(img_dst.height(), [&](PixelIndex y_dst_begin, PixelIndex y_dst_end) {
+    detail::apply_resample_functions(func, func_safe, dst_to_src_factor_x, dst_to_src_factor_y, safe_boundary_left,
+                                     safe_boundary_right, safe_boundary_top, safe_boundary_bottom, img_dst,
+                                     y_dst_begin, y_dst_end);
+  });
+}
+
+// Source element offsets and fixed-point weights for one destination column (or source rows, for a destination row).
+struct BilinearFixedPointTable
+{
+  std::vector<std::ptrdiff_t> offsets_0;
+  std::vector<std::ptrdiff_t> offsets_1;
+  std::vector<std::int32_t> weights;
+};
+
+inline BilinearFixedPointTable compute_bilinear_fixed_point_table(PixelLength src_length,
+                                                                  PixelLength dst_length,
+                                                                  std::ptrdiff_t offset_multiplier)
+{
+  const auto dst_to_src_factor = src_length / static_cast<default_float_t>(dst_length);
+  const auto max_index = static_cast<PixelIndex::value_type>(src_length) - 1;
+  const auto clamp_index = [max_index](PixelIndex::value_type i) { return std::max(0, std::min(i, max_index)); };
+
+  BilinearFixedPointTable table;
+  table.offsets_0.resize(static_cast<std::size_t>(dst_length));
+  table.offsets_1.resize(static_cast<std::size_t>(dst_length));
+  table.weights.resize(static_cast<std::size_t>(dst_length));
+
+  for (auto i = 0_idx; i < dst_length; ++i)
   {
-    const auto y_src = y_dst * dst_to_src_factor_y;
+    // Same coordinate computation as in resample_rows(), to obtain identical results.
+    const auto src_coord = i * dst_to_src_factor;
+    const auto src_floor = std::floor(src_coord);
+    const auto src_index = static_cast<PixelIndex::value_type>(src_floor);
+    const auto k = static_cast<std::size_t>(i);
+    table.offsets_0[k] = clamp_index(src_index) * offset_multiplier;
+    table.offsets_1[k] = clamp_index(src_index + 1) * offset_multiplier;
+    table.weights[k] = bilinear_fixed_point_weight(src_coord - src_floor);
+  }
 
-    for (auto x_dst = 0_idx; x_dst < dst_width; ++x_dst)
+  return table;
+}
+
+template <typename PixelType, typename RowRangeExecutor>
+void resample_bilinear_fixed_point(const Image<PixelType>& img_src, Image<PixelType>& img_dst, RowRangeExecutor executor)
+{
+  using Element = typename PixelTraits<PixelType>::Element;
+  constexpr auto nr_channels = static_cast<std::ptrdiff_t>(PixelTraits<PixelType>::nr_channels);
+  static_assert(std::is_integral<Element>::value && sizeof(Element) <= 2,
+                "Fixed-point interpolation requires 8- or 16-bit integral pixel elements.");
+  using Accumulator = BilinearFixedPointAccumulator<Element>;
+
+  if (img_src.width() == 0 || img_src.height() == 0 || img_dst.width() == 0 || img_dst.height() == 0)
+  {
+    return;
+  }
+
+  const auto table_x = compute_bilinear_fixed_point_table(img_src.width(), img_dst.width(), nr_channels);
+  const auto table_y = compute_bilinear_fixed_point_table(img_src.height(), img_dst.height(), 1);
+  const auto src_row_elements = static_cast<std::size_t>(img_src.width()) * static_cast<std::size_t>(nr_channels);
+  const auto dst_width = static_cast<std::size_t>(img_dst.width());
+
+  executor(img_dst.height(), [&](PixelIndex y_dst_begin, PixelIndex y_dst_end) {
+    std::vector<Accumulator> row(src_row_elements);
+
+    for (auto y_dst = y_dst_begin; y_dst < y_dst_end; ++y_dst)
     {
-      const auto x_src = x_dst * dst_to_src_factor_x;
-      const auto value = func_safe(x_src, y_src);
-      img_dst(x_dst, y_dst) = value;
+      const auto ky = static_cast<std::size_t>(y_dst);
+      const auto wy = table_y.weights[ky];
+      const auto src_0 = reinterpret_cast<const Element*>(img_src.data(to_pixel_index(table_y.offsets_0[ky])));
+      const auto src_1 = reinterpret_cast<const Element*>(img_src.data(to_pixel_index(table_y.offsets_1[ky])));
+
+      // Vertical blend over the full source row; contiguous, and therefore vectorizable.
+      for (std::size_t i = 0; i < src_row_elements; ++i)
+      {
+        row[i] = bilinear_fixed_point_blend(Accumulator{src_0[i]}, Accumulator{src_1[i]}, wy);
+      }
+
+      // Horizontal blend, using the precomputed per-column offsets and weights.
+      auto dst = reinterpret_cast<Element*>(img_dst.data(y_dst));
+      for (std::size_t kx = 0; kx < dst_width; ++kx)
+      {
+        const auto row_0 = row.data() + table_x.offsets_0[kx];
+        const auto row_1 = row.data() + table_x.offsets_1[kx];
+        const auto wx = table_x.weights[kx];
+        for (std::ptrdiff_t c = 0; c < nr_channels; ++c)  // nr_channels is known at compile-time
+        {
+          *dst++ = bilinear_fixed_point_result<Element>(bilinear_fixed_point_blend(row_0[c], row_1[c], wx));
+        }
+      }
     }
-  }
+  });
+}
 
+template <ImageInterpolationMode interpolation_mode>
+using is_separable_resample_mode = std::integral_constant<bool,
+                                                          interpolation_mode == ImageInterpolationMode::Bicubic
+                                                              || interpolation_mode == ImageInterpolationMode::Lanczos3
+                                                              || interpolation_mode == ImageInterpolationMode::Area>;
+
+struct ResampleSampledTag {};
+struct ResampleSeparableTag {};
+struct ResampleBilinearFixedPointTag {};
+
+template <ImageInterpolationMode interpolation_mode, InterpolationPrecision precision>
+using resample_tag = std::conditional_t<
+    is_separable_resample_mode<interpolation_mode>::value,
+    ResampleSeparableTag,
+    std::conditional_t<interpolation_mode == ImageInterpolationMode::Bilinear
+                           && precision == InterpolationPrecision::FixedPoint,
+                       ResampleBilinearFixedPointTag,
+                       ResampleSampledTag>>;
+
+template <ImageInterpolationMode interpolation_mode, typename PixelType, typename RowRangeExecutor>
+void resample_impl(const Image<PixelType>& img_src,
+                   Image<PixelType>& img_dst,
+                   RowRangeExecutor executor,
+                   ResampleSeparableTag)
+{
+  detail::resample_separable<interpolation_mode>(img_src, img_dst, executor);
 }
 
-}  // namespace detail
+template <ImageInterpolationMode interpolation_mode, typename PixelType, typename RowRangeExecutor>
+void resample_impl(const Image<PixelType>& img_src,
+                   Image<PixelType>& img_dst,
+                   RowRangeExecutor executor,
+                   ResampleBilinearFixedPointTag)
+{
+  detail::resample_bilinear_fixed_point(img_src, img_dst, executor);
+}
+
+template <ImageInterpolationMode interpolation_mode, typename PixelType, typename RowRangeExecutor>
+void resample_impl(const Image<PixelType>& img_src,
+                   Image<PixelType>& img_dst,
+                   RowRangeExecutor executor,
+                   ResampleSampledTag)
+{
+  detail::resample_rows<interpolation_mode>(img_src, img_dst, executor);
+}
+
+template <ImageInterpolationMode interpolation_mode, typename PixelType, typename RowRangeExecutor>
+void resample_impl(const OrientedView<PixelType>& view_src,
+                   Image<PixelType>& img_dst,
+                   RowRangeExecutor executor,
+                   ResampleSeparableTag)
+{
+  // The filter based passes operate on contiguous source rows. Resample the unoriented source region to the
+  // unoriented target extents instead, and then only orient the target-sized result. For transposed orientations,
+  // swapping the pass order keeps the intermediate rounding identical to resampling the oriented image.
+  const auto swap_extents = orientation_swaps_extents(view_src.orientation());
+  Image<PixelType> img_tmp(swap_extents ? img_dst.height() : img_dst.width(),
+                           swap_extents ? img_dst.width() : img_dst.height());
+  detail::resample_separable<interpolation_mode>(view_src.image(), img_tmp, executor, swap_extents);
+  clone(oriented_view(img_tmp, view_src.orientation()), img_dst);
+}
+
+template <ImageInterpolationMode interpolation_mode, typename PixelType, typename RowRangeExecutor>
+void resample_impl(const OrientedView<PixelType>& view_src,
+                   Image<PixelType>& img_dst,
+                   RowRangeExecutor executor,
+                   ResampleBilinearFixedPointTag)
+{
+  detail::resample_rows<interpolation_mode, InterpolationPrecision::FixedPoint>(view_src, img_dst, executor);
+}
 
+template <ImageInterpolationMode interpolation_mode, typename PixelType, typename RowRangeExecutor>
+void resample_impl(const OrientedView<PixelType>& view_src,
+                   Image<PixelType>& img_dst,
+                   RowRangeExecutor executor,
+                   ResampleSampledTag)
+{
+  detail::resample_rows<interpolation_mode>(view_src, img_dst, executor);
+}
+
+}  // namespace detail
 
 /** \brief Resamples the input image pixels to fit the output image dimensions, using the specified interpolation mode.
  *
- * This function only samples the respective pixels in the input image. No low-pass filtering is performed to limit the
- * frequency range; therefore, aliasing may occur when shrinking the image dimensions.
+ * For `ImageInterpolationMode::NearestNeighbor` and `ImageInterpolationMode::Bilinear`, this function only samples the
+ * respective pixels in the input image. No low-pass filtering is performed to limit the frequency range; therefore,
+ * aliasing may occur when shrinking the image dimensions.
+ * The modes `ImageInterpolationMode::Area`, `ImageInterpolationMode::Bicubic` and `ImageInterpolationMode::Lanczos3`
+ * are filter based, and are computed as two separable passes (horizontal, then vertical), using weight tables that are
+ * precomputed once per call. For 8- and 16-bit integral pixel elements, fixed-point integer weights are used. When
+ * downsampling, filters are widened by the scale factor, which avoids aliasing. These modes align pixel centers, i.e.
+ * destination pixel x corresponds to source location (x + 0.5) * src_width / dst_width - 0.5.
+ *
+ * `InterpolationPrecision::FixedPoint` selects fixed-point integer arithmetic for `ImageInterpolationMode::Bilinear`,
+ * for images with 8- or 16-bit integral pixel elements. Source offsets and weights are then precomputed once per
+ * destination column and row; results are identical to accessing each pixel with
+ * `ImageInterpolator<ImageInterpolationMode::Bilinear, BorderAccessMode::Replicated, InterpolationPrecision::FixedPoint>`.
  *
  * @tparam interpolation_mode The interpolation mode to use.
+ * @tparam precision The interpolation precision to use. Only has an effect for `ImageInterpolationMode::Bilinear`.
  * @tparam PixelType The pixel type.
  * @param img The input image to be resampled
  * @param new_width The width of the target image.
  * @param new_height The height of the target image
  * @return The sampled target image.
  */
-template <ImageInterpolationMode interpolation_mode, typename PixelType>
+template <ImageInterpolationMode interpolation_mode, InterpolationPrecision precision, typename PixelType>
 Image<PixelType> resample(const Image<PixelType>& img, PixelLength new_width, PixelLength new_height)
 {
   Image<PixelType> img_dst;
-  resample<interpolation_mode>(img, new_width, new_height, img_dst);
+  resample<interpolation_mode, precision>(img, new_width, new_height, img_dst);
   return img_dst;
 }
 
 /** \brief Resamples the input image pixels to fit the output image dimensions, using the specified interpolation mode.
  *
- * This function only samples the respective pixels in the input image. No low-pass filtering is performed to limit the
- * frequency range; therefore, aliasing may occur when shrinking the image dimensions.
+ * See resample(const Image<PixelType>&, PixelLength, PixelLength) for details.
  *
  * @tparam interpolation_mode The interpolation mode to use.
+ * @tparam precision The interpolation precision to use. Only has an effect for `ImageInterpolationMode::Bilinear`.
  * @tparam PixelType The pixel type.
  * @param img_src The input image to be resampled.
  * @param img_dst The sampled target image.
  * @param new_width The width of the target image.
  * @param new_height The height of the target image
  */
-template <ImageInterpolationMode interpolation_mode, typename PixelType>
+template <ImageInterpolationMode interpolation_mode, InterpolationPrecision precision, typename PixelType>
 void resample(const Image<PixelType>& img_src, PixelLength new_width, PixelLength new_height, Image<PixelType>& img_dst)
 {
   img_dst.maybe_allocate(new_width, new_height);
 
-  const auto dst_to_src_factor_x = img_src.width() / static_cast<default_float_t>(new_width);
-  const auto dst_to_src_factor_y = img_src.height() / static_cast<default_float_t>(new_height);
+  detail::resample_impl<interpolation_mode>(img_src, img_dst,
+                                            [](PixelLength height, auto func) { func(0_idx, to_pixel_index(height)); },
+                                            detail::resample_tag<interpolation_mode, precision>{});
+}
 
-  const auto safe_boundary_left = to_pixel_length(
-      std::ceil(ImageInterpolator<interpolation_mode>::index_to_left / dst_to_src_factor_x));
-  const auto safe_boundary_right = to_pixel_length(
-      std::ceil(ImageInterpolator<interpolation_mode>::index_to_right / dst_to_src_factor_x));
-  const auto safe_boundary_top = to_pixel_length(
-      std::ceil(ImageInterpolator<interpolation_mode>::index_to_up / dst_to_src_factor_y));
-  const auto safe_boundary_bottom = to_pixel_length(
-      std::ceil(ImageInterpolator<interpolation_mode>::index_to_down / dst_to_src_factor_y));
+/** \brief Resamples the input image pixels to fit the output image dimensions, using the specified interpolation mode.
+ *
+ * The output image is split into bands of rows, each of which is computed as a separate task on the thread pool.
+ *
+ * See resample(const Image<PixelType>&, PixelLength, PixelLength) for details.
+ *
+ * @tparam interpolation_mode The interpolation mode to use.
+ * @tparam precision The interpolation precision to use. Only has an effect for `ImageInterpolationMode::Bilinear`.
+ * @tparam PixelType The pixel type.
+ * @param img The input image to be resampled
+ * @param new_width The width of the target image.
+ * @param new_height The height of the target image
+ * @param thread_pool The thread pool on which to execute the resampling.
+ * @return The sampled target image.
+ */
+template <ImageInterpolationMode interpolation_mode, InterpolationPrecision precision, typename PixelType>
+Image<PixelType> resample(const Image<PixelType>& img,
+                          PixelLength new_width,
+                          PixelLength new_height,
+                          ThreadPool& thread_pool)
+{
+  Image<PixelType> img_dst;
+  resample<interpolation_mode, precision>(img, new_width, new_height, img_dst, thread_pool);
+  return img_dst;
+}
 
-  const auto func = [&img_src](auto x, auto y) {
-    return ImageInterpolator<interpolation_mode, BorderAccessMode::Unchecked>::interpolate(img_src, x, y);
-  };
+/** \brief Resamples the input image pixels to fit the output image dimensions, using the specified interpolation mode.
+ *
+ * The output image is split into bands of rows, each of which is computed as a separate task on the thread pool.
+ *
+ * See resample(const Image<PixelType>&, PixelLength, PixelLength) for details.
+ *
+ * @tparam interpolation_mode The interpolation mode to use.
+ * @tparam precision The interpolation precision to use. Only has an effect for `ImageInterpolationMode::Bilinear`.
+ * @tparam PixelType The pixel type.
+ * @param img_src The input image to be resampled.
+ * @param img_dst The sampled target image.
+ * @param new_width The width of the target image.
+ * @param new_height The height of the target image
+ * @param thread_pool The thread pool on which to execute the resampling.
+ */
+template <ImageInterpolationMode interpolation_mode, InterpolationPrecision precision, typename PixelType>
+void resample(const Image<PixelType>& img_src,
+              PixelLength new_width,
+              PixelLength new_height,
+              Image<PixelType>& img_dst,
+              ThreadPool& thread_pool)
+{
+  img_dst.maybe_allocate(new_width, new_height);
 
-  const auto func_safe = [&img_src](auto x, auto y) {
-    return ImageInterpolator<interpolation_mode, BorderAccessMode::Replicated>::interpolate(img_src, x, y);
-  };
+  detail::resample_impl<interpolation_mode>(img_src, img_dst,
+                                            [&thread_pool](PixelLength height, auto func) {
+                                              detail::for_each_row_band(thread_pool, height, func);
+                                            },
+                                            detail::resample_tag<interpolation_mode, precision>{});
+}
+
+/** \brief Resamples the pixels of an oriented view to fit the output image dimensions, using the specified
+ * interpolation mode.
+ *
+ * The orientation of the view is applied lazily: only the source pixels needed for the target image are accessed, and
+ * no oriented copy of the source is created.
+ * For `ImageInterpolationMode::NearestNeighbor` and `ImageInterpolationMode::Bilinear` (in either precision), each
+ * target pixel is sampled through the view; results are identical to resampling the materialized oriented image.
+ * For the filter based modes, the unoriented source region is resampled to the unoriented target extents (with the
+ * pass order swapped for transposed orientations), and the orientation is then applied to the target-sized result.
+ * Results match resampling the materialized image, up to rounding of mirrored filter positions.
+ *
+ * @tparam interpolation_mode The interpolation mode to use.
+ * @tparam precision The interpolation precision to use. Only has an effect for `ImageInterpolationMode::Bilinear`.
+ * @tparam PixelType The pixel type.
+ * @param view The input view to be resampled.
+ * @param new_width The width of the target image.
+ * @param new_height The height of the target image
+ * @return The sampled target image.
+ */
+template <ImageInterpolationMode interpolation_mode, InterpolationPrecision precision, typename PixelType>
+Image<PixelType> resample(const OrientedView<PixelType>& view, PixelLength new_width, PixelLength new_height)
+{
+  Image<PixelType> img_dst;
+  resample<interpolation_mode, precision>(view, new_width, new_height, img_dst);
+  return img_dst;
+}
+
+/** \brief Resamples the pixels of an oriented view to fit the output image dimensions, using the specified
+ * interpolation mode.
+ *
+ * See resample(const OrientedView<PixelType>&, PixelLength, PixelLength) for details.
+ *
+ * @tparam interpolation_mode The interpolation mode to use.
+ * @tparam precision The interpolation precision to use. Only has an effect for `ImageInterpolationMode::Bilinear`.
+ * @tparam PixelType The pixel type.
+ * @param view_src The input view to be resampled.
+ * @param new_width The width of the target image.
+ * @param new_height The height of the target image
+ * @param img_dst The sampled target image.
+ */
+template <ImageInterpolationMode interpolation_mode, InterpolationPrecision precision, typename PixelType>
+void resample(const OrientedView<PixelType>& view_src,
+              PixelLength new_width,
+              PixelLength new_height,
+              Image<PixelType>& img_dst)
+{
+  img_dst.maybe_allocate(new_width, new_height);
+
+  detail::resample_impl<interpolation_mode>(view_src, img_dst,
+                                            [](PixelLength height, auto func) { func(0_idx, to_pixel_index(height)); },
+                                            detail::resample_tag<interpolation_mode, precision>{});
+}
+
+/** \brief Resamples the pixels of an oriented view to fit the output image dimensions, using the specified
+ * interpolation mode.
+ *
+ * The output image is split into bands of rows, each of which is computed as a separate task on the thread pool.
+ *
+ * See resample(const OrientedView<PixelType>&, PixelLength, PixelLength) for details.
+ *
+ * @tparam interpolation_mode The interpolation mode to use.
+ * @tparam precision The interpolation precision to use. Only has an effect for `ImageInterpolationMode::Bilinear`.
+ * @tparam PixelType The pixel type.
+ * @param view The input view to be resampled.
+ * @param new_width The width of the target image.
+ * @param new_height The height of the target image
+ * @param thread_pool The thread pool on which to execute the resampling.
+ * @return The sampled target image.
+ */
+template <ImageInterpolationMode interpolation_mode, InterpolationPrecision precision, typename PixelType>
+Image<PixelType> resample(const OrientedView<PixelType>& view,
+                          PixelLength new_width,
+                          PixelLength new_height,
+                          ThreadPool& thread_pool)
+{
+  Image<PixelType> img_dst;
+  resample<interpolation_mode, precision>(view, new_width, new_height, img_dst, thread_pool);
+  return img_dst;
+}
+
+/** \brief Resamples the pixels of an oriented view to fit the output image dimensions, using the specified
+ * interpolation mode.
+ *
+ * The output image is split into bands of rows, each of which is computed as a separate task on the thread pool.
+ *
+ * See resample(const OrientedView<PixelType>&, PixelLength, PixelLength) for details.
+ *
+ * @tparam interpolation_mode The interpolation mode to use.
+ * @tparam precision The interpolation precision to use. Only has an effect for `ImageInterpolationMode::Bilinear`.
+ * @tparam PixelType The pixel type.
+ * @param view_src The input view to be resampled.
+ * @param new_width The width of the target image.
+ * @param new_height The height of the target image
+ * @param img_dst The sampled target image.
+ * @param thread_pool The thread pool on which to execute the resampling.
+ */
+template <ImageInterpolationMode interpolation_mode, InterpolationPrecision precision, typename PixelType>
+void resample(const OrientedView<PixelType>& view_src,
+              PixelLength new_width,
+              PixelLength new_height,
+              Image<PixelType>& img_dst,
+              ThreadPool& thread_pool)
+{
+  img_dst.maybe_allocate(new_width, new_height);
 
-  detail::apply_resample_functions(func, func_safe, dst_to_src_factor_x, dst_to_src_factor_y,
-                                   safe_boundary_left, safe_boundary_right, safe_boundary_top, safe_boundary_bottom,
-                                   img_dst);
+  detail::resample_impl<interpolation_mode>(view_src, img_dst,
+                                            [&thread_pool](PixelLength height, auto func) {
+                                              detail::for_each_row_band(thread_pool, height, func);
+                                            },
+                                            detail::resample_tag<interpolation_mode, precision>{});
 }
 
 }  // namespace sln
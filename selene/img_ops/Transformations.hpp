@@ -10,9 +10,16 @@
 #include <selene/base/Assert.hpp>
 
 #include <selene/img/Image.hpp>
+#include <selene/img/OrientedView.hpp>
 #include <selene/img/PixelTraits.hpp>
 
+#include <selene/img_ops/detail/RowBands.hpp>
+#include <selene/img_ops/detail/TransposeKernels.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
 #include <algorithm>
+#include <cstddef>
 #include <utility>
 
 namespace sln {
@@ -62,27 +69,43 @@ void rotate(const Image<PixelType>& img_src, Image<PixelType>& img_dst);
 template <RotationDirection rot_dir, typename PixelType>
 Image<PixelType> rotate(const Image<PixelType>& img);
 
+template <typename PixelType>
+void clone(const OrientedView<PixelType>& view_src, Image<PixelType>& img_dst);
+
+template <typename PixelType>
+Image<PixelType> clone(const OrientedView<PixelType>& view_src);
+
+template <FlipDirection flip_dir, typename PixelType>
+void flip(const Image<PixelType>& img_src, Image<PixelType>& img_dst, ThreadPool& thread_pool);
+
+template <FlipDirection flip_dir, typename PixelType>
+Image<PixelType> flip(const Image<PixelType>& img, ThreadPool& thread_pool);
+
+template <bool flip_h = false, bool flip_v = false, typename PixelType>
+void transpose(const Image<PixelType>& img_src, Image<PixelType>& img_dst, ThreadPool& thread_pool);
+
+template <bool flip_h = false, bool flip_v = false, typename PixelType>
+Image<PixelType> transpose(const Image<PixelType>& img, ThreadPool& thread_pool);
+
+template <RotationDirection rot_dir, typename PixelType>
+void rotate(const Image<PixelType>& img_src, Image<PixelType>& img_dst, ThreadPool& thread_pool);
+
+template <RotationDirection rot_dir, typename PixelType>
+Image<PixelType> rotate(const Image<PixelType>& img, ThreadPool& thread_pool);
+
 // ----------
 // Implementation:
 
-/** \brief Flips the image contents according to the specified flip direction.
- *
- * @tparam flip_dir The flip direction. Must be provided
- * @tparam PixelType The pixel type.
- * @param img_src The source image.
- * @param[out] img_dst The flipped output image.
- */
+namespace detail {
+
 template <FlipDirection flip_dir, typename PixelType>
-void flip(const Image<PixelType>& img_src, Image<PixelType>& img_dst)
+void flip_rows(const Image<PixelType>& img_src, Image<PixelType>& img_dst, PixelIndex y_src_begin, PixelIndex y_src_end)
 {
-  SELENE_ASSERT(&img_src != &img_dst);
-  img_dst.maybe_allocate(img_src.width(), img_src.height());
-
   switch (flip_dir)
   {
     case FlipDirection::Horizontal:
     {
-      for (auto y_src = 0_idx; y_src < img_src.height(); ++y_src)
+      for (auto y_src = y_src_begin; y_src < y_src_end; ++y_src)
       {
         std::reverse_copy(img_src.data(y_src), img_src.data_row_end(y_src), img_dst.data(y_src));
       }
@@ -90,7 +113,7 @@ void flip(const Image<PixelType>& img_src, Image<PixelType>& img_dst)
     }
     case FlipDirection::Vertical:
     {
-      for (auto y_src = 0_idx; y_src < img_src.height(); ++y_src)
+      for (auto y_src = y_src_begin; y_src < y_src_end; ++y_src)
       {
         const auto y_dst = PixelIndex{img_src.height() - y_src - 1};
         std::copy(img_src.data(y_src), img_src.data_row_end(y_src), img_dst.data(y_dst));
@@ -99,7 +122,7 @@ void flip(const Image<PixelType>& img_src, Image<PixelType>& img_dst)
     }
     case FlipDirection::Both:
     {
-      for (auto y_src = 0_idx; y_src < img_src.height(); ++y_src)
+      for (auto y_src = y_src_begin; y_src < y_src_end; ++y_src)
       {
         const auto y_dst = PixelIndex{img_src.height() - y_src - 1};
         std::reverse_copy(img_src.data(y_src), img_src.data_row_end(y_src), img_dst.data(y_dst));
@@ -109,6 +132,45 @@ void flip(const Image<PixelType>& img_src, Image<PixelType>& img_dst)
   }
 }
 
+template <bool flip_h, bool flip_v, typename PixelType>
+void transpose_rows(const Image<PixelType>& img_src,
+                    Image<PixelType>& img_dst,
+                    PixelIndex y_dst_begin,
+                    PixelIndex y_dst_end)
+{
+  // Square tiles keep both the source and the target accesses local, instead of striding through the whole source
+  // image for each output row.
+  const auto dst_width = static_cast<std::ptrdiff_t>(img_dst.width());
+  const auto y_end = static_cast<std::ptrdiff_t>(y_dst_end);
+
+  for (auto y = static_cast<std::ptrdiff_t>(y_dst_begin); y < y_end; y += transpose_tile_size)
+  {
+    const auto y_tile_end = std::min(y + transpose_tile_size, y_end);
+    for (std::ptrdiff_t x = 0; x < dst_width; x += transpose_tile_size)
+    {
+      const auto x_tile_end = std::min(x + transpose_tile_size, dst_width);
+      transpose_tile<flip_h, flip_v>(img_src, img_dst, x, x_tile_end, y, y_tile_end);
+    }
+  }
+}
+
+}  // namespace detail
+
+/** \brief Flips the image contents according to the specified flip direction.
+ *
+ * @tparam flip_dir The flip direction. Must be provided
+ * @tparam PixelType The pixel type.
+ * @param img_src The source image.
+ * @param[out] img_dst The flipped output image.
+ */
+template <FlipDirection flip_dir, typename PixelType>
+void flip(const Image<PixelType>& img_src, Image<PixelType>& img_dst)
+{
+  SELENE_ASSERT(&img_src != &img_dst);
+  img_dst.maybe_allocate(img_src.width(), img_src.height());
+  detail::flip_rows<flip_dir>(img_src, img_dst, 0_idx, to_pixel_index(img_src.height()));
+}
+
 /** \brief Flips the image contents according to the specified flip direction.
  *
  * @tparam flip_dir The flip direction. Must be provided
@@ -200,16 +262,7 @@ void transpose(const Image<PixelType>& img_src, Image<PixelType>& img_dst)
 {
   SELENE_ASSERT(&img_src != &img_dst);
   img_dst.maybe_allocate(img_src.height(), img_src.width());
-
-  for (auto dst_y = 0_idx; dst_y < img_dst.height(); ++dst_y)
-  {
-    for (auto dst_x = 0_idx; dst_x < img_dst.width(); ++dst_x)
-    {
-      const auto src_x = flip_v ? PixelIndex{img_src.width() - 1 - dst_y} : dst_y;  // branch determined at
-      const auto src_y = flip_h ? PixelIndex{img_src.height() - 1 - dst_x} : dst_x;  // compile time
-      img_dst(dst_x, dst_y) = img_src(src_x, src_y);
-    }
-  }
+  detail::transpose_rows<flip_h, flip_v>(img_src, img_dst, 0_idx, to_pixel_index(img_dst.height()));
 }
 
 /** \brief Transposes the image.
@@ -227,7 +280,7 @@ template <bool flip_h, bool flip_v, typename PixelType>
 Image<PixelType> transpose(const Image<PixelType>& img)
 {
   Image<PixelType> img_t;
-  transpose(img, img_t);
+  transpose<flip_h, flip_v>(img, img_t);
   return img_t;
 }
 
@@ -287,6 +340,178 @@ Image<PixelType> rotate(const Image<PixelType>& img)
   return img_r;
 }
 
+/** \brief Materializes an oriented view, i.e. copies its pixels in the oriented layout into the output image.
+ *
+ * @tparam PixelType The pixel type.
+ * @param view_src The source view.
+ * @param[out] img_dst The output image. Must not share memory with the view.
+ */
+template <typename PixelType>
+void clone(const OrientedView<PixelType>& view_src, Image<PixelType>& img_dst)
+{
+  const auto& img_src = view_src.image();
+
+  switch (view_src.orientation())
+  {
+    case ImageOrientation::Identity: clone(img_src, img_dst); break;
+    case ImageOrientation::FlipHorizontal: flip<FlipDirection::Horizontal>(img_src, img_dst); break;
+    case ImageOrientation::Clockwise180: flip<FlipDirection::Both>(img_src, img_dst); break;
+    case ImageOrientation::FlipVertical: flip<FlipDirection::Vertical>(img_src, img_dst); break;
+    case ImageOrientation::Transpose: transpose<false, false>(img_src, img_dst); break;
+    case ImageOrientation::Clockwise90: transpose<true, false>(img_src, img_dst); break;
+    case ImageOrientation::Transverse: transpose<true, true>(img_src, img_dst); break;
+    case ImageOrientation::Clockwise270: transpose<false, true>(img_src, img_dst); break;
+  }
+}
+
+/** \brief Materializes an oriented view, i.e. copies its pixels in the oriented layout into a new image.
+ *
+ * @tparam PixelType The pixel type.
+ * @param view_src The source view.
+ * @return The output image.
+ */
+template <typename PixelType>
+Image<PixelType> clone(const OrientedView<PixelType>& view_src)
+{
+  Image<PixelType> img_dst;
+  clone(view_src, img_dst);
+  return img_dst;
+}
+
+/** \brief Flips the image contents according to the specified flip direction, in parallel.
+ *
+ * The image is split into bands of rows, each of which is processed as a separate task on the thread pool.
+ *
+ * @tparam flip_dir The flip direction. Must be provided
+ * @tparam PixelType The pixel type.
+ * @param img_src The source image.
+ * @param[out] img_dst The flipped output image.
+ * @param thread_pool The thread pool on which to execute the operation.
+ */
+template <FlipDirection flip_dir, typename PixelType>
+void flip(const Image<PixelType>& img_src, Image<PixelType>& img_dst, ThreadPool& thread_pool)
+{
+  SELENE_ASSERT(&img_src != &img_dst);
+  img_dst.maybe_allocate(img_src.width(), img_src.height());
+
+  detail::for_each_row_band(thread_pool, img_src.height(), [&img_src, &img_dst](PixelIndex y_begin, PixelIndex y_end) {
+    detail::flip_rows<flip_dir>(img_src, img_dst, y_begin, y_end);
+  });
+}
+
+/** \brief Flips the image contents according to the specified flip direction, in parallel.
+ *
+ * @tparam flip_dir The flip direction. Must be provided
+ * @tparam PixelType The pixel type.
+ * @param img The source image.
+ * @param thread_pool The thread pool on which to execute the operation.
+ * @return The flipped output image.
+ */
+template <FlipDirection flip_dir, typename PixelType>
+Image<PixelType> flip(const Image<PixelType>& img, ThreadPool& thread_pool)
+{
+  Image<PixelType> img_flip;
+  flip<flip_dir>(img, img_flip, thread_pool);
+  return img_flip;
+}
+
+/** \brief Transposes the image, in parallel.
+ *
+ * The output image is split into bands of rows, each of which is processed as a separate task on the thread pool.
+ *
+ * @tparam flip_h If true, the output will additionally be horizontally flipped.
+ * @tparam flip_v If true, the output will additionally be vertically flipped.
+ * @tparam PixelType The pixel type.
+ * @param img_src The source image.
+ * @param[out] img_dst The transposed output image.
+ * @param thread_pool The thread pool on which to execute the operation.
+ */
+template <bool flip_h, bool flip_v, typename PixelType>
+void transpose(const Image<PixelType>& img_src, Image<PixelType>& img_dst, ThreadPool& thread_pool)
+{
+  SELENE_ASSERT(&img_src != &img_dst);
+  img_dst.maybe_allocate(img_src.height(), img_src.width());
+
+  detail::for_each_row_band(thread_pool, img_dst.height(), [&img_src, &img_dst](PixelIndex y_begin, PixelIndex y_end) {
+    detail::transpose_rows<flip_h, flip_v>(img_src, img_dst, y_begin, y_end);
+  });
+}
+
+/** \brief Transposes the image, in parallel.
+ *
+ * @tparam flip_h If true, the output will additionally be horizontally flipped.
+ * @tparam flip_v If true, the output will additionally be vertically flipped.
+ * @tparam PixelType The pixel type.
+ * @param img The source image.
+ * @param thread_pool The thread pool on which to execute the operation.
+ * @return The transposed output image.
+ */
+template <bool flip_h, bool flip_v, typename PixelType>
+Image<PixelType> transpose(const Image<PixelType>& img, ThreadPool& thread_pool)
+{
+  Image<PixelType> img_t;
+  transpose<flip_h, flip_v>(img, img_t, thread_pool);
+  return img_t;
+}
+
+/** \brief Rotates the image (in 90 degree increments) by the specified amount and direction, in parallel.
+ *
+ * @tparam rot_dir The rotation amount and direction. Must be provided.
+ * @tparam PixelType The pixel type.
+ * @param img_src The source image.
+ * @param[out] img_dst The rotated output image.
+ * @param thread_pool The thread pool on which to execute the operation.
+ */
+template <RotationDirection rot_dir, typename PixelType>
+void rotate(const Image<PixelType>& img_src, Image<PixelType>& img_dst, ThreadPool& thread_pool)
+{
+  SELENE_ASSERT(&img_src != &img_dst);
+
+  switch (rot_dir)  // known at compile time
+  {
+    case RotationDirection::Clockwise0:
+    case RotationDirection::Counterclockwise0:
+    {
+      clone(img_src, img_dst);
+      break;
+    }
+    case RotationDirection::Clockwise90:
+    case RotationDirection::Counterclockwise270:
+    {
+      transpose<true, false>(img_src, img_dst, thread_pool);
+      break;
+    }
+    case RotationDirection::Clockwise180:
+    case RotationDirection::Counterclockwise180:
+    {
+      flip<FlipDirection::Both>(img_src, img_dst, thread_pool);
+      break;
+    }
+    case RotationDirection::Clockwise270:
+    case RotationDirection::Counterclockwise90:
+    {
+      transpose<false, true>(img_src, img_dst, thread_pool);
+      break;
+    }
+  }
+}
+
+/** \brief Rotates the image (in 90 degree increments) by the specified amount and direction, in parallel.
+ *
+ * @tparam rot_dir The rotation amount and direction. Must be provided.
+ * @tparam PixelType The pixel type.
+ * @param img The source image.
+ * @param thread_pool The thread pool on which to execute the operation.
+ * @return The rotated output image.
+ */
+template <RotationDirection rot_dir, typename PixelType>
+Image<PixelType> rotate(const Image<PixelType>& img, ThreadPool& thread_pool)
+{
+  Image<PixelType> img_r;
+  rotate<rot_dir>(img, img_r, thread_pool);
+  return img_r;
+}
+
 }  // namespace sln
 
 #endif  // SELENE_IMG_TRANSFORMATIONS_HPP
@@ -0,0 +1,737 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_DETAIL_CONVERSION_KERNELS_HPP
+#define SELENE_IMG_OPS_DETAIL_CONVERSION_KERNELS_HPP
+
+/// @file
+
+#include <selene/base/Promote.hpp>
+#include <selene/base/SIMD.hpp>
+#include <selene/base/Utils.hpp>
+
+#include <selene/img/PixelFormat.hpp>
+
+#include <selene/img_ops/PixelConversions.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace sln {
+
+/// \cond INTERNAL
+
+namespace detail {
+
+// Row conversion kernels operate on a contiguous row of `n` pixels, given as pointers to the first element of the
+// source and target row, respectively. They return the number of pixels that have been converted, always starting
+// from the beginning of the row. The remaining pixels are expected to be converted by the scalar code path (i.e. using
+// `PixelConversion<>`); results are guaranteed to be bit-exact with respect to the scalar code path.
+// Kernels never read or write outside of the row extents, unless `padded_rows` is true: then both rows are known to be
+// followed by at least `simd_vector_bytes` of padding (see `Image<>::simd_safe_tail()`), and kernels may process the
+// last partial vector of the row in full, reading and writing padding bytes. The returned number of pixels may then
+// exceed `n`.
+// Kernels for conversions that add an alpha channel additionally receive the alpha value.
+
+template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst, typename Element, typename = void>
+struct RowConversionKernel
+{
+  template <typename... AlphaValue>
+  static std::ptrdiff_t apply(const Element*, Element*, std::ptrdiff_t, bool, AlphaValue...) noexcept
+  {
+    return 0;
+  }
+};
+
+// ----------------------------------------
+// {RGB, BGR, RGBA, BGRA, ARGB, ABGR} -> Y
+
+inline constexpr bool is_y_kernel_source(PixelFormat pixel_format) noexcept
+{
+  return pixel_format == PixelFormat::RGB || pixel_format == PixelFormat::BGR || pixel_format == PixelFormat::RGBA
+         || pixel_format == PixelFormat::BGRA || pixel_format == PixelFormat::ARGB
+         || pixel_format == PixelFormat::ABGR;
+}
+
+inline constexpr bool has_rgb_channel_order(PixelFormat pixel_format) noexcept
+{
+  return pixel_format == PixelFormat::RGB || pixel_format == PixelFormat::RGBA || pixel_format == PixelFormat::ARGB;
+}
+
+inline constexpr std::size_t first_color_channel(PixelFormat pixel_format) noexcept
+{
+  return (pixel_format == PixelFormat::ARGB || pixel_format == PixelFormat::ABGR) ? 1 : 0;
+}
+
+static_assert(std::is_same<promote_t<std::uint8_t>, std::uint16_t>::value,
+              "Vectorized conversion kernels assume 16-bit intermediate precision");
+
+constexpr std::uint16_t y_kernel_shift_8u = 8;
+constexpr std::uint16_t y_kernel_half_8u = 1 << (y_kernel_shift_8u - 1);
+
+// Fixed-point coefficients; computed exactly as in `approximate_linear_combination<std::uint8_t, 3, Coeff>`.
+template <typename Coeff, std::size_t i>
+inline constexpr std::uint16_t y_kernel_coefficient_8u() noexcept
+{
+  return rounded_linear_combination_coeff_func<std::uint16_t, Coeff, y_kernel_shift_8u>(i);
+}
+
+#if defined(SELENE_SIMD_SSE2)
+
+inline std::int32_t load_u32_unaligned(const std::uint8_t* ptr) noexcept
+{
+  std::int32_t value;
+  std::memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+// Loads 4 pixels into the four 32-bit lanes of a register.
+// For 3-channel pixels, the most significant byte of each lane is undefined, and 1 (SSE2) or 4 (SSSE3) bytes beyond
+// the last pixel are read.
+inline __m128i load_4px_8u(const std::uint8_t* ptr, std::integral_constant<std::size_t, 4>) noexcept
+{
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+}
+
+inline __m128i load_4px_8u(const std::uint8_t* ptr, std::integral_constant<std::size_t, 3>) noexcept
+{
+#if defined(SELENE_SIMD_SSSE3)
+  const auto shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)), shuffle);
+#else
+  return _mm_setr_epi32(load_u32_unaligned(ptr), load_u32_unaligned(ptr + 3), load_u32_unaligned(ptr + 6),
+                        load_u32_unaligned(ptr + 9));
+#endif
+}
+
+template <int channel>
+inline __m128i extract_channel_8u(__m128i v) noexcept
+{
+  return _mm_and_si128(_mm_srli_epi32(v, 8 * channel), _mm_set1_epi32(0xFF));
+}
+
+// Computes the 16-bit weighted sums (already shifted) of 8 pixels, given in two registers as returned by load_4px_8u.
+template <int offset>
+inline __m128i y_weighted_sum_8u(__m128i v_lo, __m128i v_hi, __m128i c0, __m128i c1, __m128i c2, __m128i half) noexcept
+{
+  const auto x0 = _mm_packs_epi32(extract_channel_8u<offset + 0>(v_lo), extract_channel_8u<offset + 0>(v_hi));
+  const auto x1 = _mm_packs_epi32(extract_channel_8u<offset + 1>(v_lo), extract_channel_8u<offset + 1>(v_hi));
+  const auto x2 = _mm_packs_epi32(extract_channel_8u<offset + 2>(v_lo), extract_channel_8u<offset + 2>(v_hi));
+  auto sum = _mm_add_epi16(_mm_mullo_epi16(x0, c0), _mm_mullo_epi16(x1, c1));
+  sum = _mm_add_epi16(sum, _mm_mullo_epi16(x2, c2));
+  return _mm_srli_epi16(_mm_add_epi16(sum, half), y_kernel_shift_8u);
+}
+
+#endif  // defined(SELENE_SIMD_SSE2)
+
+#if defined(SELENE_SIMD_AVX2)
+
+// Loads 8 pixels into the eight 32-bit lanes of a register.
+// For 3-channel pixels, the most significant byte of each lane is zero, and 4 bytes beyond the last pixel are read.
+inline __m256i load_8px_8u(const std::uint8_t* ptr, std::integral_constant<std::size_t, 4>) noexcept
+{
+  return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+}
+
+inline __m256i load_8px_8u(const std::uint8_t* ptr, std::integral_constant<std::size_t, 3>) noexcept
+{
+  const auto shuffle = _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,  //
+                                        0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+  const auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 12));
+  return _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), shuffle);
+}
+
+template <int channel>
+inline __m256i extract_channel_8u(__m256i v) noexcept
+{
+  return _mm256_and_si256(_mm256_srli_epi32(v, 8 * channel), _mm256_set1_epi32(0xFF));
+}
+
+// Note that the 16-bit results are ordered lane-wise, i.e. [0..3, 8..11 | 4..7, 12..15].
+template <int offset>
+inline __m256i y_weighted_sum_8u(__m256i v_lo, __m256i v_hi, __m256i c0, __m256i c1, __m256i c2, __m256i half) noexcept
+{
+  const auto x0 = _mm256_packs_epi32(extract_channel_8u<offset + 0>(v_lo), extract_channel_8u<offset + 0>(v_hi));
+  const auto x1 = _mm256_packs_epi32(extract_channel_8u<offset + 1>(v_lo), extract_channel_8u<offset + 1>(v_hi));
+  const auto x2 = _mm256_packs_epi32(extract_channel_8u<offset + 2>(v_lo), extract_channel_8u<offset + 2>(v_hi));
+  auto sum = _mm256_add_epi16(_mm256_mullo_epi16(x0, c0), _mm256_mullo_epi16(x1, c1));
+  sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(x2, c2));
+  return _mm256_srli_epi16(_mm256_add_epi16(sum, half), y_kernel_shift_8u);
+}
+
+#endif  // defined(SELENE_SIMD_AVX2)
+
+#if defined(SELENE_SIMD_NEON)
+
+inline uint8x16x3_t load_16px_8u(const std::uint8_t* ptr, std::integral_constant<std::size_t, 3>) noexcept
+{
+  return vld3q_u8(ptr);
+}
+
+inline uint8x16x4_t load_16px_8u(const std::uint8_t* ptr, std::integral_constant<std::size_t, 4>) noexcept
+{
+  return vld4q_u8(ptr);
+}
+
+inline uint8x8_t y_weighted_sum_8u(uint8x8_t x0, uint8x8_t x1, uint8x8_t x2,
+                                   std::uint16_t c0, std::uint16_t c1, std::uint16_t c2) noexcept
+{
+  auto sum = vmulq_n_u16(vmovl_u8(x0), c0);
+  sum = vmlaq_n_u16(sum, vmovl_u8(x1), c1);
+  sum = vmlaq_n_u16(sum, vmovl_u8(x2), c2);
+  return vshrn_n_u16(vaddq_u16(sum, vdupq_n_u16(y_kernel_half_8u)), y_kernel_shift_8u);
+}
+
+#endif  // defined(SELENE_SIMD_NEON)
+
+template <std::size_t nr_channels, std::size_t offset, typename Coeff>
+inline std::ptrdiff_t convert_row_to_y_8u(const std::uint8_t* src,
+                                          std::uint8_t* dst,
+                                          std::ptrdiff_t n,
+                                          bool padded_rows) noexcept
+{
+  static_assert(nr_channels == 3 || nr_channels == 4, "Invalid number of channels");
+  static_assert(offset + 3 <= nr_channels, "Invalid channel offset");
+
+  std::ptrdiff_t x = 0;
+
+#if defined(SELENE_SIMD_SSE2) || defined(SELENE_SIMD_NEON)
+  constexpr auto c0 = y_kernel_coefficient_8u<Coeff, 0>();
+  constexpr auto c1 = y_kernel_coefficient_8u<Coeff, 1>();
+  constexpr auto c2 = y_kernel_coefficient_8u<Coeff, 2>();
+  constexpr auto N = std::ptrdiff_t{nr_channels};
+  using Tag = std::integral_constant<std::size_t, nr_channels>;
+#endif
+
+#if defined(SELENE_SIMD_SSE2)
+  // 3-channel loads read up to 4 bytes beyond the last loaded pixel; keep two pixels as safety margin.
+  constexpr auto margin = std::ptrdiff_t{(nr_channels == 3) ? 2 : 0};
+#endif
+
+#if defined(SELENE_SIMD_AVX2)
+  {
+    const auto v_c0 = _mm256_set1_epi16(static_cast<short>(c0));
+    const auto v_c1 = _mm256_set1_epi16(static_cast<short>(c1));
+    const auto v_c2 = _mm256_set1_epi16(static_cast<short>(c2));
+    const auto v_half = _mm256_set1_epi16(static_cast<short>(y_kernel_half_8u));
+    const auto v_permutation = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    for (; x + 32 + margin <= n; x += 32)
+    {
+      const auto ptr = src + x * N;
+      const auto v0 = load_8px_8u(ptr, Tag{});
+      const auto v1 = load_8px_8u(ptr + 8 * N, Tag{});
+      const auto v2 = load_8px_8u(ptr + 16 * N, Tag{});
+      const auto v3 = load_8px_8u(ptr + 24 * N, Tag{});
+      const auto y_lo = y_weighted_sum_8u<int{offset}>(v0, v1, v_c0, v_c1, v_c2, v_half);
+      const auto y_hi = y_weighted_sum_8u<int{offset}>(v2, v3, v_c0, v_c1, v_c2, v_half);
+      const auto y = _mm256_permutevar8x32_epi32(_mm256_packus_epi16(y_lo, y_hi), v_permutation);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x), y);
+    }
+  }
+#endif
+
+#if defined(SELENE_SIMD_SSE2)
+  {
+    const auto v_c0 = _mm_set1_epi16(static_cast<short>(c0));
+    const auto v_c1 = _mm_set1_epi16(static_cast<short>(c1));
+    const auto v_c2 = _mm_set1_epi16(static_cast<short>(c2));
+    const auto v_half = _mm_set1_epi16(static_cast<short>(y_kernel_half_8u));
+
+    // With padded rows, the last partial vector reads at most 60 bytes, and writes at most 15 bytes beyond the row
+    for (; padded_rows ? (x < n) : (x + 16 + margin <= n); x += 16)
+    {
+      const auto ptr = src + x * N;
+      const auto v0 = load_4px_8u(ptr, Tag{});
+      const auto v1 = load_4px_8u(ptr + 4 * N, Tag{});
+      const auto v2 = load_4px_8u(ptr + 8 * N, Tag{});
+      const auto v3 = load_4px_8u(ptr + 12 * N, Tag{});
+      const auto y_lo = y_weighted_sum_8u<int{offset}>(v0, v1, v_c0, v_c1, v_c2, v_half);
+      const auto y_hi = y_weighted_sum_8u<int{offset}>(v2, v3, v_c0, v_c1, v_c2, v_half);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x), _mm_packus_epi16(y_lo, y_hi));
+    }
+  }
+#endif
+
+#if defined(SELENE_SIMD_NEON)
+  for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+  {
+    const auto v = load_16px_8u(src + x * N, Tag{});
+    const auto y_lo = y_weighted_sum_8u(vget_low_u8(v.val[offset + 0]), vget_low_u8(v.val[offset + 1]),
+                                        vget_low_u8(v.val[offset + 2]), c0, c1, c2);
+    const auto y_hi = y_weighted_sum_8u(vget_high_u8(v.val[offset + 0]), vget_high_u8(v.val[offset + 1]),
+                                        vget_high_u8(v.val[offset + 2]), c0, c1, c2);
+    vst1q_u8(dst + x, vcombine_u8(y_lo, y_hi));
+  }
+#endif
+
+#if !defined(SELENE_SIMD_SSE2) && !defined(SELENE_SIMD_NEON)
+  static_cast<void>(src);
+  static_cast<void>(dst);
+  static_cast<void>(n);
+  static_cast<void>(padded_rows);
+#endif
+  return x;
+}
+
+template <PixelFormat pixel_format_src>
+struct RowConversionKernel<pixel_format_src,
+                           PixelFormat::Y,
+                           std::uint8_t,
+                           std::enable_if_t<is_y_kernel_source(pixel_format_src)>>
+{
+  using Coeff = std::conditional_t<has_rgb_channel_order(pixel_format_src), RGBToYCoefficients, BGRToYCoefficients>;
+
+  static std::ptrdiff_t apply(const std::uint8_t* src, std::uint8_t* dst, std::ptrdiff_t n, bool padded_rows) noexcept
+  {
+    return convert_row_to_y_8u<get_nr_channels(pixel_format_src), first_color_channel(pixel_format_src), Coeff>(
+        src, dst, n, padded_rows);
+  }
+};
+
+// --------------------------------------------------------------------------------
+// {Y, RGB, BGR, RGBA, BGRA, ARGB, ABGR} -> {RGB, BGR, RGBA, BGRA, ARGB, ABGR}
+//
+// All of these conversions are byte permutations of each pixel: channels are reordered, Y is broadcast to the color
+// channels, and an alpha channel is either dropped, copied, or set to the specified alpha value.
+
+inline constexpr bool is_permutation_kernel_format(PixelFormat pixel_format) noexcept
+{
+  return pixel_format == PixelFormat::Y || is_y_kernel_source(pixel_format);
+}
+
+// Returns the position of channel `c` (0: R, 1: G, 2: B, 3: A) within a pixel of the given format, or -1 if the
+// format does not contain the channel (i.e. alpha for Y, RGB and BGR). All color channels of Y map to position 0.
+inline constexpr std::int8_t channel_position(PixelFormat pixel_format, std::uint8_t c) noexcept
+{
+  switch (pixel_format)
+  {
+    case PixelFormat::Y: return (c == 3) ? -1 : 0;
+    case PixelFormat::RGB: return (c == 3) ? -1 : std::int8_t(c);
+    case PixelFormat::BGR: return (c == 3) ? -1 : std::int8_t(2 - c);
+    case PixelFormat::RGBA: return std::int8_t(c);
+    case PixelFormat::BGRA: return (c == 3) ? 3 : std::int8_t(2 - c);
+    case PixelFormat::ARGB: return std::int8_t((c + 1) % 4);
+    case PixelFormat::ABGR: return (c == 3) ? 0 : std::int8_t(3 - c);
+    default: return -1;
+  }
+}
+
+// For each target channel position, the source channel position; -1 denotes the alpha value.
+struct ChannelMap
+{
+  std::int8_t src_index[4];
+};
+
+inline constexpr ChannelMap make_channel_map(PixelFormat pixel_format_src, PixelFormat pixel_format_dst) noexcept
+{
+  ChannelMap map{{-1, -1, -1, -1}};
+  for (std::uint8_t c = 0; c < 4; ++c)
+  {
+    const auto pos_dst = channel_position(pixel_format_dst, c);
+    if (pos_dst >= 0)
+    {
+      map.src_index[pos_dst] = channel_position(pixel_format_src, c);
+    }
+  }
+  return map;
+}
+
+inline std::uint8_t alpha_value_8u() noexcept
+{
+  return 0;
+}
+
+template <typename ElementType>
+inline std::uint8_t alpha_value_8u(ElementType alpha_value) noexcept
+{
+  return static_cast<std::uint8_t>(alpha_value);
+}
+
+#if defined(SELENE_SIMD_SSSE3)
+
+struct ByteShuffle16
+{
+  std::int8_t index[16];
+};
+
+// Shuffle mask computing 4 target pixels from a 16-byte load, starting at the first of the 4 source pixels.
+// 3-channel targets are written to the first 12 bytes, followed by zeros.
+template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst>
+inline constexpr ByteShuffle16 make_byte_shuffle() noexcept
+{
+  constexpr auto nr_src = int{get_nr_channels(pixel_format_src)};
+  constexpr auto nr_dst = int{get_nr_channels(pixel_format_dst)};
+  const auto map = make_channel_map(pixel_format_src, pixel_format_dst);
+
+  ByteShuffle16 shuffle{};
+  for (int b = 0; b < 16; ++b)
+  {
+    const auto i = b / nr_dst;
+    const auto s = map.src_index[b % nr_dst];
+    shuffle.index[b] = (i >= 4 || s < 0) ? std::int8_t(-1) : std::int8_t(nr_src * i + s);
+  }
+  return shuffle;
+}
+
+// Shuffle mask computing the 16-byte target vector `vec` from a 16-byte load of 1-channel source pixels.
+template <PixelFormat pixel_format_dst>
+inline constexpr ByteShuffle16 make_broadcast_shuffle(int vec) noexcept
+{
+  constexpr auto nr_dst = int{get_nr_channels(pixel_format_dst)};
+  const auto map = make_channel_map(PixelFormat::Y, pixel_format_dst);
+
+  ByteShuffle16 shuffle{};
+  for (int b = 0; b < 16; ++b)
+  {
+    const auto q = 16 * vec + b;
+    shuffle.index[b] = (map.src_index[q % nr_dst] < 0) ? std::int8_t(-1) : std::int8_t(q / nr_dst);
+  }
+  return shuffle;
+}
+
+inline __m128i load_byte_shuffle(const ByteShuffle16& s) noexcept
+{
+  return _mm_setr_epi8(s.index[0], s.index[1], s.index[2], s.index[3], s.index[4], s.index[5], s.index[6],
+                       s.index[7], s.index[8], s.index[9], s.index[10], s.index[11], s.index[12], s.index[13],
+                       s.index[14], s.index[15]);
+}
+
+#elif defined(SELENE_SIMD_SSE2)
+
+// Loads the 4 pixels of `group`, out of the 16 pixels starting at `ptr`, into the four 32-bit lanes of a register.
+// Bytes beyond the channels of each pixel are undefined; 1-channel pixels are broadcast to all bytes of their lane.
+template <int group>
+inline __m128i load_4px_lanes_8u(const std::uint8_t* ptr, std::integral_constant<std::size_t, 1>) noexcept
+{
+  const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+  const auto v16 = (group < 2) ? _mm_unpacklo_epi8(v, v) : _mm_unpackhi_epi8(v, v);
+  return (group % 2 == 0) ? _mm_unpacklo_epi16(v16, v16) : _mm_unpackhi_epi16(v16, v16);
+}
+
+template <int group, std::size_t nr_channels>
+inline __m128i load_4px_lanes_8u(const std::uint8_t* ptr, std::integral_constant<std::size_t, nr_channels> tag) noexcept
+{
+  return load_4px_8u(ptr + 4 * group * int{nr_channels}, tag);
+}
+
+// Returns the mask of the target bytes in each 32-bit lane that are taken from the source byte `shift` positions
+// higher (or lower, if negative).
+inline constexpr std::uint32_t lane_shift_mask(const ChannelMap& map, int shift) noexcept
+{
+  std::uint32_t mask = 0;
+  for (int j = 0; j < 4; ++j)
+  {
+    if (map.src_index[j] >= 0 && map.src_index[j] - j == shift)
+    {
+      mask |= std::uint32_t{0xFF} << (8 * j);
+    }
+  }
+  return mask;
+}
+
+// Returns the mask of the target bytes in each 32-bit lane that are taken from a source channel.
+inline constexpr std::uint32_t lane_color_mask(const ChannelMap& map) noexcept
+{
+  std::uint32_t mask = 0;
+  for (int j = 0; j < 4; ++j)
+  {
+    if (map.src_index[j] >= 0)
+    {
+      mask |= std::uint32_t{0xFF} << (8 * j);
+    }
+  }
+  return mask;
+}
+
+// Permutes the bytes within each 32-bit lane; target bytes that are set to the alpha value are zero.
+template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst>
+inline __m128i permute_lanes_8u(__m128i v) noexcept
+{
+  constexpr auto map = make_channel_map(pixel_format_src, pixel_format_dst);
+
+  if (pixel_format_src == PixelFormat::Y)
+  {
+    // Broadcast by load_4px_lanes_8u() already
+    return _mm_and_si128(v, _mm_set1_epi32(static_cast<int>(lane_color_mask(map))));
+  }
+
+  auto r = _mm_setzero_si128();
+  for (int shift = -3; shift <= 3; ++shift)
+  {
+    const auto mask = lane_shift_mask(map, shift);
+    if (mask != 0)
+    {
+      const auto t = (shift >= 0) ? _mm_srli_epi32(v, 8 * shift) : _mm_slli_epi32(v, -8 * shift);
+      r = _mm_or_si128(r, _mm_and_si128(t, _mm_set1_epi32(static_cast<int>(mask))));
+    }
+  }
+  return r;
+}
+
+// Packs four 32-bit lanes, each holding a 3-channel pixel followed by a zero byte, into the first 12 bytes.
+inline __m128i compact_lanes_3_8u(__m128i v) noexcept
+{
+  const auto mask_lo32 = _mm_set_epi32(0, -1, 0, -1);
+  const auto v6 = _mm_or_si128(_mm_and_si128(v, mask_lo32), _mm_srli_epi64(_mm_andnot_si128(mask_lo32, v), 8));
+  const auto mask_lo64 = _mm_set_epi32(0, 0, -1, -1);
+  return _mm_or_si128(_mm_and_si128(v6, mask_lo64), _mm_srli_si128(_mm_andnot_si128(mask_lo64, v6), 2));
+}
+
+#endif
+
+#if defined(SELENE_SIMD_SSE2)
+
+// Converts the 4 pixels of `group`, out of the 16 pixels starting at `ptr`. 4-channel targets are returned as four
+// 32-bit lanes; 3-channel targets in the first 12 bytes, followed by zeros.
+template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst, int group>
+inline __m128i permute_4px_8u(const std::uint8_t* ptr, __m128i v_alpha) noexcept
+{
+  constexpr auto nr_src = get_nr_channels(pixel_format_src);
+  constexpr auto nr_dst = get_nr_channels(pixel_format_dst);
+
+#if defined(SELENE_SIMD_SSSE3)
+  constexpr auto shuffle = make_byte_shuffle<pixel_format_src, pixel_format_dst>();
+  const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 4 * group * int{nr_src}));
+  auto r = _mm_shuffle_epi8(v, load_byte_shuffle(shuffle));
+#else
+  const auto v = load_4px_lanes_8u<group>(ptr, std::integral_constant<std::size_t, nr_src>{});
+  auto r = permute_lanes_8u<pixel_format_src, pixel_format_dst>(v);
+#endif
+
+  if (conversion_requires_alpha_value(pixel_format_src, pixel_format_dst))
+  {
+    r = _mm_or_si128(r, v_alpha);
+  }
+
+#if !defined(SELENE_SIMD_SSSE3)
+  if (nr_dst == 3)
+  {
+    r = compact_lanes_3_8u(r);
+  }
+#else
+  static_cast<void>(nr_dst);
+#endif
+  return r;
+}
+
+#endif  // defined(SELENE_SIMD_SSE2)
+
+#if defined(SELENE_SIMD_NEON)
+
+inline void load_16px_channels_8u(const std::uint8_t* ptr, uint8x16_t* v, std::integral_constant<std::size_t, 1>)
+{
+  v[0] = vld1q_u8(ptr);
+}
+
+inline void load_16px_channels_8u(const std::uint8_t* ptr, uint8x16_t* v, std::integral_constant<std::size_t, 3>)
+{
+  const auto p = vld3q_u8(ptr);
+  v[0] = p.val[0];
+  v[1] = p.val[1];
+  v[2] = p.val[2];
+}
+
+inline void load_16px_channels_8u(const std::uint8_t* ptr, uint8x16_t* v, std::integral_constant<std::size_t, 4>)
+{
+  const auto p = vld4q_u8(ptr);
+  v[0] = p.val[0];
+  v[1] = p.val[1];
+  v[2] = p.val[2];
+  v[3] = p.val[3];
+}
+
+inline void store_16px_channels_8u(std::uint8_t* ptr, const uint8x16_t* v, std::integral_constant<std::size_t, 3>)
+{
+  uint8x16x3_t p;
+  p.val[0] = v[0];
+  p.val[1] = v[1];
+  p.val[2] = v[2];
+  vst3q_u8(ptr, p);
+}
+
+inline void store_16px_channels_8u(std::uint8_t* ptr, const uint8x16_t* v, std::integral_constant<std::size_t, 4>)
+{
+  uint8x16x4_t p;
+  p.val[0] = v[0];
+  p.val[1] = v[1];
+  p.val[2] = v[2];
+  p.val[3] = v[3];
+  vst4q_u8(ptr, p);
+}
+
+#endif  // defined(SELENE_SIMD_NEON)
+
+template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst>
+inline std::ptrdiff_t permute_row_8u(const std::uint8_t* src,
+                                     std::uint8_t* dst,
+                                     std::ptrdiff_t n,
+                                     bool padded_rows,
+                                     std::uint8_t alpha_value) noexcept
+{
+  std::ptrdiff_t x = 0;
+
+#if defined(SELENE_SIMD_SSE2) || defined(SELENE_SIMD_NEON)
+  constexpr auto nr_src = std::ptrdiff_t{get_nr_channels(pixel_format_src)};
+  constexpr auto nr_dst = std::ptrdiff_t{get_nr_channels(pixel_format_dst)};
+#endif
+
+#if defined(SELENE_SIMD_AVX2)
+  if (nr_src == 4 && nr_dst == 4)
+  {
+    constexpr auto shuffle = make_byte_shuffle<pixel_format_src, pixel_format_dst>();
+    const auto mask_256 = _mm256_broadcastsi128_si256(load_byte_shuffle(shuffle));
+    for (; x + 8 <= n; x += 8)
+    {
+      const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + 4 * x));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 4 * x), _mm256_shuffle_epi8(v, mask_256));
+    }
+  }
+#endif
+
+#if defined(SELENE_SIMD_SSE2)
+  {
+    constexpr auto alpha_shift = 8 * std::max(0, int{channel_position(pixel_format_dst, 3)});
+    const auto v_alpha = conversion_requires_alpha_value(pixel_format_src, pixel_format_dst)
+                             ? _mm_set1_epi32(static_cast<int>(std::uint32_t{alpha_value} << alpha_shift))
+                             : _mm_setzero_si128();
+
+#if defined(SELENE_SIMD_SSSE3)
+    // For 1-channel sources, a single load holds 16 source pixels, and each target vector is a single shuffle of it.
+    if (nr_src == 1)
+    {
+      constexpr auto shuffle0 = make_broadcast_shuffle<pixel_format_dst>(0);
+      constexpr auto shuffle1 = make_broadcast_shuffle<pixel_format_dst>(1);
+      constexpr auto shuffle2 = make_broadcast_shuffle<pixel_format_dst>(2);
+      constexpr auto shuffle3 = make_broadcast_shuffle<pixel_format_dst>(3);
+      const auto mask0 = load_byte_shuffle(shuffle0);
+      const auto mask1 = load_byte_shuffle(shuffle1);
+      const auto mask2 = load_byte_shuffle(shuffle2);
+      const auto mask3 = load_byte_shuffle(shuffle3);
+      for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+      {
+        // The target vectors are computed last to first; with GCC, the resulting instruction schedule was measured to
+        // be up to 25% faster for these store-bound conversions.
+        const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x));
+        const auto r3 = _mm_or_si128(_mm_shuffle_epi8(v, mask3), v_alpha);
+        const auto r2 = _mm_or_si128(_mm_shuffle_epi8(v, mask2), v_alpha);
+        const auto r1 = _mm_or_si128(_mm_shuffle_epi8(v, mask1), v_alpha);
+        const auto r0 = _mm_or_si128(_mm_shuffle_epi8(v, mask0), v_alpha);
+        const auto ptr_dst = dst + x * nr_dst;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst), r0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst + 16), r1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst + 32), r2);
+        if (nr_dst == 4)
+        {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst + 48), r3);
+        }
+      }
+      return x;
+    }
+
+    // Each group of 4 pixels is loaded with 16 bytes, starting at its first pixel.
+    constexpr auto read_bytes = 12 * nr_src + 16;
+#else
+    // Without byte shuffles, the lane-wise permutation and repacking of 3-channel targets does not beat the scalar
+    // code path (which the compiler vectorizes well for these cases) unless alpha channels are dropped.
+    if (nr_dst == 3 && nr_src != 4)
+    {
+      return x;
+    }
+
+    // Each group of 4 pixels is loaded with (at most) 16 bytes, starting at its first pixel; 1-channel sources are
+    // loaded with 16 bytes at once.
+    constexpr auto read_bytes = (nr_src == 1) ? std::ptrdiff_t{16} : 12 * nr_src + 16;
+#endif
+
+    // With padded rows, the last partial vector reads at most 52 bytes, and writes at most 60 bytes beyond the row.
+    for (; padded_rows ? (x < n) : (x * nr_src + read_bytes <= n * nr_src); x += 16)
+    {
+      const auto ptr_src = src + x * nr_src;
+      const auto ptr_dst = dst + x * nr_dst;
+      // Computed last to first, as above
+      const auto r3 = permute_4px_8u<pixel_format_src, pixel_format_dst, 3>(ptr_src, v_alpha);
+      const auto r2 = permute_4px_8u<pixel_format_src, pixel_format_dst, 2>(ptr_src, v_alpha);
+      const auto r1 = permute_4px_8u<pixel_format_src, pixel_format_dst, 1>(ptr_src, v_alpha);
+      const auto r0 = permute_4px_8u<pixel_format_src, pixel_format_dst, 0>(ptr_src, v_alpha);
+
+      if (nr_dst == 4)
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst), r0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst + 16), r1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst + 32), r2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst + 48), r3);
+      }
+      else
+      {
+        // 4 x 12 bytes -> 3 x 16 bytes
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst), _mm_or_si128(r0, _mm_slli_si128(r1, 12)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst + 16),
+                         _mm_or_si128(_mm_srli_si128(r1, 4), _mm_slli_si128(r2, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr_dst + 32),
+                         _mm_or_si128(_mm_srli_si128(r2, 8), _mm_slli_si128(r3, 4)));
+      }
+    }
+  }
+#endif
+
+#if defined(SELENE_SIMD_NEON)
+  {
+    constexpr auto map = make_channel_map(pixel_format_src, pixel_format_dst);
+    const auto v_alpha = vdupq_n_u8(alpha_value);
+    uint8x16_t v[4];
+    uint8x16_t r[4];
+    for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+    {
+      load_16px_channels_8u(src + x * nr_src, v, std::integral_constant<std::size_t, nr_src>{});
+      for (std::ptrdiff_t j = 0; j < nr_dst; ++j)
+      {
+        r[j] = (map.src_index[j] < 0) ? v_alpha : v[map.src_index[j]];
+      }
+      store_16px_channels_8u(dst + x * nr_dst, r, std::integral_constant<std::size_t, nr_dst>{});
+    }
+  }
+#endif
+
+#if !defined(SELENE_SIMD_SSE2) && !defined(SELENE_SIMD_NEON)
+  static_cast<void>(src);
+  static_cast<void>(dst);
+  static_cast<void>(n);
+  static_cast<void>(padded_rows);
+  static_cast<void>(alpha_value);
+#endif
+  return x;
+}
+
+template <PixelFormat pixel_format_src, PixelFormat pixel_format_dst>
+struct RowConversionKernel<pixel_format_src,
+                           pixel_format_dst,
+                           std::uint8_t,
+                           std::enable_if_t<is_permutation_kernel_format(pixel_format_src)
+                                            && is_permutation_kernel_format(pixel_format_dst)
+                                            && pixel_format_dst != PixelFormat::Y>>
+{
+  template <typename... AlphaValue>
+  static std::ptrdiff_t apply(const std::uint8_t* src,
+                              std::uint8_t* dst,
+                              std::ptrdiff_t n,
+                              bool padded_rows,
+                              AlphaValue... alpha_value) noexcept
+  {
+    return permute_row_8u<pixel_format_src, pixel_format_dst>(src, dst, n, padded_rows,
+                                                               alpha_value_8u(alpha_value...));
+  }
+};
+
+}  // namespace detail
+
+/// \endcond
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_DETAIL_CONVERSION_KERNELS_HPP
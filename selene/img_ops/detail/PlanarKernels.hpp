@@ -0,0 +1,302 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_DETAIL_PLANAR_KERNELS_HPP
+#define SELENE_IMG_OPS_DETAIL_PLANAR_KERNELS_HPP
+
+/// @file
+
+#include <selene/base/SIMD.hpp>
+
+#include <selene/img_ops/detail/TransposeKernels.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sln {
+
+/// \cond INTERNAL
+
+namespace detail {
+
+// Planar row kernels convert a contiguous row of `n` pixels between interleaved storage (`N` elements per pixel) and
+// planar storage (one row pointer per channel). They return the number of pixels that have been converted, always
+// starting from the beginning of the row; the remaining pixels are expected to be converted by the scalar code path.
+// As for the row conversion kernels (see ConversionKernels.hpp), kernels never read or write outside of the row
+// extents, unless `padded_rows` is true; then the last partial vector of the row may be processed in full.
+//
+// On x86, the 3-channel kernels need SSSE3 (`pshufb`), i.e. they are not vectorized in the default SSE2-only x86-64
+// build; the 4-channel kernels only need SSE2, and use SSSE3 for deinterleaving where available. There are no AVX2
+// variants, since byte shuffles do not cross the 128-bit lanes of AVX2 registers, which makes 3-channel layouts
+// awkward to handle; the 128-bit kernels are used instead.
+
+template <typename Element, std::size_t N>
+struct DeinterleaveKernel
+{
+  static std::ptrdiff_t apply(const Element*, Element* const*, std::ptrdiff_t, bool) noexcept
+  {
+    return 0;
+  }
+};
+
+template <typename Element, std::size_t N>
+struct InterleaveKernel
+{
+  static std::ptrdiff_t apply(const Element* const*, Element*, std::ptrdiff_t, bool) noexcept
+  {
+    return 0;
+  }
+};
+
+#if defined(SELENE_SIMD_SSSE3)
+
+// Shuffle mask gathering channel `c` from the `k`-th of three consecutive vectors holding 16 interleaved 3-byte pixels.
+inline __m128i deinterleave_mask_8u3(int k, int c) noexcept
+{
+  alignas(16) std::int8_t mask[16];
+  for (int i = 0; i < 16; ++i)
+  {
+    const auto j = 3 * i + c - 16 * k;
+    mask[i] = static_cast<std::int8_t>((j >= 0 && j < 16) ? j : -128);
+  }
+  return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+// Shuffle mask scattering the 16 elements of channel `c` to their positions in the `k`-th of three consecutive vectors
+// holding 16 interleaved 3-byte pixels.
+inline __m128i interleave_mask_8u3(int k, int c) noexcept
+{
+  alignas(16) std::int8_t mask[16];
+  for (int j = 0; j < 16; ++j)
+  {
+    const auto i = 16 * k + j;
+    mask[j] = static_cast<std::int8_t>((i % 3 == c) ? i / 3 : -128);
+  }
+  return _mm_load_si128(reinterpret_cast<const __m128i*>(mask));
+}
+
+#endif
+
+template <>
+struct DeinterleaveKernel<std::uint8_t, 3>
+{
+  static std::ptrdiff_t apply(const std::uint8_t* src, std::uint8_t* const* dst, std::ptrdiff_t n, bool padded_rows)
+      noexcept
+  {
+    std::ptrdiff_t x = 0;
+
+#if defined(SELENE_SIMD_SSSE3)
+    __m128i masks[3][3];
+    for (int k = 0; k < 3; ++k)
+    {
+      for (int c = 0; c < 3; ++c)
+      {
+        masks[k][c] = deinterleave_mask_8u3(k, c);
+      }
+    }
+
+    for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+    {
+      const auto v0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * x));
+      const auto v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * x + 16));
+      const auto v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * x + 32));
+
+      for (int c = 0; c < 3; ++c)
+      {
+        const auto r = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, masks[0][c]), _mm_shuffle_epi8(v1, masks[1][c])),
+                                    _mm_shuffle_epi8(v2, masks[2][c]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst[c] + x), r);
+      }
+    }
+#elif defined(SELENE_SIMD_NEON)
+    for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+    {
+      const auto v = vld3q_u8(src + 3 * x);
+      vst1q_u8(dst[0] + x, v.val[0]);
+      vst1q_u8(dst[1] + x, v.val[1]);
+      vst1q_u8(dst[2] + x, v.val[2]);
+    }
+#else
+    static_cast<void>(src);
+    static_cast<void>(dst);
+    static_cast<void>(n);
+    static_cast<void>(padded_rows);
+#endif
+    return x;
+  }
+};
+
+template <>
+struct DeinterleaveKernel<std::uint8_t, 4>
+{
+  static std::ptrdiff_t apply(const std::uint8_t* src, std::uint8_t* const* dst, std::ptrdiff_t n, bool padded_rows)
+      noexcept
+  {
+    std::ptrdiff_t x = 0;
+
+#if defined(SELENE_SIMD_SSSE3)
+    // Groups the bytes of each 4-pixel vector by channel, such that a 4x4 transpose of 32-bit values yields the planes
+    const auto mask = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+
+    for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+    {
+      auto r0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x)), mask);
+      auto r1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x + 16)), mask);
+      auto r2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x + 32)), mask);
+      auto r3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x + 48)), mask);
+
+      transpose_4x4_u32(r0, r1, r2, r3);
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst[0] + x), r0);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst[1] + x), r1);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst[2] + x), r2);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst[3] + x), r3);
+    }
+#elif defined(SELENE_SIMD_SSE2)
+    // Without byte shuffles, each channel is isolated within the 32-bit lanes by shifting and masking, and the lanes of
+    // four vectors are then narrowed to bytes (the values fit, so the saturating packs do not alter them)
+    const auto mask = _mm_set1_epi32(0xFF);
+
+    for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+    {
+      __m128i v[4];
+      for (int k = 0; k < 4; ++k)
+      {
+        v[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x + 16 * k));
+      }
+
+      for (int c = 0; c < 4; ++c)
+      {
+        const auto r = _mm_packus_epi16(_mm_packs_epi32(_mm_and_si128(v[0], mask), _mm_and_si128(v[1], mask)),
+                                        _mm_packs_epi32(_mm_and_si128(v[2], mask), _mm_and_si128(v[3], mask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst[c] + x), r);
+
+        for (int k = 0; k < 4; ++k)
+        {
+          v[k] = _mm_srli_epi32(v[k], 8);
+        }
+      }
+    }
+#elif defined(SELENE_SIMD_NEON)
+    for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+    {
+      const auto v = vld4q_u8(src + 4 * x);
+      vst1q_u8(dst[0] + x, v.val[0]);
+      vst1q_u8(dst[1] + x, v.val[1]);
+      vst1q_u8(dst[2] + x, v.val[2]);
+      vst1q_u8(dst[3] + x, v.val[3]);
+    }
+#else
+    static_cast<void>(src);
+    static_cast<void>(dst);
+    static_cast<void>(n);
+    static_cast<void>(padded_rows);
+#endif
+    return x;
+  }
+};
+
+template <>
+struct InterleaveKernel<std::uint8_t, 3>
+{
+  static std::ptrdiff_t apply(const std::uint8_t* const* src, std::uint8_t* dst, std::ptrdiff_t n, bool padded_rows)
+      noexcept
+  {
+    std::ptrdiff_t x = 0;
+
+#if defined(SELENE_SIMD_SSSE3)
+    __m128i masks[3][3];
+    for (int k = 0; k < 3; ++k)
+    {
+      for (int c = 0; c < 3; ++c)
+      {
+        masks[k][c] = interleave_mask_8u3(k, c);
+      }
+    }
+
+    for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+    {
+      const auto p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[0] + x));
+      const auto p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[1] + x));
+      const auto p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[2] + x));
+
+      for (int k = 0; k < 3; ++k)
+      {
+        const auto r = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(p0, masks[k][0]), _mm_shuffle_epi8(p1, masks[k][1])),
+                                    _mm_shuffle_epi8(p2, masks[k][2]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 3 * x + 16 * k), r);
+      }
+    }
+#elif defined(SELENE_SIMD_NEON)
+    for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+    {
+      uint8x16x3_t v;
+      v.val[0] = vld1q_u8(src[0] + x);
+      v.val[1] = vld1q_u8(src[1] + x);
+      v.val[2] = vld1q_u8(src[2] + x);
+      vst3q_u8(dst + 3 * x, v);
+    }
+#else
+    static_cast<void>(src);
+    static_cast<void>(dst);
+    static_cast<void>(n);
+    static_cast<void>(padded_rows);
+#endif
+    return x;
+  }
+};
+
+template <>
+struct InterleaveKernel<std::uint8_t, 4>
+{
+  static std::ptrdiff_t apply(const std::uint8_t* const* src, std::uint8_t* dst, std::ptrdiff_t n, bool padded_rows)
+      noexcept
+  {
+    std::ptrdiff_t x = 0;
+
+#if defined(SELENE_SIMD_SSE2)
+    for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+    {
+      const auto p0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[0] + x));
+      const auto p1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[1] + x));
+      const auto p2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[2] + x));
+      const auto p3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src[3] + x));
+
+      const auto p01_lo = _mm_unpacklo_epi8(p0, p1);  // pixels 0-7, channels 0, 1
+      const auto p01_hi = _mm_unpackhi_epi8(p0, p1);  // pixels 8-15, channels 0, 1
+      const auto p23_lo = _mm_unpacklo_epi8(p2, p3);  // pixels 0-7, channels 2, 3
+      const auto p23_hi = _mm_unpackhi_epi8(p2, p3);  // pixels 8-15, channels 2, 3
+
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * x), _mm_unpacklo_epi16(p01_lo, p23_lo));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * x + 16), _mm_unpackhi_epi16(p01_lo, p23_lo));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * x + 32), _mm_unpacklo_epi16(p01_hi, p23_hi));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * x + 48), _mm_unpackhi_epi16(p01_hi, p23_hi));
+    }
+#elif defined(SELENE_SIMD_NEON)
+    for (; padded_rows ? (x < n) : (x + 16 <= n); x += 16)
+    {
+      uint8x16x4_t v;
+      v.val[0] = vld1q_u8(src[0] + x);
+      v.val[1] = vld1q_u8(src[1] + x);
+      v.val[2] = vld1q_u8(src[2] + x);
+      v.val[3] = vld1q_u8(src[3] + x);
+      vst4q_u8(dst + 4 * x, v);
+    }
+#else
+    static_cast<void>(src);
+    static_cast<void>(dst);
+    static_cast<void>(n);
+    static_cast<void>(padded_rows);
+#endif
+    return x;
+  }
+};
+
+}  // namespace detail
+
+/// \endcond
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_DETAIL_PLANAR_KERNELS_HPP
@@ -0,0 +1,55 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_DETAIL_ROW_BANDS_HPP
+#define SELENE_IMG_OPS_DETAIL_ROW_BANDS_HPP
+
+/// @file
+
+#include <selene/img/Types.hpp>
+
+#include <selene/thread/Parallel.hpp>
+#include <selene/thread/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace sln {
+
+/// \cond INTERNAL
+
+namespace detail {
+
+/// Number of row bands per participating thread; more than one band per thread evens out differing per-row costs.
+constexpr std::size_t row_bands_per_thread = 4;
+
+/** \brief Splits the row range [0, height) into contiguous bands and processes the bands in parallel.
+ *
+ * Returns only after all bands have been processed; the calling thread takes part in the work.
+ * See `parallel_for` for the exception behavior.
+ *
+ * @tparam Func The function type. Its signature should be `void f(PixelIndex y_begin, PixelIndex y_end)`.
+ * @param thread_pool The thread pool to run the tasks on.
+ * @param height The number of rows.
+ * @param func The function to be invoked for each row band.
+ */
+template <typename Func>
+void for_each_row_band(ThreadPool& thread_pool, PixelLength height, Func func)
+{
+  const auto nr_rows = static_cast<std::size_t>(height);
+  const auto nr_bands = std::max(std::size_t{1}, std::min(nr_rows, (thread_pool.size() + 1) * row_bands_per_thread));
+  const auto band_height = std::max(std::size_t{1}, (nr_rows + nr_bands - 1) / nr_bands);
+
+  parallel_for(thread_pool, std::size_t{0}, nr_rows, band_height, [&func](std::size_t y_begin, std::size_t y_end) {
+    func(to_pixel_index(y_begin), to_pixel_index(y_end));
+  });
+}
+
+}  // namespace detail
+
+/// \endcond
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_DETAIL_ROW_BANDS_HPP
@@ -0,0 +1,458 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_DETAIL_SEPARABLE_RESAMPLE_HPP
+#define SELENE_IMG_OPS_DETAIL_SEPARABLE_RESAMPLE_HPP
+
+/// @file
+
+#include <selene/base/Types.hpp>
+
+#include <selene/img/Image.hpp>
+#include <selene/img/Interpolators.hpp>
+#include <selene/img/PixelTraits.hpp>
+#include <selene/img/Types.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+/// \cond INTERNAL
+
+namespace detail {
+
+// Filter functions for the separable resampler. Each provides its support radius (in source pixels, at scale 1) and
+// its value at position x.
+
+template <ImageInterpolationMode interpolation_mode>
+struct ResampleFilter;
+
+template <>
+struct ResampleFilter<ImageInterpolationMode::Bicubic>
+{
+  static constexpr double support = 2.0;
+
+  // Cubic convolution kernel (Keys), with a = -0.5
+  static double evaluate(double x) noexcept
+  {
+    constexpr double a = -0.5;
+    x = std::abs(x);
+
+    if (x < 1.0)
+    {
+      return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0;
+    }
+
+    if (x < 2.0)
+    {
+      return (((x - 5.0) * x + 8.0) * x - 4.0) * a;
+    }
+
+    return 0.0;
+  }
+};
+
+template <>
+struct ResampleFilter<ImageInterpolationMode::Lanczos3>
+{
+  static constexpr double support = 3.0;
+
+  static double evaluate(double x) noexcept
+  {
+    if (x > -3.0 && x < 3.0)
+    {
+      return sinc(x) * sinc(x / 3.0);
+    }
+
+    return 0.0;
+  }
+
+private:
+  static double sinc(double x) noexcept
+  {
+    if (x == 0.0)
+    {
+      return 1.0;
+    }
+
+    constexpr double pi = 3.14159265358979323846;
+    x *= pi;
+    return std::sin(x) / x;
+  }
+};
+
+// Per destination position (column or row): the first contributing source position, and the weights of all
+// contributing source positions. Weights are stored with a fixed stride of `max_taps` per destination position.
+template <typename Weight>
+struct ResampleCoefficients
+{
+  std::vector<std::ptrdiff_t> first;
+  std::vector<std::ptrdiff_t> nr_taps;
+  std::vector<Weight> weights;
+  std::size_t max_taps = 0;
+
+  const Weight* weights_for(std::size_t i) const noexcept
+  {
+    return weights.data() + i * max_taps;
+  }
+};
+
+// Area: each destination pixel is the average of the source area it covers; partially covered source pixels are
+// weighted by their coverage.
+inline ResampleCoefficients<double> compute_area_coefficients(std::ptrdiff_t src_length, std::ptrdiff_t dst_length)
+{
+  const auto scale = static_cast<double>(src_length) / static_cast<double>(dst_length);
+
+  ResampleCoefficients<double> coeffs;
+  coeffs.max_taps = static_cast<std::size_t>(std::ceil(scale)) + 1;
+  coeffs.first.resize(static_cast<std::size_t>(dst_length));
+  coeffs.nr_taps.resize(static_cast<std::size_t>(dst_length));
+  coeffs.weights.resize(static_cast<std::size_t>(dst_length) * coeffs.max_taps, 0.0);
+
+  for (std::ptrdiff_t i = 0; i < dst_length; ++i)
+  {
+    const auto begin = static_cast<double>(i) * scale;
+    const auto end = std::min(static_cast<double>(i + 1) * scale, static_cast<double>(src_length));
+    const auto first = static_cast<std::ptrdiff_t>(std::floor(begin));
+    const auto last = std::min(src_length, static_cast<std::ptrdiff_t>(std::ceil(end)));
+
+    auto weights = coeffs.weights.data() + static_cast<std::size_t>(i) * coeffs.max_taps;
+    std::ptrdiff_t nr_taps = 0;
+    for (auto j = first; j < last && static_cast<std::size_t>(nr_taps) < coeffs.max_taps; ++j, ++nr_taps)
+    {
+      const auto overlap = std::min(end, static_cast<double>(j + 1)) - std::max(begin, static_cast<double>(j));
+      weights[nr_taps] = std::max(0.0, overlap) / (end - begin);
+    }
+
+    coeffs.first[static_cast<std::size_t>(i)] = first;
+    coeffs.nr_taps[static_cast<std::size_t>(i)] = nr_taps;
+  }
+
+  return coeffs;
+}
+
+// Filter based: the filter is centered on each destination pixel center (mapped to source coordinates), and stretched
+// by the downscaling factor, s.t. it acts as a low-pass filter. Weights are normalized to sum up to 1.
+template <ImageInterpolationMode interpolation_mode>
+ResampleCoefficients<double> compute_filter_coefficients(std::ptrdiff_t src_length, std::ptrdiff_t dst_length)
+{
+  using Filter = ResampleFilter<interpolation_mode>;
+
+  const auto scale = static_cast<double>(src_length) / static_cast<double>(dst_length);
+  const auto filter_scale = std::max(scale, 1.0);
+  const auto support = Filter::support * filter_scale;
+
+  ResampleCoefficients<double> coeffs;
+  coeffs.max_taps = static_cast<std::size_t>(std::ceil(support)) * 2 + 1;
+  coeffs.first.resize(static_cast<std::size_t>(dst_length));
+  coeffs.nr_taps.resize(static_cast<std::size_t>(dst_length));
+  coeffs.weights.resize(static_cast<std::size_t>(dst_length) * coeffs.max_taps, 0.0);
+
+  for (std::ptrdiff_t i = 0; i < dst_length; ++i)
+  {
+    const auto center = (static_cast<double>(i) + 0.5) * scale;
+    const auto first = std::max(std::ptrdiff_t{0}, static_cast<std::ptrdiff_t>(std::floor(center - support + 0.5)));
+    const auto last = std::min(src_length, static_cast<std::ptrdiff_t>(std::floor(center + support + 0.5)));
+
+    auto weights = coeffs.weights.data() + static_cast<std::size_t>(i) * coeffs.max_taps;
+    std::ptrdiff_t nr_taps = 0;
+    auto sum = 0.0;
+    for (auto j = first; j < last && static_cast<std::size_t>(nr_taps) < coeffs.max_taps; ++j, ++nr_taps)
+    {
+      weights[nr_taps] = Filter::evaluate((static_cast<double>(j) + 0.5 - center) / filter_scale);
+      sum += weights[nr_taps];
+    }
+
+    if (sum != 0.0)
+    {
+      std::for_each(weights, weights + nr_taps, [sum](double& w) { w /= sum; });
+    }
+
+    coeffs.first[static_cast<std::size_t>(i)] = first;
+    coeffs.nr_taps[static_cast<std::size_t>(i)] = nr_taps;
+  }
+
+  return coeffs;
+}
+
+template <ImageInterpolationMode interpolation_mode>
+ResampleCoefficients<double> compute_resample_coefficients(std::ptrdiff_t src_length,
+                                                           std::ptrdiff_t dst_length,
+                                                           std::true_type /* is_area */)
+{
+  return compute_area_coefficients(src_length, dst_length);
+}
+
+template <ImageInterpolationMode interpolation_mode>
+ResampleCoefficients<double> compute_resample_coefficients(std::ptrdiff_t src_length,
+                                                           std::ptrdiff_t dst_length,
+                                                           std::false_type /* is_area */)
+{
+  return compute_filter_coefficients<interpolation_mode>(src_length, dst_length);
+}
+
+// Arithmetic used for resampling, depending on the pixel element type.
+// 8- and 16-bit integral elements use fixed-point weights with `precision_bits` fractional bits; all other element
+// types use floating point weights.
+template <typename Element, typename = void>
+struct ResampleArithmetic
+{
+  using Weight = std::conditional_t<std::is_same<Element, float>::value, float, double>;
+  using Accumulator = Weight;
+  static constexpr int precision_bits = 0;
+
+  static constexpr Accumulator initial_value() noexcept
+  {
+    return Accumulator{0};
+  }
+
+  static Weight to_weight(double w) noexcept
+  {
+    return static_cast<Weight>(w);
+  }
+
+  static Element to_element(Accumulator value) noexcept
+  {
+    return to_element(value, std::integral_constant<bool, std::is_integral<Element>::value>{});
+  }
+
+private:
+  static Element to_element(Accumulator value, std::true_type) noexcept
+  {
+    constexpr auto lowest = static_cast<Accumulator>(std::numeric_limits<Element>::lowest());
+    constexpr auto highest = static_cast<Accumulator>(std::numeric_limits<Element>::max());
+    return static_cast<Element>(std::round(std::max(lowest, std::min(value, highest))));
+  }
+
+  static Element to_element(Accumulator value, std::false_type) noexcept
+  {
+    return static_cast<Element>(value);
+  }
+};
+
+template <typename Element>
+struct ResampleArithmetic<Element, std::enable_if_t<std::is_integral<Element>::value && sizeof(Element) <= 2>>
+{
+  using Weight = std::int32_t;
+  // The sum of absolute weights of a (normalized) filter with negative lobes stays well below 2, so 8-bit values fit
+  // into 32 bits.
+  using Accumulator = std::conditional_t<sizeof(Element) == 1, std::int32_t, std::int64_t>;
+  static constexpr int precision_bits = 22;
+
+  static constexpr Accumulator initial_value() noexcept
+  {
+    return Accumulator{1} << (precision_bits - 1);  // for rounding
+  }
+
+  static Weight to_weight(double w) noexcept
+  {
+    return static_cast<Weight>(std::lround(w * static_cast<double>(std::int32_t{1} << precision_bits)));
+  }
+
+  static Element to_element(Accumulator value) noexcept
+  {
+    constexpr auto lowest = static_cast<Accumulator>(std::numeric_limits<Element>::lowest());
+    constexpr auto highest = static_cast<Accumulator>(std::numeric_limits<Element>::max());
+    // Arithmetic (i.e. flooring) shift for negative values, which can only occur with negative filter lobes.
+    const auto v = value >> precision_bits;
+    return static_cast<Element>(std::max(lowest, std::min(v, highest)));
+  }
+};
+
+template <typename Arithmetic>
+ResampleCoefficients<typename Arithmetic::Weight> quantize_coefficients(const ResampleCoefficients<double>& src)
+{
+  ResampleCoefficients<typename Arithmetic::Weight> dst;
+  dst.first = src.first;
+  dst.nr_taps = src.nr_taps;
+  dst.max_taps = src.max_taps;
+  dst.weights.resize(src.weights.size());
+  std::transform(src.weights.cbegin(), src.weights.cend(), dst.weights.begin(),
+                 [](double w) { return Arithmetic::to_weight(w); });
+  return dst;
+}
+
+template <ImageInterpolationMode interpolation_mode, typename Arithmetic>
+ResampleCoefficients<typename Arithmetic::Weight> make_resample_coefficients(PixelLength src_length,
+                                                                             PixelLength dst_length)
+{
+  using IsArea = std::integral_constant<bool, interpolation_mode == ImageInterpolationMode::Area>;
+  const auto coeffs = compute_resample_coefficients<interpolation_mode>(
+      static_cast<std::ptrdiff_t>(src_length), static_cast<std::ptrdiff_t>(dst_length), IsArea{});
+  return quantize_coefficients<Arithmetic>(coeffs);
+}
+
+// Horizontal pass: resamples the rows [y_begin, y_end) of img_src to the width of img_dst.
+template <typename Arithmetic, typename PixelType>
+void resample_horizontal_rows(const Image<PixelType>& img_src,
+                              Image<PixelType>& img_dst,
+                              const ResampleCoefficients<typename Arithmetic::Weight>& coeffs,
+                              PixelIndex y_begin,
+                              PixelIndex y_end)
+{
+  using Element = typename PixelTraits<PixelType>::Element;
+  using Accumulator = typename Arithmetic::Accumulator;
+  constexpr auto nr_channels = PixelTraits<PixelType>::nr_channels;
+  const auto dst_width = static_cast<std::size_t>(img_dst.width());
+
+  for (auto y = y_begin; y < y_end; ++y)
+  {
+    const auto src = reinterpret_cast<const Element*>(img_src.data(y));
+    const auto dst = reinterpret_cast<Element*>(img_dst.data(y));
+
+    for (std::size_t x = 0; x < dst_width; ++x)
+    {
+      const auto src_x = src + coeffs.first[x] * static_cast<std::ptrdiff_t>(nr_channels);
+      const auto weights = coeffs.weights_for(x);
+      const auto nr_taps = coeffs.nr_taps[x];
+
+      for (std::size_t c = 0; c < nr_channels; ++c)  // nr_channels is known at compile-time
+      {
+        auto sum = Arithmetic::initial_value();
+        for (std::ptrdiff_t k = 0; k < nr_taps; ++k)
+        {
+          sum += static_cast<Accumulator>(weights[k]) * static_cast<Accumulator>(src_x[k * nr_channels + c]);
+        }
+        dst[x * nr_channels + c] = Arithmetic::to_element(sum);
+      }
+    }
+  }
+}
+
+// Vertical pass: computes the rows [y_begin, y_end) of img_dst from the rows of img_src (of equal width).
+template <typename Arithmetic, typename PixelType>
+void resample_vertical_rows(const Image<PixelType>& img_src,
+                            Image<PixelType>& img_dst,
+                            const ResampleCoefficients<typename Arithmetic::Weight>& coeffs,
+                            PixelIndex y_begin,
+                            PixelIndex y_end)
+{
+  using Element = typename PixelTraits<PixelType>::Element;
+  using Accumulator = typename Arithmetic::Accumulator;
+  constexpr auto nr_channels = PixelTraits<PixelType>::nr_channels;
+  const auto row_elements = static_cast<std::size_t>(img_dst.width()) * nr_channels;
+
+  std::vector<Accumulator> sums(row_elements);
+
+  for (auto y = y_begin; y < y_end; ++y)
+  {
+    const auto weights = coeffs.weights_for(static_cast<std::size_t>(y));
+    const auto first = coeffs.first[static_cast<std::size_t>(y)];
+    const auto nr_taps = coeffs.nr_taps[static_cast<std::size_t>(y)];
+
+    // Accumulate row by row, which keeps memory access contiguous.
+    std::fill(sums.begin(), sums.end(), Arithmetic::initial_value());
+    for (std::ptrdiff_t k = 0; k < nr_taps; ++k)
+    {
+      const auto src = reinterpret_cast<const Element*>(img_src.data(to_pixel_index(first + k)));
+      const auto w = static_cast<Accumulator>(weights[k]);
+      for (std::size_t i = 0; i < row_elements; ++i)
+      {
+        sums[i] += w * static_cast<Accumulator>(src[i]);
+      }
+    }
+
+    const auto dst = reinterpret_cast<Element*>(img_dst.data(y));
+    std::transform(sums.cbegin(), sums.cend(), dst, [](Accumulator v) { return Arithmetic::to_element(v); });
+  }
+}
+
+/** \brief Resamples an image using a separable filter (area, bicubic, or Lanczos), in two passes.
+ *
+ * Weight tables are computed once per call, for all destination columns and rows. By default, the horizontal pass is
+ * applied first (into an intermediate image of size new_width x src_height), followed by the vertical pass. Passes
+ * along dimensions that do not change size are skipped.
+ *
+ * @param executor Function object with signature `void executor(PixelLength height, Func func)`, which needs to invoke
+ * `func(y_begin, y_end)` on row ranges covering [0, height).
+ * @param vertical_first If true, the vertical pass is applied first (into an intermediate image of size src_width x
+ * new_height). This reproduces the intermediate rounding of resampling the transposed image.
+ */
+template <ImageInterpolationMode interpolation_mode, typename PixelType, typename RowRangeExecutor>
+void resample_separable(const Image<PixelType>& img_src,
+                        Image<PixelType>& img_dst,
+                        RowRangeExecutor executor,
+                        bool vertical_first = false)
+{
+  using Element = typename PixelTraits<PixelType>::Element;
+  using Arithmetic = ResampleArithmetic<Element>;
+
+  const auto src_width = img_src.width();
+  const auto src_height = img_src.height();
+  const auto dst_width = img_dst.width();
+  const auto dst_height = img_dst.height();
+
+  if (src_width == 0 || src_height == 0 || dst_width == 0 || dst_height == 0)
+  {
+    return;
+  }
+
+  const bool resample_x = (src_width != dst_width);
+  const bool resample_y = (src_height != dst_height);
+
+  if (!resample_x && !resample_y)
+  {
+    executor(dst_height, [&](PixelIndex y_begin, PixelIndex y_end) {
+      for (auto y = y_begin; y < y_end; ++y)
+      {
+        std::copy(img_src.data(y), img_src.data_row_end(y), img_dst.data(y));
+      }
+    });
+    return;
+  }
+
+  const auto horizontal_pass = [&](const Image<PixelType>& img_in, Image<PixelType>& img_out) {
+    const auto coeffs_x = make_resample_coefficients<interpolation_mode, Arithmetic>(src_width, dst_width);
+    img_out.maybe_allocate(dst_width, img_in.height());
+    executor(img_in.height(), [&](PixelIndex y_begin, PixelIndex y_end) {
+      resample_horizontal_rows<Arithmetic>(img_in, img_out, coeffs_x, y_begin, y_end);
+    });
+  };
+
+  const auto vertical_pass = [&](const Image<PixelType>& img_in, Image<PixelType>& img_out) {
+    const auto coeffs_y = make_resample_coefficients<interpolation_mode, Arithmetic>(src_height, dst_height);
+    img_out.maybe_allocate(img_in.width(), dst_height);
+    executor(dst_height, [&](PixelIndex y_begin, PixelIndex y_end) {
+      resample_vertical_rows<Arithmetic>(img_in, img_out, coeffs_y, y_begin, y_end);
+    });
+  };
+
+  if (!resample_y)
+  {
+    horizontal_pass(img_src, img_dst);
+    return;
+  }
+
+  if (!resample_x)
+  {
+    vertical_pass(img_src, img_dst);
+    return;
+  }
+
+  Image<PixelType> img_tmp;
+  if (vertical_first)
+  {
+    vertical_pass(img_src, img_tmp);
+    horizontal_pass(img_tmp, img_dst);
+  }
+  else
+  {
+    horizontal_pass(img_src, img_tmp);
+    vertical_pass(img_tmp, img_dst);
+  }
+}
+
+}  // namespace detail
+
+/// \endcond
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_DETAIL_SEPARABLE_RESAMPLE_HPP
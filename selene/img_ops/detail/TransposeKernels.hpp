@@ -0,0 +1,403 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IMG_OPS_DETAIL_TRANSPOSE_KERNELS_HPP
+#define SELENE_IMG_OPS_DETAIL_TRANSPOSE_KERNELS_HPP
+
+/// @file
+
+#include <selene/base/SIMD.hpp>
+
+#include <selene/img/Image.hpp>
+#include <selene/img/PixelTraits.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace sln {
+
+/// \cond INTERNAL
+
+namespace detail {
+
+// Block transpose kernels transpose a square block of `block_size` x `block_size` pixels in registers.
+// Input is given as `block_size` pointers to the first byte of each (contiguous) source block row; output is given as
+// `block_size` pointers to the first byte of each destination block row, where destination row k receives source
+// block column k. Flipping is achieved by the caller, by passing the row pointers in reversed order.
+// Kernels are selected by the number of bytes per pixel; a `block_size` of 0 means that no kernel is available.
+
+template <std::size_t nr_bytes, typename = void>
+struct TransposeBlockKernel
+{
+  static constexpr std::ptrdiff_t block_size = 0;
+
+  static void apply(const std::uint8_t* const*, std::uint8_t* const*) noexcept
+  {
+  }
+};
+
+#if defined(SELENE_SIMD_SSE2)
+
+// Transposes 8x8 bytes, given as the lower 64 bits of each of `r[0]` to `r[7]`. On return, `r[0]` to `r[3]` contain
+// the output rows (2k, 2k + 1) in their lower and upper 64 bits, respectively.
+inline void transpose_8x8_u8(__m128i* r) noexcept
+{
+  const auto b0 = _mm_unpacklo_epi8(r[0], r[1]);
+  const auto b1 = _mm_unpacklo_epi8(r[2], r[3]);
+  const auto b2 = _mm_unpacklo_epi8(r[4], r[5]);
+  const auto b3 = _mm_unpacklo_epi8(r[6], r[7]);
+  const auto c0 = _mm_unpacklo_epi16(b0, b1);  // columns 0-3, rows 0-3
+  const auto c1 = _mm_unpackhi_epi16(b0, b1);  // columns 4-7, rows 0-3
+  const auto c2 = _mm_unpacklo_epi16(b2, b3);  // columns 0-3, rows 4-7
+  const auto c3 = _mm_unpackhi_epi16(b2, b3);  // columns 4-7, rows 4-7
+  r[0] = _mm_unpacklo_epi32(c0, c2);  // columns 0, 1
+  r[1] = _mm_unpackhi_epi32(c0, c2);  // columns 2, 3
+  r[2] = _mm_unpacklo_epi32(c1, c3);  // columns 4, 5
+  r[3] = _mm_unpackhi_epi32(c1, c3);  // columns 6, 7
+}
+
+// Transposes 4x4 32-bit values.
+inline void transpose_4x4_u32(__m128i& r0, __m128i& r1, __m128i& r2, __m128i& r3) noexcept
+{
+  const auto t0 = _mm_unpacklo_epi32(r0, r1);
+  const auto t1 = _mm_unpacklo_epi32(r2, r3);
+  const auto t2 = _mm_unpackhi_epi32(r0, r1);
+  const auto t3 = _mm_unpackhi_epi32(r2, r3);
+  r0 = _mm_unpacklo_epi64(t0, t1);
+  r1 = _mm_unpackhi_epi64(t0, t1);
+  r2 = _mm_unpacklo_epi64(t2, t3);
+  r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+template <>
+struct TransposeBlockKernel<1>
+{
+  static constexpr std::ptrdiff_t block_size = 8;
+
+  static void apply(const std::uint8_t* const* src_rows, std::uint8_t* const* dst_rows) noexcept
+  {
+    __m128i r[8];
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+      r[i] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src_rows[i]));
+    }
+
+    transpose_8x8_u8(r);
+
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_rows[2 * i]), r[i]);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_rows[2 * i + 1]), _mm_unpackhi_epi64(r[i], r[i]));
+    }
+  }
+};
+
+template <>
+struct TransposeBlockKernel<4>
+{
+  static constexpr std::ptrdiff_t block_size = 4;
+
+  static void apply(const std::uint8_t* const* src_rows, std::uint8_t* const* dst_rows) noexcept
+  {
+    auto r0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_rows[0]));
+    auto r1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_rows[1]));
+    auto r2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_rows[2]));
+    auto r3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_rows[3]));
+
+    transpose_4x4_u32(r0, r1, r2, r3);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_rows[0]), r0);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_rows[1]), r1);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_rows[2]), r2);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_rows[3]), r3);
+  }
+};
+
+#if defined(SELENE_SIMD_SSSE3)
+
+// 3-byte pixels are expanded to 4 bytes (using a byte shuffle), transposed as 32-bit values, and compressed again.
+// Loads and stores are exactly 12 bytes wide, so that nothing outside of the block is accessed.
+template <>
+struct TransposeBlockKernel<3>
+{
+  static constexpr std::ptrdiff_t block_size = 4;
+
+  static __m128i load_12_bytes(const std::uint8_t* ptr) noexcept
+  {
+    std::int32_t tail;
+    std::memcpy(&tail, ptr + 8, sizeof(tail));
+    return _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr)), _mm_cvtsi32_si128(tail));
+  }
+
+  static void store_12_bytes(std::uint8_t* ptr, __m128i v) noexcept
+  {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(ptr), v);
+    const std::int32_t tail = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+    std::memcpy(ptr + 8, &tail, sizeof(tail));
+  }
+
+  static void apply(const std::uint8_t* const* src_rows, std::uint8_t* const* dst_rows) noexcept
+  {
+    const auto expand = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const auto compress = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    auto r0 = _mm_shuffle_epi8(load_12_bytes(src_rows[0]), expand);
+    auto r1 = _mm_shuffle_epi8(load_12_bytes(src_rows[1]), expand);
+    auto r2 = _mm_shuffle_epi8(load_12_bytes(src_rows[2]), expand);
+    auto r3 = _mm_shuffle_epi8(load_12_bytes(src_rows[3]), expand);
+
+    transpose_4x4_u32(r0, r1, r2, r3);
+
+    store_12_bytes(dst_rows[0], _mm_shuffle_epi8(r0, compress));
+    store_12_bytes(dst_rows[1], _mm_shuffle_epi8(r1, compress));
+    store_12_bytes(dst_rows[2], _mm_shuffle_epi8(r2, compress));
+    store_12_bytes(dst_rows[3], _mm_shuffle_epi8(r3, compress));
+  }
+};
+
+#endif  // defined(SELENE_SIMD_SSSE3)
+
+#elif defined(SELENE_SIMD_NEON)
+
+// Transposes 8x8 bytes in-place.
+inline void transpose_8x8_u8(uint8x8_t* r) noexcept
+{
+  const auto t01 = vtrn_u8(r[0], r[1]);
+  const auto t23 = vtrn_u8(r[2], r[3]);
+  const auto t45 = vtrn_u8(r[4], r[5]);
+  const auto t67 = vtrn_u8(r[6], r[7]);
+
+  const auto u02 = vtrn_u16(vreinterpret_u16_u8(t01.val[0]), vreinterpret_u16_u8(t23.val[0]));
+  const auto u13 = vtrn_u16(vreinterpret_u16_u8(t01.val[1]), vreinterpret_u16_u8(t23.val[1]));
+  const auto u46 = vtrn_u16(vreinterpret_u16_u8(t45.val[0]), vreinterpret_u16_u8(t67.val[0]));
+  const auto u57 = vtrn_u16(vreinterpret_u16_u8(t45.val[1]), vreinterpret_u16_u8(t67.val[1]));
+
+  const auto v04 = vtrn_u32(vreinterpret_u32_u16(u02.val[0]), vreinterpret_u32_u16(u46.val[0]));
+  const auto v15 = vtrn_u32(vreinterpret_u32_u16(u13.val[0]), vreinterpret_u32_u16(u57.val[0]));
+  const auto v26 = vtrn_u32(vreinterpret_u32_u16(u02.val[1]), vreinterpret_u32_u16(u46.val[1]));
+  const auto v37 = vtrn_u32(vreinterpret_u32_u16(u13.val[1]), vreinterpret_u32_u16(u57.val[1]));
+
+  r[0] = vreinterpret_u8_u32(v04.val[0]);
+  r[1] = vreinterpret_u8_u32(v15.val[0]);
+  r[2] = vreinterpret_u8_u32(v26.val[0]);
+  r[3] = vreinterpret_u8_u32(v37.val[0]);
+  r[4] = vreinterpret_u8_u32(v04.val[1]);
+  r[5] = vreinterpret_u8_u32(v15.val[1]);
+  r[6] = vreinterpret_u8_u32(v26.val[1]);
+  r[7] = vreinterpret_u8_u32(v37.val[1]);
+}
+
+template <>
+struct TransposeBlockKernel<1>
+{
+  static constexpr std::ptrdiff_t block_size = 8;
+
+  static void apply(const std::uint8_t* const* src_rows, std::uint8_t* const* dst_rows) noexcept
+  {
+    uint8x8_t r[8];
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+      r[i] = vld1_u8(src_rows[i]);
+    }
+
+    transpose_8x8_u8(r);
+
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+      vst1_u8(dst_rows[i], r[i]);
+    }
+  }
+};
+
+// 3-byte pixels are de-interleaved into three planes on load, and re-interleaved on store.
+template <>
+struct TransposeBlockKernel<3>
+{
+  static constexpr std::ptrdiff_t block_size = 8;
+
+  static void apply(const std::uint8_t* const* src_rows, std::uint8_t* const* dst_rows) noexcept
+  {
+    uint8x8_t planes[3][8];
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+      const auto v = vld3_u8(src_rows[i]);
+      planes[0][i] = v.val[0];
+      planes[1][i] = v.val[1];
+      planes[2][i] = v.val[2];
+    }
+
+    transpose_8x8_u8(planes[0]);
+    transpose_8x8_u8(planes[1]);
+    transpose_8x8_u8(planes[2]);
+
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+      uint8x8x3_t v;
+      v.val[0] = planes[0][i];
+      v.val[1] = planes[1][i];
+      v.val[2] = planes[2][i];
+      vst3_u8(dst_rows[i], v);
+    }
+  }
+};
+
+template <>
+struct TransposeBlockKernel<4>
+{
+  static constexpr std::ptrdiff_t block_size = 4;
+
+  static void apply(const std::uint8_t* const* src_rows, std::uint8_t* const* dst_rows) noexcept
+  {
+    const auto r0 = vld1q_u32(reinterpret_cast<const std::uint32_t*>(src_rows[0]));
+    const auto r1 = vld1q_u32(reinterpret_cast<const std::uint32_t*>(src_rows[1]));
+    const auto r2 = vld1q_u32(reinterpret_cast<const std::uint32_t*>(src_rows[2]));
+    const auto r3 = vld1q_u32(reinterpret_cast<const std::uint32_t*>(src_rows[3]));
+
+    const auto t01 = vtrnq_u32(r0, r1);
+    const auto t23 = vtrnq_u32(r2, r3);
+
+    vst1q_u32(reinterpret_cast<std::uint32_t*>(dst_rows[0]),
+              vcombine_u32(vget_low_u32(t01.val[0]), vget_low_u32(t23.val[0])));
+    vst1q_u32(reinterpret_cast<std::uint32_t*>(dst_rows[1]),
+              vcombine_u32(vget_low_u32(t01.val[1]), vget_low_u32(t23.val[1])));
+    vst1q_u32(reinterpret_cast<std::uint32_t*>(dst_rows[2]),
+              vcombine_u32(vget_high_u32(t01.val[0]), vget_high_u32(t23.val[0])));
+    vst1q_u32(reinterpret_cast<std::uint32_t*>(dst_rows[3]),
+              vcombine_u32(vget_high_u32(t01.val[1]), vget_high_u32(t23.val[1])));
+  }
+};
+
+#endif  // defined(SELENE_SIMD_SSE2) / defined(SELENE_SIMD_NEON)
+
+template <typename PixelType>
+using TransposeBlockKernelFor = std::conditional_t<sizeof(PixelType) == PixelTraits<PixelType>::nr_bytes
+                                                       && std::is_trivially_copyable<PixelType>::value,
+                                                   TransposeBlockKernel<sizeof(PixelType)>,
+                                                   TransposeBlockKernel<0>>;
+
+/// Side length (in pixels) of the square tiles processed by `transpose_tile`; both the source and the target tile of
+/// 4-byte pixels then fit into 8 KiB of L1 cache.
+constexpr std::ptrdiff_t transpose_tile_size = 32;
+
+// Transposes the destination pixels in [x_begin, x_end) x [y, y + 1) one by one.
+template <bool flip_h, bool flip_v, typename PixelType>
+void transpose_row_segment(const Image<PixelType>& img_src,
+                           Image<PixelType>& img_dst,
+                           std::ptrdiff_t x_begin,
+                           std::ptrdiff_t x_end,
+                           std::ptrdiff_t y)
+{
+  const auto src_x = flip_v ? std::ptrdiff_t{img_src.width()} - 1 - y : y;
+  auto dst_ptr = img_dst.data(PixelIndex(y));
+  for (auto x = x_begin; x < x_end; ++x)
+  {
+    const auto src_y = flip_h ? std::ptrdiff_t{img_src.height()} - 1 - x : x;
+    dst_ptr[x] = img_src.data(PixelIndex(src_y))[src_x];
+  }
+}
+
+// Transposes as many full blocks as possible using the block kernel, plus the remaining pixels to their right.
+// Returns the first destination row that has not been processed.
+template <bool flip_h, bool flip_v, typename PixelType>
+std::ptrdiff_t transpose_tile_blocks(const Image<PixelType>& img_src,
+                                     Image<PixelType>& img_dst,
+                                     std::ptrdiff_t x_begin,
+                                     std::ptrdiff_t x_end,
+                                     std::ptrdiff_t y_begin,
+                                     std::ptrdiff_t y_end,
+                                     std::true_type /* has_kernel */)
+{
+  using Kernel = TransposeBlockKernelFor<PixelType>;
+  constexpr auto block_size = Kernel::block_size;
+  constexpr auto block_bytes = block_size * static_cast<std::ptrdiff_t>(sizeof(PixelType));
+
+  const auto x_blocks_end = x_begin + (x_end - x_begin) / block_size * block_size;
+  const auto y_blocks_end = y_begin + (y_end - y_begin) / block_size * block_size;
+
+  std::array<const std::uint8_t*, block_size> src_rows;
+  std::array<std::uint8_t*, block_size> dst_rows;
+
+  for (auto y = y_begin; y < y_blocks_end; y += block_size)
+  {
+    // Source block columns are read in ascending order; with a vertical flip, they end up in descending row order.
+    const auto src_x = flip_v ? std::ptrdiff_t{img_src.width()} - y - block_size : y;
+    for (std::ptrdiff_t k = 0; k < block_size; ++k)
+    {
+      const auto dst_y = flip_v ? y + block_size - 1 - k : y + k;
+      dst_rows[std::size_t(k)] = reinterpret_cast<std::uint8_t*>(img_dst.data(PixelIndex(dst_y)) + x_begin);
+    }
+
+    for (auto x = x_begin; x < x_blocks_end; x += block_size)
+    {
+      for (std::ptrdiff_t k = 0; k < block_size; ++k)
+      {
+        const auto src_y = flip_h ? std::ptrdiff_t{img_src.height()} - 1 - (x + k) : x + k;
+        src_rows[std::size_t(k)] = reinterpret_cast<const std::uint8_t*>(img_src.data(PixelIndex(src_y)) + src_x);
+      }
+
+      Kernel::apply(src_rows.data(), dst_rows.data());
+
+      for (auto& dst_row : dst_rows)
+      {
+        dst_row += block_bytes;
+      }
+    }
+
+    for (auto k = y; k < y + block_size; ++k)
+    {
+      transpose_row_segment<flip_h, flip_v>(img_src, img_dst, x_blocks_end, x_end, k);
+    }
+  }
+
+  return y_blocks_end;
+}
+
+template <bool flip_h, bool flip_v, typename PixelType>
+std::ptrdiff_t transpose_tile_blocks(const Image<PixelType>&,
+                                     Image<PixelType>&,
+                                     std::ptrdiff_t,
+                                     std::ptrdiff_t,
+                                     std::ptrdiff_t y_begin,
+                                     std::ptrdiff_t,
+                                     std::false_type /* has_kernel */)
+{
+  return y_begin;
+}
+
+/** \brief Transposes one tile of the destination image, i.e. the destination pixels in [x_begin, x_end) x [y_begin,
+ * y_end).
+ *
+ * Destination pixel (x, y) receives source pixel (flip_v ? W - 1 - y : y, flip_h ? H - 1 - x : x), where W and H
+ * are the source image width and height.
+ * Full blocks are transposed by the block kernel, if one is available for the pixel type; remaining pixels are copied
+ * one by one.
+ */
+template <bool flip_h, bool flip_v, typename PixelType>
+void transpose_tile(const Image<PixelType>& img_src,
+                    Image<PixelType>& img_dst,
+                    std::ptrdiff_t x_begin,
+                    std::ptrdiff_t x_end,
+                    std::ptrdiff_t y_begin,
+                    std::ptrdiff_t y_end)
+{
+  using has_kernel = std::integral_constant<bool, (TransposeBlockKernelFor<PixelType>::block_size > 0)>;
+  const auto y_rest = transpose_tile_blocks<flip_h, flip_v>(img_src, img_dst, x_begin, x_end, y_begin, y_end,
+                                                            has_kernel{});
+
+  for (auto y = y_rest; y < y_end; ++y)
+  {
+    transpose_row_segment<flip_h, flip_v>(img_src, img_dst, x_begin, x_end, y);
+  }
+}
+
+}  // namespace detail
+
+/// \endcond
+
+}  // namespace sln
+
+#endif  // SELENE_IMG_OPS_DETAIL_TRANSPOSE_KERNELS_HPP
@@ -0,0 +1,122 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <selene/io/MMapReader.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SELENE_IO_HAVE_MMAP
+#endif
+
+#if defined(SELENE_IO_HAVE_MMAP)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <cstdio>
+#endif
+
+namespace sln {
+
+/** \brief Maps the specified file for reading and sets the read position to the beginning of the file.
+ *
+ * Any already open file will be closed.
+ * The mapped pages are advised for sequential access. Empty files cannot be mapped; the open operation will fail.
+ *
+ * \param filename The name of the file to be read.
+ * \return True, if the file was successfully opened; false otherwise.
+ */
+bool MMapReader::open(const char* filename) noexcept
+{
+  close();
+
+#if defined(SELENE_IO_HAVE_MMAP)
+  const int fd = ::open(filename, O_RDONLY);
+  if (fd < 0)
+  {
+    return false;
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) != 0 || st.st_size <= 0)
+  {
+    ::close(fd);
+    return false;
+  }
+
+  const auto len = static_cast<std::size_t>(st.st_size);
+  void* addr = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);  // the mapping stays valid after closing the descriptor
+
+  if (addr == MAP_FAILED)
+  {
+    return false;
+  }
+
+  ::madvise(addr, len, MADV_SEQUENTIAL);  // purely advisory; failure is not an error
+
+  data_ = static_cast<const std::uint8_t*>(addr);
+  len_ = static_cast<std::ptrdiff_t>(len);
+  ptr_ = data_;
+  return true;
+#else
+  auto fp = std::fopen(filename, "rb");
+  if (fp == nullptr)
+  {
+    return false;
+  }
+
+  bool success = (std::fseek(fp, 0, SEEK_END) == 0);
+  const auto len = success ? std::ftell(fp) : -1;
+  success = success && len > 0 && std::fseek(fp, 0, SEEK_SET) == 0;
+
+  if (success)
+  {
+    try
+    {
+      buffer_.resize(static_cast<std::size_t>(len));
+    }
+    catch (...)
+    {
+      success = false;
+    }
+  }
+
+  success = success && std::fread(buffer_.data(), 1, buffer_.size(), fp) == buffer_.size();
+  std::fclose(fp);
+
+  if (!success)
+  {
+    buffer_ = std::vector<std::uint8_t>();
+    return false;
+  }
+
+  data_ = buffer_.data();
+  len_ = static_cast<std::ptrdiff_t>(buffer_.size());
+  ptr_ = data_;
+  return true;
+#endif
+}
+
+/** \brief Unmaps an open file.
+ *
+ * The function will have no effect, if no file is currently opened.
+ */
+void MMapReader::close() noexcept
+{
+#if defined(SELENE_IO_HAVE_MMAP)
+  if (data_ != nullptr)
+  {
+    ::munmap(const_cast<std::uint8_t*>(data_), static_cast<std::size_t>(len_));
+  }
+#else
+  buffer_ = std::vector<std::uint8_t>();
+#endif
+
+  data_ = nullptr;
+  len_ = 0;
+  ptr_ = nullptr;
+}
+
+}  // namespace sln
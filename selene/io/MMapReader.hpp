@@ -0,0 +1,360 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_IO_MMAP_READER_HPP
+#define SELENE_IO_MMAP_READER_HPP
+
+/// @file
+
+#include <selene/base/Assert.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+
+/** \brief Class for reading binary data from a memory-mapped file.
+ *
+ * Class for reading binary data from a file that is mapped into the address space of the process. Provides the usual
+ * operations for random file access. As much of the interface as possible is equal to the FileReader and MemoryReader
+ * classes. This enables user code to abstract from the particular type of "reader" by means of static polymorphism
+ * (e.g. treating the "reader" type as a template).
+ *
+ * In contrast to FileReader, no data passes through the C standard library's stream buffers; the image decoders are
+ * fed directly from the mapped pages, which are advised for sequential access.
+ * On platforms without POSIX `mmap` support, the file contents are read into an internal buffer instead.
+ */
+class MMapReader
+{
+public:
+  MMapReader() = default;
+  explicit MMapReader(const char* filename);
+  explicit MMapReader(const std::string& filename);
+  ~MMapReader();
+
+  MMapReader(const MMapReader&) = delete;
+  MMapReader& operator=(const MMapReader&) = delete;
+  MMapReader(MMapReader&& other) noexcept;  ///< Move constructor.
+  MMapReader& operator=(MMapReader&& other) noexcept;  ///< Move assignment operator.
+
+  const std::uint8_t* handle() noexcept;
+
+  bool open(const char* filename) noexcept;
+  bool open(const std::string& filename) noexcept;
+  void close() noexcept;
+
+  bool is_open() const noexcept;
+  bool is_eof() const noexcept;
+  std::ptrdiff_t position() const noexcept;
+  std::size_t size() const noexcept;
+  std::ptrdiff_t bytes_remaining() const noexcept;
+
+  void rewind() noexcept;
+  bool seek_abs(std::ptrdiff_t offset) noexcept;
+  bool seek_rel(std::ptrdiff_t offset) noexcept;
+
+  template <typename T, typename = std::enable_if_t<std::is_trivially_copyable<T>::value>>
+  bool read(T& value) noexcept;
+
+  template <typename T, typename = std::enable_if_t<std::is_trivially_copyable<T>::value>>
+  std::size_t read(T* values, std::size_t nr_values) noexcept;
+
+private:
+  const std::uint8_t* data_ = nullptr;
+  std::ptrdiff_t len_ = 0;
+  const std::uint8_t* ptr_ = nullptr;
+  std::vector<std::uint8_t> buffer_;  // only used if memory mapping is not available
+};
+
+template <typename T, typename = std::enable_if_t<std::is_trivially_copyable<T>::value>>
+T read(MMapReader& source);
+
+template <typename T, typename = std::enable_if_t<std::is_trivially_copyable<T>::value>>
+bool read(MMapReader& source, T& value) noexcept;
+
+template <typename T, typename = std::enable_if_t<std::is_trivially_copyable<T>::value>>
+std::size_t read(MMapReader& source, T* values, std::size_t nr_values) noexcept;
+
+// ----------
+// Implementation:
+
+/** \brief Maps the specified file for reading and sets the read position to the beginning of the file.
+ *
+ * If the open operation fails (e.g. if the file does not exist or is empty), the function will throw a
+ * `std::runtime_error` exception. See also MMapReader::open.
+ *
+ * \param filename The name of the file to be read.
+ */
+inline MMapReader::MMapReader(const char* filename)
+{
+  if (!open(filename))
+  {
+    throw std::runtime_error("Cannot map file " + std::string(filename) + " for reading");
+  }
+}
+
+/** \brief Maps the specified file for reading and sets the read position to the beginning of the file.
+ *
+ * If the open operation fails (e.g. if the file does not exist or is empty), the function will throw a
+ * `std::runtime_error` exception. See also MMapReader::open.
+ *
+ * \param filename The name of the file to be read.
+ */
+inline MMapReader::MMapReader(const std::string& filename) : MMapReader(filename.c_str())
+{
+}
+
+/** \brief Destructor; unmaps the file, if one is open.
+ */
+inline MMapReader::~MMapReader()
+{
+  close();
+}
+
+inline MMapReader::MMapReader(MMapReader&& other) noexcept
+    : data_(other.data_), len_(other.len_), ptr_(other.ptr_), buffer_(std::move(other.buffer_))
+{
+  other.data_ = nullptr;
+  other.len_ = 0;
+  other.ptr_ = nullptr;
+}
+
+inline MMapReader& MMapReader::operator=(MMapReader&& other) noexcept
+{
+  if (this == &other)
+  {
+    return *this;
+  }
+
+  close();
+  data_ = other.data_;
+  len_ = other.len_;
+  ptr_ = other.ptr_;
+  buffer_ = std::move(other.buffer_);
+  other.data_ = nullptr;
+  other.len_ = 0;
+  other.ptr_ = nullptr;
+  return *this;
+}
+
+/** \brief Returns a native handle to the mapped file contents.
+ *
+ * \return A pointer to the mapped file contents. The returned handle will point to the current internal read
+ *         position, not to the beginning of the file.
+ *         Will return `nullptr` if no file is currently opened.
+ */
+inline const std::uint8_t* MMapReader::handle() noexcept
+{
+  return ptr_;
+}
+
+/** \brief Maps the specified file for reading and sets the read position to the beginning of the file.
+ *
+ * Any already open file will be closed.
+ *
+ * \param filename The name of the file to be read.
+ * \return True, if the file was successfully opened; false otherwise.
+ */
+inline bool MMapReader::open(const std::string& filename) noexcept
+{
+  return open(filename.c_str());
+}
+
+/** \brief Returns whether a file is open.
+ *
+ * \return True, if a file is open; false otherwise.
+ */
+inline bool MMapReader::is_open() const noexcept
+{
+  return (data_ != nullptr);
+}
+
+/** \brief Returns whether the end of the file has been reached.
+ *
+ * \return True, if the read position is outside of the file contents (or if no file is open); false otherwise.
+ */
+inline bool MMapReader::is_eof() const noexcept
+{
+  if (data_ == nullptr)
+  {
+    return true;
+  }
+
+  return (ptr_ >= data_ + len_ || ptr_ < data_);
+}
+
+/** \brief Returns the current value of the position indicator of the file.
+ *
+ * \return The numeric value of the position indicator, or -1 on failure (also, if no file is open).
+ */
+inline std::ptrdiff_t MMapReader::position() const noexcept
+{
+  if (data_ == nullptr)
+  {
+    return -1;
+  }
+
+  return ptr_ - data_;
+}
+
+/** \brief Returns the total size of the file.
+ *
+ * \return The total size of the file in bytes, irrespective of the current read position.
+ */
+inline std::size_t MMapReader::size() const noexcept
+{
+  return static_cast<std::size_t>(len_);
+}
+
+/** \brief Returns the remaining data size that can still be read.
+ *
+ * \return The size in bytes of the remaining data that can still be read.
+ */
+inline std::ptrdiff_t MMapReader::bytes_remaining() const noexcept
+{
+  return is_eof() ? 0 : (data_ + len_) - ptr_;
+}
+
+/** \brief Resets the current read position to the beginning of the file.
+ *
+ * The function will have no effect if no file is open.
+ */
+inline void MMapReader::rewind() noexcept
+{
+  ptr_ = data_;
+}
+
+/** \brief Performs an absolute seek operation to the specified offset.
+ *
+ * Failure cases include no file being open, or the offset being outside the file.
+ *
+ * \param offset The absolute offset in bytes.
+ * \return True, if the seek operation was successful; false on failure.
+ */
+inline bool MMapReader::seek_abs(std::ptrdiff_t offset) noexcept
+{
+  if (!is_open() || offset < 0 || offset > len_)
+  {
+    return false;
+  }
+
+  ptr_ = data_ + offset;
+  return true;
+}
+
+/** \brief Performs a relative seek operation by the specified offset.
+ *
+ * Failure cases include no file being open, or the resulting position being outside the file.
+ *
+ * \param offset The relative offset in bytes.
+ * \return True, if the seek operation was successful; false on failure.
+ */
+inline bool MMapReader::seek_rel(std::ptrdiff_t offset) noexcept
+{
+  return is_open() && seek_abs(position() + offset);
+}
+
+/** \brief Reads an element of type T and writes the element to the output parameter `value`.
+ *
+ * In generic code, prefer using the corresponding non-member function.
+ *
+ * \tparam T The type of the data element to be read. Needs to be trivially copyable.
+ * \param[out] value An element of type T, if the read operation was successful.
+ * \return True, if read operation was successful, false otherwise.
+ */
+template <typename T, typename>
+inline bool MMapReader::read(T& value) noexcept
+{
+  SELENE_ASSERT(ptr_ != nullptr);
+
+  if (bytes_remaining() < static_cast<std::ptrdiff_t>(sizeof(T)))
+  {
+    ptr_ = data_ + len_;
+    return false;
+  }
+
+  std::memcpy(&value, ptr_, sizeof(T));  // memory access might be unaligned
+  ptr_ += sizeof(T);
+  return true;
+}
+
+/** \brief Reads `nr_values` elements of type T and writes the elements to the output parameter `values`.
+ *
+ * In generic code, prefer using the corresponding non-member function.
+ *
+ * \tparam T The type of the data elements to be read. Needs to be trivially copyable.
+ * \param[out] values A pointer to a memory location where the read elements should be written to.
+ * \param nr_values The number of data elements to read.
+ * \return The number of data elements that were successfully read.
+ */
+template <typename T, typename>
+inline std::size_t MMapReader::read(T* values, std::size_t nr_values) noexcept
+{
+  SELENE_ASSERT(ptr_ != nullptr);
+  const auto nr_values_available = static_cast<std::ptrdiff_t>(bytes_remaining() / sizeof(T));
+  const auto nr_values_read = std::min(nr_values_available, static_cast<std::ptrdiff_t>(nr_values));
+  std::memcpy(values, ptr_, static_cast<std::size_t>(nr_values_read) * sizeof(T));
+  ptr_ += static_cast<std::size_t>(nr_values_read) * sizeof(T);
+  return static_cast<std::size_t>(nr_values_read);
+}
+
+// ----------
+
+/** \brief Reads an element of type T from `source` and returns the element.
+ *
+ * The function does not perform an explicit check (beyond a debug-mode assertion) whether the requested element was
+ * actually read. If the read operation failed, then the returned result is undefined.
+ *
+ * \tparam T The type of the data element to be read. Needs to be trivially copyable.
+ * \param source The source MMapReader instance.
+ * \return An element of type T, if the read operation was successful.
+ */
+template <typename T, typename>
+T read(MMapReader& source)
+{
+  T value{};
+#ifndef NDEBUG  // TODO: replace with [[maybe_unused]] (C++17)
+  bool read =
+#endif
+      source.read(value);
+  SELENE_ASSERT(read);
+  return value;
+}
+
+/** \brief Reads an element of type T from `source` and writes the element to the output parameter `value`.
+ *
+ * \tparam T The type of the data element to be read. Needs to be trivially copyable.
+ * \param source The source MMapReader instance.
+ * \param[out] value An element of type T, if the read operation was successful.
+ * \return True, if read operation was successful, false otherwise.
+ */
+template <typename T, typename>
+inline bool read(MMapReader& source, T& value) noexcept
+{
+  return source.read(value);
+}
+
+/** \brief Reads `nr_values` elements of type T from `source` and writes the elements to the output parameter `values`.
+ *
+ * \tparam T The type of the data elements to be read. Needs to be trivially copyable.
+ * \param source The source MMapReader instance.
+ * \param[out] values A pointer to a memory location where the read elements should be written to.
+ * \param nr_values The number of data elements to read.
+ * \return The number of data elements that were successfully read.
+ */
+template <typename T, typename>
+inline std::size_t read(MMapReader& source, T* values, std::size_t nr_values) noexcept
+{
+  return source.read(values, nr_values);
+}
+
+}  // namespace sln
+
+#endif  // SELENE_IO_MMAP_READER_HPP
@@ -0,0 +1,256 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_THREAD_PARALLEL_HPP
+#define SELENE_THREAD_PARALLEL_HPP
+
+/// @file
+
+#include <selene/base/Assert.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sln {
+
+template <typename Index, typename Func>
+void parallel_for(ThreadPool& thread_pool, Index begin, Index end, Index grain, Func func);
+
+template <typename Index, typename T, typename MapFunc, typename ReduceFunc>
+T parallel_reduce(ThreadPool& thread_pool,
+                  Index begin,
+                  Index end,
+                  Index grain,
+                  T identity,
+                  MapFunc map_func,
+                  ReduceFunc reduce_func);
+
+// ----------
+// Implementation:
+
+/// \cond INTERNAL
+
+namespace detail {
+
+// State shared between the calling thread and the helper tasks of one parallel_for invocation.
+// It is reference counted, since helper tasks may only start running after all blocks have been processed (e.g. if the
+// pool is busy); such helpers then find no remaining blocks, and return without touching any caller-owned data.
+class ParallelForState
+{
+public:
+  explicit ParallelForState(std::size_t nr_blocks)
+      : nr_blocks_(nr_blocks), next_block_(0), nr_finished_blocks_(0), cancelled_(false)
+  {
+  }
+
+  template <typename BlockFunc>
+  void process(BlockFunc& block_func)
+  {
+    std::size_t nr_processed = 0;
+
+    for (auto block = next_block_.fetch_add(1); block < nr_blocks_; block = next_block_.fetch_add(1))
+    {
+      // After an exception, the remaining blocks are still claimed (and counted), but not executed.
+      if (!cancelled_.load(std::memory_order_relaxed))
+      {
+        try
+        {
+          block_func(block);
+        }
+        catch (...)
+        {
+          set_exception(std::current_exception());
+        }
+      }
+
+      ++nr_processed;
+    }
+
+    mark_finished(nr_processed);
+  }
+
+  void wait_and_rethrow()
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      cond_.wait(lock, [this] { return nr_finished_blocks_.load() >= nr_blocks_; });
+    }
+
+    if (exception_)
+    {
+      std::rethrow_exception(exception_);
+    }
+  }
+
+private:
+  const std::size_t nr_blocks_;
+  std::atomic<std::size_t> next_block_;
+  std::atomic<std::size_t> nr_finished_blocks_;
+  std::atomic<bool> cancelled_;
+  std::exception_ptr exception_;
+  std::mutex mutex_;
+  std::condition_variable cond_;
+
+  void set_exception(std::exception_ptr exception)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!exception_)
+    {
+      exception_ = exception;
+    }
+    cancelled_.store(true, std::memory_order_relaxed);
+  }
+
+  void mark_finished(std::size_t nr_processed)
+  {
+    if (nr_processed > 0 && nr_finished_blocks_.fetch_add(nr_processed) + nr_processed == nr_blocks_)
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      cond_.notify_all();
+    }
+  }
+};
+
+}  // namespace detail
+
+/// \endcond
+
+/** \brief Invokes a function on a block-partitioned index range, in parallel on a thread pool.
+ *
+ * The range [begin, end) is split into contiguous blocks of `grain` elements each (the last block may be shorter),
+ * and `func(block_begin, block_end)` is invoked once for each block.
+ * Blocks are distributed dynamically: the calling thread, as well as (at most) one helper task per pool thread,
+ * repeatedly claim the next unprocessed block. In contrast to `ThreadPool::push`, no `std::future` is created per block.
+ *
+ * The function returns after all blocks have been processed. Since the calling thread takes part in the work, it is
+ * safe to call this function from within a task running on the same thread pool.
+ * If any invocation of `func` throws, blocks that have not yet been started are skipped, and the first exception is
+ * rethrown after all running invocations have finished.
+ *
+ * @tparam Index An integral index type.
+ * @tparam Func The function type. Its signature should be `void f(Index block_begin, Index block_end)`.
+ * @param thread_pool The thread pool to use for parallel execution.
+ * @param begin The beginning of the index range.
+ * @param end The end of the index range (exclusive).
+ * @param grain The number of elements per block. Needs to be greater than 0.
+ * @param func The function to be invoked for each block.
+ */
+template <typename Index, typename Func>
+void parallel_for(ThreadPool& thread_pool, Index begin, Index end, Index grain, Func func)
+{
+  static_assert(std::is_integral<Index>::value, "Index type needs to be integral");
+  SELENE_ASSERT(grain > 0);
+
+  if (end <= begin)
+  {
+    return;
+  }
+
+  const auto nr_elements = static_cast<std::size_t>(end - begin);
+  const auto block_size = static_cast<std::size_t>(grain);
+  const auto nr_blocks = (nr_elements + block_size - 1) / block_size;
+
+  auto block_func = [begin, end, block_size, &func](std::size_t block) {
+    const auto block_begin = static_cast<Index>(begin + static_cast<Index>(block * block_size));
+    const auto block_end = static_cast<Index>(std::min(end, static_cast<Index>(block_begin + block_size)));
+    func(block_begin, block_end);
+  };
+
+  if (nr_blocks == 1)
+  {
+    block_func(0);
+    return;
+  }
+
+  const auto state = std::make_shared<detail::ParallelForState>(nr_blocks);
+  const auto nr_helpers = std::min(thread_pool.size(), nr_blocks - 1);
+
+  for (std::size_t i = 0; i < nr_helpers; ++i)
+  {
+    // The returned future is intentionally discarded; completion is tracked by the shared state.
+    thread_pool.push([state, &block_func]() { state->process(block_func); });
+  }
+
+  state->process(block_func);
+  state->wait_and_rethrow();
+}
+
+/** \brief Computes a reduction over a block-partitioned index range, in parallel on a thread pool.
+ *
+ * The range [begin, end) is split into blocks as described for `parallel_for`. For each block, a partial result is
+ * computed as `map_func(block_begin, block_end)`. All partial results are then combined, in block order, on the calling
+ * thread: `reduce_func(...reduce_func(reduce_func(identity, r_0), r_1)..., r_{n-1})`.
+ * The result is therefore deterministic, even for non-associative operations (such as floating point addition), given
+ * a fixed `grain`.
+ *
+ * @tparam Index An integral index type.
+ * @tparam T The result type.
+ * @tparam MapFunc The block function type. Its signature should be `T f(Index block_begin, Index block_end)`.
+ * @tparam ReduceFunc The reduction function type. Its signature should be `T f(T a, T b)`.
+ * @param thread_pool The thread pool to use for parallel execution.
+ * @param begin The beginning of the index range.
+ * @param end The end of the index range (exclusive).
+ * @param grain The number of elements per block. Needs to be greater than 0.
+ * @param identity The identity element of the reduction; returned for an empty range.
+ * @param map_func The function computing the partial result for each block.
+ * @param reduce_func The function combining two results.
+ * @return The reduced result.
+ */
+template <typename Index, typename T, typename MapFunc, typename ReduceFunc>
+T parallel_reduce(ThreadPool& thread_pool,
+                  Index begin,
+                  Index end,
+                  Index grain,
+                  T identity,
+                  MapFunc map_func,
+                  ReduceFunc reduce_func)
+{
+  static_assert(std::is_integral<Index>::value, "Index type needs to be integral");
+  SELENE_ASSERT(grain > 0);
+
+  if (end <= begin)
+  {
+    return identity;
+  }
+
+  const auto nr_elements = static_cast<std::size_t>(end - begin);
+  const auto block_size = static_cast<std::size_t>(grain);
+  const auto nr_blocks = (nr_elements + block_size - 1) / block_size;
+
+  // Wrapped, s.t. each element is a separate memory location (also for T = bool).
+  struct PartialResult
+  {
+    T value;
+  };
+
+  std::vector<PartialResult> partial_results(nr_blocks, PartialResult{identity});
+
+  parallel_for(thread_pool, begin, end, grain, [begin, block_size, &partial_results, &map_func](Index block_begin,
+                                                                                                 Index block_end) {
+    const auto block = static_cast<std::size_t>(block_begin - begin) / block_size;
+    partial_results[block].value = map_func(block_begin, block_end);
+  });
+
+  auto result = std::move(identity);
+  for (auto& partial_result : partial_results)
+  {
+    result = reduce_func(std::move(result), std::move(partial_result.value));
+  }
+
+  return result;
+}
+
+}  // namespace sln
+
+#endif  // SELENE_THREAD_PARALLEL_HPP
@@ -15,11 +15,15 @@
 #include <future>
 #include <memory>
 #include <mutex>
+#include <random>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include <selene/base/Assert.hpp>
+#include <selene/base/Numa.hpp>
 #include <selene/thread/detail/TaskQueue.hpp>
+#include <selene/thread/detail/WorkStealingDeque.hpp>
 
 namespace sln {
 
@@ -29,15 +33,41 @@ namespace sln {
 // and
 // "C++ Concurrency in Action", first edition, listing 9.2
 
+/** \brief Describes the task scheduling strategy of a `ThreadPool`. */
+enum class ThreadPoolScheduler
+{
+  WorkStealing,  ///< Lock-free work-stealing deque per thread; idle threads steal from randomly chosen threads.
+  MultiQueue,  ///< Mutex-protected task queue per thread; tasks are distributed in round-robin fashion.
+};
+
+/** \brief Describes how the threads of a `ThreadPool` are pinned to CPUs. */
+enum class ThreadPinning
+{
+  None,  ///< Threads are not pinned, and may be moved between CPUs by the operating system.
+  Cores,  ///< Each thread is pinned to one CPU; threads are assigned to the available CPUs in round-robin fashion.
+  NumaNodes,  ///< Threads are assigned to NUMA nodes in round-robin fashion, and pinned to the CPUs of their node.
+};
+
 /** \brief Simple thread pool, to enable task (function) based parallelism.
  *
- * Starts a user-defined number of threads and contains a task queue, to which function invocations can be pushed.
- * These "callables" are then taken from the queue and processed in parallel on the running pool threads.
+ * Starts a user-defined number of threads and contains task queues, to which function invocations can be pushed.
+ * These "callables" are then taken from the queues and processed in parallel on the running pool threads.
+ *
+ * By default, tasks are scheduled using work-stealing (`ThreadPoolScheduler::WorkStealing`): tasks pushed from within
+ * a task running on the pool are put onto the executing thread's own lock-free deque, and are preferably processed by
+ * the same thread, in LIFO order. Tasks pushed from other threads are put onto a shared queue. Idle threads first take
+ * from the shared queue, and then steal (in FIFO order) from other threads' deques, starting at a random victim.
+ *
+ * Optionally, the threads can be pinned to CPUs or NUMA nodes (see `ThreadPinning`). On multi-socket systems, pinning
+ * to NUMA nodes keeps the memory accesses of each thread local to its node, e.g. when scratch images are allocated
+ * from a `MappedMemoryResource` with `local_numa_node`.
  */
 class ThreadPool
 {
 public:
-  explicit ThreadPool(std::size_t num_threads);
+  explicit ThreadPool(std::size_t num_threads,
+                      ThreadPoolScheduler scheduler = ThreadPoolScheduler::WorkStealing,
+                      ThreadPinning pinning = ThreadPinning::None);
   ~ThreadPool();
 
   ThreadPool(const ThreadPool&) = delete;  ///< Copy constructor (deleted).
@@ -51,15 +81,50 @@ public:
 
   bool empty() const;
   std::size_t size() const;
+  ThreadPoolScheduler scheduler() const;
+  ThreadPinning pinning() const;
+  int numa_node(std::size_t thread_index) const;
 
 private:
+  struct WorkerContext
+  {
+    const ThreadPool* pool = nullptr;
+    std::size_t index = 0;
+  };
+
+  using TaskDeque = detail::WorkStealingDeque<detail::Callable::RawHandle>;
+
+  ThreadPoolScheduler scheduler_;
+  ThreadPinning pinning_;
+  std::vector<std::vector<int>> thread_cpus_;  // CPUs each thread is pinned to; empty if not pinned
+  std::vector<int> thread_nodes_;  // NUMA node of each thread, if pinned to a single node; -1 otherwise
+
+  // ThreadPoolScheduler::MultiQueue
   std::vector<detail::TaskQueue> queues_;
-  std::vector<std::thread> threads_;
   std::atomic<std::size_t> index_;
+
+  // ThreadPoolScheduler::WorkStealing
+  std::vector<std::unique_ptr<TaskDeque>> deques_;
+  detail::TaskQueue shared_queue_;
+  std::atomic<std::int64_t> nr_pending_tasks_;
+  std::atomic<std::size_t> nr_sleeping_threads_;
+  std::atomic<bool> finished_;
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cond_;
+
+  std::vector<std::thread> threads_;
   std::atomic<std::size_t> num_threads_;
   mutable std::mutex mutex_;
 
+  static WorkerContext& current_worker();
+
+  void assign_cpus(std::size_t num_threads);
+
+  void push_task(detail::Callable&& task);
+  bool try_take_task(std::size_t thread_index, std::minstd_rand& rng, detail::Callable& task);
+
   void run_loop(std::size_t thread_index);
+  void run_loop_work_stealing(std::size_t thread_index);
 };
 
 
@@ -82,13 +147,37 @@ auto async(ThreadPool& thread_pool, Func&& f, Args&&... args)
 /** \brief Constructor. Starts the provided number of threads that wait for task execution.
  *
  * @param num_threads Number of threads in the thread pool.
+ * @param scheduler The task scheduling strategy.
+ * @param pinning How the threads are pinned to CPUs. Pinning is best effort; if it fails (or is not supported on the
+ * system), threads run unpinned.
  */
-inline ThreadPool::ThreadPool(std::size_t num_threads) : index_(0), num_threads_(0)
+inline ThreadPool::ThreadPool(std::size_t num_threads, ThreadPoolScheduler scheduler, ThreadPinning pinning)
+    : scheduler_(scheduler)
+    , pinning_(pinning)
+    , index_(0)
+    , nr_pending_tasks_(0)
+    , nr_sleeping_threads_(0)
+    , finished_(false)
+    , num_threads_(0)
 {
   std::lock_guard<std::mutex> lock(mutex_);
 
   SELENE_ASSERT(num_threads > 0);
-  queues_.resize(num_threads);
+
+  if (scheduler_ == ThreadPoolScheduler::WorkStealing)
+  {
+    deques_.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i)
+    {
+      deques_.push_back(std::make_unique<TaskDeque>());
+    }
+  }
+  else
+  {
+    queues_.resize(num_threads);
+  }
+
+  assign_cpus(num_threads);
   threads_.reserve(num_threads);
 
   for (std::size_t i = 0; i < num_threads; ++i)
@@ -106,6 +195,15 @@ inline ThreadPool::~ThreadPool()
 {
   std::lock_guard<std::mutex> lock(mutex_);
 
+  if (scheduler_ == ThreadPoolScheduler::WorkStealing)
+  {
+    {
+      std::lock_guard<std::mutex> sleep_lock(sleep_mutex_);
+      finished_ = true;
+    }
+    sleep_cond_.notify_all();
+  }
+
   std::for_each(queues_.begin(), queues_.end(), [](detail::TaskQueue& q) { q.set_finished(); });
   std::for_each(threads_.begin(), threads_.end(), [](std::thread& t) { t.join(); });
 }
@@ -128,6 +226,12 @@ auto ThreadPool::push(Func&& func, Args&&... args) -> std::future<typename std::
   std::packaged_task<ReturnType()> task(std::move(f));
   std::future<ReturnType> future(task.get_future());
 
+  if (scheduler_ == ThreadPoolScheduler::WorkStealing)
+  {
+    push_task(detail::Callable(std::move(task)));
+    return future;
+  }
+
   const auto i = index_++;
 
   for (std::size_t n = 0; n < num_threads_; ++n)
@@ -165,8 +269,233 @@ inline std::size_t ThreadPool::size() const
 }
 
 
+/** \brief Returns the task scheduling strategy of the thread pool.
+ *
+ * @return The task scheduling strategy.
+ */
+inline ThreadPoolScheduler ThreadPool::scheduler() const
+{
+  return scheduler_;
+}
+
+
+/** \brief Returns how the threads of the thread pool are pinned to CPUs.
+ *
+ * @return The thread pinning mode.
+ */
+inline ThreadPinning ThreadPool::pinning() const
+{
+  return pinning_;
+}
+
+
+/** \brief Returns the NUMA node the specified thread is assigned to.
+ *
+ * @param thread_index The index of the thread, in the range [0, size()).
+ * @return The NUMA node index, or -1 if the thread is not pinned to the CPUs of a single node.
+ */
+inline int ThreadPool::numa_node(std::size_t thread_index) const
+{
+  SELENE_ASSERT(thread_index < thread_nodes_.size());
+  return thread_nodes_[thread_index];
+}
+
+
+inline ThreadPool::WorkerContext& ThreadPool::current_worker()
+{
+  static thread_local WorkerContext context;
+  return context;
+}
+
+
+inline void ThreadPool::assign_cpus(std::size_t num_threads)
+{
+  thread_cpus_.resize(num_threads);
+  thread_nodes_.assign(num_threads, -1);
+
+  if (pinning_ == ThreadPinning::Cores)
+  {
+    const auto cpus = available_cpus();
+    const auto nr_nodes = static_cast<int>(nr_numa_nodes());
+    std::vector<int> cpu_nodes(cpus.size(), -1);
+
+    for (int node = 0; node < nr_nodes; ++node)
+    {
+      for (const auto cpu : numa_node_cpus(node))
+      {
+        const auto it = std::lower_bound(cpus.cbegin(), cpus.cend(), cpu);
+        if (it != cpus.cend() && *it == cpu)
+        {
+          cpu_nodes[static_cast<std::size_t>(it - cpus.cbegin())] = node;
+        }
+      }
+    }
+
+    for (std::size_t i = 0; i < num_threads; ++i)
+    {
+      thread_cpus_[i] = {cpus[i % cpus.size()]};
+      thread_nodes_[i] = cpu_nodes[i % cpus.size()];
+    }
+  }
+  else if (pinning_ == ThreadPinning::NumaNodes)
+  {
+    // Only consider nodes with CPUs available to the process
+    std::vector<std::pair<int, std::vector<int>>> nodes;
+    const auto nr_nodes = static_cast<int>(nr_numa_nodes());
+
+    for (int node = 0; node < nr_nodes; ++node)
+    {
+      auto cpus = numa_node_cpus(node);
+      if (!cpus.empty())
+      {
+        nodes.emplace_back(node, std::move(cpus));
+      }
+    }
+
+    for (std::size_t i = 0; i < num_threads && !nodes.empty(); ++i)
+    {
+      const auto& node = nodes[i % nodes.size()];
+      thread_cpus_[i] = node.second;
+      thread_nodes_[i] = node.first;
+    }
+  }
+}
+
+
+inline void ThreadPool::push_task(detail::Callable&& task)
+{
+  // Count the task before it becomes visible, s.t. the counter never underflows.
+  nr_pending_tasks_.fetch_add(1);
+
+  try
+  {
+    const auto& worker = current_worker();
+    if (worker.pool == this)
+    {
+      const auto handle = task.release();
+      try
+      {
+        deques_[worker.index]->push(handle);
+      }
+      catch (...)
+      {
+        // Growing the deque failed, leaving it unchanged; hand ownership back, s.t. the task gets destroyed.
+        task = detail::Callable::adopt(handle);
+        throw;
+      }
+    }
+    else
+    {
+      shared_queue_.push(std::move(task));
+    }
+  }
+  catch (...)
+  {
+    nr_pending_tasks_.fetch_sub(1);
+    throw;
+  }
+
+  // Sequentially consistent ordering w.r.t. the increment above: either a thread about to sleep sees the new task, or
+  // we see the sleeping thread.
+  if (nr_sleeping_threads_.load() > 0)
+  {
+    {
+      std::lock_guard<std::mutex> sleep_lock(sleep_mutex_);
+    }
+    sleep_cond_.notify_one();
+  }
+}
+
+
+inline bool ThreadPool::try_take_task(std::size_t thread_index, std::minstd_rand& rng, detail::Callable& task)
+{
+  detail::Callable::RawHandle handle = nullptr;
+
+  if (deques_[thread_index]->pop(handle))
+  {
+    task = detail::Callable::adopt(handle);
+    nr_pending_tasks_.fetch_sub(1);
+    return true;
+  }
+
+  if (shared_queue_.try_pop(task))
+  {
+    nr_pending_tasks_.fetch_sub(1);
+    return true;
+  }
+
+  const auto nr_deques = deques_.size();
+  const auto first_victim = static_cast<std::size_t>(rng()) % nr_deques;
+
+  for (std::size_t n = 0; n < nr_deques; ++n)
+  {
+    const auto victim = (first_victim + n) % nr_deques;
+    if (victim != thread_index && deques_[victim]->steal(handle))
+    {
+      task = detail::Callable::adopt(handle);
+      nr_pending_tasks_.fetch_sub(1);
+      return true;
+    }
+  }
+
+  return false;
+}
+
+
+inline void ThreadPool::run_loop_work_stealing(std::size_t thread_index)
+{
+  auto& worker = current_worker();
+  worker.pool = this;
+  worker.index = thread_index;
+
+  std::minstd_rand rng(static_cast<std::minstd_rand::result_type>(thread_index + 1));
+
+  while (true)
+  {
+    detail::Callable current_task;
+
+    for (std::size_t n = 0; n < 32 && !current_task.valid(); ++n)
+    {
+      if (!try_take_task(thread_index, rng, current_task))
+      {
+        std::this_thread::yield();
+      }
+    }
+
+    if (current_task.valid())
+    {
+      current_task.call();
+      continue;
+    }
+
+    std::unique_lock<std::mutex> sleep_lock(sleep_mutex_);
+    nr_sleeping_threads_.fetch_add(1);
+    sleep_cond_.wait(sleep_lock, [this] { return nr_pending_tasks_.load() > 0 || finished_; });
+    nr_sleeping_threads_.fetch_sub(1);
+
+    if (finished_ && nr_pending_tasks_.load() == 0)
+    {
+      break;
+    }
+  }
+
+  worker = WorkerContext{};
+}
+
+
 inline void ThreadPool::run_loop(std::size_t thread_index)
 {
+  if (!thread_cpus_[thread_index].empty())
+  {
+    pin_current_thread(thread_cpus_[thread_index]);
+  }
+
+  if (scheduler_ == ThreadPoolScheduler::WorkStealing)
+  {
+    run_loop_work_stealing(thread_index);
+    return;
+  }
+
   const auto i = thread_index;
 
   while (true)
@@ -44,6 +44,26 @@ public:
     callable_->call();
   }
 
+private:
+  struct CallableBase;
+
+public:
+  using RawHandle = CallableBase*;
+
+  // Releases ownership of the type-erased function object, e.g. for storage in a lock-free container.
+  RawHandle release() noexcept
+  {
+    return callable_.release();
+  }
+
+  // Takes ownership of a type-erased function object previously obtained via release().
+  static Callable adopt(RawHandle handle) noexcept
+  {
+    Callable callable;
+    callable.callable_.reset(handle);
+    return callable;
+  }
+
 private:
   struct CallableBase
   {
@@ -0,0 +1,204 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#ifndef SELENE_THREAD_DETAIL_WORK_STEALING_DEQUE_HPP
+#define SELENE_THREAD_DETAIL_WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace sln {
+namespace detail {
+
+/// \cond INTERNAL
+
+// Lock-free work-stealing deque, as described in
+// D. Chase, Y. Lev: "Dynamic Circular Work-Stealing Deque", SPAA 2005
+// with the memory orderings from
+// N. M. Le, A. Pop, A. Cohen, F. Zappa Nardelli: "Correct and Efficient Work-Stealing for Weak Memory Models",
+// PPoPP 2013.
+//
+// Only the owning thread may call push() and pop(), which operate on the bottom end of the deque (LIFO).
+// Any thread may call steal(), which operates on the top end of the deque (FIFO).
+// Elements are required to be trivially copyable (e.g. pointers).
+// pop() and steal() only assign to their argument if they succeed.
+// If push() throws while growing the underlying array (e.g. std::bad_alloc), the deque is left unchanged.
+template <typename T>
+class WorkStealingDeque
+{
+  static_assert(std::is_trivially_copyable<T>::value, "Elements need to be trivially copyable");
+
+public:
+  explicit WorkStealingDeque(std::int64_t initial_capacity = 256);
+  ~WorkStealingDeque() = default;
+
+  WorkStealingDeque(const WorkStealingDeque&) = delete;
+  WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+  WorkStealingDeque(WorkStealingDeque&&) = delete;
+  WorkStealingDeque& operator=(WorkStealingDeque&&) = delete;
+
+  void push(T value);
+  bool pop(T& value);
+  bool steal(T& value);
+
+  bool empty() const;
+
+private:
+  class Array
+  {
+  public:
+    explicit Array(std::int64_t capacity)
+        : capacity_(capacity), mask_(capacity - 1), buffer_(std::make_unique<std::atomic<T>[]>(capacity))
+    {
+    }
+
+    std::int64_t capacity() const noexcept
+    {
+      return capacity_;
+    }
+
+    T load(std::int64_t i) const noexcept
+    {
+      return buffer_[i & mask_].load(std::memory_order_relaxed);
+    }
+
+    void store(std::int64_t i, T value) noexcept
+    {
+      buffer_[i & mask_].store(value, std::memory_order_relaxed);
+    }
+
+  private:
+    std::int64_t capacity_;
+    std::int64_t mask_;
+    std::unique_ptr<std::atomic<T>[]> buffer_;
+  };
+
+  std::atomic<std::int64_t> top_;
+  std::atomic<std::int64_t> bottom_;
+  std::atomic<Array*> array_;
+  // Arrays are only reclaimed on destruction, since concurrent thieves might still read from a replaced one.
+  std::vector<std::unique_ptr<Array>> arrays_;
+
+  Array* grow(Array* array, std::int64_t bottom, std::int64_t top);
+};
+
+template <typename T>
+WorkStealingDeque<T>::WorkStealingDeque(std::int64_t initial_capacity) : top_(0), bottom_(0), array_(nullptr)
+{
+  auto capacity = std::int64_t{1};
+  while (capacity < initial_capacity)
+  {
+    capacity *= 2;
+  }
+
+  arrays_.push_back(std::make_unique<Array>(capacity));
+  array_.store(arrays_.back().get(), std::memory_order_relaxed);
+}
+
+template <typename T>
+void WorkStealingDeque<T>::push(T value)
+{
+  const auto b = bottom_.load(std::memory_order_relaxed);
+  const auto t = top_.load(std::memory_order_acquire);
+  auto a = array_.load(std::memory_order_relaxed);
+
+  if (b - t > a->capacity() - 1)
+  {
+    a = grow(a, b, t);
+  }
+
+  a->store(b, value);
+  std::atomic_thread_fence(std::memory_order_release);
+  bottom_.store(b + 1, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::pop(T& value)
+{
+  const auto b = bottom_.load(std::memory_order_relaxed) - 1;
+  const auto a = array_.load(std::memory_order_relaxed);
+  bottom_.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  auto t = top_.load(std::memory_order_relaxed);
+
+  if (t > b)  // empty
+  {
+    bottom_.store(b + 1, std::memory_order_relaxed);
+    return false;
+  }
+
+  const auto element = a->load(b);
+
+  if (t == b)  // last element; compete with thieves
+  {
+    const bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_relaxed);
+
+    if (!won)
+    {
+      return false;
+    }
+  }
+
+  value = element;
+  return true;
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::steal(T& value)
+{
+  auto t = top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  const auto b = bottom_.load(std::memory_order_acquire);
+
+  if (t >= b)  // empty
+  {
+    return false;
+  }
+
+  const auto a = array_.load(std::memory_order_acquire);
+  const auto element = a->load(t);
+
+  if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+  {
+    return false;
+  }
+
+  value = element;
+  return true;
+}
+
+template <typename T>
+bool WorkStealingDeque<T>::empty() const
+{
+  const auto b = bottom_.load(std::memory_order_relaxed);
+  const auto t = top_.load(std::memory_order_relaxed);
+  return b <= t;
+}
+
+template <typename T>
+auto WorkStealingDeque<T>::grow(Array* array, std::int64_t bottom, std::int64_t top) -> Array*
+{
+  arrays_.push_back(std::make_unique<Array>(2 * array->capacity()));
+  const auto new_array = arrays_.back().get();
+
+  for (auto i = top; i < bottom; ++i)
+  {
+    new_array->store(i, array->load(i));
+  }
+
+  array_.store(new_array, std::memory_order_release);
+  return new_array;
+}
+
+/// \endcond
+
+}  // namespace detail
+}  // namespace sln
+
+#endif  // SELENE_THREAD_DETAIL_WORK_STEALING_DEQUE_HPP
@@ -8,6 +8,8 @@
 #include <selene/base/MemoryBlock.hpp>
 #include <selene/base/Utils.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <random>
 
 TEST_CASE("Allocators", "[base]")
@@ -61,4 +63,30 @@ TEST_CASE("Allocators", "[base]")
       REQUIRE(reinterpret_cast<std::uintptr_t>(memory_block.data()) % alignment == 0);
     }
   }
-}
\ No newline at end of file
+}
+TEST_CASE("Zero-initialized allocation", "[base]")
+{
+  for (const std::size_t nr_bytes : {std::size_t{1}, std::size_t{1000}, std::size_t{4} << 20})
+  {
+    for (const std::size_t alignment : {std::size_t{1}, std::size_t{16}, std::size_t{64}})
+    {
+      // Leave some garbage behind, s.t. a reused allocation is not zero by chance
+      {
+        auto garbage = sln::AlignedMallocAllocator::allocate(nr_bytes, alignment);
+        std::fill(garbage.data(), garbage.data() + garbage.size(), std::uint8_t{0xFF});
+      }
+
+      auto block = sln::AlignedMallocAllocator::allocate_zeroed(nr_bytes, alignment);
+      REQUIRE(block.size() == nr_bytes);
+      REQUIRE(reinterpret_cast<std::uintptr_t>(block.data()) % alignment == 0);
+      REQUIRE(std::all_of(block.data(), block.data() + block.size(), [](auto x) { return x == 0; }));
+    }
+
+    auto block = sln::MallocAllocator::allocate_zeroed(nr_bytes);
+    REQUIRE(block.size() == nr_bytes);
+    REQUIRE(std::all_of(block.data(), block.data() + block.size(), [](auto x) { return x == 0; }));
+  }
+
+  REQUIRE(sln::MallocAllocator::allocate_zeroed(0).data() == nullptr);
+  REQUIRE(sln::AlignedMallocAllocator::allocate_zeroed(0, 16).data() == nullptr);
+}
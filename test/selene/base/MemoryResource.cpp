@@ -0,0 +1,360 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch.hpp>
+
+#include <selene/base/Allocators.hpp>
+#include <selene/base/ArenaMemoryResource.hpp>
+#include <selene/base/MappedMemoryResource.hpp>
+#include <selene/base/MemoryBlock.hpp>
+#include <selene/base/MemoryResource.hpp>
+#include <selene/base/Numa.hpp>
+#include <selene/base/PoolMemoryResource.hpp>
+
+#include <selene/thread/Parallel.hpp>
+#include <selene/thread/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+bool is_aligned(const std::uint8_t* ptr, std::size_t alignment)
+{
+  return reinterpret_cast<std::uintptr_t>(ptr) % alignment == 0;
+}
+
+}  // namespace
+
+TEST_CASE("Memory block ownership transfer", "[base]")
+{
+  auto block = sln::AlignedNewAllocator::allocate(1000, 16);
+  const auto data = block.data();
+  REQUIRE(data != nullptr);
+
+  auto block_moved = std::move(block);
+  REQUIRE(block.data() == nullptr);
+  REQUIRE(block.size() == 0);
+  REQUIRE(block_moved.data() == data);
+  REQUIRE(block_moved.size() == 1000);
+
+  auto block_other = sln::AlignedNewAllocator::allocate(500, 16);
+  block_other = std::move(block_moved);  // deallocates the previously held memory
+  REQUIRE(block_moved.data() == nullptr);
+  REQUIRE(block_other.data() == data);
+
+  auto& resource = sln::default_memory_resource();
+  auto resource_block = resource.allocate(2000, 32);
+  REQUIRE(resource_block.size() == 2000);
+  REQUIRE(&resource_block.resource() == &resource);
+  REQUIRE(is_aligned(resource_block.data(), 32));
+
+  auto resource_block_moved = std::move(resource_block);
+  REQUIRE(resource_block.data() == nullptr);
+  REQUIRE(resource_block_moved.size() == 2000);
+
+  const auto empty_block = resource.allocate(0, 16);
+  REQUIRE(empty_block.data() == nullptr);
+  REQUIRE(empty_block.size() == 0);
+}
+
+TEST_CASE("Pool memory resource", "[base]")
+{
+  SECTION("Block reuse")
+  {
+    sln::PoolMemoryResource pool;
+
+    auto block = pool.allocate(10000, 16);
+    REQUIRE(block.size() == 10000);
+    REQUIRE(is_aligned(block.data(), sln::PoolMemoryResource::block_alignment));
+    std::memset(block.data(), 0xAB, block.size());
+    const auto data = block.data();
+    REQUIRE(pool.nr_pooled_blocks() == 0);
+
+    block = pool.allocate(100, 16);  // the previous block is deallocated to the thread cache
+    REQUIRE(pool.nr_pooled_blocks() == 1);
+    REQUIRE(pool.nr_allocations() == 2);
+
+    // A request of the same size class reuses the block
+    auto block_same_class = pool.allocate(9000, 64);
+    REQUIRE(block_same_class.data() == data);
+    REQUIRE(pool.nr_allocations() == 2);
+    REQUIRE(pool.nr_pooled_blocks() == 0);
+
+    // Larger alignments bypass the pool
+    auto block_aligned = pool.allocate(10000, 4 * sln::PoolMemoryResource::block_alignment);
+    REQUIRE(is_aligned(block_aligned.data(), 4 * sln::PoolMemoryResource::block_alignment));
+    REQUIRE(pool.nr_allocations() == 3);
+    block_aligned = pool.allocate(0, 16);
+    REQUIRE(pool.nr_pooled_blocks() == 0);
+
+    pool.clear();
+    REQUIRE(pool.nr_pooled_blocks() == 0);
+  }
+
+  SECTION("Limited number of retained blocks")
+  {
+    sln::PoolMemoryResource pool(2, 3);
+
+    {
+      std::vector<sln::MemoryBlock<sln::MemoryResource>> blocks;
+      for (int i = 0; i < 10; ++i)
+      {
+        blocks.push_back(pool.allocate(50000, 16));
+      }
+    }
+
+    // 3 blocks in the thread cache, 2 in the shared pool
+    REQUIRE(pool.nr_allocations() == 10);
+    REQUIRE(pool.nr_pooled_blocks() == 5);
+
+    for (int i = 0; i < 5; ++i)
+    {
+      auto block = pool.allocate(50000, 16);
+    }
+
+    REQUIRE(pool.nr_allocations() == 10);
+  }
+
+  SECTION("Blocks cached by an exiting thread")
+  {
+    sln::PoolMemoryResource pool(16, 4);
+
+    std::thread thread([&pool]() {
+      auto block0 = pool.allocate(100000, 16);
+      auto block1 = pool.allocate(100000, 16);
+    });
+    thread.join();
+
+    // The blocks were moved to the shared pool, and can be reused by this thread
+    REQUIRE(pool.nr_pooled_blocks() == 2);
+    auto block0 = pool.allocate(100000, 16);
+    auto block1 = pool.allocate(100000, 16);
+    REQUIRE(pool.nr_allocations() == 2);
+  }
+
+  SECTION("No thread cache")
+  {
+    sln::PoolMemoryResource pool(16, 0);
+
+    for (int i = 0; i < 10; ++i)
+    {
+      auto block = pool.allocate(20000, 16);
+      REQUIRE(pool.nr_pooled_blocks() == 0);
+    }
+
+    REQUIRE(pool.nr_allocations() == 1);
+    REQUIRE(pool.nr_pooled_blocks() == 1);
+  }
+
+  SECTION("Concurrent use")
+  {
+    sln::PoolMemoryResource pool;
+    sln::ThreadPool thread_pool(4);
+    std::atomic<bool> data_intact{true};
+
+    sln::parallel_for(thread_pool, std::size_t{0}, std::size_t{1000}, std::size_t{10}, [&](std::size_t begin,
+                                                                                          std::size_t end) {
+      for (auto i = begin; i < end; ++i)
+      {
+        auto block = pool.allocate(4096 + (i % 4) * 20000, 16);
+        std::fill(block.data(), block.data() + block.size(), static_cast<std::uint8_t>(i));
+        std::this_thread::yield();
+        if (!std::all_of(block.data(), block.data() + block.size(), [i](auto x) { return x == std::uint8_t(i); }))
+        {
+          data_intact = false;
+        }
+      }
+    });
+
+    REQUIRE(data_intact);
+    // At most one block per size class and thread is in use at any time
+    REQUIRE(pool.nr_allocations() <= 4 * (thread_pool.size() + 1));
+  }
+}
+
+TEST_CASE("Arena memory resource", "[base]")
+{
+  constexpr std::size_t chunk_size = 100000;
+  sln::ArenaMemoryResource arena(chunk_size);
+  REQUIRE(arena.nr_chunks() == 0);
+  REQUIRE(arena.capacity() == 0);
+
+  const std::uint8_t* first_data = nullptr;
+
+  for (int round = 0; round < 3; ++round)
+  {
+    std::vector<sln::MemoryBlock<sln::MemoryResource>> blocks;
+
+    for (std::size_t i = 0; i < 10; ++i)
+    {
+      const auto alignment = std::size_t{1} << (i % 8);
+      blocks.push_back(arena.allocate(30000 + i, alignment));
+      REQUIRE(blocks.back().data() != nullptr);
+      REQUIRE(is_aligned(blocks.back().data(), alignment));
+      std::memset(blocks.back().data(), int(i), blocks.back().size());
+    }
+
+    // Allocations do not overlap
+    for (std::size_t i = 0; i < blocks.size(); ++i)
+    {
+      REQUIRE(std::all_of(blocks[i].data(), blocks[i].data() + blocks[i].size(),
+                          [i](auto x) { return x == std::uint8_t(i); }));
+    }
+
+    REQUIRE(arena.nr_bytes_allocated() == 10 * 30000 + 45);
+
+    if (round == 0)
+    {
+      REQUIRE(arena.nr_chunks() == 4);
+    }
+    else
+    {
+      // After the first reset, everything fits into a single chunk, which is reused
+      REQUIRE(arena.nr_chunks() == 1);
+      REQUIRE(arena.capacity() == 4 * chunk_size);
+      first_data = (round == 1) ? blocks.front().data() : first_data;
+      REQUIRE(blocks.front().data() == first_data);
+    }
+
+    blocks.clear();  // deallocation is a no-op
+    arena.reset();
+    REQUIRE(arena.nr_bytes_allocated() == 0);
+    REQUIRE(arena.nr_chunks() == 1);
+  }
+
+  // Allocations larger than the chunk size
+  auto large_block = arena.allocate(3 * chunk_size, 64);
+  REQUIRE(large_block.size() == 3 * chunk_size);
+  REQUIRE(is_aligned(large_block.data(), 64));
+
+  arena.release();
+  REQUIRE(arena.nr_chunks() == 0);
+  REQUIRE(arena.capacity() == 0);
+}
+
+TEST_CASE("Mapped memory resource", "[base]")
+{
+  constexpr std::size_t min_mapping_size = 1 << 16;
+
+  for (const auto huge_pages : {sln::HugePages::None, sln::HugePages::Transparent, sln::HugePages::Explicit})
+  {
+    for (const auto numa_node : {sln::MappedMemoryResource::any_numa_node, sln::MappedMemoryResource::local_numa_node,
+                                 sln::current_numa_node()})
+    {
+      sln::MappedMemoryResource resource(huge_pages, numa_node, min_mapping_size);
+      REQUIRE(resource.huge_pages() == huge_pages);
+      REQUIRE(resource.numa_node() == numa_node);
+      REQUIRE(resource.min_mapping_size() == min_mapping_size);
+
+      std::vector<sln::MemoryBlock<sln::MemoryResource>> blocks;
+
+      for (std::size_t i = 0; i < 8; ++i)
+      {
+        // Alternating between allocations below and above the mapping threshold
+        const auto nr_bytes = (i % 2 == 0) ? 1000 + i : 3 * min_mapping_size + i;
+        const auto alignment = std::size_t{16} << i;
+        blocks.push_back(resource.allocate(nr_bytes, alignment));
+        REQUIRE(blocks.back().data() != nullptr);
+        REQUIRE(blocks.back().size() == nr_bytes);
+        REQUIRE(is_aligned(blocks.back().data(), alignment));
+        std::memset(blocks.back().data(), int(i), blocks.back().size());
+      }
+
+      for (std::size_t i = 0; i < blocks.size(); ++i)
+      {
+        REQUIRE(std::all_of(blocks[i].data(), blocks[i].data() + blocks[i].size(),
+                            [i](auto x) { return x == std::uint8_t(i); }));
+      }
+
+#if defined(__unix__) || defined(__APPLE__)
+      REQUIRE(resource.nr_mappings() == 4);
+#endif
+      REQUIRE(resource.nr_bound_mappings() <= resource.nr_mappings());
+    }
+  }
+
+  REQUIRE(sln::MappedMemoryResource::huge_page_size() >= 4096);
+}
+
+TEST_CASE("NUMA topology", "[base]")
+{
+  const auto nr_nodes = sln::nr_numa_nodes();
+  REQUIRE(nr_nodes >= 1);
+
+  const auto node = sln::current_numa_node();
+  REQUIRE(node >= 0);
+  REQUIRE(static_cast<std::size_t>(node) < nr_nodes);
+
+  const auto cpus = sln::available_cpus();
+  REQUIRE(!cpus.empty());
+  REQUIRE(std::is_sorted(cpus.cbegin(), cpus.cend()));
+
+  // Each available CPU belongs to exactly one node
+  std::size_t nr_node_cpus = 0;
+  for (std::size_t n = 0; n < nr_nodes; ++n)
+  {
+    const auto node_cpus = sln::numa_node_cpus(static_cast<int>(n));
+    for (const auto cpu : node_cpus)
+    {
+      REQUIRE(std::binary_search(cpus.cbegin(), cpus.cend(), cpu));
+    }
+    nr_node_cpus += node_cpus.size();
+  }
+  REQUIRE(nr_node_cpus == cpus.size());
+
+  REQUIRE(!sln::pin_current_thread({}));
+}
+
+TEST_CASE("Zero-initialized allocation from memory resources", "[base]")
+{
+  const auto is_zero = [](const sln::MemoryBlock<sln::MemoryResource>& block) {
+    return std::all_of(block.data(), block.data() + block.size(), [](auto x) { return x == 0; });
+  };
+
+  sln::PoolMemoryResource pool;
+  sln::ArenaMemoryResource arena(1 << 20);
+  sln::MappedMemoryResource mapped(sln::HugePages::None, sln::MappedMemoryResource::any_numa_node, 1 << 16);
+
+  for (sln::MemoryResource* resource :
+       std::vector<sln::MemoryResource*>{&sln::default_memory_resource(), &pool, &arena, &mapped})
+  {
+    for (const std::size_t nr_bytes : {std::size_t{100}, std::size_t{50000}, std::size_t{300000}})
+    {
+      // Blocks that are reused (e.g. from the pool or after an arena reset) have to be cleared
+      for (int round = 0; round < 2; ++round)
+      {
+        auto block = resource->allocate_zeroed(nr_bytes, 32);
+        REQUIRE(block.size() == nr_bytes);
+        REQUIRE(is_aligned(block.data(), 32));
+        REQUIRE(is_zero(block));
+        std::memset(block.data(), 0xFF, block.size());
+        block = resource->allocate(0, 16);
+        arena.reset();
+      }
+    }
+  }
+
+  REQUIRE(mapped.nr_mappings() == 2);
+  REQUIRE(pool.allocate_zeroed(0, 16).data() == nullptr);
+
+  // The default resource allocates zero-initialized memory differently, but deallocates either kind of memory (as well
+  // as memory allocated via AlignedNewAllocator)
+  auto& resource = sln::default_memory_resource();
+  auto zeroed_block = resource.allocate_zeroed(std::size_t{1} << 24, 64);
+  REQUIRE(is_aligned(zeroed_block.data(), 64));
+  REQUIRE(is_zero(zeroed_block));
+  auto block = resource.allocate(1000, 64);
+  auto adopted_block = sln::construct_memory_block_from_existing_memory(
+      sln::AlignedNewAllocator::allocate(1000, 16).transfer_data(), 1000, resource);
+  zeroed_block = std::move(block);
+  block = std::move(adopted_block);
+  zeroed_block = resource.allocate_zeroed(100, 16);
+  REQUIRE(is_zero(zeroed_block));
+}
@@ -5,10 +5,15 @@
 #include <catch.hpp>
 
 #include <selene/base/Allocators.hpp>
+#include <selene/base/ArenaMemoryResource.hpp>
+#include <selene/base/MappedMemoryResource.hpp>
+#include <selene/base/PoolMemoryResource.hpp>
 #include <selene/base/Types.hpp>
 #include <selene/img/Image.hpp>
 
+#include <algorithm>
 #include <random>
+#include <vector>
 
 #include <test/selene/img/_TestImages.hpp>
 
@@ -307,3 +312,169 @@ TEST_CASE("Image comparison", "[img]")
   REQUIRE(img_xxx_2.height() == img_xxx.height());
   REQUIRE(img_xxx_2 == img_xxx);
 }
+
+TEST_CASE("Image allocation from a memory resource", "[img]")
+{
+  sln::PoolMemoryResource pool;
+
+  {
+    sln::Image_8u3 img(100_px, 50_px, sln::Stride{0}, pool);
+    REQUIRE(&img.memory_resource() == &pool);
+    REQUIRE(!img.is_view());
+    img.fill(sln::Pixel_8u3(1, 2, 3));
+    REQUIRE(pool.nr_allocations() == 1);
+
+    // Reallocations use the same resource
+    img.allocate(50_px, 100_px, sln::Stride{0}, true, true);
+    REQUIRE(pool.nr_allocations() == 1);  // same size class
+    img.allocate(200_px, 100_px);
+    REQUIRE(pool.nr_allocations() == 2);
+
+    // The resource is transferred on move, but not on copy construction
+    const auto img_copy = img;
+    REQUIRE(&img_copy.memory_resource() == &sln::default_memory_resource());
+    REQUIRE(img_copy == img);
+
+    sln::Image_8u3 img_moved = std::move(img);
+    REQUIRE(&img_moved.memory_resource() == &pool);
+    REQUIRE(img_moved == img_copy);
+
+    sln::Image_8u3 img_assigned;
+    img_assigned = std::move(img_moved);
+    REQUIRE(&img_assigned.memory_resource() == &pool);
+    REQUIRE(pool.nr_pooled_blocks() == 1);
+  }
+
+  REQUIRE(pool.nr_pooled_blocks() == 2);
+
+  {
+    sln::ArenaMemoryResource arena(1 << 20);
+    sln::Image_8u1 img(arena);
+    REQUIRE(img.is_empty());
+    REQUIRE(&img.memory_resource() == &arena);
+
+    img.allocate(64_px, 64_px, sln::ImageRowAlignment{32});
+    REQUIRE(reinterpret_cast<std::uintptr_t>(img.byte_ptr()) % 32 == 0);
+    REQUIRE(arena.nr_bytes_allocated() == img.total_bytes());
+
+    const auto nr_bytes = img.total_bytes();
+    img.clear();
+    REQUIRE(&img.memory_resource() == &arena);
+
+    sln::Image_8u1 img_2(10_px, 10_px, sln::ImageRowAlignment{16}, arena);
+    img_2.fill(sln::Pixel_8u1(42));
+    REQUIRE(arena.nr_bytes_allocated() == nr_bytes + img_2.total_bytes());
+
+    auto block = arena.allocate(100, 16);
+    img.set_data(std::move(block), 10_px, 10_px);
+    REQUIRE(&img.memory_resource() == &arena);
+    img.set_data(sln::AlignedNewAllocator::allocate(100, 16), 10_px, 10_px);
+    REQUIRE(&img.memory_resource() == &sln::default_memory_resource());
+  }
+}
+
+TEST_CASE("Zero-initialized image allocation", "[img]")
+{
+  const auto is_zero = [](const auto& img) {
+    return std::all_of(img.byte_ptr(), img.byte_ptr() + img.total_bytes(), [](auto x) { return x == 0; });
+  };
+
+  sln::PoolMemoryResource pool;
+  sln::MappedMemoryResource mapped(sln::HugePages::Transparent);
+
+  for (sln::MemoryResource* resource :
+       std::vector<sln::MemoryResource*>{&sln::default_memory_resource(), &pool, &mapped})
+  {
+    sln::Image_8u3 img(1000_px, 1000_px, sln::Stride{0}, *resource);
+    img.fill(sln::Pixel_8u3(255, 255, 255));
+
+    // Always reallocates, even if the size matches
+    img.allocate_zeroed(1000_px, 1000_px, sln::Stride{3008});
+    REQUIRE(&img.memory_resource() == resource);
+    REQUIRE(img.width() == 1000_px);
+    REQUIRE(img.height() == 1000_px);
+    REQUIRE(img.stride_bytes() == 3008);
+    REQUIRE(!img.is_view());
+    REQUIRE(is_zero(img));
+
+    img.fill(sln::Pixel_8u3(255, 255, 255));
+    img.allocate_zeroed(300_px, 200_px, sln::ImageRowAlignment{64});
+    REQUIRE(img.stride_bytes() % 64 == 0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(img.byte_ptr()) % 64 == 0);
+    REQUIRE(is_zero(img));
+  }
+
+  // Zero-initialized allocation from a view allocates owned memory
+  std::vector<std::uint8_t> buffer(30, 0xFF);
+  sln::Image_8u3 img_view(buffer.data(), 5_px, 2_px);
+  img_view.allocate_zeroed(5_px, 2_px);
+  REQUIRE(!img_view.is_view());
+  REQUIRE(is_zero(img_view));
+  REQUIRE(buffer[0] == 0xFF);
+
+  // Large zero-initialized images are backed by fresh mappings
+  REQUIRE(mapped.nr_mappings() == 2);
+}
+
+TEST_CASE("SIMD-padded image layout", "[img]")
+{
+  const auto check_layout = [](const auto& img) {
+    REQUIRE(img.simd_safe_tail());
+    REQUIRE(reinterpret_cast<std::uintptr_t>(img.byte_ptr()) % sln::simd_vector_bytes == 0);
+    REQUIRE(img.stride_bytes() % sln::simd_vector_bytes == 0);
+    REQUIRE(img.stride_bytes() >= img.row_bytes() + sln::simd_vector_bytes);
+    REQUIRE(img.stride_bytes() < img.row_bytes() + 2 * sln::simd_vector_bytes);
+  };
+
+  for (auto width : {1, 3, 21, 22, 64, 100})
+  {
+    const auto w = sln::PixelLength{width};
+    sln::Image_8u3 img(w, 5_px, sln::ImageLayout::SimdPadded);
+    check_layout(img);
+
+    // Writing the row padding does not affect the pixels of subsequent rows
+    img.fill(sln::Pixel_8u3(1, 2, 3));
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      std::fill(img.byte_ptr(y) + img.row_bytes(), img.byte_ptr(y) + img.row_bytes() + sln::simd_vector_bytes,
+                std::uint8_t{0xFF});
+    }
+
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      REQUIRE(std::all_of(img.data(y), img.data_row_end(y), [](auto px) { return px == sln::Pixel_8u3(1, 2, 3); }));
+    }
+
+    // Copies and moved-to images retain the layout
+    const auto img_copy = img;
+    check_layout(img_copy);
+    const auto img_moved = std::move(img);
+    check_layout(img_moved);
+  }
+
+  sln::Image_8u4 img(10_px, 10_px);
+  REQUIRE(!img.simd_safe_tail());
+  REQUIRE(!sln::Image_8u4().simd_safe_tail());
+
+  img.allocate(10_px, 10_px, sln::ImageLayout::SimdPadded);
+  check_layout(img);
+  REQUIRE(!sln::view(img).simd_safe_tail());
+  REQUIRE(!sln::view(img, 0_idx, 0_idx, 5_px, 5_px).simd_safe_tail());
+
+  img.allocate(10_px, 10_px, sln::ImageLayout::Default);
+  REQUIRE(img.stride_bytes() == img.row_bytes());
+  REQUIRE(!img.simd_safe_tail());
+
+  img.allocate_zeroed(20_px, 3_px, sln::ImageLayout::SimdPadded);
+  check_layout(img);
+  REQUIRE(std::all_of(img.byte_ptr(), img.byte_ptr() + img.total_bytes(), [](auto x) { return x == 0; }));
+
+  // Views on external memory never have a SIMD-safe tail, irrespective of their geometry
+  sln::Image_8u4 img_view(img.byte_ptr(), 20_px, 3_px, img.stride_bytes());
+  REQUIRE(!img_view.simd_safe_tail());
+
+  // Reallocation with a matching size, but insufficient alignment, allocates new memory
+  sln::Image_8u1 img_small(sln::AlignedNewAllocator::allocate(256, 16), 64_px, 4_px);
+  img_small.allocate(64_px, 2_px, sln::ImageLayout::SimdPadded, false);
+  check_layout(img_small);
+}
@@ -0,0 +1,162 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch.hpp>
+
+#include <selene/img/ImageBufferPool.hpp>
+
+#include <selene/thread/Parallel.hpp>
+#include <selene/thread/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+using namespace sln::literals;
+
+TEST_CASE("Image buffer pool size classes", "[img]")
+{
+  for (std::size_t nr_bytes : {0, 1, 100, 4096})
+  {
+    REQUIRE(sln::ImageBufferPool::size_class_index(nr_bytes) == 0);
+  }
+
+  REQUIRE(sln::ImageBufferPool::size_class_bytes(0) == sln::ImageBufferPool::min_buffer_size);
+
+  std::size_t prev_index = 0;
+  for (std::size_t nr_bytes = 4097; nr_bytes < (std::size_t{1} << 30); nr_bytes += nr_bytes / 7 + 1)
+  {
+    const auto index = sln::ImageBufferPool::size_class_index(nr_bytes);
+    const auto class_bytes = sln::ImageBufferPool::size_class_bytes(index);
+    REQUIRE(index >= prev_index);
+    REQUIRE(class_bytes >= nr_bytes);
+    REQUIRE(class_bytes < nr_bytes + nr_bytes / 4 + 1);
+    REQUIRE(sln::ImageBufferPool::size_class_index(class_bytes) == index);
+    REQUIRE(sln::ImageBufferPool::size_class_bytes(index - 1) < nr_bytes);
+    prev_index = index;
+  }
+}
+
+TEST_CASE("Image buffer pool", "[img]")
+{
+  SECTION("Buffer reuse")
+  {
+    sln::ImageBufferPool pool;
+
+    std::uint8_t* data = nullptr;
+    {
+      auto buffer = pool.acquire(10000);
+      REQUIRE(!buffer.empty());
+      REQUIRE(buffer.size() >= 10000);
+      REQUIRE(reinterpret_cast<std::uintptr_t>(buffer.data()) % sln::ImageBufferPool::buffer_alignment == 0);
+      std::memset(buffer.data(), 0xAB, buffer.size());
+      data = buffer.data();
+      REQUIRE(pool.nr_pooled_buffers() == 0);
+    }
+
+    REQUIRE(pool.nr_pooled_buffers() == 1);
+
+    // A request of the same size class reuses the buffer
+    auto buffer = pool.acquire(9000);
+    REQUIRE(buffer.data() == data);
+    REQUIRE(pool.nr_allocations() == 1);
+
+    // Requests of other size classes do not
+    auto buffer_small = pool.acquire(100);
+    auto buffer_large = pool.acquire(100000);
+    REQUIRE(buffer_small.data() != data);
+    REQUIRE(buffer_large.data() != data);
+    REQUIRE(pool.nr_allocations() == 3);
+
+    // Moving transfers ownership
+    auto buffer_moved = std::move(buffer);
+    REQUIRE(buffer.empty());
+    REQUIRE(buffer_moved.data() == data);
+
+    buffer_moved.reset();
+    REQUIRE(buffer_moved.empty());
+    REQUIRE(pool.nr_pooled_buffers() == 1);
+
+    buffer_small = std::move(buffer_large);
+    REQUIRE(buffer_large.empty());
+    REQUIRE(pool.nr_pooled_buffers() == 2);
+
+    pool.clear();
+    REQUIRE(pool.nr_pooled_buffers() == 0);
+  }
+
+  SECTION("Limited number of pooled buffers")
+  {
+    sln::ImageBufferPool pool(2);
+
+    {
+      std::vector<sln::ImageBufferPool::Buffer> buffers;
+      for (int i = 0; i < 5; ++i)
+      {
+        buffers.push_back(pool.acquire(50000));
+      }
+    }
+
+    REQUIRE(pool.nr_allocations() == 5);
+    REQUIRE(pool.nr_pooled_buffers() == 2);
+  }
+
+  SECTION("Pooled image data")
+  {
+    sln::ImageBufferPool pool;
+
+    const std::uint8_t* data = nullptr;
+    {
+      auto img = pool.acquire_image_data(100_px, 50_px, 3, 2, sln::PixelFormat::RGB, sln::SampleFormat::UnsignedInteger);
+      REQUIRE(img.is_valid());
+
+      const auto& img_data = img.image_data();
+      REQUIRE(img_data.is_view());
+      REQUIRE(img_data.width() == 100);
+      REQUIRE(img_data.height() == 50);
+      REQUIRE(img_data.nr_channels() == 3);
+      REQUIRE(img_data.nr_bytes_per_channel() == 2);
+      REQUIRE(img_data.stride_bytes() == 600);
+      REQUIRE(img_data.pixel_format() == sln::PixelFormat::RGB);
+      REQUIRE(img_data.sample_format() == sln::SampleFormat::UnsignedInteger);
+      data = img_data.byte_ptr();
+
+      sln::PooledImageData img_moved = std::move(img);
+      REQUIRE(img_moved.is_valid());
+      REQUIRE(img_moved.image_data().byte_ptr() == data);
+      REQUIRE(pool.nr_pooled_buffers() == 0);
+    }
+
+    REQUIRE(pool.nr_pooled_buffers() == 1);
+
+    auto img = pool.acquire_image_data(50_px, 100_px, 3, 2);  // same number of bytes
+    REQUIRE(img.image_data().byte_ptr() == data);
+    REQUIRE(pool.nr_allocations() == 1);
+
+    img.clear();
+    REQUIRE(!img.is_valid());
+    REQUIRE(pool.nr_pooled_buffers() == 1);
+  }
+
+  SECTION("Concurrent use")
+  {
+    sln::ImageBufferPool pool;
+    sln::ThreadPool thread_pool(4);
+
+    sln::parallel_for(thread_pool, std::size_t{0}, std::size_t{1000}, std::size_t{10}, [&pool](std::size_t begin,
+                                                                                              std::size_t end) {
+      for (auto i = begin; i < end; ++i)
+      {
+        auto buffer = pool.acquire(4096 + (i % 4) * 20000);
+        std::fill(buffer.data(), buffer.data() + buffer.size(), static_cast<std::uint8_t>(i));
+      }
+    });
+
+    // At most one buffer per size class and thread is in use at any time
+    REQUIRE(pool.nr_allocations() <= 4 * (thread_pool.size() + 1));
+    REQUIRE(pool.nr_pooled_buffers() == pool.nr_allocations());
+  }
+}
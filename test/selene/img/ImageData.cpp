@@ -4,12 +4,14 @@
 
 #include <catch.hpp>
 
+#include <selene/base/ArenaMemoryResource.hpp>
 #include <selene/base/Types.hpp>
 #include <selene/base/Utils.hpp>
 #include <selene/img/ImageData.hpp>
 #include <selene/img/Types.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <random>
 
@@ -128,3 +130,110 @@ TEST_CASE("Image data construction", "[img]")
   test_image_data_construction_over_channels<std::int64_t>(rng);
 }
 
+
+TEST_CASE("Image data allocation from a memory resource", "[img]")
+{
+  sln::ArenaMemoryResource arena(1 << 16);
+
+  for (int i = 0; i < 3; ++i)
+  {
+    {
+      sln::ImageData<> img_data(100_px, 20_px, 3, 1, sln::Stride{0}, sln::PixelFormat::RGB,
+                                sln::SampleFormat::UnsignedInteger, arena);
+      REQUIRE(&img_data.memory_resource() == &arena);
+      REQUIRE(img_data.stride_bytes() == 300);
+      REQUIRE(arena.nr_bytes_allocated() == 300 * 20);
+
+      sln::ImageData<> img_data_2(arena);
+      img_data_2.allocate(10_px, 10_px, 1, 2, sln::ImageRowAlignment{64});
+      REQUIRE(reinterpret_cast<std::uintptr_t>(img_data_2.byte_ptr()) % 64 == 0);
+      REQUIRE(img_data_2.stride_bytes() == 64);
+      REQUIRE(arena.nr_bytes_allocated() == 300 * 20 + 64 * 10);
+
+      // The resource is transferred on move, but not on copy construction
+      const auto img_data_copy = img_data;
+      REQUIRE(&img_data_copy.memory_resource() == &sln::default_memory_resource());
+      const auto img_data_moved = std::move(img_data_2);
+      REQUIRE(&img_data_moved.memory_resource() == &arena);
+    }
+
+    arena.reset();
+  }
+
+  REQUIRE(arena.nr_chunks() == 1);
+}
+
+TEST_CASE("Zero-initialized image data allocation", "[img]")
+{
+  sln::ImageData<> img_data(300_px, 200_px, 4, 2);
+  std::fill(img_data.byte_ptr(), img_data.byte_ptr() + img_data.total_bytes(), std::uint8_t{0xFF});
+
+  img_data.allocate_zeroed(300_px, 200_px, 3, 1, sln::Stride{1000}, sln::PixelFormat::RGB,
+                           sln::SampleFormat::UnsignedInteger);
+  REQUIRE(img_data.width() == 300_px);
+  REQUIRE(img_data.height() == 200_px);
+  REQUIRE(img_data.nr_channels() == 3);
+  REQUIRE(img_data.nr_bytes_per_channel() == 1);
+  REQUIRE(img_data.stride_bytes() == 1000);
+  REQUIRE(img_data.pixel_format() == sln::PixelFormat::RGB);
+  REQUIRE(img_data.sample_format() == sln::SampleFormat::UnsignedInteger);
+  REQUIRE(!img_data.is_view());
+  REQUIRE(std::all_of(img_data.byte_ptr(), img_data.byte_ptr() + img_data.total_bytes(),
+                      [](auto x) { return x == 0; }));
+
+  std::fill(img_data.byte_ptr(), img_data.byte_ptr() + img_data.total_bytes(), std::uint8_t{0xFF});
+  img_data.allocate_zeroed(300_px, 200_px, 3, 1, sln::ImageRowAlignment{64}, sln::PixelFormat::RGB);
+  REQUIRE(img_data.stride_bytes() % 64 == 0);
+  REQUIRE(img_data.stride_bytes() >= 900);
+  REQUIRE(reinterpret_cast<std::uintptr_t>(img_data.byte_ptr()) % 64 == 0);
+  REQUIRE(img_data.sample_format() == sln::SampleFormat::Unknown);
+  REQUIRE(std::all_of(img_data.byte_ptr(), img_data.byte_ptr() + img_data.total_bytes(),
+                      [](auto x) { return x == 0; }));
+}
+
+TEST_CASE("Planar image data", "[img]")
+{
+  sln::ImageData<> img_data;
+  img_data.allocate_planar(30_px, 20_px, 3, 2, sln::Stride{64}, sln::PixelFormat::RGB,
+                           sln::SampleFormat::UnsignedInteger);
+  REQUIRE(img_data.is_planar());
+  REQUIRE(img_data.channel_layout() == sln::ChannelLayout::Planar);
+  REQUIRE(img_data.stride_bytes() == 64);
+  REQUIRE(img_data.row_bytes() == 60);
+  REQUIRE(img_data.total_bytes() == 64 * 20 * 3);
+  REQUIRE(!img_data.is_packed());
+  REQUIRE(!img_data.is_view());
+
+  for (std::uint16_t c = 0; c < 3; ++c)
+  {
+    REQUIRE(img_data.plane_byte_ptr(c) == img_data.byte_ptr() + c * 64 * 20);
+    REQUIRE(img_data.plane_byte_ptr(c, 5_idx) == img_data.plane_byte_ptr(c) + 5 * 64);
+    std::fill(img_data.plane_byte_ptr(c), img_data.plane_byte_ptr(c) + 64 * 20, std::uint8_t(c + 1));
+  }
+
+  REQUIRE(*img_data.plane_byte_ptr(2, 19_idx) == 3);
+  REQUIRE(img_data.byte_ptr(4_idx, 1_idx) == img_data.byte_ptr() + 64 + 4 * 2);
+
+  // Copies retain the planar layout
+  const auto img_data_copy = img_data;
+  REQUIRE(img_data_copy.is_planar());
+  REQUIRE(img_data_copy.total_bytes() == img_data.total_bytes());
+
+  // The minimal stride of each plane only covers one channel
+  sln::ImageData<> img_data_view;
+  img_data_view.set_planar_view(img_data.byte_ptr(), 32_px, 20_px, 3, 2);
+  REQUIRE(img_data_view.is_view());
+  REQUIRE(img_data_view.is_planar());
+  REQUIRE(img_data_view.is_packed());
+  REQUIRE(img_data_view.stride_bytes() == 64);
+  REQUIRE(*img_data_view.plane_byte_ptr(1) == 2);
+
+  // Interleaved (re)allocation resets the layout
+  img_data.allocate(30_px, 20_px, 3, 2);
+  REQUIRE(!img_data.is_planar());
+  REQUIRE(img_data.row_bytes() == 180);
+  REQUIRE(img_data.total_bytes() == 180 * 20);
+
+  img_data.clear();
+  REQUIRE(img_data.channel_layout() == sln::ChannelLayout::Interleaved);
+}
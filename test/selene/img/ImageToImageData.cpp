@@ -4,8 +4,11 @@
 
 #include <catch.hpp>
 
+#include <selene/base/PoolMemoryResource.hpp>
+
 #include <selene/img/Image.hpp>
 #include <selene/img/ImageData.hpp>
+#include <selene/img/ImageDataToImage.hpp>
 #include <selene/img/ImageToImageData.hpp>
 
 using namespace sln::literals;
@@ -111,3 +114,26 @@ TEST_CASE("Converting Image<> to ImageData", "[img]")
     }
   }
 }
+
+TEST_CASE("Converting Image<> to ImageData and back, retaining the memory resource", "[img]")
+{
+  sln::PoolMemoryResource pool;
+  sln::Image_8u3 img(20_px, 10_px, sln::Stride{0}, pool);
+  img.fill(sln::Pixel_8u3(10, 20, 30));
+  const auto data = img.byte_ptr();
+
+  auto img_data = sln::to_image_data(std::move(img), sln::PixelFormat::RGB);
+  REQUIRE(!img_data.is_view());
+  REQUIRE(img_data.byte_ptr() == data);
+  REQUIRE(&img_data.memory_resource() == &pool);
+
+  auto img_back = sln::to_image<sln::Pixel_8u3>(std::move(img_data));
+  REQUIRE(!img_back.is_view());
+  REQUIRE(img_back.byte_ptr() == data);
+  REQUIRE(&img_back.memory_resource() == &pool);
+  REQUIRE(img_back(19_idx, 9_idx) == sln::Pixel_8u3(10, 20, 30));
+
+  img_back.clear();
+  REQUIRE(pool.nr_allocations() == 1);
+  REQUIRE(pool.nr_pooled_blocks() == 1);
+}
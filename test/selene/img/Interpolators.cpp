@@ -40,6 +40,36 @@ TEST_CASE("Image interpolators, 8u1", "[img]")
     REQUIRE(sln::ImageInterpolator<sln::ImageInterpolationMode::Bilinear>::interpolate(img, 1.8, 1.6) == Approx(76.0));
   }
 
+  SECTION("Bilinear, fixed point")
+  {
+    using FixedInterpolator = sln::ImageInterpolator<sln::ImageInterpolationMode::Bilinear,
+                                                     sln::BorderAccessMode::Unchecked,
+                                                     sln::InterpolationPrecision::FixedPoint>;
+    REQUIRE(FixedInterpolator::interpolate(img, 0.0, 0.0) == 10);
+    REQUIRE(FixedInterpolator::interpolate(img, 0.51, 0.0) == 15);
+    REQUIRE(FixedInterpolator::interpolate(img, 1.11, 0.88) == 47);
+    REQUIRE(FixedInterpolator::interpolate(img, 1.8, 1.6) == 76);
+
+    using FixedInterpolatorReplicated = sln::ImageInterpolator<sln::ImageInterpolationMode::Bilinear,
+                                                               sln::BorderAccessMode::Replicated,
+                                                               sln::InterpolationPrecision::FixedPoint>;
+    REQUIRE(FixedInterpolatorReplicated::interpolate(img, -2.0, 1.0) == 40);
+    REQUIRE(FixedInterpolatorReplicated::interpolate(img, 2.5, 2.5) == 90);
+    REQUIRE(FixedInterpolatorReplicated::interpolate(img, -0.5, 0.0) == 10);
+
+    // Results are within rounding distance of the floating point interpolation.
+    for (double y = 0.0; y < 3.0; y += 0.1)
+    {
+      for (double x = 0.0; x < 3.0; x += 0.07)
+      {
+        const auto value_fixed = FixedInterpolatorReplicated::interpolate(img, x, y);
+        const auto value_float = sln::ImageInterpolator<sln::ImageInterpolationMode::Bilinear,
+                                                        sln::BorderAccessMode::Replicated>::interpolate(img, x, y);
+        REQUIRE(double(value_fixed) == Approx(value_float).margin(0.51));
+      }
+    }
+  }
+
   SECTION("Bilinear, relative access")
   {
     auto r_img = sln::relative_accessor(img, 1_idx, 1_idx);
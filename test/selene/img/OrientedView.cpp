@@ -0,0 +1,284 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch.hpp>
+
+#include <selene/img/BorderAccessors.hpp>
+#include <selene/img/Image.hpp>
+#include <selene/img/Interpolators.hpp>
+#include <selene/img/OrientedView.hpp>
+
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Resample.hpp>
+#include <selene/img_ops/Transformations.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <utility>
+
+#include <test/selene/img/_TestImages.hpp>
+
+using namespace sln::literals;
+
+namespace {
+
+constexpr sln::ImageOrientation all_orientations[] = {
+    sln::ImageOrientation::Identity,     sln::ImageOrientation::FlipHorizontal, sln::ImageOrientation::Clockwise180,
+    sln::ImageOrientation::FlipVertical, sln::ImageOrientation::Transpose,      sln::ImageOrientation::Clockwise90,
+    sln::ImageOrientation::Transverse,   sln::ImageOrientation::Clockwise270};
+
+// Materializes the orientation using the (independently tested) flip, rotate and transpose functions.
+template <typename PixelType>
+sln::Image<PixelType> reference_orientation(const sln::Image<PixelType>& img, sln::ImageOrientation orientation)
+{
+  switch (orientation)
+  {
+    case sln::ImageOrientation::Identity: return sln::clone(img);
+    case sln::ImageOrientation::FlipHorizontal: return sln::flip<sln::FlipDirection::Horizontal>(img);
+    case sln::ImageOrientation::Clockwise180: return sln::rotate<sln::RotationDirection::Clockwise180>(img);
+    case sln::ImageOrientation::FlipVertical: return sln::flip<sln::FlipDirection::Vertical>(img);
+    case sln::ImageOrientation::Transpose: return sln::transpose(img);
+    case sln::ImageOrientation::Clockwise90: return sln::rotate<sln::RotationDirection::Clockwise90>(img);
+    case sln::ImageOrientation::Transverse:
+      return sln::rotate<sln::RotationDirection::Clockwise180>(sln::transpose(img));
+    case sln::ImageOrientation::Clockwise270: return sln::rotate<sln::RotationDirection::Clockwise270>(img);
+  }
+  return sln::Image<PixelType>{};
+}
+
+template <typename PixelType>
+void check_view_equals(const sln::OrientedView<PixelType>& view, const sln::Image<PixelType>& img)
+{
+  REQUIRE(view.width() == img.width());
+  REQUIRE(view.height() == img.height());
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      REQUIRE(view(x, y) == img(x, y));
+    }
+  }
+}
+
+template <sln::ImageInterpolationMode mode,
+          sln::InterpolationPrecision precision = sln::InterpolationPrecision::FloatingPoint>
+void check_resample_exact(const sln::OrientedView<sln::Pixel_8u3>& view,
+                          const sln::Image_8u3& img,
+                          sln::PixelLength width,
+                          sln::PixelLength height,
+                          sln::ThreadPool& thread_pool)
+{
+  const auto img_ref = sln::resample<mode, precision>(img, width, height);
+  REQUIRE((sln::resample<mode, precision>(view, width, height) == img_ref));
+  REQUIRE((sln::resample<mode, precision>(view, width, height, thread_pool) == img_ref));
+}
+
+template <sln::ImageInterpolationMode mode>
+void check_resample_close(const sln::OrientedView<sln::Pixel_8u3>& view,
+                          const sln::Image_8u3& img,
+                          sln::PixelLength width,
+                          sln::PixelLength height,
+                          sln::ThreadPool& thread_pool)
+{
+  const auto img_ref = sln::resample<mode>(img, width, height);
+  const auto img_view = sln::resample<mode>(view, width, height);
+  REQUIRE(img_view.width() == width);
+  REQUIRE(img_view.height() == height);
+  REQUIRE((sln::resample<mode>(view, width, height, thread_pool) == img_view));
+
+  for (auto y = 0_idx; y < height; ++y)
+  {
+    for (auto x = 0_idx; x < width; ++x)
+    {
+      for (std::size_t c = 0; c < 3; ++c)
+      {
+        REQUIRE(std::abs(int{img_view(x, y)[c]} - int{img_ref(x, y)[c]}) <= 1);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Oriented view, orientations", "[img]")
+{
+  std::mt19937 rng(42);
+  const auto img = sln_test::make_random_image<sln::Pixel_8u3>(13_px, 7_px, rng);
+
+  for (const auto orientation : all_orientations)
+  {
+    const auto view = sln::oriented_view(img, orientation);
+    const auto img_ref = reference_orientation(img, orientation);
+    REQUIRE(view.orientation() == orientation);
+    REQUIRE(!view.is_empty());
+    REQUIRE(sln::orientation_swaps_extents(orientation) == (view.width() != img.width()));
+    check_view_equals(view, img_ref);
+    REQUIRE((sln::clone(view) == img_ref));
+
+    for (auto y = 0_idx; y < view.height(); ++y)
+    {
+      const auto row = reinterpret_cast<const std::uint8_t*>(view.row_origin(y));
+      for (auto x = 0_idx; x < view.width(); ++x)
+      {
+        const auto px = reinterpret_cast<const sln::Pixel_8u3*>(row + x * view.pixel_step_bytes());
+        REQUIRE(*px == img_ref(x, y));
+      }
+    }
+  }
+
+  REQUIRE(sln::OrientedView<sln::Pixel_8u3>{}.is_empty());
+}
+
+TEST_CASE("Oriented view, composition", "[img]")
+{
+  std::mt19937 rng(42);
+  const auto img = sln_test::make_random_image<sln::Pixel_8u1>(5_px, 3_px, rng);
+
+  for (const auto first : all_orientations)
+  {
+    const auto view_first = sln::oriented_view(img, first);
+    for (const auto second : all_orientations)
+    {
+      const auto view = sln::oriented_view(view_first, second);
+      REQUIRE(view.orientation() == sln::compose_orientations(first, second));
+      check_view_equals(view, reference_orientation(reference_orientation(img, first), second));
+    }
+  }
+
+  REQUIRE(sln::compose_orientations(sln::ImageOrientation::Clockwise90, sln::ImageOrientation::Clockwise90)
+          == sln::ImageOrientation::Clockwise180);
+  REQUIRE(sln::compose_orientations(sln::ImageOrientation::Clockwise90, sln::ImageOrientation::Clockwise270)
+          == sln::ImageOrientation::Identity);
+  REQUIRE(sln::compose_orientations(sln::ImageOrientation::FlipHorizontal, sln::ImageOrientation::FlipVertical)
+          == sln::ImageOrientation::Clockwise180);
+}
+
+TEST_CASE("Oriented view, EXIF orientation", "[img]")
+{
+  REQUIRE(sln::orientation_from_exif(1) == sln::ImageOrientation::Identity);
+  REQUIRE(sln::orientation_from_exif(2) == sln::ImageOrientation::FlipHorizontal);
+  REQUIRE(sln::orientation_from_exif(3) == sln::ImageOrientation::Clockwise180);
+  REQUIRE(sln::orientation_from_exif(4) == sln::ImageOrientation::FlipVertical);
+  REQUIRE(sln::orientation_from_exif(5) == sln::ImageOrientation::Transpose);
+  REQUIRE(sln::orientation_from_exif(6) == sln::ImageOrientation::Clockwise90);
+  REQUIRE(sln::orientation_from_exif(7) == sln::ImageOrientation::Transverse);
+  REQUIRE(sln::orientation_from_exif(8) == sln::ImageOrientation::Clockwise270);
+  REQUIRE(sln::orientation_from_exif(0) == sln::ImageOrientation::Identity);
+  REQUIRE(sln::orientation_from_exif(9) == sln::ImageOrientation::Identity);
+}
+
+TEST_CASE("Oriented view, cropping", "[img]")
+{
+  std::mt19937 rng(42);
+  const auto img = sln_test::make_random_image<sln::Pixel_8u3>(17_px, 11_px, rng);
+
+  for (const auto orientation : all_orientations)
+  {
+    const auto img_ref = reference_orientation(img, orientation);
+    std::uniform_int_distribution<sln::PixelIndex::value_type> dist_x(0, img_ref.width() - 1);
+    std::uniform_int_distribution<sln::PixelIndex::value_type> dist_y(0, img_ref.height() - 1);
+
+    for (int i = 0; i < 20; ++i)
+    {
+      const auto x0 = sln::PixelIndex{dist_x(rng)};
+      const auto y0 = sln::PixelIndex{dist_y(rng)};
+      const auto w = sln::PixelLength{std::uniform_int_distribution<int>(1, img_ref.width() - x0)(rng)};
+      const auto h = sln::PixelLength{std::uniform_int_distribution<int>(1, img_ref.height() - y0)(rng)};
+
+      auto view = sln::oriented_view(img, orientation);
+      sln::crop(view, x0, y0, w, h);
+      REQUIRE(view.image().stride_bytes() == img.stride_bytes());
+      check_view_equals(view, sln::clone(img_ref, x0, y0, w, h));
+
+      // Cropping and re-orienting do not copy any pixel data.
+      const auto view_rotated = sln::oriented_view(view, sln::ImageOrientation::Clockwise90);
+      REQUIRE(view_rotated.image().byte_ptr() == view.image().byte_ptr());
+      check_view_equals(view_rotated,
+                        reference_orientation(sln::clone(img_ref, x0, y0, w, h), sln::ImageOrientation::Clockwise90));
+    }
+  }
+}
+
+TEST_CASE("Oriented view, border accessors and interpolators", "[img]")
+{
+  std::mt19937 rng(42);
+  const auto img = sln_test::make_random_image<sln::Pixel_8u3>(9_px, 6_px, rng);
+
+  for (const auto orientation : all_orientations)
+  {
+    const auto view = sln::oriented_view(img, orientation);
+    const auto img_ref = reference_orientation(img, orientation);
+
+    for (auto y = -2_idx; y < img_ref.height() + 2; ++y)
+    {
+      for (auto x = -2_idx; x < img_ref.width() + 2; ++x)
+      {
+        REQUIRE(sln::ImageBorderAccessor<sln::BorderAccessMode::ZeroPadding>::access(view, x, y)
+                == sln::ImageBorderAccessor<sln::BorderAccessMode::ZeroPadding>::access(img_ref, x, y));
+        REQUIRE(sln::ImageBorderAccessor<sln::BorderAccessMode::Replicated>::access(view, x, y)
+                == sln::ImageBorderAccessor<sln::BorderAccessMode::Replicated>::access(img_ref, x, y));
+      }
+    }
+
+    using Bilinear = sln::ImageInterpolator<sln::ImageInterpolationMode::Bilinear, sln::BorderAccessMode::Replicated>;
+    using BilinearFixed = sln::ImageInterpolator<sln::ImageInterpolationMode::Bilinear,
+                                                 sln::BorderAccessMode::Replicated,
+                                                 sln::InterpolationPrecision::FixedPoint>;
+    std::uniform_real_distribution<double> dist_x(0.0, img_ref.width());
+    std::uniform_real_distribution<double> dist_y(0.0, img_ref.height());
+    for (int i = 0; i < 50; ++i)
+    {
+      const auto x = dist_x(rng);
+      const auto y = dist_y(rng);
+      REQUIRE(Bilinear::interpolate(view, x, y) == Bilinear::interpolate(img_ref, x, y));
+      REQUIRE(BilinearFixed::interpolate(view, x, y) == BilinearFixed::interpolate(img_ref, x, y));
+    }
+  }
+}
+
+TEST_CASE("Oriented view, resampling", "[img]")
+{
+  std::mt19937 rng(42);
+  sln::ThreadPool thread_pool(2);
+  const auto img = sln_test::make_random_image<sln::Pixel_8u3>(40_px, 30_px, rng);
+
+  for (const auto orientation : all_orientations)
+  {
+    auto view = sln::oriented_view(img, orientation);
+    sln::crop(view, 3_idx, 2_idx, sln::PixelLength{view.width() - 7}, sln::PixelLength{view.height() - 4});
+    const auto img_ref = sln::clone(view);
+
+    for (const auto& size : {std::make_pair(11, 9), std::make_pair(50, 61)})
+    {
+      const auto width = sln::to_pixel_length(size.first);
+      const auto height = sln::to_pixel_length(size.second);
+      check_resample_exact<sln::ImageInterpolationMode::NearestNeighbor>(view, img_ref, width, height, thread_pool);
+      check_resample_exact<sln::ImageInterpolationMode::Bilinear>(view, img_ref, width, height, thread_pool);
+      check_resample_exact<sln::ImageInterpolationMode::Bilinear, sln::InterpolationPrecision::FixedPoint>(
+          view, img_ref, width, height, thread_pool);
+      check_resample_close<sln::ImageInterpolationMode::Area>(view, img_ref, width, height, thread_pool);
+      check_resample_close<sln::ImageInterpolationMode::Bicubic>(view, img_ref, width, height, thread_pool);
+      check_resample_close<sln::ImageInterpolationMode::Lanczos3>(view, img_ref, width, height, thread_pool);
+    }
+  }
+}
+
+TEST_CASE("Oriented view, pixel transformation", "[img]")
+{
+  std::mt19937 rng(42);
+  sln::ThreadPool thread_pool(2);
+  const auto img = sln_test::make_random_image<sln::Pixel_8u3>(23_px, 14_px, rng);
+  const auto op = [](const sln::Pixel_8u3& px) { return sln::Pixel_32f1{px[0] + 2.0f * px[1] - px[2]}; };
+
+  for (const auto orientation : all_orientations)
+  {
+    const auto view = sln::oriented_view(img, orientation);
+    const auto img_ref = sln::transform_pixels<sln::Pixel_32f1>(reference_orientation(img, orientation), op);
+    REQUIRE((sln::transform_pixels<sln::Pixel_32f1>(view, op) == img_ref));
+    REQUIRE((sln::transform_pixels<sln::Pixel_32f1>(view, op, thread_pool) == img_ref));
+  }
+}
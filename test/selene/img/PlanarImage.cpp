@@ -0,0 +1,224 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch.hpp>
+
+#include <selene/base/ArenaMemoryResource.hpp>
+#include <selene/base/Types.hpp>
+#include <selene/img/ImageDataToImage.hpp>
+#include <selene/img/PlanarImage.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+using namespace sln::literals;
+
+namespace {
+
+template <typename T, std::size_t N>
+void fill_with_pattern(sln::PlanarImage<T, N>& img)
+{
+  for (std::size_t c = 0; c < N; ++c)
+  {
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img.width(); ++x)
+      {
+        img(x, y, c) = static_cast<T>(100 * c + 10 * y + x);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST_CASE("Planar image construction", "[img]")
+{
+  sln::PlanarImage_8u3 img(10_px, 5_px);
+  REQUIRE(img.width() == 10_px);
+  REQUIRE(img.height() == 5_px);
+  REQUIRE(img.stride_bytes() == 10);
+  REQUIRE(img.row_bytes() == 10);
+  REQUIRE(img.plane_bytes() == 50);
+  REQUIRE(img.total_bytes() == 150);
+  REQUIRE(img.is_packed());
+  REQUIRE(!img.is_view());
+  REQUIRE(!img.is_empty());
+  REQUIRE(img.is_valid());
+
+  // Planes are stored consecutively
+  REQUIRE(img.byte_ptr(1) == img.byte_ptr(0) + 50);
+  REQUIRE(img.byte_ptr(2) == img.byte_ptr(0) + 100);
+  REQUIRE(img.byte_ptr(1, 2_idx) == img.byte_ptr(1) + 20);
+
+  fill_with_pattern(img);
+  REQUIRE(img(3_idx, 4_idx, 0) == 43);
+  REQUIRE(img(3_idx, 4_idx, 2) == 243);
+  REQUIRE(img.pixel(3_idx, 4_idx) == sln::Pixel_8u3(43, 143, 243));
+
+  const auto plane = img.plane(1);
+  REQUIRE(plane.is_view());
+  REQUIRE(plane.width() == 10_px);
+  REQUIRE(plane.height() == 5_px);
+  REQUIRE(plane(3_idx, 4_idx) == 143);
+
+  img.fill(sln::Pixel_8u3(1, 2, 3));
+  REQUIRE(img.pixel(0_idx, 0_idx) == sln::Pixel_8u3(1, 2, 3));
+  REQUIRE(img.pixel(9_idx, 4_idx) == sln::Pixel_8u3(1, 2, 3));
+
+  img.clear();
+  REQUIRE(img.is_empty());
+  REQUIRE(img.total_bytes() == 0);
+
+  sln::PlanarImage_16u4 img_16u(7_px, 3_px, sln::Stride{32});
+  REQUIRE(img_16u.stride_bytes() == 32);
+  REQUIRE(img_16u.row_bytes() == 14);
+  REQUIRE(!img_16u.is_packed());
+  REQUIRE(img_16u.byte_ptr(3) == img_16u.byte_ptr(0) + 3 * 32 * 3);
+}
+
+TEST_CASE("Planar image copy, move, and views", "[img]")
+{
+  sln::PlanarImage_32f3 img(6_px, 4_px, sln::Stride{40});
+  fill_with_pattern(img);
+
+  auto img_copy = img;
+  REQUIRE(!img_copy.is_view());
+  REQUIRE(img_copy.byte_ptr(0) != img.byte_ptr(0));
+  REQUIRE(img_copy == img);
+
+  img_copy(2_idx, 2_idx, 1) = -1.0f;
+  REQUIRE(img_copy != img);
+
+  // Copy assignment reuses an existing allocation of the same size
+  const auto ptr_copy = img_copy.byte_ptr(0);
+  img_copy = img;
+  REQUIRE(img_copy == img);
+  REQUIRE(img_copy.byte_ptr(0) == ptr_copy);
+
+  sln::PlanarImage_32f3 img_other(3_px, 2_px);
+  img_other = img;
+  REQUIRE(img_other == img);
+  REQUIRE(img_other.stride_bytes() == img.stride_bytes());
+  REQUIRE(img_other.byte_ptr(0) != img.byte_ptr(0));
+
+  // Empty images are equal to each other, but not to a non-empty image
+  sln::PlanarImage_32f3 img_empty_0, img_empty_1;
+  REQUIRE(img_empty_0 == img_empty_1);
+  REQUIRE(img_empty_0 != img);
+  REQUIRE(img != img_empty_0);
+
+  const auto img_empty_view = sln::view(img_empty_0);
+  REQUIRE(img_empty_view.is_empty());
+  REQUIRE(img_empty_view == img_empty_0);
+
+  auto img_view = sln::view(img);
+  REQUIRE(img_view.is_view());
+  REQUIRE(img_view.byte_ptr(2) == img.byte_ptr(2));
+  REQUIRE(img_view == img);
+
+  const auto img_view_copy = img_view;
+  REQUIRE(img_view_copy.is_view());
+  REQUIRE(img_view_copy.byte_ptr(0) == img.byte_ptr(0));
+
+  const auto ptr = img_copy.byte_ptr(0);
+  const auto img_moved = std::move(img_copy);
+  REQUIRE(img_moved.byte_ptr(0) == ptr);
+  REQUIRE(img_copy.is_empty());
+
+  // Views onto arbitrary plane locations
+  std::vector<std::uint8_t> r(12, 1), g(12, 2), b(12, 3);
+  sln::PlanarImage_8u3 img_ext({{r.data(), g.data(), b.data()}}, 4_px, 3_px);
+  REQUIRE(img_ext.is_view());
+  REQUIRE(img_ext.pixel(3_idx, 2_idx) == sln::Pixel_8u3(1, 2, 3));
+
+  // Allocating from a view is allowed, but not resizing it via maybe_allocate()
+  REQUIRE_THROWS(img_ext.maybe_allocate(5_px, 3_px));
+  img_ext.allocate(5_px, 3_px);
+  REQUIRE(!img_ext.is_view());
+  REQUIRE(r[0] == 1);
+}
+
+TEST_CASE("Planar image allocation", "[img]")
+{
+  sln::ArenaMemoryResource arena;
+
+  sln::PlanarImage_8u4 img(arena);
+  img.allocate(100_px, 50_px);
+  REQUIRE(&img.memory_resource() == &arena);
+  REQUIRE(img.total_bytes() == 100 * 50 * 4);
+
+  // No reallocation, if the size matches
+  const auto ptr = img.byte_ptr(0);
+  img.allocate(50_px, 100_px);
+  REQUIRE(img.byte_ptr(0) == ptr);
+  REQUIRE(img.byte_ptr(3) == ptr + 3 * 50 * 100);
+
+  sln::PlanarImage_8u3 img_padded(33_px, 7_px, sln::ImageLayout::SimdPadded);
+  REQUIRE(img_padded.simd_safe_tail());
+  REQUIRE(img_padded.stride_bytes() % sln::simd_vector_bytes == 0);
+  REQUIRE(img_padded.stride_bytes() >= img_padded.row_bytes() + sln::simd_vector_bytes);
+
+  for (std::size_t c = 0; c < 3; ++c)
+  {
+    REQUIRE(reinterpret_cast<std::uintptr_t>(img_padded.byte_ptr(c)) % sln::simd_vector_bytes == 0);
+  }
+
+  REQUIRE(!sln::view(img_padded).simd_safe_tail());
+  REQUIRE(!sln::PlanarImage_8u3(33_px, 7_px).simd_safe_tail());
+}
+
+TEST_CASE("Planar image to/from image data", "[img]")
+{
+  sln::PlanarImage_16u3 img(9_px, 4_px);
+  fill_with_pattern(img);
+  const auto img_ref = img;
+  const auto ptr = img.byte_ptr(0);
+
+  auto img_data = sln::to_image_data(std::move(img), sln::PixelFormat::RGB);
+  REQUIRE(img.is_empty());
+  REQUIRE(img_data.is_planar());
+  REQUIRE(!img_data.is_view());
+  REQUIRE(img_data.byte_ptr() == ptr);
+  REQUIRE(img_data.nr_channels() == 3);
+  REQUIRE(img_data.nr_bytes_per_channel() == 2);
+  REQUIRE(img_data.total_bytes() == img_ref.total_bytes());
+  REQUIRE(img_data.pixel_format() == sln::PixelFormat::RGB);
+  REQUIRE(img_data.sample_format() == sln::SampleFormat::UnsignedInteger);
+
+  // Planar image data cannot be interpreted as interleaved image
+  REQUIRE_THROWS(sln::to_image_view<sln::Pixel_16u3>(img_data));
+  REQUIRE_THROWS((sln::to_planar_image_view<std::uint16_t, 4>(img_data)));
+  REQUIRE_THROWS((sln::to_planar_image_view<std::uint8_t, 3>(img_data)));
+
+  const auto img_view = sln::to_planar_image_view<std::uint16_t, 3>(img_data);
+  REQUIRE(img_view.is_view());
+  REQUIRE(img_view == img_ref);
+
+  const auto img_back = sln::to_planar_image<std::uint16_t, 3>(std::move(img_data));
+  REQUIRE(!img_back.is_view());
+  REQUIRE(img_back.byte_ptr(0) == ptr);
+  REQUIRE(img_back == img_ref);
+
+  // Image data that a decoder wrote to directly, plane by plane
+  sln::ImageData<> img_data_dec;
+  img_data_dec.allocate_planar(5_px, 2_px, 3, 1);
+  for (std::uint16_t c = 0; c < 3; ++c)
+  {
+    std::fill(img_data_dec.plane_byte_ptr(c), img_data_dec.plane_byte_ptr(c) + 10, std::uint8_t(10 * c));
+  }
+
+  const auto img_dec = sln::to_planar_image<std::uint8_t, 3>(std::move(img_data_dec));
+  REQUIRE(img_dec.pixel(4_idx, 1_idx) == sln::Pixel_8u3(0, 10, 20));
+
+  // Interleaved image data cannot be interpreted as planar image
+  sln::ImageData<> img_data_il(5_px, 2_px, 3, 1);
+  REQUIRE_THROWS((sln::to_planar_image_view<std::uint8_t, 3>(img_data_il)));
+
+  // Views with non-consecutive planes cannot be described by image data
+  std::vector<std::uint8_t> r(12), g(12), b(12);
+  REQUIRE_THROWS(sln::to_image_data(sln::PlanarImage_8u3({{r.data(), g.data(), b.data()}}, 4_px, 3_px),
+                                    sln::PixelFormat::Unknown));
+}
@@ -0,0 +1,353 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <selene/base/MessageLog.hpp>
+
+#include <selene/img/ImageBufferPool.hpp>
+#include <selene/img_io/DecoderPool.hpp>
+#include <selene/img_io/IO.hpp>
+
+#include <selene/io/FileReader.hpp>
+#include <selene/io/FileUtils.hpp>
+#include <selene/io/MMapReader.hpp>
+#include <selene/io/MemoryReader.hpp>
+
+#include <selene/thread/Parallel.hpp>
+#include <selene/thread/ThreadPool.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace fs = boost::filesystem;
+using namespace sln::literals;
+
+constexpr auto ref_width = 1024;
+constexpr auto ref_height = 684;
+
+namespace {
+
+fs::path full_path(const char* filename)
+{
+  const auto env_var = std::getenv("SELENE_DATA_PATH");
+  return (env_var) ? (fs::path(env_var) / fs::path(filename)) : (fs::path("../data") / fs::path(filename));
+}
+
+bool equal_contents(const sln::ImageData<>& a, const sln::ImageData<>& b)
+{
+  if (a.width() != b.width() || a.height() != b.height() || a.nr_channels() != b.nr_channels()
+      || a.nr_bytes_per_channel() != b.nr_bytes_per_channel() || a.pixel_format() != b.pixel_format())
+  {
+    return false;
+  }
+
+  const auto row_bytes = a.width() * a.nr_channels() * a.nr_bytes_per_channel();
+  for (auto y = 0_idx; y < a.height(); ++y)
+  {
+    if (std::memcmp(a.byte_ptr(y), b.byte_ptr(y), row_bytes) != 0)
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+#if defined(SELENE_WITH_LIBPNG)
+int nr_custom_pooled_reads = 0;
+
+sln::PooledImageData custom_pooled_read(sln::MemoryReader& source,
+                                        sln::DecoderPool& decoder_pool,
+                                        sln::ImageBufferPool& buffer_pool,
+                                        sln::MessageLog* messages)
+{
+  ++nr_custom_pooled_reads;
+  auto obj = decoder_pool.png().acquire();
+  return sln::read_png(*obj, source, buffer_pool, sln::PNGDecompressionOptions(), messages);
+}
+#endif  // defined(SELENE_WITH_LIBPNG)
+
+}  // namespace
+
+TEST_CASE("Decompression object pool", "[img]")
+{
+  sln::DecoderPool decoder_pool(2);
+
+#if defined(SELENE_WITH_LIBJPEG)
+  auto& jpeg_pool = decoder_pool.jpeg();
+  REQUIRE(jpeg_pool.nr_pooled_objects() == 2);
+  REQUIRE(jpeg_pool.nr_constructed_objects() == 2);
+
+  {
+    auto obj0 = jpeg_pool.acquire();
+    auto obj1 = jpeg_pool.acquire();
+    auto obj2 = jpeg_pool.acquire();
+    REQUIRE(obj0.get() != nullptr);
+    REQUIRE(obj0->valid());
+    REQUIRE(obj0.get() != obj1.get());
+    REQUIRE(obj1.get() != obj2.get());
+    REQUIRE(jpeg_pool.nr_pooled_objects() == 0);
+    REQUIRE(jpeg_pool.nr_constructed_objects() == 3);
+
+    const auto ptr = obj2.get();
+    auto obj_moved = std::move(obj2);
+    REQUIRE(obj2.get() == nullptr);
+    REQUIRE(obj_moved.get() == ptr);
+
+    obj_moved.reset();
+    REQUIRE(jpeg_pool.nr_pooled_objects() == 1);
+  }
+
+  REQUIRE(jpeg_pool.nr_pooled_objects() == 3);
+  REQUIRE(jpeg_pool.nr_constructed_objects() == 3);
+#endif  // defined(SELENE_WITH_LIBJPEG)
+
+#if defined(SELENE_WITH_LIBPNG)
+  auto& png_pool = decoder_pool.png();
+  REQUIRE(png_pool.nr_pooled_objects() == 2);
+
+  {
+    auto obj = png_pool.acquire();
+    REQUIRE(obj->valid());
+    REQUIRE(png_pool.nr_pooled_objects() == 1);
+  }
+
+  REQUIRE(png_pool.nr_pooled_objects() == 2);
+  REQUIRE(png_pool.nr_constructed_objects() == 2);
+#endif  // defined(SELENE_WITH_LIBPNG)
+}
+
+#if defined(SELENE_WITH_LIBJPEG)
+TEST_CASE("Pooled JPEG image reading", "[img]")
+{
+  const auto path = full_path("bike_duck.jpg").string();
+  const auto ref_img = sln::read_jpeg(sln::FileReader(path));
+  REQUIRE(ref_img.is_valid());
+
+  sln::DecoderPool decoder_pool;
+  sln::ImageBufferPool buffer_pool;
+  auto obj = decoder_pool.jpeg().acquire();
+
+  // Reuse the same decompression object for different kinds of sources, and after partial or failed reads
+  const auto file_contents = sln::read_file_contents(path);
+
+  for (int i = 0; i < 3; ++i)
+  {
+    {
+      auto img = sln::read_jpeg(*obj, sln::FileReader(path), buffer_pool);
+      REQUIRE(img.is_valid());
+      REQUIRE(img.image_data().width() == ref_width);
+      REQUIRE(img.image_data().height() == ref_height);
+      REQUIRE(equal_contents(img.image_data(), ref_img));
+    }
+
+    {
+      auto img = sln::read_jpeg(*obj, sln::MemoryReader(file_contents.data(), file_contents.size()), buffer_pool);
+      REQUIRE(img.is_valid());
+      REQUIRE(equal_contents(img.image_data(), ref_img));
+    }
+
+    const auto header = sln::read_jpeg_header(*obj, sln::MemoryReader(file_contents.data(), file_contents.size()));
+    REQUIRE(header.is_valid());
+
+    {
+      auto img = sln::read_jpeg(*obj, sln::MMapReader(path), buffer_pool);
+      REQUIRE(img.is_valid());
+      REQUIRE(equal_contents(img.image_data(), ref_img));
+    }
+
+    {
+      // Truncated data
+      sln::MessageLog messages;
+      auto img = sln::read_jpeg(*obj, sln::MemoryReader(file_contents.data(), 1000), buffer_pool,
+                                sln::JPEGDecompressionOptions(), &messages);
+      REQUIRE(!img.is_valid());
+      REQUIRE(!messages.messages().empty());
+    }
+  }
+
+  // One output buffer suffices for the sequential reads
+  REQUIRE(buffer_pool.nr_allocations() == 1);
+  REQUIRE(buffer_pool.nr_pooled_buffers() == 1);
+
+  // Decompression options are respected
+  const auto img_gray = sln::read_jpeg(*obj, sln::FileReader(path), buffer_pool,
+                                       sln::JPEGDecompressionOptions(sln::JPEGColorSpace::Grayscale));
+  REQUIRE(img_gray.is_valid());
+  REQUIRE(img_gray.image_data().nr_channels() == 1);
+  REQUIRE(img_gray.image_data().pixel_format() == sln::PixelFormat::Y);
+}
+#endif  // defined(SELENE_WITH_LIBJPEG)
+
+#if defined(SELENE_WITH_LIBPNG)
+TEST_CASE("Pooled PNG image reading", "[img]")
+{
+  const auto path = full_path("bike_duck.png").string();
+  const auto ref_img = sln::read_png(sln::FileReader(path));
+  REQUIRE(ref_img.is_valid());
+
+  sln::DecoderPool decoder_pool;
+  sln::ImageBufferPool buffer_pool;
+  auto obj = decoder_pool.png().acquire();
+
+  const auto file_contents = sln::read_file_contents(path);
+
+  for (int i = 0; i < 3; ++i)
+  {
+    {
+      auto img = sln::read_png(*obj, sln::FileReader(path), buffer_pool);
+      REQUIRE(img.is_valid());
+      REQUIRE(img.image_data().width() == ref_width);
+      REQUIRE(img.image_data().height() == ref_height);
+      REQUIRE(equal_contents(img.image_data(), ref_img));
+    }
+
+    const auto header = sln::read_png_header(*obj, sln::FileReader(path));
+    REQUIRE(header.is_valid());
+
+    {
+      auto img = sln::read_png(*obj, sln::MemoryReader(file_contents.data(), file_contents.size()), buffer_pool);
+      REQUIRE(img.is_valid());
+      REQUIRE(equal_contents(img.image_data(), ref_img));
+    }
+
+    {
+      // Not a PNG stream
+      const std::vector<std::uint8_t> invalid_data(100, 0x42);
+      auto img = sln::read_png(*obj, sln::MemoryReader(invalid_data.data(), invalid_data.size()), buffer_pool);
+      REQUIRE(!img.is_valid());
+    }
+
+    {
+      auto img = sln::read_png(*obj, sln::MMapReader(path), buffer_pool);
+      REQUIRE(img.is_valid());
+      REQUIRE(equal_contents(img.image_data(), ref_img));
+    }
+  }
+
+  REQUIRE(buffer_pool.nr_allocations() == 1);
+  REQUIRE(buffer_pool.nr_pooled_buffers() == 1);
+}
+#endif  // defined(SELENE_WITH_LIBPNG)
+
+#if defined(SELENE_WITH_LIBJPEG) && defined(SELENE_WITH_LIBPNG)
+TEST_CASE("Pooled image reading with automatic format selection", "[img]")
+{
+  const std::vector<std::string> paths = {full_path("bike_duck.jpg").string(), full_path("bike_duck.png").string()};
+  std::vector<sln::ImageData<>> ref_imgs;
+  for (const auto& path : paths)
+  {
+    ref_imgs.push_back(sln::read_image(sln::FileReader(path)));
+  }
+
+  sln::DecoderPool decoder_pool;
+  sln::ImageBufferPool buffer_pool;
+
+  SECTION("Sequential reading")
+  {
+    for (int i = 0; i < 5; ++i)
+    {
+      for (std::size_t j = 0; j < paths.size(); ++j)
+      {
+        sln::MessageLog messages;
+        const auto img = sln::read_image(sln::FileReader(paths[j]), decoder_pool, buffer_pool, &messages);
+        REQUIRE(img.is_valid());
+        REQUIRE(messages.messages().empty());
+        REQUIRE(equal_contents(img.image_data(), ref_imgs[j]));
+      }
+    }
+
+    REQUIRE(decoder_pool.jpeg().nr_constructed_objects() == 1);
+    REQUIRE(decoder_pool.png().nr_constructed_objects() == 1);
+    REQUIRE(buffer_pool.nr_allocations() == 1);
+
+    // Unsupported data
+    const std::vector<std::uint8_t> invalid_data(100, 0x42);
+    sln::MemoryReader source(invalid_data.data(), invalid_data.size());
+    sln::MessageLog messages;
+    const auto img = sln::read_image(source, decoder_pool, buffer_pool, &messages);
+    REQUIRE(!img.is_valid());
+    REQUIRE(!messages.messages().empty());
+    REQUIRE(source.position() == 0);
+  }
+
+  SECTION("Concurrent reading")
+  {
+    sln::ThreadPool thread_pool(4);
+    const std::size_t nr_reads = 40;
+    std::vector<int> results(nr_reads, 0);
+
+    sln::parallel_for(thread_pool, std::size_t{0}, nr_reads, std::size_t{1}, [&](std::size_t begin, std::size_t end) {
+      for (auto i = begin; i < end; ++i)
+      {
+        const auto img = sln::read_image(sln::FileReader(paths[i % 2]), decoder_pool, buffer_pool);
+        results[i] = img.is_valid() && equal_contents(img.image_data(), ref_imgs[i % 2]);
+      }
+    });
+
+    for (auto result : results)
+    {
+      REQUIRE(result);
+    }
+
+    REQUIRE(decoder_pool.jpeg().nr_constructed_objects() <= thread_pool.size() + 1);
+    REQUIRE(decoder_pool.png().nr_constructed_objects() <= thread_pool.size() + 1);
+    REQUIRE(buffer_pool.nr_allocations() <= thread_pool.size() + 1);
+  }
+}
+#endif  // defined(SELENE_WITH_LIBJPEG) && defined(SELENE_WITH_LIBPNG)
+
+#if defined(SELENE_WITH_LIBPNG)
+TEST_CASE("Pooled image reading through the codec registry", "[img]")
+{
+  using Registry = sln::ImageReaderRegistry<sln::MemoryReader>;
+  auto& registry = Registry::instance();
+  const std::initializer_list<std::uint8_t> png_signature = {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A};
+
+  const auto file_contents = sln::read_file_contents(full_path("bike_duck.png").string());
+  const auto ref_img = sln::read_image(sln::MemoryReader(file_contents.data(), file_contents.size()));
+
+  sln::DecoderPool decoder_pool;
+  sln::ImageBufferPool buffer_pool;
+
+  // Replace the built-in PNG decoder; pooled reading dispatches to the pooled read function of the entry
+  REQUIRE(registry.add(sln::ImageFormat::PNG, png_signature, sln::detail::read_png_default<sln::MemoryReader>,
+                       custom_pooled_read));
+
+  {
+    sln::MemoryReader source(file_contents.data(), file_contents.size());
+    const auto img = sln::read_image(source, decoder_pool, buffer_pool);
+    REQUIRE(img.is_valid());
+    REQUIRE(equal_contents(img.image_data(), ref_img));
+    REQUIRE(nr_custom_pooled_reads == 1);
+  }
+
+  // Decoders registered without a pooled read function are rejected
+  REQUIRE(registry.add(sln::ImageFormat::PNG, png_signature, sln::detail::read_png_default<sln::MemoryReader>));
+
+  {
+    sln::MemoryReader source(file_contents.data(), file_contents.size());
+    sln::MessageLog messages;
+    const auto img = sln::read_image(source, decoder_pool, buffer_pool, &messages);
+    REQUIRE(!img.is_valid());
+    REQUIRE(!messages.messages().empty());
+    REQUIRE(source.position() == 0);
+    REQUIRE(nr_custom_pooled_reads == 1);
+  }
+
+  // Restore the built-in decoder
+  REQUIRE(registry.add(sln::ImageFormat::PNG, png_signature, sln::detail::read_png_default<sln::MemoryReader>,
+                       sln::detail::read_png_pooled_default<sln::MemoryReader>));
+
+  sln::MemoryReader source(file_contents.data(), file_contents.size());
+  REQUIRE(sln::read_image(source, decoder_pool, buffer_pool).is_valid());
+  REQUIRE(nr_custom_pooled_reads == 1);
+}
+#endif  // defined(SELENE_WITH_LIBPNG)
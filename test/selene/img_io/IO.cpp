@@ -8,15 +8,21 @@
 
 #include <selene/base/MessageLog.hpp>
 
+#include <selene/img/PlanarImage.hpp>
+
 #include <selene/img_io/IO.hpp>
 
 #include <selene/io/FileReader.hpp>
+#include <selene/io/FileUtils.hpp>
 #include <selene/io/FileWriter.hpp>
+#include <selene/io/MMapReader.hpp>
+#include <selene/io/MemoryReader.hpp>
 #include <selene/io/VectorWriter.hpp>
 
 #include <test/selene/Utils.hpp>
 
 namespace fs = boost::filesystem;
+using namespace sln::literals;
 
 constexpr auto ref_width = 1024;
 constexpr auto ref_height = 684;
@@ -29,6 +35,16 @@ fs::path full_path(const char* filename)
   return (env_var) ? (fs::path(env_var) / fs::path(filename)) : (fs::path("../data") / fs::path(filename));
 }
 
+#if defined(SELENE_WITH_LIBPNG)
+int nr_custom_reads = 0;
+
+sln::ImageData<> custom_read(sln::MemoryReader& source, sln::MessageLog* messages)
+{
+  ++nr_custom_reads;
+  return sln::read_png(source, sln::PNGDecompressionOptions(), messages);
+}
+#endif  // defined(SELENE_WITH_LIBPNG)
+
 }  // namespace
 
 TEST_CASE("Image reading with automatic format selection", "[img]")
@@ -97,4 +113,121 @@ TEST_CASE("Image reading with automatic format selection", "[img]")
     REQUIRE(status_write);
     REQUIRE(messages_write.messages().empty());
   }
+
+  {
+    // Read the same PNG image from a memory-mapped file
+    sln::MMapReader source((tmp_path / "test_duck_auto.png").string());
+    REQUIRE(source.is_open());
+
+    sln::MessageLog messages;
+    const auto img_data = sln::read_image(source, &messages);
+
+    REQUIRE(messages.messages().empty());
+    REQUIRE(img_data.width() == ref_width);
+    REQUIRE(img_data.height() == ref_height);
+    REQUIRE(img_data.nr_channels() == 3);
+    REQUIRE(img_data.is_valid());
+  }
+
+  {
+    // Read the original JPEG image from a memory-mapped file
+    sln::MMapReader source(full_path("bike_duck.jpg").string());
+    REQUIRE(source.is_open());
+
+    sln::MessageLog messages;
+    const auto img_data = sln::read_image(source, &messages);
+
+    REQUIRE(messages.messages().empty());
+    REQUIRE(img_data.width() == ref_width);
+    REQUIRE(img_data.height() == ref_height);
+    REQUIRE(img_data.nr_channels() == 3);
+    REQUIRE(img_data.is_valid());
+  }
+}
+
+TEST_CASE("Image codec registry", "[img]")
+{
+  using Registry = sln::ImageReaderRegistry<sln::MemoryReader>;
+  auto& registry = Registry::instance();
+  REQUIRE(!registry.empty());
+
+  const std::array<std::uint8_t, 4> jpeg_bytes = {{0xFF, 0xD8, 0xFF, 0xE0}};
+  const std::array<std::uint8_t, 8> png_bytes = {{0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A}};
+  const std::array<std::uint8_t, 4> other_bytes = {{0x42, 0x4D, 0x00, 0x00}};
+
+#if defined(SELENE_WITH_LIBJPEG)
+  REQUIRE(registry.find(jpeg_bytes.data(), jpeg_bytes.size()) != nullptr);
+  REQUIRE(registry.find(jpeg_bytes.data(), jpeg_bytes.size())->format == sln::ImageFormat::JPEG);
+  REQUIRE(registry.find(jpeg_bytes.data(), 2) == nullptr);  // too short for the signature
+#endif
+#if defined(SELENE_WITH_LIBPNG)
+  REQUIRE(registry.find(png_bytes.data(), png_bytes.size()) != nullptr);
+  REQUIRE(registry.find(png_bytes.data(), png_bytes.size())->format == sln::ImageFormat::PNG);
+#endif
+  REQUIRE(registry.find(other_bytes.data(), other_bytes.size()) == nullptr);
+  REQUIRE(!registry.add(sln::ImageFormat::Unknown, {0x42, 0x4D}, [](sln::MemoryReader&, sln::MessageLog*) {
+    return sln::ImageData<>();
+  }));
+
+  {
+    // Unknown formats are rejected without invoking any decoder
+    sln::MemoryReader source(other_bytes.data(), other_bytes.size());
+    sln::MessageLog messages;
+    const auto img_data = sln::read_image(source, &messages);
+    REQUIRE(!img_data.is_valid());
+    REQUIRE(!messages.messages().empty());
+    REQUIRE(source.position() == 0);
+  }
+
+#if defined(SELENE_WITH_LIBPNG)
+  {
+    REQUIRE(!registry.add(sln::ImageFormat::PNG, {}, custom_read));
+
+    // Replace the built-in PNG decoder, and restore it afterwards
+    REQUIRE(registry.add(sln::ImageFormat::PNG, {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A}, custom_read));
+
+    const auto file_contents = sln::read_file_contents(full_path("bike_duck.png").string());
+    sln::MemoryReader source(file_contents.data(), file_contents.size());
+    const auto img_data = sln::read_image(source);
+    REQUIRE(img_data.is_valid());
+    REQUIRE(img_data.width() == ref_width);
+    REQUIRE(nr_custom_reads == 1);
+
+    REQUIRE(registry.add(sln::ImageFormat::PNG, {0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A},
+                         sln::detail::read_png_default<sln::MemoryReader>,
+                         sln::detail::read_png_pooled_default<sln::MemoryReader>));
+    source.rewind();
+    REQUIRE(sln::read_image(source).is_valid());
+    REQUIRE(nr_custom_reads == 1);
+  }
+#endif
+
+  using WriterRegistry = sln::ImageWriterRegistry<sln::VectorWriter>;
+#if defined(SELENE_WITH_LIBJPEG)
+  REQUIRE(WriterRegistry::instance().find(sln::ImageFormat::JPEG) != nullptr);
+#endif
+#if defined(SELENE_WITH_LIBPNG)
+  REQUIRE(WriterRegistry::instance().find(sln::ImageFormat::PNG) != nullptr);
+#endif
+}
+
+TEST_CASE("Image writing, rejecting planar image data", "[img]")
+{
+  sln::PlanarImage_8u3 img(16_px, 8_px);
+  img.fill(sln::Pixel_8u3(10, 20, 30));
+  const auto img_data = sln::to_image_data(std::move(img), sln::PixelFormat::RGB);
+
+  for (const auto format : {sln::ImageFormat::JPEG, sln::ImageFormat::PNG})
+  {
+    if (sln::ImageWriterRegistry<sln::VectorWriter>::instance().find(format) == nullptr)
+    {
+      continue;
+    }
+
+    std::vector<std::uint8_t> buffer;
+    sln::MessageLog messages;
+    REQUIRE(!sln::write_image(img_data, format, sln::VectorWriter(buffer), &messages));
+    REQUIRE(!messages.messages().empty());
+    REQUIRE(buffer.empty());
+  }
 }
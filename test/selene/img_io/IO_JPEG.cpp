@@ -6,13 +6,17 @@
 
 #include <catch.hpp>
 
+#include <algorithm>
 #include <cstdlib>
+#include <cstring>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
 #include <selene/io/FileReader.hpp>
 #include <selene/io/FileUtils.hpp>
 #include <selene/io/FileWriter.hpp>
+#include <selene/io/MMapReader.hpp>
 #include <selene/io/MemoryReader.hpp>
 #include <selene/io/VectorWriter.hpp>
 
@@ -20,6 +24,7 @@
 #include <selene/img/ImageData.hpp>
 #include <selene/img/ImageDataToImage.hpp>
 #include <selene/img/ImageToImageData.hpp>
+#include <selene/img/PlanarImage.hpp>
 #include <selene/img_io/JPEGRead.hpp>
 #include <selene/img_io/JPEGWrite.hpp>
 
@@ -370,6 +375,129 @@ TEST_CASE("JPEG image reading and writing, reading/writing from/to memory", "[im
   REQUIRE(compressed_data.size() > 80000);  // conservative lower bound estimate; should be around 118000
 }
 
+TEST_CASE("JPEG image reading, downscaling during decompression", "[img]")
+{
+  const auto file_contents = sln::read_file_contents(in_filename().string());
+  REQUIRE(!file_contents.empty());
+
+  const auto read_scaled = [&file_contents](const sln::JPEGDecompressionOptions& options) {
+    sln::MessageLog messages;
+    auto img_data = sln::read_jpeg(sln::MemoryReader(file_contents.data(), file_contents.size()), options, &messages);
+    REQUIRE(messages.messages().empty());
+    return img_data;
+  };
+
+  SECTION("Explicit scaling factor")
+  {
+    for (unsigned int scale_denom : {1u, 2u, 4u, 8u})
+    {
+      sln::JPEGDecompressionOptions options;
+      options.scale_denom = scale_denom;
+      const auto img_data = read_scaled(options);
+      REQUIRE(img_data.is_valid());
+      REQUIRE(img_data.width() == static_cast<int>((ref_width + scale_denom - 1) / scale_denom));
+      REQUIRE(img_data.height() == static_cast<int>((ref_height + scale_denom - 1) / scale_denom));
+      REQUIRE(img_data.nr_channels() == 3);
+    }
+  }
+
+  SECTION("Minimum output size")
+  {
+    const auto check_size = [&read_scaled](sln::PixelLength min_width, sln::PixelLength min_height, int exp_width,
+                                           int exp_height) {
+      sln::JPEGDecompressionOptions options;
+      options.min_width = min_width;
+      options.min_height = min_height;
+      const auto img_data = read_scaled(options);
+      REQUIRE(img_data.is_valid());
+      REQUIRE(img_data.width() == exp_width);
+      REQUIRE(img_data.height() == exp_height);
+    };
+
+    check_size(256_px, 0_px, 256, 171);
+    check_size(300_px, 100_px, 512, 342);
+    check_size(0_px, 86_px, 128, 86);
+    check_size(10_px, 10_px, 128, 86);  // at most 1/8
+    check_size(2000_px, 100_px, ref_width, ref_height);  // no upscaling
+  }
+
+  SECTION("Downscaled output equals downscaled reading through JPEGReader")
+  {
+    sln::JPEGDecompressionOptions options;
+    options.min_width = 256_px;
+    const auto img_data = read_scaled(options);
+
+    sln::MemoryReader source(file_contents.data(), file_contents.size());
+    sln::JPEGReader<sln::MemoryReader> reader(source, options);
+    const auto info = reader.get_output_image_info();
+    REQUIRE(info.width == img_data.width());
+    REQUIRE(info.height == img_data.height());
+    const auto img_data_reader = reader.read_image_data();
+    REQUIRE(img_data_reader.is_valid());
+    for (auto y = 0_idx; y < img_data.height(); ++y)
+    {
+      REQUIRE(std::memcmp(img_data.byte_ptr(y), img_data_reader.byte_ptr(y), img_data.width() * 3) == 0);
+    }
+  }
+}
+
+TEST_CASE("JPEG image reading from memory, starting at the current reader position", "[img]")
+{
+  const auto file_contents = sln::read_file_contents(in_filename().string());
+  REQUIRE(!file_contents.empty());
+
+  std::vector<std::uint8_t> data(100, 0x42);
+  data.insert(data.end(), file_contents.cbegin(), file_contents.cend());
+
+  sln::MemoryReader source(data.data(), data.size());
+  source.seek_abs(100);
+  sln::MessageLog messages;
+  const auto img_data = sln::read_jpeg(source, sln::JPEGDecompressionOptions(), &messages);
+  REQUIRE(messages.messages().empty());
+  REQUIRE(img_data.is_valid());
+  REQUIRE(img_data.width() == ref_width);
+  REQUIRE(img_data.height() == ref_height);
+}
+
+TEST_CASE("JPEG image reading from a memory-mapped file", "[img]")
+{
+  sln::MMapReader source(in_filename().string());
+  REQUIRE(source.is_open());
+  REQUIRE(source.size() == fs::file_size(in_filename()));
+
+  const auto header = sln::read_jpeg_header(source, true);
+  REQUIRE(header.is_valid());
+  REQUIRE(header.width == ref_width);
+  REQUIRE(header.height == ref_height);
+  REQUIRE(header.nr_channels == 3);
+
+  REQUIRE(source.position() == 0);
+  sln::MessageLog messages_read;
+  auto img_data = sln::read_jpeg(source, sln::JPEGDecompressionOptions(), &messages_read);
+  REQUIRE(messages_read.messages().empty());
+  REQUIRE(img_data.is_valid());
+
+  // The decoded image has to be identical to the one decoded through the stdio-based FileReader
+  sln::FileReader file_source(in_filename().string());
+  auto img_data_ref = sln::read_jpeg(file_source);
+  REQUIRE(img_data_ref.is_valid());
+  REQUIRE(img_data.width() == img_data_ref.width());
+  REQUIRE(img_data.height() == img_data_ref.height());
+  REQUIRE(img_data.total_bytes() == img_data_ref.total_bytes());
+  REQUIRE(std::memcmp(img_data.byte_ptr(), img_data_ref.byte_ptr(), img_data.total_bytes()) == 0);
+
+  auto img = sln::to_image<sln::Pixel_8u3>(std::move(img_data));
+  for (int i = 0; i < 3; ++i)
+  {
+    const auto x = sln::PixelIndex(pix[i][0]);
+    const auto y = sln::PixelIndex(pix[i][1]);
+    REQUIRE(img(x, y) == sln::Pixel_8u3(pix[i][2], pix[i][3], pix[i][4]));
+  }
+
+  source.close();
+  REQUIRE(!source.is_open());
+}
+
 TEST_CASE("JPEG image reading, through JPEGReader interface", "[img]")
 {
   const auto tmp_path = sln_test::get_tmp_path();
@@ -432,4 +560,230 @@ TEST_CASE("JPEG image reading, through JPEGReader interface", "[img]")
   REQUIRE(!source.is_open());
 }
 
+TEST_CASE("JPEG image reading, strip by strip through JPEGReader interface", "[img]")
+{
+  const auto ref_img_data = sln::read_jpeg(sln::FileReader(in_filename().string()));
+  REQUIRE(ref_img_data.is_valid());
+  const auto nr_bytes_per_row = ref_img_data.width() * ref_img_data.nr_channels();
+
+  sln::FileReader source(in_filename().string());
+  REQUIRE(source.is_open());
+  sln::JPEGReader<sln::FileReader> jpeg_reader;
+  sln::ImageData<> strip_data;
+
+  for (auto max_nr_rows : {1_px, 7_px, 64_px, 684_px, 1000_px})
+  {
+    source.seek_abs(0);
+    jpeg_reader.set_source(source);
+
+    auto y = 0_idx;
+    while (const auto nr_rows = jpeg_reader.read_rows(strip_data, max_nr_rows))
+    {
+      REQUIRE(nr_rows <= max_nr_rows);
+      REQUIRE(strip_data.width() == ref_width);
+      REQUIRE(strip_data.height() == nr_rows);
+      REQUIRE(strip_data.nr_channels() == 3);
+      REQUIRE(strip_data.pixel_format() == sln::PixelFormat::RGB);
+      REQUIRE(!strip_data.is_view());
+
+      for (auto row = 0_idx; row < nr_rows; ++row)
+      {
+        REQUIRE(std::memcmp(strip_data.byte_ptr(row), ref_img_data.byte_ptr(sln::PixelIndex{y + row}), nr_bytes_per_row) == 0);
+      }
+
+      y += nr_rows;
+      REQUIRE(jpeg_reader.nr_remaining_rows() == ref_height - y);
+    }
+
+    REQUIRE(y == ref_height);
+    REQUIRE(jpeg_reader.message_log().messages().empty());
+    REQUIRE(jpeg_reader.read_rows(strip_data, max_nr_rows) == 0);
+  }
+
+#if defined(SELENE_LIBJPEG_PARTIAL_DECODING)
+  {
+    const sln::BoundingBox region(100_idx, 100_idx, 400_px, 350_px);
+    const auto options = sln::JPEGDecompressionOptions(sln::JPEGColorSpace::Auto, region);
+    const auto ref_region_data = sln::read_jpeg(sln::FileReader(in_filename().string()), options);
+    REQUIRE(ref_region_data.is_valid());
+    const auto nr_bytes_per_region_row = ref_region_data.width() * ref_region_data.nr_channels();
+
+    source.seek_abs(0);
+    jpeg_reader.set_source(source);
+    jpeg_reader.set_decompression_options(options);
+
+    auto y = 0_idx;
+    while (const auto nr_rows = jpeg_reader.read_rows(strip_data, 32_px))
+    {
+      REQUIRE(strip_data.width() == ref_region_data.width());
+
+      for (auto row = 0_idx; row < nr_rows; ++row)
+      {
+        REQUIRE(std::memcmp(strip_data.byte_ptr(row), ref_region_data.byte_ptr(sln::PixelIndex{y + row}), nr_bytes_per_region_row) == 0);
+      }
+
+      y += nr_rows;
+    }
+
+    REQUIRE(y == ref_region_data.height());
+  }
+#endif
+
+  {
+    // Truncated data; libjpeg fills in the missing rows, but warns about the premature end of the data
+    const auto file_contents = sln::read_file_contents(in_filename().string());
+    sln::MemoryReader mem_source(file_contents.data(), file_contents.size() / 2);
+    sln::JPEGReader<sln::MemoryReader> mem_jpeg_reader(mem_source);
+
+    auto y = 0_idx;
+    while (const auto nr_rows = mem_jpeg_reader.read_rows(strip_data, 64_px))
+    {
+      y += nr_rows;
+    }
+
+    REQUIRE(y == ref_height);
+    REQUIRE(!mem_jpeg_reader.message_log().messages().empty());
+  }
+}
+
+TEST_CASE("JPEG image writing, strip by strip through JPEGWriter interface", "[img]")
+{
+  const auto tmp_path = sln_test::get_tmp_path();
+  const auto img_data = sln::read_jpeg(sln::FileReader(in_filename().string()));
+  REQUIRE(img_data.is_valid());
+
+  const auto get_strip = [&img_data](sln::PixelIndex y, sln::PixelLength nr_rows) {
+    return sln::ImageData<sln::ImageDataStorage::Constant>(
+        img_data.byte_ptr(y), img_data.width(), nr_rows, img_data.nr_channels(), img_data.nr_bytes_per_channel(),
+        img_data.stride_bytes(), img_data.pixel_format(), img_data.sample_format());
+  };
+
+  const auto options = sln::JPEGCompressionOptions(compression_factor);
+  std::vector<std::uint8_t> ref_buffer;
+  REQUIRE(sln::write_jpeg(img_data, sln::VectorWriter(ref_buffer), options));
+
+  sln::JPEGWriter<sln::VectorWriter> jpeg_writer;
+  jpeg_writer.set_compression_options(options);
+
+  for (auto max_nr_rows : {1_px, 7_px, 64_px, 684_px})
+  {
+    std::vector<std::uint8_t> buffer;
+    sln::VectorWriter sink(buffer);
+    jpeg_writer.set_sink(sink);
+
+    REQUIRE(jpeg_writer.write_header(img_data.width(), img_data.height(), img_data.nr_channels(),
+                                     img_data.nr_bytes_per_channel(), img_data.pixel_format()));
+    REQUIRE(jpeg_writer.nr_remaining_rows() == ref_height);
+
+    for (auto y = 0_idx; y < img_data.height(); y += max_nr_rows)
+    {
+      const auto nr_rows = std::min(max_nr_rows, sln::PixelLength{img_data.height() - y});
+      REQUIRE(jpeg_writer.write_rows(get_strip(y, nr_rows)));
+      REQUIRE(jpeg_writer.nr_remaining_rows() == ref_height - y - nr_rows);
+    }
+
+    REQUIRE(jpeg_writer.message_log().messages().empty());
+    REQUIRE(buffer == ref_buffer);
+  }
+
+  {
+    std::vector<std::uint8_t> buffer;
+    sln::VectorWriter sink(buffer);
+    jpeg_writer.set_sink(sink);
+
+    // No image started
+    REQUIRE(!jpeg_writer.write_rows(get_strip(0_idx, 10_px)));
+    REQUIRE(!jpeg_writer.message_log().messages().empty());
+
+    // Unsupported bit depth
+    REQUIRE(!jpeg_writer.write_header(img_data.width(), img_data.height(), img_data.nr_channels(), 2,
+                                      img_data.pixel_format()));
+
+    // Strips not matching the image are rejected, without aborting the image
+    REQUIRE(jpeg_writer.write_header(img_data.width(), 100_px, img_data.nr_channels(),
+                                     img_data.nr_bytes_per_channel(), img_data.pixel_format()));
+    REQUIRE(!jpeg_writer.write_rows(get_strip(0_idx, 101_px)));
+    const sln::ImageData<sln::ImageDataStorage::Constant> narrow_strip(
+        img_data.byte_ptr(0_idx), 100_px, 10_px, img_data.nr_channels(), img_data.nr_bytes_per_channel(),
+        img_data.stride_bytes(), img_data.pixel_format(), img_data.sample_format());
+    REQUIRE(!jpeg_writer.write_rows(narrow_strip));
+    REQUIRE(jpeg_writer.nr_remaining_rows() == 100);
+    REQUIRE(jpeg_writer.write_rows(get_strip(0_idx, 50_px)));
+    REQUIRE(jpeg_writer.nr_remaining_rows() == 50);
+
+    // Starting a new image aborts the incomplete one; the data compressed so far remains in the sink
+    REQUIRE(jpeg_writer.write_header(img_data.width(), img_data.height(), img_data.nr_channels(),
+                                     img_data.nr_bytes_per_channel(), img_data.pixel_format()));
+    const auto aborted_size = static_cast<std::size_t>(sink.position());
+    REQUIRE(aborted_size > 2);
+    REQUIRE(buffer[0] == 0xFF);
+    REQUIRE(buffer[1] == 0xD8);
+
+    REQUIRE(jpeg_writer.write_rows(get_strip(0_idx, 300_px)));
+    REQUIRE(jpeg_writer.write_rows(get_strip(300_idx, sln::PixelLength{img_data.height() - 300})));
+    REQUIRE(jpeg_writer.nr_remaining_rows() == 0);
+    REQUIRE(buffer.size() == aborted_size + ref_buffer.size());
+    REQUIRE(std::equal(ref_buffer.cbegin(), ref_buffer.cend(), buffer.cbegin() + aborted_size));
+  }
+
+  {
+    // Writing to a vector starts at the current position, and preserves preceding data
+    std::vector<std::uint8_t> buffer = {1, 2, 3};
+    sln::VectorWriter sink(buffer, sln::WriterMode::Append);
+    REQUIRE(sln::write_jpeg(img_data, sink, options));
+    REQUIRE(buffer.size() == ref_buffer.size() + 3);
+    REQUIRE(buffer[0] == 1);
+    REQUIRE(buffer[2] == 3);
+    REQUIRE(std::equal(ref_buffer.cbegin(), ref_buffer.cend(), buffer.cbegin() + 3));
+    REQUIRE(sink.position() == static_cast<std::ptrdiff_t>(buffer.size()));
+
+    // Overwriting data: the vector keeps its size, if it is larger than the written stream
+    std::vector<std::uint8_t> large_buffer(ref_buffer.size() + 1000, 0x42);
+    sln::VectorWriter large_sink(large_buffer, sln::WriterMode::Append);
+    large_sink.seek_abs(10);
+    REQUIRE(sln::write_jpeg(img_data, large_sink, options));
+    REQUIRE(large_buffer.size() == ref_buffer.size() + 1000);
+    REQUIRE(std::equal(ref_buffer.cbegin(), ref_buffer.cend(), large_buffer.cbegin() + 10));
+    REQUIRE(large_buffer.back() == 0x42);
+    REQUIRE(large_sink.position() == static_cast<std::ptrdiff_t>(ref_buffer.size() + 10));
+  }
+
+  {
+    sln::FileWriter sink((tmp_path / "test_duck_strips.jpg").string());
+    REQUIRE(sink.is_open());
+    sln::JPEGWriter<sln::FileWriter> file_jpeg_writer(sink, options);
+    REQUIRE(file_jpeg_writer.write_header(img_data.width(), img_data.height(), img_data.nr_channels(),
+                                          img_data.nr_bytes_per_channel(), img_data.pixel_format()));
+
+    for (auto y = 0_idx; y < img_data.height(); y += 100)
+    {
+      REQUIRE(file_jpeg_writer.write_rows(get_strip(y, std::min(100_px, sln::PixelLength{img_data.height() - y}))));
+    }
+
+    sink.close();
+    REQUIRE(sln::read_file_contents((tmp_path / "test_duck_strips.jpg").string()) == ref_buffer);
+  }
+}
+
+TEST_CASE("JPEG image writing, rejecting planar image data", "[img]")
+{
+  sln::PlanarImage_8u3 img(16_px, 8_px);
+  img.fill(sln::Pixel_8u3(10, 20, 30));
+  const auto img_data = sln::to_image_data(std::move(img), sln::PixelFormat::RGB);
+  REQUIRE(img_data.is_planar());
+
+  std::vector<std::uint8_t> buffer;
+  sln::MessageLog messages;
+  REQUIRE(!sln::write_jpeg(img_data, sln::VectorWriter(buffer), sln::JPEGCompressionOptions(), &messages));
+  REQUIRE(!messages.messages().empty());
+  REQUIRE(buffer.empty());
+
+  sln::VectorWriter sink(buffer);
+  sln::JPEGWriter<sln::VectorWriter> jpeg_writer(sink);
+  REQUIRE(jpeg_writer.write_header(img_data.width(), img_data.height(), img_data.nr_channels(),
+                                   img_data.nr_bytes_per_channel(), img_data.pixel_format()));
+  REQUIRE(!jpeg_writer.write_rows(img_data));
+  REQUIRE(!jpeg_writer.message_log().messages().empty());
+}
+
 #endif  // defined(SELENE_WITH_LIBJPEG)
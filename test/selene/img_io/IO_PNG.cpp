@@ -8,14 +8,18 @@
 
 #include <catch.hpp>
 
+#include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 
 #include <boost/filesystem.hpp>
 
 #include <selene/io/FileReader.hpp>
 #include <selene/io/FileUtils.hpp>
 #include <selene/io/FileWriter.hpp>
+#include <selene/io/MMapReader.hpp>
 #include <selene/io/MemoryReader.hpp>
 #include <selene/io/VectorWriter.hpp>
 
@@ -23,9 +27,12 @@
 #include <selene/img/ImageData.hpp>
 #include <selene/img/ImageDataToImage.hpp>
 #include <selene/img/ImageToImageData.hpp>
+#include <selene/img/PlanarImage.hpp>
 #include <selene/img_io/PNGRead.hpp>
 #include <selene/img_io/PNGWrite.hpp>
 
+#include <selene/thread/ThreadPool.hpp>
+
 #include <test/selene/Utils.hpp>
 
 namespace fs = boost::filesystem;
@@ -359,6 +366,45 @@ TEST_CASE("PNG reading of the official test suite", "[img]")
   }
 }
 
+TEST_CASE("PNG image reading from a memory-mapped file", "[img]")
+{
+  sln::MMapReader source(in_filename().string());
+  REQUIRE(source.is_open());
+  REQUIRE(source.size() == fs::file_size(in_filename()));
+
+  const auto header = sln::read_png_header(source, true);
+  REQUIRE(header.is_valid());
+  REQUIRE(header.width == ref_width);
+  REQUIRE(header.height == ref_height);
+  REQUIRE(header.nr_channels == 3);
+
+  REQUIRE(source.position() == 0);
+  sln::MessageLog messages_read;
+  auto img_data = sln::read_png(source, sln::PNGDecompressionOptions(), &messages_read);
+  REQUIRE(messages_read.messages().empty());
+  REQUIRE(img_data.is_valid());
+
+  // The decoded image has to be identical to the one decoded through the stdio-based FileReader
+  sln::FileReader file_source(in_filename().string());
+  auto img_data_ref = sln::read_png(file_source);
+  REQUIRE(img_data_ref.is_valid());
+  REQUIRE(img_data.width() == img_data_ref.width());
+  REQUIRE(img_data.height() == img_data_ref.height());
+  REQUIRE(img_data.total_bytes() == img_data_ref.total_bytes());
+  REQUIRE(std::memcmp(img_data.byte_ptr(), img_data_ref.byte_ptr(), img_data.total_bytes()) == 0);
+
+  auto img = sln::to_image<sln::Pixel_8u3>(std::move(img_data));
+  for (int i = 0; i < 3; ++i)
+  {
+    const auto x = sln::PixelIndex(pix[i][0]);
+    const auto y = sln::PixelIndex(pix[i][1]);
+    REQUIRE(img(x, y) == sln::Pixel_8u3(pix[i][2], pix[i][3], pix[i][4]));
+  }
+
+  source.close();
+  REQUIRE(!source.is_open());
+}
+
 TEST_CASE("PNG image reading, through PNGReader interface", "[img]")
 {
   const auto tmp_path = sln_test::get_tmp_path();
@@ -422,4 +468,372 @@ TEST_CASE("PNG image reading, through PNGReader interface", "[img]")
 }
 
 
+TEST_CASE("PNG image reading, strip by strip through PNGReader interface", "[img]")
+{
+  const auto check_strips = [](const boost::filesystem::path& path, sln::PixelLength max_nr_rows) {
+    const auto ref_img_data = sln::read_png(sln::FileReader(path.string()));
+    REQUIRE(ref_img_data.is_valid());
+    const auto nr_bytes_per_row =
+        ref_img_data.width() * ref_img_data.nr_channels() * ref_img_data.nr_bytes_per_channel();
+
+    sln::FileReader source(path.string());
+    REQUIRE(source.is_open());
+    sln::PNGReader<sln::FileReader> png_reader(source);
+    sln::ImageData<> strip_data;
+
+    auto y = 0_idx;
+    while (const auto nr_rows = png_reader.read_rows(strip_data, max_nr_rows))
+    {
+      REQUIRE(nr_rows <= max_nr_rows);
+      REQUIRE(strip_data.width() == ref_img_data.width());
+      REQUIRE(strip_data.height() == nr_rows);
+      REQUIRE(strip_data.nr_channels() == ref_img_data.nr_channels());
+      REQUIRE(strip_data.nr_bytes_per_channel() == ref_img_data.nr_bytes_per_channel());
+      REQUIRE(strip_data.pixel_format() == ref_img_data.pixel_format());
+
+      for (auto row = 0_idx; row < nr_rows; ++row)
+      {
+        REQUIRE(std::memcmp(strip_data.byte_ptr(row), ref_img_data.byte_ptr(sln::PixelIndex{y + row}), nr_bytes_per_row) == 0);
+      }
+
+      y += nr_rows;
+      REQUIRE(png_reader.nr_remaining_rows() == ref_img_data.height() - y);
+    }
+
+    REQUIRE(y == ref_img_data.height());
+    REQUIRE(png_reader.read_rows(strip_data, max_nr_rows) == 0);
+  };
+
+  for (auto max_nr_rows : {1_px, 7_px, 64_px, 684_px, 1000_px})
+  {
+    check_strips(in_filename(), max_nr_rows);
+  }
+
+  check_strips(test_suite_dir() / "basn0g16.png", 5_px);
+  check_strips(test_suite_dir() / "basn3p04.png", 3_px);
+
+  // Interlaced images cannot be read strip by strip
+  sln::FileReader source((test_suite_dir() / "basi2c08.png").string());
+  REQUIRE(source.is_open());
+  sln::PNGReader<sln::FileReader> png_reader(source);
+  sln::ImageData<> strip_data;
+  REQUIRE(png_reader.read_rows(strip_data, 8_px) == 0);
+  REQUIRE(!png_reader.message_log().messages().empty());
+}
+
+TEST_CASE("PNG image writing, strip by strip through PNGWriter interface", "[img]")
+{
+  const auto check_strips = [](const boost::filesystem::path& path, sln::PixelLength max_nr_rows) {
+    const auto img_data = sln::read_png(sln::FileReader(path.string()));
+    REQUIRE(img_data.is_valid());
+
+    std::vector<std::uint8_t> ref_buffer;
+    REQUIRE(sln::write_png(img_data, sln::VectorWriter(ref_buffer)));
+
+    std::vector<std::uint8_t> buffer;
+    sln::VectorWriter sink(buffer);
+    sln::PNGWriter<sln::VectorWriter> png_writer(sink);
+    REQUIRE(png_writer.write_header(img_data.width(), img_data.height(), img_data.nr_channels(),
+                                    img_data.nr_bytes_per_channel(), img_data.pixel_format()));
+
+    for (auto y = 0_idx; y < img_data.height(); y += max_nr_rows)
+    {
+      const auto nr_rows = std::min(max_nr_rows, sln::PixelLength{img_data.height() - y});
+      const sln::ImageData<sln::ImageDataStorage::Constant> strip(
+          img_data.byte_ptr(y), img_data.width(), nr_rows, img_data.nr_channels(), img_data.nr_bytes_per_channel(),
+          img_data.stride_bytes(), img_data.pixel_format(), img_data.sample_format());
+      REQUIRE(png_writer.write_rows(strip));
+      REQUIRE(png_writer.nr_remaining_rows() == img_data.height() - y - nr_rows);
+    }
+
+    REQUIRE(png_writer.message_log().messages().empty());
+    REQUIRE(buffer == ref_buffer);
+  };
+
+  for (auto max_nr_rows : {1_px, 7_px, 64_px, 684_px})
+  {
+    check_strips(in_filename(), max_nr_rows);
+  }
+
+  check_strips(test_suite_dir() / "basn0g16.png", 5_px);
+  check_strips(test_suite_dir() / "basn6a16.png", 3_px);
+
+  const auto img_data = sln::read_png(sln::FileReader(in_filename().string()));
+  const auto strip = sln::ImageData<sln::ImageDataStorage::Constant>(
+      img_data.byte_ptr(0_idx), img_data.width(), 10_px, img_data.nr_channels(), img_data.nr_bytes_per_channel(),
+      img_data.stride_bytes(), img_data.pixel_format(), img_data.sample_format());
+
+  std::vector<std::uint8_t> buffer;
+  sln::VectorWriter sink(buffer);
+  sln::PNGWriter<sln::VectorWriter> png_writer(sink);
+
+  // No image started
+  REQUIRE(!png_writer.write_rows(strip));
+  REQUIRE(!png_writer.message_log().messages().empty());
+
+  // An incomplete image is aborted; the writer can be used for the next image
+  REQUIRE(png_writer.write_header(img_data.width(), 20_px, img_data.nr_channels(), img_data.nr_bytes_per_channel(),
+                                  img_data.pixel_format()));
+  REQUIRE(png_writer.write_rows(strip));
+  REQUIRE(png_writer.nr_remaining_rows() == 10);
+
+  std::vector<std::uint8_t> buffer_2;
+  sln::VectorWriter sink_2(buffer_2);
+  png_writer.set_sink(sink_2);
+  REQUIRE(png_writer.write_header(img_data.width(), 20_px, img_data.nr_channels(), img_data.nr_bytes_per_channel(),
+                                  img_data.pixel_format()));
+  REQUIRE(png_writer.write_rows(strip));
+  REQUIRE(png_writer.write_rows(strip));
+  REQUIRE(png_writer.message_log().messages().empty());
+
+  const auto img_data_2 = sln::read_png(sln::MemoryReader(buffer_2.data(), buffer_2.size()));
+  REQUIRE(img_data_2.height() == 20);
+  REQUIRE(std::memcmp(img_data_2.byte_ptr(10_idx), img_data.byte_ptr(0_idx), img_data.stride_bytes() * 10) == 0);
+
+  // Interlaced images cannot be written strip by strip
+  png_writer.set_compression_options(sln::PNGCompressionOptions(6, true));
+  REQUIRE(png_writer.write_header(img_data.width(), 10_px, img_data.nr_channels(), img_data.nr_bytes_per_channel(),
+                                  img_data.pixel_format()));
+  REQUIRE(!png_writer.write_rows(strip));
+  REQUIRE(!png_writer.message_log().messages().empty());
+}
+
+TEST_CASE("PNG image writing, compressing in parallel", "[img]")
+{
+  sln::ThreadPool thread_pool(3);
+
+  // Writes the image data using the parallel and the single-threaded writer, and checks that both PNG streams are
+  // decoded (by libpng, which verifies the checksums) to the same image data.
+  const auto check_parallel = [&thread_pool](const sln::ImageData<>& img_data, sln::PNGCompressionOptions options) {
+    std::vector<std::uint8_t> ref_buffer;
+    REQUIRE(sln::write_png(img_data, sln::VectorWriter(ref_buffer), options));
+
+    std::vector<std::uint8_t> buffer;
+    sln::MessageLog messages_write;
+    REQUIRE(sln::write_png(img_data, sln::VectorWriter(buffer), thread_pool, options, &messages_write));
+    REQUIRE(messages_write.messages().empty());
+
+    sln::MessageLog messages_read, ref_messages_read;
+    const auto ref_img_data = sln::read_png(sln::MemoryReader(ref_buffer.data(), ref_buffer.size()),
+                                            sln::PNGDecompressionOptions(), &ref_messages_read);
+    const auto img_data_2 = sln::read_png(sln::MemoryReader(buffer.data(), buffer.size()),
+                                          sln::PNGDecompressionOptions(), &messages_read);
+    REQUIRE(messages_read.messages().empty());
+    REQUIRE(ref_messages_read.messages().empty());
+    REQUIRE(img_data_2.is_valid());
+    REQUIRE(img_data_2.width() == ref_img_data.width());
+    REQUIRE(img_data_2.height() == ref_img_data.height());
+    REQUIRE(img_data_2.nr_channels() == ref_img_data.nr_channels());
+    REQUIRE(img_data_2.nr_bytes_per_channel() == ref_img_data.nr_bytes_per_channel());
+    REQUIRE(img_data_2.pixel_format() == ref_img_data.pixel_format());
+
+    const auto nr_bytes_per_row = img_data_2.width() * img_data_2.nr_channels() * img_data_2.nr_bytes_per_channel();
+    for (auto y = 0_idx; y < img_data_2.height(); ++y)
+    {
+      REQUIRE(std::memcmp(img_data_2.byte_ptr(y), ref_img_data.byte_ptr(y), nr_bytes_per_row) == 0);
+    }
+
+    return std::make_pair(buffer.size(), ref_buffer.size());
+  };
+
+  SECTION("Compression levels")
+  {
+    const auto img_data = sln::read_png(sln::FileReader(in_filename().string()));
+    REQUIRE(img_data.is_valid());
+
+    for (int compression_level : {0, 1, 6, 9})
+    {
+      const auto sizes = check_parallel(img_data, sln::PNGCompressionOptions(compression_level));
+
+      if (compression_level > 0)
+      {
+        REQUIRE(sizes.first < sizes.second + sizes.second / 20);
+      }
+    }
+  }
+
+  SECTION("Pixel formats and transformations")
+  {
+    for (const auto filename : {"basn0g08.png", "basn0g16.png", "basn2c08.png", "basn2c16.png", "basn4a08.png",
+                                "basn4a16.png", "basn6a08.png", "basn6a16.png"})
+    {
+      const auto img_data = sln::read_png(sln::FileReader((test_suite_dir() / filename).string()));
+      REQUIRE(img_data.is_valid());
+
+      check_parallel(img_data, sln::PNGCompressionOptions());
+      check_parallel(img_data, sln::PNGCompressionOptions(6, false, true, false, false));
+      check_parallel(img_data, sln::PNGCompressionOptions(6, false, false, true, false));
+      check_parallel(img_data, sln::PNGCompressionOptions(6, false, false, false, true));
+      check_parallel(img_data, sln::PNGCompressionOptions(6, false, true, true, true));
+    }
+  }
+
+  SECTION("Filter and zlib options")
+  {
+    const auto img_data = sln::read_png(sln::FileReader(in_filename().string()));
+    REQUIRE(img_data.is_valid());
+
+    for (const auto filters : {sln::PNGFilter::None, sln::PNGFilter::Sub, sln::PNGFilter::Up, sln::PNGFilter::Average,
+                               sln::PNGFilter::Paeth, sln::PNGFilter::Up | sln::PNGFilter::Paeth})
+    {
+      sln::PNGCompressionOptions options;
+      options.filters = filters;
+      check_parallel(img_data, options);
+    }
+
+    for (const auto strategy : {sln::PNGCompressionStrategy::Default, sln::PNGCompressionStrategy::Filtered,
+                                sln::PNGCompressionStrategy::HuffmanOnly, sln::PNGCompressionStrategy::RLE,
+                                sln::PNGCompressionStrategy::Fixed})
+    {
+      sln::PNGCompressionOptions options;
+      options.strategy = strategy;
+      check_parallel(img_data, options);
+    }
+
+    sln::PNGCompressionOptions options;
+    options.window_bits = 9;
+    options.mem_level = 1;
+    check_parallel(img_data, options);
+
+    for (const auto preset : {sln::PNGCompressionPreset::Fastest, sln::PNGCompressionPreset::Smallest})
+    {
+      check_parallel(img_data, sln::PNGCompressionOptions(preset));
+    }
+  }
+
+  SECTION("Row blocks of different sizes")
+  {
+    // Rows of about 600 KB each (i.e. one row per block), and rows of 2 KB each (i.e. many rows per block)
+    for (const auto& size : {std::make_pair(100000_px, 6_px), std::make_pair(1000_px, 1000_px)})
+    {
+      sln::ImageData<> img_data(size.first, size.second, 3, 2, sln::Stride{0}, sln::PixelFormat::RGB,
+                                sln::SampleFormat::UnsignedInteger);
+
+      for (auto y = 0_idx; y < img_data.height(); ++y)
+      {
+        auto ptr = img_data.byte_ptr(y);
+        for (std::size_t i = 0; i < static_cast<std::size_t>(img_data.width()) * 6; ++i)
+        {
+          ptr[i] = static_cast<std::uint8_t>((i * 7 + i / 6000 + static_cast<std::size_t>(y) * 13) % 251);
+        }
+      }
+
+      check_parallel(img_data, sln::PNGCompressionOptions());
+    }
+  }
+
+  SECTION("Different sinks and fallbacks")
+  {
+    const auto tmp_path = sln_test::get_tmp_path();
+    const auto img_data = sln::read_png(sln::FileReader(in_filename().string()));
+
+    sln::MessageLog messages_write;
+    REQUIRE(sln::write_png(img_data, sln::FileWriter((tmp_path / "test_img_parallel.png").string()), thread_pool,
+                           sln::PNGCompressionOptions(), &messages_write));
+    REQUIRE(messages_write.messages().empty());
+
+    const auto img_data_2 = sln::read_png(sln::FileReader((tmp_path / "test_img_parallel.png").string()));
+    REQUIRE(img_data_2.is_valid());
+    REQUIRE(std::memcmp(img_data_2.byte_ptr(), img_data.byte_ptr(), img_data.total_bytes()) == 0);
+
+    // Interlaced images are written by the single-threaded writer
+    std::vector<std::uint8_t> ref_buffer, buffer;
+    REQUIRE(sln::write_png(img_data, sln::VectorWriter(ref_buffer), sln::PNGCompressionOptions(6, true)));
+    REQUIRE(sln::write_png(img_data, sln::VectorWriter(buffer), thread_pool, sln::PNGCompressionOptions(6, true)));
+    REQUIRE(buffer == ref_buffer);
+
+    // Pixel format not matching the number of channels
+    const sln::ImageData<sln::ImageDataStorage::Constant> img_data_invalid(
+        img_data.byte_ptr(), img_data.width(), img_data.height(), img_data.nr_channels(),
+        img_data.nr_bytes_per_channel(), img_data.stride_bytes(), sln::PixelFormat::RGBA, img_data.sample_format());
+    buffer.clear();
+    sln::MessageLog messages_invalid;
+    REQUIRE(!sln::write_png(img_data_invalid, sln::VectorWriter(buffer), thread_pool, sln::PNGCompressionOptions(),
+                            &messages_invalid));
+    REQUIRE(!messages_invalid.messages().empty());
+    REQUIRE(buffer.empty());
+  }
+}
+
+TEST_CASE("PNG image writing, compression presets", "[img]")
+{
+  const auto img_data = sln::read_png(sln::FileReader(in_filename().string()));
+  REQUIRE(img_data.is_valid());
+
+  const auto write_preset = [&img_data](sln::PNGCompressionPreset preset) {
+    std::vector<std::uint8_t> buffer;
+    sln::MessageLog messages;
+    REQUIRE(sln::write_png(img_data, sln::VectorWriter(buffer), sln::PNGCompressionOptions(preset), &messages));
+    REQUIRE(messages.messages().empty());
+
+    const auto img_data_2 = sln::read_png(sln::MemoryReader(buffer.data(), buffer.size()));
+    REQUIRE(img_data_2.is_valid());
+    REQUIRE(img_data_2.total_bytes() == img_data.total_bytes());
+    REQUIRE(std::memcmp(img_data_2.byte_ptr(), img_data.byte_ptr(), img_data.total_bytes()) == 0);
+    return buffer;
+  };
+
+  const auto buffer_fastest = write_preset(sln::PNGCompressionPreset::Fastest);
+  const auto buffer_balanced = write_preset(sln::PNGCompressionPreset::Balanced);
+  const auto buffer_smallest = write_preset(sln::PNGCompressionPreset::Smallest);
+  REQUIRE(buffer_smallest.size() < buffer_balanced.size());
+  REQUIRE(buffer_balanced.size() < buffer_fastest.size());
+
+  // The balanced preset corresponds to the default options
+  std::vector<std::uint8_t> buffer_default;
+  REQUIRE(sln::write_png(img_data, sln::VectorWriter(buffer_default)));
+  REQUIRE(buffer_balanced == buffer_default);
+
+  // Without filtering and compression, the image data is stored as is (plus one filter type byte per row)
+  sln::PNGCompressionOptions options(0);
+  options.filters = sln::PNGFilter::None;
+  std::vector<std::uint8_t> buffer_stored;
+  REQUIRE(sln::write_png(img_data, sln::VectorWriter(buffer_stored), options));
+  REQUIRE(buffer_stored.size() > img_data.total_bytes() + static_cast<std::size_t>(img_data.height()));
+  REQUIRE(buffer_stored.size() < img_data.total_bytes() + img_data.total_bytes() / 100);
+}
+
+TEST_CASE("PNG image writing, rejecting planar image data", "[img]")
+{
+  sln::ThreadPool thread_pool(2);
+
+  sln::PlanarImage_8u3 img(4_px, 2_px);
+  img.fill(sln::Pixel_8u3(10, 20, 30));
+  const auto img_data = sln::to_image_data(std::move(img), sln::PixelFormat::RGB);
+  REQUIRE(img_data.is_planar());
+
+  std::vector<std::uint8_t> buffer;
+  sln::MessageLog messages;
+  REQUIRE(!sln::write_png(img_data, sln::VectorWriter(buffer), sln::PNGCompressionOptions(), &messages));
+  REQUIRE(!messages.messages().empty());
+  REQUIRE(buffer.empty());
+
+  sln::MessageLog messages_parallel;
+  REQUIRE(!sln::write_png(img_data, sln::VectorWriter(buffer), thread_pool, sln::PNGCompressionOptions(),
+                          &messages_parallel));
+  REQUIRE(!messages_parallel.messages().empty());
+  REQUIRE(buffer.empty());
+
+  sln::VectorWriter sink(buffer);
+  sln::PNGWriter<sln::VectorWriter> png_writer(sink);
+  REQUIRE(png_writer.write_header(img_data.width(), img_data.height(), img_data.nr_channels(),
+                                  img_data.nr_bytes_per_channel(), img_data.pixel_format()));
+  REQUIRE(!png_writer.write_rows(img_data));
+  REQUIRE(!png_writer.message_log().messages().empty());
+
+  REQUIRE_THROWS(sln::get_row_pointers(img_data));
+
+  // A single plane is equivalent to interleaved data
+  sln::PlanarImage<std::uint8_t, 1> img_y(4_px, 2_px);
+  img_y.fill(sln::Pixel<std::uint8_t, 1>(10));
+  const auto img_data_y = sln::to_image_data(std::move(img_y), sln::PixelFormat::Y);
+  std::vector<std::uint8_t> buffer_y;
+  REQUIRE(sln::write_png(img_data_y, sln::VectorWriter(buffer_y)));
+
+  const auto img_data_y_2 = sln::read_png(sln::MemoryReader(buffer_y.data(), buffer_y.size()));
+  REQUIRE(img_data_y_2.is_valid());
+  REQUIRE(img_data_y_2.nr_channels() == 1);
+  REQUIRE(*img_data_y_2.byte_ptr(3_idx, 1_idx) == 10);
+}
+
 #endif  // defined(SELENE_WITH_LIBPNG)
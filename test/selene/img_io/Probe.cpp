@@ -0,0 +1,179 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <selene/img_io/Probe.hpp>
+
+#include <selene/io/FileReader.hpp>
+#include <selene/io/FileUtils.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <test/selene/Utils.hpp>
+
+#include <string>
+#include <vector>
+
+namespace fs = boost::filesystem;
+using namespace sln::literals;
+
+constexpr auto ref_width = 1024;
+constexpr auto ref_height = 684;
+
+namespace {
+
+fs::path full_path(const char* filename)
+{
+  const auto env_var = std::getenv("SELENE_DATA_PATH");
+  return (env_var) ? (fs::path(env_var) / fs::path(filename)) : (fs::path("../data") / fs::path(filename));
+}
+
+void check_equal(const sln::ImageProbeInfo& a, const sln::ImageProbeInfo& b)
+{
+  REQUIRE(a.is_valid() == b.is_valid());
+  REQUIRE(a.width == b.width);
+  REQUIRE(a.height == b.height);
+  REQUIRE(a.nr_channels == b.nr_channels);
+  REQUIRE(a.bit_depth == b.bit_depth);
+  REQUIRE(a.format == b.format);
+}
+
+}  // namespace
+
+TEST_CASE("Image probing", "[img]")
+{
+  const auto tmp_path = sln_test::get_tmp_path();
+
+#if defined(SELENE_WITH_LIBJPEG)
+  SECTION("JPEG")
+  {
+    const auto info = sln::probe_image(full_path("bike_duck.jpg").string());
+    REQUIRE(info.is_valid());
+    REQUIRE(info.format == sln::ImageFormat::JPEG);
+    REQUIRE(info.width == ref_width);
+    REQUIRE(info.height == ref_height);
+    REQUIRE(info.nr_channels == 3);
+    REQUIRE(info.bit_depth == 8);
+  }
+
+  SECTION("JPEG with frame header beyond the file prefix")
+  {
+    // Insert a large application segment directly after the SOI marker
+    auto data = sln::read_file_contents(full_path("bike_duck.jpg").string());
+    const std::size_t segment_length = 3 * sln::ImageProber::prefix_size;
+    std::vector<std::uint8_t> segment(segment_length + 2, 0x20);
+    segment[0] = 0xFF;
+    segment[1] = 0xE9;  // APP9
+    segment[2] = static_cast<std::uint8_t>(segment_length >> 8);
+    segment[3] = static_cast<std::uint8_t>(segment_length & 0xFF);
+    data.insert(data.begin() + 2, segment.cbegin(), segment.cend());
+
+    const auto path = (tmp_path / "test_probe_large_app.jpg").string();
+    sln::write_data_contents(path, data);
+
+    sln::FileReader source(path);
+    const auto header_info = sln::read_jpeg_header(source);
+    REQUIRE(header_info.is_valid());
+
+    const auto info = sln::probe_image(path);
+    REQUIRE(info.is_valid());
+    REQUIRE(info.format == sln::ImageFormat::JPEG);
+    REQUIRE(info.width == ref_width);
+    REQUIRE(info.height == ref_height);
+    REQUIRE(info.nr_channels == 3);
+  }
+#endif  // defined(SELENE_WITH_LIBJPEG)
+
+#if defined(SELENE_WITH_LIBPNG)
+  SECTION("PNG")
+  {
+    const auto info = sln::probe_image(full_path("bike_duck.png").string());
+    REQUIRE(info.is_valid());
+    REQUIRE(info.format == sln::ImageFormat::PNG);
+    REQUIRE(info.width == ref_width);
+    REQUIRE(info.height == ref_height);
+    REQUIRE(info.nr_channels == 3);
+    REQUIRE(info.bit_depth == 8);
+  }
+
+  SECTION("PNG test suite")
+  {
+    sln::ImageProber prober;
+
+    for (fs::directory_iterator itr(full_path("png_suite")), itr_end; itr != itr_end; ++itr)
+    {
+      const auto& path = itr->path();
+      const auto is_broken = (path.stem().string()[0] == 'x');  // Broken image files begin with 'x'
+
+      if (path.extension() != ".png" || is_broken)
+      {
+        continue;
+      }
+
+      sln::FileReader source(path.string());
+      const auto header_info = sln::read_png_header(source);
+      REQUIRE(header_info.is_valid());
+
+      const auto info = prober.probe(path.string());
+      REQUIRE(info.is_valid());
+      REQUIRE(info.format == sln::ImageFormat::PNG);
+      REQUIRE(info.width == header_info.width);
+      REQUIRE(info.height == header_info.height);
+      REQUIRE(info.nr_channels == header_info.nr_channels);
+      REQUIRE(info.bit_depth == header_info.bit_depth);
+    }
+  }
+#endif  // defined(SELENE_WITH_LIBPNG)
+
+  SECTION("Invalid files")
+  {
+    const auto path = (tmp_path / "test_probe_invalid.bin").string();
+    sln::write_data_contents(path, std::vector<std::uint8_t>(100, 0xFF));
+
+    REQUIRE(!sln::probe_image(path).is_valid());
+    REQUIRE(sln::probe_image(path).format == sln::ImageFormat::Unknown);
+    REQUIRE(!sln::probe_image((tmp_path / "non_existing_file.jpg").string()).is_valid());
+
+    // Truncated after the signature
+    const auto data = sln::read_file_contents(full_path("bike_duck.png").string());
+    const auto path_truncated = (tmp_path / "test_probe_truncated.png").string();
+    sln::write_data_contents(path_truncated, data.data(), 12);
+    REQUIRE(!sln::probe_image(path_truncated).is_valid());
+    REQUIRE(sln::probe_image(path_truncated).format == sln::ImageFormat::Unknown);
+  }
+}
+
+TEST_CASE("Batch image probing", "[img]")
+{
+  std::vector<std::string> paths;
+  for (int i = 0; i < 50; ++i)
+  {
+    paths.push_back(full_path("bike_duck.jpg").string());
+    paths.push_back(full_path("bike_duck.png").string());
+    paths.push_back(full_path("non_existing_file.png").string());
+  }
+
+  const auto infos = sln::probe_images(paths);
+  REQUIRE(infos.size() == paths.size());
+
+  for (std::size_t i = 0; i < infos.size(); ++i)
+  {
+    check_equal(infos[i], sln::probe_image(paths[i]));
+  }
+
+  for (auto nr_threads : {1, 3, 8})
+  {
+    sln::ThreadPool thread_pool(static_cast<std::size_t>(nr_threads));
+    const auto infos_parallel = sln::probe_images(paths, thread_pool);
+    REQUIRE(infos_parallel.size() == paths.size());
+
+    for (std::size_t i = 0; i < infos.size(); ++i)
+    {
+      check_equal(infos_parallel[i], infos[i]);
+    }
+  }
+}
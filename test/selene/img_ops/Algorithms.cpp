@@ -7,6 +7,8 @@
 #include <selene/img/Image.hpp>
 #include <selene/img_ops/Algorithms.hpp>
 
+#include <selene/thread/ThreadPool.hpp>
+
 #include <random>
 
 using namespace sln::literals;
@@ -42,4 +44,35 @@ TEST_CASE("Image algorithms", "[img]")
       }
     }
   }
+
+  SECTION("Test for_each_pixel() on a thread pool")
+  {
+    sln::ThreadPool thread_pool(4);
+    sln::for_each_pixel(img, [](auto& px) { px = 67; }, thread_pool);
+
+    for (const auto& row : img)
+    {
+      for (const auto& px : row)
+      {
+        REQUIRE(px == 67);
+      }
+    }
+  }
+
+  SECTION("Test transform_pixels() on a thread pool")
+  {
+    sln::ThreadPool thread_pool(4);
+    const auto img2 = sln::transform_pixels<sln::Pixel_32u1>(
+        img, [](const auto& px) { return sln::Pixel_32u1{px / 2}; }, thread_pool);
+    REQUIRE(img2.width() == img.width());
+    REQUIRE(img2.height() == img.height());
+
+    for (const auto& row : img2)
+    {
+      for (const auto& px : row)
+      {
+        REQUIRE(px == 21);
+      }
+    }
+  }
 }
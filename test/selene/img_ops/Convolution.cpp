@@ -0,0 +1,203 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch.hpp>
+
+#include <selene/img/BorderAccessors.hpp>
+#include <selene/img_ops/Algorithms.hpp>
+#include <selene/img_ops/Convolution.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <test/selene/img/_TestImages.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+
+using namespace sln::literals;
+
+namespace {
+
+template <sln::BorderAccessMode border_access_mode, typename PixelType, std::size_t kx, std::size_t ky>
+sln::Image<sln::Pixel<double, sln::PixelTraits<PixelType>::nr_channels>> reference_convolution(
+    const sln::Image<PixelType>& img,
+    const std::array<sln::default_float_t, kx>& kernel_x,
+    const std::array<sln::default_float_t, ky>& kernel_y)
+{
+  constexpr auto nr_channels = sln::PixelTraits<PixelType>::nr_channels;
+  constexpr auto rx = static_cast<sln::PixelIndex::value_type>(kx / 2);
+  constexpr auto ry = static_cast<sln::PixelIndex::value_type>(ky / 2);
+
+  sln::Image<sln::Pixel<double, nr_channels>> img_h(img.width(), img.height());
+  sln::Image<sln::Pixel<double, nr_channels>> img_v(img.width(), img.height());
+
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      for (std::size_t c = 0; c < nr_channels; ++c)
+      {
+        double sum = 0.0;
+        for (std::size_t k = 0; k < kx; ++k)
+        {
+          const auto xs = sln::PixelIndex{x - rx + static_cast<sln::PixelIndex::value_type>(k)};
+          sum += kernel_x[k] * sln::ImageBorderAccessor<border_access_mode>::access(img, xs, y)[c];
+        }
+        img_h(x, y)[c] = sum;
+      }
+    }
+  }
+
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      for (std::size_t c = 0; c < nr_channels; ++c)
+      {
+        double sum = 0.0;
+        for (std::size_t k = 0; k < ky; ++k)
+        {
+          const auto ys = sln::PixelIndex{y - ry + static_cast<sln::PixelIndex::value_type>(k)};
+          sum += kernel_y[k] * sln::ImageBorderAccessor<border_access_mode>::access(img_h, x, ys)[c];
+        }
+        img_v(x, y)[c] = sum;
+      }
+    }
+  }
+
+  return img_v;
+}
+
+template <sln::BorderAccessMode border_access_mode, typename PixelType, std::size_t kx, std::size_t ky>
+void check_convolution(const sln::Image<PixelType>& img,
+                       const std::array<sln::default_float_t, kx>& kernel_x,
+                       const std::array<sln::default_float_t, ky>& kernel_y,
+                       double tolerance)
+{
+  using Element = typename sln::PixelTraits<PixelType>::Element;
+  constexpr auto nr_channels = sln::PixelTraits<PixelType>::nr_channels;
+  constexpr auto lowest = static_cast<double>(std::numeric_limits<Element>::lowest());
+  constexpr auto highest = static_cast<double>(std::numeric_limits<Element>::max());
+
+  const auto img_ref = reference_convolution<border_access_mode>(img, kernel_x, kernel_y);
+  const auto img_conv = sln::convolve_separable<border_access_mode>(img, kernel_x, kernel_y);
+  REQUIRE(img_conv.width() == img.width());
+  REQUIRE(img_conv.height() == img.height());
+
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      for (std::size_t c = 0; c < nr_channels; ++c)
+      {
+        const auto ref = std::max(lowest, std::min(img_ref(x, y)[c], highest));  // saturated
+        REQUIRE(std::abs(static_cast<double>(img_conv(x, y)[c]) - ref) <= tolerance);
+      }
+    }
+  }
+
+  sln::ThreadPool thread_pool(3);
+  const auto img_conv_mt = sln::convolve_separable<border_access_mode>(img, kernel_x, kernel_y, thread_pool);
+  REQUIRE(img_conv == img_conv_mt);
+}
+
+}  // namespace
+
+TEST_CASE("Convolution kernels", "[img]")
+{
+  const auto kernel_g = sln::gaussian_kernel<7>(1.5f);
+  REQUIRE(std::accumulate(kernel_g.cbegin(), kernel_g.cend(), 0.0) == Approx(1.0));
+  for (std::size_t k = 0; k < 3; ++k)
+  {
+    REQUIRE(kernel_g[k] == Approx(kernel_g[6 - k]));
+    REQUIRE(kernel_g[k] < kernel_g[k + 1]);
+  }
+
+  const auto kernel_g_auto = sln::gaussian_kernel<5>(0.0f);
+  REQUIRE(std::accumulate(kernel_g_auto.cbegin(), kernel_g_auto.cend(), 0.0) == Approx(1.0));
+
+  const auto kernel_b = sln::box_kernel<5>();
+  for (const auto v : kernel_b)
+  {
+    REQUIRE(v == Approx(0.2));
+  }
+}
+
+TEST_CASE("Separable convolution", "[img]")
+{
+  std::mt19937 rng(42);
+
+  // Includes sizes smaller than the kernel, and widths spanning several tiles
+  const std::array<std::pair<sln::PixelLength, sln::PixelLength>, 5> sizes = {{
+      {1_px, 1_px}, {2_px, 9_px}, {17_px, 4_px}, {64_px, 33_px}, {3001_px, 40_px}}};
+
+  const std::array<sln::default_float_t, 3> kernel_x = {{-1.0f, 0.0f, 1.0f}};
+  const auto kernel_y = sln::gaussian_kernel<5>(1.0f);
+
+  for (const auto& size : sizes)
+  {
+    const auto img_8u3 = sln_test::make_random_image<sln::Pixel_8u3>(size.first, size.second, rng);
+    check_convolution<sln::BorderAccessMode::Replicated>(img_8u3, kernel_x, kernel_y, 1.0);
+    check_convolution<sln::BorderAccessMode::ZeroPadding>(img_8u3, kernel_x, kernel_y, 1.0);
+    check_convolution<sln::BorderAccessMode::Replicated>(img_8u3, kernel_y, kernel_y, 1.0);
+
+    const auto img_16u1 = sln_test::make_random_image<sln::Pixel_16u1>(size.first, size.second, rng);
+    check_convolution<sln::BorderAccessMode::Replicated>(img_16u1, kernel_y, kernel_x, 1.0);
+
+    sln::Image_32f2 img_32f2(size.first, size.second);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    sln::for_each_pixel(img_32f2, [&](auto& px) { px = sln::Pixel_32f2(dist(rng), dist(rng)); });
+    check_convolution<sln::BorderAccessMode::ZeroPadding>(img_32f2, kernel_x, kernel_y, 1e-3);
+    check_convolution<sln::BorderAccessMode::Replicated>(img_32f2, kernel_y, kernel_x, 1e-3);
+  }
+
+  // Wide vertical kernels on wide images split the image into several column strips
+  const auto kernel_wide = sln::gaussian_kernel<19>(4.0f);
+  const auto img_wide_8u3 = sln_test::make_random_image<sln::Pixel_8u3>(3001_px, 45_px, rng);
+  check_convolution<sln::BorderAccessMode::Replicated>(img_wide_8u3, kernel_x, kernel_wide, 1.0);
+  check_convolution<sln::BorderAccessMode::ZeroPadding>(img_wide_8u3, kernel_wide, kernel_wide, 1.0);
+}
+
+TEST_CASE("Gaussian blur and box filter", "[img]")
+{
+  // A constant image remains constant using replicated borders, but not using zero padding.
+  sln::Image_8u1 img(50_px, 30_px);
+  sln::for_each_pixel(img, [](auto& px) { px = sln::Pixel_8u1(200); });
+
+  const auto img_g = sln::gaussian_blur<5>(img, 1.2f);
+  const auto img_b = sln::box_filter<7>(img);
+  REQUIRE(img_g == img);
+  REQUIRE(img_b == img);
+
+  const auto img_b_zero = sln::box_filter<3, sln::BorderAccessMode::ZeroPadding>(img);
+  REQUIRE(img_b_zero(0_idx, 0_idx) == std::uint8_t(std::lround(200.0 * 4.0 / 9.0)));
+  REQUIRE(img_b_zero(1_idx, 0_idx) == std::uint8_t(std::lround(200.0 * 6.0 / 9.0)));
+  REQUIRE(img_b_zero(1_idx, 1_idx) == 200);
+
+  // Single impulse: the result is the (outer product of the) kernel, scaled.
+  sln::Image_32f1 img_impulse(9_px, 9_px);
+  sln::for_each_pixel(img_impulse, [](auto& px) { px = sln::Pixel_32f1(0.0f); });
+  img_impulse(4_idx, 4_idx) = 1.0f;
+
+  sln::ThreadPool thread_pool(2);
+  const auto img_impulse_g = sln::gaussian_blur<5>(img_impulse, 1.0f, thread_pool);
+  const auto kernel = sln::gaussian_kernel<5>(1.0f);
+  for (auto y = 0_idx; y < img_impulse_g.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img_impulse_g.width(); ++x)
+    {
+      const bool inside = std::abs(x - 4) <= 2 && std::abs(y - 4) <= 2;
+      const auto expected = inside ? kernel[std::size_t(x - 2)] * kernel[std::size_t(y - 2)] : 0.0f;
+      REQUIRE(img_impulse_g(x, y) == Approx(expected).margin(1e-6));
+    }
+  }
+
+  const auto img_impulse_b = sln::box_filter<3>(img_impulse, thread_pool);
+  REQUIRE(img_impulse_b(3_idx, 5_idx) == Approx(1.0f / 9.0f));
+  REQUIRE(img_impulse_b(2_idx, 5_idx) == Approx(0.0f).margin(1e-6));
+}
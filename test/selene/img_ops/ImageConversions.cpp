@@ -6,8 +6,15 @@
 
 #include <selene/img_ops/ImageConversions.hpp>
 
+#include <selene/thread/ThreadPool.hpp>
+
 #include <test/selene/img/_TestImages.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <type_traits>
+
 using namespace sln::literals;
 
 TEST_CASE("Image conversions", "[img]")
@@ -87,3 +94,166 @@ TEST_CASE("Image conversions", "[img]")
     REQUIRE(img_rgba_1 == img_rgba);
   }
 }
+
+namespace {
+
+template <sln::PixelFormat pixel_format_src, sln::PixelFormat pixel_format_dst, typename PixelSrc>
+void check_image_conversion_against_pixel_conversion(const sln::Image<PixelSrc>& img_src)
+{
+  const auto img_dst = sln::convert_image<pixel_format_src, pixel_format_dst>(img_src);
+  REQUIRE(img_dst.width() == img_src.width());
+  REQUIRE(img_dst.height() == img_src.height());
+
+  for (auto y = 0_idx; y < img_src.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img_src.width(); ++x)
+    {
+      REQUIRE(img_dst(x, y) == (sln::convert_pixel<pixel_format_src, pixel_format_dst>(img_src(x, y))));
+    }
+  }
+}
+
+template <sln::PixelFormat pixel_format_src, sln::PixelFormat pixel_format_dst, typename PixelSrc>
+void check_image_conversion_against_pixel_conversion(const sln::Image<PixelSrc>& img_src, std::false_type)
+{
+  check_image_conversion_against_pixel_conversion<pixel_format_src, pixel_format_dst>(img_src);
+}
+
+template <sln::PixelFormat pixel_format_src, sln::PixelFormat pixel_format_dst, typename PixelSrc>
+void check_image_conversion_against_pixel_conversion(const sln::Image<PixelSrc>& img_src,
+                                                     std::true_type /* requires alpha value */)
+{
+  const auto alpha_value = std::uint8_t{0xA5};
+  const auto img_dst = sln::convert_image<pixel_format_src, pixel_format_dst>(img_src, alpha_value);
+  REQUIRE(img_dst.width() == img_src.width());
+  REQUIRE(img_dst.height() == img_src.height());
+
+  for (auto y = 0_idx; y < img_src.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img_src.width(); ++x)
+    {
+      REQUIRE(img_dst(x, y) == (sln::convert_pixel<pixel_format_src, pixel_format_dst>(img_src(x, y), alpha_value)));
+    }
+  }
+}
+
+// Checks the conversions from the given source format to all 3- and 4-channel color formats.
+template <sln::PixelFormat pixel_format_src, typename PixelSrc>
+void check_color_conversions_against_pixel_conversion(const sln::Image<PixelSrc>& img_src)
+{
+  using namespace sln;
+  const auto check = [&img_src](auto pixel_format_dst) {
+    constexpr auto fmt = decltype(pixel_format_dst)::value;
+    check_image_conversion_against_pixel_conversion<pixel_format_src, fmt>(
+        img_src, std::integral_constant<bool, conversion_requires_alpha_value(pixel_format_src, fmt)>{});
+  };
+
+  check(std::integral_constant<PixelFormat, PixelFormat::RGB>{});
+  check(std::integral_constant<PixelFormat, PixelFormat::BGR>{});
+  check(std::integral_constant<PixelFormat, PixelFormat::RGBA>{});
+  check(std::integral_constant<PixelFormat, PixelFormat::BGRA>{});
+  check(std::integral_constant<PixelFormat, PixelFormat::ARGB>{});
+  check(std::integral_constant<PixelFormat, PixelFormat::ABGR>{});
+}
+
+}  // namespace
+
+TEST_CASE("Image conversions (vectorized rows)", "[img]")
+{
+  std::mt19937 rng(42ul);
+
+  // Various widths to cover vectorized parts and scalar remainders of the rows
+  for (auto width : {1, 2, 15, 16, 17, 18, 31, 33, 34, 47, 64, 65, 100, 257})
+  {
+    const auto w = sln::PixelLength{width};
+    const auto h = 3_px;
+
+    const auto img_3 = sln_test::make_random_image<sln::Pixel_8u3>(w, h, rng);
+    check_image_conversion_against_pixel_conversion<sln::PixelFormat::RGB, sln::PixelFormat::Y>(img_3);
+    check_image_conversion_against_pixel_conversion<sln::PixelFormat::BGR, sln::PixelFormat::Y>(img_3);
+
+    const auto img_4 = sln_test::make_random_image<sln::Pixel_8u4>(w, h, rng);
+    check_image_conversion_against_pixel_conversion<sln::PixelFormat::RGBA, sln::PixelFormat::Y>(img_4);
+    check_image_conversion_against_pixel_conversion<sln::PixelFormat::BGRA, sln::PixelFormat::Y>(img_4);
+    check_image_conversion_against_pixel_conversion<sln::PixelFormat::ARGB, sln::PixelFormat::Y>(img_4);
+    check_image_conversion_against_pixel_conversion<sln::PixelFormat::ABGR, sln::PixelFormat::Y>(img_4);
+
+    const auto img_1 = sln_test::make_random_image<sln::Pixel_8u1>(w, h, rng);
+    check_color_conversions_against_pixel_conversion<sln::PixelFormat::Y>(img_1);
+    check_color_conversions_against_pixel_conversion<sln::PixelFormat::RGB>(img_3);
+    check_color_conversions_against_pixel_conversion<sln::PixelFormat::BGR>(img_3);
+    check_color_conversions_against_pixel_conversion<sln::PixelFormat::RGBA>(img_4);
+    check_color_conversions_against_pixel_conversion<sln::PixelFormat::BGRA>(img_4);
+    check_color_conversions_against_pixel_conversion<sln::PixelFormat::ARGB>(img_4);
+    check_color_conversions_against_pixel_conversion<sln::PixelFormat::ABGR>(img_4);
+
+    // Views with row padding and unaligned start (which need to lie within the image)
+    if (width >= 3)
+    {
+      const auto sub_width = sln::PixelLength{width - 2};
+      const auto img_4_view = sln::view(img_4, 1_idx, 1_idx, sub_width, 2_px);
+      check_image_conversion_against_pixel_conversion<sln::PixelFormat::RGBA, sln::PixelFormat::Y>(img_4_view);
+      check_image_conversion_against_pixel_conversion<sln::PixelFormat::RGBA, sln::PixelFormat::ARGB>(img_4_view);
+      const auto img_3_view = sln::view(img_3, 1_idx, 1_idx, sub_width, 2_px);
+      check_color_conversions_against_pixel_conversion<sln::PixelFormat::BGR>(img_3_view);
+    }
+
+    // SIMD-padded images, for which the kernels also process the last partial vector of each row
+    sln::Image_8u3 img_3_padded(w, h, sln::ImageLayout::SimdPadded);
+    sln::Image_8u4 img_4_padded(w, h, sln::ImageLayout::SimdPadded);
+    sln::Image_8u1 img_y_padded(w, h, sln::ImageLayout::SimdPadded);
+    sln::Image_8u4 img_bgra_padded(w, h, sln::ImageLayout::SimdPadded);
+
+    for (auto y = 0_idx; y < h; ++y)
+    {
+      std::copy(img_3.data(y), img_3.data_row_end(y), img_3_padded.data(y));
+      std::copy(img_4.data(y), img_4.data_row_end(y), img_4_padded.data(y));
+    }
+
+    sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::Y>(img_3_padded, img_y_padded);
+    REQUIRE(img_y_padded == (sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::Y>(img_3)));
+    sln::convert_image<sln::PixelFormat::RGBA, sln::PixelFormat::Y>(img_4_padded, img_y_padded);
+    REQUIRE(img_y_padded == (sln::convert_image<sln::PixelFormat::RGBA, sln::PixelFormat::Y>(img_4)));
+    sln::convert_image<sln::PixelFormat::RGBA, sln::PixelFormat::BGRA>(img_4_padded, img_bgra_padded);
+    REQUIRE(img_bgra_padded == (sln::convert_image<sln::PixelFormat::RGBA, sln::PixelFormat::BGRA>(img_4)));
+
+    sln::Image_8u3 img_bgr_padded(w, h, sln::ImageLayout::SimdPadded);
+    sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::BGR>(img_3_padded, img_bgr_padded);
+    REQUIRE(img_bgr_padded == (sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::BGR>(img_3)));
+    sln::convert_image<sln::PixelFormat::ARGB, sln::PixelFormat::BGR>(img_4_padded, img_bgr_padded);
+    REQUIRE(img_bgr_padded == (sln::convert_image<sln::PixelFormat::ARGB, sln::PixelFormat::BGR>(img_4)));
+    sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::ABGR>(img_3_padded, img_bgra_padded, std::uint8_t{7});
+    REQUIRE(img_bgra_padded
+            == (sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::ABGR>(img_3, std::uint8_t{7})));
+    const auto img_y = sln::convert_image<sln::PixelFormat::RGBA, sln::PixelFormat::Y>(img_4);
+    sln::convert_image<sln::PixelFormat::Y, sln::PixelFormat::BGRA>(img_y_padded, img_bgra_padded, std::uint8_t{7});
+    REQUIRE(img_bgra_padded
+            == (sln::convert_image<sln::PixelFormat::Y, sln::PixelFormat::BGRA>(img_y, std::uint8_t{7})));
+    REQUIRE(img_y_padded.simd_safe_tail());
+    REQUIRE(img_bgra_padded.simd_safe_tail());
+  }
+}
+
+TEST_CASE("Image conversions on a thread pool", "[img]")
+{
+  std::mt19937 rng(42ul);
+  sln::ThreadPool thread_pool(3);
+
+  const auto img_xxx = sln_test::make_random_image<sln::Pixel_8u3>(77_px, 41_px, rng);
+
+  const auto img_y = sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::Y>(img_xxx);
+  REQUIRE((sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::Y>(img_xxx, thread_pool) == img_y));
+
+  sln::Image_8u1 img_y_p;
+  sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::Y>(img_xxx, img_y_p, thread_pool);
+  REQUIRE(img_y_p == img_y);
+
+  const auto img_rgba = sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::RGBA>(img_xxx, std::uint8_t{128});
+  REQUIRE((sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::RGBA>(img_xxx, std::uint8_t{128}, thread_pool)
+           == img_rgba));
+
+  sln::Image_8u4 img_rgba_p;
+  sln::convert_image<sln::PixelFormat::RGB, sln::PixelFormat::RGBA>(img_xxx, img_rgba_p, std::uint8_t{128},
+                                                                    thread_pool);
+  REQUIRE(img_rgba_p == img_rgba);
+}
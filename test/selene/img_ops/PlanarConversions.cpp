@@ -0,0 +1,102 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch.hpp>
+
+#include <selene/img_ops/PlanarConversions.hpp>
+
+#include <selene/thread/ThreadPool.hpp>
+
+#include <test/selene/img/_TestImages.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace sln::literals;
+
+namespace {
+
+template <typename T, std::size_t N>
+void check_planar_conversions(const sln::Image<sln::Pixel<T, N>>& img)
+{
+  const auto img_planar = sln::deinterleave(img);
+  REQUIRE(img_planar.width() == img.width());
+  REQUIRE(img_planar.height() == img.height());
+
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      REQUIRE(img_planar.pixel(x, y) == img(x, y));
+    }
+  }
+
+  REQUIRE(sln::interleave(img_planar) == img);
+
+  // SIMD-padded images, for which the kernels also process the last partial vector of each row
+  sln::Image<sln::Pixel<T, N>> img_padded(img.width(), img.height(), sln::ImageLayout::SimdPadded);
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    std::copy(img.data(y), img.data_row_end(y), img_padded.data(y));
+  }
+
+  sln::PlanarImage<T, N> img_planar_padded(img.width(), img.height(), sln::ImageLayout::SimdPadded);
+  sln::deinterleave(img_padded, img_planar_padded);
+  REQUIRE(img_planar_padded == img_planar);
+
+  sln::Image<sln::Pixel<T, N>> img_padded_dst(img.width(), img.height(), sln::ImageLayout::SimdPadded);
+  sln::interleave(img_planar_padded, img_padded_dst);
+  REQUIRE(img_padded_dst == img);
+}
+
+}  // namespace
+
+TEST_CASE("Planar conversions", "[img]")
+{
+  std::mt19937 rng(42ul);
+
+  // Various widths to cover vectorized parts and scalar remainders of the rows
+  for (auto width : {1, 2, 15, 16, 17, 31, 32, 33, 47, 64, 65, 100, 257})
+  {
+    const auto w = sln::PixelLength{width};
+    const auto h = 3_px;
+
+    const auto img_8u3 = sln_test::make_random_image<sln::Pixel_8u3>(w, h, rng);
+    check_planar_conversions(img_8u3);
+
+    const auto img_8u4 = sln_test::make_random_image<sln::Pixel_8u4>(w, h, rng);
+    check_planar_conversions(img_8u4);
+
+    check_planar_conversions(sln_test::make_random_image<sln::Pixel_16u3>(w, h, rng));
+    check_planar_conversions(sln_test::make_random_image<sln::Pixel_16u4>(w, h, rng));
+
+    // Views with row padding and unaligned start (which need to lie within the image)
+    if (width >= 3)
+    {
+      const auto sub_width = sln::PixelLength{width - 2};
+      check_planar_conversions(sln::view(img_8u3, 1_idx, 1_idx, sub_width, 2_px));
+      check_planar_conversions(sln::view(img_8u4, 1_idx, 1_idx, sub_width, 2_px));
+    }
+  }
+}
+
+TEST_CASE("Planar conversions on a thread pool", "[img]")
+{
+  std::mt19937 rng(42ul);
+  sln::ThreadPool thread_pool(3);
+
+  const auto img_xxx = sln_test::make_random_image<sln::Pixel_8u3>(77_px, 41_px, rng);
+  const auto img_planar = sln::deinterleave(img_xxx);
+
+  REQUIRE(sln::deinterleave(img_xxx, thread_pool) == img_planar);
+  REQUIRE(sln::interleave(img_planar, thread_pool) == img_xxx);
+
+  sln::PlanarImage_8u3 img_planar_p;
+  sln::deinterleave(img_xxx, img_planar_p, thread_pool);
+  REQUIRE(img_planar_p == img_planar);
+
+  sln::Image_8u3 img_xxx_p;
+  sln::interleave(img_planar_p, img_xxx_p, thread_pool);
+  REQUIRE(img_xxx_p == img_xxx);
+}
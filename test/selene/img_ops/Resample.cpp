@@ -5,10 +5,16 @@
 #include <catch.hpp>
 
 #include <selene/img/Interpolators.hpp>
+#include <selene/img_ops/Algorithms.hpp>
 #include <selene/img_ops/Resample.hpp>
 
+#include <selene/thread/ThreadPool.hpp>
+
 #include <test/selene/img/_TestImages.hpp>
 
+#include <cstdlib>
+#include <random>
+
 using namespace sln::literals;
 
 TEST_CASE("Image resampling", "[img]")
@@ -54,3 +60,202 @@ TEST_CASE("Image resampling", "[img]")
     }
   }
 }
+
+TEST_CASE("Image resampling on a thread pool", "[img]")
+{
+  std::mt19937 rng(42);
+  sln::ThreadPool thread_pool(3);
+
+  const auto img = sln_test::make_random_image<sln::Pixel_8u3>(37_px, 23_px, rng);
+
+  for (const auto size : {1, 5, 23, 50, 111})
+  {
+    const auto w = sln::PixelLength{size};
+    const auto h = sln::PixelLength{size + 3};
+
+    const auto img_nn = sln::resample<sln::ImageInterpolationMode::NearestNeighbor>(img, w, h);
+    const auto img_nn_p = sln::resample<sln::ImageInterpolationMode::NearestNeighbor>(img, w, h, thread_pool);
+    REQUIRE(img_nn_p == img_nn);
+
+    const auto img_bl = sln::resample<sln::ImageInterpolationMode::Bilinear>(img, w, h);
+    const auto img_bl_p = sln::resample<sln::ImageInterpolationMode::Bilinear>(img, w, h, thread_pool);
+    REQUIRE(img_bl_p == img_bl);
+
+    const auto img_lz = sln::resample<sln::ImageInterpolationMode::Lanczos3>(img, w, h);
+    const auto img_lz_p = sln::resample<sln::ImageInterpolationMode::Lanczos3>(img, w, h, thread_pool);
+    REQUIRE(img_lz_p == img_lz);
+  }
+}
+
+namespace {
+
+template <sln::ImageInterpolationMode interpolation_mode, typename PixelType>
+void check_constant_image_resampling(PixelType value)
+{
+  sln::Image<PixelType> img(41_px, 29_px);
+  sln::for_each_pixel(img, [value](auto& px) { px = value; });
+
+  for (const auto size : {1, 3, 10, 29, 41, 100})
+  {
+    const auto img_r = sln::resample<interpolation_mode>(img, sln::PixelLength{size}, sln::PixelLength{size + 1});
+    REQUIRE(img_r.width() == size);
+    REQUIRE(img_r.height() == size + 1);
+
+    for (auto y = 0_idx; y < img_r.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img_r.width(); ++x)
+      {
+        for (std::size_t c = 0; c < sln::PixelTraits<PixelType>::nr_channels; ++c)
+        {
+          REQUIRE(static_cast<double>(img_r(x, y)[c]) == Approx(static_cast<double>(value[c])).margin(1.0));
+        }
+      }
+    }
+  }
+}
+
+template <sln::ImageInterpolationMode interpolation_mode>
+void check_checkerboard_downsampling()
+{
+  // Nearest neighbor or bilinear sampling would alias a pixel-level checkerboard; filter based modes average it.
+  sln::Image_8u1 img(160_px, 96_px);
+  for (auto y = 0_idx; y < img.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img.width(); ++x)
+    {
+      img(x, y) = ((x + y) % 2 == 0) ? 0 : 255;
+    }
+  }
+
+  const auto img_r = sln::resample<interpolation_mode>(img, 20_px, 12_px);
+  for (auto y = 1_idx; y < img_r.height() - 1; ++y)
+  {
+    for (auto x = 1_idx; x < img_r.width() - 1; ++x)
+    {
+      REQUIRE(int(img_r(x, y)) == Approx(127.5).margin(3.0));
+    }
+  }
+}
+
+template <typename PixelType>
+void check_fixed_point_bilinear_resampling(const sln::Image<PixelType>& img,
+                                           sln::PixelLength new_width,
+                                           sln::PixelLength new_height,
+                                           sln::ThreadPool& thread_pool)
+{
+  using Interpolator = sln::ImageInterpolator<sln::ImageInterpolationMode::Bilinear,
+                                              sln::BorderAccessMode::Replicated,
+                                              sln::InterpolationPrecision::FixedPoint>;
+  constexpr auto mode = sln::ImageInterpolationMode::Bilinear;
+  constexpr auto precision = sln::InterpolationPrecision::FixedPoint;
+
+  const auto img_r = sln::resample<mode, precision>(img, new_width, new_height);
+  REQUIRE(img_r.width() == new_width);
+  REQUIRE(img_r.height() == new_height);
+
+  const auto factor_x = img.width() / static_cast<sln::default_float_t>(new_width);
+  const auto factor_y = img.height() / static_cast<sln::default_float_t>(new_height);
+  for (auto y = 0_idx; y < img_r.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img_r.width(); ++x)
+    {
+      REQUIRE(img_r(x, y) == Interpolator::interpolate(img, x * factor_x, y * factor_y));
+    }
+  }
+
+  const auto img_r_mt = sln::resample<mode, precision>(img, new_width, new_height, thread_pool);
+  REQUIRE(img_r_mt == img_r);
+}
+
+}  // namespace
+
+TEST_CASE("Image resampling, filter based modes", "[img]")
+{
+  check_constant_image_resampling<sln::ImageInterpolationMode::Area>(sln::Pixel_8u3(10, 128, 255));
+  check_constant_image_resampling<sln::ImageInterpolationMode::Bicubic>(sln::Pixel_8u3(10, 128, 255));
+  check_constant_image_resampling<sln::ImageInterpolationMode::Lanczos3>(sln::Pixel_8u3(10, 128, 255));
+  check_constant_image_resampling<sln::ImageInterpolationMode::Lanczos3>(sln::Pixel_16u1(40000));
+  check_constant_image_resampling<sln::ImageInterpolationMode::Bicubic>(sln::Pixel_32f2(-1.5f, 1000.0f));
+
+  check_checkerboard_downsampling<sln::ImageInterpolationMode::Area>();
+  check_checkerboard_downsampling<sln::ImageInterpolationMode::Bicubic>();
+  check_checkerboard_downsampling<sln::ImageInterpolationMode::Lanczos3>();
+
+  SECTION("Area, integral factor")
+  {
+    std::mt19937 rng(42);
+    const auto img = sln_test::make_random_image<sln::Pixel_8u1>(40_px, 30_px, rng);
+    const auto img_r = sln::resample<sln::ImageInterpolationMode::Area>(img, 10_px, 10_px);
+
+    for (auto y = 0_idx; y < img_r.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img_r.width(); ++x)
+      {
+        double sum = 0.0;
+        for (auto yy = 3 * y; yy < 3 * y + 3; ++yy)
+        {
+          for (auto xx = 4 * x; xx < 4 * x + 4; ++xx)
+          {
+            sum += img(sln::PixelIndex{xx}, sln::PixelIndex{yy});
+          }
+        }
+        REQUIRE(int(img_r(x, y)) == Approx(sum / 12.0).margin(1.0));
+      }
+    }
+  }
+
+  SECTION("Bicubic, upsampling a linear ramp")
+  {
+    sln::Image_32f1 img(10_px, 10_px);
+    for (auto y = 0_idx; y < img.height(); ++y)
+    {
+      for (auto x = 0_idx; x < img.width(); ++x)
+      {
+        img(x, y) = float(x) + 10.0f * float(y);
+      }
+    }
+
+    const auto img_r = sln::resample<sln::ImageInterpolationMode::Bicubic>(img, 40_px, 20_px);
+    for (auto y = 4_idx; y < img_r.height() - 4; ++y)
+    {
+      for (auto x = 8_idx; x < img_r.width() - 8; ++x)
+      {
+        const auto x_src = (x + 0.5) * 0.25 - 0.5;
+        const auto y_src = (y + 0.5) * 0.5 - 0.5;
+        REQUIRE(img_r(x, y) == Approx(x_src + 10.0 * y_src).margin(1e-4));
+      }
+    }
+  }
+}
+
+TEST_CASE("Image resampling, fixed-point bilinear", "[img]")
+{
+  std::mt19937 rng(42);
+  sln::ThreadPool thread_pool(3);
+
+  const auto img_8u3 = sln_test::make_random_image<sln::Pixel_8u3>(37_px, 23_px, rng);
+  const auto img_16u1 = sln_test::make_random_image<sln::Pixel_16u1>(37_px, 23_px, rng);
+
+  for (const auto size : {1, 5, 23, 50, 111})
+  {
+    const auto w = sln::to_pixel_length(size);
+    const auto h = sln::to_pixel_length(size + 3);
+    check_fixed_point_bilinear_resampling(img_8u3, w, h, thread_pool);
+    check_fixed_point_bilinear_resampling(img_16u1, w, h, thread_pool);
+  }
+
+  // The integer results of the floating point path are truncated, so values can differ by one (but not more).
+  const auto img_float = sln::resample<sln::ImageInterpolationMode::Bilinear>(img_8u3, 80_px, 50_px);
+  const auto img_fixed = sln::resample<sln::ImageInterpolationMode::Bilinear, sln::InterpolationPrecision::FixedPoint>(
+      img_8u3, 80_px, 50_px);
+  for (auto y = 0_idx; y < img_fixed.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img_fixed.width(); ++x)
+    {
+      for (std::size_t c = 0; c < 3; ++c)
+      {
+        REQUIRE(std::abs(int(img_fixed(x, y)[c]) - int(img_float(x, y)[c])) <= 1);
+      }
+    }
+  }
+}
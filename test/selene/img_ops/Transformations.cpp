@@ -6,12 +6,53 @@
 
 #include <selene/img_ops/Transformations.hpp>
 
+#include <selene/thread/ThreadPool.hpp>
+
 #include <random>
 
 #include <test/selene/img/_TestImages.hpp>
 
 using namespace sln::literals;
 
+namespace {
+
+template <bool flip_h, bool flip_v, typename PixelType>
+sln::Image<PixelType> reference_transpose(const sln::Image<PixelType>& img)
+{
+  sln::Image<PixelType> img_t(img.height(), img.width());
+  for (auto y = 0_idx; y < img_t.height(); ++y)
+  {
+    for (auto x = 0_idx; x < img_t.width(); ++x)
+    {
+      const auto src_x = flip_v ? sln::PixelIndex{img.width() - 1 - y} : y;
+      const auto src_y = flip_h ? sln::PixelIndex{img.height() - 1 - x} : x;
+      img_t(x, y) = img(src_x, src_y);
+    }
+  }
+  return img_t;
+}
+
+template <typename PixelType>
+void check_tiled_transpose(std::mt19937& rng, sln::ThreadPool& thread_pool)
+{
+  // Sizes around multiples of the block and tile sizes
+  for (const auto width : {1, 3, 8, 13, 32, 37, 67})
+  {
+    for (const auto height : {1, 4, 9, 31, 64, 70})
+    {
+      const auto img = sln_test::make_random_image<PixelType>(sln::to_pixel_length(width),
+                                                              sln::to_pixel_length(height), rng);
+      REQUIRE((sln::transpose<false, false>(img) == reference_transpose<false, false>(img)));
+      REQUIRE((sln::transpose<true, false>(img) == reference_transpose<true, false>(img)));
+      REQUIRE((sln::transpose<false, true>(img) == reference_transpose<false, true>(img)));
+      REQUIRE((sln::transpose<true, true>(img) == reference_transpose<true, true>(img)));
+      REQUIRE((sln::transpose<true, true>(img, thread_pool) == reference_transpose<true, true>(img)));
+    }
+  }
+}
+
+}  // namespace
+
 TEST_CASE("Image transformations", "[img]")
 {
   std::mt19937 rng(100);
@@ -109,3 +150,48 @@ TEST_CASE("Image transformations", "[img]")
             == sln::rotate<sln::RotationDirection::Counterclockwise90>(img));
   }
 }
+
+TEST_CASE("Image transformations on a thread pool", "[img]")
+{
+  std::mt19937 rng(100);
+  std::uniform_int_distribution<sln::PixelIndex::value_type> dist_size(0, 64);
+  sln::ThreadPool thread_pool(3);
+
+  for (std::size_t count = 0; count < 32; ++count)
+  {
+    const auto width = sln::PixelLength{dist_size(rng)};
+    const auto height = sln::PixelLength{dist_size(rng)};
+    const auto img = sln_test::make_random_image<sln::Pixel_8u3>(width, height, rng);
+
+    REQUIRE((sln::transpose(img, thread_pool) == sln::transpose(img)));
+    REQUIRE((sln::transpose<true, false>(img, thread_pool) == sln::rotate<sln::RotationDirection::Clockwise90>(img)));
+    REQUIRE((sln::transpose<false, true>(img, thread_pool) == sln::rotate<sln::RotationDirection::Clockwise270>(img)));
+
+    REQUIRE(sln::flip<sln::FlipDirection::Horizontal>(img, thread_pool)
+            == sln::flip<sln::FlipDirection::Horizontal>(img));
+    REQUIRE(sln::flip<sln::FlipDirection::Vertical>(img, thread_pool) == sln::flip<sln::FlipDirection::Vertical>(img));
+    REQUIRE(sln::flip<sln::FlipDirection::Both>(img, thread_pool) == sln::flip<sln::FlipDirection::Both>(img));
+
+    REQUIRE(sln::rotate<sln::RotationDirection::Clockwise0>(img, thread_pool)
+            == sln::rotate<sln::RotationDirection::Clockwise0>(img));
+    REQUIRE(sln::rotate<sln::RotationDirection::Clockwise90>(img, thread_pool)
+            == sln::rotate<sln::RotationDirection::Clockwise90>(img));
+    REQUIRE(sln::rotate<sln::RotationDirection::Clockwise180>(img, thread_pool)
+            == sln::rotate<sln::RotationDirection::Clockwise180>(img));
+    REQUIRE(sln::rotate<sln::RotationDirection::Clockwise270>(img, thread_pool)
+            == sln::rotate<sln::RotationDirection::Clockwise270>(img));
+  }
+}
+
+TEST_CASE("Image transposition, tiled", "[img]")
+{
+  std::mt19937 rng(200);
+  sln::ThreadPool thread_pool(3);
+
+  check_tiled_transpose<sln::Pixel_8u1>(rng, thread_pool);
+  check_tiled_transpose<sln::Pixel_8u2>(rng, thread_pool);
+  check_tiled_transpose<sln::Pixel_8u3>(rng, thread_pool);
+  check_tiled_transpose<sln::Pixel_8u4>(rng, thread_pool);
+  check_tiled_transpose<sln::Pixel_16u1>(rng, thread_pool);
+  check_tiled_transpose<sln::Pixel_32f3>(rng, thread_pool);
+}
@@ -8,6 +8,7 @@
 #include <selene/io/FileReader.hpp>
 #include <selene/io/FileUtils.hpp>
 #include <selene/io/FileWriter.hpp>
+#include <selene/io/MMapReader.hpp>
 #include <selene/io/MemoryReader.hpp>
 #include <selene/io/MemoryWriter.hpp>
 #include <selene/io/VectorReader.hpp>
@@ -30,6 +31,11 @@ bool handle_valid(sln::FileWriter& source)
   return source.handle() != nullptr;
 }
 
+bool handle_valid(sln::MMapReader& source)
+{
+  return source.handle() != nullptr;
+}
+
 bool handle_valid(sln::MemoryReader& source)
 {
   return source.handle() != nullptr;
@@ -159,8 +165,10 @@ TEST_CASE("Test I/O classes", "[io]")
   const auto& filename_str = filename.string();
   write_test_1<sln::FileWriter>(&filename_str);
   read_test_1<sln::FileReader>(&filename_str);
+  read_test_1<sln::MMapReader>(&filename_str);
   write_test_2<sln::FileWriter>(&filename_str);
   read_test_2<sln::FileReader>(&filename_str);
+  read_test_2<sln::MMapReader>(&filename_str);
 
   std::vector<std::uint8_t> vec;
   write_test_1<sln::VectorWriter>(&vec);
@@ -169,6 +177,51 @@ TEST_CASE("Test I/O classes", "[io]")
   read_test_2<sln::VectorReader>(&vec);
 }
 
+TEST_CASE("Test memory-mapped file reading", "[io]")
+{
+  const auto tmp_path = sln_test::get_tmp_path();
+  const auto filename = (tmp_path / "test_mmap.bin").string();
+
+  std::vector<std::uint8_t> data(100000);
+  std::mt19937 rng(42);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::generate(data.begin(), data.end(), [&]() { return static_cast<std::uint8_t>(dist(rng)); });
+  sln::write_data_contents(filename, data.data(), data.size());
+
+  sln::MMapReader source(filename);
+  REQUIRE(source.is_open());
+  REQUIRE(source.size() == data.size());
+  REQUIRE(source.bytes_remaining() == static_cast<std::ptrdiff_t>(data.size()));
+  REQUIRE(std::memcmp(source.handle(), data.data(), data.size()) == 0);
+
+  std::vector<std::uint8_t> buffer(data.size() + 10);
+  REQUIRE(source.seek_abs(1000));
+  REQUIRE(source.read(buffer.data(), 500) == 500);
+  REQUIRE(std::memcmp(buffer.data(), data.data() + 1000, 500) == 0);
+  REQUIRE(source.position() == 1500);
+  REQUIRE(source.bytes_remaining() == static_cast<std::ptrdiff_t>(data.size() - 1500));
+
+  // Reads past the end are truncated
+  REQUIRE(source.read(buffer.data(), buffer.size()) == data.size() - 1500);
+  REQUIRE(source.is_eof());
+  REQUIRE(source.bytes_remaining() == 0);
+  REQUIRE(!source.seek_abs(static_cast<std::ptrdiff_t>(data.size()) + 1));
+  REQUIRE(source.seek_rel(-10));
+  REQUIRE(sln::read<std::uint8_t>(source) == data[data.size() - 10]);
+
+  // Ownership of the mapping is transferred on move
+  sln::MMapReader source_2(std::move(source));
+  REQUIRE(!source.is_open());
+  REQUIRE(source_2.is_open());
+  REQUIRE(source_2.position() == static_cast<std::ptrdiff_t>(data.size()) - 9);
+
+  // Non-existing or empty files cannot be mapped
+  REQUIRE(!source.open((tmp_path / "non_existing_file.bin").string()));
+  REQUIRE_THROWS_AS(sln::MMapReader((tmp_path / "non_existing_file.bin").string()), std::runtime_error);
+  sln::write_data_contents((tmp_path / "test_mmap_empty.bin").string(), data.data(), 0);
+  REQUIRE(!source.open((tmp_path / "test_mmap_empty.bin").string()));
+}
+
 TEST_CASE("Test binary data I/O", "[io]")
 {
   const auto tmp_path = sln_test::get_tmp_path();
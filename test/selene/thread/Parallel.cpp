@@ -0,0 +1,141 @@
+// This file is part of the `Selene` library.
+// Copyright 2017-2018 Michael Hofmann (https://github.com/kmhofmann).
+// Distributed under MIT license. See accompanying LICENSE file in the top-level directory.
+
+#include <catch.hpp>
+
+#include <selene/thread/Parallel.hpp>
+#include <selene/thread/ThreadPool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Parallel for", "[thread]")
+{
+  for (const auto scheduler : {sln::ThreadPoolScheduler::WorkStealing, sln::ThreadPoolScheduler::MultiQueue})
+  {
+    sln::ThreadPool pool(4, scheduler);
+
+    for (const std::int64_t grain : {1, 7, 64, 1000, 5000})
+    {
+      const std::int64_t begin = 13;
+      const std::int64_t end = 4013;
+      std::vector<int> visited(static_cast<std::size_t>(end), 0);
+      std::atomic<std::int64_t> nr_blocks{0};
+      std::atomic<bool> blocks_valid{true};
+
+      // Catch assertions are not thread-safe, so everything is checked afterwards.
+      sln::parallel_for(pool, begin, end, grain, [&](std::int64_t block_begin, std::int64_t block_end) {
+        if (block_begin >= block_end || block_end - block_begin > grain || (block_begin - begin) % grain != 0)
+        {
+          blocks_valid = false;
+        }
+
+        for (auto i = block_begin; i < block_end; ++i)
+        {
+          ++visited[static_cast<std::size_t>(i)];
+        }
+        ++nr_blocks;
+      });
+
+      REQUIRE(blocks_valid);
+      REQUIRE(nr_blocks == (end - begin + grain - 1) / grain);
+      REQUIRE(std::all_of(visited.cbegin(), visited.cbegin() + begin, [](int v) { return v == 0; }));
+      REQUIRE(std::all_of(visited.cbegin() + begin, visited.cend(), [](int v) { return v == 1; }));
+    }
+
+    // Empty range
+    bool called = false;
+    sln::parallel_for(pool, 10, 10, 1, [&](int, int) { called = true; });
+    REQUIRE(!called);
+  }
+}
+
+TEST_CASE("Parallel for, nested and with exceptions", "[thread]")
+{
+  sln::ThreadPool pool(4);
+
+  // Nested invocation from within pool tasks must not deadlock, since the calling thread takes part in the work.
+  std::atomic<std::int64_t> sum{0};
+  std::vector<std::future<void>> futures;
+  for (int t = 0; t < 8; ++t)
+  {
+    futures.push_back(pool.push([&pool, &sum]() {
+      sln::parallel_for(pool, 0, 1000, 10, [&sum](int b, int e) {
+        for (auto i = b; i < e; ++i)
+        {
+          sum += i;
+        }
+      });
+    }));
+  }
+  std::for_each(futures.begin(), futures.end(), [](std::future<void>& f) { f.get(); });
+  REQUIRE(sum == 8 * (999 * 1000 / 2));
+
+  // The first exception is propagated to the caller.
+  std::atomic<int> nr_calls{0};
+  REQUIRE_THROWS_AS(sln::parallel_for(pool, 0, 100, 1,
+                                      [&nr_calls](int b, int) {
+                                        ++nr_calls;
+                                        if (b == 50)
+                                        {
+                                          throw std::runtime_error("error");
+                                        }
+                                      }),
+                    std::runtime_error);
+  REQUIRE(nr_calls <= 100);
+
+  // The pool remains usable afterwards.
+  std::atomic<int> count{0};
+  sln::parallel_for(pool, 0, 100, 1, [&count](int b, int e) { count += e - b; });
+  REQUIRE(count == 100);
+}
+
+TEST_CASE("Parallel reduce", "[thread]")
+{
+  sln::ThreadPool pool(4);
+
+  std::vector<std::uint32_t> values(100003);
+  std::iota(values.begin(), values.end(), std::uint32_t{0});
+  const auto expected_sum = std::accumulate(values.cbegin(), values.cend(), std::uint64_t{0});
+
+  for (const std::size_t grain : {1, 100, 4096, 200000})
+  {
+    const auto sum = sln::parallel_reduce(
+        pool, std::size_t{0}, values.size(), grain, std::uint64_t{0},
+        [&values](std::size_t b, std::size_t e) {
+          return std::accumulate(values.cbegin() + b, values.cbegin() + e, std::uint64_t{0});
+        },
+        [](std::uint64_t a, std::uint64_t b) { return a + b; });
+    REQUIRE(sum == expected_sum);
+
+    const auto max_value = sln::parallel_reduce(
+        pool, std::size_t{0}, values.size(), grain, std::uint32_t{0},
+        [&values](std::size_t b, std::size_t e) { return *std::max_element(values.cbegin() + b, values.cbegin() + e); },
+        [](std::uint32_t a, std::uint32_t b) { return std::max(a, b); });
+    REQUIRE(max_value == 100002);
+  }
+
+  // Reduction happens in block order, also for non-commutative operations.
+  const auto concatenated = sln::parallel_reduce(
+      pool, 0, 10, 3, std::vector<int>{}, [](int b, int e) {
+        std::vector<int> v;
+        for (auto i = b; i < e; ++i)
+        {
+          v.push_back(i);
+        }
+        return v;
+      },
+      [](std::vector<int> a, std::vector<int> b) {
+        a.insert(a.end(), b.cbegin(), b.cend());
+        return a;
+      });
+  REQUIRE(concatenated == std::vector<int>({0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+  REQUIRE(sln::parallel_reduce(pool, 5, 5, 1, 42, [](int, int) { return 0; }, [](int a, int b) { return a + b; }) == 42);
+}
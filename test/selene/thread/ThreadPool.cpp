@@ -1,10 +1,18 @@
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <future>
+#include <thread>
+#include <vector>
 
 #include <catch.hpp>
 
+#include <selene/base/MappedMemoryResource.hpp>
+#include <selene/base/Numa.hpp>
+
 #include <selene/thread/ThreadPool.hpp>
+#include <selene/thread/detail/WorkStealingDeque.hpp>
 
 double expensive_work(double seed)
 {
@@ -22,23 +30,192 @@ double expensive_work(double seed)
 
 TEST_CASE("Simple ThreadPool test", "[thread]")
 {
-  sln::ThreadPool tp(8);
-  REQUIRE(!tp.empty());
-  REQUIRE(tp.size() == 8);
+  for (const auto scheduler : {sln::ThreadPoolScheduler::WorkStealing, sln::ThreadPoolScheduler::MultiQueue})
+  {
+    sln::ThreadPool tp(8, scheduler);
+    REQUIRE(!tp.empty());
+    REQUIRE(tp.size() == 8);
+    REQUIRE(tp.scheduler() == scheduler);
+
+    std::vector<std::future<double>> futures;
+
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+      const auto seed = 5.0 * i;
+      futures.emplace_back(tp.push(expensive_work, seed));
+    }
+
+    double sum = 0.0;
+    for (auto& f : futures)
+    {
+      sum += f.get();
+    }
+
+    REQUIRE(sum == Approx(5.5223).margin(0.01));
+  }
+}
+
+TEST_CASE("ThreadPool nested task submission", "[thread]")
+{
+  constexpr std::size_t nr_outer_tasks = 64;
+  constexpr std::size_t nr_inner_tasks = 256;
+
+  for (const auto scheduler : {sln::ThreadPoolScheduler::WorkStealing, sln::ThreadPoolScheduler::MultiQueue})
+  {
+    std::atomic<std::size_t> counter{0};
+
+    {
+      sln::ThreadPool tp(4, scheduler);
+
+      for (std::size_t i = 0; i < nr_outer_tasks; ++i)
+      {
+        tp.push([&tp, &counter]() {
+          for (std::size_t j = 0; j < nr_inner_tasks; ++j)
+          {
+            tp.push([&counter]() { ++counter; });
+          }
+        });
+      }
+
+      while (counter < nr_outer_tasks * nr_inner_tasks)
+      {
+        std::this_thread::yield();
+      }
+    }
+
+    REQUIRE(counter == nr_outer_tasks * nr_inner_tasks);
+  }
+}
+
+TEST_CASE("ThreadPool finishes remaining tasks on destruction", "[thread]")
+{
+  std::atomic<std::size_t> counter{0};
+
+  {
+    sln::ThreadPool tp(2);
+    for (std::size_t i = 0; i < 1000; ++i)
+    {
+      tp.push([&counter]() { ++counter; });
+    }
+  }
 
-  std::vector<std::future<double>> futures;
+  REQUIRE(counter == 1000);
+}
 
-  for (std::size_t i = 0; i < 8; ++i)
+TEST_CASE("ThreadPool thread pinning", "[thread]")
+{
+  for (const auto pinning : {sln::ThreadPinning::None, sln::ThreadPinning::Cores, sln::ThreadPinning::NumaNodes})
   {
-    const auto seed = 5.0 * i;
-    futures.emplace_back(tp.push(expensive_work, seed));
+    sln::ThreadPool tp(4, sln::ThreadPoolScheduler::WorkStealing, pinning);
+    REQUIRE(tp.pinning() == pinning);
+
+    for (std::size_t i = 0; i < tp.size(); ++i)
+    {
+      const auto node = tp.numa_node(i);
+      if (pinning == sln::ThreadPinning::None)
+      {
+        REQUIRE(node == -1);
+      }
+      else
+      {
+        REQUIRE(node >= 0);
+        REQUIRE(static_cast<std::size_t>(node) < sln::nr_numa_nodes());
+      }
+    }
+
+    std::vector<std::future<int>> futures;
+    for (std::size_t i = 0; i < 64; ++i)
+    {
+      futures.emplace_back(tp.push([] { return sln::current_numa_node(); }));
+    }
+
+    for (auto& f : futures)
+    {
+      const auto node = f.get();
+      REQUIRE(node >= 0);
+      REQUIRE(static_cast<std::size_t>(node) < sln::nr_numa_nodes());
+    }
+  }
+
+  // Scratch memory allocated on the pinned threads, bound to their respective node
+  sln::ThreadPool tp(2, sln::ThreadPoolScheduler::MultiQueue, sln::ThreadPinning::NumaNodes);
+  sln::MappedMemoryResource scratch(sln::HugePages::Transparent, sln::MappedMemoryResource::local_numa_node);
+  std::vector<std::future<bool>> futures;
+
+  for (std::size_t i = 0; i < 4; ++i)
+  {
+    futures.emplace_back(tp.push([&scratch] {
+      auto block = scratch.allocate(std::size_t{8} << 20, 64);
+      if (block.data() == nullptr)
+      {
+        return false;
+      }
+
+      std::fill(block.data(), block.data() + block.size(), std::uint8_t{0x5A});
+      return block.data()[block.size() - 1] == 0x5A;
+    }));
   }
 
-  double sum = 0.0;
   for (auto& f : futures)
   {
-    sum += f.get();
+    REQUIRE(f.get());
+  }
+
+  REQUIRE(scratch.nr_mappings() == 4);
+}
+
+TEST_CASE("Work-stealing deque", "[thread]")
+{
+  constexpr std::size_t nr_items = 100000;
+  constexpr std::size_t nr_thieves = 3;
+
+  sln::detail::WorkStealingDeque<std::size_t> deque(4);  // small initial capacity, to exercise growing
+  std::vector<std::atomic<std::uint8_t>> taken(nr_items);
+  for (auto& t : taken)
+  {
+    t = 0;
   }
 
-  REQUIRE(sum == Approx(5.5223).margin(0.01));
+  std::atomic<bool> done{false};
+  std::vector<std::thread> thieves;
+  for (std::size_t i = 0; i < nr_thieves; ++i)
+  {
+    thieves.emplace_back([&]() {
+      std::size_t value = 0;
+      while (!done || !deque.empty())
+      {
+        if (deque.steal(value))
+        {
+          ++taken[value];
+        }
+      }
+    });
+  }
+
+  std::size_t value = 0;
+  for (std::size_t i = 0; i < nr_items; ++i)
+  {
+    deque.push(i);
+
+    if (i % 3 == 0 && deque.pop(value))
+    {
+      ++taken[value];
+    }
+  }
+
+  while (deque.pop(value))
+  {
+    ++taken[value];
+  }
+
+  done = true;
+  for (auto& t : thieves)
+  {
+    t.join();
+  }
+
+  for (const auto& t : taken)
+  {
+    REQUIRE(t == 1);
+  }
 }